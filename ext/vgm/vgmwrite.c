@@ -130,6 +130,8 @@ typedef struct _vgm_file_inf VGM_INF;
 struct _vgm_file_inf
 {
 	FILE* hFile;
+	char* WrtBuf;	// large stdio buffer, so register writes don't hit the disk one by one
+	uint32_t SmplsChkpt;	// sample count at the last header checkpoint
 	VGM_HEADER Header;
 	uint8_t WroteHeader;
 	uint32_t HeaderBytes;
@@ -167,6 +169,8 @@ struct _vgm_chip_pcmcache
 
 #define MAX_VGM_FILES	0x10
 #define MAX_VGM_CHIPS	0x80
+#define VGM_WRITE_BUFFER	0x40000	// 256 KB
+#define VGM_CHECKPOINT_SMPLS	(44100 * 10)	// rewrite the header every 10 seconds
 static char vgm_namebase[0x80];
 static VGM_INF VgmFile[MAX_VGM_FILES];
 static VGM_CHIP VgmChip[MAX_VGM_CHIPS];
@@ -183,6 +187,8 @@ static void vgm_header_sizecheck(uint16_t vgm_id, uint32_t MinVer, uint32_t MinS
 static void vgm_header_clear(uint16_t vgm_id);
 static void vgm_setup_pcmcache(VGM_PCMCACHE* TempPC, uint32_t Size);
 static void vgm_close(uint16_t vgm_id);
+static void vgm_fclose(VGM_INF* VI);
+static void vgm_header_checkpoint(uint16_t vgm_id);
 static void vgm_write_delay(uint16_t vgm_id);
 static uint8_t vgm_nes_ram_check(VGM_INF* VI, uint32_t datasize, uint32_t* value1, uint32_t* value2, const uint8_t* data);
 static void vgm_flush_pcm(VGM_CHIP* VC);
@@ -277,6 +283,7 @@ void vgm_start(struct RunningMachine *machine)
 	for (curvgm = 0x00; curvgm < MAX_VGM_FILES; curvgm ++)
 	{
 		VgmFile[curvgm].hFile = NULL;
+		VgmFile[curvgm].WrtBuf = NULL;
 		VgmFile[curvgm].DataCount = 0x00;
 		VgmFile[curvgm].CmdCount = 0x00;
 		VgmFile[curvgm].NesMemEmpty = 0x01;
@@ -945,9 +952,13 @@ uint16_t vgm_open(uint8_t chip_type, double clockd)
 				if (VgmFile[curvgm].hFile)
 				{
 					logerror("OK\n");
+					VgmFile[curvgm].WrtBuf = (char*)malloc(VGM_WRITE_BUFFER);
+					if (VgmFile[curvgm].WrtBuf != NULL)
+						setvbuf(VgmFile[curvgm].hFile, VgmFile[curvgm].WrtBuf, _IOFBF, VGM_WRITE_BUFFER);
 					chip_file = curvgm;
 					VgmFile[curvgm].BytesWrt = 0;
 					VgmFile[curvgm].SmplsWrt = 0;
+					VgmFile[curvgm].SmplsChkpt = 0;
 					VgmFile[curvgm].EvtDelay = 0;
 					vgm_header_clear(curvgm);
 				}
@@ -1490,8 +1501,7 @@ static void vgm_close(uint16_t vgm_id)
 	
 	if (! VI->WroteHeader)
 	{
-		fclose(VI->hFile);
-		VI->hFile = NULL;
+		vgm_fclose(VI);
 		return;
 	}
 	
@@ -1525,10 +1535,42 @@ static void vgm_close(uint16_t vgm_id)
 	fseek(VI->hFile, 0x00, SEEK_SET);
 	fwrite(Header, 0x01, VI->HeaderBytes, VI->hFile);
 	
+	vgm_fclose(VI);
+	
+	logerror("VGM %02hX closed. %u Bytes, %u Samples written.\n", vgm_id, VI->BytesWrt, VI->SmplsWrt);
+	
+	return;
+}
+
+static void vgm_fclose(VGM_INF* VI)
+{
 	fclose(VI->hFile);
 	VI->hFile = NULL;
+	free(VI->WrtBuf);	// only after fclose, stdio owns it until then
+	VI->WrtBuf = NULL;
 	
-	logerror("VGM %02hX closed. %u Bytes, %u Samples written.\n", vgm_id, VI->BytesWrt, VI->SmplsWrt);
+	return;
+}
+
+// Patch the sizes in the header, so a session that never reaches vgm_close()
+// still leaves a playable file.  Only done every few seconds, as it flushes
+// the write buffer.
+static void vgm_header_checkpoint(uint16_t vgm_id)
+{
+	VGM_INF* VI;
+	VGM_HEADER* Header;
+	
+	VI = &VgmFile[vgm_id];
+	Header = &VI->Header;
+	
+	Header->lngTotalSamples = VI->SmplsWrt;
+	Header->lngEOFOffset = VI->BytesWrt - 0x00000004;
+	Header->lngDataOffset = VI->HeaderBytes - 0x34;
+	
+	fseek(VI->hFile, 0x00, SEEK_SET);
+	fwrite(Header, 0x01, VI->HeaderBytes, VI->hFile);
+	fseek(VI->hFile, 0x00, SEEK_END);
+	VI->SmplsChkpt = VI->SmplsWrt;
 	
 	return;
 }
@@ -1574,6 +1616,9 @@ static void vgm_write_delay(uint16_t vgm_id)
 		VI->EvtDelay -= delaywrite;
 	}
 	
+	if (VI->WroteHeader && VI->SmplsWrt - VI->SmplsChkpt >= VGM_CHECKPOINT_SMPLS)
+		vgm_header_checkpoint(vgm_id);
+	
 	return;
 }
 
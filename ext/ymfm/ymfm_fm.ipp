@@ -876,6 +876,26 @@ bool fm_channel<RegisterType>::prepare()
 template<class RegisterType>
 void fm_channel<RegisterType>::clock(uint32_t env_counter, int32_t lfo_raw_pm)
 {
+#ifdef PINMAME
+	// skip channels that are completely done (all operators released down to
+	// max attenuation, feedback settled): clocking them would only advance
+	// phases that are reset on the next key on, so the output stays bit exact
+	// (not used with rhythm mode or dynamic operators, where phases leak into other channels)
+	if (!RegisterType::EG_HAS_SSG && !RegisterType::EG_HAS_REVERB && !RegisterType::EG_HAS_DEPRESS && !RegisterType::DYNAMIC_OPS &&
+		!m_regs.rhythm_enable() && m_feedback[0] == m_feedback_in && m_feedback[1] == m_feedback_in)
+	{
+		bool idle = true;
+		for (uint32_t opnum = 0; opnum < m_op.size(); opnum++)
+			if (m_op[opnum] != nullptr && (m_op[opnum]->debug_eg_state() != EG_RELEASE || m_op[opnum]->debug_eg_attenuation() != 0x3ff))
+			{
+				idle = false;
+				break;
+			}
+		if (idle)
+			return;
+	}
+#endif
+
 	// clock the feedback through
 	m_feedback[0] = m_feedback[1];
 	m_feedback[1] = m_feedback_in;
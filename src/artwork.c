@@ -416,6 +416,12 @@ static UINT8 global_artwork_enable;
 
 static const struct overlay_piece *overlay_list;
 
+static UINT8 *game_shadow;
+static UINT8 *game_row_dirty;
+static int game_shadow_width, game_shadow_height;
+static int game_shadow_valid, game_rows_tracked;
+static struct rectangle game_shadow_area;
+
 
 
 /***************************************************************************
@@ -441,6 +447,8 @@ static void render_game_bitmap_underlay(struct mame_bitmap *bitmap, const rgb_t
 static void render_game_bitmap_overlay(struct mame_bitmap *bitmap, const rgb_t *palette, struct mame_display *display);
 static void render_game_bitmap_underlay_overlay(struct mame_bitmap *bitmap, const rgb_t *palette, struct mame_display *display);
 static void render_ui_overlay(struct mame_bitmap *bitmap, UINT32 *dirty, const rgb_t *palette, struct mame_display *display);
+static void update_dirty_rows(struct mame_bitmap *bitmap, int force);
+static void render_bezels(void);
 static void erase_rect(struct mame_bitmap *bitmap, const struct rectangle *bounds, UINT32 color);
 static void alpha_blend_intersecting_rect(struct mame_bitmap *dstbitmap, const struct rectangle *dstbounds, struct mame_bitmap *srcbitmap, const struct rectangle *srcbounds, const UINT32 *hintlist);
 static void add_intersecting_rect(struct mame_bitmap *dstbitmap, const struct rectangle *dstbounds, struct mame_bitmap *srcbitmap, const struct rectangle *srcbounds);
@@ -585,6 +593,21 @@ INLINE UINT32 blend_over(UINT32 game, UINT32 pre, UINT32 yrgb)
 
 
 
+/*-------------------------------------------------
+	next_dirty_row - return the first game row at
+	or after y that needs to be composited again
+-------------------------------------------------*/
+
+INLINE int next_dirty_row(int y, int height)
+{
+	if (game_rows_tracked)
+		while (y < height && !game_row_dirty[y])
+			y++;
+	return y;
+}
+
+
+
 #if 0
 #pragma mark -
 #pragma mark OSD FRONTENDS
@@ -684,6 +707,21 @@ int artwork_create_display(struct osd_create_params *params, UINT32 rgb_componen
 		uioverlayhint = auto_malloc(uioverlay->height * MAX_HINTS_PER_SCANLINE * sizeof(uioverlayhint[0]));
 	if (!uioverlay || !uioverlayhint)
 		return 1;
+
+	/* allocate the copy of the last game frame used to find the rows that changed */
+	game_shadow = NULL;
+	game_row_dirty = NULL;
+	game_shadow_valid = 0;
+	game_rows_tracked = 0;
+	if (!(params->video_attributes & VIDEO_TYPE_VECTOR))
+	{
+		game_shadow_width = original_width;
+		game_shadow_height = original_height;
+		game_shadow = auto_malloc(original_width * original_height * sizeof(UINT32));
+		game_row_dirty = auto_malloc(original_height * sizeof(game_row_dirty[0]));
+		if (!game_shadow || !game_row_dirty)
+			return 1;
+	}
 	fillbitmap(uioverlay, (Machine->color_depth == 32) ? UI_TRANSPARENT_COLOR32 : UI_TRANSPARENT_COLOR16, NULL);
 	memset(uioverlayhint, 0, uioverlay->height * MAX_HINTS_PER_SCANLINE * sizeof(uioverlayhint[0]));
 
@@ -730,6 +768,7 @@ void artwork_update_video_and_audio(struct mame_display *display)
 	static struct rectangle ui_changed_bounds;
 	static int ui_changed;
 	int artwork_changed = 0;
+	int palette_changed = display->changed_flags & GAME_PALETTE_CHANGED;
 
 	/* do nothing if no artwork */
 	if (!artwork_list && !uioverlay)
@@ -741,7 +780,7 @@ void artwork_update_video_and_audio(struct mame_display *display)
 	profiler_mark(PROFILER_ARTWORK);
 
 	/* update the palette */
-	if (display->changed_flags & GAME_PALETTE_CHANGED)
+	if (palette_changed)
 		update_palette_lookup(display);
 
 	/* process the artwork and UI only if we're not frameskipping */
@@ -779,6 +818,7 @@ void artwork_update_video_and_audio(struct mame_display *display)
 			union_rect(&underlay_invalid, &screenrect);
 			union_rect(&overlay_invalid, &screenrect);
 			union_rect(&bezel_invalid, &screenrect);
+			update_dirty_rows(display->game_bitmap, 1);
 			render_game_bitmap(display->game_bitmap, palette_lookup, display);
 		}
 
@@ -788,6 +828,11 @@ void artwork_update_video_and_audio(struct mame_display *display)
 			/* update the underlay and overlay */
 			artwork_changed = update_layers();
 
+			/* only rows that changed since the last frame need blending again, unless */
+			/* the layers or the UI have touched the final bitmap in the meantime */
+			update_dirty_rows(display->game_bitmap, artwork_changed || ui_changed || ui_visible || palette_changed ||
+					(display->changed_flags & VECTOR_PIXELS_CHANGED));
+
 			/* render to the final bitmap */
 			if (num_underlays && num_overlays)
 				render_game_bitmap_underlay_overlay(display->game_bitmap, palette_lookup, display);
@@ -800,12 +845,7 @@ void artwork_update_video_and_audio(struct mame_display *display)
 
 			/* apply the bezel */
 			if (num_bezels)
-			{
-				struct artwork_piece *piece;
-				for (piece = artwork_list; piece; piece = piece->next)
-					if (piece->layer >= LAYER_BEZEL && piece->intersects_game)
-						alpha_blend_intersecting_rect(final, &gamerect, piece->prebitmap, &piece->bounds, piece->scanlinehint);
-			}
+				render_bezels();
 		}
 
 		/* add UI */
@@ -1397,7 +1437,7 @@ static void render_game_bitmap(struct mame_bitmap *bitmap, const rgb_t *palette,
 		/* 16/15bpp case */
 		if (bitmap->depth != 32)
 		{
-			for (y = 0; y < height; y++)
+			for (y = next_dirty_row(0, height); y < height; y = next_dirty_row(y + 1, height))
 			{
 				UINT16 *src = (UINT16 *)srcbase + y * srcrowpixels + Machine->absolute_visible_area.min_x;
 				UINT32 *dst = (UINT32 *)dstbase + y * dstrowpixels;
@@ -1409,7 +1449,7 @@ static void render_game_bitmap(struct mame_bitmap *bitmap, const rgb_t *palette,
 		/* 32bpp case */
 		else
 		{
-			for (y = 0; y < height; y++)
+			for (y = next_dirty_row(0, height); y < height; y = next_dirty_row(y + 1, height))
 			{
 				UINT32 *src = (UINT32 *)srcbase + y * srcrowpixels + Machine->absolute_visible_area.min_x;
 				UINT32 *dst = (UINT32 *)dstbase + y * dstrowpixels;
@@ -1425,7 +1465,7 @@ static void render_game_bitmap(struct mame_bitmap *bitmap, const rgb_t *palette,
 		/* 16/15bpp case */
 		if (bitmap->depth != 32)
 		{
-			for (y = 0; y < height; y++)
+			for (y = next_dirty_row(0, height); y < height; y = next_dirty_row(y + 1, height))
 			{
 				UINT16 *src = (UINT16 *)srcbase + y * srcrowpixels + Machine->absolute_visible_area.min_x;
 				UINT32 *dst = (UINT32 *)dstbase + y * 2 * dstrowpixels;
@@ -1444,7 +1484,7 @@ static void render_game_bitmap(struct mame_bitmap *bitmap, const rgb_t *palette,
 		/* 32bpp case */
 		else
 		{
-			for (y = 0; y < height; y++)
+			for (y = next_dirty_row(0, height); y < height; y = next_dirty_row(y + 1, height))
 			{
 				UINT32 *src = (UINT32 *)srcbase + y * srcrowpixels + Machine->absolute_visible_area.min_x;
 				UINT32 *dst = (UINT32 *)dstbase + y * 2 * dstrowpixels;
@@ -1523,7 +1563,7 @@ static void render_game_bitmap_underlay(struct mame_bitmap *bitmap, const rgb_t
 		/* 16/15bpp case */
 		if (bitmap->depth != 32)
 		{
-			for (y = 0; y < height; y++)
+			for (y = next_dirty_row(0, height); y < height; y = next_dirty_row(y + 1, height))
 			{
 				UINT16 *src = (UINT16 *)srcbase + y * srcrowpixels + Machine->absolute_visible_area.min_x;
 				UINT32 *dst = (UINT32 *)dstbase + y * dstrowpixels;
@@ -1536,7 +1576,7 @@ static void render_game_bitmap_underlay(struct mame_bitmap *bitmap, const rgb_t
 		/* 32bpp case */
 		else
 		{
-			for (y = 0; y < height; y++)
+			for (y = next_dirty_row(0, height); y < height; y = next_dirty_row(y + 1, height))
 			{
 				UINT32 *src = (UINT32 *)srcbase + y * srcrowpixels + Machine->absolute_visible_area.min_x;
 				UINT32 *dst = (UINT32 *)dstbase + y * dstrowpixels;
@@ -1553,7 +1593,7 @@ static void render_game_bitmap_underlay(struct mame_bitmap *bitmap, const rgb_t
 		/* 16/15bpp case */
 		if (bitmap->depth != 32)
 		{
-			for (y = 0; y < height; y++)
+			for (y = next_dirty_row(0, height); y < height; y = next_dirty_row(y + 1, height))
 			{
 				UINT16 *src = (UINT16 *)srcbase + y * srcrowpixels + Machine->absolute_visible_area.min_x;
 				UINT32 *dst = (UINT32 *)dstbase + y * 2 * dstrowpixels;
@@ -1574,7 +1614,7 @@ static void render_game_bitmap_underlay(struct mame_bitmap *bitmap, const rgb_t
 		/* 32bpp case */
 		else
 		{
-			for (y = 0; y < height; y++)
+			for (y = next_dirty_row(0, height); y < height; y = next_dirty_row(y + 1, height))
 			{
 				UINT32 *src = (UINT32 *)srcbase + y * srcrowpixels + Machine->absolute_visible_area.min_x;
 				UINT32 *dst = (UINT32 *)dstbase + y * 2 * dstrowpixels;
@@ -1656,7 +1696,7 @@ static void render_game_bitmap_overlay(struct mame_bitmap *bitmap, const rgb_t *
 		/* 16/15bpp case */
 		if (bitmap->depth != 32)
 		{
-			for (y = 0; y < height; y++)
+			for (y = next_dirty_row(0, height); y < height; y = next_dirty_row(y + 1, height))
 			{
 				UINT16 *src = (UINT16 *)srcbase + y * srcrowpixels + Machine->absolute_visible_area.min_x;
 				UINT32 *dst = (UINT32 *)dstbase + y * dstrowpixels;
@@ -1670,7 +1710,7 @@ static void render_game_bitmap_overlay(struct mame_bitmap *bitmap, const rgb_t *
 		/* 32bpp case */
 		else
 		{
-			for (y = 0; y < height; y++)
+			for (y = next_dirty_row(0, height); y < height; y = next_dirty_row(y + 1, height))
 			{
 				UINT32 *src = (UINT32 *)srcbase + y * srcrowpixels + Machine->absolute_visible_area.min_x;
 				UINT32 *dst = (UINT32 *)dstbase + y * dstrowpixels;
@@ -1688,7 +1728,7 @@ static void render_game_bitmap_overlay(struct mame_bitmap *bitmap, const rgb_t *
 		/* 16/15bpp case */
 		if (bitmap->depth != 32)
 		{
-			for (y = 0; y < height; y++)
+			for (y = next_dirty_row(0, height); y < height; y = next_dirty_row(y + 1, height))
 			{
 				UINT16 *src = (UINT16 *)srcbase + y * srcrowpixels + Machine->absolute_visible_area.min_x;
 				UINT32 *dst = (UINT32 *)dstbase + y * 2 * dstrowpixels;
@@ -1711,7 +1751,7 @@ static void render_game_bitmap_overlay(struct mame_bitmap *bitmap, const rgb_t *
 		/* 32bpp case */
 		else
 		{
-			for (y = 0; y < height; y++)
+			for (y = next_dirty_row(0, height); y < height; y = next_dirty_row(y + 1, height))
 			{
 				UINT32 *src = (UINT32 *)srcbase + y * srcrowpixels + Machine->absolute_visible_area.min_x;
 				UINT32 *dst = (UINT32 *)dstbase + y * 2 * dstrowpixels;
@@ -1797,7 +1837,7 @@ static void render_game_bitmap_underlay_overlay(struct mame_bitmap *bitmap, cons
 		/* 16/15bpp case */
 		if (bitmap->depth != 32)
 		{
-			for (y = 0; y < height; y++)
+			for (y = next_dirty_row(0, height); y < height; y = next_dirty_row(y + 1, height))
 			{
 				UINT16 *src = (UINT16 *)srcbase + y * srcrowpixels + Machine->absolute_visible_area.min_x;
 				UINT32 *dst = (UINT32 *)dstbase + y * dstrowpixels;
@@ -1812,7 +1852,7 @@ static void render_game_bitmap_underlay_overlay(struct mame_bitmap *bitmap, cons
 		/* 32bpp case */
 		else
 		{
-			for (y = 0; y < height; y++)
+			for (y = next_dirty_row(0, height); y < height; y = next_dirty_row(y + 1, height))
 			{
 				UINT32 *src = (UINT32 *)srcbase + y * srcrowpixels + Machine->absolute_visible_area.min_x;
 				UINT32 *dst = (UINT32 *)dstbase + y * dstrowpixels;
@@ -1831,7 +1871,7 @@ static void render_game_bitmap_underlay_overlay(struct mame_bitmap *bitmap, cons
 		/* 16/15bpp case */
 		if (bitmap->depth != 32)
 		{
-			for (y = 0; y < height; y++)
+			for (y = next_dirty_row(0, height); y < height; y = next_dirty_row(y + 1, height))
 			{
 				UINT16 *src = (UINT16 *)srcbase + y * srcrowpixels + Machine->absolute_visible_area.min_x;
 				UINT32 *dst = (UINT32 *)dstbase + y * 2 * dstrowpixels;
@@ -1856,7 +1896,7 @@ static void render_game_bitmap_underlay_overlay(struct mame_bitmap *bitmap, cons
 		/* 32bpp case */
 		else
 		{
-			for (y = 0; y < height; y++)
+			for (y = next_dirty_row(0, height); y < height; y = next_dirty_row(y + 1, height))
 			{
 				UINT32 *src = (UINT32 *)srcbase + y * srcrowpixels + Machine->absolute_visible_area.min_x;
 				UINT32 *dst = (UINT32 *)dstbase + y * 2 * dstrowpixels;
@@ -1882,6 +1922,80 @@ static void render_game_bitmap_underlay_overlay(struct mame_bitmap *bitmap, cons
 
 
 
+/*-------------------------------------------------
+	update_dirty_rows - compare the visible game
+	bitmap against the previous frame and mark
+	the rows that have to be composited again
+-------------------------------------------------*/
+
+static void update_dirty_rows(struct mame_bitmap *bitmap, int force)
+{
+	const struct rectangle *area = &Machine->absolute_visible_area;
+	int width = area->max_x - area->min_x + 1;
+	int height = area->max_y - area->min_y + 1;
+	int pixelbytes = (bitmap->depth == 32) ? 4 : 2;
+	int rowbytes = width * pixelbytes;
+	int y;
+
+	/* without a usable copy of the last frame, everything is dirty */
+	game_rows_tracked = 0;
+	if (!game_shadow || width > game_shadow_width || height > game_shadow_height)
+		return;
+
+	/* a new visible area invalidates the copy */
+	if (!game_shadow_valid || memcmp(area, &game_shadow_area, sizeof(game_shadow_area)) != 0)
+	{
+		game_shadow_area = *area;
+		game_shadow_valid = 1;
+		force = 1;
+	}
+
+	for (y = 0; y < height; y++)
+	{
+		const UINT8 *src = (const UINT8 *)bitmap->base + (area->min_y + y) * bitmap->rowbytes + area->min_x * pixelbytes;
+		UINT8 *last = game_shadow + y * rowbytes;
+
+		game_row_dirty[y] = force || memcmp(src, last, rowbytes) != 0;
+		if (game_row_dirty[y])
+			memcpy(last, src, rowbytes);
+	}
+	game_rows_tracked = 1;
+}
+
+
+
+/*-------------------------------------------------
+	render_bezels - blend the bezels over the
+	game rows that were rendered this frame
+-------------------------------------------------*/
+
+static void render_bezels(void)
+{
+	int height = (gamerect.max_y - gamerect.min_y + 1) / gamescale;
+	int y = next_dirty_row(0, height);
+
+	while (y < height)
+	{
+		struct artwork_piece *piece;
+		struct rectangle rows = gamerect;
+		int end = y;
+
+		/* gather a run of dirty rows */
+		while (end + 1 < height && (!game_rows_tracked || game_row_dirty[end + 1]))
+			end++;
+		rows.min_y = gamerect.min_y + y * gamescale;
+		rows.max_y = gamerect.min_y + (end + 1) * gamescale - 1;
+
+		for (piece = artwork_list; piece; piece = piece->next)
+			if (piece->layer >= LAYER_BEZEL && piece->intersects_game)
+				alpha_blend_intersecting_rect(final, &rows, piece->prebitmap, &piece->bounds, piece->scanlinehint);
+
+		y = next_dirty_row(end + 1, height);
+	}
+}
+
+
+
 /*-------------------------------------------------
 	render_ui_overlay - render the UI overlay
 -------------------------------------------------*/
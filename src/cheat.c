@@ -854,6 +854,10 @@ static SearchInfo			* searchList = NULL;
 static INT32				searchListLength = 0;
 static INT32				currentSearchIdx = 0;
 
+static UINT8				* searchSnapshot = NULL;
+static UINT32				searchSnapshotLength = 0;
+static SearchRegion			* searchSnapshotRegion = NULL;
+
 static CPUInfo				cpuInfoList[MAX_CPU];
 static CPUInfo				regionInfoList[kRegionListLength];
 
@@ -1193,11 +1197,13 @@ static void		InvalidateEntireRegion(SearchInfo * search, SearchRegion * region);
 static void		InitializeNewSearch(SearchInfo * search);
 static void		UpdateSearch(SearchInfo * search);
 
+static void		SnapshotSearchRegion(SearchRegion * region);
 static void		DoSearch(SearchInfo * search);
 
 static UINT8 **	LookupHandlerMemory(UINT8 cpu, UINT32 address, UINT32 * outRelativeAddress);
 
 static UINT32	DoCPURead(UINT8 cpu, UINT32 address, UINT8 bytes, UINT8 swap);
+static UINT32	DoSnapshotRead(UINT8 * buf, UINT32 address, UINT8 bytes, UINT8 swap);
 static UINT32	DoMemoryRead(UINT8 * buf, UINT32 address, UINT8 bytes, UINT8 swap, CPUInfo * info);
 static void		DoCPUWrite(UINT32 data, UINT8 cpu, UINT32 address, UINT8 bytes, UINT8 swap);
 static void		DoMemoryWrite(UINT32 data, UINT8 * buf, UINT32 address, UINT8 bytes, UINT8 swap, CPUInfo * info);
@@ -1757,6 +1763,12 @@ void StopCheat(void)
 		searchList = NULL;
 	}
 
+	free(searchSnapshot);
+
+	searchSnapshot = NULL;
+	searchSnapshotLength = 0;
+	searchSnapshotRegion = NULL;
+
 	FreeStringTable();
 
 	free(menuItemInfo);
@@ -7818,7 +7830,54 @@ static void FillBufferFromRegion(SearchRegion * region, UINT8 * buf)
 {
 	UINT32	offset;
 
-	// ### optimize if needed
+	if(region->targetType == kRegionType_CPU)
+	{
+		UINT8	cpu = region->targetIdx;
+		UINT8	linear;
+
+		// RAM and banks hold bytes in address order only if the bus is 8 bits wide or the CPU
+		// shares the host byte order; otherwise every byte has to go through the read handlers
+#ifdef LSB_FIRST
+		linear = (cpunum_databus_width(cpu) == 8) || (cpunum_endianess(cpu) == CPU_IS_LE);
+#else
+		linear = (cpunum_databus_width(cpu) == 8) || (cpunum_endianess(cpu) == CPU_IS_BE);
+#endif
+
+		if(linear)
+		{
+			cpuintrf_push_context(cpu);
+
+			offset = 0;
+
+			while(offset < region->length)
+			{
+				UINT32	address = region->address + offset;
+				UINT8	* base = memory_get_read_ptr(cpu, address);
+				UINT32	run = 1;
+
+				// handler-mapped byte, or a CPU whose read path remaps addresses
+				if(!base || (*base != cpunum_read_byte(cpu, address)))
+				{
+					buf[offset++] = cpunum_read_byte(cpu, address);
+
+					continue;
+				}
+
+				// copy the whole stretch backed by the same block in one go
+				while(	(offset + run < region->length) &&
+						(memory_get_read_ptr(cpu, address + run) == base + run))
+					run++;
+
+				memcpy(&buf[offset], base, run);
+
+				offset += run;
+			}
+
+			cpuintrf_pop_context();
+
+			return;
+		}
+	}
 
 	for(offset = 0; offset < region->length; offset++)
 	{
@@ -8862,7 +8921,10 @@ static UINT32 ReadSearchOperand(UINT8 type, SearchInfo * search, SearchRegion *
 	switch(type)
 	{
 		case kSearchOperand_Current:
-			value = ReadRegionData(region, address - region->address, kSearchByteIncrementTable[search->bytes], search->swap);
+			if(region == searchSnapshotRegion)
+				value = DoSnapshotRead(searchSnapshot, address - region->address, kSearchByteIncrementTable[search->bytes], CPUNeedsSwap(region->targetIdx) ^ search->swap);
+			else
+				value = ReadRegionData(region, address - region->address, kSearchByteIncrementTable[search->bytes], search->swap);
 			break;
 
 		case kSearchOperand_Previous:
@@ -8890,7 +8952,10 @@ static UINT32 ReadSearchOperandBit(UINT8 type, SearchInfo * search, SearchRegion
 	switch(type)
 	{
 		case kSearchOperand_Current:
-			value = ReadRegionData(region, address - region->address, kSearchByteIncrementTable[search->bytes], search->swap);
+			if(region == searchSnapshotRegion)
+				value = DoSnapshotRead(searchSnapshot, address - region->address, kSearchByteIncrementTable[search->bytes], CPUNeedsSwap(region->targetIdx) ^ search->swap);
+			else
+				value = ReadRegionData(region, address - region->address, kSearchByteIncrementTable[search->bytes], search->swap);
 			break;
 
 		case kSearchOperand_Previous:
@@ -9137,6 +9202,31 @@ static void UpdateSearch(SearchInfo * search)
 	}
 }
 
+// grab the current contents of a CPU region once per search pass, so the comparison loop
+// reads plain memory instead of going through cpunum_read_byte for every operand
+static void SnapshotSearchRegion(SearchRegion * region)
+{
+	searchSnapshotRegion = NULL;
+
+	if(region->targetType != kRegionType_CPU)
+		return;
+
+	if(searchSnapshotLength < region->length)
+	{
+		UINT8	* temp = realloc(searchSnapshot, region->length);
+
+		if(!temp)
+			return;
+
+		searchSnapshot = temp;
+		searchSnapshotLength = region->length;
+	}
+
+	FillBufferFromRegion(region, searchSnapshot);
+
+	searchSnapshotRegion = region;
+}
+
 static void DoSearch(SearchInfo * search)
 {
 	int	i, j;
@@ -9159,6 +9249,8 @@ static void DoSearch(SearchInfo * search)
 				continue;
 			}
 
+			SnapshotSearchRegion(region);
+
 			for(j = 0; j < lastAddress; j += increment)
 			{
 				UINT32	address = region->address + j;
@@ -9199,6 +9291,8 @@ static void DoSearch(SearchInfo * search)
 				continue;
 			}
 
+			SnapshotSearchRegion(region);
+
 			for(j = 0; j < lastAddress; j += increment)
 			{
 				UINT32	address = region->address + j;
@@ -9221,6 +9315,8 @@ static void DoSearch(SearchInfo * search)
 			}
 		}
 	}
+
+	searchSnapshotRegion = NULL;
 }
 
 static UINT8 ** LookupHandlerMemory(UINT8 cpu, UINT32 address, UINT32 * outRelativeAddress)
@@ -9303,6 +9399,23 @@ static UINT32 DoCPURead(UINT8 cpu, UINT32 address, UINT8 bytes, UINT8 swap)
 	return 0;
 }
 
+// same byte ordering as DoCPURead, but from a region snapshot
+static UINT32 DoSnapshotRead(UINT8 * buf, UINT32 address, UINT8 bytes, UINT8 swap)
+{
+	UINT32	data = 0;
+	UINT8	i;
+
+	for(i = 0; i < bytes; i++)
+	{
+		if(swap)
+			data |= buf[address + i] << (i * 8);
+		else
+			data = (data << 8) | buf[address + i];
+	}
+
+	return data;
+}
+
 static UINT32 DoMemoryRead(UINT8 * buf, UINT32 address, UINT8 bytes, UINT8 swap, CPUInfo * info)
 {
 	UINT32	data = 0;
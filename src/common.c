@@ -10,6 +10,11 @@
 #include "png.h"
 #include "harddisk.h"
 #include "artwork.h"
+#ifdef PINMAME
+#include "wpc/romshare.h"
+#else
+#define romshare_free(base) free(base)
+#endif
 #include <stdarg.h>
 #include <ctype.h>
 
@@ -32,7 +37,16 @@ extern void libpinmame_log_error(const char* format, ...);
 // routines don't clip at boundaries of the bitmap.
 #define BITMAP_SAFETY			16
 
-#define MAX_MALLOCS				4096
+/* the malloc tracking list grows by this many entries at a time */
+#define MALLOC_LIST_GROW		1024
+
+/* small auto_malloc requests are carved from arena chunks of this size */
+#define ARENA_CHUNK_SIZE		(64 * 1024)
+#define ARENA_MAX_ALLOC			(4 * 1024)
+#define ARENA_ALIGN				16
+
+/* decoded samples are kept across games up to this many bytes */
+#define SAMPLE_CACHE_LIMIT		(32 * 1024 * 1024)
 
 
 
@@ -65,8 +79,14 @@ unsigned int coinlockedout[COIN_COUNTERS];
 int snapno;
 
 /* malloc tracking */
-static struct malloc_info malloc_list[MAX_MALLOCS];
+static struct malloc_info *malloc_list;
 static int malloc_list_index = 0;
+static int malloc_list_size = 0;
+
+/* current arena chunk for small allocations, only used for its own tag */
+static UINT8 *arena_ptr;
+static size_t arena_left;
+static int arena_tag = -1;
 
 /* resource tracking */
 int resource_tracking_tag = 0;
@@ -222,8 +242,8 @@ static struct GameSample *read_wav_sample(mame_file *f)
 			return NULL;
 	}
 
-	/* allocate the game sample */
-	result = auto_malloc(sizeof(struct GameSample) + length);
+	/* allocate the game sample; it is owned by the sample cache */
+	result = malloc(sizeof(struct GameSample) + length);
 	if (result == NULL)
 		return NULL;
 
@@ -253,7 +273,132 @@ static struct GameSample *read_wav_sample(mame_file *f)
 
 
 /*-------------------------------------------------
-	readsamples - load all samples
+	sample cache - decoded samples shared between
+	games, so switching tables doesn't reload them
+-------------------------------------------------*/
+
+struct sample_cache_entry
+{
+	struct sample_cache_entry *next;
+	char *dir;
+	char *name;
+	struct GameSample *sample;	/* NULL if the file couldn't be read */
+	UINT32 bytes;
+	UINT32 lastuse;
+	UINT32 epoch;				/* game session that last used it */
+};
+
+static struct sample_cache_entry *sample_cache;
+static UINT32 sample_cache_bytes;
+static UINT32 sample_cache_clock;
+static UINT32 sample_cache_epoch;
+static const struct GameDriver *sample_cache_game;
+
+static void sample_cache_evict(UINT32 needed)
+{
+	/* samples bound during the current game may still be playing, so only */
+	/* entries left over from earlier games are candidates */
+	while (sample_cache_bytes + needed > SAMPLE_CACHE_LIMIT)
+	{
+		struct sample_cache_entry **entry, **oldest = NULL;
+
+		for (entry = &sample_cache; *entry; entry = &(*entry)->next)
+			if ((*entry)->epoch != sample_cache_epoch && (*entry)->sample)
+				if (!oldest || (*entry)->lastuse < (*oldest)->lastuse)
+					oldest = entry;
+		if (!oldest)
+			return;
+
+		{
+			struct sample_cache_entry *victim = *oldest;
+			*oldest = victim->next;
+			sample_cache_bytes -= victim->bytes;
+			free(victim->sample);
+			free(victim->dir);
+			free(victim->name);
+			free(victim);
+		}
+	}
+}
+
+static struct sample_cache_entry *sample_cache_load(const char *dir, const char *name)
+{
+	struct sample_cache_entry *entry;
+	mame_file *f;
+
+	for (entry = sample_cache; entry; entry = entry->next)
+		if (strcmp(entry->dir, dir) == 0 && strcmp(entry->name, name) == 0)
+			break;
+
+	if (!entry)
+	{
+		f = mame_fopen(dir, name, FILETYPE_SAMPLE, 0);
+		if (f == 0)
+			return NULL;
+
+		entry = malloc(sizeof(*entry));
+		if (entry == NULL)
+		{
+			mame_fclose(f);
+			return NULL;
+		}
+		entry->sample = read_wav_sample(f);
+		mame_fclose(f);
+
+		entry->bytes = entry->sample ? sizeof(struct GameSample) + entry->sample->length : 0;
+		sample_cache_evict(entry->bytes);
+
+		entry->dir = malloc(strlen(dir) + 1);
+		entry->name = malloc(strlen(name) + 1);
+		if (entry->dir == NULL || entry->name == NULL)
+		{
+			free(entry->dir);
+			free(entry->name);
+			free(entry->sample);
+			free(entry);
+			return NULL;
+		}
+		strcpy(entry->dir, dir);
+		strcpy(entry->name, name);
+		entry->next = sample_cache;
+		sample_cache = entry;
+		sample_cache_bytes += entry->bytes;
+	}
+
+	entry->lastuse = ++sample_cache_clock;
+	entry->epoch = sample_cache_epoch;
+	return entry;
+}
+
+
+/*-------------------------------------------------
+	getsample - return a sample, reading it on
+	first use
+-------------------------------------------------*/
+
+struct GameSample *getsample(struct GameSamples *samples, int num)
+{
+	struct GameSampleSource *source = &samples->source[num];
+	struct sample_cache_entry *entry;
+
+	if (samples->sample[num] || source->name == NULL)
+		return samples->sample[num];
+
+	entry = sample_cache_load(source->dir, source->name);
+	if (!entry && source->altdir)
+		entry = sample_cache_load(source->altdir, source->name);
+
+	/* don't look for a missing file again */
+	source->name = NULL;
+	if (entry)
+		samples->sample[num] = entry->sample;
+	return samples->sample[num];
+}
+
+
+/*-------------------------------------------------
+	readsamples - prepare the samples; the WAV
+	data itself is read on first use
 -------------------------------------------------*/
 #ifdef VPINMAME
 extern int g_fMechSamples;
@@ -282,32 +427,31 @@ struct GameSamples *readsamples(const char **samplenames,const char *basename)
 
 	if ((samples = auto_malloc(sizeof(struct GameSamples) + (i-1)*sizeof(struct GameSample))) == 0)
 		return 0;
+	if ((samples->source = auto_malloc(i * sizeof(struct GameSampleSource))) == 0)
+		return 0;
+
+	/* a new game starts a new cache session */
+	if (sample_cache_game != Machine->gamedrv)
+	{
+		sample_cache_game = Machine->gamedrv;
+		sample_cache_epoch++;
+	}
 
 	samples->total = i;
 	for (i = 0;i < samples->total;i++)
+	{
 		samples->sample[i] = 0;
+		samples->source[i].dir = basename;
+		samples->source[i].altdir = skipfirst ? samplenames[0]+1 : NULL;
+		samples->source[i].name = samplenames[i+skipfirst][0] ? samplenames[i+skipfirst] : NULL;
+	}
 
 #ifdef VPINMAME
 	if ( (!g_fMechSamples) && _stricmp(*samplenames, "*pinmame")==0 )
-		return samples;
+		for (i = 0;i < samples->total;i++)
+			samples->source[i].name = NULL;
 #endif
 
-	for (i = 0;i < samples->total;i++)
-	{
-		if (samplenames[i+skipfirst][0])
-		{
-			mame_file *f;
-			if ((f = mame_fopen(basename,samplenames[i+skipfirst],FILETYPE_SAMPLE,0)) == 0)
-				if (skipfirst)
-					f = mame_fopen(samplenames[0]+1,samplenames[i+skipfirst],FILETYPE_SAMPLE,0);
-			if (f != 0)
-			{
-				samples->sample[i] = read_wav_sample(f);
-				mame_fclose(f);
-			}
-		}
-	}
-
 	return samples;
 }
 
@@ -372,10 +516,15 @@ size_t memory_region_length(int num)
 
 int new_memory_region(int num, size_t length, UINT32 flags)
 {
+    /* regions to be erased to 0 come from calloc: large blocks are then backed
+       by lazily mapped zero pages, so the parts never touched by the emulation
+       (e.g. most of the 80MB SAM CPU region) don't become resident */
+    const int zeroed = ((flags & ROMREGION_ERASEMASK) == ROMREGION_ERASE) && ((flags & ROMREGION_ERASEVALMASK) >> 8) == 0;
+
     if (num < MAX_MEMORY_REGIONS)
     {
         Machine->memory_region[num].length = length;
-        Machine->memory_region[num].base = malloc(length);
+        Machine->memory_region[num].base = zeroed ? calloc(1, length) : malloc(length);
         return (Machine->memory_region[num].base == NULL) ? 1 : 0;
     }
     else
@@ -388,7 +537,7 @@ int new_memory_region(int num, size_t length, UINT32 flags)
                 Machine->memory_region[i].length = length;
                 Machine->memory_region[i].type = num;
                 Machine->memory_region[i].flags = flags;
-                Machine->memory_region[i].base = malloc(length);
+                Machine->memory_region[i].base = zeroed ? calloc(1, length) : malloc(length);
                 return (Machine->memory_region[i].base == NULL) ? 1 : 0;
             }
         }
@@ -406,7 +555,7 @@ void free_memory_region(int num)
 {
 	if (num < MAX_MEMORY_REGIONS)
 	{
-		free(Machine->memory_region[num].base);
+		romshare_free(Machine->memory_region[num].base);
 		memset(&Machine->memory_region[num], 0, sizeof(Machine->memory_region[num]));
 	}
 	else
@@ -416,7 +565,7 @@ void free_memory_region(int num)
 		{
 			if (Machine->memory_region[i].type == num)
 			{
-				free(Machine->memory_region[i].base);
+				romshare_free(Machine->memory_region[i].base);
 				memset(&Machine->memory_region[i], 0, sizeof(Machine->memory_region[i]));
 				return;
 			}
@@ -662,7 +811,7 @@ void bitmap_free(struct mame_bitmap *bitmap)
 	auto_malloc - allocate auto-freeing memory
 -------------------------------------------------*/
 
-void *auto_malloc(size_t size)
+static void *auto_malloc_tracked(size_t size)
 {
 	void *result = malloc(size);
 	if (result)
@@ -670,10 +819,16 @@ void *auto_malloc(size_t size)
 		struct malloc_info *info;
 
 		/* make sure we have space */
-		if (malloc_list_index >= MAX_MALLOCS)
+		if (malloc_list_index >= malloc_list_size)
 		{
-			fprintf(stderr, "Out of malloc tracking slots!\n");
-			return result;
+			struct malloc_info *list = realloc(malloc_list, (malloc_list_size + MALLOC_LIST_GROW) * sizeof(*list));
+			if (!list)
+			{
+				fprintf(stderr, "Out of malloc tracking slots!\n");
+				return result;
+			}
+			malloc_list = list;
+			malloc_list_size += MALLOC_LIST_GROW;
 		}
 
 		/* fill in the current entry */
@@ -684,6 +839,35 @@ void *auto_malloc(size_t size)
 	return result;
 }
 
+void *auto_malloc(size_t size)
+{
+	void *result;
+
+	/* large blocks get their own allocation */
+	if (size > ARENA_MAX_ALLOC)
+		return auto_malloc_tracked(size);
+
+	/* small ones are bumped from a chunk owned by the current tag, */
+	/* so they are released with it in one go */
+	size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+	if (arena_tag != get_resource_tag() || arena_left < size)
+	{
+		arena_ptr = auto_malloc_tracked(ARENA_CHUNK_SIZE);
+		if (!arena_ptr)
+		{
+			arena_left = 0;
+			arena_tag = -1;
+			return NULL;
+		}
+		arena_left = ARENA_CHUNK_SIZE;
+		arena_tag = get_resource_tag();
+	}
+	result = arena_ptr;
+	arena_ptr += size;
+	arena_left -= size;
+	return result;
+}
+
 
 /*-------------------------------------------------
 	end_resource_tracking - stop tracking
@@ -700,6 +884,22 @@ void auto_free(void)
 		struct malloc_info *info = &malloc_list[--malloc_list_index];
 		free(info->ptr);
 	}
+
+	/* the current arena chunk went with it */
+	if (arena_tag >= tag)
+	{
+		arena_ptr = NULL;
+		arena_left = 0;
+		arena_tag = -1;
+	}
+
+	/* drop the list itself once nothing is tracked anymore */
+	if (malloc_list_index == 0)
+	{
+		free(malloc_list);
+		malloc_list = NULL;
+		malloc_list_size = 0;
+	}
 }
 
 
@@ -1882,9 +2082,12 @@ int rom_load(const struct RomModule *romp)
 		romdata.regionbase = memory_region(regiontype);
 		debugload("Allocated %X bytes @ %08X\n", romdata.regionlength, (size_t)romdata.regionbase);
 
-		/* clear the region if it's requested */
+		/* clear the region if it's requested (new_memory_region already did for 0) */
 		if (ROMREGION_ISERASE(region))
-			memset(romdata.regionbase, ROMREGION_GETERASEVAL(region), romdata.regionlength);
+		{
+			if (ROMREGION_GETERASEVAL(region) != 0)
+				memset(romdata.regionbase, ROMREGION_GETERASEVAL(region), romdata.regionlength);
+		}
 
 		/* or if it's sufficiently small (<= 4MB) */
 		else if (romdata.regionlength <= 0x400000)
@@ -1932,6 +2135,9 @@ int rom_load(const struct RomModule *romp)
 			regionlist[regiontype] = region;
 	}
 
+	/* remember the checksums of the files we just loaded */
+	mame_fhashcache_flush();
+
 	/* post-process the regions */
 	for (regnum = 0; regnum < REGION_MAX; regnum++)
 		if (regionlist[regnum])
@@ -1940,6 +2146,16 @@ int rom_load(const struct RomModule *romp)
 			romdata.regionlength = memory_region_length(regnum);
 			romdata.regionbase = memory_region(regnum);
 			region_post_process(&romdata, regionlist[regnum]);
+#ifdef PINMAME
+			/* the loaded ROM images are final now: share their pages with the other instances */
+			if (ROMREGION_ISROMDATA(regionlist[regnum]) && !ROMREGION_ISDISPOSE(regionlist[regnum]))
+			{
+				int i;
+				for (i = 0; i < MAX_MEMORY_REGIONS; i++)
+					if (Machine->memory_region[i].base == romdata.regionbase)
+						Machine->memory_region[i].base = romshare_map(romdata.regionbase, romdata.regionlength);
+			}
+#endif
 		}
 
 	/* display the results and exit */
@@ -99,9 +99,18 @@ struct rom_load_data
 };
 
 
+struct GameSampleSource
+{
+	const char *dir;				/* directory/zip to look in first */
+	const char *altdir;				/* shared directory, or NULL */
+	const char *name;				/* file name; NULL once looked up */
+};
+
+
 struct GameSamples
 {
 	int total;						/* total number of samples */
+	struct GameSampleSource *source;	/* where each sample is read from on first use */
 	struct GameSample *sample[1];	/* extendable */
 };
 
@@ -393,6 +402,8 @@ void showdisclaimer(void);
 /* helper function that reads samples from disk - this can be used by other */
 /* drivers as well (e.g. a sound chip emulator needing drum samples) */
 struct GameSamples *readsamples(const char **samplenames,const char *name);
+/* returns sample num, reading it from disk the first time it is used */
+struct GameSample *getsample(struct GameSamples *samples, int num);
 #define freesamples(samps)
 
 /* return a pointer to the specified memory region - num can be either an absolute */
@@ -720,6 +731,22 @@ INLINE unsigned long long __brevll(unsigned long long i)
 #endif
 }
 
+// index of the lowest set bit, input must not be 0!
+INLINE unsigned int __ctz(unsigned int i)
+{
+#if (defined(__GNUC__) && (__GNUC__ > 3)) || defined(__clang__)
+    return __builtin_ctz(i);
+#elif defined(_MSC_VER)
+    unsigned long r;
+    _BitScanForward(&r, i);
+    return r;
+#else
+    unsigned int r = 0;
+    while ((i & 1u) == 0) { i >>= 1; r++; }
+    return r;
+#endif
+}
+
 
 #ifdef __cplusplus
 }
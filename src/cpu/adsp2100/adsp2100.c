@@ -288,6 +288,11 @@ static UINT8 *condition_table = 0;
 static RX_CALLBACK sport_rx_callback = 0;
 static TX_CALLBACK sport_tx_callback = 0;
 
+/* direct data memory, each pointer is the base of its page */
+static UINT16 *data_read16[ADSP2100_DATA_PAGES];
+static UINT16 *data_write16[ADSP2100_DATA_PAGES];
+static const UINT8 *data_read8[ADSP2100_DATA_PAGES];
+
 #if TRACK_HOTSPOTS
 static UINT32 pcbucket[0x4000];
 #endif
@@ -307,12 +312,23 @@ static void check_irqs(void);
 
 INLINE UINT32 RWORD_DATA(UINT32 addr)
 {
+	const UINT32 page = (addr >> ADSP2100_DATA_PAGE_SHIFT) & (ADSP2100_DATA_PAGES - 1);
+	if (data_read16[page])
+		return data_read16[page][addr & ((1 << ADSP2100_DATA_PAGE_SHIFT) - 1)];
+	if (data_read8[page])
+		return data_read8[page][addr & ((1 << ADSP2100_DATA_PAGE_SHIFT) - 1)];
 	addr <<= 1;
 	return ADSP2100_RDMEM_WORD(ADSP2100_DATA_OFFSET + addr);
 }
 
 INLINE void WWORD_DATA(UINT32 addr, UINT32 data)
 {
+	const UINT32 page = (addr >> ADSP2100_DATA_PAGE_SHIFT) & (ADSP2100_DATA_PAGES - 1);
+	if (data_write16[page])
+	{
+		data_write16[page][addr & ((1 << ADSP2100_DATA_PAGE_SHIFT) - 1)] = data;
+		return;
+	}
 	addr <<= 1;
 	ADSP2100_WRMEM_WORD(ADSP2100_DATA_OFFSET + addr, data);
 }
@@ -341,7 +357,8 @@ INLINE void WWORD_PGM(UINT32 addr, UINT32 data)
 	ADSP2100_WRPGM(&OP_ROM[ADSP2100_PGM_OFFSET + addr], data);
 }
 
-#define ROPCODE() RWORD_PGM(adsp2100.pc)
+/* opcode fetches never target the DCS latch, so they skip the RWORD_PGM check */
+#define ROPCODE() (*(UINT32 *)&OP_ROM[ADSP2100_PGM_OFFSET + (adsp2100.pc << 2)])
 
 
 /*###################################################################################################
@@ -563,8 +580,32 @@ void adsp2100_init(void)
 		exit(-1);
 }
 
+void adsp2100_set_data_pages(UINT32 start, UINT32 end, UINT16 *read16, UINT16 *write16, const UINT8 *read8)
+{
+	UINT32 page;
+
+	for (page = start >> ADSP2100_DATA_PAGE_SHIFT; page <= (end >> ADSP2100_DATA_PAGE_SHIFT) && page < ADSP2100_DATA_PAGES; page++)
+	{
+		const UINT32 offset = (page << ADSP2100_DATA_PAGE_SHIFT) - start;
+		data_read16[page] = read16 ? read16 + offset : NULL;
+		data_write16[page] = write16 ? write16 + offset : NULL;
+		data_read8[page] = read8 ? read8 + offset : NULL;
+	}
+}
+
+
 void adsp2100_reset(void *param)
 {
+	int page;
+
+	/* plain RAM pages are accessed directly */
+	for (page = 0; page < ADSP2100_DATA_PAGES; page++)
+	{
+		UINT16 *ram = memory_get_ram_page(cpu_getactivecpu(), ADSP2100_DATA_OFFSET + (page << (ADSP2100_DATA_PAGE_SHIFT + 1)), 2 << ADSP2100_DATA_PAGE_SHIFT);
+		if (ram)
+			adsp2100_set_data_pages(page << ADSP2100_DATA_PAGE_SHIFT, ((page + 1) << ADSP2100_DATA_PAGE_SHIFT) - 1, ram, ram, NULL);
+	}
+
 	/* ensure that zero is zero */
 	adsp2100.core.zero.u = adsp2100.alt.zero.u = 0;
 
@@ -735,6 +776,8 @@ static int create_tables(void)
 
 void adsp2100_exit(void)
 {
+	adsp2100_set_data_pages(0, 0x3fff, NULL, NULL, NULL);
+
 	if (reverse_table)
 		free(reverse_table);
 	reverse_table = NULL;
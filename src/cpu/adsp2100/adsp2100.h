@@ -26,6 +26,10 @@
 #define ADSP2100_PGM_OFFSET		0x10000
 #define ADSP2100_SIZE			0x20000
 
+/* data memory pages that can be accessed without the memory handlers */
+#define ADSP2100_DATA_PAGE_SHIFT	9
+#define ADSP2100_DATA_PAGES			(0x4000 >> ADSP2100_DATA_PAGE_SHIFT)
+
 /* transmit and receive data callbacks types */
 typedef INT32 (*RX_CALLBACK)( int port );
 typedef void  (*TX_CALLBACK)( int port, INT32 data );
@@ -98,6 +102,12 @@ extern void adsp2100_set_irq_callback(int (*callback)(int irqline));
 extern const char *adsp2100_info(void *context, int regnum);
 extern unsigned adsp2100_dasm(char *buffer, unsigned pc);
 
+/* Maps the data memory words start-end (page aligned) straight to memory: 16-bit reads
+   and writes from read16/write16, or zero extended bytes from read8 for byte wide ROMs.
+   NULL pointers go through the memory handlers again. Plain RAM is mapped at reset,
+   banked ranges have to be remapped by the driver on each bank switch. */
+extern void adsp2100_set_data_pages(UINT32 start, UINT32 end, UINT16 *read16, UINT16 *write16, const UINT8 *read8);
+
 
 /****************************************************************************/
 /* Read a byte from given memory location                                   */
@@ -110,6 +110,130 @@ INLINE data32_t arm7_cpu_read32( int addr );
 INLINE data16_t arm7_cpu_read16( int addr );
 INLINE data8_t arm7_cpu_read8( int addr );
 
+/***************************************************************************
+ * Decode tables
+ *
+ * The interpreter (arm7exec.c) does not decode the condition and the
+ * instruction class bit by bit anymore, it looks them up:
+ * - bit n of arm7_cond_lut[cond] is set when cond passes with the
+ *   NZCV flags n (CPSR bits 31-28),
+ * - arm7_class_lut[] holds the instruction class for bits 27-20 and 7-4,
+ *   which are the only bits the class depends on, except for BX.
+ * The tables are indexed by the instruction bits rather than cached per
+ * address, so code written to RAM (SAM copies its program to the boot
+ * RAM) needs no invalidation.
+ ***************************************************************************/
+enum {
+	ARM7_CLASS_ALU = 0,		// Data Processing
+	ARM7_CLASS_PSR,			// PSR Transfer (MRS & MSR)
+	ARM7_CLASS_PSR_OR_BX,	// PSR Transfer, or BX if bits 19-8 are all set
+	ARM7_CLASS_MUL,
+	ARM7_CLASS_SMULL,
+	ARM7_CLASS_UMULL,
+	ARM7_CLASS_HALFWORD,	// Halfword Data Transfer
+	ARM7_CLASS_SWAP,
+	ARM7_CLASS_MEMSINGLE,	// Single Data Transfer
+	ARM7_CLASS_MEMBLOCK,	// Block Data Transfer
+	ARM7_CLASS_BRANCH,		// Branch or Branch & Link
+	ARM7_CLASS_COPRODT,		// Co-Processor Data Transfer
+	ARM7_CLASS_COPRORT,		// Co-Processor Register Transfer
+	ARM7_CLASS_COPRODO,		// Co-Processor Data Operation
+	ARM7_CLASS_SWI			// Software Interrupt
+};
+
+#define ARM7_CLASS_INDEX(insn)	((((insn) >> 16) & 0xff0) | (((insn) >> 4) & 0xf))
+
+static data16_t arm7_cond_lut[16];
+static data8_t arm7_class_lut[4096];
+
+static int arm7_decode_class(data32_t insn)
+{
+	switch ((insn & 0xF000000) >> 24)
+	{
+		/* Bits 27-24 = 0000 -> Can be Data Proc, Multiply, Multiply Long, Halfword Data Transfer */
+		case 0:
+			switch (insn & 0xf0)
+			{
+				case 0x90:
+					if (insn & 0x800000)
+						return (insn & 0x00400000) ? ARM7_CLASS_SMULL : ARM7_CLASS_UMULL;
+					return ARM7_CLASS_MUL;
+				case 0xb0:
+				case 0xd0:
+					return ARM7_CLASS_HALFWORD;
+				default:
+					return ARM7_CLASS_ALU;
+			}
+
+		/* Bits 27-24 = 0001 -> Can be BX, SWP, Halfword Data Transfer, Data Proc/PSR Transfer */
+		case 1:
+			if ((insn & 0x0ff000f0) == 0x01200010)
+				return ARM7_CLASS_PSR_OR_BX;
+			if ((insn & 0x80) && (insn & 0x10))
+				return (insn & 0x60) ? ARM7_CLASS_HALFWORD : ARM7_CLASS_SWAP;
+			/* fall through */
+
+		/* Bits 27-24 = 0011 OR 0010 -> Can only be Data Proc/PSR Transfer */
+		case 2:
+		case 3:
+			if (((insn & 0x0100000) == 0) && ((insn & 0x01800000) == 0x01000000)) //( S bit must be clear, and bit 24,23 = 10 )
+				return ARM7_CLASS_PSR;
+			return ARM7_CLASS_ALU;
+
+		case 4: case 5: case 6: case 7:
+			return ARM7_CLASS_MEMSINGLE;
+		case 8: case 9:
+			return ARM7_CLASS_MEMBLOCK;
+		case 0xa: case 0xb:
+			return ARM7_CLASS_BRANCH;
+		case 0xc: case 0xd:
+			return ARM7_CLASS_COPRODT;
+		case 0xe:
+			return (insn & 0x10) ? ARM7_CLASS_COPRORT : ARM7_CLASS_COPRODO;
+		default:
+			return ARM7_CLASS_SWI;
+	}
+}
+
+static void arm7_build_decode_tables(void)
+{
+	int cond, flags, i;
+
+	for (cond = 0; cond < 16; cond++)
+	{
+		arm7_cond_lut[cond] = 0;
+		for (flags = 0; flags < 16; flags++)
+		{
+			const int n = (flags >> 3) & 1, z = (flags >> 2) & 1, c = (flags >> 1) & 1, v = flags & 1;
+			int pass = 0;
+			switch (cond)
+			{
+				case COND_EQ: pass = z; break;
+				case COND_NE: pass = !z; break;
+				case COND_CS: pass = c; break;
+				case COND_CC: pass = !c; break;
+				case COND_MI: pass = n; break;
+				case COND_PL: pass = !n; break;
+				case COND_VS: pass = v; break;
+				case COND_VC: pass = !v; break;
+				case COND_HI: pass = c && !z; break;
+				case COND_LS: pass = !c || z; break;
+				case COND_GE: pass = n == v; break;
+				case COND_LT: pass = n != v; break;
+				case COND_GT: pass = !z && n == v; break;
+				case COND_LE: pass = z || n != v; break;
+				case COND_AL: pass = 1; break;
+				case COND_NV: pass = 0; break;
+			}
+			if (pass)
+				arm7_cond_lut[cond] |= 1 << flags;
+		}
+	}
+
+	for (i = 0; i < 4096; i++)
+		arm7_class_lut[i] = (data8_t)arm7_decode_class(((data32_t)(i >> 4) << 20) | ((data32_t)(i & 0xf) << 4));
+}
+
 /***************************************************************************
  * Default Memory Handlers 
  ***************************************************************************/
@@ -117,6 +241,7 @@ INLINE void arm7_cpu_write32( int addr, data32_t data )
 {
 	//Call normal 32 bit handler
 	cpu_writemem32ledw_dword(addr,data);
+	JIT_NOTIFY_WRITE(ARM7.jit, addr, 4);
 
 	/* Unaligned writes are treated as normal writes */
 	#if ARM7_DEBUG_CORE
@@ -130,12 +255,14 @@ INLINE void arm7_cpu_write16( int addr, data16_t data )
 {
 	//Call normal 16 bit handler ( for 32 bit cpu )
 	cpu_writemem32ledw_word(addr,data);
+	JIT_NOTIFY_WRITE(ARM7.jit, addr, 2);
 }
 
 INLINE void arm7_cpu_write8( int addr, data8_t data )
 {
 	//Call normal 8 bit handler ( for 32 bit cpu )
 	cpu_writemem32ledw(addr,data);
+	JIT_NOTIFY_WRITE(ARM7.jit, addr, 1);
 }
 
 INLINE data32_t arm7_cpu_read32( int addr )
@@ -656,6 +783,8 @@ static void arm7_core_init(const char *cpuname)
 	state_save_register_UINT8(cpuname, cpu, "UND", &ARM7.pendingUnd, 1);
 	state_save_register_UINT8(cpuname, cpu, "SWI", &ARM7.pendingSwi, 1);
 
+	arm7_build_decode_tables();
+
 	// create the JIT translator
 	ARM7.jit = jit_create(&ARM7_ICOUNT);
 	jit_set_mem_callbacks(
@@ -1086,10 +1215,6 @@ static void HandleMemSingle( data32_t insn )
 
 			//WRITE32(rnv, rd == eR15 ? R15 + 8 : GET_REGISTER(rd));
 			WRITE32(rnv, rd == eR15 ? R15 + 8 + 4 : GET_REGISTER(rd)); //manual says STR rd = PC, +12
-#if JIT_ENABLED
-			// This is to handle code in self-modifying color patches.
-			jit_untranslate(ARM7.jit, rnv);
-#endif
 		}
 		//Store takes only 2 N Cycles, so add + 1
 		ARM7_ICOUNT += 1;
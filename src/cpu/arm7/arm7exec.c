@@ -146,7 +146,6 @@ extern unsigned at91_get_reg(int regnum);
 	data32_t pc;
 	static data32_t pc_prev2 = 0, pc_prev1 = 0;
 	data32_t insn;
-	int op_offset;
 
 	RESET_ICOUNT
 	do
@@ -169,111 +168,31 @@ extern unsigned at91_get_reg(int regnum);
 
 		JIT_FETCH(ARM7.jit, pc);
 		insn = cpu_readop32(pc);
-		op_offset = 0;
 
 		pc_prev2 = pc_prev1;
 		pc_prev1 = pc;
 
-		/* process condition codes for this instruction */
-		switch (insn >> INSN_COND_SHIFT)
+		/* process condition codes for this instruction (see arm7_cond_lut) */
+		if (!((arm7_cond_lut[insn >> INSN_COND_SHIFT] >> (GET_CPSR >> 28)) & 1))
 		{
-		case COND_EQ:
-			if (Z_IS_CLEAR(GET_CPSR)) goto L_Next;
-			break;
-		case COND_NE:
-			if (Z_IS_SET(GET_CPSR)) goto L_Next;
-			break;
-		case COND_CS:
-			if (C_IS_CLEAR(GET_CPSR)) goto L_Next;
-			break;
-		case COND_CC:
-			if (C_IS_SET(GET_CPSR)) goto L_Next;
-			break;
-		case COND_MI:
-			if (N_IS_CLEAR(GET_CPSR)) goto L_Next;
-			break;
-		case COND_PL:
-			if (N_IS_SET(GET_CPSR)) goto L_Next;
-			break;
-		case COND_VS:
-			if (V_IS_CLEAR(GET_CPSR)) goto L_Next;
-			break;
-		case COND_VC:
-			if (V_IS_SET(GET_CPSR)) goto L_Next;
-			break;
-		case COND_HI:
-			if (C_IS_CLEAR(GET_CPSR) || Z_IS_SET(GET_CPSR)) goto L_Next;
-			break;
-		case COND_LS:
-			if (C_IS_SET(GET_CPSR) && Z_IS_CLEAR(GET_CPSR)) goto L_Next;
-			break;
-		case COND_GE:
-			if (!(GET_CPSR & N_MASK) != !(GET_CPSR & V_MASK)) goto L_Next; /* Use x ^ (x >> ...) method */
-			break;
-		case COND_LT:
-			if (!(GET_CPSR & N_MASK) == !(GET_CPSR & V_MASK)) goto L_Next;
-			break;
-		case COND_GT:
-			if (Z_IS_SET(GET_CPSR) || (!(GET_CPSR & N_MASK) != !(GET_CPSR & V_MASK))) goto L_Next;
-			break;
-		case COND_LE:
-			if (Z_IS_CLEAR(GET_CPSR) && (!(GET_CPSR & N_MASK) == !(GET_CPSR & V_MASK))) goto L_Next;
-			break;
-		case COND_NV:
 #ifdef ARM9
-			if (m_archRev < 5)
+			if ((insn >> INSN_COND_SHIFT) == COND_NV && m_archRev >= 5)
+				goto L_Undefined;
 #endif
-				goto L_Next;
-#ifdef ARM9
-			else
-				op_offset = 0x10;
-#endif
-			break;
+			goto L_Next;
 		}
 		/*******************************************************************/
 		/* If we got here - condition satisfied, so decode the instruction */
-		/*******************************************************************/		
-		switch( ((insn & 0xF000000)>>24) + op_offset)
+		/*******************************************************************/
+		switch (arm7_class_lut[ARM7_CLASS_INDEX(insn)])
 		{
-			/* Bits 27-24 = 0000 -> Can be Data Proc, Multiply, Multiply Long, Halfword Data Transfer */
-			case 0:
-				/* Bits 7-4 */
-				switch(insn & 0xf0)
-				{
-					// Multiply, Multiply Long
-					case 0x90:		//1001
-						/* multiply long */
-						if( insn&0x800000 )	//Bit 23 = 1 for Multiply Long
-						{
-							/* Signed? */
-							if( insn&0x00400000 )
-								HandleSMulLong(insn);
-							else
-								HandleUMulLong(insn);
-						}
-						/* multiply */
-						else
-						{
-							HandleMul(insn);
-						}
-						R15 += 4;
-						break;
-
-					// Halfword Data Transfer
-					case 0xb0:		//1011
-					case 0xd0:		//1101
-						HandleHalfWordDT(insn);
-						break;
-					// Data Proc (Cannot be PSR Transfer since bit 24 = 0)
-					default:
-						HandleALU(insn);
-				}
+			/* Data Processing */
+			case ARM7_CLASS_ALU:
+				HandleALU(insn);
 				break;
 
-			/* Bits 27-24 = 0001 -> Can be BX, SWP, Halfword Data Transfer, Data Proc/PSR Transfer */
-			case 1:
-
-				/* Branch and Exchange (BX) */
+			/* Branch and Exchange (BX), has the same bits 27-20 and 7-4 as a MRS */
+			case ARM7_CLASS_PSR_OR_BX:
 				if( (insn&0x0ffffff0)==0x012fff10 )		//bits 27-4 == 000100101111111111110001
 				{ 
 					R15 = GET_REGISTER(insn & 0x0f);
@@ -282,99 +201,82 @@ extern unsigned at91_get_reg(int regnum);
 						SET_CPSR(GET_CPSR|T_BIT);
 						LOG(("%08x: Setting Thumb Mode due to R15 change to %08x - but not supported\n",pc,R15));
 					}
+					break;
 				}
-				else
-				/* Swap OR Half Word Data Transfer OR Data Proc/PSR Transfer */
-				if( (insn & 0x80) && (insn & 0x10) )	// bit 7=1, bit 4=1
-				{
-					/* Half Word Data Transfer */
-					if(insn & 0x60)			//bits = 6-5 != 00
-					{
-						HandleHalfWordDT(insn);
-					}
-					else 
-					/* Swap */
-					{
-						HandleSwap(insn);
-					}
-				}
-				else
-				/* Data Processing OR PSR Transfer */
-				{
-					/* PSR Transfer (MRS & MSR) */
-					if( ((insn&0x0100000)==0) && ((insn&0x01800000)==0x01000000) ) //( S bit must be clear, and bit 24,23 = 10 )
-					{
-						HandlePSRTransfer(insn);
-						ARM7_ICOUNT += 2;		//PSR only takes 1 - S Cycle, so we add + 2, since at end, we -3..
-						R15 += 4;
-					}
-					/* Data Processing */
-					else
-					{
-						HandleALU(insn);
-					}
-				}
+				/* fall through */
+
+			/* PSR Transfer (MRS & MSR) */
+			case ARM7_CLASS_PSR:
+				HandlePSRTransfer(insn);
+				ARM7_ICOUNT += 2;		//PSR only takes 1 - S Cycle, so we add + 2, since at end, we -3..
+				R15 += 4;
 				break;
 
-			/* Bits 27-24 = 0011 OR 0010 -> Can only be Data Proc/PSR Transfer */
-			case 2:
-			case 3:
-				/* PSR Transfer (MRS & MSR) */
-				if( ((insn&0x0100000)==0) && ((insn&0x01800000)==0x01000000) ) //( S bit must be clear, and bit 24,23 = 10 )
-				{
-					HandlePSRTransfer(insn);
-					ARM7_ICOUNT += 2;		//PSR only takes 1 - S Cycle, so we add + 2, since at end, we -3..
-					R15 += 4;
-				}
-				/* Data Processing */
-				else
-				{
-					HandleALU(insn);
-				}
+			/* Multiply, Multiply Long */
+			case ARM7_CLASS_MUL:
+				HandleMul(insn);
+				R15 += 4;
+				break;
+			case ARM7_CLASS_SMULL:
+				HandleSMulLong(insn);
+				R15 += 4;
+				break;
+			case ARM7_CLASS_UMULL:
+				HandleUMulLong(insn);
+				R15 += 4;
+				break;
+
+			/* Half Word Data Transfer */
+			case ARM7_CLASS_HALFWORD:
+				HandleHalfWordDT(insn);
+				break;
+
+			/* Swap */
+			case ARM7_CLASS_SWAP:
+				HandleSwap(insn);
 				break;
 
 			/* Data Transfer - Single Data Access */
-			case 4:
-			case 5:
-			case 6:
-			case 7:
+			case ARM7_CLASS_MEMSINGLE:
 				HandleMemSingle(insn);
 				R15 += 4;
 				ARM7_CHECKIRQ;
 				break;
 			/* Block Data Transfer/Access */
-			case 8:
-			case 9:
+			case ARM7_CLASS_MEMBLOCK:
 				HandleMemBlock(insn);
 				R15 += 4;
 				break;
 			/* Branch or Branch & Link */
-			case 0xa:
-			case 0xb:
+			case ARM7_CLASS_BRANCH:
 				HandleBranch(insn, 0);
 				break;
 			/* Co-Processor Data Transfer */
-			case 0xc:
-			case 0xd:
+			case ARM7_CLASS_COPRODT:
 				HandleCoProcDT(insn);
 				R15 += 4;
 				break;
-			/* Co-Processor Data Operation or Register Transfer */
-			case 0xe:
-				if(insn & 0x10)
-					HandleCoProcRT(insn);
-				else
-					HandleCoProcDO(insn);
+			/* Co-Processor Register Transfer */
+			case ARM7_CLASS_COPRORT:
+				HandleCoProcRT(insn);
+				R15 += 4;
+				break;
+			/* Co-Processor Data Operation */
+			case ARM7_CLASS_COPRODO:
+				HandleCoProcDO(insn);
 				R15 += 4;
 				break;
 			/* Software Interrupt */
-			case 0x0f:
+			case ARM7_CLASS_SWI:
 				ARM7.pendingSwi = 1;
 				ARM7_CHECKIRQ;
 				//couldn't find any cycle counts for SWI
 				break;
 			/* Undefined */
 			default:
+#ifdef ARM9
+			L_Undefined:
+#endif
 				ARM7.pendingSwi = 1;
 
 				ARM7_ICOUNT -= 1;				//undefined takes 4 cycles (page 77)
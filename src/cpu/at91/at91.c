@@ -218,6 +218,7 @@ int at91_irqstack[31];
 int at91_irqstackpos = 0;
 
 #define AT91_RECEIVE_BUFFER_SIZE 512
+#define AT91_USART_PDC_BLOCK 16		// Max bytes moved by the PDC per serial timer event
 
 #define US_DMSI         (1<<10)
 #define US_TXEMPTY      (1<<9)
@@ -244,6 +245,9 @@ typedef struct
 	data32_t US_BRGR;
 	data32_t US_RCR;
 	int pending_THR;
+	double byte_period;		// Time to shift one character at the programmed baud rate, 0 if disabled
+	int block_pending;		// A PDC block is being shifted, pending_CSR is raised at its end
+	data32_t pending_CSR;
 	// Internal AT91 receive buffer (circular buffer)
 	int at91_rbuf_head;
 	int at91_rbuf_tail;
@@ -280,6 +284,11 @@ void at91_init_jit(int min_addr, int max_addr)
 	jit_create_map(at91.jit, min_addr, max_addr);
 }
 
+void at91_jit_invalidate(data32_t addr, data32_t len)
+{
+	jit_untranslate_range(at91.jit, addr, len, 1);
+}
+
 //used for debugging
 static char temp[256];
 
@@ -422,6 +431,20 @@ void at91_irqcheck(void)
 	arm7_check_irq_state();
 }
 
+// The serial timer only runs while there is something to shift (PDC transfer, pending
+// THR or an armed PDC receive) instead of ticking at the byte rate forever. An armed
+// receive keeps polling since at91_receive_serial may be called from another thread.
+static int at91_serial_has_work(int usartno)
+{
+	return (at91usart[usartno].US_TCR > 0) || (at91usart[usartno].US_RCR > 0) || at91usart[usartno].pending_THR || at91usart[usartno].block_pending;
+}
+
+static void at91_serial_kick(int usartno)
+{
+	if ((at91usart[usartno].byte_period > 0) && !timer_enabled(at91_serial_timer[usartno]) && at91_serial_has_work(usartno))
+		timer_adjust(at91_serial_timer[usartno], at91usart[usartno].byte_period, usartno, 0);
+}
+
 void at91_adjust_serial_baud_rate(int usartno)
 {
 	if (at91usart[usartno].US_BRGR)
@@ -437,13 +460,15 @@ void at91_adjust_serial_baud_rate(int usartno)
 		                 : 9600;                                            // SCK (external clock, not implemented)
 		double bitPerByte = (MODE9 ? 9 : (CHRL + 5)) + (NBSTOP / 2.0);
 		LOG(("%08x: AT91-USART%d BYTE RATE = %8.1f bytes per second\n", activecpu_get_pc(), usartno + 1, uartClock / bitPerByte));
-		timer_adjust(at91_serial_timer[usartno], TIME_IN_HZ(uartClock / bitPerByte), usartno, TIME_IN_HZ(uartClock / bitPerByte));
+		at91usart[usartno].byte_period = TIME_IN_HZ(uartClock / bitPerByte);
 	}
 	else
 	{
 		LOG(("%08x: AT91-USART%d BYTE RATE = 0 (disabled)\n", activecpu_get_pc(), usartno + 1));
-		timer_enable(at91_serial_timer[usartno], 0);
+		at91usart[usartno].byte_period = 0;
 	}
+	timer_enable(at91_serial_timer[usartno], 0);
+	at91_serial_kick(usartno);
 }
 
 static data8_t at91_serial_receive_next_byte(int usartno)
@@ -462,22 +487,50 @@ static data8_t at91_serial_receive_next_byte(int usartno)
 	return rcvByte;
 }
 
+static void at91_serial_apply_csr(int usartno, data32_t csrSetFlag)
+{
+	// Apply CSR flag changes and eventually fire IRQ
+	at91usart[usartno].US_CSR |= csrSetFlag;
+	if (at91usart[usartno].US_IMR & csrSetFlag)
+	{
+		at91_fire_irq(AT91_USART_IRQ(usartno));
+	}
+}
+
+// PDC transfers are serviced in blocks of up to AT91_USART_PDC_BLOCK bytes per event: the
+// bytes of a block are moved at once, and the resulting flags are raised when the last
+// byte of the block would have been shifted, so ENDTX/ENDRX keep their timing.
 static void at91_serial_timer_event(int usartno)
 {
 	data32_t csrSetFlag = 0;
+	int span = 1;
+
+	// End of the previous PDC block
+	if (at91usart[usartno].block_pending)
+	{
+		at91usart[usartno].block_pending = 0;
+		at91_serial_apply_csr(usartno, at91usart[usartno].pending_CSR);
+		at91usart[usartno].pending_CSR = 0;
+		at91_serial_kick(usartno);
+		return;
+	}
 
 	// Transmit
 	if (at91usart[usartno].US_TCR > 0)
 	{
 		// Peripheral Data Controller has pending data
+		int count = at91usart[usartno].US_TCR < AT91_USART_PDC_BLOCK ? at91usart[usartno].US_TCR : AT91_USART_PDC_BLOCK;
 		if (at91_transmit_serial)
 		{
-			data8_t data = cpu_readmem32ledw(at91usart[usartno].US_TPR);
-			LOG(("AT91-USART%d Transmit %02x (PDC) [t=%8.6f]\n", usartno + 1, data, timer_get_time()));
-			at91_transmit_serial(usartno, &data, 1);
+			data8_t data[AT91_USART_PDC_BLOCK];
+			for (int i = 0; i < count; i++)
+				data[i] = cpu_readmem32ledw(at91usart[usartno].US_TPR + i);
+			LOG(("AT91-USART%d Transmit %d bytes, first %02x (PDC) [t=%8.6f]\n", usartno + 1, count, data[0], timer_get_time()));
+			at91_transmit_serial(usartno, data, count);
 		}
-		at91usart[usartno].US_TPR++;
-		at91usart[usartno].US_TCR--;
+		at91usart[usartno].US_TPR += count;
+		at91usart[usartno].US_TCR -= count;
+		span = count;
 		if (at91usart[usartno].US_TCR == 0)
 		{
 			csrSetFlag |= ~at91usart[usartno].US_CSR & US_ENDTX;
@@ -502,23 +555,34 @@ static void at91_serial_timer_event(int usartno)
 	// Receive
 	if ((at91usart[usartno].US_RCR > 0) && (at91usart[usartno].at91_rbuf_tail != at91usart[usartno].at91_rbuf_head))
 	{
-		LOG(("AT91-USART%d Receive %02x (PDC write at %08x) [t=%8.6f]\n", usartno + 1, at91usart[usartno].at91_receivebuf[at91usart[usartno].at91_rbuf_tail], at91usart[usartno].US_RPR, timer_get_time()));
-		data8_t data = at91_serial_receive_next_byte(usartno);
-		cpu_writemem32ledw(at91usart[usartno].US_RPR, data);
-		at91usart[usartno].US_RPR++;
-		at91usart[usartno].US_RCR--;
+		int count = 0;
+		do
+		{
+			LOG(("AT91-USART%d Receive %02x (PDC write at %08x) [t=%8.6f]\n", usartno + 1, at91usart[usartno].at91_receivebuf[at91usart[usartno].at91_rbuf_tail], at91usart[usartno].US_RPR, timer_get_time()));
+			data8_t data = at91_serial_receive_next_byte(usartno);
+			cpu_writemem32ledw(at91usart[usartno].US_RPR, data);
+			at91usart[usartno].US_RPR++;
+			at91usart[usartno].US_RCR--;
+			count++;
+		} while ((count < AT91_USART_PDC_BLOCK) && (at91usart[usartno].US_RCR > 0) && (at91usart[usartno].at91_rbuf_tail != at91usart[usartno].at91_rbuf_head));
+		if (count > span)
+			span = count;
 		if (at91usart[usartno].US_RCR == 0)
 		{
 			csrSetFlag |= ~at91usart[usartno].US_CSR & US_ENDRX;
 		}
 	}
 
-	// Apply CSR flag changes and eventually fire IRQ
-	at91usart[usartno].US_CSR |= csrSetFlag;
-	if (at91usart[usartno].US_IMR & csrSetFlag)
+	if (span > 1)
 	{
-		at91_fire_irq(AT91_USART_IRQ(usartno));
+		at91usart[usartno].block_pending = 1;
+		at91usart[usartno].pending_CSR = csrSetFlag;
+		timer_adjust(at91_serial_timer[usartno], (span - 1) * at91usart[usartno].byte_period, usartno, 0);
+		return;
 	}
+
+	at91_serial_apply_csr(usartno, csrSetFlag);
+	at91_serial_kick(usartno);
 }
 
 int at91_receive_serial(int usartno, data8_t *buf, int size)
@@ -636,6 +700,7 @@ void at91_usart_write(int usartno, int addr, data32_t outdata)
 		at91usart[usartno].pending_THR = 1;
 		at91usart[usartno].US_THR = outdata;
 		at91usart[usartno].US_CSR &= ~(US_TXRDY | US_TXEMPTY);
+		at91_serial_kick(usartno);
 		break;
 	case 0x08:  // Baud Rate Generator Register
 		at91usart[usartno].US_BRGR = outdata;
@@ -654,6 +719,7 @@ void at91_usart_write(int usartno, int addr, data32_t outdata)
 		at91usart[usartno].US_RCR = outdata; // Receive counter
 		if (outdata > 0)
 			at91usart[usartno].US_CSR &= ~US_ENDRX;
+		at91_serial_kick(usartno);
 		break;
 	case 0x0e:  // Transmit pointer
 		at91usart[usartno].US_TPR = outdata;
@@ -662,6 +728,7 @@ void at91_usart_write(int usartno, int addr, data32_t outdata)
 		at91usart[usartno].US_TCR = outdata;
 		if (outdata > 0)
 			at91usart[usartno].US_CSR &= ~(US_ENDTX | US_TXRDY | US_TXEMPTY);
+		at91_serial_kick(usartno);
 		break;
 	default:
 		assert(0); // Read only registers
@@ -741,6 +808,7 @@ INLINE void internal_write (int addr, data32_t data)
 							{
 								//Copy Reset RAM Contents into Page 0 RAM Address
 								memcpy(at91rs.page0_ram_ptr, at91rs.reset_ram_ptr, 0x100000);
+								jit_untranslate_range(at91.jit, 0, 0x100000, 1);
 								at91.remap = 1;
 								LOG(("%08x: AT91-EBI_RCR = 1 (RAM @ 0x300000 remapped to 0x0)!\n",activecpu_get_pc()));
 
@@ -1525,6 +1593,7 @@ INLINE void at91_cpu_write32( int addr, data32_t data )
 
 	//Call normal 32 bit handler
 	cpu_writemem32ledw_dword(addr,data);
+	JIT_NOTIFY_WRITE(at91.jit, addr, 4);
 
 	/* Unaligned writes are treated as normal writes */
 	#ifdef AT91_DEBUG_CORE
@@ -1545,6 +1614,7 @@ INLINE void at91_cpu_write16( int addr, data16_t data )
 
 	//Call normal 16 bit handler ( for 32 bit cpu )
 	cpu_writemem32ledw_word(addr,data);
+	JIT_NOTIFY_WRITE(at91.jit, addr, 2);
 }
 
 INLINE void at91_cpu_write8( int addr, data8_t data )
@@ -1558,6 +1628,7 @@ INLINE void at91_cpu_write8( int addr, data8_t data )
 
 	//Call normal 8 bit handler ( for 32 bit cpu )
 	cpu_writemem32ledw(addr,data);
+	JIT_NOTIFY_WRITE(at91.jit, addr, 1);
 }
 
 INLINE data32_t at91_cpu_read32( int addr )
@@ -87,6 +87,7 @@ extern void at91_set_reg(int regnum, unsigned val);
 //interfaces to the drivers using the chip
 extern void at91_set_ram_pointers(data32_t *reset_ram_ptr, data32_t *page0_ram_ptr);
 extern void at91_init_jit(int min_addr, int max_addr);
+extern void at91_jit_invalidate(data32_t addr, data32_t len); // memory at addr was replaced (bank switch), drop its translated code
 extern void at91_cs_callback_r(offs_t start, offs_t end, READ32_HANDLER((*callback)));
 extern void at91_cs_callback_w(offs_t start, offs_t end, WRITE32_HANDLER((*callback)));
 extern void at91_ready_irq_callback_w(WRITE32_HANDLER((*callback)));
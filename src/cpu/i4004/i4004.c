@@ -32,11 +32,14 @@ static UINT8 i4004_win_layout[] = {
 	 0,23,80, 1,	/* command line window (bottom rows) */
 };
 
+#define I4004_RAM_PAGES 32
+
 typedef struct {
 	int 	cputype;	/* 0 = 4004 */
 	PAIR	PC, S1, S2, S3, ramaddr;
 	UINT8	R01, R23, R45, R67, R89, RAB, RCD, REF;
 	INT8	accu, carry, test;
+	UINT8	*ram[I4004_RAM_PAGES];	/* direct pointers to plain RAM pages at 0x1000-0x2fff, NULL goes through the memory system */
 }	i4004_Regs;
 
 int i4004_ICount = 0;
@@ -55,12 +58,17 @@ static UINT8 ARG(void)
 
 static UINT8 RM(UINT32 a)
 {
+	if (a - 0x1000 < 0x2000 && I.ram[(a - 0x1000) >> 8])
+		return I.ram[(a - 0x1000) >> 8][a & 0xff];
 	return cpu_readmem16(a);
 }
 
 static void WM(UINT32 a, UINT8 v)
 {
-	cpu_writemem16(a, v);
+	if (a - 0x1000 < 0x2000 && I.ram[(a - 0x1000) >> 8])
+		I.ram[(a - 0x1000) >> 8][a & 0xff] = v;
+	else
+		cpu_writemem16(a, v);
 }
 
 static void illegal(void)
@@ -832,8 +840,11 @@ void i4004_init(void)
 void i4004_reset(void *param)
 {
 	int testSave = I.test;
+	int i;
 	memset(&I, 0, sizeof(i4004_Regs));
 	I.test = testSave;
+	for (i = 0; i < I4004_RAM_PAGES; i++)
+		I.ram[i] = memory_get_ram_page(cpu_getactivecpu(), 0x1000 + (i << 8), 0x100);
 	change_pc16(I.PC.d);
 }
 
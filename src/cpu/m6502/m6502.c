@@ -30,6 +30,15 @@
 #include "mamedbg.h"
 #include "m6502.h"
 #include "ops02.h"
+
+/* With GCC/Clang, run the plain 6502 opcode table as threaded code */
+#ifndef M6502_COMPUTED_GOTO
+#if defined(__GNUC__)
+#define M6502_COMPUTED_GOTO 1
+#else
+#define M6502_COMPUTED_GOTO 0
+#endif
+#endif
 #include "ill02.h"
 
 
@@ -127,12 +136,81 @@ typedef struct
 	UINT8	irq_state;
 	UINT8   so_state;
 	int 	(*irq_callback)(int irqline);	/* IRQ callback */
+	UINT8	idle_detect;	/* CPU_IDLE_DETECT set for this CPU */
+	UINT8	idle_write;		/* memory written since the last backward branch */
+	UINT8	idle_count; 	/* times the same poll loop was seen unchanged */
+	UINT16	idle_pc;		/* address of the branch closing the loop */
+	UINT32	idle_regs[2];	/* registers when the branch was last taken */
+	UINT32	idle_skips; 	/* number of time slices skipped */
 }	m6502_Regs;
 
 int m6502_ICount = 0;
 
 static m6502_Regs m6502;
 
+/* number of unchanged passes through a poll loop before it is skipped */
+#define M6502_IDLE_PASSES	4
+
+/****************************************************************************
+ * Poll loop detection: called when a short branch is taken backwards. If
+ * the same branch is taken again with the registers unchanged and no memory
+ * written in between, the loop only reads and can only be left by an
+ * interrupt or an input change, so the rest of the time slice (which ends
+ * at the next timer) is eaten.
+ ****************************************************************************/
+static void m6502_check_idle_loop(void)
+{
+	const UINT32 r0 = A | (X << 8) | (Y << 16) | (P << 24), r1 = S;
+
+	if (m6502.idle_pc == PPC && !m6502.idle_write &&
+		m6502.idle_regs[0] == r0 && m6502.idle_regs[1] == r1)
+	{
+		if (++m6502.idle_count >= M6502_IDLE_PASSES && m6502_ICount > 0)
+		{
+			m6502.idle_skips++;
+			m6502_ICount = 0;
+		}
+	}
+	else
+	{
+		m6502.idle_pc = PPC;
+		m6502.idle_count = 0;
+		m6502.idle_regs[0] = r0;
+		m6502.idle_regs[1] = r1;
+	}
+	m6502.idle_write = 0;
+}
+
+/* the opcodes below note their writes and check their short backward branches */
+#undef WRMEM
+#if FAST_MEMORY
+#define WRMEM(addr,data)										\
+	if ((m6502.idle_write = 1), cur_mwhard[(addr) >> (ABITS2_16 + ABITS_MIN_16)]) \
+		cpu_writemem16(addr,data);								\
+	else														\
+		RAM[addr] = data
+#else
+#define WRMEM(addr,data) (m6502.idle_write = 1, cpu_writemem16(addr,data))
+#endif
+
+#undef BRA
+#define BRA(cond)												\
+	if (cond)													\
+	{															\
+		tmp = RDOPARG();										\
+		EAW = PCW + (signed char)tmp;							\
+		m6502_ICount -= (PCH == EAH) ? 3 : 4;					\
+		PCD = EAD;												\
+		CHANGE_PC;												\
+		if (tmp >= 0xf0 && m6502.idle_detect)					\
+			m6502_check_idle_loop();							\
+	}															\
+	else														\
+	{															\
+		PCW++;													\
+		m6502_ICount -= 2;										\
+	}
+
 /***************************************************************
  * include the opcode macros, functions and tables
  ***************************************************************/
@@ -185,11 +263,18 @@ static void m6502_state_register(const char *type)
 	state_save_register_UINT8 (type, cpu, "so_state", &m6502.so_state, 1);
 }
 
+static void m6502_idle_init(void)
+{
+	m6502.idle_detect = (Machine->drv->cpu[cpu_getactivecpu()].cpu_flags & CPU_IDLE_DETECT) != 0;
+	m6502.idle_skips = 0;
+}
+
 void m6502_init(void)
 {
 	m6502.subtype = SUBTYPE_6502;
 	m6502.insn = insn6502;
 	m6502_state_register("m6502");
+	m6502_idle_init();
 }
 
 void m6502_reset(void *param)
@@ -212,7 +297,8 @@ void m6502_reset(void *param)
 
 void m6502_exit(void)
 {
-	/* nothing to do yet */
+	if (m6502.idle_skips)
+		logerror("M6502: skipped %u time slices in poll loops\n", m6502.idle_skips);
 }
 
 unsigned m6502_get_context (void *dst)
@@ -311,8 +397,110 @@ INLINE void m6502_take_irq(void)
 	m6502.pending_irq = 0;
 }
 
+/* after an opcode: see if the I flag was just reset or an irq is pending */
+static void m6502_after_op(void)
+{
+	if( m6502.after_cli )
+	{
+		LOG(("M6502#%d after_cli was >0", cpu_getactivecpu()));
+		m6502.after_cli = 0;
+		if (m6502.irq_state != CLEAR_LINE)
+		{
+			LOG((": irq line is asserted: set pending IRQ\n"));
+			m6502.pending_irq = 1;
+		}
+		else
+		{
+			LOG((": irq line is clear\n"));
+		}
+	}
+	else
+	if( m6502.pending_irq )
+		m6502_take_irq();
+}
+
+#if M6502_COMPUTED_GOTO
+/* plain 6502: every opcode does the post-op checks, fetches the next */
+/* one and jumps straight to it through a table of label addresses */
+#define M6502_DISPATCH												\
+	PPC = PCD;														\
+	CALL_MAME_DEBUG;												\
+	if( m6502.pending_irq )											\
+		m6502_take_irq();											\
+	goto *ops[RDOP()]
+
+#define M6502_OP(nn)												\
+	op_##nn: m6502_##nn();											\
+	if( m6502.after_cli | m6502.pending_irq ) m6502_after_op();	\
+	if( m6502_ICount <= 0 ) goto done;								\
+	M6502_DISPATCH;
+
+#define M6502_OPROW(h)	&&op_##h##0, &&op_##h##1, &&op_##h##2, &&op_##h##3, \
+						&&op_##h##4, &&op_##h##5, &&op_##h##6, &&op_##h##7, \
+						&&op_##h##8, &&op_##h##9, &&op_##h##a, &&op_##h##b, \
+						&&op_##h##c, &&op_##h##d, &&op_##h##e, &&op_##h##f
+
+static int m6502_execute_threaded(int cycles)
+{
+	static const void *const ops[256] =
+	{
+		M6502_OPROW(0), M6502_OPROW(1), M6502_OPROW(2), M6502_OPROW(3),
+		M6502_OPROW(4), M6502_OPROW(5), M6502_OPROW(6), M6502_OPROW(7),
+		M6502_OPROW(8), M6502_OPROW(9), M6502_OPROW(a), M6502_OPROW(b),
+		M6502_OPROW(c), M6502_OPROW(d), M6502_OPROW(e), M6502_OPROW(f)
+	};
+
+	m6502_ICount = cycles;
+
+    change_pc16(PCD);
+
+	M6502_DISPATCH;
+	{
+		M6502_OP(00) M6502_OP(01) M6502_OP(02) M6502_OP(03) M6502_OP(04) M6502_OP(05) M6502_OP(06) M6502_OP(07)
+		M6502_OP(08) M6502_OP(09) M6502_OP(0a) M6502_OP(0b) M6502_OP(0c) M6502_OP(0d) M6502_OP(0e) M6502_OP(0f)
+		M6502_OP(10) M6502_OP(11) M6502_OP(12) M6502_OP(13) M6502_OP(14) M6502_OP(15) M6502_OP(16) M6502_OP(17)
+		M6502_OP(18) M6502_OP(19) M6502_OP(1a) M6502_OP(1b) M6502_OP(1c) M6502_OP(1d) M6502_OP(1e) M6502_OP(1f)
+		M6502_OP(20) M6502_OP(21) M6502_OP(22) M6502_OP(23) M6502_OP(24) M6502_OP(25) M6502_OP(26) M6502_OP(27)
+		M6502_OP(28) M6502_OP(29) M6502_OP(2a) M6502_OP(2b) M6502_OP(2c) M6502_OP(2d) M6502_OP(2e) M6502_OP(2f)
+		M6502_OP(30) M6502_OP(31) M6502_OP(32) M6502_OP(33) M6502_OP(34) M6502_OP(35) M6502_OP(36) M6502_OP(37)
+		M6502_OP(38) M6502_OP(39) M6502_OP(3a) M6502_OP(3b) M6502_OP(3c) M6502_OP(3d) M6502_OP(3e) M6502_OP(3f)
+		M6502_OP(40) M6502_OP(41) M6502_OP(42) M6502_OP(43) M6502_OP(44) M6502_OP(45) M6502_OP(46) M6502_OP(47)
+		M6502_OP(48) M6502_OP(49) M6502_OP(4a) M6502_OP(4b) M6502_OP(4c) M6502_OP(4d) M6502_OP(4e) M6502_OP(4f)
+		M6502_OP(50) M6502_OP(51) M6502_OP(52) M6502_OP(53) M6502_OP(54) M6502_OP(55) M6502_OP(56) M6502_OP(57)
+		M6502_OP(58) M6502_OP(59) M6502_OP(5a) M6502_OP(5b) M6502_OP(5c) M6502_OP(5d) M6502_OP(5e) M6502_OP(5f)
+		M6502_OP(60) M6502_OP(61) M6502_OP(62) M6502_OP(63) M6502_OP(64) M6502_OP(65) M6502_OP(66) M6502_OP(67)
+		M6502_OP(68) M6502_OP(69) M6502_OP(6a) M6502_OP(6b) M6502_OP(6c) M6502_OP(6d) M6502_OP(6e) M6502_OP(6f)
+		M6502_OP(70) M6502_OP(71) M6502_OP(72) M6502_OP(73) M6502_OP(74) M6502_OP(75) M6502_OP(76) M6502_OP(77)
+		M6502_OP(78) M6502_OP(79) M6502_OP(7a) M6502_OP(7b) M6502_OP(7c) M6502_OP(7d) M6502_OP(7e) M6502_OP(7f)
+		M6502_OP(80) M6502_OP(81) M6502_OP(82) M6502_OP(83) M6502_OP(84) M6502_OP(85) M6502_OP(86) M6502_OP(87)
+		M6502_OP(88) M6502_OP(89) M6502_OP(8a) M6502_OP(8b) M6502_OP(8c) M6502_OP(8d) M6502_OP(8e) M6502_OP(8f)
+		M6502_OP(90) M6502_OP(91) M6502_OP(92) M6502_OP(93) M6502_OP(94) M6502_OP(95) M6502_OP(96) M6502_OP(97)
+		M6502_OP(98) M6502_OP(99) M6502_OP(9a) M6502_OP(9b) M6502_OP(9c) M6502_OP(9d) M6502_OP(9e) M6502_OP(9f)
+		M6502_OP(a0) M6502_OP(a1) M6502_OP(a2) M6502_OP(a3) M6502_OP(a4) M6502_OP(a5) M6502_OP(a6) M6502_OP(a7)
+		M6502_OP(a8) M6502_OP(a9) M6502_OP(aa) M6502_OP(ab) M6502_OP(ac) M6502_OP(ad) M6502_OP(ae) M6502_OP(af)
+		M6502_OP(b0) M6502_OP(b1) M6502_OP(b2) M6502_OP(b3) M6502_OP(b4) M6502_OP(b5) M6502_OP(b6) M6502_OP(b7)
+		M6502_OP(b8) M6502_OP(b9) M6502_OP(ba) M6502_OP(bb) M6502_OP(bc) M6502_OP(bd) M6502_OP(be) M6502_OP(bf)
+		M6502_OP(c0) M6502_OP(c1) M6502_OP(c2) M6502_OP(c3) M6502_OP(c4) M6502_OP(c5) M6502_OP(c6) M6502_OP(c7)
+		M6502_OP(c8) M6502_OP(c9) M6502_OP(ca) M6502_OP(cb) M6502_OP(cc) M6502_OP(cd) M6502_OP(ce) M6502_OP(cf)
+		M6502_OP(d0) M6502_OP(d1) M6502_OP(d2) M6502_OP(d3) M6502_OP(d4) M6502_OP(d5) M6502_OP(d6) M6502_OP(d7)
+		M6502_OP(d8) M6502_OP(d9) M6502_OP(da) M6502_OP(db) M6502_OP(dc) M6502_OP(dd) M6502_OP(de) M6502_OP(df)
+		M6502_OP(e0) M6502_OP(e1) M6502_OP(e2) M6502_OP(e3) M6502_OP(e4) M6502_OP(e5) M6502_OP(e6) M6502_OP(e7)
+		M6502_OP(e8) M6502_OP(e9) M6502_OP(ea) M6502_OP(eb) M6502_OP(ec) M6502_OP(ed) M6502_OP(ee) M6502_OP(ef)
+		M6502_OP(f0) M6502_OP(f1) M6502_OP(f2) M6502_OP(f3) M6502_OP(f4) M6502_OP(f5) M6502_OP(f6) M6502_OP(f7)
+		M6502_OP(f8) M6502_OP(f9) M6502_OP(fa) M6502_OP(fb) M6502_OP(fc) M6502_OP(fd) M6502_OP(fe) M6502_OP(ff)
+	}
+done:
+	return cycles - m6502_ICount;
+}
+#endif
+
 int m6502_execute(int cycles)
 {
+#if M6502_COMPUTED_GOTO
+	if( m6502.insn == insn6502 )
+		return m6502_execute_threaded(cycles);
+#endif
+
 	m6502_ICount = cycles;
 
     change_pc16(PCD);
@@ -344,23 +532,7 @@ int m6502_execute(int cycles)
 #endif
 
 		/* check if the I flag was just reset (interrupts enabled) */
-		if( m6502.after_cli )
-		{
-			LOG(("M6502#%d after_cli was >0", cpu_getactivecpu()));
-			m6502.after_cli = 0;
-			if (m6502.irq_state != CLEAR_LINE)
-			{
-				LOG((": irq line is asserted: set pending IRQ\n"));
-				m6502.pending_irq = 1;
-			}
-			else
-			{
-				LOG((": irq line is clear\n"));
-			}
-		}
-		else
-		if( m6502.pending_irq )
-			m6502_take_irq();
+		m6502_after_op();
 
 	} while (m6502_ICount > 0);
 
@@ -498,6 +670,7 @@ void n2a03_init(void)
 	m6502.subtype = SUBTYPE_2A03;
 	m6502.insn = insn2a03;
 	m6502_state_register("n2a03");
+	m6502_idle_init();
 }
 
 void n2a03_reset(void *param) { m6502_reset(param); }
@@ -565,6 +738,7 @@ void m6510_init ()
 	m6502.subtype = SUBTYPE_6510;
 	m6502.insn = insn6510;
 	m6502_state_register("m6510");
+	m6502_idle_init();
 }
 
 void m6510_reset(void *param) { m6502_reset(param); }
@@ -657,6 +831,7 @@ void m65c02_init(void)
 	m6502.subtype = SUBTYPE_65C02;
 	m6502.insn = insn65c02;
 	m6502_state_register("m65c02");
+	m6502_idle_init();
 }
 
 void m65c02_reset (void *param)
@@ -811,6 +986,7 @@ void m65sc02_init(void)
 	m6502.subtype = SUBTYPE_65SC02;
 	m6502.insn = insn65sc02;
 	m6502_state_register("m65sc02");
+	m6502_idle_init();
 }
 void m65sc02_reset(void *param) { m6502_reset(param); }
 void m65sc02_exit  (void) { m6502_exit(); }
@@ -872,6 +1048,7 @@ void deco16_init(void)
 	m6502.subtype = SUBTYPE_DECO16;
 	m6502.insn = insndeco16;
 	m6502_state_register("deco16");
+	m6502_idle_init();
 }
 
 
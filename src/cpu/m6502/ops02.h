@@ -41,7 +41,7 @@
 #define NZ	m6502.nz
 
 #define SET_NZ(n)				\
-	if ((n) == 0) P = (P & ~F_N) | F_Z; else P = (P & ~(F_N | F_Z)) | ((n) & F_N)
+	P = (P & ~(F_N | F_Z)) | ((n) & F_N) | ((n) == 0 ? F_Z : 0)
 
 #define SET_Z(n)				\
 	if ((n) == 0) P |= F_Z; else P &= ~F_Z
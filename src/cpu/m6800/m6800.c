@@ -261,6 +261,33 @@ static UINT32 timer_next;
 	}															\
 }
 
+/* With GCC/Clang, m6800_execute() and m6803_execute() dispatch through a */
+/* table of label addresses: every opcode accounts its cycles, fetches the */
+/* next one and jumps to it directly while there are cycles left */
+#ifndef M6800_COMPUTED_GOTO
+#if defined(__GNUC__)
+#define M6800_COMPUTED_GOTO 1
+#else
+#define M6800_COMPUTED_GOTO 0
+#endif
+#endif
+
+#if M6800_COMPUTED_GOTO
+#define M6800_OP(n)		op_##n:
+#define M6800_NEXT		INCREMENT_COUNTER(M6800_CYCLES[ireg]);							\
+						if( m6800_ICount <= 0 || (m6800.wai_state & M6800_WAI) )		\
+							goto op_next;												\
+						pPPC = pPC; CALL_MAME_DEBUG; ireg=M_RDOP(PCD); PC++;			\
+						goto *m6800_ops[ireg]
+#define M6800_OPROW(h)	&&op_0x##h##0, &&op_0x##h##1, &&op_0x##h##2, &&op_0x##h##3, \
+						&&op_0x##h##4, &&op_0x##h##5, &&op_0x##h##6, &&op_0x##h##7, \
+						&&op_0x##h##8, &&op_0x##h##9, &&op_0x##h##a, &&op_0x##h##b, \
+						&&op_0x##h##c, &&op_0x##h##d, &&op_0x##h##e, &&op_0x##h##f
+#else
+#define M6800_OP(n)		case n:
+#define M6800_NEXT		break
+#endif
+
 /* operate one instruction for */
 #define ONE_MORE_INSN() {		\
 	UINT8 ireg; 							\
@@ -788,9 +815,20 @@ void m6800_set_irq_callback(int (*callback)(int irqline))
 /****************************************************************************
  * Execute cycles CPU cycles. Return number of cycles really executed
  ****************************************************************************/
+#undef M6800_CYCLES
+#define M6800_CYCLES cycles_6800
 int m6800_execute(int cycles)
 {
 	UINT8 ireg;
+#if M6800_COMPUTED_GOTO
+	static const void *const m6800_ops[256] =
+	{
+		M6800_OPROW(0), M6800_OPROW(1), M6800_OPROW(2), M6800_OPROW(3),
+		M6800_OPROW(4), M6800_OPROW(5), M6800_OPROW(6), M6800_OPROW(7),
+		M6800_OPROW(8), M6800_OPROW(9), M6800_OPROW(a), M6800_OPROW(b),
+		M6800_OPROW(c), M6800_OPROW(d), M6800_OPROW(e), M6800_OPROW(f)
+	};
+#endif
 	m6800_ICount = cycles;
 
 	CLEANUP_conters;
@@ -810,267 +848,274 @@ int m6800_execute(int cycles)
 			ireg=M_RDOP(PCD);
 			PC++;
 
+#if M6800_COMPUTED_GOTO
+			goto *m6800_ops[ireg];
+#else
 			switch( ireg )
+#endif
 			{
-				case 0x00: illegal(); break;
-				case 0x01: nop(); break;
-				case 0x02: clra(); clrb(); illegal(); break; // illegal 1-byte instruction, used on cosflash sound, obviously clears B register at least?!
-				case 0x03: illegal(); break;
-				case 0x04: illegal(); break;
-				case 0x05: illegal(); break;
-				case 0x06: tap(); break;
-				case 0x07: tpa(); break;
-				case 0x08: inx(); break;
-				case 0x09: dex(); break;
-				case 0x0A: CLV; break;
-				case 0x0B: SEV; break;
-				case 0x0C: CLC; break;
-				case 0x0D: SEC; break;
-				case 0x0E: cli(); break;
-				case 0x0F: sei(); break;
-				case 0x10: sba(); break;
-				case 0x11: cba(); break;
-				case 0x12: illegal(); break;
-				case 0x13: illegal(); break;
-				case 0x14: illegal(); break;
-				case 0x15: illegal(); break;
-				case 0x16: tab(); break;
-				case 0x17: tba(); break;
-				case 0x18: illegal(); break;
-				case 0x19: daa(); break;
-				case 0x1a: illegal(); break;
-				case 0x1b: aba(); break;
-				case 0x1c: illegal(); break;
-				case 0x1d: illegal(); break;
-				case 0x1e: illegal(); break;
-				case 0x1f: illegal(); break;
-				case 0x20: bra(); break;
-				case 0x21: brn(); break;
-				case 0x22: bhi(); break;
-				case 0x23: bls(); break;
-				case 0x24: bcc(); break;
-				case 0x25: bcs(); break;
-				case 0x26: bne(); break;
-				case 0x27: beq(); break;
-				case 0x28: bvc(); break;
-				case 0x29: bvs(); break;
-				case 0x2a: bpl(); break;
-				case 0x2b: bmi(); break;
-				case 0x2c: bge(); break;
-				case 0x2d: blt(); break;
-				case 0x2e: bgt(); break;
-				case 0x2f: ble(); break;
-				case 0x30: tsx(); break;
-				case 0x31: ins(); break;
-				case 0x32: pula(); break;
-				case 0x33: pulb(); break;
-				case 0x34: des(); break;
-				case 0x35: txs(); break;
-				case 0x36: psha(); break;
-				case 0x37: pshb(); break;
-				case 0x38: illegal(); break;
-				case 0x39: rts(); break;
-				case 0x3a: illegal(); break;
-				case 0x3b: rti(); break;
-				case 0x3c: illegal(); break;
-				case 0x3d: illegal(); break;
-				case 0x3e: wai(); break;
-				case 0x3f: swi(); break;
-				case 0x40: nega(); break;
-				case 0x41: illegal(); break;
-				case 0x42: illegal(); break;
-				case 0x43: coma(); break;
-				case 0x44: lsra(); break;
-				case 0x45: illegal(); break;
-				case 0x46: rora(); break;
-				case 0x47: asra(); break;
-				case 0x48: asla(); break;
-				case 0x49: rola(); break;
-				case 0x4a: deca(); break;
-				case 0x4b: illegal(); break;
-				case 0x4c: inca(); break;
-				case 0x4d: tsta(); break;
-				case 0x4e: illegal(); break;
-				case 0x4f: clra(); break;
-				case 0x50: negb(); break;
-				case 0x51: illegal(); break;
-				case 0x52: illegal(); break;
-				case 0x53: comb(); break;
-				case 0x54: lsrb(); break;
-				case 0x55: illegal(); break;
-				case 0x56: rorb(); break;
-				case 0x57: asrb(); break;
-				case 0x58: aslb(); break;
-				case 0x59: rolb(); break;
-				case 0x5a: decb(); break;
-				case 0x5b: illegal(); break;
-				case 0x5c: incb(); break;
-				case 0x5d: tstb(); break;
-				case 0x5e: illegal(); break;
-				case 0x5f: clrb(); break;
-				case 0x60: neg_ix(); break;
-				case 0x61: illegal(); break;
-				case 0x62: illegal(); break;
-				case 0x63: com_ix(); break;
-				case 0x64: lsr_ix(); break;
-				case 0x65: illegal(); break;
-				case 0x66: ror_ix(); break;
-				case 0x67: asr_ix(); break;
-				case 0x68: asl_ix(); break;
-				case 0x69: rol_ix(); break;
-				case 0x6a: dec_ix(); break;
-				case 0x6b: illegal(); break;
-				case 0x6c: inc_ix(); break;
-				case 0x6d: tst_ix(); break;
-				case 0x6e: jmp_ix(); break;
-				case 0x6f: clr_ix(); break;
-				case 0x70: neg_ex(); break;
-				case 0x71: illegal(); break;
-				case 0x72: illegal(); break;
-				case 0x73: com_ex(); break;
-				case 0x74: lsr_ex(); break;
-				case 0x75: illegal(); break;
-				case 0x76: ror_ex(); break;
-				case 0x77: asr_ex(); break;
-				case 0x78: asl_ex(); break;
-				case 0x79: rol_ex(); break;
-				case 0x7a: dec_ex(); break;
-				case 0x7b: illegal(); break;
-				case 0x7c: inc_ex(); break;
-				case 0x7d: tst_ex(); break;
-				case 0x7e: jmp_ex(); break;
-				case 0x7f: clr_ex(); break;
-				case 0x80: suba_im(); break;
-				case 0x81: cmpa_im(); break;
-				case 0x82: sbca_im(); break;
-				case 0x83: illegal(); break;
-				case 0x84: anda_im(); break;
-				case 0x85: bita_im(); break;
-				case 0x86: lda_im(); break;
-				case 0x87: sta_im(); break;
-				case 0x88: eora_im(); break;
-				case 0x89: adca_im(); break;
-				case 0x8a: ora_im(); break;
-				case 0x8b: adda_im(); break;
-				case 0x8c: cmpx_im(); break;
-				case 0x8d: bsr(); break;
-				case 0x8e: lds_im(); break;
-				case 0x8f: sts_im(); /* orthogonality */ break;
-				case 0x90: suba_di(); break;
-				case 0x91: cmpa_di(); break;
-				case 0x92: sbca_di(); break;
-				case 0x93: illegal(); break;
-				case 0x94: anda_di(); break;
-				case 0x95: bita_di(); break;
-				case 0x96: lda_di(); break;
-				case 0x97: sta_di(); break;
-				case 0x98: eora_di(); break;
-				case 0x99: adca_di(); break;
-				case 0x9a: ora_di(); break;
-				case 0x9b: adda_di(); break;
-				case 0x9c: cmpx_di(); break;
-				case 0x9d: jsr_di(); break;
-				case 0x9e: lds_di(); break;
-				case 0x9f: sts_di(); break;
-				case 0xa0: suba_ix(); break;
-				case 0xa1: cmpa_ix(); break;
-				case 0xa2: sbca_ix(); break;
-				case 0xa3: illegal(); break;
-				case 0xa4: anda_ix(); break;
-				case 0xa5: bita_ix(); break;
-				case 0xa6: lda_ix(); break;
-				case 0xa7: sta_ix(); break;
-				case 0xa8: eora_ix(); break;
-				case 0xa9: adca_ix(); break;
-				case 0xaa: ora_ix(); break;
-				case 0xab: adda_ix(); break;
-				case 0xac: cmpx_ix(); break;
-				case 0xad: jsr_ix(); break;
-				case 0xae: lds_ix(); break;
-				case 0xaf: sts_ix(); break;
-				case 0xb0: suba_ex(); break;
-				case 0xb1: cmpa_ex(); break;
-				case 0xb2: sbca_ex(); break;
-				case 0xb3: illegal(); break;
-				case 0xb4: anda_ex(); break;
-				case 0xb5: bita_ex(); break;
-				case 0xb6: lda_ex(); break;
-				case 0xb7: sta_ex(); break;
-				case 0xb8: eora_ex(); break;
-				case 0xb9: adca_ex(); break;
-				case 0xba: ora_ex(); break;
-				case 0xbb: adda_ex(); break;
-				case 0xbc: cmpx_ex(); break;
-				case 0xbd: jsr_ex(); break;
-				case 0xbe: lds_ex(); break;
-				case 0xbf: sts_ex(); break;
-				case 0xc0: subb_im(); break;
-				case 0xc1: cmpb_im(); break;
-				case 0xc2: sbcb_im(); break;
-				case 0xc3: illegal(); break;
-				case 0xc4: andb_im(); break;
-				case 0xc5: bitb_im(); break;
-				case 0xc6: ldb_im(); break;
-				case 0xc7: stb_im(); break;
-				case 0xc8: eorb_im(); break;
-				case 0xc9: adcb_im(); break;
-				case 0xca: orb_im(); break;
-				case 0xcb: addb_im(); break;
-				case 0xcc: illegal(); break;
-				case 0xcd: illegal(); break;
-				case 0xce: ldx_im(); break;
-				case 0xcf: stx_im(); break;
-				case 0xd0: subb_di(); break;
-				case 0xd1: cmpb_di(); break;
-				case 0xd2: sbcb_di(); break;
-				case 0xd3: illegal(); break;
-				case 0xd4: andb_di(); break;
-				case 0xd5: bitb_di(); break;
-				case 0xd6: ldb_di(); break;
-				case 0xd7: stb_di(); break;
-				case 0xd8: eorb_di(); break;
-				case 0xd9: adcb_di(); break;
-				case 0xda: orb_di(); break;
-				case 0xdb: addb_di(); break;
-				case 0xdc: illegal(); break;
-				case 0xdd: illegal(); break;
-				case 0xde: ldx_di(); break;
-				case 0xdf: stx_di(); break;
-				case 0xe0: subb_ix(); break;
-				case 0xe1: cmpb_ix(); break;
-				case 0xe2: sbcb_ix(); break;
-				case 0xe3: illegal(); break;
-				case 0xe4: andb_ix(); break;
-				case 0xe5: bitb_ix(); break;
-				case 0xe6: ldb_ix(); break;
-				case 0xe7: stb_ix(); break;
-				case 0xe8: eorb_ix(); break;
-				case 0xe9: adcb_ix(); break;
-				case 0xea: orb_ix(); break;
-				case 0xeb: addb_ix(); break;
-				case 0xec: illegal(); break;
-				case 0xed: illegal(); break;
-				case 0xee: ldx_ix(); break;
-				case 0xef: stx_ix(); break;
-				case 0xf0: subb_ex(); break;
-				case 0xf1: cmpb_ex(); break;
-				case 0xf2: sbcb_ex(); break;
-				case 0xf3: illegal(); break;
-				case 0xf4: andb_ex(); break;
-				case 0xf5: bitb_ex(); break;
-				case 0xf6: ldb_ex(); break;
-				case 0xf7: stb_ex(); break;
-				case 0xf8: eorb_ex(); break;
-				case 0xf9: adcb_ex(); break;
-				case 0xfa: orb_ex(); break;
-				case 0xfb: addb_ex(); break;
-				case 0xfc: addx_ex(); break;
-				case 0xfd: illegal(); break;
-				case 0xfe: ldx_ex(); break;
-				case 0xff: stx_ex(); break;
+				M6800_OP(0x00) illegal(); M6800_NEXT;
+				M6800_OP(0x01) nop(); M6800_NEXT;
+				M6800_OP(0x02) clra(); clrb(); illegal(); M6800_NEXT; // illegal 1-byte instruction, used on cosflash sound, obviously clears B register at least?!
+				M6800_OP(0x03) illegal(); M6800_NEXT;
+				M6800_OP(0x04) illegal(); M6800_NEXT;
+				M6800_OP(0x05) illegal(); M6800_NEXT;
+				M6800_OP(0x06) tap(); M6800_NEXT;
+				M6800_OP(0x07) tpa(); M6800_NEXT;
+				M6800_OP(0x08) inx(); M6800_NEXT;
+				M6800_OP(0x09) dex(); M6800_NEXT;
+				M6800_OP(0x0a) CLV; M6800_NEXT;
+				M6800_OP(0x0b) SEV; M6800_NEXT;
+				M6800_OP(0x0c) CLC; M6800_NEXT;
+				M6800_OP(0x0d) SEC; M6800_NEXT;
+				M6800_OP(0x0e) cli(); M6800_NEXT;
+				M6800_OP(0x0f) sei(); M6800_NEXT;
+				M6800_OP(0x10) sba(); M6800_NEXT;
+				M6800_OP(0x11) cba(); M6800_NEXT;
+				M6800_OP(0x12) illegal(); M6800_NEXT;
+				M6800_OP(0x13) illegal(); M6800_NEXT;
+				M6800_OP(0x14) illegal(); M6800_NEXT;
+				M6800_OP(0x15) illegal(); M6800_NEXT;
+				M6800_OP(0x16) tab(); M6800_NEXT;
+				M6800_OP(0x17) tba(); M6800_NEXT;
+				M6800_OP(0x18) illegal(); M6800_NEXT;
+				M6800_OP(0x19) daa(); M6800_NEXT;
+				M6800_OP(0x1a) illegal(); M6800_NEXT;
+				M6800_OP(0x1b) aba(); M6800_NEXT;
+				M6800_OP(0x1c) illegal(); M6800_NEXT;
+				M6800_OP(0x1d) illegal(); M6800_NEXT;
+				M6800_OP(0x1e) illegal(); M6800_NEXT;
+				M6800_OP(0x1f) illegal(); M6800_NEXT;
+				M6800_OP(0x20) bra(); M6800_NEXT;
+				M6800_OP(0x21) brn(); M6800_NEXT;
+				M6800_OP(0x22) bhi(); M6800_NEXT;
+				M6800_OP(0x23) bls(); M6800_NEXT;
+				M6800_OP(0x24) bcc(); M6800_NEXT;
+				M6800_OP(0x25) bcs(); M6800_NEXT;
+				M6800_OP(0x26) bne(); M6800_NEXT;
+				M6800_OP(0x27) beq(); M6800_NEXT;
+				M6800_OP(0x28) bvc(); M6800_NEXT;
+				M6800_OP(0x29) bvs(); M6800_NEXT;
+				M6800_OP(0x2a) bpl(); M6800_NEXT;
+				M6800_OP(0x2b) bmi(); M6800_NEXT;
+				M6800_OP(0x2c) bge(); M6800_NEXT;
+				M6800_OP(0x2d) blt(); M6800_NEXT;
+				M6800_OP(0x2e) bgt(); M6800_NEXT;
+				M6800_OP(0x2f) ble(); M6800_NEXT;
+				M6800_OP(0x30) tsx(); M6800_NEXT;
+				M6800_OP(0x31) ins(); M6800_NEXT;
+				M6800_OP(0x32) pula(); M6800_NEXT;
+				M6800_OP(0x33) pulb(); M6800_NEXT;
+				M6800_OP(0x34) des(); M6800_NEXT;
+				M6800_OP(0x35) txs(); M6800_NEXT;
+				M6800_OP(0x36) psha(); M6800_NEXT;
+				M6800_OP(0x37) pshb(); M6800_NEXT;
+				M6800_OP(0x38) illegal(); M6800_NEXT;
+				M6800_OP(0x39) rts(); M6800_NEXT;
+				M6800_OP(0x3a) illegal(); M6800_NEXT;
+				M6800_OP(0x3b) rti(); M6800_NEXT;
+				M6800_OP(0x3c) illegal(); M6800_NEXT;
+				M6800_OP(0x3d) illegal(); M6800_NEXT;
+				M6800_OP(0x3e) wai(); M6800_NEXT;
+				M6800_OP(0x3f) swi(); M6800_NEXT;
+				M6800_OP(0x40) nega(); M6800_NEXT;
+				M6800_OP(0x41) illegal(); M6800_NEXT;
+				M6800_OP(0x42) illegal(); M6800_NEXT;
+				M6800_OP(0x43) coma(); M6800_NEXT;
+				M6800_OP(0x44) lsra(); M6800_NEXT;
+				M6800_OP(0x45) illegal(); M6800_NEXT;
+				M6800_OP(0x46) rora(); M6800_NEXT;
+				M6800_OP(0x47) asra(); M6800_NEXT;
+				M6800_OP(0x48) asla(); M6800_NEXT;
+				M6800_OP(0x49) rola(); M6800_NEXT;
+				M6800_OP(0x4a) deca(); M6800_NEXT;
+				M6800_OP(0x4b) illegal(); M6800_NEXT;
+				M6800_OP(0x4c) inca(); M6800_NEXT;
+				M6800_OP(0x4d) tsta(); M6800_NEXT;
+				M6800_OP(0x4e) illegal(); M6800_NEXT;
+				M6800_OP(0x4f) clra(); M6800_NEXT;
+				M6800_OP(0x50) negb(); M6800_NEXT;
+				M6800_OP(0x51) illegal(); M6800_NEXT;
+				M6800_OP(0x52) illegal(); M6800_NEXT;
+				M6800_OP(0x53) comb(); M6800_NEXT;
+				M6800_OP(0x54) lsrb(); M6800_NEXT;
+				M6800_OP(0x55) illegal(); M6800_NEXT;
+				M6800_OP(0x56) rorb(); M6800_NEXT;
+				M6800_OP(0x57) asrb(); M6800_NEXT;
+				M6800_OP(0x58) aslb(); M6800_NEXT;
+				M6800_OP(0x59) rolb(); M6800_NEXT;
+				M6800_OP(0x5a) decb(); M6800_NEXT;
+				M6800_OP(0x5b) illegal(); M6800_NEXT;
+				M6800_OP(0x5c) incb(); M6800_NEXT;
+				M6800_OP(0x5d) tstb(); M6800_NEXT;
+				M6800_OP(0x5e) illegal(); M6800_NEXT;
+				M6800_OP(0x5f) clrb(); M6800_NEXT;
+				M6800_OP(0x60) neg_ix(); M6800_NEXT;
+				M6800_OP(0x61) illegal(); M6800_NEXT;
+				M6800_OP(0x62) illegal(); M6800_NEXT;
+				M6800_OP(0x63) com_ix(); M6800_NEXT;
+				M6800_OP(0x64) lsr_ix(); M6800_NEXT;
+				M6800_OP(0x65) illegal(); M6800_NEXT;
+				M6800_OP(0x66) ror_ix(); M6800_NEXT;
+				M6800_OP(0x67) asr_ix(); M6800_NEXT;
+				M6800_OP(0x68) asl_ix(); M6800_NEXT;
+				M6800_OP(0x69) rol_ix(); M6800_NEXT;
+				M6800_OP(0x6a) dec_ix(); M6800_NEXT;
+				M6800_OP(0x6b) illegal(); M6800_NEXT;
+				M6800_OP(0x6c) inc_ix(); M6800_NEXT;
+				M6800_OP(0x6d) tst_ix(); M6800_NEXT;
+				M6800_OP(0x6e) jmp_ix(); M6800_NEXT;
+				M6800_OP(0x6f) clr_ix(); M6800_NEXT;
+				M6800_OP(0x70) neg_ex(); M6800_NEXT;
+				M6800_OP(0x71) illegal(); M6800_NEXT;
+				M6800_OP(0x72) illegal(); M6800_NEXT;
+				M6800_OP(0x73) com_ex(); M6800_NEXT;
+				M6800_OP(0x74) lsr_ex(); M6800_NEXT;
+				M6800_OP(0x75) illegal(); M6800_NEXT;
+				M6800_OP(0x76) ror_ex(); M6800_NEXT;
+				M6800_OP(0x77) asr_ex(); M6800_NEXT;
+				M6800_OP(0x78) asl_ex(); M6800_NEXT;
+				M6800_OP(0x79) rol_ex(); M6800_NEXT;
+				M6800_OP(0x7a) dec_ex(); M6800_NEXT;
+				M6800_OP(0x7b) illegal(); M6800_NEXT;
+				M6800_OP(0x7c) inc_ex(); M6800_NEXT;
+				M6800_OP(0x7d) tst_ex(); M6800_NEXT;
+				M6800_OP(0x7e) jmp_ex(); M6800_NEXT;
+				M6800_OP(0x7f) clr_ex(); M6800_NEXT;
+				M6800_OP(0x80) suba_im(); M6800_NEXT;
+				M6800_OP(0x81) cmpa_im(); M6800_NEXT;
+				M6800_OP(0x82) sbca_im(); M6800_NEXT;
+				M6800_OP(0x83) illegal(); M6800_NEXT;
+				M6800_OP(0x84) anda_im(); M6800_NEXT;
+				M6800_OP(0x85) bita_im(); M6800_NEXT;
+				M6800_OP(0x86) lda_im(); M6800_NEXT;
+				M6800_OP(0x87) sta_im(); M6800_NEXT;
+				M6800_OP(0x88) eora_im(); M6800_NEXT;
+				M6800_OP(0x89) adca_im(); M6800_NEXT;
+				M6800_OP(0x8a) ora_im(); M6800_NEXT;
+				M6800_OP(0x8b) adda_im(); M6800_NEXT;
+				M6800_OP(0x8c) cmpx_im(); M6800_NEXT;
+				M6800_OP(0x8d) bsr(); M6800_NEXT;
+				M6800_OP(0x8e) lds_im(); M6800_NEXT;
+				M6800_OP(0x8f) sts_im(); /* orthogonality */ M6800_NEXT;
+				M6800_OP(0x90) suba_di(); M6800_NEXT;
+				M6800_OP(0x91) cmpa_di(); M6800_NEXT;
+				M6800_OP(0x92) sbca_di(); M6800_NEXT;
+				M6800_OP(0x93) illegal(); M6800_NEXT;
+				M6800_OP(0x94) anda_di(); M6800_NEXT;
+				M6800_OP(0x95) bita_di(); M6800_NEXT;
+				M6800_OP(0x96) lda_di(); M6800_NEXT;
+				M6800_OP(0x97) sta_di(); M6800_NEXT;
+				M6800_OP(0x98) eora_di(); M6800_NEXT;
+				M6800_OP(0x99) adca_di(); M6800_NEXT;
+				M6800_OP(0x9a) ora_di(); M6800_NEXT;
+				M6800_OP(0x9b) adda_di(); M6800_NEXT;
+				M6800_OP(0x9c) cmpx_di(); M6800_NEXT;
+				M6800_OP(0x9d) jsr_di(); M6800_NEXT;
+				M6800_OP(0x9e) lds_di(); M6800_NEXT;
+				M6800_OP(0x9f) sts_di(); M6800_NEXT;
+				M6800_OP(0xa0) suba_ix(); M6800_NEXT;
+				M6800_OP(0xa1) cmpa_ix(); M6800_NEXT;
+				M6800_OP(0xa2) sbca_ix(); M6800_NEXT;
+				M6800_OP(0xa3) illegal(); M6800_NEXT;
+				M6800_OP(0xa4) anda_ix(); M6800_NEXT;
+				M6800_OP(0xa5) bita_ix(); M6800_NEXT;
+				M6800_OP(0xa6) lda_ix(); M6800_NEXT;
+				M6800_OP(0xa7) sta_ix(); M6800_NEXT;
+				M6800_OP(0xa8) eora_ix(); M6800_NEXT;
+				M6800_OP(0xa9) adca_ix(); M6800_NEXT;
+				M6800_OP(0xaa) ora_ix(); M6800_NEXT;
+				M6800_OP(0xab) adda_ix(); M6800_NEXT;
+				M6800_OP(0xac) cmpx_ix(); M6800_NEXT;
+				M6800_OP(0xad) jsr_ix(); M6800_NEXT;
+				M6800_OP(0xae) lds_ix(); M6800_NEXT;
+				M6800_OP(0xaf) sts_ix(); M6800_NEXT;
+				M6800_OP(0xb0) suba_ex(); M6800_NEXT;
+				M6800_OP(0xb1) cmpa_ex(); M6800_NEXT;
+				M6800_OP(0xb2) sbca_ex(); M6800_NEXT;
+				M6800_OP(0xb3) illegal(); M6800_NEXT;
+				M6800_OP(0xb4) anda_ex(); M6800_NEXT;
+				M6800_OP(0xb5) bita_ex(); M6800_NEXT;
+				M6800_OP(0xb6) lda_ex(); M6800_NEXT;
+				M6800_OP(0xb7) sta_ex(); M6800_NEXT;
+				M6800_OP(0xb8) eora_ex(); M6800_NEXT;
+				M6800_OP(0xb9) adca_ex(); M6800_NEXT;
+				M6800_OP(0xba) ora_ex(); M6800_NEXT;
+				M6800_OP(0xbb) adda_ex(); M6800_NEXT;
+				M6800_OP(0xbc) cmpx_ex(); M6800_NEXT;
+				M6800_OP(0xbd) jsr_ex(); M6800_NEXT;
+				M6800_OP(0xbe) lds_ex(); M6800_NEXT;
+				M6800_OP(0xbf) sts_ex(); M6800_NEXT;
+				M6800_OP(0xc0) subb_im(); M6800_NEXT;
+				M6800_OP(0xc1) cmpb_im(); M6800_NEXT;
+				M6800_OP(0xc2) sbcb_im(); M6800_NEXT;
+				M6800_OP(0xc3) illegal(); M6800_NEXT;
+				M6800_OP(0xc4) andb_im(); M6800_NEXT;
+				M6800_OP(0xc5) bitb_im(); M6800_NEXT;
+				M6800_OP(0xc6) ldb_im(); M6800_NEXT;
+				M6800_OP(0xc7) stb_im(); M6800_NEXT;
+				M6800_OP(0xc8) eorb_im(); M6800_NEXT;
+				M6800_OP(0xc9) adcb_im(); M6800_NEXT;
+				M6800_OP(0xca) orb_im(); M6800_NEXT;
+				M6800_OP(0xcb) addb_im(); M6800_NEXT;
+				M6800_OP(0xcc) illegal(); M6800_NEXT;
+				M6800_OP(0xcd) illegal(); M6800_NEXT;
+				M6800_OP(0xce) ldx_im(); M6800_NEXT;
+				M6800_OP(0xcf) stx_im(); M6800_NEXT;
+				M6800_OP(0xd0) subb_di(); M6800_NEXT;
+				M6800_OP(0xd1) cmpb_di(); M6800_NEXT;
+				M6800_OP(0xd2) sbcb_di(); M6800_NEXT;
+				M6800_OP(0xd3) illegal(); M6800_NEXT;
+				M6800_OP(0xd4) andb_di(); M6800_NEXT;
+				M6800_OP(0xd5) bitb_di(); M6800_NEXT;
+				M6800_OP(0xd6) ldb_di(); M6800_NEXT;
+				M6800_OP(0xd7) stb_di(); M6800_NEXT;
+				M6800_OP(0xd8) eorb_di(); M6800_NEXT;
+				M6800_OP(0xd9) adcb_di(); M6800_NEXT;
+				M6800_OP(0xda) orb_di(); M6800_NEXT;
+				M6800_OP(0xdb) addb_di(); M6800_NEXT;
+				M6800_OP(0xdc) illegal(); M6800_NEXT;
+				M6800_OP(0xdd) illegal(); M6800_NEXT;
+				M6800_OP(0xde) ldx_di(); M6800_NEXT;
+				M6800_OP(0xdf) stx_di(); M6800_NEXT;
+				M6800_OP(0xe0) subb_ix(); M6800_NEXT;
+				M6800_OP(0xe1) cmpb_ix(); M6800_NEXT;
+				M6800_OP(0xe2) sbcb_ix(); M6800_NEXT;
+				M6800_OP(0xe3) illegal(); M6800_NEXT;
+				M6800_OP(0xe4) andb_ix(); M6800_NEXT;
+				M6800_OP(0xe5) bitb_ix(); M6800_NEXT;
+				M6800_OP(0xe6) ldb_ix(); M6800_NEXT;
+				M6800_OP(0xe7) stb_ix(); M6800_NEXT;
+				M6800_OP(0xe8) eorb_ix(); M6800_NEXT;
+				M6800_OP(0xe9) adcb_ix(); M6800_NEXT;
+				M6800_OP(0xea) orb_ix(); M6800_NEXT;
+				M6800_OP(0xeb) addb_ix(); M6800_NEXT;
+				M6800_OP(0xec) illegal(); M6800_NEXT;
+				M6800_OP(0xed) illegal(); M6800_NEXT;
+				M6800_OP(0xee) ldx_ix(); M6800_NEXT;
+				M6800_OP(0xef) stx_ix(); M6800_NEXT;
+				M6800_OP(0xf0) subb_ex(); M6800_NEXT;
+				M6800_OP(0xf1) cmpb_ex(); M6800_NEXT;
+				M6800_OP(0xf2) sbcb_ex(); M6800_NEXT;
+				M6800_OP(0xf3) illegal(); M6800_NEXT;
+				M6800_OP(0xf4) andb_ex(); M6800_NEXT;
+				M6800_OP(0xf5) bitb_ex(); M6800_NEXT;
+				M6800_OP(0xf6) ldb_ex(); M6800_NEXT;
+				M6800_OP(0xf7) stb_ex(); M6800_NEXT;
+				M6800_OP(0xf8) eorb_ex(); M6800_NEXT;
+				M6800_OP(0xf9) adcb_ex(); M6800_NEXT;
+				M6800_OP(0xfa) orb_ex(); M6800_NEXT;
+				M6800_OP(0xfb) addb_ex(); M6800_NEXT;
+				M6800_OP(0xfc) addx_ex(); M6800_NEXT;
+				M6800_OP(0xfd) illegal(); M6800_NEXT;
+				M6800_OP(0xfe) ldx_ex(); M6800_NEXT;
+				M6800_OP(0xff) stx_ex(); M6800_NEXT;
 			}
 			INCREMENT_COUNTER(cycles_6800[ireg]);
 		}
+#if M6800_COMPUTED_GOTO
+M6800_OP(next) ;
+#endif
 	} while( m6800_ICount>0 );
 
 	INCREMENT_COUNTER(m6800.extra_cycles);
@@ -1285,9 +1330,20 @@ void m6803_exit(void) { m6800_exit(); }
  * Execute cycles CPU cycles. Return number of cycles really executed
  ****************************************************************************/
 #if (HAS_M6803||HAS_M6801)
+#undef M6800_CYCLES
+#define M6800_CYCLES cycles_6803
 int m6803_execute(int cycles)
 {
 	UINT8 ireg;
+#if M6800_COMPUTED_GOTO
+	static const void *const m6800_ops[256] =
+	{
+		M6800_OPROW(0), M6800_OPROW(1), M6800_OPROW(2), M6800_OPROW(3),
+		M6800_OPROW(4), M6800_OPROW(5), M6800_OPROW(6), M6800_OPROW(7),
+		M6800_OPROW(8), M6800_OPROW(9), M6800_OPROW(a), M6800_OPROW(b),
+		M6800_OPROW(c), M6800_OPROW(d), M6800_OPROW(e), M6800_OPROW(f)
+	};
+#endif
 	m6803_ICount = cycles;
 
 	CLEANUP_conters;
@@ -1307,267 +1363,274 @@ int m6803_execute(int cycles)
 			ireg=M_RDOP(PCD);
 			PC++;
 
+#if M6800_COMPUTED_GOTO
+			goto *m6800_ops[ireg];
+#else
 			switch( ireg )
+#endif
 			{
-				case 0x00: illegal(); break;
-				case 0x01: nop(); break;
-				case 0x02: illegal(); break;
-				case 0x03: illegal(); break;
-				case 0x04: lsrd(); /* 6803 only */; break;
-				case 0x05: asld(); /* 6803 only */; break;
-				case 0x06: tap(); break;
-				case 0x07: tpa(); break;
-				case 0x08: inx(); break;
-				case 0x09: dex(); break;
-				case 0x0A: CLV; break;
-				case 0x0B: SEV; break;
-				case 0x0C: CLC; break;
-				case 0x0D: SEC; break;
-				case 0x0E: cli(); break;
-				case 0x0F: sei(); break;
-				case 0x10: sba(); break;
-				case 0x11: cba(); break;
-				case 0x12: illegal(); break;
-				case 0x13: illegal(); break;
-				case 0x14: illegal(); break;
-				case 0x15: illegal(); break;
-				case 0x16: tab(); break;
-				case 0x17: tba(); break;
-				case 0x18: illegal(); break;
-				case 0x19: daa(); break;
-				case 0x1a: illegal(); break;
-				case 0x1b: aba(); break;
-				case 0x1c: illegal(); break;
-				case 0x1d: illegal(); break;
-				case 0x1e: illegal(); break;
-				case 0x1f: illegal(); break;
-				case 0x20: bra(); break;
-				case 0x21: brn(); break;
-				case 0x22: bhi(); break;
-				case 0x23: bls(); break;
-				case 0x24: bcc(); break;
-				case 0x25: bcs(); break;
-				case 0x26: bne(); break;
-				case 0x27: beq(); break;
-				case 0x28: bvc(); break;
-				case 0x29: bvs(); break;
-				case 0x2a: bpl(); break;
-				case 0x2b: bmi(); break;
-				case 0x2c: bge(); break;
-				case 0x2d: blt(); break;
-				case 0x2e: bgt(); break;
-				case 0x2f: ble(); break;
-				case 0x30: tsx(); break;
-				case 0x31: ins(); break;
-				case 0x32: pula(); break;
-				case 0x33: pulb(); break;
-				case 0x34: des(); break;
-				case 0x35: txs(); break;
-				case 0x36: psha(); break;
-				case 0x37: pshb(); break;
-				case 0x38: pulx(); /* 6803 only */ break;
-				case 0x39: rts(); break;
-				case 0x3a: abx(); /* 6803 only */ break;
-				case 0x3b: rti(); break;
-				case 0x3c: pshx(); /* 6803 only */ break;
-				case 0x3d: mul(); /* 6803 only */ break;
-				case 0x3e: wai(); break;
-				case 0x3f: swi(); break;
-				case 0x40: nega(); break;
-				case 0x41: illegal(); break;
-				case 0x42: illegal(); break;
-				case 0x43: coma(); break;
-				case 0x44: lsra(); break;
-				case 0x45: illegal(); break;
-				case 0x46: rora(); break;
-				case 0x47: asra(); break;
-				case 0x48: asla(); break;
-				case 0x49: rola(); break;
-				case 0x4a: deca(); break;
-				case 0x4b: illegal(); break;
-				case 0x4c: inca(); break;
-				case 0x4d: tsta(); break;
-				case 0x4e: illegal(); break;
-				case 0x4f: clra(); break;
-				case 0x50: negb(); break;
-				case 0x51: illegal(); break;
-				case 0x52: illegal(); break;
-				case 0x53: comb(); break;
-				case 0x54: lsrb(); break;
-				case 0x55: illegal(); break;
-				case 0x56: rorb(); break;
-				case 0x57: asrb(); break;
-				case 0x58: aslb(); break;
-				case 0x59: rolb(); break;
-				case 0x5a: decb(); break;
-				case 0x5b: illegal(); break;
-				case 0x5c: incb(); break;
-				case 0x5d: tstb(); break;
-				case 0x5e: illegal(); break;
-				case 0x5f: clrb(); break;
-				case 0x60: neg_ix(); break;
-				case 0x61: illegal(); break;
-				case 0x62: illegal(); break;
-				case 0x63: com_ix(); break;
-				case 0x64: lsr_ix(); break;
-				case 0x65: illegal(); break;
-				case 0x66: ror_ix(); break;
-				case 0x67: asr_ix(); break;
-				case 0x68: asl_ix(); break;
-				case 0x69: rol_ix(); break;
-				case 0x6a: dec_ix(); break;
-				case 0x6b: illegal(); break;
-				case 0x6c: inc_ix(); break;
-				case 0x6d: tst_ix(); break;
-				case 0x6e: jmp_ix(); break;
-				case 0x6f: clr_ix(); break;
-				case 0x70: neg_ex(); break;
-				case 0x71: illegal(); break;
-				case 0x72: illegal(); break;
-				case 0x73: com_ex(); break;
-				case 0x74: lsr_ex(); break;
-				case 0x75: illegal(); break;
-				case 0x76: ror_ex(); break;
-				case 0x77: asr_ex(); break;
-				case 0x78: asl_ex(); break;
-				case 0x79: rol_ex(); break;
-				case 0x7a: dec_ex(); break;
-				case 0x7b: illegal(); break;
-				case 0x7c: inc_ex(); break;
-				case 0x7d: tst_ex(); break;
-				case 0x7e: jmp_ex(); break;
-				case 0x7f: clr_ex(); break;
-				case 0x80: suba_im(); break;
-				case 0x81: cmpa_im(); break;
-				case 0x82: sbca_im(); break;
-				case 0x83: subd_im(); /* 6803 only */ break;
-				case 0x84: anda_im(); break;
-				case 0x85: bita_im(); break;
-				case 0x86: lda_im(); break;
-				case 0x87: sta_im(); break;
-				case 0x88: eora_im(); break;
-				case 0x89: adca_im(); break;
-				case 0x8a: ora_im(); break;
-				case 0x8b: adda_im(); break;
-				case 0x8c: cpx_im(); /* 6803 difference */ break;
-				case 0x8d: bsr(); break;
-				case 0x8e: lds_im(); break;
-				case 0x8f: sts_im(); /* orthogonality */ break;
-				case 0x90: suba_di(); break;
-				case 0x91: cmpa_di(); break;
-				case 0x92: sbca_di(); break;
-				case 0x93: subd_di(); /* 6803 only */ break;
-				case 0x94: anda_di(); break;
-				case 0x95: bita_di(); break;
-				case 0x96: lda_di(); break;
-				case 0x97: sta_di(); break;
-				case 0x98: eora_di(); break;
-				case 0x99: adca_di(); break;
-				case 0x9a: ora_di(); break;
-				case 0x9b: adda_di(); break;
-				case 0x9c: cpx_di(); /* 6803 difference */ break;
-				case 0x9d: jsr_di(); break;
-				case 0x9e: lds_di(); break;
-				case 0x9f: sts_di(); break;
-				case 0xa0: suba_ix(); break;
-				case 0xa1: cmpa_ix(); break;
-				case 0xa2: sbca_ix(); break;
-				case 0xa3: subd_ix(); /* 6803 only */ break;
-				case 0xa4: anda_ix(); break;
-				case 0xa5: bita_ix(); break;
-				case 0xa6: lda_ix(); break;
-				case 0xa7: sta_ix(); break;
-				case 0xa8: eora_ix(); break;
-				case 0xa9: adca_ix(); break;
-				case 0xaa: ora_ix(); break;
-				case 0xab: adda_ix(); break;
-				case 0xac: cpx_ix(); /* 6803 difference */ break;
-				case 0xad: jsr_ix(); break;
-				case 0xae: lds_ix(); break;
-				case 0xaf: sts_ix(); break;
-				case 0xb0: suba_ex(); break;
-				case 0xb1: cmpa_ex(); break;
-				case 0xb2: sbca_ex(); break;
-				case 0xb3: subd_ex(); /* 6803 only */ break;
-				case 0xb4: anda_ex(); break;
-				case 0xb5: bita_ex(); break;
-				case 0xb6: lda_ex(); break;
-				case 0xb7: sta_ex(); break;
-				case 0xb8: eora_ex(); break;
-				case 0xb9: adca_ex(); break;
-				case 0xba: ora_ex(); break;
-				case 0xbb: adda_ex(); break;
-				case 0xbc: cpx_ex(); /* 6803 difference */ break;
-				case 0xbd: jsr_ex(); break;
-				case 0xbe: lds_ex(); break;
-				case 0xbf: sts_ex(); break;
-				case 0xc0: subb_im(); break;
-				case 0xc1: cmpb_im(); break;
-				case 0xc2: sbcb_im(); break;
-				case 0xc3: addd_im(); /* 6803 only */ break;
-				case 0xc4: andb_im(); break;
-				case 0xc5: bitb_im(); break;
-				case 0xc6: ldb_im(); break;
-				case 0xc7: stb_im(); break;
-				case 0xc8: eorb_im(); break;
-				case 0xc9: adcb_im(); break;
-				case 0xca: orb_im(); break;
-				case 0xcb: addb_im(); break;
-				case 0xcc: ldd_im(); /* 6803 only */ break;
-				case 0xcd: std_im(); /* 6803 only -- orthogonality */ break;
-				case 0xce: ldx_im(); break;
-				case 0xcf: stx_im(); break;
-				case 0xd0: subb_di(); break;
-				case 0xd1: cmpb_di(); break;
-				case 0xd2: sbcb_di(); break;
-				case 0xd3: addd_di(); /* 6803 only */ break;
-				case 0xd4: andb_di(); break;
-				case 0xd5: bitb_di(); break;
-				case 0xd6: ldb_di(); break;
-				case 0xd7: stb_di(); break;
-				case 0xd8: eorb_di(); break;
-				case 0xd9: adcb_di(); break;
-				case 0xda: orb_di(); break;
-				case 0xdb: addb_di(); break;
-				case 0xdc: ldd_di(); /* 6803 only */ break;
-				case 0xdd: std_di(); /* 6803 only */ break;
-				case 0xde: ldx_di(); break;
-				case 0xdf: stx_di(); break;
-				case 0xe0: subb_ix(); break;
-				case 0xe1: cmpb_ix(); break;
-				case 0xe2: sbcb_ix(); break;
-				case 0xe3: addd_ix(); /* 6803 only */ break;
-				case 0xe4: andb_ix(); break;
-				case 0xe5: bitb_ix(); break;
-				case 0xe6: ldb_ix(); break;
-				case 0xe7: stb_ix(); break;
-				case 0xe8: eorb_ix(); break;
-				case 0xe9: adcb_ix(); break;
-				case 0xea: orb_ix(); break;
-				case 0xeb: addb_ix(); break;
-				case 0xec: ldd_ix(); /* 6803 only */ break;
-				case 0xed: std_ix(); /* 6803 only */ break;
-				case 0xee: ldx_ix(); break;
-				case 0xef: stx_ix(); break;
-				case 0xf0: subb_ex(); break;
-				case 0xf1: cmpb_ex(); break;
-				case 0xf2: sbcb_ex(); break;
-				case 0xf3: addd_ex(); /* 6803 only */ break;
-				case 0xf4: andb_ex(); break;
-				case 0xf5: bitb_ex(); break;
-				case 0xf6: ldb_ex(); break;
-				case 0xf7: stb_ex(); break;
-				case 0xf8: eorb_ex(); break;
-				case 0xf9: adcb_ex(); break;
-				case 0xfa: orb_ex(); break;
-				case 0xfb: addb_ex(); break;
-				case 0xfc: ldd_ex(); /* 6803 only */ break;
-				case 0xfd: std_ex(); /* 6803 only */ break;
-				case 0xfe: ldx_ex(); break;
-				case 0xff: stx_ex(); break;
+				M6800_OP(0x00) illegal(); M6800_NEXT;
+				M6800_OP(0x01) nop(); M6800_NEXT;
+				M6800_OP(0x02) illegal(); M6800_NEXT;
+				M6800_OP(0x03) illegal(); M6800_NEXT;
+				M6800_OP(0x04) lsrd(); /* 6803 only */; M6800_NEXT;
+				M6800_OP(0x05) asld(); /* 6803 only */; M6800_NEXT;
+				M6800_OP(0x06) tap(); M6800_NEXT;
+				M6800_OP(0x07) tpa(); M6800_NEXT;
+				M6800_OP(0x08) inx(); M6800_NEXT;
+				M6800_OP(0x09) dex(); M6800_NEXT;
+				M6800_OP(0x0a) CLV; M6800_NEXT;
+				M6800_OP(0x0b) SEV; M6800_NEXT;
+				M6800_OP(0x0c) CLC; M6800_NEXT;
+				M6800_OP(0x0d) SEC; M6800_NEXT;
+				M6800_OP(0x0e) cli(); M6800_NEXT;
+				M6800_OP(0x0f) sei(); M6800_NEXT;
+				M6800_OP(0x10) sba(); M6800_NEXT;
+				M6800_OP(0x11) cba(); M6800_NEXT;
+				M6800_OP(0x12) illegal(); M6800_NEXT;
+				M6800_OP(0x13) illegal(); M6800_NEXT;
+				M6800_OP(0x14) illegal(); M6800_NEXT;
+				M6800_OP(0x15) illegal(); M6800_NEXT;
+				M6800_OP(0x16) tab(); M6800_NEXT;
+				M6800_OP(0x17) tba(); M6800_NEXT;
+				M6800_OP(0x18) illegal(); M6800_NEXT;
+				M6800_OP(0x19) daa(); M6800_NEXT;
+				M6800_OP(0x1a) illegal(); M6800_NEXT;
+				M6800_OP(0x1b) aba(); M6800_NEXT;
+				M6800_OP(0x1c) illegal(); M6800_NEXT;
+				M6800_OP(0x1d) illegal(); M6800_NEXT;
+				M6800_OP(0x1e) illegal(); M6800_NEXT;
+				M6800_OP(0x1f) illegal(); M6800_NEXT;
+				M6800_OP(0x20) bra(); M6800_NEXT;
+				M6800_OP(0x21) brn(); M6800_NEXT;
+				M6800_OP(0x22) bhi(); M6800_NEXT;
+				M6800_OP(0x23) bls(); M6800_NEXT;
+				M6800_OP(0x24) bcc(); M6800_NEXT;
+				M6800_OP(0x25) bcs(); M6800_NEXT;
+				M6800_OP(0x26) bne(); M6800_NEXT;
+				M6800_OP(0x27) beq(); M6800_NEXT;
+				M6800_OP(0x28) bvc(); M6800_NEXT;
+				M6800_OP(0x29) bvs(); M6800_NEXT;
+				M6800_OP(0x2a) bpl(); M6800_NEXT;
+				M6800_OP(0x2b) bmi(); M6800_NEXT;
+				M6800_OP(0x2c) bge(); M6800_NEXT;
+				M6800_OP(0x2d) blt(); M6800_NEXT;
+				M6800_OP(0x2e) bgt(); M6800_NEXT;
+				M6800_OP(0x2f) ble(); M6800_NEXT;
+				M6800_OP(0x30) tsx(); M6800_NEXT;
+				M6800_OP(0x31) ins(); M6800_NEXT;
+				M6800_OP(0x32) pula(); M6800_NEXT;
+				M6800_OP(0x33) pulb(); M6800_NEXT;
+				M6800_OP(0x34) des(); M6800_NEXT;
+				M6800_OP(0x35) txs(); M6800_NEXT;
+				M6800_OP(0x36) psha(); M6800_NEXT;
+				M6800_OP(0x37) pshb(); M6800_NEXT;
+				M6800_OP(0x38) pulx(); /* 6803 only */ M6800_NEXT;
+				M6800_OP(0x39) rts(); M6800_NEXT;
+				M6800_OP(0x3a) abx(); /* 6803 only */ M6800_NEXT;
+				M6800_OP(0x3b) rti(); M6800_NEXT;
+				M6800_OP(0x3c) pshx(); /* 6803 only */ M6800_NEXT;
+				M6800_OP(0x3d) mul(); /* 6803 only */ M6800_NEXT;
+				M6800_OP(0x3e) wai(); M6800_NEXT;
+				M6800_OP(0x3f) swi(); M6800_NEXT;
+				M6800_OP(0x40) nega(); M6800_NEXT;
+				M6800_OP(0x41) illegal(); M6800_NEXT;
+				M6800_OP(0x42) illegal(); M6800_NEXT;
+				M6800_OP(0x43) coma(); M6800_NEXT;
+				M6800_OP(0x44) lsra(); M6800_NEXT;
+				M6800_OP(0x45) illegal(); M6800_NEXT;
+				M6800_OP(0x46) rora(); M6800_NEXT;
+				M6800_OP(0x47) asra(); M6800_NEXT;
+				M6800_OP(0x48) asla(); M6800_NEXT;
+				M6800_OP(0x49) rola(); M6800_NEXT;
+				M6800_OP(0x4a) deca(); M6800_NEXT;
+				M6800_OP(0x4b) illegal(); M6800_NEXT;
+				M6800_OP(0x4c) inca(); M6800_NEXT;
+				M6800_OP(0x4d) tsta(); M6800_NEXT;
+				M6800_OP(0x4e) illegal(); M6800_NEXT;
+				M6800_OP(0x4f) clra(); M6800_NEXT;
+				M6800_OP(0x50) negb(); M6800_NEXT;
+				M6800_OP(0x51) illegal(); M6800_NEXT;
+				M6800_OP(0x52) illegal(); M6800_NEXT;
+				M6800_OP(0x53) comb(); M6800_NEXT;
+				M6800_OP(0x54) lsrb(); M6800_NEXT;
+				M6800_OP(0x55) illegal(); M6800_NEXT;
+				M6800_OP(0x56) rorb(); M6800_NEXT;
+				M6800_OP(0x57) asrb(); M6800_NEXT;
+				M6800_OP(0x58) aslb(); M6800_NEXT;
+				M6800_OP(0x59) rolb(); M6800_NEXT;
+				M6800_OP(0x5a) decb(); M6800_NEXT;
+				M6800_OP(0x5b) illegal(); M6800_NEXT;
+				M6800_OP(0x5c) incb(); M6800_NEXT;
+				M6800_OP(0x5d) tstb(); M6800_NEXT;
+				M6800_OP(0x5e) illegal(); M6800_NEXT;
+				M6800_OP(0x5f) clrb(); M6800_NEXT;
+				M6800_OP(0x60) neg_ix(); M6800_NEXT;
+				M6800_OP(0x61) illegal(); M6800_NEXT;
+				M6800_OP(0x62) illegal(); M6800_NEXT;
+				M6800_OP(0x63) com_ix(); M6800_NEXT;
+				M6800_OP(0x64) lsr_ix(); M6800_NEXT;
+				M6800_OP(0x65) illegal(); M6800_NEXT;
+				M6800_OP(0x66) ror_ix(); M6800_NEXT;
+				M6800_OP(0x67) asr_ix(); M6800_NEXT;
+				M6800_OP(0x68) asl_ix(); M6800_NEXT;
+				M6800_OP(0x69) rol_ix(); M6800_NEXT;
+				M6800_OP(0x6a) dec_ix(); M6800_NEXT;
+				M6800_OP(0x6b) illegal(); M6800_NEXT;
+				M6800_OP(0x6c) inc_ix(); M6800_NEXT;
+				M6800_OP(0x6d) tst_ix(); M6800_NEXT;
+				M6800_OP(0x6e) jmp_ix(); M6800_NEXT;
+				M6800_OP(0x6f) clr_ix(); M6800_NEXT;
+				M6800_OP(0x70) neg_ex(); M6800_NEXT;
+				M6800_OP(0x71) illegal(); M6800_NEXT;
+				M6800_OP(0x72) illegal(); M6800_NEXT;
+				M6800_OP(0x73) com_ex(); M6800_NEXT;
+				M6800_OP(0x74) lsr_ex(); M6800_NEXT;
+				M6800_OP(0x75) illegal(); M6800_NEXT;
+				M6800_OP(0x76) ror_ex(); M6800_NEXT;
+				M6800_OP(0x77) asr_ex(); M6800_NEXT;
+				M6800_OP(0x78) asl_ex(); M6800_NEXT;
+				M6800_OP(0x79) rol_ex(); M6800_NEXT;
+				M6800_OP(0x7a) dec_ex(); M6800_NEXT;
+				M6800_OP(0x7b) illegal(); M6800_NEXT;
+				M6800_OP(0x7c) inc_ex(); M6800_NEXT;
+				M6800_OP(0x7d) tst_ex(); M6800_NEXT;
+				M6800_OP(0x7e) jmp_ex(); M6800_NEXT;
+				M6800_OP(0x7f) clr_ex(); M6800_NEXT;
+				M6800_OP(0x80) suba_im(); M6800_NEXT;
+				M6800_OP(0x81) cmpa_im(); M6800_NEXT;
+				M6800_OP(0x82) sbca_im(); M6800_NEXT;
+				M6800_OP(0x83) subd_im(); /* 6803 only */ M6800_NEXT;
+				M6800_OP(0x84) anda_im(); M6800_NEXT;
+				M6800_OP(0x85) bita_im(); M6800_NEXT;
+				M6800_OP(0x86) lda_im(); M6800_NEXT;
+				M6800_OP(0x87) sta_im(); M6800_NEXT;
+				M6800_OP(0x88) eora_im(); M6800_NEXT;
+				M6800_OP(0x89) adca_im(); M6800_NEXT;
+				M6800_OP(0x8a) ora_im(); M6800_NEXT;
+				M6800_OP(0x8b) adda_im(); M6800_NEXT;
+				M6800_OP(0x8c) cpx_im(); /* 6803 difference */ M6800_NEXT;
+				M6800_OP(0x8d) bsr(); M6800_NEXT;
+				M6800_OP(0x8e) lds_im(); M6800_NEXT;
+				M6800_OP(0x8f) sts_im(); /* orthogonality */ M6800_NEXT;
+				M6800_OP(0x90) suba_di(); M6800_NEXT;
+				M6800_OP(0x91) cmpa_di(); M6800_NEXT;
+				M6800_OP(0x92) sbca_di(); M6800_NEXT;
+				M6800_OP(0x93) subd_di(); /* 6803 only */ M6800_NEXT;
+				M6800_OP(0x94) anda_di(); M6800_NEXT;
+				M6800_OP(0x95) bita_di(); M6800_NEXT;
+				M6800_OP(0x96) lda_di(); M6800_NEXT;
+				M6800_OP(0x97) sta_di(); M6800_NEXT;
+				M6800_OP(0x98) eora_di(); M6800_NEXT;
+				M6800_OP(0x99) adca_di(); M6800_NEXT;
+				M6800_OP(0x9a) ora_di(); M6800_NEXT;
+				M6800_OP(0x9b) adda_di(); M6800_NEXT;
+				M6800_OP(0x9c) cpx_di(); /* 6803 difference */ M6800_NEXT;
+				M6800_OP(0x9d) jsr_di(); M6800_NEXT;
+				M6800_OP(0x9e) lds_di(); M6800_NEXT;
+				M6800_OP(0x9f) sts_di(); M6800_NEXT;
+				M6800_OP(0xa0) suba_ix(); M6800_NEXT;
+				M6800_OP(0xa1) cmpa_ix(); M6800_NEXT;
+				M6800_OP(0xa2) sbca_ix(); M6800_NEXT;
+				M6800_OP(0xa3) subd_ix(); /* 6803 only */ M6800_NEXT;
+				M6800_OP(0xa4) anda_ix(); M6800_NEXT;
+				M6800_OP(0xa5) bita_ix(); M6800_NEXT;
+				M6800_OP(0xa6) lda_ix(); M6800_NEXT;
+				M6800_OP(0xa7) sta_ix(); M6800_NEXT;
+				M6800_OP(0xa8) eora_ix(); M6800_NEXT;
+				M6800_OP(0xa9) adca_ix(); M6800_NEXT;
+				M6800_OP(0xaa) ora_ix(); M6800_NEXT;
+				M6800_OP(0xab) adda_ix(); M6800_NEXT;
+				M6800_OP(0xac) cpx_ix(); /* 6803 difference */ M6800_NEXT;
+				M6800_OP(0xad) jsr_ix(); M6800_NEXT;
+				M6800_OP(0xae) lds_ix(); M6800_NEXT;
+				M6800_OP(0xaf) sts_ix(); M6800_NEXT;
+				M6800_OP(0xb0) suba_ex(); M6800_NEXT;
+				M6800_OP(0xb1) cmpa_ex(); M6800_NEXT;
+				M6800_OP(0xb2) sbca_ex(); M6800_NEXT;
+				M6800_OP(0xb3) subd_ex(); /* 6803 only */ M6800_NEXT;
+				M6800_OP(0xb4) anda_ex(); M6800_NEXT;
+				M6800_OP(0xb5) bita_ex(); M6800_NEXT;
+				M6800_OP(0xb6) lda_ex(); M6800_NEXT;
+				M6800_OP(0xb7) sta_ex(); M6800_NEXT;
+				M6800_OP(0xb8) eora_ex(); M6800_NEXT;
+				M6800_OP(0xb9) adca_ex(); M6800_NEXT;
+				M6800_OP(0xba) ora_ex(); M6800_NEXT;
+				M6800_OP(0xbb) adda_ex(); M6800_NEXT;
+				M6800_OP(0xbc) cpx_ex(); /* 6803 difference */ M6800_NEXT;
+				M6800_OP(0xbd) jsr_ex(); M6800_NEXT;
+				M6800_OP(0xbe) lds_ex(); M6800_NEXT;
+				M6800_OP(0xbf) sts_ex(); M6800_NEXT;
+				M6800_OP(0xc0) subb_im(); M6800_NEXT;
+				M6800_OP(0xc1) cmpb_im(); M6800_NEXT;
+				M6800_OP(0xc2) sbcb_im(); M6800_NEXT;
+				M6800_OP(0xc3) addd_im(); /* 6803 only */ M6800_NEXT;
+				M6800_OP(0xc4) andb_im(); M6800_NEXT;
+				M6800_OP(0xc5) bitb_im(); M6800_NEXT;
+				M6800_OP(0xc6) ldb_im(); M6800_NEXT;
+				M6800_OP(0xc7) stb_im(); M6800_NEXT;
+				M6800_OP(0xc8) eorb_im(); M6800_NEXT;
+				M6800_OP(0xc9) adcb_im(); M6800_NEXT;
+				M6800_OP(0xca) orb_im(); M6800_NEXT;
+				M6800_OP(0xcb) addb_im(); M6800_NEXT;
+				M6800_OP(0xcc) ldd_im(); /* 6803 only */ M6800_NEXT;
+				M6800_OP(0xcd) std_im(); /* 6803 only -- orthogonality */ M6800_NEXT;
+				M6800_OP(0xce) ldx_im(); M6800_NEXT;
+				M6800_OP(0xcf) stx_im(); M6800_NEXT;
+				M6800_OP(0xd0) subb_di(); M6800_NEXT;
+				M6800_OP(0xd1) cmpb_di(); M6800_NEXT;
+				M6800_OP(0xd2) sbcb_di(); M6800_NEXT;
+				M6800_OP(0xd3) addd_di(); /* 6803 only */ M6800_NEXT;
+				M6800_OP(0xd4) andb_di(); M6800_NEXT;
+				M6800_OP(0xd5) bitb_di(); M6800_NEXT;
+				M6800_OP(0xd6) ldb_di(); M6800_NEXT;
+				M6800_OP(0xd7) stb_di(); M6800_NEXT;
+				M6800_OP(0xd8) eorb_di(); M6800_NEXT;
+				M6800_OP(0xd9) adcb_di(); M6800_NEXT;
+				M6800_OP(0xda) orb_di(); M6800_NEXT;
+				M6800_OP(0xdb) addb_di(); M6800_NEXT;
+				M6800_OP(0xdc) ldd_di(); /* 6803 only */ M6800_NEXT;
+				M6800_OP(0xdd) std_di(); /* 6803 only */ M6800_NEXT;
+				M6800_OP(0xde) ldx_di(); M6800_NEXT;
+				M6800_OP(0xdf) stx_di(); M6800_NEXT;
+				M6800_OP(0xe0) subb_ix(); M6800_NEXT;
+				M6800_OP(0xe1) cmpb_ix(); M6800_NEXT;
+				M6800_OP(0xe2) sbcb_ix(); M6800_NEXT;
+				M6800_OP(0xe3) addd_ix(); /* 6803 only */ M6800_NEXT;
+				M6800_OP(0xe4) andb_ix(); M6800_NEXT;
+				M6800_OP(0xe5) bitb_ix(); M6800_NEXT;
+				M6800_OP(0xe6) ldb_ix(); M6800_NEXT;
+				M6800_OP(0xe7) stb_ix(); M6800_NEXT;
+				M6800_OP(0xe8) eorb_ix(); M6800_NEXT;
+				M6800_OP(0xe9) adcb_ix(); M6800_NEXT;
+				M6800_OP(0xea) orb_ix(); M6800_NEXT;
+				M6800_OP(0xeb) addb_ix(); M6800_NEXT;
+				M6800_OP(0xec) ldd_ix(); /* 6803 only */ M6800_NEXT;
+				M6800_OP(0xed) std_ix(); /* 6803 only */ M6800_NEXT;
+				M6800_OP(0xee) ldx_ix(); M6800_NEXT;
+				M6800_OP(0xef) stx_ix(); M6800_NEXT;
+				M6800_OP(0xf0) subb_ex(); M6800_NEXT;
+				M6800_OP(0xf1) cmpb_ex(); M6800_NEXT;
+				M6800_OP(0xf2) sbcb_ex(); M6800_NEXT;
+				M6800_OP(0xf3) addd_ex(); /* 6803 only */ M6800_NEXT;
+				M6800_OP(0xf4) andb_ex(); M6800_NEXT;
+				M6800_OP(0xf5) bitb_ex(); M6800_NEXT;
+				M6800_OP(0xf6) ldb_ex(); M6800_NEXT;
+				M6800_OP(0xf7) stb_ex(); M6800_NEXT;
+				M6800_OP(0xf8) eorb_ex(); M6800_NEXT;
+				M6800_OP(0xf9) adcb_ex(); M6800_NEXT;
+				M6800_OP(0xfa) orb_ex(); M6800_NEXT;
+				M6800_OP(0xfb) addb_ex(); M6800_NEXT;
+				M6800_OP(0xfc) ldd_ex(); /* 6803 only */ M6800_NEXT;
+				M6800_OP(0xfd) std_ex(); /* 6803 only */ M6800_NEXT;
+				M6800_OP(0xfe) ldx_ex(); M6800_NEXT;
+				M6800_OP(0xff) stx_ex(); M6800_NEXT;
 			}
 			INCREMENT_COUNTER(cycles_6803[ireg]);
 		}
+#if M6800_COMPUTED_GOTO
+M6800_OP(next) ;
+#endif
 	} while( m6803_ICount>0 );
 
 	INCREMENT_COUNTER(m6803.extra_cycles);
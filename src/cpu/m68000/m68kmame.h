@@ -88,6 +88,16 @@ INLINE unsigned int m68kx_read_immediate_16(unsigned int address)
 
 INLINE unsigned int m68kx_read_immediate_32(unsigned int address)
 {
+	/* prefetch refills are long aligned: fetch both words of the opcode ROM at once */
+	if (!(address & 3) && !m68k_memory_intf.opcode_xor)
+	{
+		const data32_t data = cpu_readop32(address);
+#ifdef LSB_FIRST
+		return (data << 16) | (data >> 16);
+#else
+		return data;
+#endif
+	}
 	return ((m68k_read_immediate_16(address) << 16) | m68k_read_immediate_16((address)+2));
 }
 
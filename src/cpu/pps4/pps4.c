@@ -30,11 +30,14 @@ static UINT8 PPS4_win_layout[] = {
 	 0,23,80, 1,	/* command line window (bottom rows) */
 };
 
+#define PPS4_RAM_PAGES 16
+
 typedef struct {
 	int 	cputype;	/* 0 = PPS-4 (10660), 1 = PPS-4/2 (11660) */
 	PAIR	PC, SA, SB, BX, AB;
 	UINT8   DB;
 	INT8	accu, xreg, carry, ff1, ff2, skip, sag;
+	UINT8	*ram[PPS4_RAM_PAGES];	/* direct pointers to plain RAM pages at 0x1000-0x1fff, NULL goes through the memory system */
 }	PPS4_Regs;
 
 static PPS4_Regs I;
@@ -87,14 +90,20 @@ static UINT8 ARG(void)
 
 static UINT8 RM(UINT32 a)
 {
-	return cpu_readmem16(a & (I.sag ? 0x100f : 0x1fff)) & 0x0f;
+	a &= I.sag ? 0x100f : 0x1fff;
+	if ((a & 0x1000) && I.ram[(a >> 8) & 0x0f])
+		return I.ram[(a >> 8) & 0x0f][a & 0xff] & 0x0f;
+	return cpu_readmem16(a) & 0x0f;
 }
 
 static void WM(UINT32 a, UINT8 v)
 {
 	if (I.sag) a &= 0x100f;
 	if (a > 0x10ff) { LOG(("%03x: Write to memory @%04x:%x\n", activecpu_get_pc(), a, v)); }
-	cpu_writemem16(a, v & 0x0f);
+	if ((a & 0xf000) == 0x1000 && I.ram[(a >> 8) & 0x0f])
+		I.ram[(a >> 8) & 0x0f][a & 0xff] = v & 0x0f;
+	else
+		cpu_writemem16(a, v & 0x0f);
 }
 
 INLINE void execute_one(UINT8 opcode)
@@ -464,11 +473,15 @@ void PPS4_init(void)
  ****************************************************************************/
 void PPS4_reset(void *param)
 {
+	int i;
+
 	memset(&I, 0, sizeof(PPS4_Regs));
 	I.cputype = 1; // we use the PPS-4/2 by default for enhanced I/O capability!
 	PPS4_ICount = 0;
 	wasLB = 0;
 	wasLDI = 0;
+	for (i = 0; i < PPS4_RAM_PAGES; i++)
+		I.ram[i] = memory_get_ram_page(cpu_getactivecpu(), 0x1000 + (i << 8), 0x100);
 	change_pc16(I.PC.d);
 }
 
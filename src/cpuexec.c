@@ -203,8 +203,33 @@ static double scanline_period;
 static double scanline_period_inv;
 
 static void *interleave_boost_timer;
+
+/* guest PC sampling: one open addressing table per CPU, keyed by PC and bank id */
+#define PC_SAMPLE_ENTRIES	4096	/* per CPU, must be a power of 2 */
+#define PC_SAMPLE_PROBES	16
+
+struct pc_sample_entry
+{
+	UINT32		pc;
+	UINT32		bank;
+	UINT32		count;
+	char		dasm[40];
+};
+
+static void *pc_sample_timer;
+static double pc_sample_interval;
+static struct pc_sample_entry *pc_samples[MAX_CPU];
+static UINT32 pc_sample_total[MAX_CPU];
 static void *interleave_boost_timer_end;
 static double perfect_interleave;
+static int interleave_boost_scale = 1;
+
+/* automatic interleave: long timeslices while the CPUs do not talk to each other */
+static void *auto_interleave_timer_end;
+static int auto_interleave_stretch;
+static int auto_interleave_quiet;
+static UINT32 timeslice_count;
+static double timeslice_total;
 
 // PinMame: time fence global offset
 volatile double time_fence_global_offset = 0.0;
@@ -233,6 +258,7 @@ static void cpu_vblankreset(void);
 static void cpu_vblankcallback(int param);
 static void cpu_updatecallback(int param);
 static void end_interleave_boost(int param);
+static void end_auto_interleave_window(int param);
 static void compute_perfect_interleave(void);
 
 static void handle_loadsave(void);
@@ -298,6 +324,14 @@ int cpu_init(void)
 	if (cpuint_init())
 		return 1;
 
+	/* a new game starts a new PC histogram */
+	for (cpunum = 0; cpunum < MAX_CPU; cpunum++)
+	{
+		if (pc_samples[cpunum])
+			memset(pc_samples[cpunum], 0, PC_SAMPLE_ENTRIES * sizeof(pc_samples[0][0]));
+		pc_sample_total[cpunum] = 0;
+	}
+
 	return 0;
 }
 
@@ -420,6 +454,14 @@ void cpu_run(void)
 			/* if we have a load/save scheduled, handle it */
 			if (loadsave_schedule != LOADSAVE_NONE)
 				handle_loadsave();
+
+#if defined(LIBPINMAME)
+			/* in-memory save states and rewind checkpoints */
+			{
+				extern void libpinmame_update_state(void);
+				libpinmame_update_state();
+			}
+#endif
 			
 			/* execute CPUs */
 			cpu_timeslice();
@@ -455,6 +497,10 @@ void cpu_exit(void)
 	for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
 		cpuintrf_exit_cpu(cpunum);
 
+	/* the timers are gone, the PC histograms stay readable until the next cpu_init */
+	pc_sample_timer = NULL;
+	timeslice_timer = NULL;
+
 	// PinMame
 	time_fence_exit();
 }
@@ -487,38 +533,68 @@ void machine_reset(void)
  *
  *************************************/
 
-static void handle_save(void)
+static void save_all_tags(void)
 {
-	mame_file *file;
+	int cpunum;
 
-	/* open the file */
-	file = mame_fopen(Machine->gamedrv->name, loadsave_schedule_name, FILETYPE_STATE, 1);
+	/* write tag 0 */
+	state_save_set_current_tag(0);
+	state_save_save_continue();
 
-	if (file)
+	/* loop over CPUs */
+	for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
 	{
-		int cpunum;
+		cpuintrf_push_context(cpunum);
 
-		/* write the save state */
-		state_save_save_begin(file);
+		/* make sure banking is set */
+		activecpu_reset_banking();
 
-		/* write tag 0 */
-		state_save_set_current_tag(0);
+		/* save the CPU data */
+		state_save_set_current_tag(cpunum + 1);
 		state_save_save_continue();
 
-		/* loop over CPUs */
-		for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
-		{
-			cpuintrf_push_context(cpunum);
+		cpuintrf_pop_context();
+	}
+}
 
-			/* make sure banking is set */
-			activecpu_reset_banking();
 
-			/* save the CPU data */
-			state_save_set_current_tag(cpunum + 1);
-			state_save_save_continue();
+static void load_all_tags(void)
+{
+	int cpunum;
 
-			cpuintrf_pop_context();
-		}
+	/* read tag 0 */
+	state_save_set_current_tag(0);
+	state_save_load_continue();
+
+	/* loop over CPUs */
+	for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
+	{
+		cpuintrf_push_context(cpunum);
+
+		/* make sure banking is set */
+		activecpu_reset_banking();
+
+		/* load the CPU data */
+		state_save_set_current_tag(cpunum + 1);
+		state_save_load_continue();
+
+		cpuintrf_pop_context();
+	}
+}
+
+
+static void handle_save(void)
+{
+	mame_file *file;
+
+	/* open the file */
+	file = mame_fopen(Machine->gamedrv->name, loadsave_schedule_name, FILETYPE_STATE, 1);
+
+	if (file)
+	{
+		/* write the save state */
+		state_save_save_begin(file);
+		save_all_tags();
 
 		/* finish and close */
 		state_save_save_finish();
@@ -554,26 +630,7 @@ static void handle_load(void)
 		/* start loading */
 		if (!state_save_load_begin(file))
 		{
-			int cpunum;
-
-			/* read tag 0 */
-			state_save_set_current_tag(0);
-			state_save_load_continue();
-
-			/* loop over CPUs */
-			for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
-			{
-				cpuintrf_push_context(cpunum);
-
-				/* make sure banking is set */
-				activecpu_reset_banking();
-
-				/* load the CPU data */
-				state_save_set_current_tag(cpunum + 1);
-				state_save_load_continue();
-
-				cpuintrf_pop_context();
-			}
+			load_all_tags();
 
 			/* finish and close */
 			state_save_load_finish();
@@ -591,6 +648,49 @@ static void handle_load(void)
 
 
 
+/*************************************
+ *
+ *	Save & load to memory
+ *
+ *************************************/
+
+/*
+ * Same data as a save state file, without the scheduling and file access.
+ * Must be called from the emulation thread, between timeslices (e.g. from
+ * a video update or a timer callback). With a NULL buffer, *size is set to
+ * the required buffer size.
+ */
+int cpu_save_state_mem(UINT8 *buffer, size_t *size)
+{
+	const size_t needed = state_save_get_size();
+
+	if (buffer == NULL || *size < needed)
+	{
+		*size = needed;
+		return (buffer == NULL) ? 0 : 1;
+	}
+
+	state_save_save_begin_mem(buffer);
+	save_all_tags();
+	state_save_save_finish();
+
+	*size = needed;
+	return 0;
+}
+
+
+int cpu_load_state_mem(const UINT8 *buffer, size_t size)
+{
+	if (state_save_load_begin_mem(buffer, size))
+		return 1;
+
+	load_all_tags();
+	state_save_load_finish();
+	return 0;
+}
+
+
+
 /*************************************
  *
  *	Handle saves & loads at runtime
@@ -852,20 +952,31 @@ void time_fence_post()
 		ReleaseSemaphore(time_fence_semaphore, 1, NULL);
 }
 
-int time_fence_wait(double secs)
+static int time_fence_try_wait(void)
+{
+	return WaitForSingleObject(time_fence_semaphore, 0) == WAIT_OBJECT_0;
+}
+
+static int time_fence_block(double secs)
 {
 	// Wait for the time fence semaphore (returns WAIT_OBJECT_0) or a Windows message (returns WAIT_OBJECT_0+1)
-	return time_fence_is_supported() && (MsgWaitForMultipleObjects(1, &time_fence_semaphore, FALSE, /*INFINITE*/ max((int)ceil(secs * 1000.), 1), QS_ALLINPUT) == WAIT_OBJECT_0);
+	const DWORD result = MsgWaitForMultipleObjects(1, &time_fence_semaphore, FALSE, /*INFINITE*/ max((int)ceil(secs * 1000.), 1), QS_ALLINPUT);
+#if defined(VPINMAME)
+	// have the next timeslice process the message right away
+	if (result == WAIT_OBJECT_0 + 1)
+	{
+		extern volatile int win_events_pending;
+		win_events_pending = 1;
+	}
+#endif
+	return result == WAIT_OBJECT_0;
 }
 
-void time_fence_exit()
+static void time_fence_close(void)
 {
 	if (time_fence_semaphore != NULL)
 		CloseHandle(time_fence_semaphore);
 	time_fence_semaphore = NULL;
-
-	options.time_fence = 0.0;
-	time_fence_global_offset = 0.0;
 }
 
 
@@ -874,10 +985,6 @@ void time_fence_exit()
 #include <dispatch/dispatch.h>
 static dispatch_semaphore_t time_fence_semaphore;
 static int time_fence_initialized = 0;
-static int max(int a, int b)
-{
-	return a > b ? a : b;
-}
 
 int time_fence_is_supported()
 {
@@ -895,14 +1002,18 @@ void time_fence_post()
 		dispatch_semaphore_signal(time_fence_semaphore);
 }
 
-int time_fence_wait(double secs)
+static int time_fence_try_wait(void)
 {
-	int64_t ns = max((int64_t)ceil(secs * 1000000000.), (int64_t)1);
-	dispatch_time_t wait_length = dispatch_time(DISPATCH_TIME_NOW, ns);
-	return time_fence_is_supported() && (dispatch_semaphore_wait(time_fence_semaphore, wait_length) == 0);
+	return dispatch_semaphore_wait(time_fence_semaphore, DISPATCH_TIME_NOW) == 0;
 }
 
-void time_fence_exit()
+static int time_fence_block(double secs)
+{
+	int64_t ns = (int64_t)ceil(secs * 1000000000.);
+	return dispatch_semaphore_wait(time_fence_semaphore, dispatch_time(DISPATCH_TIME_NOW, ns > 0 ? ns : 1)) == 0;
+}
+
+static void time_fence_close(void)
 {
 	if (time_fence_initialized)
 	{
@@ -914,12 +1025,9 @@ void time_fence_exit()
 #else
 
 #include <semaphore.h>
+#include <time.h>
 static sem_t time_fence_semaphore;
 static int time_fence_initialized = 0;
-static int max(int a, int b)
-{
-	return a > b ? a : b;
-}
 
 int time_fence_is_supported()
 {
@@ -938,16 +1046,24 @@ void time_fence_post()
 		sem_post(&time_fence_semaphore);
 }
 
-int time_fence_wait(double secs)
+static int time_fence_try_wait(void)
 {
-	int ns = max((int)ceil(secs * 1000000000.), 1);
-	struct timespec wait_length;
-	wait_length.tv_sec = 0ul;
-	wait_length.tv_nsec = ns;
-	return time_fence_is_supported() && (sem_timedwait(&time_fence_semaphore, &wait_length) == 0);
+	return sem_trywait(&time_fence_semaphore) == 0;
 }
 
-void time_fence_exit()
+static int time_fence_block(double secs)
+{
+	// sem_timedwait takes an absolute CLOCK_REALTIME deadline
+	long long ns = (long long)ceil(secs * 1000000000.);
+	struct timespec deadline;
+	clock_gettime(CLOCK_REALTIME, &deadline);
+	ns += deadline.tv_nsec;
+	deadline.tv_sec += (time_t)(ns / 1000000000);
+	deadline.tv_nsec = (long)(ns % 1000000000);
+	return sem_timedwait(&time_fence_semaphore, &deadline) == 0;
+}
+
+static void time_fence_close(void)
 {
 	if (time_fence_initialized)
 	{
@@ -958,13 +1074,98 @@ void time_fence_exit()
 
 #endif
 
+/* Hosts that move the fence every physics step (~1ms) post again within a
+   fraction of a millisecond, far below the granularity of a blocking wait.
+   Spin on the semaphore for a short, adaptive while before blocking */
+#define TIME_FENCE_SPIN_MIN		0.00002
+#define TIME_FENCE_SPIN_MAX		0.001
+
+static double time_fence_spin = 0.0002;
+static cycles_t time_fence_last;		/* host time at the end of the last wait */
+static double time_fence_waiting;		/* host seconds spent waiting on the fence */
+static double time_fence_running;		/* host seconds spent emulating between waits */
+static UINT32 time_fence_waits, time_fence_spin_hits;
+
+int time_fence_wait(double secs)
+{
+	const cycles_t cps = osd_cycles_per_second();
+	const cycles_t start = osd_cycles();
+	const cycles_t spin_end = start + (cycles_t)(time_fence_spin * cps);
+	cycles_t end;
+	double waited;
+	int result = 0, spun = 0;
+
+	if (!time_fence_is_supported())
+		return 0;
+
+	if (time_fence_last != 0)
+		time_fence_running += (double)(start - time_fence_last) / cps;
+
+	do
+	{
+		if (time_fence_try_wait())
+		{
+			result = spun = 1;
+			break;
+		}
+		end = osd_cycles();
+	} while (end - spin_end < 0);
+
+	if (!spun)
+		result = time_fence_block(secs - time_fence_spin);
+
+	end = osd_cycles();
+	waited = (double)(end - start) / cps;
+	time_fence_last = end;
+	time_fence_waiting += waited;
+	time_fence_waits++;
+
+	/* grow the spin while the posts land just after it, shrink it when they are far apart */
+	if (spun)
+		time_fence_spin_hits++;
+	else if (result && waited < 4. * time_fence_spin)
+	{
+		time_fence_spin *= 2.;
+		if (time_fence_spin > TIME_FENCE_SPIN_MAX)
+			time_fence_spin = TIME_FENCE_SPIN_MAX;
+	}
+	else
+	{
+		time_fence_spin *= 0.5;
+		if (time_fence_spin < TIME_FENCE_SPIN_MIN)
+			time_fence_spin = TIME_FENCE_SPIN_MIN;
+	}
+
+	return result;
+}
+
+void time_fence_get_stats(double *waiting, double *running, UINT32 *waits, UINT32 *spin_hits)
+{
+	*waiting = time_fence_waiting;
+	*running = time_fence_running;
+	*waits = time_fence_waits;
+	*spin_hits = time_fence_spin_hits;
+}
+
+void time_fence_exit()
+{
+	time_fence_close();
+
+	options.time_fence = 0.0;
+	time_fence_global_offset = 0.0;
+	time_fence_last = 0;
+	time_fence_waiting = time_fence_running = 0.;
+	time_fence_waits = time_fence_spin_hits = 0;
+}
+
 static void cpu_timeslice(void)
 {
 #if defined(VPINMAME)
 	// Continuously pump message loop, otherwise it creates stutters between COM server and client (VPinMame locks VPX scripts until message are processed)
 	// It also causes a deadlock if using a TimeFence since messages are normally processed by a CPU callback that may not happen depending on the TimeFence.
-	extern void win_process_events(void);
-	win_process_events();
+	// The queue is only drained every millisecond, or right away when a time fence wait was woken up by a message.
+	extern void win_process_events_slice(void);
+	win_process_events_slice();
 #endif
 
 #if defined(LIBPINMAME)
@@ -1004,6 +1205,14 @@ static void cpu_timeslice(void)
 	double target = timer_time_until_next_timer();
 	int cpunum;
 
+	// PinMAME: stop the slice at the time fence instead of running past it for the whole slice
+	if (options.time_fence != 0.0)
+	{
+		const double to_fence = options.time_fence + time_fence_global_offset - timer_get_time();
+		if (to_fence > 0. && to_fence < target)
+			target = to_fence;
+	}
+
 	LOG(("------------------\n"));
 	LOG(("cpu_timeslice: target = %.9f\n", target));
 
@@ -1030,11 +1239,25 @@ static void cpu_timeslice(void)
 			if (cycles_running > 0)
 			{
 				int ran;
+#if defined(LIBPINMAME)
+				extern int libpinmame_cpu_trace_mask;
+				extern void libpinmame_cpu_trace(int cpunum, int cycles, cycles_t host);
+				const cycles_t start = (libpinmame_cpu_trace_mask & (1 << cpunum)) ? osd_cycles() : 0;
+#endif
 				profiler_mark(PROFILER_CPU1 + cpunum);
 				cycles_stolen = 0;
-				ran = cpunum_execute(cpunum, cycles_running);
+				/* bulk cores run the whole slice unless the interleave is boosted */
+				if (timer_enabled(interleave_boost_timer))
+					ran = cpunum_execute(cpunum, cycles_running);
+				else
+					ran = cpunum_execute_until(cpunum, cycles_running, CPU_EVENT_IRQ | CPU_EVENT_WRITE);
 				ran -= cycles_stolen;
 				profiler_mark(PROFILER_END);
+#if defined(LIBPINMAME)
+				/* differential CPU traces */
+				if (libpinmame_cpu_trace_mask & (1 << cpunum))
+					libpinmame_cpu_trace(cpunum, ran, osd_cycles() - start);
+#endif
 
 				/* account for these cycles */
 				cpu[cpunum].totalcycles += ran;
@@ -1078,6 +1301,8 @@ static void cpu_timeslice(void)
 
 	/* update the global time */
 	timer_adjust_global_time(target);
+	timeslice_count++;
+	timeslice_total += target;
 
 	/* huh? something for the debugger */
 	#ifdef MAME_DEBUG
@@ -1109,6 +1334,23 @@ void activecpu_abort_timeslice(void)
 	cycles_stolen += current_icount;
 	cycles_running -= current_icount;
 	activecpu_adjust_icount(-current_icount);
+	cpu_signal_event(CPU_EVENT_ABORT);
+}
+
+
+
+/*************************************
+ *
+ *	Raise an event for a CPU running
+ *	in execute_until(); ignored for
+ *	plain execute()
+ *
+ *************************************/
+
+void cpu_signal_event(UINT32 events)
+{
+	extern UINT32 cpu_event_mask, cpu_pending_events;
+	cpu_pending_events |= events & cpu_event_mask;
 }
 
 
@@ -1243,6 +1485,7 @@ void cpu_boost_interleave(double timeslice_time, double boost_duration)
 	/* if you pass 0 for the timeslice_time, it means pick something reasonable */
 	if (timeslice_time < perfect_interleave)
 		timeslice_time = perfect_interleave;
+	timeslice_time *= interleave_boost_scale;
 
 	LOG(("cpu_boost_interleave(%.9f, %.9f)\n", timeslice_time, boost_duration));
 
@@ -1253,6 +1496,66 @@ void cpu_boost_interleave(double timeslice_time, double boost_duration)
 	timer_adjust(interleave_boost_timer_end, boost_duration, 0, TIME_NEVER);
 }
 
+void cpu_set_interleave_boost_scale(int scale)
+{
+	interleave_boost_scale = (scale < 1) ? 1 : scale;
+}
+
+
+
+/*************************************
+ *
+ *	Automatic interleave tuning
+ *
+ *************************************/
+
+static double auto_interleave_quiet_period(void)
+{
+	/* stretch the driver timeslice, but keep at least the driver floor of slices per frame */
+	double floor = Machine->drv->cpu_slices_floor;
+	double period = timeslice_period * auto_interleave_stretch;
+
+	if (floor <= 0.)
+		floor = Machine->drv->cpu_slices_per_frame / 8.;
+	if (floor < 1.)
+		floor = 1.;
+	if (period > TIME_IN_HZ(Machine->drv->frames_per_second * floor))
+		period = TIME_IN_HZ(Machine->drv->frames_per_second * floor);
+	return (period > timeslice_period) ? period : timeslice_period;
+}
+
+void cpu_set_auto_interleave(int stretch)
+{
+	auto_interleave_stretch = (stretch <= 1) ? 0 : stretch;
+	if (!timeslice_timer)
+		return;
+
+	/* back to the driver interleave, the quiet period starts after one more window */
+	auto_interleave_quiet = 0;
+	timer_adjust(timeslice_timer, timeslice_period, 0, timeslice_period);
+	timer_adjust(auto_interleave_timer_end, auto_interleave_stretch ? TIME_IN_HZ(Machine->drv->frames_per_second) : TIME_NEVER, 0, TIME_NEVER);
+}
+
+void cpu_interleave_activity(void)
+{
+	if (!auto_interleave_stretch)
+		return;
+
+	if (auto_interleave_quiet)
+	{
+		auto_interleave_quiet = 0;
+		timer_adjust(timeslice_timer, timeslice_period, 0, timeslice_period);
+		LOG(("cpu_interleave_activity: back to the driver interleave\n"));
+	}
+	timer_adjust(auto_interleave_timer_end, TIME_IN_HZ(Machine->drv->frames_per_second), 0, TIME_NEVER);
+}
+
+void cpu_get_interleave_stats(UINT32 *slices, double *average)
+{
+	*slices = timeslice_count;
+	*average = timeslice_count ? timeslice_total / timeslice_count : 0.;
+}
+
 
 
 #if 0
@@ -1936,6 +2239,24 @@ static void end_interleave_boost(int param)
 
 
 
+/*************************************
+ *
+ *	Callback to end the busy window
+ *	of the automatic interleave
+ *
+ *************************************/
+
+static void end_auto_interleave_window(int param)
+{
+	const double period = auto_interleave_quiet_period();
+
+	auto_interleave_quiet = 1;
+	timer_adjust(timeslice_timer, period, 0, period);
+	LOG(("end_auto_interleave_window: timeslice %.9f\n", period));
+}
+
+
+
 /*************************************
  *
  *	Compute the "perfect" interleave
@@ -1971,6 +2292,101 @@ static void compute_perfect_interleave(void)
 
 
 
+/*************************************
+ *
+ *	Guest PC sampling
+ *
+ *************************************/
+
+static void cpu_pc_sample_callback(int param)
+{
+	int cpunum;
+
+	for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
+	{
+		struct pc_sample_entry *table = pc_samples[cpunum];
+		UINT32 pc, bank, hash;
+		int probe;
+
+		if (!table || cpu[cpunum].suspend)
+			continue;
+
+		pc = cpunum_get_pc(cpunum);
+		bank = memory_get_read_bankid(cpunum, pc);
+		hash = (pc ^ (bank * 0x9E3779B1)) * 0x85EBCA6B;
+		pc_sample_total[cpunum]++;
+
+		for (probe = 0; probe < PC_SAMPLE_PROBES; probe++)
+		{
+			struct pc_sample_entry *entry = &table[(hash + probe) & (PC_SAMPLE_ENTRIES - 1)];
+
+			if (entry->count && (entry->pc != pc || entry->bank != bank))
+				continue;
+
+			/* a new address: disassemble it now, while the sampled bank is mapped in */
+			if (!entry->count++)
+			{
+				char buffer[256];
+				buffer[0] = 0;
+				cpunum_dasm(cpunum, buffer, pc);
+				entry->pc = pc;
+				entry->bank = bank;
+				strncpy(entry->dasm, buffer, sizeof(entry->dasm) - 1);
+			}
+			break;
+		}
+	}
+}
+
+void cpu_set_pc_sampling(double interval)
+{
+	int cpunum;
+
+	pc_sample_interval = interval;
+
+	for (cpunum = 0; cpunum < MAX_CPU; cpunum++)
+		if (interval > 0 && !pc_samples[cpunum])
+			pc_samples[cpunum] = calloc(PC_SAMPLE_ENTRIES, sizeof(pc_samples[0][0]));
+
+	if (pc_sample_timer)
+		timer_adjust(pc_sample_timer, interval > 0 ? interval : TIME_NEVER, 0, interval > 0 ? interval : 0);
+}
+
+static int pc_sample_compare(const void *a, const void *b)
+{
+	const UINT32 count_a = (*(const struct pc_sample_entry **)a)->count;
+	const UINT32 count_b = (*(const struct pc_sample_entry **)b)->count;
+	return (count_a < count_b) ? 1 : (count_a > count_b) ? -1 : 0;
+}
+
+int cpu_get_pc_samples(int cpunum, struct cpu_pc_sample *samples, int max, UINT32 *total)
+{
+	static struct pc_sample_entry *sorted[PC_SAMPLE_ENTRIES];
+	struct pc_sample_entry *table;
+	int i, count = 0;
+
+	if (total)
+		*total = (cpunum >= 0 && cpunum < MAX_CPU) ? pc_sample_total[cpunum] : 0;
+	if (cpunum < 0 || cpunum >= MAX_CPU || (table = pc_samples[cpunum]) == NULL)
+		return 0;
+
+	for (i = 0; i < PC_SAMPLE_ENTRIES; i++)
+		if (table[i].count)
+			sorted[count++] = &table[i];
+	qsort(sorted, count, sizeof(sorted[0]), pc_sample_compare);
+
+	for (i = 0; i < count && i < max; i++)
+	{
+		samples[i].pc = sorted[i]->pc;
+		samples[i].bank = sorted[i]->bank;
+		samples[i].count = sorted[i]->count;
+		samples[i].dasm = sorted[i]->dasm;
+	}
+	return i;
+}
+
+
+
 /*************************************
  *
  *	Setup all the core timers
@@ -1995,6 +2411,14 @@ static void cpu_inittimers(void)
 	interleave_boost_timer = timer_alloc(NULL);
 	interleave_boost_timer_end = timer_alloc(end_interleave_boost);
 
+	/* the automatic interleave starts with a busy window at the driver interleave */
+	auto_interleave_timer_end = timer_alloc(end_auto_interleave_window);
+	auto_interleave_quiet = 0;
+	timeslice_count = 0;
+	timeslice_total = 0.;
+	if (auto_interleave_stretch)
+		timer_adjust(auto_interleave_timer_end, TIME_IN_HZ(Machine->drv->frames_per_second), 0, TIME_NEVER);
+
 	/*
 	 *	The following code finds all the CPUs that are interrupting in sync with the VBLANK
 	 *	and sets up the VBLANK timer to run at the minimum number of cycles per frame in
@@ -2044,6 +2468,10 @@ static void cpu_inittimers(void)
 	vblank_countdown = vblank_multiplier;
 
 	sync_timer = timer_alloc(cpu_synccallback);
+
+	pc_sample_timer = timer_alloc(cpu_pc_sample_callback);
+	if (pc_sample_interval > 0)
+		timer_adjust(pc_sample_timer, pc_sample_interval, 0, pc_sample_interval);
 	/*
 	 *		The following code creates individual timers for each CPU whose interrupts are not
 	 *		synced to the VBLANK, and computes the typical number of cycles per interrupt
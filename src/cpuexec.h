@@ -71,7 +71,11 @@ enum
 	CPU_AUDIO_CPU = 0x0002,
 
 	/* the Z80 can be wired to use 16 bit addressing for I/O ports */
-	CPU_16BIT_PORT = 0x0001
+	CPU_16BIT_PORT = 0x0001,
+
+	/* let the CPU core skip the rest of a time slice when it detects a poll */
+	/* loop that only reads memory (M6809 and 6502 family only for now) */
+	CPU_IDLE_DETECT = 0x0004
 };
 
 
@@ -114,6 +118,12 @@ void cpu_loadsave_schedule(int type, char id);
 void cpu_loadsave_schedule_file(int type, const char *name);
 void cpu_loadsave_reset(void);
 
+/* Save/load the state immediately to/from memory (emulation thread only,
+   between timeslices), returns 0 on success; see state_save_delta_encode()
+   for incremental snapshots */
+int cpu_save_state_mem(UINT8 *buffer, size_t *size);
+int cpu_load_state_mem(const UINT8 *buffer, size_t size);
+
 
 
 /*************************************
@@ -183,6 +193,9 @@ int cpunum_is_suspended(int cpunum, int reason);
 /* Aborts the timeslice for the active CPU */
 void activecpu_abort_timeslice(void);
 
+/* Raises CPU_EVENT_xxx for a CPU running in execute_until() */
+void cpu_signal_event(UINT32 events);
+
 /* Returns the current local time for a CPU, relative to the current timeslice */
 double cpunum_get_localtime(int cpunum);
 
@@ -195,6 +208,34 @@ void cpunum_set_clockscale(int cpunum, double clockscale);
 /* Temporarily boosts the interleave factor */
 void cpu_boost_interleave(double timeslice_time, double boost_duration);
 
+/* Multiplies the timeslice of the following interleave boosts (1 = as requested), used by the speed governor */
+void cpu_set_interleave_boost_scale(int scale);
+
+/* Automatic interleave: the timeslice is stretched 'stretch' times (0 disables), down to the
+   driver floor (MDRV_INTERLEAVE_FLOOR, default 1/8 of MDRV_INTERLEAVE) of slices per frame,
+   while no cpu_interleave_activity() was reported during the last frame */
+void cpu_set_auto_interleave(int stretch);
+
+/* Reports a write to a cross-CPU latch, returns to the driver interleave for a frame */
+void cpu_interleave_activity(void);
+
+/* Returns the number of timeslices run since the machine started and their average length */
+void cpu_get_interleave_stats(UINT32 *slices, double *average);
+
+/* Samples the PC of all running CPUs every 'interval' seconds (0 stops), into
+   one histogram per CPU and bank (memory_get_read_bankid), cleared by cpu_init */
+struct cpu_pc_sample
+{
+	UINT32 pc;
+	UINT32 bank;			/* FAKE_BANKID outside of banks */
+	UINT32 count;
+	const char *dasm;		/* at the first sample (full mnemonics with MAME_DEBUG) */
+};
+void cpu_set_pc_sampling(double interval);
+
+/* Fills up to 'max' entries, most sampled first, and returns their number */
+int cpu_get_pc_samples(int cpunum, struct cpu_pc_sample *samples, int max, UINT32 *total);
+
 /* Backwards compatibility */
 #define timer_suspendcpu(cpunum, suspend, reason)	do { if (suspend) cpunum_suspend(cpunum, reason, 1); else cpunum_resume(cpunum, reason); } while (0)
 #define timer_holdcpu(cpunum, suspend, reason)		do { if (suspend) cpunum_suspend(cpunum, reason, 0); else cpunum_resume(cpunum, reason); } while (0)
@@ -331,6 +331,7 @@ void cpu_set_irq_line_and_vector(int cpunum, int irqline, int state, int vector)
 	int event_index = irq_event_index[cpunum]++;
 
 	LOG(("cpu_set_irq_line(%d,%d,%d,%02x)\n", cpunum, irqline, state, vector));
+	cpu_signal_event(CPU_EVENT_IRQ);
 
 	/* enqueue the event */
 	if (event_index < MAX_IRQ_EVENTS)
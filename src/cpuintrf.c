@@ -811,6 +811,8 @@ UINT8 default_win_layout[] =
 
 int activecpu;		/* index of active CPU (or -1) */
 int executingcpu;	/* index of executing CPU (or -1) */
+UINT32 cpu_event_mask;		/* events the CPU in execute_until() stops on, 0 otherwise */
+UINT32 cpu_pending_events;	/* events raised during the current execute_until() */
 int totalcpu;		/* total number of CPUs */
 
 static struct cpuinfo_intf cpu[MAX_CPU];
@@ -1250,6 +1252,35 @@ int cpunum_execute(int cpunum, int cycles)
 }
 
 
+/*--------------------------
+ 	Execute until an event
+--------------------------*/
+
+int cpunum_execute_until(int cpunum, int cycles, UINT32 events)
+{
+	int ran;
+	VERIFY_CPUNUM(0, cpunum_execute_until);
+	if (!cpu[cpunum].intf.execute_until)
+		return cpunum_execute(cpunum, cycles);
+	cpuintrf_push_context(cpunum);
+	executingcpu = cpunum;
+	cpu_event_mask = events | CPU_EVENT_ABORT;
+	cpu_pending_events = 0;
+	(*cpu[cpunum].intf.set_op_base)(activecpu_get_pc_byte());
+	ran = (*cpu[cpunum].intf.execute_until)(cycles, events);
+	cpu_event_mask = 0;
+	executingcpu = -1;
+	cpuintrf_pop_context();
+	return ran;
+}
+
+int cpunum_has_execute_until(int cpunum)
+{
+	VERIFY_CPUNUM(0, cpunum_has_execute_until);
+	return cpu[cpunum].intf.execute_until != NULL;
+}
+
+
 /*--------------------------
  	Reset and set IRQ ack
 --------------------------*/
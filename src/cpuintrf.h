@@ -508,9 +508,21 @@ struct cpu_interface
 	unsigned	endianess;
 	unsigned	align_unit;
 	unsigned	max_inst_len;
+
+	/* optional bulk execution, NULL for cores that only provide execute: */
+	/* runs until the cycles are used or activecpu_pending_events() is set, */
+	/* checked at the core's block boundaries; *icount must be current when */
+	/* calling handlers, and the return value is cycles - *icount as usual */
+	int			(*execute_until)(int cycles, UINT32 events);
 };
 
 
+/* events that end an execute_until() run early (see cpu_signal_event) */
+#define CPU_EVENT_ABORT			0x01	/* timeslice aborted (earlier timer, yield, spin), always set */
+#define CPU_EVENT_IRQ			0x02	/* an IRQ line of any CPU changed state */
+#define CPU_EVENT_WRITE			0x04	/* a driver signaled a write to a watched location */
+
+
 
 /*************************************
  *
@@ -639,6 +651,11 @@ const char *activecpu_win_layout(void);
 /* execute the requested cycles on a given CPU */
 int cpunum_execute(int cpunum, int cycles);
 
+/* execute up to the requested cycles, stopping early on the given events; */
+/* falls back to cpunum_execute() for cores without execute_until */
+int cpunum_execute_until(int cpunum, int cycles, UINT32 events);
+int cpunum_has_execute_until(int cpunum);
+
 /* signal a reset and set the IRQ ack callback for a given CPU */
 void cpunum_reset(int cpunum, void *param, int (*irqack)(int));
 
@@ -849,6 +866,15 @@ INLINE int cpu_getexecutingcpu(void)
 }
 
 
+/* events raised since the executing CPU entered execute_until(), */
+/* polled by the core at its block boundaries */
+INLINE UINT32 activecpu_pending_events(void)
+{
+	extern UINT32 cpu_pending_events;
+	return cpu_pending_events;
+}
+
+
 /* return a the total number of registered CPUs */
 INLINE int cpu_gettotalcpu(void)
 {
@@ -2,6 +2,13 @@
 
 #include "driver.h"
 
+#if (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || defined(__x86_64__)
+ #define SSE_GFX_OPT
+ #include <emmintrin.h>
+#elif (defined(_M_ARM) || defined(_M_ARM64) || defined(__arm__) || defined(__arm64__) || defined(__aarch64__)) && (!defined(__ARM_ARCH) || __ARM_ARCH >= 7) && (!defined(_MSC_VER) || defined(__clang__))
+ #define SSE_GFX_OPT // uses sse2neon then
+ #include "../ext/sse2neon.h"
+#endif
 
 #ifdef LSB_FIRST
 #define SHIFT0 0
@@ -300,6 +307,21 @@ INLINE void blockmove_NtoN_transpen_noremap8(
 	{
 		UINT32 *sd4;
 		UINT8 *end = dstdata + srcwidth;
+#ifdef SSE_GFX_OPT
+		if ((unsigned int)transpen <= 0xff)
+		{
+			/* 16 pixels at a time, the transparent ones keep the destination */
+			const __m128i trans16 = _mm_set1_epi8((char)transpen);
+			while (dstdata <= end - 16)
+			{
+				const __m128i col16 = _mm_loadu_si128((const __m128i *)srcdata);
+				const __m128i keep = _mm_cmpeq_epi8(col16, trans16);
+				_mm_storeu_si128((__m128i *)dstdata, _mm_or_si128(_mm_and_si128(keep, _mm_loadu_si128((const __m128i *)dstdata)), _mm_andnot_si128(keep, col16)));
+				srcdata += 16;
+				dstdata += 16;
+			}
+		}
+#endif
 		while (((size_t)srcdata & 3) && dstdata < end)	/* longword align */
 		{
 			int col;
@@ -422,6 +444,20 @@ INLINE void blockmove_NtoN_transpen_noremap16(
 	while (srcheight)
 	{
 		UINT16 *end = dstdata + srcwidth;
+#ifdef SSE_GFX_OPT
+		if ((unsigned int)transpen <= 0xffff)
+		{
+			const __m128i trans8 = _mm_set1_epi16((short)transpen);
+			while (dstdata <= end - 8)
+			{
+				const __m128i col8 = _mm_loadu_si128((const __m128i *)srcdata);
+				const __m128i keep = _mm_cmpeq_epi16(col8, trans8);
+				_mm_storeu_si128((__m128i *)dstdata, _mm_or_si128(_mm_and_si128(keep, _mm_loadu_si128((const __m128i *)dstdata)), _mm_andnot_si128(keep, col8)));
+				srcdata += 8;
+				dstdata += 8;
+			}
+		}
+#endif
 		while (dstdata < end)
 		{
 			int col;
@@ -475,6 +511,17 @@ INLINE void blockmove_NtoN_transpen_noremap32(
 	while (srcheight)
 	{
 		UINT32 *end = dstdata + srcwidth;
+#ifdef SSE_GFX_OPT
+		const __m128i trans4 = _mm_set1_epi32(transpen);
+		while (dstdata <= end - 4)
+		{
+			const __m128i col4 = _mm_loadu_si128((const __m128i *)srcdata);
+			const __m128i keep = _mm_cmpeq_epi32(col4, trans4);
+			_mm_storeu_si128((__m128i *)dstdata, _mm_or_si128(_mm_and_si128(keep, _mm_loadu_si128((const __m128i *)dstdata)), _mm_andnot_si128(keep, col4)));
+			srcdata += 4;
+			dstdata += 4;
+		}
+#endif
 		while (dstdata < end)
 		{
 			int col;
@@ -3819,6 +3866,25 @@ DECLARE_SWAP_RAW_PRI(blockmove_8toN_transpen,(COMMON_ARGS,
 		while (dstheight)
 		{
 			end = dstdata + dstwidth*HMODULO;
+#ifdef SSE_GFX_OPT
+			if ((unsigned int)transpen <= 0xff)
+			{
+				/* skips 16 transparent pixels at once */
+				const __m128i trans16 = _mm_set1_epi8((char)transpen);
+				while (dstdata <= end - 16*HMODULO)
+				{
+					const int draw = ~_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)srcdata), trans16)) & 0xffff;
+					if (draw)
+					{
+						int i;
+						for (i = 0; i < 16; i++)
+							if (draw & (1 << i)) SETPIXELCOLOR(i*HMODULO,LOOKUP(srcdata[i]))
+					}
+					srcdata += 16;
+					INCREMENT_DST(16*HMODULO)
+				}
+			}
+#endif
 			while (((size_t)srcdata & 3) && dstdata < end)	/* longword align */
 			{
 				int col;
@@ -100,6 +100,8 @@ typedef struct {
   int virtual_dmd;             /* If we have no screen, then we can suppress the DMD */
 #endif /* PROC_SUPPORT */
   int vgmwrite; // bool
+  int soundrip; // bool
+  int soundrip_prefix; // first command byte for the sound ripper, -1 = none
   int force_mono_to_stereo; // bool
 #ifdef PINMAME_HOST_UART
   char *serial_device;         /* COM or /dev/tty mapped to WPC95 UART */
@@ -257,6 +259,9 @@ extern void machine_add_timer(struct InternalMachineDriver *machine, void (*func
 #define MDRV_INTERLEAVE(interleave)                                                                             \
         machine->cpu_slices_per_frame = (interleave);                                           \
 
+#define MDRV_INTERLEAVE_FLOOR(interleave)                                                                       \
+        machine->cpu_slices_floor = (interleave);                                                       \
+
 
 /* core functions */
 #define MDRV_MACHINE_INIT(name)                                                                                 \
@@ -368,6 +373,7 @@ struct InternalMachineDriver
         double frames_per_second;
         int vblank_duration;
         double cpu_slices_per_frame;
+        double cpu_slices_floor;        /* PinMAME: fewest slices per frame of the automatic interleave */
 
         void (*machine_init)(void);
         void (*machine_stop)(void);
@@ -631,4 +637,10 @@ const struct GameDriver driver_##NAME =         \
 extern struct GameDriver *drivers[];
 extern const struct GameDriver *test_drivers[];
 
+/* O(1) lookups in drivers[] (index built on first use, call it once from the
+   main thread before using it from several threads); all return -1 if none */
+int driver_get_index(const char *name);
+int driver_get_first_clone(int game);
+int driver_get_next_clone(int game);
+
 #endif
@@ -51,6 +51,13 @@
 #define DEBUG_COOKIE			0xbaadf00d
 #endif
 
+/* ROM hashes computed for zipped files are remembered in cfg/romhash.cfg */
+#define HASHCACHE_NAME			"romhash"
+#define HASHCACHE_MAX			4096
+
+/* writes smaller than half of this are collected before they reach the OSD layer */
+#define WRITE_BUFFER_SIZE		4096
+
 
 /***************************************************************************
 	PROTOTYPES
@@ -59,6 +66,44 @@
 static mame_file *generic_fopen(int pathtype, const char *gamename, const char *filename, const char* hash, UINT32 flags);
 static const char *get_extension_for_filetype(int filetype);
 static int checksum_file(int pathtype, int pathindex, const char *file, UINT8 **p, UINT64 *size, char* hash);
+static int hashcache_find(const char *zipfile, const char *filename, UINT32 crc, UINT32 length, UINT32 stamp, unsigned int functions, char *hash);
+static void hashcache_add(const char *zipfile, const char *filename, UINT32 crc, UINT32 length, UINT32 stamp, const char *hash);
+
+
+/***************************************************************************
+	TYPE DEFINITIONS
+***************************************************************************/
+
+struct hashcache_entry
+{
+	char *zipfile;
+	char *filename;
+	UINT32 crc, length, stamp;		/* zip entry CRC-32, size and DOS date/time */
+	char hash[HASH_BUF_SIZE];
+};
+
+
+/***************************************************************************
+	GLOBALS
+***************************************************************************/
+
+static struct hashcache_entry *hashcache;
+static int hashcache_count, hashcache_loaded, hashcache_dirty;
+
+
+
+/***************************************************************************
+	flush_write_buffer
+***************************************************************************/
+
+static void flush_write_buffer(mame_file *file)
+{
+	if (file->writebytes)
+	{
+		osd_fwrite(file->file, file->writebuffer, file->writebytes);
+		file->writebytes = 0;
+	}
+}
 
 
 /***************************************************************************
@@ -229,6 +274,8 @@ void mame_fclose(mame_file *file)
 	switch (file->type)
 	{
 		case PLAIN_FILE:
+			flush_write_buffer(file);
+			free(file->writebuffer);
 			osd_fclose(file->file);
 			break;
 
@@ -317,6 +364,7 @@ UINT32 mame_fread(mame_file *file, void *buffer, size_t length)
 	switch (file->type)
 	{
 		case PLAIN_FILE:
+			flush_write_buffer(file);
 			return osd_fread(file->file, buffer, length);
 
 		case ZIPPED_FILE:
@@ -350,6 +398,22 @@ UINT32 mame_fwrite(mame_file *file, const void *buffer, size_t length)
 	switch (file->type)
 	{
 		case PLAIN_FILE:
+			/* config, hiscore and similar writers emit a few bytes at a time; */
+			/* on most OSD layers each osd_fwrite is a seek plus a write call */
+			if (length < WRITE_BUFFER_SIZE / 2)
+			{
+				if (!file->writebuffer)
+					file->writebuffer = malloc(WRITE_BUFFER_SIZE);
+				if (file->writebuffer)
+				{
+					if (file->writebytes + length > WRITE_BUFFER_SIZE)
+						flush_write_buffer(file);
+					memcpy(file->writebuffer + file->writebytes, buffer, length);
+					file->writebytes += length;
+					return length;
+				}
+			}
+			flush_write_buffer(file);
 			return osd_fwrite(file->file, buffer, length);
 		case RAM_FILE:
 			if (!file->data || (file->offset + length > file->length))
@@ -390,6 +454,7 @@ int mame_fseek(mame_file *file, INT64 offset, int whence)
 	switch (file->type)
 	{
 		case PLAIN_FILE:
+			flush_write_buffer(file);
 			return osd_fseek(file->file, offset, whence);
 
 		case ZIPPED_FILE:
@@ -451,6 +516,7 @@ UINT64 mame_fsize(mame_file *file)
 	{
 		case PLAIN_FILE:
 		{
+			flush_write_buffer(file);
 /*			int size, offs;
 			offs = osd_ftell(file->file);
 			osd_fseek(file->file, 0, SEEK_END);
@@ -493,6 +559,7 @@ int mame_fgetc(mame_file *file)
 	switch (file->type)
 	{
 		case PLAIN_FILE:
+			flush_write_buffer(file);
 			if (osd_fread(file->file, &buffer, 1) == 1)
 				return buffer;
 			return EOF;
@@ -520,6 +587,7 @@ int mame_ungetc(int c, mame_file *file)
 	switch (file->type)
 	{
 		case PLAIN_FILE:
+			flush_write_buffer(file);
 			if (osd_feof(file->file))
 			{
 				if (osd_fseek(file->file, 0, SEEK_CUR))
@@ -609,6 +677,7 @@ int mame_feof(mame_file *file)
 	switch (file->type)
 	{
 		case PLAIN_FILE:
+			flush_write_buffer(file);
 			return osd_feof(file->file);
 
 		case RAM_FILE:
@@ -631,6 +700,7 @@ UINT64 mame_ftell(mame_file *file)
 	switch (file->type)
 	{
 		case PLAIN_FILE:
+			flush_write_buffer(file);
 			return osd_ftell(file->file);
 
 		case RAM_FILE:
@@ -958,6 +1028,9 @@ static mame_file *generic_fopen(int pathtype, const char *gamename, const char *
 				{
 					int err;
 
+					const char *loadname = tempname;
+					char crcn[9];
+
 					/* Try loading the file */
 					err = load_zipped_file(pathtype, pathindex, name, tempname, &file.data, &ziplength);
 
@@ -966,16 +1039,17 @@ static mame_file *generic_fopen(int pathtype, const char *gamename, const char *
 					   of specifying the CRC as filename. */
 					if (err && hash)
 					{
-						char crcn[9];
-
 						hash_data_extract_printable_checksum(hash, HASH_CRC, crcn);
 
 						err = load_zipped_file(pathtype, pathindex, name, crcn, &file.data, &ziplength);
+						loadname = crcn;
 					}
 
 					if (err == 0)
 					{
 						unsigned functions;
+						unsigned int zlength, zcrc, zstamp;
+						int stamped;
 
 						LOG(("Using (mame_fopen) zip file for %s\n", filename));
 						file.length = ziplength;
@@ -990,7 +1064,16 @@ static mame_file *generic_fopen(int pathtype, const char *gamename, const char *
 						if (options.crc_only && (functions & HASH_CRC))
 							functions = HASH_CRC;
 
-						hash_compute(file.hash, file.data, file.length, functions);
+						/* Unchanged entries (same CRC, length and time stamp) get their
+						   checksums from the hash cache instead of hashing the data again. */
+						stamped = (flags & FILEFLAG_HASH) && functions
+							&& stat_zipped_file(pathtype, pathindex, name, loadname, &zlength, &zcrc, &zstamp) == 0 && zlength == file.length;
+						if (!stamped || !hashcache_find(name, loadname, zcrc, zlength, zstamp, functions, file.hash))
+						{
+							hash_compute(file.hash, file.data, file.length, functions);
+							if (stamped)
+								hashcache_add(name, loadname, zcrc, zlength, zstamp, file.hash);
+						}
 						break;
 					}
 				}
@@ -1089,6 +1172,157 @@ static int checksum_file(int pathtype, int pathindex, const char *file, UINT8 **
 	osd_fclose(f);
 	return 0;
 }
+/***************************************************************************
+	hashcache_load
+***************************************************************************/
+
+static void hashcache_load(void)
+{
+	mame_file *f;
+	char line[2048];
+
+	hashcache_loaded = 1;
+	f = mame_fopen(HASHCACHE_NAME, NULL, FILETYPE_CONFIG, 0);
+	if (!f)
+		return;
+
+	while (mame_fgets(line, sizeof(line), f) != NULL)
+	{
+		/* crc, length, stamp, zip file, entry name, hash data; tab separated */
+		unsigned int crc, length, stamp;
+		char *zipfile, *filename, *hash, *end;
+
+		if (sscanf(line, "%x\t%x\t%x\t", &crc, &length, &stamp) != 3)
+			continue;
+		if ((zipfile = strchr(line, '\t')) == NULL || (zipfile = strchr(zipfile + 1, '\t')) == NULL || (zipfile = strchr(zipfile + 1, '\t')) == NULL)
+			continue;
+		if ((filename = strchr(++zipfile, '\t')) == NULL)
+			continue;
+		*filename++ = 0;
+		if ((hash = strchr(filename, '\t')) == NULL)
+			continue;
+		*hash++ = 0;
+		if ((end = strpbrk(hash, "\r\n")) != NULL)
+			*end = 0;
+		if (strlen(hash) >= HASH_BUF_SIZE)
+			continue;
+		hashcache_add(zipfile, filename, crc, length, stamp, hash);
+	}
+	mame_fclose(f);
+	hashcache_dirty = 0;
+}
+
+
+
+/***************************************************************************
+	hashcache_find
+***************************************************************************/
+
+static int hashcache_find(const char *zipfile, const char *filename, UINT32 crc, UINT32 length, UINT32 stamp, unsigned int functions, char *hash)
+{
+	int i;
+
+	if (!hashcache_loaded)
+		hashcache_load();
+
+	for (i = 0; i < hashcache_count; i++)
+	{
+		struct hashcache_entry *entry = &hashcache[i];
+		if (entry->crc == crc && entry->length == length && entry->stamp == stamp
+			&& !strcmp(entry->filename, filename) && !strcmp(entry->zipfile, zipfile))
+		{
+			/* the cached data must hold all the checksums we need */
+			if ((hash_data_used_functions(entry->hash) & functions) != functions)
+				return 0;
+			hash_data_copy(hash, entry->hash);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+
+
+/***************************************************************************
+	hashcache_add
+***************************************************************************/
+
+static void hashcache_add(const char *zipfile, const char *filename, UINT32 crc, UINT32 length, UINT32 stamp, const char *hash)
+{
+	struct hashcache_entry *entry = NULL;
+	int i;
+
+	if (!hashcache_loaded)
+		hashcache_load();
+
+	/* replace the entry for the same file if the archive was changed */
+	for (i = 0; i < hashcache_count; i++)
+		if (!strcmp(hashcache[i].filename, filename) && !strcmp(hashcache[i].zipfile, zipfile))
+		{
+			entry = &hashcache[i];
+			break;
+		}
+
+	if (!entry)
+	{
+		char *zipcopy, *filecopy;
+
+		if (hashcache_count >= HASHCACHE_MAX)
+			return;
+		if ((hashcache_count % 256) == 0)
+		{
+			struct hashcache_entry *newcache = realloc(hashcache, (hashcache_count + 256) * sizeof(*hashcache));
+			if (!newcache)
+				return;
+			hashcache = newcache;
+		}
+		zipcopy = malloc(strlen(zipfile) + 1);
+		filecopy = malloc(strlen(filename) + 1);
+		if (!zipcopy || !filecopy)
+		{
+			free(zipcopy);
+			free(filecopy);
+			return;
+		}
+		entry = &hashcache[hashcache_count++];
+		entry->zipfile = strcpy(zipcopy, zipfile);
+		entry->filename = strcpy(filecopy, filename);
+	}
+
+	entry->crc = crc;
+	entry->length = length;
+	entry->stamp = stamp;
+	hash_data_copy(entry->hash, hash);
+	hashcache_dirty = 1;
+}
+
+
+
+/***************************************************************************
+	mame_fhashcache_flush
+***************************************************************************/
+
+void mame_fhashcache_flush(void)
+{
+	mame_file *f;
+	int i;
+
+	if (!hashcache_dirty)
+		return;
+
+	f = mame_fopen(HASHCACHE_NAME, NULL, FILETYPE_CONFIG, 1);
+	if (!f)
+		return;
+
+	for (i = 0; i < hashcache_count; i++)
+		mame_fprintf(f, "%08x\t%08x\t%08x\t%s\t%s\t%s\n", hashcache[i].crc, hashcache[i].length, hashcache[i].stamp,
+			hashcache[i].zipfile, hashcache[i].filename, hashcache[i].hash);
+	mame_fclose(f);
+	hashcache_dirty = 0;
+}
+
+
+
 /***************************************************************************
 	mame_fputs
 ***************************************************************************/
@@ -24,6 +24,7 @@ static struct
 	struct mem_range
 	{
 		UINT32 cpu, addr, num_bytes, start_value, end_value;
+		UINT8 *base;	/* direct pointer to the range if it is plain RAM */
 		struct mem_range *next;
 	} *mem_range;
 } state;
@@ -134,21 +135,49 @@ static int safe_to_load (void)
 	struct mem_range *mem_range = state.mem_range;
 	while (mem_range)
 	{
-		if (cpunum_read_byte (mem_range->cpu, mem_range->addr) !=
-			mem_range->start_value)
+		if (mem_range->base)
 		{
-			return 0;
+			if (mem_range->base[0] != mem_range->start_value ||
+				mem_range->base[mem_range->num_bytes - 1] != mem_range->end_value)
+			{
+				return 0;
+			}
 		}
-		if (cpunum_read_byte (mem_range->cpu, mem_range->addr + mem_range->num_bytes - 1) !=
-			mem_range->end_value)
+		else
 		{
-			return 0;
+			if (cpunum_read_byte (mem_range->cpu, mem_range->addr) !=
+				mem_range->start_value)
+			{
+				return 0;
+			}
+			if (cpunum_read_byte (mem_range->cpu, mem_range->addr + mem_range->num_bytes - 1) !=
+				mem_range->end_value)
+			{
+				return 0;
+			}
 		}
 		mem_range = mem_range->next;
 	}
 	return 1;
 }
 
+/*	find_ram_base returns a pointer to the range if it is unbanked RAM of
+	an 8-bit CPU, so that the per-frame check in hs_update doesn't have to
+	go through the CPU context switch of cpunum_read_byte
+*/
+static UINT8 *find_ram_base (const struct mem_range *mem_range)
+{
+	UINT8 *base;
+
+	if (cpunum_databus_width (mem_range->cpu) != 8 || mem_range->num_bytes == 0)
+		return NULL;
+
+	cpuintrf_push_context (mem_range->cpu);
+	base = memory_get_ram_page (mem_range->cpu, mem_range->addr, mem_range->num_bytes);
+	cpuintrf_pop_context ();
+	return base;
+}
+
 /* hs_free disposes of the mem_range linked list */
 static void hs_free (void)
 {
@@ -192,28 +221,37 @@ static void hs_load (void)
 
 static void hs_save (void)
 {
-	mame_file *f = mame_fopen (Machine->gamedrv->name, 0, FILETYPE_HIGHSCORE, 1);
+	mame_file *f;
+	struct mem_range *mem_range;
+	UINT32 total = 0;
+	UINT8 *data;
+
 	LOG(("hs_save\n"));
+
+	/* gather all ranges first, so the file is written in one go */
+	for (mem_range = state.mem_range; mem_range; mem_range = mem_range->next)
+		total += mem_range->num_bytes;
+	data = malloc (total);
+	if (!data)
+		return;
+	total = 0;
+	for (mem_range = state.mem_range; mem_range; mem_range = mem_range->next)
+	{
+		if (mem_range->base)
+			memcpy (data + total, mem_range->base, mem_range->num_bytes);
+		else
+			copy_from_memory (mem_range->cpu, mem_range->addr, data + total, mem_range->num_bytes);
+		total += mem_range->num_bytes;
+	}
+
+	f = mame_fopen (Machine->gamedrv->name, 0, FILETYPE_HIGHSCORE, 1);
 	if (f)
 	{
-		struct mem_range *mem_range = state.mem_range;
 		LOG(("saving...\n"));
-		while (mem_range)
-		{
-			UINT8 *data = malloc (mem_range->num_bytes);
-			if (data)
-			{
-				/*	this buffer will almost certainly be small
-					enough to be dynamically allocated, but let's
-					avoid memory trashing just in case
-				*/
-				copy_from_memory (mem_range->cpu, mem_range->addr, data, mem_range->num_bytes);
-				mame_fwrite(f, data, mem_range->num_bytes);
-			}
-			mem_range = mem_range->next;
-		}
-		mame_fclose(f);
+		mame_fwrite (f, data, total);
+		mame_fclose (f);
 	}
+	free (data);
 }
 
 /*****************************************************************************/
@@ -222,9 +260,15 @@ static void hs_save (void)
 /* call hs_open once after loading a game */
 void hs_open (const char *name)
 {
-	mame_file *f = mame_fopen (NULL, db_filename, FILETYPE_HIGHSCORE_DB, 0);
+	mame_file *f;
 	state.mem_range = NULL;
 
+	/* a minimal core doesn't scan hiscore.dat at all */
+	if (options.minimal_core)
+		return;
+
+	f = mame_fopen (NULL, db_filename, FILETYPE_HIGHSCORE_DB, 0);
+
 	LOG(("hs_open: '%s'\n", name));
 
 	if (f)
@@ -254,6 +298,7 @@ void hs_open (const char *name)
 					mem_range->num_bytes = hexstr2num (&pBuf);
 					mem_range->start_value = hexstr2num (&pBuf);
 					mem_range->end_value = hexstr2num (&pBuf);
+					mem_range->base = NULL;
 
 					mem_range->next = NULL;
 					{
@@ -295,6 +340,8 @@ void hs_init (void)
 
 	while (mem_range)
 	{
+		mem_range->base = find_ram_base (mem_range);
+
 		cpunum_write_byte(
 			mem_range->cpu,
 			mem_range->addr,
@@ -2407,6 +2407,14 @@ void update_input_ports(void)
 #ifdef MAME_NET
 	int player;
 #endif /* MAME_NET */
+#ifdef PINMAME
+	/* when the host sets the switches itself, only the default values */
+	/* (DIP switches) and VBLANK bits are needed: skip the key sequences */
+	extern int g_fHandleKeyboard;
+	const int scan_keys = g_fHandleKeyboard;
+#else
+	const int scan_keys = 1;
+#endif
 
 
 profiler_mark(PROFILER_INPUT);
@@ -2433,7 +2441,8 @@ profiler_mark(PROFILER_INPUT);
 		in++;
 	}
 
-	ScanJoysticks( in ); /* populates mJoyCurrent[] */
+	if (scan_keys)
+		ScanJoysticks( in ); /* populates mJoyCurrent[] */
 
 	/* scan all the input ports */
 	port = 0;
@@ -2504,6 +2513,8 @@ if (Machine->drv->vblank_duration == 0)
 							= in->default_value * 100 / IP_GET_SENSITIVITY(in);
 					}
 				}
+				else if (!scan_keys)
+					waspressed[ib] = 0;
 				else
 				{
 					InputSeq* seq;
@@ -2672,6 +2683,9 @@ void inputport_vblank_end(void)
 {
 	int port;
 	int i;
+#ifdef PINMAME
+	extern int g_fHandleKeyboard;
+#endif
 
 
 profiler_mark(PROFILER_INPUT);
@@ -2684,6 +2698,15 @@ profiler_mark(PROFILER_INPUT);
 		}
 	}
 
+#ifdef PINMAME
+	/* the host handles the input devices */
+	if (!g_fHandleKeyboard)
+	{
+profiler_mark(PROFILER_END);
+		return;
+	}
+#endif
+
 	/* update the analog devices */
 	for (i = 0;i < OSD_MAX_JOY_ANALOG;i++)
 	{
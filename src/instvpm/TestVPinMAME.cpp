@@ -145,8 +145,26 @@ typedef struct tagGAMEINFO {
 	char	szGameName[64];
 	char	szGameDescription[128];
 	BOOL	fROMAvailable; 
+	long	lROMState;		// IRoms::State after "Check All", -1 if not checked
 } GAMEINFO, *PGAMEINFO;
 
+/* the list entry for a game: description, name and the ROM state */
+void FormatListEntry(PGAMEINFO pGameInfo, char *szListEntry)
+{
+	lstrcpy(szListEntry, pGameInfo->szGameDescription);
+	lstrcat(szListEntry, "\t");
+	lstrcat(szListEntry, pGameInfo->szGameName);
+
+	if ( pGameInfo->lROMState==0 )
+		lstrcat(szListEntry, "\tbad");
+	else if ( pGameInfo->lROMState==2 )
+		lstrcat(szListEntry, "\t(ok)");
+	else if ( pGameInfo->lROMState==1 )
+		lstrcat(szListEntry, "\tok");
+	else if ( pGameInfo->fROMAvailable )
+		lstrcat(szListEntry, "\tX");
+}
+
 void DeleteListContent(HWND hWnd)
 {
 	HWND hGamesList = GetDlgItem(hWnd, IDC_GAMESLIST);
@@ -219,6 +237,7 @@ BOOL PopulateListGreaterV1_10(HWND hWnd, IController *pController)
 
 		PGAMEINFO pGameInfo = new GAMEINFO;
 		pGameInfo->fROMAvailable = false;
+		pGameInfo->lROMState = -1;
 
 		/* get a pointer to the IRoms interface */
 		IRoms* pRoms;
@@ -236,18 +255,14 @@ BOOL PopulateListGreaterV1_10(HWND hWnd, IController *pController)
 		/* fetch the infos we need */
 		pGame->get_Description(&sHelp);
 		WideCharToMultiByte(CP_ACP, 0, (LPOLESTR) sHelp, -1, pGameInfo->szGameDescription, sizeof pGameInfo->szGameDescription, NULL, NULL);
-		lstrcpy(szListEntry, pGameInfo->szGameDescription);
-		lstrcat(szListEntry, "\t");
 
 		pGame->get_Name(&sHelp);
 		WideCharToMultiByte(CP_ACP, 0, (LPOLESTR) sHelp, -1, pGameInfo->szGameName, sizeof pGameInfo->szGameName, NULL, NULL);
-		lstrcat(szListEntry, pGameInfo->szGameName);
 
 		/* done */
 		pGame->Release();
 
-		if ( pGameInfo->fROMAvailable )
-			lstrcat(szListEntry, "\tX");
+		FormatListEntry(pGameInfo, szListEntry);
 
 		/* put it to the list */
 		size_t nIndex = SendMessage(hGamesList, LB_ADDSTRING, 0, (LPARAM) szListEntry);
@@ -330,6 +345,87 @@ void CheckRoms(HWND hWnd, IController *pController)
 }
 
 
+/***************************************************************************************/
+/* Audits every game whose ROM set is available and shows the result in the list /*
+/***************************************************************************************/
+void CheckAllRoms(HWND hWnd, IController *pController)
+{
+	HWND hGamesList = GetDlgItem(hWnd, IDC_GAMESLIST);
+	HWND hState = GetDlgItem(hWnd, IDC_STATE);
+
+	IGames* pGames = NULL;
+	if ( FAILED(pController->get_Games(&pGames)) || !pGames )
+		return;
+
+	/* only the sets that are there are worth an audit; the others can't be played anyway */
+	const int nCount = (int) SendMessage(hGamesList, LB_GETCOUNT, 0, 0);
+	PGAMEINFO* pGameInfos = new PGAMEINFO[nCount];
+	int nAvailable = 0;
+	for(int i=0; i<nCount; i++) {
+		pGameInfos[i] = (PGAMEINFO) SendMessage(hGamesList, LB_GETITEMDATA, i, 0);
+		if ( pGameInfos[i]->fROMAvailable )
+			nAvailable++;
+	}
+
+	HCURSOR hOldCursor = SetCursor(LoadCursor(NULL, IDC_WAIT));
+
+	/* parents and clones sit next to each other in the sorted list, so a shared */
+	/* zip is still in the unzip cache when the next set needs it */
+	int nChecked = 0, nBad = 0;
+	for(int i=0; i<nCount; i++) {
+		PGAMEINFO pGameInfo = pGameInfos[i];
+		if ( !pGameInfo->fROMAvailable )
+			continue;
+
+		TCHAR szState[256];
+		wsprintf(szState, TEXT("Checking '%s' (%i of %i)..."), pGameInfo->szGameName, ++nChecked, nAvailable);
+		SetWindowText(hState, szState);
+		UpdateWindow(hState);
+
+		VARIANT vGameName;
+		OLECHAR wszGameName[64];
+		MultiByteToWideChar(CP_ACP, 0, pGameInfo->szGameName, -1, wszGameName, 64);
+		vGameName.vt = VT_BSTR;
+		vGameName.bstrVal = SysAllocString(wszGameName);
+
+		IGame* pGame = NULL;
+		if ( SUCCEEDED(pGames->get_Item(&vGameName, &pGame)) && pGame ) {
+			IRoms* pRoms = NULL;
+			if ( SUCCEEDED(pGame->get_Roms(&pRoms)) && pRoms ) {
+				pRoms->Audit(VARIANT_FALSE);
+				pRoms->get_State(&pGameInfo->lROMState);
+				pRoms->Release();
+			}
+			pGame->Release();
+		}
+		VariantClear(&vGameName);
+
+		if ( pGameInfo->lROMState==0 )
+			nBad++;
+	}
+
+	pGames->Release();
+
+	/* rebuild the list with the results; the item data survives */
+	SendMessage(hGamesList, WM_SETREDRAW, FALSE, 0);
+	SendMessage(hGamesList, LB_RESETCONTENT, 0, 0);
+	for(int i=0; i<nCount; i++) {
+		char szListEntry[256];
+		FormatListEntry(pGameInfos[i], szListEntry);
+		LRESULT nIndex = SendMessage(hGamesList, LB_ADDSTRING, 0, (LPARAM) szListEntry);
+		SendMessage(hGamesList, LB_SETITEMDATA, nIndex, (LPARAM) pGameInfos[i]);
+	}
+	SendMessage(hGamesList, WM_SETREDRAW, TRUE, 0);
+	InvalidateRect(hGamesList, NULL, TRUE);
+	delete[] pGameInfos;
+
+	SetCursor(hOldCursor);
+
+	TCHAR szState[256];
+	wsprintf(szState, TEXT("%i ROM sets checked, %i with errors."), nChecked, nBad);
+	SetWindowText(hState, szState);
+}
+
 /***************************************************************************************/
 /* Displays the game options /*
 /***************************************************************************************/
@@ -478,6 +574,10 @@ INT_PTR PASCAL RunDlgProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
 			CheckRoms(hWnd, pController);
 			break;
 
+		case IDC_CHECKALLROMS:
+			CheckAllRoms(hWnd, pController);
+			break;
+
 		case IDC_GAMESLIST:
 			switch (HIWORD(wParam)) {
 			case LBN_DBLCLK:
@@ -20,6 +20,7 @@
 #define IDC_VERSION                     1009
 #define IDC_OPTIONS                     1010
 #define IDC_CHECKROMS                   1011
+#define IDC_CHECKALLROMS                1012
 
 // Next default values for new objects
 // 
@@ -27,7 +28,7 @@
 #ifndef APSTUDIO_READONLY_SYMBOLS
 #define _APS_NEXT_RESOURCE_VALUE        105
 #define _APS_NEXT_COMMAND_VALUE         40001
-#define _APS_NEXT_CONTROL_VALUE         1012
+#define _APS_NEXT_CONTROL_VALUE         1013
 #define _APS_NEXT_SYMED_VALUE           101
 #endif
 #endif
@@ -0,0 +1,306 @@
+// license:BSD-3-Clause
+
+// Headless emulation benchmark: runs one representative game per hardware generation unthrottled
+// for a fixed emulated time and prints the results as JSON on stdout.
+//
+//   pinmame_bench [-t seconds] [-p vpmPath] [--record corpusDir [-f framesPerCrc] | --verify corpusDir] [game ...]
+//
+// Games without ROMs in <vpmPath>/roms are reported as "missing". All rates are per wall clock second.
+//
+// --record stores a golden output corpus: for each game, the input script as a replay (<game>.replay) and
+// checksums of the DMD frames and of the audio (<game>.golden, see PinmameSetGoldenOutput). --verify replays
+// it, reports the first frame that diverges and exits with 1 on any mismatch. Both start each game from a
+// blank NVRAM kept in <corpusDir>/nvram, so that runs are reproducible.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <string>
+#include <filesystem>
+#include "libpinmame.h"
+
+typedef struct {
+	const char* name;
+	const char* label;
+	int startSw; // pressed 3 and 5 emulated seconds after the boot, 0 for none
+} BenchGame;
+
+static const BenchGame _benchGames[] = {
+	{ "bk_l4",    "S7",          3 },
+	{ "t2_l8",    "WPC DMD",    13 },
+	{ "mm_109c",  "WPC95 DCS",  13 },
+	{ "lw3_208",  "DE 128x32",   0 },
+	{ "monopoly", "Whitestar",  54 },
+	{ "sfight2",  "GTS3",        0 },
+	{ "tf_180h",  "SAM",         0 },
+	{ "pmv112",   "Capcom",      0 },
+	{ "mystcast", "Alvin G",     0 },
+};
+
+static std::atomic<int> _running(0);
+static std::atomic<int> _stopped(0);
+static std::atomic<uint64_t> _displayUpdates(0);
+static std::atomic<uint64_t> _audioSamples(0);
+static int _found = 0;
+
+typedef struct {
+	PINMAME_GOLDEN_MODE mode;
+	std::string dir;
+	int framesPerCrc;
+	int failures;
+} Corpus;
+
+void PINMAMECALLBACK OnGame(PinmameGame* p_game, const void* p_userData)
+{
+	_found = p_game->found;
+}
+
+void PINMAMECALLBACK OnStateUpdated(int state, const void* p_userData)
+{
+	if (state)
+		_running = 1;
+	else
+		_stopped = 1;
+}
+
+void PINMAMECALLBACK OnDisplayAvailable(int index, int displayCount, PinmameDisplayLayout* p_displayLayout, const void* p_userData)
+{
+}
+
+void PINMAMECALLBACK OnDisplayUpdated(int index, void* p_displayData, PinmameDisplayLayout* p_displayLayout, const void* p_userData)
+{
+	if (p_displayData)
+		_displayUpdates++;
+}
+
+int PINMAMECALLBACK OnAudioAvailable(PinmameAudioInfo* p_audioInfo, const void* p_userData)
+{
+	return p_audioInfo->samplesPerFrame;
+}
+
+int PINMAMECALLBACK OnAudioUpdated(void* p_buffer, int samples, const void* p_userData)
+{
+	_audioSamples += samples;
+	return samples;
+}
+
+void PINMAMECALLBACK OnLogMessage(PINMAME_LOG_LEVEL logLevel, const char* format, va_list args, const void* p_userData)
+{
+	if (logLevel == PINMAME_LOG_LEVEL_ERROR) {
+		fprintf(stderr, "ERROR: ");
+		vfprintf(stderr, format, args);
+		fprintf(stderr, "\n");
+	}
+}
+
+static double EmulatedTime()
+{
+	PinmameOutputBatch batch;
+	memset(&batch, 0, sizeof(batch));
+
+	return (PinmameGetChangedOutputs(&batch) == PINMAME_STATUS_OK) ? batch.timestamp : -1.;
+}
+
+static bool SetupCorpus(Corpus& corpus, const char* const p_name)
+{
+	if (corpus.mode == PINMAME_GOLDEN_MODE_NONE)
+		return true;
+
+	const std::filesystem::path dir(corpus.dir);
+	const std::string replay = (dir / (std::string(p_name) + ".replay")).string();
+	const std::string golden = (dir / (std::string(p_name) + ".golden")).string();
+	std::error_code error;
+
+	if (corpus.mode == PINMAME_GOLDEN_MODE_VERIFY && (!std::filesystem::exists(replay) || !std::filesystem::exists(golden)))
+		return false;
+
+	std::filesystem::create_directories(dir / "nvram", error);
+	std::filesystem::remove(dir / "nvram" / (std::string(p_name) + ".nv"), error);
+
+	if (corpus.mode == PINMAME_GOLDEN_MODE_RECORD)
+		PinmameSetRecording(replay.c_str(), 1.);
+	else
+		PinmameSetReplay(replay.c_str());
+
+	PinmameSetGoldenOutput(golden.c_str(), corpus.mode, corpus.framesPerCrc);
+	return true;
+}
+
+static void PrintCorpus(Corpus& corpus)
+{
+	static const char* const mismatches[] = { "none", "luminance", "bitplane", "audio", "sequence" };
+	PinmameGoldenStatus golden;
+	PinmameReplayStatus replay;
+
+	PinmameGetGoldenStatus(&golden);
+	PinmameGetReplayStatus(&replay);
+
+	const bool failed = golden.mismatch != PINMAME_GOLDEN_MISMATCH_NONE || replay.mismatches || !golden.checks;
+	if (corpus.mode == PINMAME_GOLDEN_MODE_VERIFY && failed)
+		corpus.failures++;
+
+	printf(", \"golden\": {\"mode\": \"%s\", \"checks\": %u", corpus.mode == PINMAME_GOLDEN_MODE_RECORD ? "record" : "verify", golden.checks);
+	if (corpus.mode == PINMAME_GOLDEN_MODE_VERIFY) {
+		printf(", \"status\": \"%s\", \"stateMismatches\": %u", failed ? "mismatch" : "match", replay.mismatches);
+		if (golden.mismatch != PINMAME_GOLDEN_MISMATCH_NONE)
+			printf(", \"mismatch\": \"%s\", \"firstFrame\": %u, \"time\": %.3f", mismatches[golden.mismatch], golden.firstMismatchFrame, golden.firstMismatchTime);
+	}
+	printf("}");
+}
+
+static void RunGame(const BenchGame* p_game, const double seconds, const bool first, Corpus& corpus)
+{
+	printf("%s\n    {\"game\": \"%s\", \"gen\": \"%s\", ", first ? "" : ",", p_game->name, p_game->label);
+
+	_found = 0;
+	if (PinmameGetGame(p_game->name, &OnGame, NULL) != PINMAME_STATUS_OK) {
+		printf("\"status\": \"unknown\"}");
+		return;
+	}
+	if (!_found) {
+		printf("\"status\": \"missing\"}");
+		return;
+	}
+
+	if (!SetupCorpus(corpus, p_game->name)) {
+		printf("\"status\": \"no reference\"}");
+		corpus.failures++;
+		return;
+	}
+
+	_running = 0;
+	_stopped = 0;
+	_displayUpdates = 0;
+	_audioSamples = 0;
+
+	if (PinmameRun(p_game->name) != PINMAME_STATUS_OK) {
+		printf("\"status\": \"failed\"}");
+		return;
+	}
+
+	while (!_running && !_stopped)
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+	if (p_game->startSw) {
+		const PinmameSwitchEvent events[] = {
+			{ p_game->startSw, 1, 3.0 }, { p_game->startSw, 0, 3.1 },
+			{ p_game->startSw, 1, 5.0 }, { p_game->startSw, 0, 5.1 }
+		};
+		PinmameQueueSwitchEvents(events, sizeof(events) / sizeof(events[0]));
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	double emulated = 0.;
+
+	while (!_stopped && (emulated = EmulatedTime()) < seconds)
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+	const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	PinmameCpuStats cpus[8];
+	const int cpuCount = PinmameGetCpuStats(cpus, 8);
+	const uint64_t displayUpdates = _displayUpdates;
+	const uint64_t audioSamples = _audioSamples;
+	const bool stopped = _stopped;
+
+	PinmameStop();
+
+	if (stopped && emulated < seconds) {
+		printf("\"status\": \"stopped\", \"emulatedSeconds\": %.3f}", emulated);
+		return;
+	}
+
+	printf("\"status\": \"ok\", \"emulatedSeconds\": %.3f, \"wallSeconds\": %.3f, \"speed\": %.3f, "
+		"\"displayUpdatesPerSecond\": %.1f, \"audioSamplesPerSecond\": %.1f, \"cpus\": [",
+		emulated, wall, emulated / wall, displayUpdates / wall, audioSamples / wall);
+
+	for (int i = 0; i < cpuCount && i < 8; i++)
+		printf("%s{\"name\": \"%s\", \"clock\": %d, \"cyclesPerSecond\": %.0f}", i ? ", " : "",
+			cpus[i].name, cpus[i].clock, cpus[i].cycles / wall);
+
+	printf("]");
+	if (corpus.mode != PINMAME_GOLDEN_MODE_NONE)
+		PrintCorpus(corpus);
+	printf("}");
+}
+
+int main(int argc, char** argv)
+{
+	double seconds = 30.;
+	const char* p_path = NULL;
+	std::vector<BenchGame> games;
+	Corpus corpus = { PINMAME_GOLDEN_MODE_NONE, "", 10, 0 };
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-t") && i + 1 < argc)
+			seconds = atof(argv[++i]);
+		else if (!strcmp(argv[i], "-p") && i + 1 < argc)
+			p_path = argv[++i];
+		else if ((!strcmp(argv[i], "--record") || !strcmp(argv[i], "--verify")) && i + 1 < argc) {
+			corpus.mode = !strcmp(argv[i], "--record") ? PINMAME_GOLDEN_MODE_RECORD : PINMAME_GOLDEN_MODE_VERIFY;
+			corpus.dir = argv[++i];
+		}
+		else if (!strcmp(argv[i], "-f") && i + 1 < argc)
+			corpus.framesPerCrc = atoi(argv[++i]);
+		else
+			games.push_back({ argv[i], "", 0 });
+	}
+
+	if (games.empty())
+		games.assign(_benchGames, _benchGames + sizeof(_benchGames) / sizeof(_benchGames[0]));
+
+	PinmameConfig config = {
+		PINMAME_AUDIO_FORMAT_INT16,
+		44100,
+		"",
+		&OnStateUpdated,
+		&OnDisplayAvailable,
+		&OnDisplayUpdated,
+		&OnAudioAvailable,
+		&OnAudioUpdated,
+		NULL,
+		NULL,
+		NULL,
+		NULL,
+		NULL,
+		&OnLogMessage,
+		NULL,
+	};
+
+	if (p_path) {
+		snprintf((char*)config.vpmPath, PINMAME_MAX_PATH, "%s", p_path);
+	}
+	else {
+	#if defined(_WIN32) || defined(_WIN64)
+		snprintf((char*)config.vpmPath, PINMAME_MAX_PATH, "%s%s\\pinmame\\", getenv("HOMEDRIVE"), getenv("HOMEPATH"));
+	#else
+		snprintf((char*)config.vpmPath, PINMAME_MAX_PATH, "%s/.pinmame/", getenv("HOME"));
+	#endif
+	}
+
+	PinmameSetConfig(&config);
+
+	if (corpus.mode != PINMAME_GOLDEN_MODE_NONE) {
+		const std::string nvram = (std::filesystem::path(corpus.dir) / "nvram").string();
+		PinmameSetPath(PINMAME_FILE_TYPE_NVRAM, nvram.c_str());
+	}
+
+	PinmameSetCheat(0);
+	PinmameSetHandleKeyboard(0);
+	PinmameSetHandleMechanics(0);
+	PinmameSetDmdMode(PINMAME_DMD_MODE_RAW);
+	PinmameSetSpeedMode(PINMAME_SPEED_MODE_UNTHROTTLED, 1);
+
+	printf("{\n  \"emulatedSeconds\": %.3f,\n  \"results\": [", seconds);
+
+	for (size_t i = 0; i < games.size(); i++)
+		RunGame(&games[i], seconds, i == 0, corpus);
+
+	printf("\n  ]\n}\n");
+
+	return corpus.failures ? 1 : 0;
+}
@@ -0,0 +1,224 @@
+// license:BSD-3-Clause
+
+// Differential CPU trace comparison: reads two traces written by PinmameSetCpuTrace, typically the same
+// input replay (PinmameSetReplay) run with two builds of a CPU core, reports the first timeslice where the
+// registers, the cycle counts or the machine state hashes differ, and compares the speed of both runs.
+//
+//   pinmame_cpudiff [-c contextLines] reference.trace candidate.trace
+//
+// Exits with 0 if the traces match, 1 if they diverge and 2 on errors.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <sstream>
+
+#define CPU_TRACE_MAGIC "PMCPUTRACE1"
+
+typedef struct {
+	std::string name;
+	uint64_t slices;
+	uint64_t cycles;
+	uint64_t host;
+} CpuTotals;
+
+typedef struct {
+	FILE* p_file;
+	const char* p_path;
+	std::string game;
+	double hostTicksPerSecond;
+	std::map<int, CpuTotals> cpus;
+	uint64_t lineNo;
+} Trace;
+
+static bool ReadLine(Trace& trace, std::string& line)
+{
+	char buffer[1024];
+	line.clear();
+
+	while (fgets(buffer, sizeof(buffer), trace.p_file)) {
+		line += buffer;
+		if (!line.empty() && line.back() == '\n') {
+			line.pop_back();
+			break;
+		}
+	}
+	if (line.empty() && feof(trace.p_file))
+		return false;
+
+	trace.lineNo++;
+	return true;
+}
+
+// Accounts a line and returns its comparable part: timeslices without the host time, which always differs
+static std::string Digest(Trace& trace, const std::string& line)
+{
+	if (line[0] == 'N') {
+		int cpu;
+		char name[64];
+		if (sscanf(line.c_str(), "N %d %63s", &cpu, name) == 2)
+			trace.cpus[cpu].name = name;
+		return line;
+	}
+	if (line[0] != 'C')
+		return line;
+
+	int cpu, cycles;
+	double time;
+	long long host;
+	int length = 0;
+	if (sscanf(line.c_str(), "C %d %lf %d %lld%n", &cpu, &time, &cycles, &host, &length) != 4)
+		return line;
+
+	CpuTotals& totals = trace.cpus[cpu];
+	totals.slices++;
+	totals.cycles += cycles;
+	totals.host += host;
+
+	char head[64];
+	snprintf(head, sizeof(head), "C %d %.9f %d", cpu, time, cycles);
+	return head + line.substr(length);
+}
+
+static bool Open(Trace& trace, const char* p_path)
+{
+	trace.p_path = p_path;
+	trace.lineNo = 0;
+	trace.p_file = fopen(p_path, "r");
+	if (!trace.p_file) {
+		fprintf(stderr, "Unable to open %s\n", p_path);
+		return false;
+	}
+
+	std::string line;
+	char magic[16], game[64];
+	long long ticks;
+	if (!ReadLine(trace, line) || sscanf(line.c_str(), "%15s %63s %lld", magic, game, &ticks) != 3 || strcmp(magic, CPU_TRACE_MAGIC)) {
+		fprintf(stderr, "%s is not a CPU trace\n", p_path);
+		return false;
+	}
+
+	trace.game = game;
+	trace.hostTicksPerSecond = (double)ticks;
+	return true;
+}
+
+static void PrintRegisterDiff(const std::string& reference, const std::string& candidate)
+{
+	const size_t refRegs = reference.find('|');
+	const size_t candRegs = candidate.find('|');
+	if (refRegs == std::string::npos || candRegs == std::string::npos)
+		return;
+
+	std::istringstream refStream(reference.substr(refRegs + 1, reference.find('|', refRegs + 1) - refRegs - 1));
+	std::istringstream candStream(candidate.substr(candRegs + 1, candidate.find('|', candRegs + 1) - candRegs - 1));
+	std::string refReg, candReg;
+
+	printf("registers:");
+	while (refStream >> refReg && candStream >> candReg) {
+		if (refReg != candReg)
+			printf(" %s -> %s", refReg.c_str(), candReg.c_str());
+	}
+	printf("\n");
+}
+
+static void PrintSpeed(const Trace& reference, const Trace& candidate)
+{
+	for (const auto& entry : reference.cpus) {
+		const CpuTotals& ref = entry.second;
+		const auto it = candidate.cpus.find(entry.first);
+		if (it == candidate.cpus.end() || !ref.slices)
+			continue;
+		const CpuTotals& cand = it->second;
+
+		const double refSeconds = ref.host / reference.hostTicksPerSecond;
+		const double candSeconds = cand.host / candidate.hostTicksPerSecond;
+
+		printf("cpu %d %s: %llu timeslices, reference %.2f MHz emulated per host second, candidate %.2f MHz, speedup %.2fx\n",
+			entry.first, ref.name.c_str(), (unsigned long long)ref.slices,
+			refSeconds > 0. ? ref.cycles / refSeconds / 1e6 : 0.,
+			candSeconds > 0. ? cand.cycles / candSeconds / 1e6 : 0.,
+			candSeconds > 0. ? refSeconds / candSeconds : 0.);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	size_t contextLines = 8;
+	std::vector<const char*> paths;
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-c") && i + 1 < argc)
+			contextLines = (size_t)atoi(argv[++i]);
+		else
+			paths.push_back(argv[i]);
+	}
+
+	if (paths.size() != 2) {
+		fprintf(stderr, "usage: pinmame_cpudiff [-c contextLines] reference.trace candidate.trace\n");
+		return 2;
+	}
+
+	Trace reference, candidate;
+	if (!Open(reference, paths[0]) || !Open(candidate, paths[1]))
+		return 2;
+
+	if (reference.game != candidate.game) {
+		fprintf(stderr, "The traces are for different games (%s, %s)\n", reference.game.c_str(), candidate.game.c_str());
+		return 2;
+	}
+
+	std::deque<std::string> context;
+	std::string refLine, candLine;
+	int result = 0;
+
+	for (;;) {
+		const bool refMore = ReadLine(reference, refLine);
+		const bool candMore = ReadLine(candidate, candLine);
+
+		if (!refMore || !candMore) {
+			if (refMore != candMore) {
+				printf("%s ends first, at line %llu\n", refMore ? candidate.p_path : reference.p_path,
+					(unsigned long long)(refMore ? candidate.lineNo : reference.lineNo));
+				result = 1;
+			}
+			break;
+		}
+		if (refLine.empty() || candLine.empty())
+			continue;
+
+		const std::string refDigest = Digest(reference, refLine);
+		const std::string candDigest = Digest(candidate, candLine);
+
+		if (refDigest != candDigest) {
+			printf("traces diverge at line %llu, after:\n", (unsigned long long)reference.lineNo);
+			for (const std::string& line : context)
+				printf("  %s\n", line.c_str());
+			printf("reference: %s\ncandidate: %s\n", refDigest.c_str(), candDigest.c_str());
+			if (refDigest[0] == 'C' && candDigest[0] == 'C')
+				PrintRegisterDiff(refDigest, candDigest);
+			result = 1;
+			break;
+		}
+
+		if (contextLines) {
+			context.push_back(refDigest);
+			if (context.size() > contextLines)
+				context.pop_front();
+		}
+	}
+
+	if (!result)
+		printf("traces match (%llu lines)\n", (unsigned long long)reference.lineNo);
+
+	PrintSpeed(reference, candidate);
+
+	fclose(reference.p_file);
+	fclose(candidate.p_file);
+
+	return result;
+}
@@ -846,6 +846,87 @@ void osd_fclose(osd_file *file)
 
 
 
+//============================================================
+//	osd_replace_file
+//============================================================
+
+// writes a whole file next to the target and renames it over the target, so
+// a power loss leaves either the old or the new file; this doesn't use the
+// openfile[] table, so it can be called from a worker thread once the paths
+// of the file type have been expanded (i.e. after a first osd_fopen)
+int osd_replace_file(int pathtype, int pathindex, const char *filename, const void *data, UINT32 length)
+{
+	TCHAR fullpath[1024];
+	TCHAR temppath[1024 + 4];
+#if defined(_WIN32) || defined(_WIN64)
+	HANDLE handle;
+	DWORD written = 0;
+#else
+	int handle;
+	ssize_t written;
+#endif
+
+	/* compose the full path and the temporary one */
+	compose_path(fullpath, pathtype, pathindex, filename);
+#if defined(_WIN32) || defined(_WIN64)
+	_tcscpy(temppath, fullpath);
+	appendstring(temppath, ".tmp");
+
+	handle = CreateFile(temppath, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, 0, NULL);
+	if (handle == INVALID_HANDLE_VALUE)
+	{
+		create_path(temppath, 1);
+		handle = CreateFile(temppath, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, 0, NULL);
+		if (handle == INVALID_HANDLE_VALUE)
+			return 1;
+	}
+
+	if (!WriteFile(handle, data, length, &written, NULL) || written != length || !FlushFileBuffers(handle))
+	{
+		CloseHandle(handle);
+		DeleteFile(temppath);
+		return 1;
+	}
+	CloseHandle(handle);
+
+	if (!MoveFileEx(temppath, fullpath, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+	{
+		DeleteFile(temppath);
+		return 1;
+	}
+#else
+	strcpy(temppath, fullpath);
+	strcat(temppath, ".tmp");
+
+	handle = open(temppath, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (handle == INVALID_HANDLE_VALUE)
+	{
+		create_path(temppath, 1);
+		handle = open(temppath, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+		if (handle == INVALID_HANDLE_VALUE)
+			return 1;
+	}
+
+	written = write(handle, data, length);
+	if (written != (ssize_t)length || fsync(handle) != 0)
+	{
+		close(handle);
+		unlink(temppath);
+		return 1;
+	}
+	close(handle);
+
+	if (rename(temppath, fullpath) != 0)
+	{
+		unlink(temppath);
+		return 1;
+	}
+#endif
+	return 0;
+}
+
+
+
 //============================================================
 //	osd_display_loading_rom_message
 //============================================================
@@ -3,9 +3,16 @@
 #include "libpinmame.h"
 
 #include "../../ext/libsamplerate/samplerate.h"
+#include <zlib.h>
 
 #include <thread>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 #include <vector>
+#include <string>
+#include <deque>
 #include <algorithm>
 
 #if defined(_WIN32) || defined(_WIN64)
@@ -21,6 +28,20 @@ extern "C" {
 #include "video.h"
 #include "audit.h"
 #include "mech.h"
+#include "outexport.h"
+#include "netpub.h"
+#include "gamealias.h"
+#include "threadsched.h"
+#include "romshare.h"
+#include "state.h"
+
+extern UINT8 g_raw_dmdbuffer[];
+extern UINT32 g_raw_colordmdbuffer[];
+extern UINT64 g_raw_dmd_hash;
+extern UINT64 g_raw_dmd_dirty_rows;
+
+extern int osd_replace_file(int pathtype, int pathindex, const char *filename, const void *data, UINT32 length);
+extern void time_fence_get_stats(double *waiting, double *running, UINT32 *waits, UINT32 *spin_hits);
 
 extern int throttle;
 extern int autoframeskip;
@@ -38,6 +59,10 @@ char g_szGameName[256] = {0}; //!! not set yet
 
 static int _isRunning = 0;
 static int _timeToQuit = 0;
+static std::mutex _switchMutex; // _timeToQuit and _nextGameNum transitions
+static int _nextGameNum = -1;   // Game to start when the running one has quit (PinmameSwitchGame)
+static int _gameThreadActive = 0; // GameThread still takes switch requests
+static int _warmSwitch = 0;     // Starting a game through PinmameSwitchGame
 static PinmameConfig* _p_Config = nullptr;
 static std::thread* _p_gameThread = nullptr;
 static void* _p_userData = nullptr;
@@ -45,20 +70,326 @@ static void* _p_userData = nullptr;
 static int _mechInit[MECH_MAXMECH];
 static PinmameMechInfo _mechInfo[MECH_MAXMECH];
 
+// Switch event queue: single producer (host thread, PinmameQueueSwitchEvents), single consumer
+// (emulation thread, polled by the core every millisecond of emulated time)
+#define SWITCH_EVENT_QUEUE_SIZE 256 // must be a power of 2
+
+static PinmameSwitchEvent _switchEvents[SWITCH_EVENT_QUEUE_SIZE];
+static std::atomic<unsigned int> _switchEventRead(0);
+static std::atomic<unsigned int> _switchEventWrite(0);
+
+// Last state reported by PinmameGetChangedOutputs
+static uint64_t _outputSequence = 0;
+static PinmameMechState _outputMechState[MECH_MAXMECH / 2];
+
+// Unthrottled mode: no speed throttling, no audio output, display callbacks only every _frameDecimation frames
+static PINMAME_SPEED_MODE _speedMode = PINMAME_SPEED_MODE_NORMAL;
+static int _frameDecimation = 1;
+
+// Pause: the emulation thread sleeps on _pauseCond until resumed, stopped or asked for a state request
+static std::mutex _pauseMutex;
+static std::condition_variable _pauseCond;
+
+// Eco attract mode: once no switch changed for _ecoIdleTime and the main DMD only shows frames seen
+// before (the attract loop), display callbacks are only made every _ecoDecimation frames
+#define ECO_HASH_HISTORY 512 // Main DMD frames remembered to recognize the attract loop
+#define ECO_LOOP_FRAMES  32  // Consecutive known frames needed to consider the display is looping
+static std::atomic<double> _ecoIdleTime(0.);
+static std::atomic<int> _ecoDecimation(1);
+static std::atomic<int> _ecoActivity(0);
+static std::atomic<int> _ecoActive(0);
+static double _ecoLastActivity = 0.;
+static uint64_t _ecoHashes[ECO_HASH_HISTORY];
+static int _ecoHashCount = 0;
+static int _ecoKnownFrames = 0;
+
+// Emulated time sampled by the game thread, used to measure emulation speed
+static std::atomic<double> _emulatedTime(0.);
+static std::atomic<uint64_t> _cpuCycles[MAX_CPU];
+static std::atomic<int> _cpuCount(0);
+
+// Timer callback counters, copied by the emulation thread every TIMERSTATS_INTERVAL emulated seconds
+#define TIMERSTATS_INTERVAL 0.1
+
+static std::mutex _timerStatsMutex;
+static std::vector<PinmameTimerStats> _timerStats;
+static double _timerStatsTime = 0.;
+static std::atomic<int> _timerProfiling(0);
+static int _timerProfilingApplied = 0;
+static double _lastSpeedEmulatedTime = 0.;
+static std::chrono::steady_clock::time_point _lastSpeedWallTime;
+
 static PinmameAudioInfo _audioInfo;
+static int _audioChannels = 0; // Channels requested by the host, 0 for the game layout
+static int _audioUpmix = 0;    // Mono game played on a stereo stream
+static INT16 _audioUpmix16[PINMAME_ACCUMULATOR_SAMPLES * 2];
+static float _audioUpmixFloat[PINMAME_ACCUMULATOR_SAMPLES * 2];
+static int _audioStreamResult = -1; // Host answer to cb_OnAudioAvailable for _audioInfo, -1 if no stream was opened
 static float _audioData[PINMAME_ACCUMULATOR_SAMPLES * 2];
 
+// Audio queue for hosts without cb_OnAudioUpdated: single producer (emulation thread), single consumer
+// (host audio thread, PinmameGetAudio). Positions are in samples and only ever increase, the queue
+// keeps the fill level between AUDIO_QUEUE_LOW and AUDIO_QUEUE_HIGH frames by adjusting the number
+// of samples the mixer produces for the next frame
+#define AUDIO_QUEUE_SAMPLES PINMAME_ACCUMULATOR_SAMPLES // must be a power of 2
+#define AUDIO_QUEUE_LOW     2
+#define AUDIO_QUEUE_HIGH    4
+
+static int _audioQueueEnabled = 0;
+static int _audioQueueSampleSize = 0;
+static uint8_t _audioQueue[AUDIO_QUEUE_SAMPLES * 2 * sizeof(float)];
+static std::atomic<uint32_t> _audioQueueRead(0);
+static std::atomic<uint32_t> _audioQueueWrite(0);
+static std::atomic<int> _audioQueueUnderruns(0);
+static std::atomic<int> _audioQueueOverruns(0);
+
+// The last AUDIO_XRUN_LOG queue underruns and overruns, with the emulated time of the last queued frame
+// (PinmameGetAudioXruns); underruns are detected on the host audio thread, overruns on the emulation thread
+#define AUDIO_XRUN_LOG 64
+
+static std::mutex _audioXrunMutex;
+static PinmameAudioXrun _audioXruns[AUDIO_XRUN_LOG];
+static uint32_t _audioXrunCount = 0;
+static std::atomic<double> _audioQueueTime(0.);
+static int _audioUnderrunsProfiled = 0;
+static int _audioUnderrunLabel = PROFILER_SOUND;
+static int _audioOverrunLabel = PROFILER_SOUND;
+
+// Sound stream counters (PinmameGetAudioStreamStats), snapshot with the timer ones
+static std::vector<PinmameAudioStreamStats> _audioStreamStats; // guarded by _timerStatsMutex
+static std::atomic<int> _audioProfiling(0);
+
 static int _nvramInit = 0;
 static uint8_t _nvram[CORE_MAXNVRAM];
 static PinmameNVRAMState _nvramState[CORE_MAXNVRAM];
 
+// NVRAM autosave: the emulation thread captures the NVRAM image every interval (emulated time) and
+// hands it to a writer thread when it changed; the final save on exit stays in run_game.
+static std::atomic<double> _nvramAutosaveInterval(0.);
+static double _nvramAutosaveTime = 0.;
+static std::vector<uint8_t> _nvramAutosaved;
+static std::vector<uint8_t> _nvramPending;
+static std::mutex _nvramWriteMutex;
+static std::condition_variable _nvramWriteCond;
+static std::thread* _p_nvramThread = nullptr;
+static int _nvramWritePending = 0;
+static int _nvramWriterQuit = 0;
+static int _nvramWriteFailed = 0;
+
+// Each display owns a triple buffer: the emulation thread fills 'back' and swaps it with the shared
+// 'middle' slot, the host swaps 'front' with 'middle' in PinmameGetDisplayFrame. Published frames
+// are never written again until they went back through the middle slot to the emulation thread.
+#define DISPLAY_FRAME_BUFFERS 3
+#define DISPLAY_FRAME_DIRTY   0x10
+
 typedef struct {
 	PinmameDisplayLayout layout;
-	void* pData;
 	int size;
+	void* pFrameData[DISPLAY_FRAME_BUFFERS];
+	uint32_t frameSequence[DISPLAY_FRAME_BUFFERS];
+	double frameTimestamp[DISPLAY_FRAME_BUFFERS];
+	uint64_t frameHash[DISPLAY_FRAME_BUFFERS];
+	std::atomic<uint64_t> dirtyRows; // Rows changed since the host last got a frame
+	uint32_t sequence;
+	int backFrame;                // Emulation thread
+	int lastFrame;                // Emulation thread, last published frame (front or middle)
+	std::atomic<int> middleFrame; // Shared, DISPLAY_FRAME_DIRTY when it holds a frame not yet seen by the host
+	int frontFrame;               // Host thread
+	int pendingUpdate;            // Changed since the last cb_OnDisplayUpdated with data (for frame decimation)
+	std::vector<uint8_t> source;  // Video: bitmap pixels of the last converted frame
+	std::vector<uint32_t> penLut; // Video: pen to output pixel of the last converted frame
 } PinmameDisplay;
 
 static std::vector<PinmameDisplay*> _displays;
+static std::mutex _displaysMutex;
+static std::vector<std::pair<int, void*>> _spareFrameBuffers; // Frame buffers kept from the previous game of a warm switch
+
+// Video display frames format, applied when a game starts, and game palette as of the last converted
+// frame for PINMAME_VIDEO_FORMAT_INDEXED16 (RGBA8888 colors)
+static PINMAME_VIDEO_FORMAT _videoFormat = PINMAME_VIDEO_FORMAT_RGB888;
+static PINMAME_VIDEO_FORMAT _videoFormatRunning = PINMAME_VIDEO_FORMAT_RGB888;
+static std::vector<uint32_t> _videoPalette;
+static std::mutex _videoPaletteMutex;
+
+// PINMAME_DMD_MODE_COLOR changes the DMD frame size, so it can only be selected or left while no game is running
+static int _dmdColorRunning = 0;
+
+// Save state requests are run by the emulation thread between timeslices (libpinmame_update_state),
+// the calling thread waits for the result.
+typedef enum {
+	STATE_REQUEST_NONE = 0,
+	STATE_REQUEST_SAVE,
+	STATE_REQUEST_LOAD,
+	STATE_REQUEST_REWIND
+} STATE_REQUEST;
+
+static std::mutex _stateMutex;
+static std::condition_variable _stateDone;
+static std::atomic<int> _stateRequest(STATE_REQUEST_NONE);
+static void* _p_stateBuffer = nullptr;
+static size_t _stateSize = 0;
+static double _stateRewindTime = 0.;
+static PINMAME_STATUS _stateStatus = PINMAME_STATUS_OK;
+
+// Rewind ring, emulation thread only: the newest snapshot in full, and for each older checkpoint
+// the delta that turns the next newer snapshot back into it. The oldest deltas are dropped to stay
+// within the budget.
+typedef struct {
+	double time;
+	std::vector<uint8_t> delta;
+} PinmameRewindEntry;
+
+static std::atomic<size_t> _rewindBudget(0);
+static std::atomic<double> _rewindInterval(0.);
+static std::vector<uint8_t> _rewindHead;
+static std::vector<uint8_t> _rewindScratch;
+static std::vector<uint8_t> _rewindDelta;
+static double _rewindHeadTime = 0.;
+static double _rewindTimeOffset = 0.; // timer_get_time() minus rewind timeline, grows on each rewind
+static size_t _rewindUsed = 0;
+static std::deque<PinmameRewindEntry> _rewindEntries;
+
+// Warm start: a state saved bootTime emulated seconds after a cold boot, restored on the next
+// launch when the ROM set, the NVRAM loaded at startup and the DIP settings are the same.
+#define WARMSTART_MAGIC   "PMWARM01"
+#define WARMSTART_HEADER  (8 + 4 * 4 + 6)
+
+static std::atomic<double> _warmStartBootTime(0.);
+static int _warmStartChecked = 0;
+static int _warmStartPending = 0;
+static uint8_t _warmStartKey[WARMSTART_HEADER];
+
+// Input recorder/replayer (PinmameSetRecording/PinmameSetReplay). While active, every input is applied
+// by the emulation thread on the 1 ms switch poll ticks of the core (libpinmame_replay_poll), so that its
+// emulated time is exact, and logged or replayed together with checkpoints: hashes of the machine state,
+// of all display frames and of all audio output.
+#define REPLAY_MAGIC "PMREPLAY1"
+
+typedef struct {
+	char type;     // 'S' switch, 'D' DIP bank, 'F' time fence (logged only)
+	int no;
+	int value;
+	double fvalue;
+} PinmameReplayInput;
+
+static std::mutex _replayMutex;
+static std::string _replayPath;
+static double _replayInterval = 1.;
+static PINMAME_REPLAY_MODE _replayRequested = PINMAME_REPLAY_MODE_NONE;
+static std::atomic<int> _replayMode(PINMAME_REPLAY_MODE_NONE);
+static std::deque<PinmameReplayInput> _replayInputs; // host inputs while recording, guarded by _replayMutex
+static PinmameReplayStatus _replayStatus;            // guarded by _replayMutex
+
+// emulation thread only
+static FILE* _p_replayFile = nullptr;
+static int _replayStarted = 0;
+static double _replayNextCheckpoint = 0.;
+static uLong _replayDisplayCrc = 0;
+static uLong _replayAudioCrc = 0;
+static std::vector<uint8_t> _replayState;
+static std::deque<PinmameSwitchEvent> _replayPendingEvents;
+static char _replayLine[256];
+static int _replayHasLine = 0;
+
+// Differential CPU traces (PinmameSetCpuTrace): one line per executed timeslice of the traced CPUs, with the
+// registers and the disassembly at the PC, for comparing two builds of a CPU core on the same input replay
+#define CPU_TRACE_MAGIC "PMCPUTRACE1"
+
+static std::mutex _cpuTraceMutex;
+static std::string _cpuTracePath;
+static uint32_t _cpuTraceRequestedMask = 0;
+static double _cpuTraceStateInterval = 0.;
+extern "C" { int libpinmame_cpu_trace_mask = 0; } // emulation thread only, read by cpu_timeslice
+static FILE* _p_cpuTraceFile = nullptr;
+static double _cpuTraceNextState = 0.;
+
+// Golden output checksums (PinmameSetGoldenOutput): CRCs of the main DMD luminance and bitplane frames every
+// framesPerCrc frames and of the mixed audio per emulated second, written to or verified against a reference file
+#define GOLDEN_MAGIC "PMGOLDEN1"
+
+static std::mutex _goldenMutex;
+static std::string _goldenPath;
+static PINMAME_GOLDEN_MODE _goldenRequested = PINMAME_GOLDEN_MODE_NONE;
+static int _goldenFramesPerCrc = 10;
+static PinmameGoldenStatus _goldenStatus;
+// emulation thread only
+static FILE* _p_goldenFile = nullptr;
+static PINMAME_GOLDEN_MODE _goldenMode = PINMAME_GOLDEN_MODE_NONE;
+static int _goldenInterval = 10;
+static uint32_t _goldenFrame = 0;
+static int _goldenSecond = 0;
+static uLong _goldenLuminanceCrc = 0;
+static uLong _goldenBitplaneCrc = 0;
+static uLong _goldenAudioCrc = 0;
+
+// Guest PC sampling (PinmameSetPcSampling), the report is appended when each game stops
+static std::mutex _pcSamplingMutex;
+static std::string _pcSamplingReport;
+static int _pcSamplingTop = 0;
+static std::atomic<double> _pcSamplingInterval(0.);
+static double _pcSamplingApplied = 0.; // emulation thread only
+static std::atomic<int> _autoInterleave(0);
+static int _autoInterleaveApplied = 0; // emulation thread only
+static std::atomic<uint32_t> _interleaveSlices(0);
+static std::atomic<double> _interleaveAverage(0.);
+
+// Profiler export (PinmameSetProfiler), handed to the emulation thread and applied again on each game start
+static std::mutex _profilerMutex;
+static std::string _profilerTraceFile;
+static std::string _profilerCsvFile;
+static double _profilerCsvInterval = 1.;
+static std::atomic<int> _profilerPending(0);
+
+// SAM node bus bridge (PinmameSetNodeBus): the mode and callback are read when a SAM game starts. Messages
+// are staged by the emulation thread and delivered in one callback per emulated millisecond, the responses
+// queued by the host are fed to the CPU board serial port on the same ticks
+#define NODEBUS_STAGE_SIZE 65536 // staged bytes that force an early delivery
+
+static std::atomic<int> _nodeBusMode(PINMAME_NODEBUS_MODE_OFF);
+static std::atomic<PinmameOnNodeBusMessagesCallback> _nodeBusCallback(nullptr);
+static std::mutex _nodeBusResponseMutex;
+static std::deque<uint8_t> _nodeBusResponses;
+static std::vector<PinmameNodeBusMessage> _nodeBusMessages; // emulation thread only, p_data holds offsets in _nodeBusData
+static std::vector<uint8_t> _nodeBusData;
+
+// RAM watch (PinmameWatchMemory): the watches are requested from any thread and applied by the emulation
+// thread, which taps the CPU writes to their range (memory_set_write_watch). The bytes written are compared
+// with their last delivered value at the end of each time slice, so the host gets one event per changed byte
+// however often it was written in between, and unchanged rewrites cost no callback
+struct MemoryWatch {
+	int id;
+	int cpu;
+	uint32_t start;
+	int length;
+	PinmameOnMemoryChangedCallback callback;
+	std::vector<uint8_t> value;     // last delivered values
+	std::vector<double> writeTime;  // emulated time of the last write of each byte, < 0 if not written since
+	std::vector<uint32_t> written;  // offsets written since the last delivery
+};
+
+static std::mutex _memoryWatchMutex;
+static std::vector<MemoryWatch> _memoryWatchRequests; // the watches wanted by the host, without their state
+static int _memoryWatchNextId = 0;
+static std::atomic<int> _memoryWatchPending(0);
+static std::vector<MemoryWatch> _memoryWatches; // emulation thread only
+static std::vector<PinmameMemoryChange> _memoryChanges; // emulation thread only
+
+// Output push (PinmameSetOutputPush): the emulation thread wakes the notifier thread every interval of
+// emulated time, or at the end of the switch update that changed a solenoid of the immediate mask. The
+// notifier reads the output change journal from its own cursor and delivers all the changes since the
+// last call at once, so the host callback never runs on (nor blocks) the emulation thread
+static std::atomic<double> _outputPushInterval(0.);
+static std::atomic<uint64_t> _outputPushImmediate(0);
+static std::atomic<PinmameOnOutputsUpdatedCallback> _outputPushCallback(nullptr); // applied on game start
+static PinmameOnOutputsUpdatedCallback _outputPushRunning = nullptr;
+static double _outputPushTime = 0.; // emulation thread only
+static int _outputPushUrgent = 0;   // emulation thread only
+static std::mutex _outputPushMutex;
+static std::condition_variable _outputPushCond;
+static std::thread* _p_outputPushThread = nullptr;
+static int _outputPushPending = 0;
+static int _outputPushQuit = 0;
+static PinmameChangeJournalCursor _outputPushCursor;
 
 static const PinmameKeyboardInfo _keyboardInfo[] = {
 	{ "A", PINMAME_KEYCODE_A, KEYCODE_A },
@@ -187,18 +518,15 @@ char* ComposePath(const char* const path, const char* const file)
 
 int GetGameNumFromString(const char* const name)
 {
-	int gameNum = 0;
-
-	while (drivers[gameNum]) {
-		if (!strcasecmp(drivers[gameNum]->name, name))
-			break;
-		gameNum++;
+	if (_p_Config) {
+		char* const p_aliasFilename = ComposePath(_p_Config->vpmPath, "VPMAlias.txt");
+		const char* const p_real = gamealias_find(p_aliasFilename, name);
+		free(p_aliasFilename);
+		if (p_real)
+			return driver_get_index(p_real);
 	}
 
-	if (!drivers[gameNum])
-		return -1;
-
-	return gameNum;
+	return driver_get_index(name);
 }
 
 /******************************************************
@@ -245,55 +573,123 @@ int GetDisplayCount()
  * UpdatePinmameDisplayBitmap
  ******************************************************/
 
+static inline uint32_t VideoPixel(const UINT8 r, const UINT8 g, const UINT8 b, const int bgra)
+{
+	const uint8_t px[4] = { bgra ? b : r, g, bgra ? r : b, 255 };
+	uint32_t v;
+	memcpy(&v, px, sizeof(v));
+	return v;
+}
+
+template <typename T>
+static void ConvertPinmameDisplayBitmap(PinmameDisplay* pDisplay, UINT8* __restrict dst)
+{
+	const T* __restrict src = (const T*)pDisplay->source.data();
+	const int count = pDisplay->layout.width * pDisplay->layout.height;
+	const uint32_t* const lut = pDisplay->penLut.data();
+	const unsigned int lutSize = (unsigned int)pDisplay->penLut.size();
+	const int bgra = (_videoFormatRunning == PINMAME_VIDEO_FORMAT_BGRA8888);
+
+	for (int i = 0; i < count; i++) {
+		const unsigned int pen = src[i];
+		uint32_t v;
+		if (pen < lutSize)
+			v = lut[pen];
+		else { // pens outside of the game palette (UI, direct color bitmaps)
+			UINT8 r,g,b;
+			palette_get_color(pen,&r,&g,&b);
+			v = VideoPixel(r, g, b, bgra);
+		}
+		switch (_videoFormatRunning) {
+			case PINMAME_VIDEO_FORMAT_RGBA8888:
+			case PINMAME_VIDEO_FORMAT_BGRA8888:
+				memcpy(dst, &v, 4);
+				dst += 4;
+				break;
+			case PINMAME_VIDEO_FORMAT_INDEXED16:
+				*((uint16_t*)dst) = (uint16_t)pen;
+				dst += 2;
+				break;
+			default:
+				memcpy(dst, &v, 3);
+				dst += 3;
+				break;
+		}
+	}
+}
+
 int UpdatePinmameDisplayBitmap(PinmameDisplay* pDisplay, const struct mame_bitmap* p_bitmap)
 {
-	UINT8* __restrict dst = (UINT8*)pDisplay->pData;
+	const int srcBytes = (p_bitmap->depth == 8) ? 1 : (p_bitmap->depth == 15 || p_bitmap->depth == 16) ? 2 : 4;
+	const int rowBytes = pDisplay->layout.width * srcBytes;
 	int diff = 0;
 
-	if (p_bitmap->depth == 8) {
-		for(int j = 0; j < pDisplay->layout.height; j++) {
-			const UINT8* __restrict src = (UINT8*)p_bitmap->line[j];
-			for(int i=0; i < pDisplay->layout.width; i++) {
-				UINT8 r,g,b;
-				palette_get_color((*src++),&r,&g,&b);
-				if (dst[0] != r || dst[1] != g || dst[2] != b)
-					diff = 1;
-				*(dst++) = r;
-				*(dst++) = g;
-				*(dst++) = b;
-			}
+	// Pen lookup of the game palette, updated every frame so that palette changes are caught even if no pixel changed
+	if (srcBytes != 4) {
+		const int colors = Machine->drv->total_colors;
+		const int bgra = (_videoFormatRunning == PINMAME_VIDEO_FORMAT_BGRA8888);
+		int paletteChanged = 0;
+		if ((int)pDisplay->penLut.size() != colors) {
+			pDisplay->penLut.assign(colors, 0);
+			paletteChanged = 1;
 		}
-	}
-	else if(p_bitmap->depth == 15 || p_bitmap->depth == 16) {
-		for(int j = 0; j < pDisplay->layout.height; j++) {
-			const UINT16* __restrict src = (UINT16*)p_bitmap->line[j];
-			for(int i=0; i < pDisplay->layout.width; i++) {
-				UINT8 r,g,b;
-				palette_get_color((*src++),&r,&g,&b);
-				if (dst[0] != r || dst[1] != g || dst[2] != b)
-					diff = 1;
-				*(dst++) = r;
-				*(dst++) = g;
-				*(dst++) = b;
+		for (int pen = 0; pen < colors; pen++) {
+			UINT8 r,g,b;
+			palette_get_color(pen,&r,&g,&b);
+			const uint32_t v = VideoPixel(r, g, b, bgra);
+			if (pDisplay->penLut[pen] != v) {
+				pDisplay->penLut[pen] = v;
+				paletteChanged = 1;
 			}
 		}
+		if (paletteChanged && _videoFormatRunning == PINMAME_VIDEO_FORMAT_INDEXED16) {
+			std::lock_guard<std::mutex> lock(_videoPaletteMutex);
+			_videoPalette = pDisplay->penLut;
+		}
+		diff = paletteChanged;
 	}
-	else {
-		for(int j = 0; j < pDisplay->layout.height; j++) {
-			const UINT32* __restrict src = (UINT32*)p_bitmap->line[j];
-			for(int i=0; i < pDisplay->layout.width; i++) {
-				UINT8 r,g,b;
-				palette_get_color((*src++),&r,&g,&b);
-				if (dst[0] != r || dst[1] != g || dst[2] != b)
-					diff = 1;
-				*(dst++) = r;
-				*(dst++) = g;
-				*(dst++) = b;
-			}
+
+	// Compare the bitmap pixels, which are much smaller than the converted ones, and only convert a frame that changed
+	if (pDisplay->source.size() != (size_t)rowBytes * pDisplay->layout.height) {
+		pDisplay->source.assign((size_t)rowBytes * pDisplay->layout.height, 0);
+		diff = 1;
+	}
+	for (int j = 0; j < pDisplay->layout.height; j++) {
+		UINT8* const row = pDisplay->source.data() + (size_t)j * rowBytes;
+		if (memcmp(row, p_bitmap->line[j], rowBytes)) {
+			memcpy(row, p_bitmap->line[j], rowBytes);
+			diff = 1;
 		}
 	}
 
-	return diff;
+	if (!diff)
+		return 0;
+
+	UINT8* const dst = (UINT8*)pDisplay->pFrameData[pDisplay->backFrame];
+	if (srcBytes == 1)
+		ConvertPinmameDisplayBitmap<UINT8>(pDisplay, dst);
+	else if (srcBytes == 2)
+		ConvertPinmameDisplayBitmap<UINT16>(pDisplay, dst);
+	else
+		ConvertPinmameDisplayBitmap<UINT32>(pDisplay, dst);
+
+	return 1;
+}
+
+/******************************************************
+ * PublishPinmameDisplayFrame
+ ******************************************************/
+
+void PublishPinmameDisplayFrame(PinmameDisplay* pDisplay, const uint64_t hash, const uint64_t dirtyRows)
+{
+	const int frame = pDisplay->backFrame;
+
+	pDisplay->frameSequence[frame] = ++pDisplay->sequence;
+	pDisplay->frameTimestamp[frame] = timer_get_time();
+	pDisplay->frameHash[frame] = hash;
+	pDisplay->dirtyRows.fetch_or(dirtyRows, std::memory_order_relaxed);
+	pDisplay->lastFrame = frame;
+	pDisplay->backFrame = pDisplay->middleFrame.exchange(frame | DISPLAY_FRAME_DIRTY, std::memory_order_acq_rel) & ~DISPLAY_FRAME_DIRTY;
 }
 
 /******************************************************
@@ -344,24 +740,133 @@ extern "C" int osd_start_audio_stream(const int stereo)
 	if (!_p_Config->cb_OnAudioAvailable)
 		return 0;
 
-	memset(&_audioInfo, 0, sizeof(PinmameAudioInfo));
-	_audioInfo.format = _p_Config->audioFormat;
-	_audioInfo.channels = stereo ? 2 : 1;
-	_audioInfo.sampleRate = Machine->sample_rate;
-	_audioInfo.framesPerSecond = Machine->drv->frames_per_second;
-	_audioInfo.samplesPerFrame = (int)(Machine->sample_rate / Machine->drv->frames_per_second);
-	_audioInfo.bufferSize = PINMAME_ACCUMULATOR_SAMPLES * 2;
+	PinmameAudioInfo audioInfo;
+	memset(&audioInfo, 0, sizeof(PinmameAudioInfo));
+	audioInfo.format = _p_Config->audioFormat;
+	audioInfo.channels = (stereo || _audioChannels == 2) ? 2 : 1; // the mixer already mixed down to mono if requested
+	audioInfo.sampleRate = Machine->sample_rate;
+	audioInfo.framesPerSecond = Machine->drv->frames_per_second;
+	audioInfo.samplesPerFrame = (int)(Machine->sample_rate / Machine->drv->frames_per_second);
+	audioInfo.bufferSize = PINMAME_ACCUMULATOR_SAMPLES * 2;
+
+	// on a warm switch, the host keeps its stream if the format did not change
+	const int keepStream = _warmSwitch && _audioStreamResult >= 0 && !memcmp(&audioInfo, &_audioInfo, sizeof(PinmameAudioInfo));
+	_audioInfo = audioInfo;
+	_audioUpmix = !stereo && audioInfo.channels == 2;
+
+	_audioQueueEnabled = !_p_Config->cb_OnAudioUpdated;
+	_audioQueueSampleSize = _audioInfo.channels * (_audioInfo.format == PINMAME_AUDIO_FORMAT_FLOAT ? sizeof(float) : sizeof(INT16));
+	_audioQueueRead = 0;
+	_audioQueueWrite = 0;
+	_audioQueueUnderruns = 0;
+	_audioQueueOverruns = 0;
+	_audioQueueTime = 0.;
+	_audioUnderrunsProfiled = 0;
+	_audioUnderrunLabel = profiler_label("Audio underrun", PROFILER_SOUND);
+	_audioOverrunLabel = profiler_label("Audio overrun", PROFILER_SOUND);
+	{
+		std::lock_guard<std::mutex> lock(_audioXrunMutex);
+		_audioXrunCount = 0;
+	}
+
+	mixer_set_float_output(_p_Config->audioFormat == PINMAME_AUDIO_FORMAT_FLOAT);
+
+	if (!keepStream)
+		_audioStreamResult = (*(_p_Config->cb_OnAudioAvailable))(&_audioInfo, _p_userData);
+
+	return _audioStreamResult;
+}
+
+/******************************************************
+ * LogAudioXrun
+ ******************************************************/
+
+static void LogAudioXrun(const PINMAME_AUDIO_XRUN type, const int samples, const double time)
+{
+	std::lock_guard<std::mutex> lock(_audioXrunMutex);
+
+	PinmameAudioXrun& xrun = _audioXruns[_audioXrunCount++ % AUDIO_XRUN_LOG];
+	xrun.type = type;
+	xrun.samples = samples;
+	xrun.time = time;
+}
+
+/******************************************************
+ * osd_queue_audio
+ ******************************************************/
+
+static int osd_queue_audio(const void* p_buffer, const int samples)
+{
+	const uint32_t read = _audioQueueRead.load(std::memory_order_acquire);
+	uint32_t write = _audioQueueWrite.load(std::memory_order_relaxed);
+	const double now = timer_get_time();
+
+	_audioQueueTime.store(now, std::memory_order_relaxed);
+
+	const int underruns = _audioQueueUnderruns;
+	if (underruns != _audioUnderrunsProfiled) {
+		profiler_event(_audioUnderrunLabel, underruns - _audioUnderrunsProfiled);
+		_audioUnderrunsProfiled = underruns;
+	}
+
+	int count = AUDIO_QUEUE_SAMPLES - (int)(write - read);
+	if (count < samples) {
+		_audioQueueOverruns++;
+		LogAudioXrun(PINMAME_AUDIO_XRUN_OVERRUN, samples - count, now);
+		profiler_event(_audioOverrunLabel, samples - count);
+	}
+	else
+		count = samples;
+
+	const uint8_t* p_src = (const uint8_t*)p_buffer;
+	while (count > 0) {
+		const int pos = write & (AUDIO_QUEUE_SAMPLES - 1);
+		const int len = std::min(count, AUDIO_QUEUE_SAMPLES - pos);
+		memcpy(_audioQueue + pos * _audioQueueSampleSize, p_src, len * _audioQueueSampleSize);
+		p_src += len * _audioQueueSampleSize;
+		write += len;
+		count -= len;
+	}
 
-	return (*(_p_Config->cb_OnAudioAvailable))(&_audioInfo, _p_userData);
+	_audioQueueWrite.store(write, std::memory_order_release);
+
+	// drift correction: ask the mixer for slightly more or less samples next frame, depending on the fill level
+	const int fill = (int)(write - read);
+	if (fill < _audioInfo.samplesPerFrame * AUDIO_QUEUE_LOW)
+		return _audioInfo.samplesPerFrame + 1;
+	if (fill > _audioInfo.samplesPerFrame * AUDIO_QUEUE_HIGH)
+		return _audioInfo.samplesPerFrame - 1;
+	return _audioInfo.samplesPerFrame;
 }
 
 /******************************************************
  * osd_update_audio_stream
  ******************************************************/
 
-extern "C" int osd_update_audio_stream(INT16* p_buffer)
+static void GoldenAudio(const void* p_buffer, const size_t sampleSize);
+
+static int ReplayAudio(const void* p_buffer, const size_t sampleSize, const int samples)
+{
+	if (_replayMode.load(std::memory_order_relaxed) == PINMAME_REPLAY_MODE_NONE)
+		return samples;
+
+	// recorded and replayed runs must mix exactly the same chunks, whatever the host or the speed mode
+	_replayAudioCrc = crc32(_replayAudioCrc, (const Bytef*)p_buffer, (uInt)(mixer_samples_this_frame() * _audioInfo.channels * sampleSize));
+	return _audioInfo.samplesPerFrame;
+}
+
+static int UpdateAudioStream(INT16* p_buffer)
 {
-	if(!_p_Config->cb_OnAudioUpdated || g_fSoundMode != PINMAME_SOUND_MODE_DEFAULT)
+	if (_audioQueueEnabled && g_fSoundMode == PINMAME_SOUND_MODE_DEFAULT && _speedMode != PINMAME_SPEED_MODE_UNTHROTTLED) {
+		if (_p_Config->audioFormat == PINMAME_AUDIO_FORMAT_INT16)
+			return osd_queue_audio(p_buffer, mixer_samples_this_frame());
+
+		src_short_to_float_array(p_buffer, _audioData, mixer_samples_this_frame() * _audioInfo.channels);
+
+		return osd_queue_audio(_audioData, mixer_samples_this_frame());
+	}
+
+	if(!_p_Config->cb_OnAudioUpdated || g_fSoundMode != PINMAME_SOUND_MODE_DEFAULT || _speedMode == PINMAME_SPEED_MODE_UNTHROTTLED)
 		return 0;
 
 	const int samplesThisFrame = mixer_samples_this_frame();
@@ -374,6 +879,46 @@ extern "C" int osd_update_audio_stream(INT16* p_buffer)
 	return (*(_p_Config->cb_OnAudioUpdated))((void*)_audioData, samplesThisFrame, _p_userData);
 }
 
+// Duplicates the mono mix for a host that asked for a stereo stream
+template <typename T> static T* UpmixMono(const T* const p_src, T* const p_dst)
+{
+	const int samples = mixer_samples_this_frame();
+	for (int i = 0; i < samples; i++)
+		p_dst[i * 2] = p_dst[i * 2 + 1] = p_src[i];
+	return p_dst;
+}
+
+extern "C" int osd_update_audio_stream(INT16* p_buffer)
+{
+	if (_audioUpmix)
+		p_buffer = UpmixMono(p_buffer, _audioUpmix16);
+	GoldenAudio(p_buffer, sizeof(INT16));
+	return ReplayAudio(p_buffer, sizeof(INT16), UpdateAudioStream(p_buffer));
+}
+
+/******************************************************
+ * osd_update_audio_stream_float
+ ******************************************************/
+
+static int UpdateAudioStreamFloat(float* p_buffer)
+{
+	if (_audioQueueEnabled && g_fSoundMode == PINMAME_SOUND_MODE_DEFAULT && _speedMode != PINMAME_SPEED_MODE_UNTHROTTLED)
+		return osd_queue_audio(p_buffer, mixer_samples_this_frame());
+
+	if(!_p_Config->cb_OnAudioUpdated || g_fSoundMode != PINMAME_SOUND_MODE_DEFAULT || _speedMode == PINMAME_SPEED_MODE_UNTHROTTLED)
+		return 0;
+
+	return (*(_p_Config->cb_OnAudioUpdated))((void*)p_buffer, mixer_samples_this_frame(), _p_userData);
+}
+
+extern "C" int osd_update_audio_stream_float(float* p_buffer)
+{
+	if (_audioUpmix)
+		p_buffer = UpmixMono(p_buffer, _audioUpmixFloat);
+	GoldenAudio(p_buffer, sizeof(float));
+	return ReplayAudio(p_buffer, sizeof(float), UpdateAudioStreamFloat(p_buffer));
+}
+
 /******************************************************
  * osd_stop_audio_stream
  ******************************************************/
@@ -424,983 +969,3963 @@ extern "C" int libpinmame_time_to_quit(void)
 	return _timeToQuit;
 }
 
+extern "C" void libpinmame_log_info(const char* format, ...);
+extern "C" void libpinmame_log_error(const char* format, ...);
+
 /******************************************************
- * libpinmame_update_display
+ * CaptureNVRAM
  ******************************************************/
 
-extern "C" void libpinmame_update_display(const int index, const struct core_dispLayout* p_layout, void* p_data)
+static int CaptureNVRAM(std::vector<uint8_t>& image)
 {
-	PinmameDisplay* pDisplay = nullptr;
+	if (!(Machine && Machine->drv && Machine->drv->nvram_handler))
+		return -1;
 
-	if (_displays.size() < index + 1) {
-		pDisplay = new PinmameDisplay();
-		memset(pDisplay, 0, sizeof(PinmameDisplay));
+	mame_file* nvram_file = (mame_file*)malloc(sizeof(mame_file));
+	memset(nvram_file, 0, sizeof(mame_file));
+	nvram_file->type = RAM_FILE;
+	(*Machine->drv->nvram_handler)(nvram_file, 1);
 
-		pDisplay->layout.type = (PINMAME_DISPLAY_TYPE)p_layout->type;
-		pDisplay->layout.top = p_layout->top;
-		pDisplay->layout.left = p_layout->left;
+	const int size = (int)nvram_file->offset;
+	if (size > 0)
+		image.assign(nvram_file->data, nvram_file->data + size);
 
-		if (p_layout->type == CORE_VIDEO) {
-			pDisplay->layout.width = p_layout->length;
-			pDisplay->layout.height = p_layout->start;
+	mame_fclose(nvram_file);
 
-			pDisplay->layout.depth = 24;
+	return (size > 0) ? size : -1;
+}
 
-			pDisplay->size = pDisplay->layout.width * pDisplay->layout.height * 3;
-		}
-		else if ((p_layout->type & CORE_DMD) == CORE_DMD) {
-			pDisplay->layout.width = p_layout->length;
-			pDisplay->layout.height = p_layout->start;
+/******************************************************
+ * NVRAMWriter
+ ******************************************************/
 
-			if (p_layout->type & CORE_DMDSEG)
-				pDisplay->layout.depth = 2;
-			else {
-				const int shade_16_enabled = (core_gameData->gen & (GEN_SAM|GEN_SPA|GEN_ALVG|GEN_ALVG_DMD2|GEN_GTS3)) != 0;
-				pDisplay->layout.depth = shade_16_enabled ? 4 : 2;
-			}
+static void NVRAMWriter(std::string filename)
+{
+	std::vector<uint8_t> image;
+	std::unique_lock<std::mutex> lock(_nvramWriteMutex);
 
-			pDisplay->size = pDisplay->layout.width * pDisplay->layout.height;
-		}
-		else {
-			pDisplay->layout.length = p_layout->length;
+	for (;;) {
+		_nvramWriteCond.wait(lock, [] { return _nvramWritePending || _nvramWriterQuit; });
+		if (!_nvramWritePending)
+			break;
 
-			pDisplay->size = pDisplay->layout.length * sizeof(UINT16);
-		}
+		image.swap(_nvramPending);
+		_nvramWritePending = 0;
 
-		pDisplay->pData = malloc(pDisplay->size);
-		memset(pDisplay->pData, 0, pDisplay->size);
+		lock.unlock();
+		const int failed = osd_replace_file(FILETYPE_NVRAM, 0, filename.c_str(), image.data(), (UINT32)image.size());
+		lock.lock();
 
-		_displays.push_back(pDisplay);
+		// reported by the emulation thread, which owns the log callback
+		if (failed)
+			_nvramWriteFailed = 1;
+	}
+}
 
-		if (!_p_Config->cb_OnDisplayAvailable)
-			return;
+/******************************************************
+ * NVRAMAutosave
+ ******************************************************/
 
-		const int displayCount = GetDisplayCount();
-		(*(_p_Config->cb_OnDisplayAvailable))(index, displayCount, &pDisplay->layout, _p_userData);
+static void NVRAMAutosave()
+{
+	const double interval = _nvramAutosaveInterval.load(std::memory_order_relaxed);
+	if (interval <= 0.)
+		return;
+
+	const double now = timer_get_time();
+	if (_nvramAutosaveTime == 0.) {
+		// baseline, the image loaded at startup is already on disk
+		_nvramAutosaveTime = now;
+		CaptureNVRAM(_nvramAutosaved);
+		return;
 	}
-	else {
-		if (!_p_Config->cb_OnDisplayUpdated)
-			return;
+	if (now - _nvramAutosaveTime < interval && now >= _nvramAutosaveTime)
+		return;
+	_nvramAutosaveTime = now;
 
-		pDisplay = _displays[index];
+	std::vector<uint8_t> image;
+	if (CaptureNVRAM(image) < 0 || image == _nvramAutosaved)
+		return;
 
-		if (p_data == nullptr) {
-			(*(_p_Config->cb_OnDisplayUpdated))(index, nullptr, &pDisplay->layout, _p_userData);
-			return;
-		}
+	_nvramAutosaved = image;
 
-		if (pDisplay->layout.type == CORE_VIDEO) {
-			if (UpdatePinmameDisplayBitmap(pDisplay, (mame_bitmap*)p_data))
-				(*(_p_Config->cb_OnDisplayUpdated))(index, pDisplay->pData, &pDisplay->layout, _p_userData);
-			else
-				(*(_p_Config->cb_OnDisplayUpdated))(index, nullptr, &pDisplay->layout, _p_userData);
-		}
-		else {
-			if (memcmp(pDisplay->pData, p_data, pDisplay->size)) {
-				memcpy(pDisplay->pData, p_data, pDisplay->size);
-				(*(_p_Config->cb_OnDisplayUpdated))(index, pDisplay->pData, &pDisplay->layout, _p_userData);
-			}
-			else
-				(*(_p_Config->cb_OnDisplayUpdated))(index, nullptr, &pDisplay->layout, _p_userData);
-		}
+	std::lock_guard<std::mutex> lock(_nvramWriteMutex);
+	if (_nvramWriteFailed) {
+		libpinmame_log_error("NVRAM autosave of %s failed", Machine->gamedrv->name);
+		_nvramWriteFailed = 0;
 	}
+	if (!_p_nvramThread) {
+		_nvramWriterQuit = 0;
+		_p_nvramThread = new std::thread(NVRAMWriter, std::string(Machine->gamedrv->name) + ".nv");
+	}
+	_nvramPending.swap(image);
+	_nvramWritePending = 1;
+	_nvramWriteCond.notify_one();
 }
 
 /******************************************************
- * libpinmame_snd_cmd_log
+ * OutputPushNotifier
  ******************************************************/
 
-extern "C" void libpinmame_snd_cmd_log(int boardNo, int cmd)
+static void OutputPushNotifier(PinmameOnOutputsUpdatedCallback callback)
 {
-	if (!_p_Config->cb_OnSoundCommand)
+	std::vector<PinmameOutputChange> changes(VP_JOURNAL_SIZE);
+	std::unique_lock<std::mutex> lock(_outputPushMutex);
+
+	for (;;) {
+		_outputPushCond.wait(lock, [] { return _outputPushPending || _outputPushQuit; });
+		const int quit = _outputPushQuit;
+		_outputPushPending = 0;
+
+		// the journal never holds more than VP_JOURNAL_SIZE changes, one read gets them all
+		lock.unlock();
+		const int count = PinmameReadChangeJournal(&_outputPushCursor, changes.data(), VP_JOURNAL_SIZE);
+		if (count > 0)
+			(*callback)(changes.data(), count, _p_userData);
+		lock.lock();
+
+		if (quit)
+			break;
+	}
+}
+
+/******************************************************
+ * OutputPushStart
+ ******************************************************/
+
+static void OutputPushStart()
+{
+	_outputPushRunning = _outputPushCallback;
+	if (!_outputPushRunning)
 		return;
 
-	(*(_p_Config->cb_OnSoundCommand))(boardNo, cmd, _p_userData);
+	_outputPushTime = 0.;
+	_outputPushUrgent = 0;
+	_outputPushPending = 0;
+	_outputPushQuit = 0;
+	PinmameOpenChangeJournal(&_outputPushCursor);
+	_p_outputPushThread = new std::thread(OutputPushNotifier, _outputPushRunning);
 }
 
 /******************************************************
- * libpinmame_forward_console_data
+ * OutputPushStop
+ *
+ * Delivers the changes still pending and stops the notifier thread.
  ******************************************************/
 
-extern "C" void libpinmame_forward_console_data(void* p_data, int size)
+static void OutputPushStop()
 {
-	if (!_p_Config->cb_OnConsoleDataUpdated)
+	if (!_p_outputPushThread)
 		return;
 
-	(*(_p_Config->cb_OnConsoleDataUpdated))(p_data, size, _p_userData);
+	{
+		std::lock_guard<std::mutex> lock(_outputPushMutex);
+		_outputPushQuit = 1;
+		_outputPushCond.notify_one();
+	}
+	_p_outputPushThread->join();
+	delete _p_outputPushThread;
+	_p_outputPushThread = nullptr;
+
+	PinmameCloseChangeJournal(&_outputPushCursor);
+	_outputPushRunning = nullptr;
 }
 
 /******************************************************
- * OnStateChange
+ * libpinmame_output_push
+ *
+ * Called by the core after the output change journal was updated.
  ******************************************************/
 
-extern "C" void OnStateChange(const int state)
+extern "C" void libpinmame_output_push(void)
 {
-	_isRunning = state;
+	if (!_outputPushRunning)
+		return;
 
-	if (!_p_Config->cb_OnStateUpdated)
+	const double now = timer_get_time();
+	if (!_outputPushUrgent && now - _outputPushTime < _outputPushInterval.load(std::memory_order_relaxed) && now >= _outputPushTime)
 		return;
+	_outputPushTime = now;
+	_outputPushUrgent = 0;
 
-	(*(_p_Config->cb_OnStateUpdated))(state, _p_userData);
+	std::lock_guard<std::mutex> lock(_outputPushMutex);
+	_outputPushPending = 1;
+	_outputPushCond.notify_one();
 }
 
 /******************************************************
- * OnSolenoid
+ * libpinmame_stop_nvram_autosave
+ *
+ * Called before the NVRAM is saved on exit: writes what is still pending
+ * and stops the writer thread.
  ******************************************************/
 
-extern "C" void OnSolenoid(const int solenoid, const int state)
+extern "C" void libpinmame_stop_nvram_autosave(void)
 {
-	if (!_p_Config->cb_OnSolenoidUpdated)
-		return;
+	std::thread* p_thread;
+	{
+		std::lock_guard<std::mutex> lock(_nvramWriteMutex);
+		p_thread = _p_nvramThread;
+		_p_nvramThread = nullptr;
+		_nvramWriterQuit = 1;
+		_nvramWriteCond.notify_one();
+	}
 
-	PinmameSolenoidState solenoidState;
-	solenoidState.solNo = solenoid;
-	solenoidState.state = state;
+	if (p_thread) {
+		p_thread->join();
+		delete p_thread;
+	}
 
-	(*(_p_Config->cb_OnSolenoidUpdated))(&solenoidState, _p_userData);
+	_nvramAutosaveTime = 0.;
+	_nvramAutosaved.clear();
 }
 
 /******************************************************
- * libpinmame_log_info
+ * ResetRewind
  ******************************************************/
 
-extern "C" void libpinmame_log_info(const char* format, ...)
+static void ResetRewind()
 {
-	if (!_p_Config->cb_OnLogMessage)
-		return;
-
-	va_list args;
-	va_start(args, format);
-	(*(_p_Config->cb_OnLogMessage))(PINMAME_LOG_LEVEL_INFO, format, args, _p_userData);
-	va_end(args);
+	_rewindEntries.clear();
+	_rewindHead.clear();
+	_rewindHead.shrink_to_fit();
+	_rewindScratch.clear();
+	_rewindScratch.shrink_to_fit();
+	_rewindDelta.clear();
+	_rewindDelta.shrink_to_fit();
+	_rewindUsed = 0;
+	_rewindHeadTime = 0.;
+	_rewindTimeOffset = 0.;
 }
 
 /******************************************************
- * libpinmame_log_error
+ * RewindCheckpoint
  ******************************************************/
 
-extern "C" void libpinmame_log_error(const char* format, ...)
+static void RewindCheckpoint(const double time)
 {
-	if (!_p_Config->cb_OnLogMessage)
+	size_t size = 0;
+	cpu_save_state_mem(nullptr, &size);
+
+	if (_rewindHead.size() != size) {
+		ResetRewind();
+		_rewindHead.resize(size);
+		_rewindScratch.resize(size);
+		_rewindDelta.resize(state_save_delta_max_size(size));
+	}
+	else {
+		// keep the previous snapshot as a delta against the new one
+		cpu_save_state_mem(_rewindScratch.data(), &size);
+
+		const size_t deltaSize = state_save_delta_encode(_rewindScratch.data(), _rewindHead.data(), size, _rewindDelta.data());
+		_rewindEntries.push_back({ _rewindHeadTime, std::vector<uint8_t>(_rewindDelta.begin(), _rewindDelta.begin() + deltaSize) });
+		_rewindUsed += deltaSize;
+		_rewindHead.swap(_rewindScratch);
+		_rewindHeadTime = time;
+
+		while (!_rewindEntries.empty() && size + _rewindUsed > _rewindBudget) {
+			_rewindUsed -= _rewindEntries.front().delta.size();
+			_rewindEntries.pop_front();
+		}
 		return;
+	}
 
-	va_list args;
-	va_start(args, format);
-	(*(_p_Config->cb_OnLogMessage))(PINMAME_LOG_LEVEL_ERROR, format, args, _p_userData);
-	va_end(args);
+	cpu_save_state_mem(_rewindHead.data(), &size);
+	_rewindHeadTime = time;
 }
 
 /******************************************************
- * libpinmame_update_mech
+ * Rewind
  ******************************************************/
 
-extern "C" void libpinmame_update_mech(const int mechNo, mech_tMechData* p_mechData)
+static PINMAME_STATUS Rewind(const double timeInS)
 {
-	int speed = p_mechData->speed / p_mechData->ret;
+	if (_rewindHead.empty())
+		return PINMAME_STATUS_REWIND_NOT_AVAILABLE;
+
+	const double target = timer_get_time() - _rewindTimeOffset - timeInS;
+	const size_t size = _rewindHead.size();
+
+	// walk back from the newest snapshot until the target time (or the oldest checkpoint) is reached
+	while (!_rewindEntries.empty() && _rewindHeadTime > target) {
+		const PinmameRewindEntry& entry = _rewindEntries.back();
+		if (state_save_delta_apply(_rewindHead.data(), size, entry.delta.data(), entry.delta.size())) {
+			ResetRewind();
+			return PINMAME_STATUS_STATE_INVALID;
+		}
+		_rewindHeadTime = entry.time;
+		_rewindUsed -= entry.delta.size();
+		_rewindEntries.pop_back();
+	}
 
-	if (_mechInit[mechNo]) {
-		if (_mechInfo[mechNo].pos != p_mechData->pos || _mechInfo[mechNo].speed != speed) {
-			_mechInfo[mechNo].pos = p_mechData->pos;
-			_mechInfo[mechNo].speed = speed;
+	if (cpu_load_state_mem(_rewindHead.data(), size)) {
+		ResetRewind();
+		return PINMAME_STATUS_STATE_INVALID;
+	}
 
-			if (!_p_Config->cb_OnMechUpdated)
-				return;
+	_rewindTimeOffset = timer_get_time() - _rewindHeadTime;
 
-			if (g_fHandleMechanics == 0)
-				(*(_p_Config->cb_OnMechUpdated))(mechNo - (MECH_MAXMECH / 2) + 1, &_mechInfo[mechNo], _p_userData);
-			else
-				(*(_p_Config->cb_OnMechUpdated))(mechNo, &_mechInfo[mechNo], _p_userData);
+	return PINMAME_STATUS_OK;
+}
+
+/******************************************************
+ * WarmStartKey
+ ******************************************************/
+
+static void WarmStartKey(uint8_t* const p_key, const size_t stateSize)
+{
+	// ROM set: names and expected hashes of all ROM files
+	uLong romCrc = crc32(0L, Z_NULL, 0);
+	for (const struct RomModule* region = rom_first_region(Machine->gamedrv); region; region = rom_next_region(region)) {
+		for (const struct RomModule* rom = rom_first_file(region); rom; rom = rom_next_file(rom)) {
+			romCrc = crc32(romCrc, (const Bytef*)ROM_GETNAME(rom), (uInt)strlen(ROM_GETNAME(rom)));
+			romCrc = crc32(romCrc, (const Bytef*)ROM_GETHASHDATA(rom), (uInt)strlen(ROM_GETHASHDATA(rom)));
 		}
 	}
-	else {
-		_mechInit[mechNo] = 1;
 
-		_mechInfo[mechNo].type = p_mechData->type;
-		_mechInfo[mechNo].length = p_mechData->length;
-		_mechInfo[mechNo].steps = p_mechData->steps;
-		
-		_mechInfo[mechNo].pos = p_mechData->pos;
-		_mechInfo[mechNo].speed = speed;
+	std::vector<uint8_t> image;
+	uLong nvramCrc = crc32(0L, Z_NULL, 0);
+	if (CaptureNVRAM(image) > 0)
+		nvramCrc = crc32(nvramCrc, image.data(), (uInt)image.size());
 
-		if (!_p_Config->cb_OnMechAvailable)
-			return;
+	const uint32_t values[4] = { (uint32_t)romCrc, (uint32_t)nvramCrc, (uint32_t)stateSize, (uint32_t)(_warmStartBootTime * 1000.) };
 
-		if (g_fHandleMechanics == 0)
-			(*(_p_Config->cb_OnMechAvailable))(mechNo - (MECH_MAXMECH / 2) + 1, &_mechInfo[mechNo], _p_userData);
-		else
-			(*(_p_Config->cb_OnMechAvailable))(mechNo, &_mechInfo[mechNo], _p_userData);
+	memcpy(p_key, WARMSTART_MAGIC, 8);
+	for (int i = 0; i < 4; i++) {
+		p_key[8 + i * 4 + 0] = values[i];
+		p_key[8 + i * 4 + 1] = values[i] >> 8;
+		p_key[8 + i * 4 + 2] = values[i] >> 16;
+		p_key[8 + i * 4 + 3] = values[i] >> 24;
 	}
+	for (int i = 0; i < 6; i++)
+		p_key[8 + 4 * 4 + i] = core_getDip(i);
 }
 
 /******************************************************
- * StartGame
+ * WarmStart
+ *
+ * First update of a run: restores the warm start state if its key matches,
+ * otherwise schedules saving one after the boot time.
  ******************************************************/
 
-int StartGame(const int gameNum)
+static void WarmStart()
 {
-	int err;
+	char filename[256];
+	snprintf(filename, sizeof(filename), "%s-warm", Machine->gamedrv->name);
 
-	memset(_mechInit, 0, sizeof(_mechInit));
-	memset(_mechInfo, 0, sizeof(_mechInfo));
+	size_t size = 0;
+	cpu_save_state_mem(nullptr, &size);
+	WarmStartKey(_warmStartKey, size);
 
-	err = run_game(gameNum);
+	mame_file* file = mame_fopen(Machine->gamedrv->name, filename, FILETYPE_STATE, 0);
+	if (file) {
+		uint8_t key[WARMSTART_HEADER];
+		std::vector<uint8_t> state(size);
 
-	OnStateChange(0);
+		const int valid = mame_fread(file, key, sizeof(key)) == sizeof(key)
+			&& !memcmp(key, _warmStartKey, sizeof(key))
+			&& mame_fread(file, state.data(), (UINT32)size) == size;
+		mame_fclose(file);
 
-	return err;
+		if (valid && !cpu_load_state_mem(state.data(), size)) {
+			libpinmame_log_info("WarmStart(): restored %s", filename);
+			return;
+		}
+	}
+
+	_warmStartPending = 1;
 }
 
 /******************************************************
- * PinmameGetGame
+ * WarmStartSave
  ******************************************************/
 
-PINMAMEAPI PINMAME_STATUS PinmameGetGame(const char* const p_name, PinmameGameCallback callback, const void* p_userData)
+static void WarmStartSave()
 {
-	if (!_p_Config)
-		return PINMAME_STATUS_CONFIG_NOT_SET;
+	char filename[256];
+	snprintf(filename, sizeof(filename), "%s-warm", Machine->gamedrv->name);
 
-	int gameNum = GetGameNumFromString(p_name);
+	size_t size = 0;
+	cpu_save_state_mem(nullptr, &size);
+	std::vector<uint8_t> state(size);
+	if (cpu_save_state_mem(state.data(), &size))
+		return;
 
-	if (gameNum < 0)
-		return PINMAME_STATUS_GAME_NOT_FOUND;
+	mame_file* file = mame_fopen(Machine->gamedrv->name, filename, FILETYPE_STATE, 1);
+	if (file) {
+		mame_fwrite(file, _warmStartKey, sizeof(_warmStartKey));
+		mame_fwrite(file, state.data(), (UINT32)size);
+		mame_fclose(file);
+		libpinmame_log_info("WarmStartSave(): saved %s", filename);
+	}
+}
 
-	PinmameGame game;
-	memset(&game, 0, sizeof(PinmameGame));
+/******************************************************
+ * MemoryWatchWrite
+ *
+ * Write tap of the watched CPUs (emulation thread).
+ ******************************************************/
 
-	game.name = drivers[gameNum]->name;
-	if (drivers[gameNum]->clone_of)
-		game.clone_of = drivers[gameNum]->clone_of->name;
-	game.description = drivers[gameNum]->description;
-	game.year = drivers[gameNum]->year;
-	game.manufacturer = drivers[gameNum]->manufacturer;
-	game.flags = drivers[gameNum]->flags;
-	game.found = RomsetMissing(gameNum) == 0;
+static void MemoryWatchWrite(int cpunum, offs_t address, int length)
+{
+	const double now = timer_get_time();
+
+	for (MemoryWatch& watch : _memoryWatches) {
+		if (watch.cpu != cpunum)
+			continue;
+
+		for (int i = 0; i < length; i++) {
+			const uint32_t offset = (uint32_t)address + i - watch.start;
+			if (offset >= (uint32_t)watch.length)
+				continue;
+			if (watch.writeTime[offset] < 0.)
+				watch.written.push_back(offset);
+			watch.writeTime[offset] = now;
+		}
+	}
+}
 
-	if (callback)
-		(*callback)(&game, p_userData);
+/******************************************************
+ * MemoryWatchTouchAll
+ *
+ * Checks every watched byte on the next delivery, after the memory
+ * was replaced without CPU writes (state load, rewind).
+ ******************************************************/
 
-	return PINMAME_STATUS_OK;
+static void MemoryWatchTouchAll()
+{
+	const double now = timer_get_time();
+
+	for (MemoryWatch& watch : _memoryWatches) {
+		watch.written.clear();
+		for (int i = 0; i < watch.length; i++) {
+			watch.writeTime[i] = now;
+			watch.written.push_back(i);
+		}
+	}
 }
 
 /******************************************************
- * PinmameGetGames
+ * MemoryWatchApply
+ *
+ * Takes over the watches requested by the host, keeping the state of
+ * the ones already applied, and sets the write taps to cover them.
  ******************************************************/
 
-PINMAMEAPI PINMAME_STATUS PinmameGetGames(PinmameGameCallback callback, const void* p_userData)
+static void MemoryWatchApply()
 {
-	if (!_p_Config)
-		return PINMAME_STATUS_CONFIG_NOT_SET;
+	std::vector<MemoryWatch> watches;
+	{
+		std::lock_guard<std::mutex> lock(_memoryWatchMutex);
+		_memoryWatchPending = 0;
+		watches = _memoryWatchRequests;
+	}
 
-	int gameNum = 0;
+	const int cpuCount = cpu_gettotalcpu();
+	for (MemoryWatch& watch : watches) {
+		auto it = std::find_if(_memoryWatches.begin(), _memoryWatches.end(), [&watch](const MemoryWatch& applied) { return applied.id == watch.id; });
+		if (it != _memoryWatches.end()) {
+			watch = std::move(*it);
+			continue;
+		}
+		watch.value.resize(watch.length);
+		watch.writeTime.assign(watch.length, -1.);
+		if (watch.cpu < cpuCount)
+			for (int i = 0; i < watch.length; i++)
+				watch.value[i] = cpunum_read_byte(watch.cpu, watch.start + i);
+	}
+	_memoryWatches = std::move(watches);
+
+	memory_write_watch_hook = MemoryWatchWrite;
+	for (int cpu = 0; cpu < cpuCount; cpu++) {
+		uint32_t start = 0xffffffffu, end = 0;
+		for (const MemoryWatch& watch : _memoryWatches) {
+			if (watch.cpu != cpu)
+				continue;
+			start = std::min(start, watch.start);
+			end = std::max(end, watch.start + watch.length - 1);
+		}
+		memory_set_write_watch(cpu, start, end); // disabled if start > end
+	}
+}
 
-	while (drivers[gameNum]) {
-		PinmameGame game;
-		memset(&game, 0, sizeof(PinmameGame));
+/******************************************************
+ * MemoryWatchDeliver
+ *
+ * Calls back the host with the watched bytes that changed since the
+ * last delivery, one call per watch (emulation thread).
+ ******************************************************/
 
-		game.name = drivers[gameNum]->name;
-		if (drivers[gameNum]->clone_of)
-			game.clone_of = drivers[gameNum]->clone_of->name;
-		game.description = drivers[gameNum]->description;
-		game.year = drivers[gameNum]->year;
-		game.manufacturer = drivers[gameNum]->manufacturer;
-		game.flags = drivers[gameNum]->flags;
-		game.found = RomsetMissing(gameNum) == 0;
+static void MemoryWatchDeliver()
+{
+	for (MemoryWatch& watch : _memoryWatches) {
+		if (watch.written.empty())
+			continue;
+
+		std::sort(watch.written.begin(), watch.written.end());
+		_memoryChanges.clear();
+		for (const uint32_t offset : watch.written) {
+			const uint8_t value = cpunum_read_byte(watch.cpu, watch.start + offset);
+			if (value != watch.value[offset]) {
+				_memoryChanges.push_back({ watch.writeTime[offset], watch.cpu, watch.start + offset, watch.value[offset], value });
+				watch.value[offset] = value;
+			}
+			watch.writeTime[offset] = -1.;
+		}
+		watch.written.clear();
 
-		if (callback)
-			(*callback)(&game, p_userData);
+		if (!_memoryChanges.empty())
+			(*watch.callback)(_memoryChanges.data(), (int)_memoryChanges.size(), _p_userData);
+	}
+}
 
-		gameNum++;
+/******************************************************
+ * MemoryWatchStop
+ *
+ * The watches end with the game.
+ ******************************************************/
+
+static void MemoryWatchStop()
+{
+	std::lock_guard<std::mutex> lock(_memoryWatchMutex);
+	_memoryWatchRequests.clear();
+	_memoryWatchPending = 0;
+	_memoryWatches.clear();
+	memory_write_watch_hook = nullptr;
+}
+
+/******************************************************
+ * RunStateRequest
+ ******************************************************/
+
+static PINMAME_STATUS RunStateRequest(const STATE_REQUEST request, void* const p_buffer, size_t* const p_size, const double rewindTime)
+{
+	switch (request) {
+		case STATE_REQUEST_SAVE:
+			if (!p_buffer) {
+				cpu_save_state_mem(nullptr, p_size);
+				return PINMAME_STATUS_OK;
+			}
+			return cpu_save_state_mem((UINT8*)p_buffer, p_size) ? PINMAME_STATUS_BUFFER_TOO_SMALL : PINMAME_STATUS_OK;
+
+		case STATE_REQUEST_LOAD:
+			if (cpu_load_state_mem((const UINT8*)p_buffer, *p_size))
+				return PINMAME_STATUS_STATE_INVALID;
+			// the ring no longer matches the emulated timeline
+			ResetRewind();
+			MemoryWatchTouchAll();
+			return PINMAME_STATUS_OK;
+
+		case STATE_REQUEST_REWIND: {
+			const PINMAME_STATUS status = Rewind(rewindTime);
+			if (status == PINMAME_STATUS_OK)
+				MemoryWatchTouchAll();
+			return status;
+		}
+
+		default:
+			return PINMAME_STATUS_OK;
 	}
+}
 
-	return PINMAME_STATUS_OK;
+/******************************************************
+ * Input recording and replay
+ ******************************************************/
+
+extern "C" int libpinmame_get_switch_event(int* p_swNo, int* p_state, double* p_time);
+
+static uint32_t ReplayStateCrc()
+{
+	size_t size = 0;
+	cpu_save_state_mem(NULL, &size);
+	_replayState.resize(size);
+	if (!size || cpu_save_state_mem(_replayState.data(), &size))
+		return 0;
+
+	return (uint32_t)crc32(crc32(0L, Z_NULL, 0), _replayState.data(), (uInt)size);
+}
+
+static void ReplayApply(const PinmameReplayInput& input)
+{
+	switch (input.type) {
+		case 'S':
+			vp_putSwitch(input.no, input.value);
+			break;
+		case 'D':
+			vp_setDIP(input.no, input.value);
+			break;
+	}
+}
+
+static void ReplayRecord(const double now, const PinmameReplayInput& input)
+{
+	ReplayApply(input);
+
+	if (input.type == 'F')
+		fprintf(_p_replayFile, "F %.17g %.17g\n", now, input.fvalue);
+	else
+		fprintf(_p_replayFile, "%c %.17g %d %d\n", input.type, now, input.no, input.value);
+
+	std::lock_guard<std::mutex> lock(_replayMutex);
+	_replayStatus.events++;
+}
+
+static void ReplayStop()
+{
+	if (_p_replayFile) {
+		fclose(_p_replayFile);
+		_p_replayFile = nullptr;
+	}
+	_replayMode = PINMAME_REPLAY_MODE_NONE;
+}
+
+static int ReplayReadLine()
+{
+	_replayHasLine = fgets(_replayLine, sizeof(_replayLine), _p_replayFile) != NULL;
+	return _replayHasLine;
+}
+
+// first poll tick: write or check the header, the NVRAM loaded at startup and the DIP settings
+static void ReplayOpen(const PINMAME_REPLAY_MODE mode)
+{
+	std::vector<uint8_t> image;
+	uLong nvramCrc = crc32(0L, Z_NULL, 0);
+	if (CaptureNVRAM(image) > 0)
+		nvramCrc = crc32(nvramCrc, image.data(), (uInt)image.size());
+
+	_p_replayFile = fopen(_replayPath.c_str(), mode == PINMAME_REPLAY_MODE_RECORD ? "w" : "r");
+	if (!_p_replayFile) {
+		libpinmame_log_error("Unable to open the input recording %s", _replayPath.c_str());
+		ReplayStop();
+		return;
+	}
+
+	if (mode == PINMAME_REPLAY_MODE_RECORD) {
+		fprintf(_p_replayFile, "%s %s %.17g %08x\n", REPLAY_MAGIC, Machine->gamedrv->name, _replayInterval, (unsigned int)nvramCrc);
+		for (int i = 0; i < 6; i++)
+			ReplayRecord(timer_get_time(), { 'D', i, core_getDip(i), 0. });
+		return;
+	}
+
+	char magic[16], name[64];
+	double interval;
+	unsigned int crc;
+	if (!ReplayReadLine() || sscanf(_replayLine, "%15s %63s %lf %x", magic, name, &interval, &crc) != 4 || strcmp(magic, REPLAY_MAGIC)) {
+		libpinmame_log_error("%s is not an input recording", _replayPath.c_str());
+		ReplayStop();
+		return;
+	}
+	if (strcmp(name, Machine->gamedrv->name)) {
+		libpinmame_log_error("Input recording %s is for %s, not %s", _replayPath.c_str(), name, Machine->gamedrv->name);
+		ReplayStop();
+		return;
+	}
+	if (crc != (unsigned int)nvramCrc)
+		libpinmame_log_info("Input recording %s was made with a different NVRAM, checkpoints will not match", _replayPath.c_str());
+
+	ReplayReadLine();
+}
+
+static void ReplayPlay(const double now)
+{
+	while (_replayHasLine) {
+		char type;
+		double time;
+		if (sscanf(_replayLine, " %c %lf", &type, &time) != 2) {
+			ReplayReadLine();
+			continue;
+		}
+		if (time > now)
+			return;
+
+		PinmameReplayInput input = { type, 0, 0, 0. };
+		unsigned int state, display, audio;
+
+		if (type == 'H' && sscanf(_replayLine, " %c %lf %x %x %x", &type, &time, &state, &display, &audio) == 5) {
+			const int match = (state == ReplayStateCrc()) && (display == (unsigned int)_replayDisplayCrc) && (audio == (unsigned int)_replayAudioCrc);
+
+			std::lock_guard<std::mutex> lock(_replayMutex);
+			_replayStatus.checkpoints++;
+			if (!match) {
+				if (!_replayStatus.mismatches++) {
+					_replayStatus.firstMismatchTime = now;
+					libpinmame_log_error("Input replay diverged at %.3f s", now);
+				}
+			}
+		}
+		else if (type == 'F') {
+			// time fences only pace the emulation against the host, they are not replayed
+		}
+		else if ((type == 'S' || type == 'D') && sscanf(_replayLine, " %c %lf %d %d", &type, &time, &input.no, &input.value) == 4) {
+			ReplayApply(input);
+
+			std::lock_guard<std::mutex> lock(_replayMutex);
+			_replayStatus.events++;
+		}
+
+		ReplayReadLine();
+	}
+
+	if (!_replayHasLine) {
+		std::lock_guard<std::mutex> lock(_replayMutex);
+		_replayStatus.finished = 1;
+	}
+}
+
+extern "C" int libpinmame_replay_poll(void)
+{
+	const PINMAME_REPLAY_MODE mode = (PINMAME_REPLAY_MODE)_replayMode.load(std::memory_order_relaxed);
+	if (mode == PINMAME_REPLAY_MODE_NONE)
+		return 0;
+
+	const double now = timer_get_time();
+
+	if (!_replayStarted) {
+		_replayStarted = 1;
+		_replayNextCheckpoint = now + _replayInterval;
+		ReplayOpen(mode);
+		if (!_p_replayFile)
+			return 0;
+	}
+
+	// queued switch events, as they become due
+	int swNo, state;
+	double time;
+	while (libpinmame_get_switch_event(&swNo, &state, &time)) {
+		if (mode == PINMAME_REPLAY_MODE_RECORD)
+			_replayPendingEvents.push_back({ swNo, state, time });
+	}
+
+	if (mode == PINMAME_REPLAY_MODE_PLAYBACK) {
+		ReplayPlay(now);
+		return 1;
+	}
+
+	while (!_replayPendingEvents.empty() && _replayPendingEvents.front().time <= now) {
+		const PinmameSwitchEvent event = _replayPendingEvents.front();
+		_replayPendingEvents.pop_front();
+		ReplayRecord(now, { 'S', event.swNo, event.state ? 1 : 0, 0. });
+	}
+
+	for (;;) {
+		PinmameReplayInput input;
+		{
+			std::lock_guard<std::mutex> lock(_replayMutex);
+			if (_replayInputs.empty())
+				break;
+			input = _replayInputs.front();
+			_replayInputs.pop_front();
+		}
+		ReplayRecord(now, input);
+	}
+
+	if (now >= _replayNextCheckpoint) {
+		_replayNextCheckpoint = now + _replayInterval;
+		fprintf(_p_replayFile, "H %.17g %08x %08x %08x\n", now, ReplayStateCrc(), (unsigned int)_replayDisplayCrc, (unsigned int)_replayAudioCrc);
+		fflush(_p_replayFile);
+
+		std::lock_guard<std::mutex> lock(_replayMutex);
+		_replayStatus.checkpoints++;
+	}
+
+	return 1;
+}
+
+// host inputs: while recording, handed to the emulation thread; while replaying, ignored
+static int ReplayHostInput(const char type, const int no, const int value, const double fvalue)
+{
+	const int mode = _replayMode.load(std::memory_order_relaxed);
+	if (mode == PINMAME_REPLAY_MODE_RECORD) {
+		std::lock_guard<std::mutex> lock(_replayMutex);
+		_replayInputs.push_back({ type, no, value, fvalue });
+	}
+	return mode != PINMAME_REPLAY_MODE_NONE;
 }
 
 /******************************************************
- * PinmameSetConfig
+ * libpinmame_cpu_trace
+ *
+ * Called by cpu_timeslice after each timeslice of a traced
+ * CPU, with the cycles it ran and the host time it took.
  ******************************************************/
 
-PINMAMEAPI void PinmameSetConfig(const PinmameConfig* const p_config)
+extern "C" void libpinmame_cpu_trace(int cpunum, int cycles, cycles_t host)
 {
-	if (!_p_Config)
-		_p_Config = (PinmameConfig*)malloc(sizeof(PinmameConfig));
+	if (!_p_cpuTraceFile) {
+		_p_cpuTraceFile = fopen(_cpuTracePath.c_str(), "w");
+		if (!_p_cpuTraceFile) {
+			libpinmame_log_error("Unable to open the CPU trace %s", _cpuTracePath.c_str());
+			libpinmame_cpu_trace_mask = 0;
+			return;
+		}
 
-	memcpy(_p_Config, p_config, sizeof(PinmameConfig));
+		fprintf(_p_cpuTraceFile, "%s %s %lld\n", CPU_TRACE_MAGIC, Machine->gamedrv->name, (long long)osd_cycles_per_second());
+		for (int i = 0; i < cpu_gettotalcpu(); i++) {
+			if (libpinmame_cpu_trace_mask & (1 << i))
+				fprintf(_p_cpuTraceFile, "N %d %s\n", i, cputype_name(Machine->drv->cpu[i].cpu_type));
+		}
+		_cpuTraceNextState = _cpuTraceStateInterval;
+	}
 
-	libpinmame_log_info("PinmameSetConfig(): sampleRate=%d, vpmPath=%s", _p_Config->sampleRate, _p_Config->vpmPath);
+	const double now = timer_get_time();
+	const unsigned int pc = cpunum_get_pc(cpunum);
 
-	memset(&options, 0, sizeof(options));
+	fprintf(_p_cpuTraceFile, "C %d %.9f %d %lld |", cpunum, now, cycles, (long long)host);
 
-	options.samplerate = _p_Config->sampleRate;
-	options.skip_gameinfo = 1;
-	options.skip_disclaimer = 1;
+	const INT8* p_layout = (const INT8*)cpunum_reg_layout(cpunum);
+	for (; p_layout && *p_layout; p_layout++) {
+		if (*p_layout > 0)
+			fprintf(_p_cpuTraceFile, " %s", cpunum_dump_reg(cpunum, *p_layout));
+	}
 
-	setPath(FILETYPE_ROM, ComposePath(_p_Config->vpmPath, "roms"));
-	setPath(FILETYPE_NVRAM, ComposePath(_p_Config->vpmPath, "nvram"));
-	setPath(FILETYPE_SAMPLE, ComposePath(_p_Config->vpmPath, "samples"));
-	setPath(FILETYPE_CONFIG, ComposePath(_p_Config->vpmPath, "cfg"));
-	setPath(FILETYPE_HIGHSCORE, ComposePath(_p_Config->vpmPath, "hi"));
-	setPath(FILETYPE_INPUTLOG, ComposePath(_p_Config->vpmPath, "inp"));
-	setPath(FILETYPE_MEMCARD, ComposePath(_p_Config->vpmPath, "memcard"));
-	setPath(FILETYPE_STATE, ComposePath(_p_Config->vpmPath, "sta"));
+	char dasm[256];
+	dasm[0] = '\0';
+	cpunum_dasm(cpunum, dasm, pc);
+	fprintf(_p_cpuTraceFile, " | %s\n", dasm);
 
-	throttle = 1;
-	autoframeskip = 0;
-	allow_sleep = 1;
+	if (_cpuTraceStateInterval > 0. && now >= _cpuTraceNextState) {
+		_cpuTraceNextState = now + _cpuTraceStateInterval;
+		fprintf(_p_cpuTraceFile, "H %.9f %08x\n", now, ReplayStateCrc());
+	}
 }
 
 /******************************************************
- * PinmameSetPath
+ * Golden output checksums
  ******************************************************/
 
-PINMAMEAPI void PinmameSetPath(const PINMAME_FILE_TYPE fileType, const char* const p_path)
+static void GoldenOpen(const char* const p_gameName)
 {
-	if (!p_path)
+	std::lock_guard<std::mutex> lock(_goldenMutex);
+
+	memset(&_goldenStatus, 0, sizeof(_goldenStatus));
+	_goldenMode = PINMAME_GOLDEN_MODE_NONE;
+	_goldenFrame = 0;
+	_goldenSecond = 0;
+	_goldenLuminanceCrc = _goldenBitplaneCrc = _goldenAudioCrc = crc32(0L, Z_NULL, 0);
+
+	if (_goldenRequested == PINMAME_GOLDEN_MODE_NONE)
 		return;
 
-	char* const newPath = (char*)malloc(strlen(p_path) + 1);
-	strcpy(newPath, p_path);
+	_p_goldenFile = fopen(_goldenPath.c_str(), _goldenRequested == PINMAME_GOLDEN_MODE_RECORD ? "w" : "r");
+	if (!_p_goldenFile) {
+		libpinmame_log_error("Unable to open the golden output %s", _goldenPath.c_str());
+		return;
+	}
 
-	switch(fileType) {
-		case PINMAME_FILE_TYPE_ROMS:
-			setPath(FILETYPE_ROM, newPath);
-			break;
-		case PINMAME_FILE_TYPE_NVRAM:
-			setPath(FILETYPE_NVRAM, newPath);
-			break;
-		case PINMAME_FILE_TYPE_SAMPLES:
-			setPath(FILETYPE_SAMPLE, newPath);
-			break;
-		case PINMAME_FILE_TYPE_CONFIG:
-			setPath(FILETYPE_CONFIG, newPath);
-			break;
-		case PINMAME_FILE_TYPE_HIGHSCORE:
-			setPath(FILETYPE_HIGHSCORE, newPath);
-			break;
+	if (_goldenRequested == PINMAME_GOLDEN_MODE_RECORD) {
+		_goldenInterval = _goldenFramesPerCrc;
+		fprintf(_p_goldenFile, "%s %s %d\n", GOLDEN_MAGIC, p_gameName, _goldenInterval);
+	}
+	else {
+		char magic[16], game[64];
+		if (fscanf(_p_goldenFile, "%15s %63s %d\n", magic, game, &_goldenInterval) != 3 || strcmp(magic, GOLDEN_MAGIC) || _goldenInterval < 1) {
+			libpinmame_log_error("%s is not a golden output file", _goldenPath.c_str());
+			fclose(_p_goldenFile);
+			_p_goldenFile = nullptr;
+			return;
+		}
+		if (strcmp(game, p_gameName)) {
+			libpinmame_log_error("Golden output %s was made for %s", _goldenPath.c_str(), game);
+			fclose(_p_goldenFile);
+			_p_goldenFile = nullptr;
+			return;
+		}
+	}
+
+	_goldenMode = _goldenRequested;
+	_goldenStatus.mode = _goldenRequested;
+}
+
+static void GoldenStop()
+{
+	if (_p_goldenFile) {
+		fclose(_p_goldenFile);
+		_p_goldenFile = nullptr;
+	}
+	_goldenMode = PINMAME_GOLDEN_MODE_NONE;
+}
+
+static void GoldenMismatch(const PINMAME_GOLDEN_MISMATCH mismatch, const uint32_t frame, const double time)
+{
+	static const char* const names[] = { "", "luminance", "bitplane", "audio", "frame sequence" };
+	libpinmame_log_info("Golden output mismatch (%s) at frame %u, %.3f s", names[mismatch], frame, time);
+
+	std::lock_guard<std::mutex> lock(_goldenMutex);
+	_goldenStatus.mismatch = mismatch;
+	_goldenStatus.firstMismatchFrame = frame;
+	_goldenStatus.firstMismatchTime = time;
+	_goldenMode = PINMAME_GOLDEN_MODE_NONE;
+}
+
+// 'D' frame luminance bitplane: last frame of a group of _goldenInterval frames, 'A' second audio
+static void GoldenCheck(const char type, const uint32_t index, const uint32_t crc1, const uint32_t crc2)
+{
+	if (_goldenMode == PINMAME_GOLDEN_MODE_RECORD) {
+		if (type == 'D')
+			fprintf(_p_goldenFile, "D %u %08x %08x\n", index, crc1, crc2);
+		else
+			fprintf(_p_goldenFile, "A %u %08x\n", index, crc1);
+		std::lock_guard<std::mutex> lock(_goldenMutex);
+		_goldenStatus.checks++;
+		return;
+	}
+
+	char line[128];
+	if (!fgets(line, sizeof(line), _p_goldenFile)) {
+		std::lock_guard<std::mutex> lock(_goldenMutex);
+		_goldenStatus.finished = 1;
+		_goldenMode = PINMAME_GOLDEN_MODE_NONE;
+		return;
+	}
+
+	char expectedType = 0;
+	unsigned int expectedIndex = 0, expected1 = 0, expected2 = 0;
+	sscanf(line, "%c %u %x %x", &expectedType, &expectedIndex, &expected1, &expected2);
+
+	const uint32_t firstFrame = (type == 'D') ? index - _goldenInterval : _goldenFrame;
+	if (expectedType != type || expectedIndex != index)
+		GoldenMismatch(PINMAME_GOLDEN_MISMATCH_SEQUENCE, firstFrame, timer_get_time());
+	else if (expected1 != crc1)
+		GoldenMismatch(type == 'D' ? PINMAME_GOLDEN_MISMATCH_LUMINANCE : PINMAME_GOLDEN_MISMATCH_AUDIO, firstFrame, type == 'D' ? timer_get_time() : (double)index);
+	else if (type == 'D' && expected2 != crc2)
+		GoldenMismatch(PINMAME_GOLDEN_MISMATCH_BITPLANE, firstFrame, timer_get_time());
+	else {
+		std::lock_guard<std::mutex> lock(_goldenMutex);
+		_goldenStatus.checks++;
+	}
+}
+
+/******************************************************
+ * libpinmame_golden_dmd
+ *
+ * Called by core_dmd_video_update with each main DMD
+ * frame, as luminance and bitplane values.
+ ******************************************************/
+
+extern "C" void libpinmame_golden_dmd(const UINT8* p_luminance, const UINT8* p_bitplane, const int size)
+{
+	if (_goldenMode == PINMAME_GOLDEN_MODE_NONE)
+		return;
+
+	_goldenLuminanceCrc = crc32(_goldenLuminanceCrc, (const Bytef*)p_luminance, (uInt)size);
+	_goldenBitplaneCrc = crc32(_goldenBitplaneCrc, (const Bytef*)p_bitplane, (uInt)size);
+
+	if (++_goldenFrame % _goldenInterval == 0) {
+		GoldenCheck('D', _goldenFrame, (uint32_t)_goldenLuminanceCrc, (uint32_t)_goldenBitplaneCrc);
+		_goldenLuminanceCrc = _goldenBitplaneCrc = crc32(0L, Z_NULL, 0);
+	}
+}
+
+// the mixed audio of each frame, as passed to the host
+static void GoldenAudio(const void* p_buffer, const size_t sampleSize)
+{
+	if (_goldenMode == PINMAME_GOLDEN_MODE_NONE)
+		return;
+
+	const int second = (int)timer_get_time();
+	if (second > _goldenSecond) {
+		GoldenCheck('A', (uint32_t)_goldenSecond, (uint32_t)_goldenAudioCrc, 0);
+		_goldenAudioCrc = crc32(0L, Z_NULL, 0);
+		_goldenSecond = second;
 	}
+
+	_goldenAudioCrc = crc32(_goldenAudioCrc, (const Bytef*)p_buffer, (uInt)(mixer_samples_this_frame() * _audioInfo.channels * sampleSize));
+}
+
+/******************************************************
+ * WritePcSamplingReport
+ ******************************************************/
+
+static void WritePcSamplingReport()
+{
+	std::string path;
+	int top;
+	{
+		std::lock_guard<std::mutex> lock(_pcSamplingMutex);
+		path = _pcSamplingReport;
+		top = _pcSamplingTop;
+	}
+	if (path.empty() || _pcSamplingApplied <= 0.)
+		return;
+
+	FILE* p_file = fopen(path.c_str(), "a");
+	if (!p_file) {
+		libpinmame_log_error("Unable to write the PC sampling report %s", path.c_str());
+		return;
+	}
+
+	fprintf(p_file, "game %s, one sample every %.0f us\n", Machine->gamedrv->name, _pcSamplingApplied * 1e6);
+
+	std::vector<cpu_pc_sample> samples(top > 0 ? top : 1);
+	for (int cpunum = 0; cpunum < MAX_CPU && Machine->drv->cpu[cpunum].cpu_type != CPU_DUMMY; cpunum++) {
+		UINT32 total;
+		const int count = cpu_get_pc_samples(cpunum, samples.data(), (int)samples.size(), &total);
+
+		fprintf(p_file, "  cpu %d %s, %u samples\n", cpunum, cputype_name(Machine->drv->cpu[cpunum].cpu_type), total);
+		for (int i = 0; i < count; i++) {
+			char bank[16];
+			if (samples[i].bank == (UINT32)FAKE_BANKID)
+				snprintf(bank, sizeof(bank), "--");
+			else
+				snprintf(bank, sizeof(bank), "%02X", samples[i].bank);
+
+			fprintf(p_file, "    %8u %6.2f%%  %s:%08X  %s\n", samples[i].count, total ? 100. * samples[i].count / total : 0.,
+				bank, samples[i].pc, samples[i].dasm);
+		}
+	}
+	fprintf(p_file, "\n");
+	fclose(p_file);
+}
+
+/******************************************************
+ * TimerStatsSnapshot
+ ******************************************************/
+
+static void TimerStatsSnapshot()
+{
+	std::lock_guard<std::mutex> lock(_timerStatsMutex);
+
+	const char* p_name;
+	UINT64 fires;
+	double time;
+
+	_timerStats.clear();
+	for (int i = 0; timer_get_callback_stats(i, &p_name, &fires, &time); i++) {
+		PinmameTimerStats stats;
+		snprintf(stats.name, sizeof(stats.name), "%s", p_name);
+		stats.fires = fires;
+		stats.time = time;
+		_timerStats.push_back(stats);
+	}
+
+	_audioStreamStats.clear();
+	if (Machine->sample_rate) {
+		PinmameAudioStreamStats stats;
+		snprintf(stats.name, sizeof(stats.name), "Mixer");
+		stats.channels = 0;
+		stats.time = profiler_get_total(PROFILER_MIXER, NULL);
+		stats.samples = profiler_get_count(PROFILER_MIXER);
+		_audioStreamStats.push_back(stats);
+
+		UINT64 samples;
+		for (int channel = 0; channel < MIXER_MAX_CHANNELS; channel++) {
+			const int channels = stream_get_stats(channel, &p_name, &samples, &time);
+			if (!channels)
+				continue;
+			snprintf(stats.name, sizeof(stats.name), "%s", p_name ? p_name : "");
+			stats.channels = channels;
+			stats.samples = samples;
+			stats.time = time;
+			_audioStreamStats.push_back(stats);
+			channel += channels - 1;
+		}
+	}
+}
+
+/******************************************************
+ * libpinmame_update_state
+ ******************************************************/
+
+extern "C" void libpinmame_update_state(void)
+{
+	const int cpuCount = cpu_gettotalcpu();
+	for (int i = 0; i < cpuCount; i++)
+		_cpuCycles[i].store(cpunum_gettotalcycles64(i), std::memory_order_relaxed);
+	_cpuCount.store(cpuCount, std::memory_order_release);
+
+	const int timerProfiling = _timerProfiling.load(std::memory_order_relaxed) | _audioProfiling.load(std::memory_order_relaxed);
+	if (timerProfiling != _timerProfilingApplied) {
+		_timerProfilingApplied = timerProfiling;
+		profiler_set_totals(timerProfiling);
+	}
+
+	const double pcSamplingInterval = _pcSamplingInterval.load(std::memory_order_relaxed);
+	if (pcSamplingInterval != _pcSamplingApplied) {
+		_pcSamplingApplied = pcSamplingInterval;
+		cpu_set_pc_sampling(pcSamplingInterval);
+	}
+
+	const int autoInterleave = _autoInterleave.load(std::memory_order_relaxed);
+	if (autoInterleave != _autoInterleaveApplied) {
+		_autoInterleaveApplied = autoInterleave;
+		cpu_set_auto_interleave(autoInterleave);
+	}
+	{
+		UINT32 slices;
+		double average;
+		cpu_get_interleave_stats(&slices, &average);
+		_interleaveSlices.store(slices, std::memory_order_relaxed);
+		_interleaveAverage.store(average, std::memory_order_relaxed);
+	}
+
+	const double timerStatsNow = timer_get_time();
+	if (timerStatsNow - _timerStatsTime >= TIMERSTATS_INTERVAL || timerStatsNow < _timerStatsTime) {
+		_timerStatsTime = timerStatsNow;
+		TimerStatsSnapshot();
+	}
+
+	const double bootTime = _warmStartBootTime.load(std::memory_order_relaxed);
+	if (bootTime > 0.) {
+		if (!_warmStartChecked) {
+			_warmStartChecked = 1;
+			WarmStart();
+		}
+		else if (_warmStartPending && timer_get_time() >= bootTime) {
+			_warmStartPending = 0;
+			WarmStartSave();
+		}
+	}
+
+	if (_stateRequest.load(std::memory_order_acquire) != STATE_REQUEST_NONE) {
+		std::lock_guard<std::mutex> lock(_stateMutex);
+		if (_stateRequest != STATE_REQUEST_NONE) {
+			_stateStatus = RunStateRequest((STATE_REQUEST)_stateRequest.load(), _p_stateBuffer, &_stateSize, _stateRewindTime);
+			_stateRequest = STATE_REQUEST_NONE;
+			_stateDone.notify_all();
+		}
+	}
+
+	NVRAMAutosave();
+
+	if (_memoryWatchPending.load(std::memory_order_acquire))
+		MemoryWatchApply();
+	MemoryWatchDeliver();
+
+	if (_profilerPending.load(std::memory_order_acquire)) {
+		std::lock_guard<std::mutex> lock(_profilerMutex);
+		_profilerPending = 0;
+		if (profiler_set_trace(_profilerTraceFile.empty() ? NULL : _profilerTraceFile.c_str()))
+			libpinmame_log_error("Unable to write the profiler trace %s", _profilerTraceFile.c_str());
+		if (profiler_set_csv(_profilerCsvFile.empty() ? NULL : _profilerCsvFile.c_str(), _profilerCsvInterval))
+			libpinmame_log_error("Unable to create the profiler CSV file %s", _profilerCsvFile.c_str());
+	}
+
+	const size_t budget = _rewindBudget.load(std::memory_order_relaxed);
+	const double interval = _rewindInterval.load(std::memory_order_relaxed);
+
+	if (!budget || interval <= 0.) {
+		if (!_rewindHead.empty())
+			ResetRewind();
+		return;
+	}
+
+	const double now = timer_get_time() - _rewindTimeOffset;
+	if (_rewindHead.empty() || now - _rewindHeadTime >= interval || now < _rewindHeadTime)
+		RewindCheckpoint(now);
+}
+
+/******************************************************
+ * IsPinmameDisplayFrameMismatch
+ *
+ * Main DMD frames of the other DMD mode (colored or not) than the
+ * display was created for, when the mode was changed while the game
+ * was starting.
+ ******************************************************/
+
+static int IsPinmameDisplayFrameMismatch(const PinmameDisplay* const pDisplay, const void* const p_data)
+{
+	const int colorDisplay = (pDisplay->layout.type & CORE_DMD) == CORE_DMD && pDisplay->layout.depth == 32;
+	return (p_data == g_raw_dmdbuffer && colorDisplay) || (p_data == g_raw_colordmdbuffer && !colorDisplay);
+}
+
+/******************************************************
+ * AllocFrameBuffer
+ *
+ * Reuses a frame buffer of the same size left by the previous game of
+ * a warm switch (games of the same generation have the same displays).
+ ******************************************************/
+
+static void* AllocFrameBuffer(const int size)
+{
+	for (size_t i = 0; i < _spareFrameBuffers.size(); i++) {
+		if (_spareFrameBuffers[i].first == size) {
+			void* const p_data = _spareFrameBuffers[i].second;
+			_spareFrameBuffers.erase(_spareFrameBuffers.begin() + i);
+			memset(p_data, 0, size);
+			return p_data;
+		}
+	}
+	return calloc(1, size);
+}
+
+/******************************************************
+ * FreeDisplays
+ *
+ * Deletes the displays of the last game. Their frame buffers are kept
+ * for the next game when recycle is set, otherwise they are freed along
+ * with the ones kept earlier.
+ ******************************************************/
+
+static void FreeDisplays(const int recycle)
+{
+	std::lock_guard<std::mutex> lock(_displaysMutex);
+
+	for (PinmameDisplay* pDisplay : _displays) {
+		for (int i = 0; i < DISPLAY_FRAME_BUFFERS; i++) {
+			if (recycle)
+				_spareFrameBuffers.emplace_back(pDisplay->size, pDisplay->pFrameData[i]);
+			else
+				free(pDisplay->pFrameData[i]);
+		}
+
+		delete pDisplay;
+	}
+
+	_displays.clear();
+
+	if (!recycle) {
+		for (auto& spare : _spareFrameBuffers)
+			free(spare.second);
+		_spareFrameBuffers.clear();
+	}
+}
+
+/******************************************************
+ * UpdateEcoMode
+ *
+ * Called once per frame for the first display, with newFrame set when
+ * the main DMD got a new frame (whose hash is g_raw_dmd_hash).
+ ******************************************************/
+
+static void UpdateEcoMode(const int newFrame)
+{
+	const double idleTime = _ecoIdleTime.load(std::memory_order_relaxed);
+	const double now = timer_get_time();
+
+	if (idleTime <= 0. || _ecoActivity.exchange(0, std::memory_order_relaxed)) {
+		_ecoLastActivity = now;
+		_ecoHashCount = 0;
+		_ecoKnownFrames = 0;
+		_ecoActive.store(0, std::memory_order_relaxed);
+		return;
+	}
+
+	if (newFrame) {
+		const int stored = (_ecoHashCount < ECO_HASH_HISTORY) ? _ecoHashCount : ECO_HASH_HISTORY;
+		int known = 0;
+		for (int i = 0; i < stored && !known; i++)
+			known = (_ecoHashes[i] == g_raw_dmd_hash);
+		if (known)
+			_ecoKnownFrames++;
+		else {
+			// something new is shown: back to full rate until the loop is recognized again
+			_ecoHashes[_ecoHashCount++ % ECO_HASH_HISTORY] = g_raw_dmd_hash;
+			_ecoKnownFrames = 0;
+		}
+	}
+
+	_ecoActive.store(now - _ecoLastActivity >= idleTime && _ecoKnownFrames >= ECO_LOOP_FRAMES, std::memory_order_relaxed);
+}
+
+/******************************************************
+ * libpinmame_update_display
+ ******************************************************/
+
+extern "C" void libpinmame_update_display(const int index, const struct core_dispLayout* p_layout, void* p_data)
+{
+	PinmameDisplay* pDisplay = nullptr;
+
+	if (_displays.size() < index + 1) {
+		pDisplay = new PinmameDisplay();
+
+		pDisplay->layout.type = (PINMAME_DISPLAY_TYPE)p_layout->type;
+		pDisplay->layout.top = p_layout->top;
+		pDisplay->layout.left = p_layout->left;
+
+		if (p_layout->type == CORE_VIDEO) {
+			pDisplay->layout.width = p_layout->length;
+			pDisplay->layout.height = p_layout->start;
+
+			switch (_videoFormatRunning) {
+				case PINMAME_VIDEO_FORMAT_RGBA8888:
+				case PINMAME_VIDEO_FORMAT_BGRA8888:
+					pDisplay->layout.depth = 32;
+					break;
+				case PINMAME_VIDEO_FORMAT_INDEXED16:
+					pDisplay->layout.depth = 16;
+					break;
+				default:
+					pDisplay->layout.depth = 24;
+					break;
+			}
+
+			pDisplay->size = pDisplay->layout.width * pDisplay->layout.height * (pDisplay->layout.depth / 8);
+		}
+		else if ((p_layout->type & CORE_DMD) == CORE_DMD) {
+			pDisplay->layout.width = p_layout->length;
+			pDisplay->layout.height = p_layout->start;
+
+			if (p_layout->type & CORE_DMDSEG)
+				pDisplay->layout.depth = 2;
+			else if (_dmdColorRunning)
+				pDisplay->layout.depth = 32;
+			else
+				pDisplay->layout.depth = core_dmd_bitplane_depth();
+
+			pDisplay->size = pDisplay->layout.width * pDisplay->layout.height * (pDisplay->layout.depth == 32 ? 4 : 1);
+		}
+		else {
+			pDisplay->layout.length = p_layout->length;
+
+			pDisplay->size = pDisplay->layout.length * sizeof(UINT16);
+		}
+
+		for (int i = 0; i < DISPLAY_FRAME_BUFFERS; i++)
+			pDisplay->pFrameData[i] = AllocFrameBuffer(pDisplay->size);
+
+		pDisplay->frontFrame = 0;
+		pDisplay->middleFrame = 1;
+		pDisplay->backFrame = 2;
+		pDisplay->lastFrame = 0;
+
+		if (p_data && IsPinmameDisplayFrameMismatch(pDisplay, p_data))
+			p_data = nullptr;
+
+		if (p_data) {
+			uint64_t hash = 0;
+			uint64_t dirtyRows = 0;
+
+			if (pDisplay->layout.type == CORE_VIDEO)
+				UpdatePinmameDisplayBitmap(pDisplay, (mame_bitmap*)p_data);
+			else
+				memcpy(pDisplay->pFrameData[pDisplay->backFrame], p_data, pDisplay->size);
+
+			if (p_data == g_raw_dmdbuffer || p_data == g_raw_colordmdbuffer) {
+				hash = g_raw_dmd_hash;
+				dirtyRows = ~0ull;
+				g_raw_dmd_dirty_rows = 0;
+			}
+
+			PublishPinmameDisplayFrame(pDisplay, hash, dirtyRows);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(_displaysMutex);
+			_displays.push_back(pDisplay);
+		}
+
+		if (!_p_Config->cb_OnDisplayAvailable)
+			return;
+
+		const int displayCount = GetDisplayCount();
+		(*(_p_Config->cb_OnDisplayAvailable))(index, displayCount, &pDisplay->layout, _p_userData);
+	}
+	else {
+		pDisplay = _displays[index];
+
+		if (index == 0)
+			_emulatedTime.store(timer_get_time(), std::memory_order_relaxed);
+
+		// p_data is null when the core already knows the frame did not change (DMD frame index unchanged)
+		int changed = 0;
+
+		if (p_data && IsPinmameDisplayFrameMismatch(pDisplay, p_data))
+			p_data = nullptr;
+
+		if (p_data == g_raw_dmdbuffer || p_data == g_raw_colordmdbuffer) {
+			// Main DMD frames are only passed when they changed, with their hash and changed rows computed by the core
+			memcpy(pDisplay->pFrameData[pDisplay->backFrame], p_data, pDisplay->size);
+			PublishPinmameDisplayFrame(pDisplay, g_raw_dmd_hash, g_raw_dmd_dirty_rows);
+			g_raw_dmd_dirty_rows = 0;
+			changed = 1;
+		}
+		else if (p_data != nullptr) {
+			if (pDisplay->layout.type == CORE_VIDEO)
+				changed = UpdatePinmameDisplayBitmap(pDisplay, (mame_bitmap*)p_data);
+			else if (memcmp(pDisplay->pFrameData[pDisplay->lastFrame], p_data, pDisplay->size)) {
+				memcpy(pDisplay->pFrameData[pDisplay->backFrame], p_data, pDisplay->size);
+				changed = 1;
+			}
+
+			if (changed)
+				PublishPinmameDisplayFrame(pDisplay, 0, 0);
+		}
+
+		if (changed && _replayMode.load(std::memory_order_relaxed) != PINMAME_REPLAY_MODE_NONE)
+			_replayDisplayCrc = crc32(_replayDisplayCrc, (const Bytef*)pDisplay->pFrameData[pDisplay->lastFrame], (uInt)pDisplay->size);
+
+		if (index == 0)
+			UpdateEcoMode(changed && (p_data == g_raw_dmdbuffer || p_data == g_raw_colordmdbuffer));
+
+		if (!_p_Config->cb_OnDisplayUpdated)
+			return;
+
+		const int decimation = (_speedMode == PINMAME_SPEED_MODE_UNTHROTTLED) ? _frameDecimation
+			: _ecoActive.load(std::memory_order_relaxed) ? _ecoDecimation.load(std::memory_order_relaxed) : 1;
+		if (decimation > 1) {
+			pDisplay->pendingUpdate |= changed;
+			if ((cpu_getcurrentframe() % decimation) != 0)
+				return;
+			changed = pDisplay->pendingUpdate;
+		}
+		pDisplay->pendingUpdate = 0;
+
+		if (changed)
+			core_latencyStop(CORE_LATENCY_DMD, -1);
+
+		(*(_p_Config->cb_OnDisplayUpdated))(index, changed ? pDisplay->pFrameData[pDisplay->lastFrame] : nullptr, &pDisplay->layout, _p_userData);
+	}
+}
+
+/******************************************************
+ * libpinmame_snd_cmd_log
+ ******************************************************/
+
+extern "C" void libpinmame_snd_cmd_log(int boardNo, int cmd)
+{
+	if (!_p_Config->cb_OnSoundCommand)
+		return;
+
+	(*(_p_Config->cb_OnSoundCommand))(boardNo, cmd, _p_userData);
+}
+
+/******************************************************
+ * libpinmame_forward_console_data
+ ******************************************************/
+
+extern "C" void libpinmame_forward_console_data(void* p_data, int size)
+{
+	if (!_p_Config->cb_OnConsoleDataUpdated)
+		return;
+
+	(*(_p_Config->cb_OnConsoleDataUpdated))(p_data, size, _p_userData);
+}
+
+/******************************************************
+ * libpinmame_nodebus_mode
+ ******************************************************/
+
+extern "C" int libpinmame_nodebus_mode()
+{
+	return _nodeBusMode;
+}
+
+/******************************************************
+ * libpinmame_nodebus_flush
+ *
+ * Delivers the staged node bus messages to the host.
+ ******************************************************/
+
+extern "C" void libpinmame_nodebus_flush()
+{
+	if (_nodeBusMessages.empty())
+		return;
+
+	PinmameOnNodeBusMessagesCallback callback = _nodeBusCallback;
+	if (callback) {
+		for (PinmameNodeBusMessage& message : _nodeBusMessages)
+			message.p_data = _nodeBusData.data() + (size_t)message.p_data;
+		(*callback)(_nodeBusMessages.data(), (int)_nodeBusMessages.size(), _p_userData);
+	}
+
+	_nodeBusMessages.clear();
+	_nodeBusData.clear();
+}
+
+/******************************************************
+ * libpinmame_nodebus_message
+ ******************************************************/
+
+extern "C" void libpinmame_nodebus_message(int channel, const UINT8* p_data, int size)
+{
+	if (_nodeBusData.size() + size > NODEBUS_STAGE_SIZE)
+		libpinmame_nodebus_flush();
+
+	_nodeBusMessages.push_back({ timer_get_time(), (PINMAME_NODEBUS_CHANNEL)channel, size, (const uint8_t*)_nodeBusData.size() });
+	_nodeBusData.insert(_nodeBusData.end(), p_data, p_data + size);
+}
+
+/******************************************************
+ * libpinmame_nodebus_response
+ *
+ * Copies up to maxSize queued response bytes, without removing them (see
+ * libpinmame_nodebus_response_sent).
+ ******************************************************/
+
+extern "C" int libpinmame_nodebus_response(UINT8* p_data, int maxSize)
+{
+	std::lock_guard<std::mutex> lock(_nodeBusResponseMutex);
+
+	const int size = std::min(maxSize, (int)_nodeBusResponses.size());
+	std::copy(_nodeBusResponses.begin(), _nodeBusResponses.begin() + size, p_data);
+
+	return size;
+}
+
+/******************************************************
+ * libpinmame_nodebus_response_sent
+ ******************************************************/
+
+extern "C" void libpinmame_nodebus_response_sent(int size)
+{
+	std::lock_guard<std::mutex> lock(_nodeBusResponseMutex);
+	_nodeBusResponses.erase(_nodeBusResponses.begin(), _nodeBusResponses.begin() + size);
+}
+
+/******************************************************
+ * OnStateChange
+ ******************************************************/
+
+extern "C" void OnStateChange(const int state)
+{
+	_isRunning = state;
+
+	if (!_p_Config->cb_OnStateUpdated)
+		return;
+
+	(*(_p_Config->cb_OnStateUpdated))(state, _p_userData);
+}
+
+/******************************************************
+ * OnSolenoid
+ ******************************************************/
+
+extern "C" void OnSolenoid(const int solenoid, const int state)
+{
+	if (_outputPushRunning && solenoid >= 1 && solenoid <= 64
+	    && (_outputPushImmediate.load(std::memory_order_relaxed) & (1ull << (solenoid - 1))))
+		_outputPushUrgent = 1;
+
+	if (!_p_Config->cb_OnSolenoidUpdated)
+		return;
+
+	PinmameSolenoidState solenoidState;
+	solenoidState.solNo = solenoid;
+	solenoidState.state = state;
+
+	(*(_p_Config->cb_OnSolenoidUpdated))(&solenoidState, _p_userData);
+}
+
+/******************************************************
+ * libpinmame_log_info
+ ******************************************************/
+
+extern "C" void libpinmame_log_info(const char* format, ...)
+{
+	if (!_p_Config->cb_OnLogMessage)
+		return;
+
+	va_list args;
+	va_start(args, format);
+	(*(_p_Config->cb_OnLogMessage))(PINMAME_LOG_LEVEL_INFO, format, args, _p_userData);
+	va_end(args);
+}
+
+/******************************************************
+ * libpinmame_log_error
+ ******************************************************/
+
+extern "C" void libpinmame_log_error(const char* format, ...)
+{
+	if (!_p_Config->cb_OnLogMessage)
+		return;
+
+	va_list args;
+	va_start(args, format);
+	(*(_p_Config->cb_OnLogMessage))(PINMAME_LOG_LEVEL_ERROR, format, args, _p_userData);
+	va_end(args);
+}
+
+/******************************************************
+ * libpinmame_update_mech
+ ******************************************************/
+
+extern "C" void libpinmame_update_mech(const int mechNo, mech_tMechData* p_mechData)
+{
+	int speed = p_mechData->speed / p_mechData->ret;
+
+	if (_mechInit[mechNo]) {
+		if (_mechInfo[mechNo].pos != p_mechData->pos || _mechInfo[mechNo].speed != speed) {
+			_mechInfo[mechNo].pos = p_mechData->pos;
+			_mechInfo[mechNo].speed = speed;
+
+			if (!_p_Config->cb_OnMechUpdated)
+				return;
+
+			if (g_fHandleMechanics == 0)
+				(*(_p_Config->cb_OnMechUpdated))(mechNo - (MECH_MAXMECH / 2) + 1, &_mechInfo[mechNo], _p_userData);
+			else
+				(*(_p_Config->cb_OnMechUpdated))(mechNo, &_mechInfo[mechNo], _p_userData);
+		}
+	}
+	else {
+		_mechInit[mechNo] = 1;
+
+		_mechInfo[mechNo].type = p_mechData->type;
+		_mechInfo[mechNo].length = p_mechData->length;
+		_mechInfo[mechNo].steps = p_mechData->steps;
+		
+		_mechInfo[mechNo].pos = p_mechData->pos;
+		_mechInfo[mechNo].speed = speed;
+
+		if (!_p_Config->cb_OnMechAvailable)
+			return;
+
+		if (g_fHandleMechanics == 0)
+			(*(_p_Config->cb_OnMechAvailable))(mechNo - (MECH_MAXMECH / 2) + 1, &_mechInfo[mechNo], _p_userData);
+		else
+			(*(_p_Config->cb_OnMechAvailable))(mechNo, &_mechInfo[mechNo], _p_userData);
+	}
+}
+
+/******************************************************
+ * StartGame
+ ******************************************************/
+
+int StartGame(const int gameNum)
+{
+	int err;
+
+	memset(_mechInit, 0, sizeof(_mechInit));
+	memset(_mechInfo, 0, sizeof(_mechInfo));
+
+	_warmStartChecked = 0;
+	_warmStartPending = 0;
+	_timerProfilingApplied = 0;
+	_timerStatsTime = 0.;
+	{
+		std::lock_guard<std::mutex> lock(_timerStatsMutex);
+		_timerStats.clear();
+		_audioStreamStats.clear();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_profilerMutex);
+		_profilerPending = !_profilerTraceFile.empty() || !_profilerCsvFile.empty();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_replayMutex);
+		memset(&_replayStatus, 0, sizeof(_replayStatus));
+		_replayStatus.mode = _replayRequested;
+		_replayInputs.clear();
+	}
+	_replayStarted = 0;
+	_replayHasLine = 0;
+	_replayDisplayCrc = crc32(0L, Z_NULL, 0);
+	_replayAudioCrc = crc32(0L, Z_NULL, 0);
+	_replayPendingEvents.clear();
+	_replayMode = _replayRequested;
+
+	GoldenOpen(drivers[gameNum]->name);
+
+	if (_replayRequested != PINMAME_REPLAY_MODE_NONE || _goldenMode != PINMAME_GOLDEN_MODE_NONE)
+		srand(0); // the core fills RAM with rand() at startup
+
+	{
+		std::lock_guard<std::mutex> lock(_cpuTraceMutex);
+		libpinmame_cpu_trace_mask = _cpuTracePath.empty() ? 0 : (int)_cpuTraceRequestedMask;
+	}
+
+	_pcSamplingApplied = _pcSamplingInterval;
+	cpu_set_pc_sampling(_pcSamplingApplied);
+	_autoInterleaveApplied = _autoInterleave;
+	cpu_set_auto_interleave(_autoInterleaveApplied);
+	_interleaveSlices = 0;
+	_interleaveAverage = 0.;
+
+	OutputPushStart();
+
+	err = run_game(gameNum);
+
+	OutputPushStop();
+	MemoryWatchStop();
+	ReplayStop();
+	GoldenStop();
+
+	WritePcSamplingReport();
+	cpu_set_pc_sampling(0.);
+
+	libpinmame_cpu_trace_mask = 0;
+	if (_p_cpuTraceFile) {
+		fclose(_p_cpuTraceFile);
+		_p_cpuTraceFile = nullptr;
+	}
+
+	OnStateChange(0);
+
+	{
+		// release a host still waiting for a state request
+		std::lock_guard<std::mutex> lock(_stateMutex);
+		if (_stateRequest != STATE_REQUEST_NONE) {
+			_stateStatus = PINMAME_STATUS_EMULATOR_NOT_RUNNING;
+			_stateRequest = STATE_REQUEST_NONE;
+			_stateDone.notify_all();
+		}
+	}
+
+	ResetRewind();
+	libpinmame_stop_nvram_autosave();
+
+	// write the trace and close the CSV file
+	profiler_set_trace(NULL);
+	profiler_set_csv(NULL, 0.);
+	profiler_set_totals(0);
+
+	return err;
+}
+
+/******************************************************
+ * FillGame
+ ******************************************************/
+
+static void FillGame(PinmameGame* const p_game, const int gameNum, const int checkRoms)
+{
+	memset(p_game, 0, sizeof(PinmameGame));
+
+	p_game->name = drivers[gameNum]->name;
+	if (drivers[gameNum]->clone_of)
+		p_game->clone_of = drivers[gameNum]->clone_of->name;
+	p_game->description = drivers[gameNum]->description;
+	p_game->year = drivers[gameNum]->year;
+	p_game->manufacturer = drivers[gameNum]->manufacturer;
+	p_game->flags = drivers[gameNum]->flags;
+	p_game->found = checkRoms ? (RomsetMissing(gameNum) == 0) : -1;
+}
+
+/******************************************************
+ * PinmameGetGame
+ ******************************************************/
+
+PINMAMEAPI PINMAME_STATUS PinmameGetGame(const char* const p_name, PinmameGameCallback callback, const void* p_userData)
+{
+	if (!_p_Config)
+		return PINMAME_STATUS_CONFIG_NOT_SET;
+
+	int gameNum = GetGameNumFromString(p_name);
+
+	if (gameNum < 0)
+		return PINMAME_STATUS_GAME_NOT_FOUND;
+
+	PinmameGame game;
+	FillGame(&game, gameNum, 1);
+
+	if (callback)
+		(*callback)(&game, p_userData);
+
+	return PINMAME_STATUS_OK;
+}
+
+/******************************************************
+ * PinmameGetGames
+ ******************************************************/
+
+PINMAMEAPI PINMAME_STATUS PinmameGetGames(PinmameGameCallback callback, const void* p_userData)
+{
+	if (!_p_Config)
+		return PINMAME_STATUS_CONFIG_NOT_SET;
+
+	int gameNum = 0;
+
+	while (drivers[gameNum]) {
+		PinmameGame game;
+		FillGame(&game, gameNum, 1);
+
+		if (callback)
+			(*callback)(&game, p_userData);
+
+		gameNum++;
+	}
+
+	return PINMAME_STATUS_OK;
+}
+
+/******************************************************
+ * PinmameGetGameList
+ *
+ * Fills up to maxGames entries of p_games in drivers[] order and returns
+ * the total number of games (only the count if p_games is NULL). The
+ * strings are static. found is only checked when checkRoms is set (like
+ * PinmameGetGames), -1 otherwise.
+ ******************************************************/
+
+PINMAMEAPI int PinmameGetGameList(PinmameGame* const p_games, const int maxGames, const int checkRoms)
+{
+	int gameNum = 0;
+
+	while (drivers[gameNum]) {
+		if (p_games && gameNum < maxGames)
+			FillGame(&p_games[gameNum], gameNum, checkRoms);
+		gameNum++;
+	}
+
+	return gameNum;
+}
+
+/******************************************************
+ * PinmameGetClones
+ *
+ * Fills up to maxClones game names of the clones of p_name and returns
+ * their number, or -1 if the game doesn't exist.
+ ******************************************************/
+
+PINMAMEAPI int PinmameGetClones(const char* const p_name, const char** const pp_clones, const int maxClones)
+{
+	const int gameNum = GetGameNumFromString(p_name);
+
+	if (gameNum < 0)
+		return -1;
+
+	int count = 0;
+	for (int clone = driver_get_first_clone(gameNum); clone >= 0; clone = driver_get_next_clone(clone)) {
+		if (pp_clones && count < maxClones)
+			pp_clones[count] = drivers[clone]->name;
+		count++;
+	}
+
+	return count;
+}
+
+/******************************************************
+ * PinmameGetGameRoms
+ *
+ * Fills up to maxRoms entries with the ROM files of p_name, straight from
+ * the compiled-in ROM definitions (no -listxml round trip), and returns
+ * their number, or -1 if the game doesn't exist.
+ ******************************************************/
+
+PINMAMEAPI int PinmameGetGameRoms(const char* const p_name, PinmameRom* const p_roms, const int maxRoms)
+{
+	const int gameNum = GetGameNumFromString(p_name);
+
+	if (gameNum < 0)
+		return -1;
+
+	int count = 0;
+	for (const struct RomModule* region = rom_first_region(drivers[gameNum]); region; region = rom_next_region(region)) {
+		for (const struct RomModule* rom = rom_first_file(region); rom; rom = rom_next_file(rom)) {
+			if (p_roms && count < maxRoms) {
+				PinmameRom* const p_rom = &p_roms[count];
+				memset(p_rom, 0, sizeof(PinmameRom));
+
+				p_rom->name = ROM_GETNAME(rom);
+				for (const struct RomModule* chunk = rom_first_chunk(rom); chunk; chunk = rom_next_chunk(chunk))
+					p_rom->length += ROM_GETLENGTH(chunk);
+				if (!ROM_NOGOODDUMP(rom)) {
+					hash_data_extract_printable_checksum(ROM_GETHASHDATA(rom), HASH_CRC, p_rom->crc);
+					hash_data_extract_printable_checksum(ROM_GETHASHDATA(rom), HASH_SHA1, p_rom->sha1);
+				}
+				p_rom->optional = ROM_ISOPTIONAL(rom) ? 1 : 0;
+			}
+			count++;
+		}
+	}
+
+	return count;
+}
+
+/******************************************************
+ * PinmameAuditGames
+ ******************************************************/
+
+static void CLIB_DECL AuditNoPrintf(const char* fmt, ...)
+{
+}
+
+PINMAMEAPI PINMAME_STATUS PinmameAuditGames(const char* const* const pp_names, const int numNames, PinmameAuditCallback callback, const void* p_userData)
+{
+	if (!_p_Config)
+		return PINMAME_STATUS_CONFIG_NOT_SET;
+
+	if (_isRunning)
+		return PINMAME_STATUS_GAME_ALREADY_RUNNING;
+
+	std::vector<int> games;
+
+	if (pp_names) {
+		for (int i = 0; i < numNames; i++) {
+			const int gameNum = GetGameNumFromString(pp_names[i]);
+			if (gameNum < 0)
+				return PINMAME_STATUS_GAME_NOT_FOUND;
+			games.push_back(gameNum);
+		}
+	}
+	else {
+		for (int gameNum = 0; drivers[gameNum]; gameNum++) {
+			if (!(drivers[gameNum]->flags & NOT_A_DRIVER))
+				games.push_back(gameNum);
+		}
+	}
+
+	// Audit each parent right before its clones, so that the zips they share stay in the unzip cache
+	// (clone_of may also be a NOT_A_DRIVER container, which isn't a parent romset)
+	auto parentOf = [](const int gameNum) -> const struct GameDriver* {
+		const struct GameDriver* const parent = drivers[gameNum]->clone_of;
+		return (parent && !(parent->flags & NOT_A_DRIVER)) ? parent : NULL;
+	};
+	std::stable_sort(games.begin(), games.end(), [&parentOf](const int a, const int b) {
+		const struct GameDriver* const rootA = parentOf(a) ? parentOf(a) : drivers[a];
+		const struct GameDriver* const rootB = parentOf(b) ? parentOf(b) : drivers[b];
+		if (rootA != rootB)
+			return strcmp(rootA->name, rootB->name) < 0;
+		return (drivers[a] == rootA) && (drivers[b] != rootB);
+	});
+
+	for (size_t i = 0; i < games.size(); i++) {
+		const int gameNum = games[i];
+
+		PinmameAuditResult result;
+		memset(&result, 0, sizeof(PinmameAuditResult));
+
+		result.name = drivers[gameNum]->name;
+		if (parentOf(gameNum))
+			result.clone_of = parentOf(gameNum)->name;
+		result.status = (PINMAME_AUDIT_STATUS)VerifyRomSet(gameNum, AuditNoPrintf);
+		result.index = (int)i;
+		result.count = (int)games.size();
+
+		if (callback)
+			(*callback)(&result, p_userData);
+	}
+
+	return PINMAME_STATUS_OK;
+}
+
+/******************************************************
+ * PinmameSetConfig
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetConfig(const PinmameConfig* const p_config)
+{
+	if (!_p_Config)
+		_p_Config = (PinmameConfig*)malloc(sizeof(PinmameConfig));
+
+	memcpy(_p_Config, p_config, sizeof(PinmameConfig));
+
+	libpinmame_log_info("PinmameSetConfig(): sampleRate=%d, vpmPath=%s", _p_Config->sampleRate, _p_Config->vpmPath);
+
+	memset(&options, 0, sizeof(options));
+
+	options.samplerate = _p_Config->sampleRate;
+	options.skip_gameinfo = 1;
+	options.skip_disclaimer = 1;
+	options.minimal_core = 1;
+
+	setPath(FILETYPE_ROM, ComposePath(_p_Config->vpmPath, "roms"));
+	setPath(FILETYPE_NVRAM, ComposePath(_p_Config->vpmPath, "nvram"));
+	setPath(FILETYPE_SAMPLE, ComposePath(_p_Config->vpmPath, "samples"));
+	setPath(FILETYPE_CONFIG, ComposePath(_p_Config->vpmPath, "cfg"));
+	setPath(FILETYPE_HIGHSCORE, ComposePath(_p_Config->vpmPath, "hi"));
+	setPath(FILETYPE_INPUTLOG, ComposePath(_p_Config->vpmPath, "inp"));
+	setPath(FILETYPE_MEMCARD, ComposePath(_p_Config->vpmPath, "memcard"));
+	setPath(FILETYPE_STATE, ComposePath(_p_Config->vpmPath, "sta"));
+
+	throttle = (_speedMode == PINMAME_SPEED_MODE_UNTHROTTLED) ? 0 : 1;
+	autoframeskip = 0;
+	allow_sleep = 1;
+
+	// build the game name index now, before several host threads look games up
+	driver_get_index("");
+}
+
+/******************************************************
+ * PinmameSetPath
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetPath(const PINMAME_FILE_TYPE fileType, const char* const p_path)
+{
+	if (!p_path)
+		return;
+
+	char* const newPath = (char*)malloc(strlen(p_path) + 1);
+	strcpy(newPath, p_path);
+
+	switch(fileType) {
+		case PINMAME_FILE_TYPE_ROMS:
+			setPath(FILETYPE_ROM, newPath);
+			break;
+		case PINMAME_FILE_TYPE_NVRAM:
+			setPath(FILETYPE_NVRAM, newPath);
+			break;
+		case PINMAME_FILE_TYPE_SAMPLES:
+			setPath(FILETYPE_SAMPLE, newPath);
+			break;
+		case PINMAME_FILE_TYPE_CONFIG:
+			setPath(FILETYPE_CONFIG, newPath);
+			break;
+		case PINMAME_FILE_TYPE_HIGHSCORE:
+			setPath(FILETYPE_HIGHSCORE, newPath);
+			break;
+	}
+}
+
+/******************************************************
+ * PinmameGetCheat
+ ******************************************************/
+
+PINMAMEAPI int PinmameGetCheat()
+{
+	return options.cheat;
+}
+
+/******************************************************
+ * PinmameSetCheat
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetCheat(const int cheat)
+{
+	options.cheat = cheat;
+}
+
+/******************************************************
+ * PinmameGetHandleKeyboard
+ ******************************************************/
+
+PINMAMEAPI int PinmameGetHandleKeyboard()
+{
+	return g_fHandleKeyboard;
+}
+
+/******************************************************
+ * PinmameSetHandleKeyboard
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetHandleKeyboard(const int handleKeyboard)
+{
+	g_fHandleKeyboard = handleKeyboard ? 1 : 0;
+}
+
+/******************************************************
+ * PinmameGetHandleMechanics
+ ******************************************************/
+
+PINMAMEAPI int PinmameGetHandleMechanics()
+{
+	return g_fHandleMechanics;
+}
+
+/******************************************************
+ * PinmameSetHandleMechanics
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetHandleMechanics(const int handleMechanics)
+{
+	g_fHandleMechanics = handleMechanics;
+}
+
+/******************************************************
+ * PinmameSetDmdMode
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetDmdMode(const PINMAME_DMD_MODE dmdMode)
+{
+	if (_isRunning && (dmdMode == PINMAME_DMD_MODE_COLOR) != _dmdColorRunning)
+		return;
+
+	g_fDmdMode = dmdMode;
+}
+
+/******************************************************
+ * PinmameAddDmdPaletteTrigger
+ *
+ * Colors of PINMAME_DMD_MODE_COLOR frames: once the main DMD
+ * bitplane frame (the PINMAME_DMD_MODE_RAW frame) has the given
+ * 64 bit FNV-1a hash, its shades are mapped to numColors (4 or 16)
+ * 0x00BBGGRR colors, until the frame of another trigger shows up.
+ * Before any trigger matched, colors come from the DMD options.
+ * Triggers can only be changed while no game is running.
+ ******************************************************/
+
+PINMAMEAPI PINMAME_STATUS PinmameAddDmdPaletteTrigger(const uint64_t bitplaneHash, const uint32_t* const p_colors, const int numColors)
+{
+	if (_isRunning)
+		return PINMAME_STATUS_GAME_ALREADY_RUNNING;
+
+	if (!p_colors || !core_dmd_add_palette_trigger(bitplaneHash, p_colors, numColors))
+		return PINMAME_STATUS_BUFFER_TOO_SMALL;
+
+	return PINMAME_STATUS_OK;
+}
+
+/******************************************************
+ * PinmameClearDmdPaletteTriggers
+ ******************************************************/
+
+PINMAMEAPI void PinmameClearDmdPaletteTriggers()
+{
+	if (!_isRunning)
+		core_dmd_clear_palette_triggers();
+}
+
+/******************************************************
+ * PinmameSetDmdOnDemand
+ *
+ * In on demand mode, PWM integrated DMDs (WPC, Data East, Sega/Stern
+ * Whitestar, GTS3 and Alvin G.) are only evaluated when
+ * PinmameGetDmdFrame is called, for example at the host display
+ * refresh, and their display frames are not published anymore.
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetDmdOnDemand(const int onDemand)
+{
+	core_dmd_set_on_demand(onDemand);
+}
+
+/******************************************************
+ * PinmameGetDmdFrame
+ *
+ * Evaluates the luminance (0..255) and bitplane frames of DMD dmdIndex
+ * (0, or 1 for the second DMD of Strikes N' Spares) from its last raw
+ * frames, into buffers of at least width * height bytes. To be called
+ * from one thread at a time. Returns width * height, or 0 if no game is
+ * running or the DMD does not exist or is not PWM integrated.
+ ******************************************************/
+
+PINMAMEAPI int PinmameGetDmdFrame(const int dmdIndex, uint8_t* const p_luminance, uint8_t* const p_bitplane, const int size)
+{
+	if (!_isRunning || !p_luminance || !p_bitplane)
+		return 0;
+
+	return core_dmd_evaluate_pwm(dmdIndex, p_luminance, p_bitplane, size);
+}
+
+/******************************************************
+ * PinmameGetDmdMode
+ ******************************************************/
+
+PINMAMEAPI PINMAME_DMD_MODE PinmameGetDmdMode()
+{
+	return g_fDmdMode;
+}
+
+/******************************************************
+ * PinmameSetVideoFormat
+ *
+ * Pixel format of the video display frames, applied when the next game
+ * starts. Frames are only converted when the bitmap or the palette
+ * changed.
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetVideoFormat(const PINMAME_VIDEO_FORMAT videoFormat)
+{
+	_videoFormat = videoFormat;
+}
+
+/******************************************************
+ * PinmameGetVideoFormat
+ ******************************************************/
+
+PINMAMEAPI PINMAME_VIDEO_FORMAT PinmameGetVideoFormat()
+{
+	return _videoFormat;
+}
+
+/******************************************************
+ * PinmameGetVideoPalette
+ *
+ * Copies up to maxColors RGBA8888 colors of the pens used by
+ * PINMAME_VIDEO_FORMAT_INDEXED16 frames, as of the last frame published.
+ * Returns the number of pens, 0 before the first frame, or -1 if no game
+ * is running.
+ ******************************************************/
+
+PINMAMEAPI int PinmameGetVideoPalette(uint32_t* const p_palette, const int maxColors)
+{
+	if (!_isRunning)
+		return -1;
+
+	std::lock_guard<std::mutex> lock(_videoPaletteMutex);
+	const int colors = (int)_videoPalette.size();
+	if (p_palette && maxColors > 0)
+		memcpy(p_palette, _videoPalette.data(), sizeof(uint32_t) * (maxColors < colors ? maxColors : colors));
+
+	return colors;
+}
+
+/******************************************************
+ * PinmameGetSoundMode
+ ******************************************************/
+
+PINMAMEAPI PINMAME_SOUND_MODE PinmameGetSoundMode()
+{
+	return g_fSoundMode;
+}
+
+/******************************************************
+ * PinmameSetSoundMode
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetSoundMode(const PINMAME_SOUND_MODE soundMode)
+{
+	g_fSoundMode = soundMode;
+}
+
+/******************************************************
+ * PinmameGetSpeedMode
+ ******************************************************/
+
+PINMAMEAPI PINMAME_SPEED_MODE PinmameGetSpeedMode()
+{
+	return _speedMode;
+}
+
+/******************************************************
+ * PinmameSetSpeedMode
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetSpeedMode(const PINMAME_SPEED_MODE speedMode, const int frameDecimation)
+{
+	_frameDecimation = frameDecimation < 1 ? 1 : frameDecimation;
+	_speedMode = speedMode;
+
+	throttle = (speedMode == PINMAME_SPEED_MODE_UNTHROTTLED) ? 0 : 1;
+}
+
+/******************************************************
+ * PinmameSetEcoMode
+ *
+ * Lowers the display callback rate to one every frameDecimation frames
+ * once no switch changed for idleSeconds and the main DMD only cycles
+ * through frames already shown (attract mode). The emulation itself
+ * keeps running at full rate and any switch change or new DMD frame
+ * restores the full callback rate. 0 idleSeconds disables it (default).
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetEcoMode(const int idleSeconds, const int frameDecimation)
+{
+	_ecoDecimation = frameDecimation < 1 ? 1 : frameDecimation;
+	_ecoIdleTime = idleSeconds < 0 ? 0. : (double)idleSeconds;
+	_ecoActivity = 1;
+}
+
+/******************************************************
+ * PinmameIsEcoActive
+ ******************************************************/
+
+PINMAMEAPI int PinmameIsEcoActive()
+{
+	return _isRunning ? _ecoActive.load(std::memory_order_relaxed) : 0;
+}
+
+/******************************************************
+ * PinmameSetAudioChannels
+ *
+ * Channel layout of the audio stream: 1 mixes stereo games down to
+ * mono (in the mixer, saving the right channel resampling), 2 plays
+ * mono games on a stereo stream, 0 follows the game (default). The
+ * sample rate is set by PinmameConfig.sampleRate, which the mixer
+ * resamples every sound chip to directly: pass the device rate to
+ * avoid resampling again on the host. Applied when the next game starts.
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetAudioChannels(const int channels)
+{
+	_audioChannels = (channels == 1 || channels == 2) ? channels : 0;
+	mixer_set_output_channels(_audioChannels);
+}
+
+/******************************************************
+ * PinmameSetThreadScheduling
+ *
+ * CPU affinity and scheduling class of a PinMAME thread, applied
+ * when the thread starts (the next game for the emulation thread).
+ * affinityMask 0 leaves the thread to the OS scheduler, it is not
+ * supported on macOS. realtimePriority 0 keeps the normal scheduling,
+ * otherwise the thread runs SCHED_FIFO with this priority (needs the
+ * privileges for it), or is registered to MMCSS "Pro Audio" on
+ * Windows. The threads are named for profilers and debuggers.
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetThreadScheduling(const PINMAME_THREAD thread, const uint64_t affinityMask, const int realtimePriority)
+{
+	threadsched_config((int)thread, affinityMask, realtimePriority);
+}
+
+/******************************************************
+ * PinmameSetRomShareDir
+ *
+ * Directory of the ROM region cache, NULL or "" to disable it (the
+ * default). Applied when the next game starts: its ROM regions are
+ * then mapped copy on write from files named by the SHA1 of their
+ * contents, so the instances and clones running the same ROM images
+ * share their memory. The directory must exist and be writable.
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetRomShareDir(const char* const p_path)
+{
+	romshare_config(p_path);
+}
+
+/******************************************************
+ * PinmameGetEmulationSpeed
+ ******************************************************/
+
+PINMAMEAPI double PinmameGetEmulationSpeed()
+{
+	if (!_isRunning)
+		return 0.;
+
+	// Emulated seconds per wall clock second since the previous call
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	const double emulatedTime = _emulatedTime.load(std::memory_order_relaxed);
+	const double wallTime = std::chrono::duration<double>(now - _lastSpeedWallTime).count();
+
+	if (wallTime <= 0.)
+		return 0.;
+
+	const double speed = (emulatedTime - _lastSpeedEmulatedTime) / wallTime;
+
+	_lastSpeedEmulatedTime = emulatedTime;
+	_lastSpeedWallTime = now;
+
+	return speed;
+}
+
+/******************************************************
+ * PinmameSetSpeedGovernor
+ *
+ * When the emulation falls behind real time, lowers the accuracy step
+ * by step, up to maxLevel (0 disables the governor, 4 is the highest):
+ *   1: coarser CPU interleave boosts
+ *   2: shorter DMD PWM low pass filter
+ *   3: linear audio resampling
+ *   4: internal DMD window rendered every other frame (no effect here)
+ * Each step is undone again once the emulation keeps up. Changes are
+ * logged and can be applied while a game is running.
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetSpeedGovernor(const int maxLevel)
+{
+	g_speed_governor = (maxLevel < 0) ? 0 : (maxLevel > CORE_GOVERNOR_MAXLEVEL) ? CORE_GOVERNOR_MAXLEVEL : maxLevel;
+}
+
+/******************************************************
+ * PinmameGetSpeedGovernorLevel
+ *
+ * Returns the level currently selected by the speed governor, 0 if it
+ * is disabled, did not need to step in or if no game is running.
+ ******************************************************/
+
+PINMAMEAPI int PinmameGetSpeedGovernorLevel()
+{
+	return _isRunning ? core_governorLevel() : 0;
+}
+
+/******************************************************
+ * PinmameSetOutputExport
+ *
+ * Streams the changes of the solenoids, lamps, GI and alphanumeric
+ * segments to one local client, rate times per emulated second, over
+ * a named pipe on Windows or a Unix domain socket elsewhere (see
+ * outexport.h for the protocol). A NULL or empty endpoint disables it.
+ * Applied when the next game starts.
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetOutputExport(const char* const p_endpoint, const int rate)
+{
+	static std::string endpoint;
+
+	endpoint = p_endpoint ? p_endpoint : "";
+	g_output_export = endpoint.empty() ? NULL : (char*)endpoint.c_str();
+	g_output_export_rate = rate;
+}
+
+/******************************************************
+ * PinmameSetNetPublish
+ *
+ * Streams the main DMD frames (changed rows only) and the output
+ * changes as UDP datagrams to p_endpoint, "address:port" of a
+ * multicast group or of one receiver, at most dmdRate and outputRate
+ * times per emulated second (see netpub.h for the protocol). raw sends
+ * the raw DMD shades instead of the luminance. A NULL or empty
+ * endpoint disables it. Applied when the next game starts.
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetNetPublish(const char* const p_endpoint, const int dmdRate, const int outputRate, const int raw)
+{
+	static std::string endpoint;
+
+	endpoint = p_endpoint ? p_endpoint : "";
+	g_net_publish = endpoint.empty() ? NULL : (char*)endpoint.c_str();
+	g_net_publish_dmd_rate = dmdRate;
+	g_net_publish_output_rate = outputRate;
+	g_net_publish_raw = raw ? 1 : 0;
+}
+
+/******************************************************
+ * PinmameGetCpuStats
+ *
+ * Fills up to maxCpus entries and returns the number of CPUs of the
+ * running game, or -1 if no game is running.
+ ******************************************************/
+
+PINMAMEAPI int PinmameGetCpuStats(PinmameCpuStats* const p_stats, const int maxCpus)
+{
+	if (!_isRunning)
+		return -1;
+
+	const int cpuCount = _cpuCount.load(std::memory_order_acquire);
+	for (int i = 0; i < cpuCount && i < maxCpus; i++) {
+		p_stats[i].name = cputype_name(Machine->drv->cpu[i].cpu_type);
+		p_stats[i].clock = (int32_t)Machine->drv->cpu[i].cpu_clock;
+		p_stats[i].cycles = _cpuCycles[i].load(std::memory_order_relaxed);
+	}
+
+	return cpuCount;
+}
+
+/******************************************************
+ * WakePause
+ ******************************************************/
+
+static void WakePause()
+{
+	std::lock_guard<std::mutex> lock(_pauseMutex);
+	_pauseCond.notify_all();
+}
+
+/******************************************************
+ * PrepareRun
+ ******************************************************/
+
+static void PrepareRun()
+{
+	vp_init();
+
+	_emulatedTime = 0.;
+	_cpuCount = 0;
+	_lastSpeedEmulatedTime = 0.;
+	_outputSequence = 0;
+	_switchEventRead = 0;
+	_switchEventWrite = 0;
+	_nodeBusMessages.clear();
+	_nodeBusData.clear();
+	{
+		std::lock_guard<std::mutex> lock(_nodeBusResponseMutex);
+		_nodeBusResponses.clear();
+	}
+	_videoFormatRunning = _videoFormat;
+	_dmdColorRunning = (g_fDmdMode == PINMAME_DMD_MODE_COLOR);
+	{
+		std::lock_guard<std::mutex> lock(_videoPaletteMutex);
+		_videoPalette.clear();
+	}
+	_lastSpeedWallTime = std::chrono::steady_clock::now();
+}
+
+/******************************************************
+ * GameThread
+ *
+ * Runs the game, then the ones requested by PinmameSwitchGame, on the
+ * same thread until PinmameStop.
+ ******************************************************/
+
+static void GameThread(int gameNum)
+{
+	threadsched_apply(THREADSCHED_EMULATION);
+
+	for (;;) {
+		StartGame(gameNum);
+
+		{
+			std::lock_guard<std::mutex> lock(_switchMutex);
+			gameNum = _nextGameNum;
+			_nextGameNum = -1;
+			if (gameNum < 0) {
+				_gameThreadActive = 0;
+				break;
+			}
+			_timeToQuit = 0;
+		}
+
+		FreeDisplays(1);
+		PrepareRun();
+		_warmSwitch = 1;
+	}
+
+	_warmSwitch = 0;
+}
+
+/******************************************************
+ * PinmameRun
+ ******************************************************/
+
+PINMAMEAPI PINMAME_STATUS PinmameRun(const char* const p_name)
+{
+	if (!_p_Config)
+		return PINMAME_STATUS_CONFIG_NOT_SET;
+
+	if (_isRunning)
+		return PINMAME_STATUS_GAME_ALREADY_RUNNING;
+
+	const int gameNum = GetGameNumFromString(p_name);
+
+	if (gameNum < 0)
+		return PINMAME_STATUS_GAME_NOT_FOUND;
+
+	PrepareRun();
+
+	_gameThreadActive = 1;
+	_p_gameThread = new std::thread(GameThread, gameNum);
+
+	return PINMAME_STATUS_OK;
+}
+
+/******************************************************
+ * PinmameSwitchGame
+ *
+ * Stops the running game and starts the given one without a full
+ * teardown: the emulation thread, the host audio stream (if the new
+ * game uses the same format), the display frame buffers of the same
+ * size and the zip and ROM hash caches are kept. Display, state and
+ * audio callbacks are called for the new game as after PinmameRun.
+ * Starts the game like PinmameRun if none is running.
+ ******************************************************/
+
+PINMAMEAPI PINMAME_STATUS PinmameSwitchGame(const char* const p_name)
+{
+	if (!_p_Config)
+		return PINMAME_STATUS_CONFIG_NOT_SET;
+
+	const int gameNum = GetGameNumFromString(p_name);
+
+	if (gameNum < 0)
+		return PINMAME_STATUS_GAME_NOT_FOUND;
+
+	{
+		std::lock_guard<std::mutex> lock(_switchMutex);
+		if (_p_gameThread && _gameThreadActive) {
+			_nextGameNum = gameNum;
+			g_fPause = 0;
+			_timeToQuit = 1;
+			WakePause();
+			return PINMAME_STATUS_OK;
+		}
+	}
+
+	// no game or the last one ended on its own: cold start
+	PinmameStop();
+	return PinmameRun(p_name);
+}
+
+/******************************************************
+ * PinmameIsRunning
+ ******************************************************/
+
+PINMAMEAPI int PinmameIsRunning()
+{
+	return _isRunning;
+}
+
+/******************************************************
+ * PinmameReset
+ ******************************************************/
+
+PINMAMEAPI PINMAME_STATUS PinmameReset()
+{
+	if (!_isRunning)
+		return PINMAME_STATUS_EMULATOR_NOT_RUNNING;
+
+	machine_reset();
+
+	return PINMAME_STATUS_OK;
+}
+
+/******************************************************
+ * libpinmame_wait_pause
+ *
+ * Called by the paused emulation thread instead of refreshing the
+ * screen: sleeps until resumed, stopped or asked for a state request
+ * (the timeout keeps the pause key polled).
+ ******************************************************/
+
+extern "C" void libpinmame_wait_pause(void)
+{
+	std::unique_lock<std::mutex> lock(_pauseMutex);
+	_pauseCond.wait_for(lock, std::chrono::milliseconds(100), [] { return !g_fPause || _stateRequest != STATE_REQUEST_NONE; });
+}
+
+/******************************************************
+ * PinmamePause
+ *
+ * While paused, the emulation thread blocks and no longer renders or
+ * calls the display and audio callbacks.
+ ******************************************************/
+
+PINMAMEAPI PINMAME_STATUS PinmamePause(const int pause)
+{
+	if (!_isRunning)
+		return PINMAME_STATUS_EMULATOR_NOT_RUNNING;
+
+	{
+		std::lock_guard<std::mutex> lock(_pauseMutex);
+		g_fPause = pause;
+		_pauseCond.notify_all();
+	}
+
+	return PINMAME_STATUS_OK;
+}
+
+/******************************************************
+ * PinmameIsPaused
+ ******************************************************/
+
+PINMAMEAPI int PinmameIsPaused()
+{
+	return g_fPause;
+}
+
+/******************************************************
+ * PinmameStop
+ ******************************************************/
+
+PINMAMEAPI void PinmameStop()
+{
+	if (!_p_gameThread)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(_switchMutex);
+		_nextGameNum = -1;
+		g_fPause = 0;
+		_timeToQuit = 1;
+		WakePause();
+	}
+
+	_p_gameThread->join();
+
+	delete _p_gameThread;
+	_p_gameThread = nullptr;
+
+	_timeToQuit = 0;
+	_audioStreamResult = -1;
+
+	FreeDisplays(0);
+}
+
+/******************************************************
+ * StateRequest
+ ******************************************************/
+
+static PINMAME_STATUS StateRequest(const STATE_REQUEST request, void* const p_buffer, size_t* const p_size, const double rewindTime)
+{
+	if (!_isRunning)
+		return PINMAME_STATUS_EMULATOR_NOT_RUNNING;
+
+	// called from a callback of the emulation thread: run it right away
+	if (_p_gameThread && std::this_thread::get_id() == _p_gameThread->get_id())
+		return RunStateRequest(request, p_buffer, p_size, rewindTime);
+
+	std::unique_lock<std::mutex> lock(_stateMutex);
+	_stateDone.wait(lock, [] { return _stateRequest == STATE_REQUEST_NONE; });
+
+	_stateRequest = request;
+	_p_stateBuffer = p_buffer;
+	_stateSize = *p_size;
+	_stateRewindTime = rewindTime;
+	WakePause();
+
+	while (_stateRequest != STATE_REQUEST_NONE) {
+		if (!_isRunning) {
+			_stateRequest = STATE_REQUEST_NONE;
+			return PINMAME_STATUS_EMULATOR_NOT_RUNNING;
+		}
+		_stateDone.wait_for(lock, std::chrono::milliseconds(10));
+	}
+
+	*p_size = _stateSize;
+	return _stateStatus;
+}
+
+/******************************************************
+ * PinmameSaveState
+ *
+ * Serialises the emulation state into p_buffer. With a NULL buffer, only
+ * sets *p_size to the required size. The state is only valid for the same
+ * game and PinMAME build.
+ ******************************************************/
+
+PINMAMEAPI PINMAME_STATUS PinmameSaveState(void* const p_buffer, size_t* const p_size)
+{
+	if (!p_size)
+		return PINMAME_STATUS_BUFFER_TOO_SMALL;
+
+	return StateRequest(STATE_REQUEST_SAVE, p_buffer, p_size, 0.);
+}
+
+/******************************************************
+ * PinmameLoadState
+ ******************************************************/
+
+PINMAMEAPI PINMAME_STATUS PinmameLoadState(const void* const p_buffer, const size_t size)
+{
+	if (!p_buffer)
+		return PINMAME_STATUS_STATE_INVALID;
+
+	size_t stateSize = size;
+	return StateRequest(STATE_REQUEST_LOAD, (void*)p_buffer, &stateSize, 0.);
+}
+
+/******************************************************
+ * PinmameSetRewind
+ *
+ * Keeps a checkpoint every intervalInS emulated seconds in memory, using at
+ * most budgetBytes (one full state plus the deltas to the older ones).
+ * A budget of 0 disables rewinding.
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetRewind(const size_t budgetBytes, const double intervalInS)
+{
+	_rewindBudget = budgetBytes;
+	_rewindInterval = intervalInS;
+}
+
+/******************************************************
+ * PinmameSetWarmStart
+ *
+ * With a boot time > 0, saves the state bootTimeInS emulated seconds after
+ * a cold boot (<game>-warm.sta in the state folder) and restores it on the
+ * next PinmameRun instead of booting, as long as the ROM set, the NVRAM
+ * loaded at startup and the DIP switches are the same. Only for games whose
+ * drivers restore correctly from a save state.
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetWarmStart(const double bootTimeInS)
+{
+	_warmStartBootTime = bootTimeInS;
+}
+
+/******************************************************
+ * PinmameRewind
+ *
+ * Goes back to the newest checkpoint at least timeInS emulated seconds old,
+ * or to the oldest one still in the ring.
+ ******************************************************/
+
+PINMAMEAPI PINMAME_STATUS PinmameRewind(const double timeInS)
+{
+	size_t size = 0;
+	return StateRequest(STATE_REQUEST_REWIND, nullptr, &size, timeInS);
+}
+
+/******************************************************
+ * PinmameGetHardwareGen
+ ******************************************************/
+
+PINMAMEAPI PINMAME_HARDWARE_GEN PinmameGetHardwareGen()
+{
+	const UINT64 hardwareGen = (_isRunning) ? core_gameData->gen : 0;
+	return (PINMAME_HARDWARE_GEN)hardwareGen;
+}
+
+/******************************************************
+ * PinmameGetSwitch
+ ******************************************************/
+
+PINMAMEAPI int PinmameGetSwitch(const int swNo)
+{
+	return (_isRunning) ? vp_getSwitch(swNo) : 0;
+}
+
+/******************************************************
+ * PinmameSetSwitch
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetSwitch(const int swNo, const int state)
+{
+	if (!_isRunning || ReplayHostInput('S', swNo, state ? 1 : 0, 0.))
+		return;
+
+	_ecoActivity = 1;
+	vp_putSwitch(swNo, state ? 1 : 0);
+}
+
+/******************************************************
+ * PinmameSetSwitches
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetSwitches(const PinmameSwitchState* const p_states, const int numSwitches)
+{
+	if (!_isRunning)
+		return;
+
+	_ecoActivity = 1;
+	for (int i = 0; i < numSwitches; ++i) {
+		if (!ReplayHostInput('S', p_states[i].swNo, p_states[i].state ? 1 : 0, 0.))
+			vp_putSwitch(p_states[i].swNo, p_states[i].state ? 1 : 0);
+	}
+}
+
+/******************************************************
+ * PinmameQueueSwitchEvents
+ ******************************************************/
+
+PINMAMEAPI int PinmameQueueSwitchEvents(const PinmameSwitchEvent* const p_events, const int numEvents)
+{
+	if (!_isRunning)
+		return -1;
+
+	const unsigned int read = _switchEventRead.load(std::memory_order_acquire);
+	unsigned int write = _switchEventWrite.load(std::memory_order_relaxed);
+
+	int count = 0;
+	while (count < numEvents && write - read < SWITCH_EVENT_QUEUE_SIZE) {
+		_switchEvents[write & (SWITCH_EVENT_QUEUE_SIZE - 1)] = p_events[count++];
+		write++;
+	}
+
+	_switchEventWrite.store(write, std::memory_order_release);
+	if (count)
+		_ecoActivity = 1;
+
+	return count;
+}
+
+/******************************************************
+ * libpinmame_get_switch_event
+ ******************************************************/
+
+extern "C" int libpinmame_get_switch_event(int* p_swNo, int* p_state, double* p_time)
+{
+	const unsigned int read = _switchEventRead.load(std::memory_order_relaxed);
+
+	if (read == _switchEventWrite.load(std::memory_order_acquire))
+		return 0;
+
+	const PinmameSwitchEvent& event = _switchEvents[read & (SWITCH_EVENT_QUEUE_SIZE - 1)];
+	*p_swNo = event.swNo;
+	*p_state = event.state ? 1 : 0;
+	*p_time = event.time;
+
+	_switchEventRead.store(read + 1, std::memory_order_release);
+
+	return 1;
+}
+
+/******************************************************
+ * PinmameGetSolenoidMask
+ ******************************************************/
+
+PINMAMEAPI uint32_t PinmameGetSolenoidMask(const int low)
+{
+	return vp_getSolMask(low);
+}
+
+/******************************************************
+ * PinmameSetSolenoidMask
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetSolenoidMask(const int low, const uint32_t mask)
+{
+	vp_setSolMask(low, mask);
+}
+
+/******************************************************
+ * PinmameGetModOutputType
+ ******************************************************/
+
+PINMAMEAPI PINMAME_MOD_OUTPUT_TYPE PinmameGetModOutputType(const int output, const int no)
+{
+	return (PINMAME_MOD_OUTPUT_TYPE)vp_getModOutputType(output, no);
+}
+
+/******************************************************
+ * PinmameSetModOutputType
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetModOutputType(const int output, const int no, const PINMAME_MOD_OUTPUT_TYPE type)
+{
+	vp_setModOutputType(output, no, (int)type);
+}
+
+/******************************************************
+ * PinmameGetOutputWatched
+ ******************************************************/
+
+PINMAMEAPI int PinmameGetOutputWatched(const int output, const int no)
+{
+	return vp_getOutputWatched(output, no);
+}
+
+/******************************************************
+ * PinmameSetOutputWatched
+ *
+ * Selects the physical outputs integrated when their state is queried, all
+ * of them by default. Output is a PINMAME_MOD_OUTPUT_TYPE, no starts at 1,
+ * 0 applies to all the outputs of the type. Unwatched outputs keep their
+ * last value and are not reported by the PinmameGetChanged* functions.
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetOutputWatched(const int output, const int no, const int watched)
+{
+	vp_setOutputWatched(output, no, watched);
+}
+
+/******************************************************
+ * PinmameGetOutputOverruns
+ *
+ * Returns how many times the flips of an output were lost since the game
+ * started, because its state was not queried before its flip ring was
+ * full (0 for all the outputs of the type, -1 for invalid outputs). A growing
+ * count means the output should be queried more often.
+ ******************************************************/
+
+PINMAMEAPI int PinmameGetOutputOverruns(const int output, const int no)
+{
+	return vp_getOutputOverruns(output, no);
+}
+
+/******************************************************
+ * PinmameSetTimeFence
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetTimeFence(const double timeInS)
+{
+	vp_setTimeFence(timeInS);
+
+	// fences are applied right away even while recording, a blocked emulation thread would never pick them up
+	if (_isRunning)
+		ReplayHostInput('F', 0, 0, timeInS);
+}
+
+/******************************************************
+ * PinmameGetTimeFenceStats
+ ******************************************************/
+
+PINMAMEAPI void PinmameGetTimeFenceStats(PinmameTimeFenceStats* const p_stats)
+{
+	time_fence_get_stats(&p_stats->waitingTime, &p_stats->runningTime, &p_stats->waits, &p_stats->spinHits);
+}
+
+/******************************************************
+ * PinmameGetMaxSolenoids
+ ******************************************************/
+
+PINMAMEAPI int PinmameGetMaxSolenoids()
+{
+	return CORE_MODOUT_SOL_MAX;
+}
+
+/******************************************************
+ * PinmameGetSolenoid
+ ******************************************************/
+
+PINMAMEAPI int PinmameGetSolenoid(const int solNo)
+{
+	if (!_isRunning)
+		return 0;
+
+	if (options.usemodsol & (CORE_MODOUT_FORCE_ON | CORE_MODOUT_ENABLE_PHYSOUT_SOLENOIDS | CORE_MODOUT_ENABLE_MODSOL))
+		core_update_pwm_outputs(CORE_MODOUT_SOL0 + solNo - 1, 1);
+
+	return vp_getSolenoid(solNo);
+}
+
+/******************************************************
+ * PinmameGetChangedSolenoids
+ ******************************************************/
+
+PINMAMEAPI int PinmameGetChangedSolenoids(PinmameSolenoidState* const p_changedStates)
+{
+	if (!_isRunning)
+		return -1;
+
+	core_update_pwm_solenoids();
+
+	vp_tChgSols chgSols;
+	const int count = vp_getChangedSolenoids(chgSols);
+	if (count > 0)
+		memcpy(p_changedStates, chgSols, count * sizeof(PinmameSolenoidState));
+	return count;
+}
+
+/******************************************************
+ * PinmameGetMaxLamps
+ ******************************************************/
+
+PINMAMEAPI int PinmameGetMaxLamps()
+{
+	return CORE_MODOUT_LAMP_MAX;
+}
+
+/******************************************************
+ * PinmameGetLamp
+ ******************************************************/
+
+PINMAMEAPI int PinmameGetLamp(const int lampNo)
+{
+	if (!_isRunning)
+		return 0;
+
+	if (options.usemodsol & (CORE_MODOUT_FORCE_ON | CORE_MODOUT_ENABLE_PHYSOUT_LAMPS))
+		core_update_pwm_outputs(CORE_MODOUT_LAMP0 + lampNo - 1, 1);
+
+	return vp_getLamp(lampNo);
 }
 
 /******************************************************
- * PinmameGetCheat
+ * PinmameGetChangedLamps
  ******************************************************/
 
-PINMAMEAPI int PinmameGetCheat()
+PINMAMEAPI int PinmameGetChangedLamps(PinmameLampState* const p_changedStates)
 {
-	return options.cheat;
+	if (!_isRunning)
+		return -1;
+
+	core_update_pwm_lamps();
+
+	vp_tChgLamps chgLamps;
+	const int count = vp_getChangedLamps(chgLamps);
+	if (count > 0)
+		memcpy(p_changedStates, chgLamps, count * sizeof(PinmameLampState));
+	return count;
 }
 
 /******************************************************
- * PinmameSetCheat
+ * PinmameGetMaxGIs
  ******************************************************/
 
-PINMAMEAPI void PinmameSetCheat(const int cheat)
+PINMAMEAPI int PinmameGetMaxGIs()
 {
-	options.cheat = cheat;
+	return CORE_MODOUT_GI_MAX;
 }
 
 /******************************************************
- * PinmameGetHandleKeyboard
+ * PinmameGetGI
  ******************************************************/
 
-PINMAMEAPI int PinmameGetHandleKeyboard()
+PINMAMEAPI int PinmameGetGI(const int giNo)
 {
-	return g_fHandleKeyboard;
+	if (!_isRunning)
+		return 0;
+
+	if (options.usemodsol & (CORE_MODOUT_FORCE_ON | CORE_MODOUT_ENABLE_PHYSOUT_GI))
+		core_update_pwm_outputs(CORE_MODOUT_GI0 + giNo - 1, 1);
+
+	return vp_getGI(giNo);
 }
 
 /******************************************************
- * PinmameSetHandleKeyboard
+ * PinmameGetChangedGIs
  ******************************************************/
 
-PINMAMEAPI void PinmameSetHandleKeyboard(const int handleKeyboard)
+PINMAMEAPI int PinmameGetChangedGIs(PinmameGIState* const p_changedStates)
 {
-	g_fHandleKeyboard = handleKeyboard ? 1 : 0;
+	if (!_isRunning)
+		return -1;
+
+	core_update_pwm_gis();
+
+	vp_tChgGIs chgGIs;
+	const int count = vp_getChangedGI(chgGIs);
+	if (count > 0)
+		memcpy(p_changedStates, chgGIs, count * sizeof(PinmameGIState));
+	return count;
 }
 
 /******************************************************
- * PinmameGetHandleMechanics
+ * PinmameGetMaxLEDs
  ******************************************************/
 
-PINMAMEAPI int PinmameGetHandleMechanics()
+PINMAMEAPI int PinmameGetMaxLEDs()
 {
-	return g_fHandleMechanics;
+	return CORE_MODOUT_SEG_MAX;
 }
 
 /******************************************************
- * PinmameSetHandleMechanics
+ * PinmameGetChangedLEDs
  ******************************************************/
 
-PINMAMEAPI void PinmameSetHandleMechanics(const int handleMechanics)
+PINMAMEAPI int PinmameGetChangedLEDs(const uint64_t mask, const uint64_t mask2, PinmameLEDState* const p_changedStates)
 {
-	g_fHandleMechanics = handleMechanics;
+	if (!_isRunning)
+		return -1;
+
+	core_update_pwm_segments();
+
+	vp_tChgLED chgLEDs;
+	const int count = vp_getChangedLEDs(chgLEDs, mask, mask2);
+	if (count > 0)
+		memcpy(p_changedStates, chgLEDs, count * sizeof(PinmameLEDState));
+	return count;
 }
 
 /******************************************************
- * PinmameSetDmdMode
+ * PinmameGetChangedOutputs
  ******************************************************/
 
-PINMAMEAPI void PinmameSetDmdMode(const PINMAME_DMD_MODE dmdMode)
+PINMAMEAPI PINMAME_STATUS PinmameGetChangedOutputs(PinmameOutputBatch* const p_batch)
 {
-	g_fDmdMode = dmdMode;
+	if (!_isRunning)
+		return PINMAME_STATUS_EMULATOR_NOT_RUNNING;
+
+	p_batch->solenoidCount = 0;
+	p_batch->lampCount = 0;
+	p_batch->giCount = 0;
+	p_batch->ledCount = 0;
+	p_batch->mechCount = 0;
+
+	if (p_batch->p_solenoids) {
+		core_update_pwm_solenoids();
+
+		vp_tChgSols chgSols;
+		p_batch->solenoidCount = vp_getChangedSolenoids(chgSols);
+		if (p_batch->solenoidCount > 0)
+			memcpy(p_batch->p_solenoids, chgSols, p_batch->solenoidCount * sizeof(PinmameSolenoidState));
+	}
+
+	if (p_batch->p_lamps) {
+		core_update_pwm_lamps();
+
+		vp_tChgLamps chgLamps;
+		p_batch->lampCount = vp_getChangedLamps(chgLamps);
+		if (p_batch->lampCount > 0)
+			memcpy(p_batch->p_lamps, chgLamps, p_batch->lampCount * sizeof(PinmameLampState));
+	}
+
+	if (p_batch->p_gis) {
+		core_update_pwm_gis();
+
+		vp_tChgGIs chgGIs;
+		p_batch->giCount = vp_getChangedGI(chgGIs);
+		if (p_batch->giCount > 0)
+			memcpy(p_batch->p_gis, chgGIs, p_batch->giCount * sizeof(PinmameGIState));
+	}
+
+	if (p_batch->p_leds) {
+		core_update_pwm_segments();
+
+		vp_tChgLED chgLEDs;
+		p_batch->ledCount = vp_getChangedLEDs(chgLEDs, p_batch->ledMask, p_batch->ledMask2);
+		if (p_batch->ledCount > 0)
+			memcpy(p_batch->p_leds, chgLEDs, p_batch->ledCount * sizeof(PinmameLEDState));
+	}
+
+	if (p_batch->p_mechs) {
+		// the caller missed a batch (or this is its first one): report all mechs
+		const int all = (p_batch->sequence != _outputSequence) || (_outputSequence == 0);
+
+		for (int i = 0; i < (MECH_MAXMECH / 2); i++) {
+			const int pos = vp_getMech(i + 1);
+			const int speed = vp_getMech(-(i + 1));
+
+			if (all || pos != _outputMechState[i].pos || speed != _outputMechState[i].speed) {
+				_outputMechState[i].mechNo = i + 1;
+				_outputMechState[i].pos = pos;
+				_outputMechState[i].speed = speed;
+				p_batch->p_mechs[p_batch->mechCount++] = _outputMechState[i];
+			}
+		}
+	}
+
+	p_batch->timestamp = _emulatedTime.load(std::memory_order_relaxed);
+	p_batch->sequence = ++_outputSequence;
+
+	return PINMAME_STATUS_OK;
 }
 
 /******************************************************
- * PinmameGetDmdMode
+ * PinmameOpenChangeJournal
+ *
+ * Starts journaling the solenoid, lamp and GI changes for one more
+ * consumer. Each consumer reads the changes from its own cursor with
+ * PinmameReadChangeJournal, without disturbing the others nor the
+ * PinmameGetChanged* functions. The journal keeps the last 4096 changes,
+ * recorded when the driver updates its outputs.
  ******************************************************/
 
-PINMAMEAPI PINMAME_DMD_MODE PinmameGetDmdMode()
+PINMAMEAPI void PinmameOpenChangeJournal(PinmameChangeJournalCursor* const p_cursor)
 {
-	return g_fDmdMode;
+	p_cursor->position = vp_openJournalCursor();
+	p_cursor->lost = 0;
 }
 
 /******************************************************
- * PinmameGetSoundMode
+ * PinmameCloseChangeJournal
  ******************************************************/
 
-PINMAMEAPI PINMAME_SOUND_MODE PinmameGetSoundMode()
+PINMAMEAPI void PinmameCloseChangeJournal(PinmameChangeJournalCursor* const p_cursor)
 {
-	return g_fSoundMode;
+	vp_closeJournalCursor();
+	p_cursor->position = 0;
 }
 
 /******************************************************
- * PinmameSetSoundMode
+ * PinmameReadChangeJournal
+ *
+ * Copies up to maxChanges changes following the cursor, oldest first, and
+ * moves the cursor after them. Returns the number of changes copied.
  ******************************************************/
 
-PINMAMEAPI void PinmameSetSoundMode(const PINMAME_SOUND_MODE soundMode)
+PINMAMEAPI int PinmameReadChangeJournal(PinmameChangeJournalCursor* const p_cursor, PinmameOutputChange* const p_changes, const int maxChanges)
 {
-	g_fSoundMode = soundMode;
+	int lost;
+	const int count = vp_readJournal(&p_cursor->position, (vp_tJournalEntry*)p_changes, maxChanges, &lost);
+	p_cursor->lost += lost;
+	return count;
 }
 
 /******************************************************
- * PinmameRun
+ * PinmameSetOutputPush
+ *
+ * Pushes the solenoid, lamp and GI changes to the host instead of having
+ * it poll: the callback receives, on a dedicated notifier thread, all the
+ * changes (as read by PinmameReadChangeJournal) of the last intervalInS
+ * of emulated time in one call. A change of a solenoid whose bit is set
+ * in immediateSolenoids (bit 0 is solenoid 1, e.g. the flipper coils) is
+ * delivered right away instead. The interval and mask apply at once, the
+ * callback when the next game starts; NULL turns the push off.
  ******************************************************/
 
-PINMAMEAPI PINMAME_STATUS PinmameRun(const char* const p_name)
+PINMAMEAPI void PinmameSetOutputPush(const double intervalInS, const uint64_t immediateSolenoids, PinmameOnOutputsUpdatedCallback callback)
 {
-	if (!_p_Config)
-		return PINMAME_STATUS_CONFIG_NOT_SET;
-
-	if (_isRunning)
-		return PINMAME_STATUS_GAME_ALREADY_RUNNING;
-
-	const int gameNum = GetGameNumFromString(p_name);
-
-	if (gameNum < 0)
-		return PINMAME_STATUS_GAME_NOT_FOUND;
-
-	vp_init();
-
-	_p_gameThread = new std::thread(StartGame, gameNum);
-
-	return PINMAME_STATUS_OK;
+	_outputPushInterval = intervalInS;
+	_outputPushImmediate = immediateSolenoids;
+	_outputPushCallback = callback;
 }
 
 /******************************************************
- * PinmameIsRunning
+ * PinmameSetNodeBus
+ *
+ * Bridges the node bus of the SAM games to the host (see
+ * PINMAME_NODEBUS_MODE): the callback receives, on the emulation thread,
+ * all the messages of each emulated millisecond in one call. Applied when
+ * the next game starts.
  ******************************************************/
 
-PINMAMEAPI int PinmameIsRunning()
+PINMAMEAPI void PinmameSetNodeBus(const PINMAME_NODEBUS_MODE mode, PinmameOnNodeBusMessagesCallback callback)
 {
-	return _isRunning;
+	_nodeBusCallback = callback;
+	_nodeBusMode = callback ? mode : PINMAME_NODEBUS_MODE_OFF;
 }
 
 /******************************************************
- * PinmameReset
+ * PinmameQueueNodeBusResponse
+ *
+ * Queues node board response bytes to the CPU board, from any thread. They
+ * are sent on the next emulated millisecond, as fast as the serial port
+ * accepts them. Returns the number of bytes queued, or -1 if no game is
+ * running.
  ******************************************************/
 
-PINMAMEAPI PINMAME_STATUS PinmameReset()
+PINMAMEAPI int PinmameQueueNodeBusResponse(const uint8_t* const p_data, const int size)
 {
 	if (!_isRunning)
-		return PINMAME_STATUS_EMULATOR_NOT_RUNNING;
+		return -1;
 
-	machine_reset();
+	std::lock_guard<std::mutex> lock(_nodeBusResponseMutex);
+	_nodeBusResponses.insert(_nodeBusResponses.end(), p_data, p_data + size);
 
-	return PINMAME_STATUS_OK;
+	return size;
 }
 
 /******************************************************
- * PinmamePause
+ * PinmameGetDisplayFrame
  ******************************************************/
 
-PINMAMEAPI PINMAME_STATUS PinmamePause(const int pause)
+PINMAMEAPI PINMAME_STATUS PinmameGetDisplayFrame(const int index, PinmameDisplayFrame* const p_frame)
 {
 	if (!_isRunning)
 		return PINMAME_STATUS_EMULATOR_NOT_RUNNING;
 
-	g_fPause = pause;
+	std::lock_guard<std::mutex> lock(_displaysMutex);
+
+	if (index < 0 || index >= (int)_displays.size())
+		return PINMAME_STATUS_DISPLAY_NO_INVALID;
+
+	PinmameDisplay* pDisplay = _displays[index];
+
+	uint64_t dirtyRows = 0;
+
+	if (pDisplay->middleFrame.load(std::memory_order_relaxed) & DISPLAY_FRAME_DIRTY) {
+		pDisplay->frontFrame = pDisplay->middleFrame.exchange(pDisplay->frontFrame, std::memory_order_acq_rel) & ~DISPLAY_FRAME_DIRTY;
+		dirtyRows = pDisplay->dirtyRows.exchange(0, std::memory_order_relaxed);
+	}
+
+	const int frame = pDisplay->frontFrame;
+
+	p_frame->sequence = pDisplay->frameSequence[frame];
+	p_frame->timestamp = pDisplay->frameTimestamp[frame];
+	p_frame->p_data = pDisplay->pFrameData[frame];
+	p_frame->size = pDisplay->size;
+	p_frame->hash = pDisplay->frameHash[frame];
+	p_frame->dirtyRows = dirtyRows;
 
 	return PINMAME_STATUS_OK;
 }
 
 /******************************************************
- * PinmameIsPaused
+ * PinmameGetAudio
  ******************************************************/
 
-PINMAMEAPI int PinmameIsPaused()
+PINMAMEAPI int PinmameGetAudio(void* const p_buffer, const int samples)
 {
-	return g_fPause;
-}
+	if (!_isRunning || !_audioQueueEnabled)
+		return 0;
 
-/******************************************************
- * PinmameStop
- ******************************************************/
+	const uint32_t write = _audioQueueWrite.load(std::memory_order_acquire);
+	uint32_t read = _audioQueueRead.load(std::memory_order_relaxed);
 
-PINMAMEAPI void PinmameStop()
-{
-	if (!_p_gameThread)
-		return;
+	int count = (int)(write - read);
+	if (count < samples) {
+		_audioQueueUnderruns++;
+		LogAudioXrun(PINMAME_AUDIO_XRUN_UNDERRUN, samples - count, _audioQueueTime.load(std::memory_order_relaxed));
+	}
+	else
+		count = samples;
+
+	const int total = count;
+	uint8_t* p_dst = (uint8_t*)p_buffer;
+	while (count > 0) {
+		const int pos = read & (AUDIO_QUEUE_SAMPLES - 1);
+		const int len = std::min(count, AUDIO_QUEUE_SAMPLES - pos);
+		memcpy(p_dst, _audioQueue + pos * _audioQueueSampleSize, len * _audioQueueSampleSize);
+		p_dst += len * _audioQueueSampleSize;
+		read += len;
+		count -= len;
+	}
 
-	g_fPause = 0;
-	_timeToQuit = 1;
+	_audioQueueRead.store(read, std::memory_order_release);
 
-	_p_gameThread->join();
+	return total;
+}
 
-	delete _p_gameThread;
-	_p_gameThread = nullptr;
+/******************************************************
+ * PinmameGetAudioQueueInfo
+ ******************************************************/
 
-	_timeToQuit = 0;
+PINMAMEAPI void PinmameGetAudioQueueInfo(PinmameAudioQueueInfo* const p_info)
+{
+	p_info->fill = (int)(_audioQueueWrite.load(std::memory_order_acquire) - _audioQueueRead.load(std::memory_order_acquire));
+	p_info->capacity = AUDIO_QUEUE_SAMPLES;
+	p_info->underruns = _audioQueueUnderruns;
+	p_info->overruns = _audioQueueOverruns;
+}
 
-	for (PinmameDisplay* pDisplay : _displays) {
-		if (pDisplay->pData)
-			free(pDisplay->pData);
+#ifdef __EMSCRIPTEN__
+/******************************************************
+ * PinmameWasmGetAudioQueue
+ *
+ * Not part of the API: the web build (src/libpinmame/wasm.cpp) lets an AudioWorklet
+ * read the pull mode audio queue in place, from the shared wasm memory, the way
+ * PinmameGetAudio does; the positions are plain 32 bit words there
+ ******************************************************/
 
-		delete pDisplay;
-	}
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && sizeof(std::atomic<int>) == sizeof(int32_t), "audio queue positions must be plain words");
 
-	_displays.clear();
+extern "C" void PinmameWasmGetAudioQueue(uint8_t** const pp_data, int* const p_samples, uint32_t** const pp_read, uint32_t** const pp_write, int32_t** const pp_underruns)
+{
+	*pp_data = _audioQueue;
+	*p_samples = AUDIO_QUEUE_SAMPLES;
+	*pp_read = (uint32_t*)&_audioQueueRead;
+	*pp_write = (uint32_t*)&_audioQueueWrite;
+	*pp_underruns = (int32_t*)&_audioQueueUnderruns;
 }
+#endif
 
 /******************************************************
- * PinmameGetHardwareGen
+ * PinmameGetMaxMechs
  ******************************************************/
 
-PINMAMEAPI PINMAME_HARDWARE_GEN PinmameGetHardwareGen()
+PINMAMEAPI int PinmameGetMaxMechs()
 {
-	const UINT64 hardwareGen = (_isRunning) ? core_gameData->gen : 0;
-	return (PINMAME_HARDWARE_GEN)hardwareGen;
+	return (MECH_MAXMECH / 2);
 }
 
 /******************************************************
- * PinmameGetSwitch
+ * PinmameGetMech
  ******************************************************/
 
-PINMAMEAPI int PinmameGetSwitch(const int swNo)
+PINMAMEAPI int PinmameGetMech(const int mechNo)
 {
-	return (_isRunning) ? vp_getSwitch(swNo) : 0;
+	return (_isRunning) ? vp_getMech(mechNo) : 0;
 }
 
 /******************************************************
- * PinmameSetSwitch
+ * PinmameSetMech
  ******************************************************/
 
-PINMAMEAPI void PinmameSetSwitch(const int swNo, const int state)
+PINMAMEAPI PINMAME_STATUS PinmameSetMech(const int mechNo, const PinmameMechConfig* const p_mechConfig)
 {
-	if (!_isRunning)
-		return;
+	if (g_fHandleMechanics)
+		return PINMAME_STATUS_MECH_HANDLE_MECHANICS;
 
-	vp_putSwitch(swNo, state ? 1 : 0);
+	if (mechNo < 1 || mechNo > (MECH_MAXMECH / 2))
+		return PINMAME_STATUS_MECH_NO_INVALID;
+
+	mech_tInitData mechInitData;
+	memset(&mechInitData, 0, sizeof(mech_tInitData));
+
+	if (p_mechConfig) {
+		mechInitData.type = p_mechConfig->type;
+
+		mechInitData.sol1 = p_mechConfig->sol1;
+		mechInitData.sol2 = p_mechConfig->sol2;
+
+		mechInitData.length = p_mechConfig->length;
+		mechInitData.steps = p_mechConfig->steps;
+		mechInitData.initialpos = p_mechConfig->initialPos;
+
+		mechInitData.type = (mechInitData.type & 0xff0001ff) | MECH_ACC(p_mechConfig->acc);
+		mechInitData.type = (mechInitData.type & 0x00ffffff) | MECH_RET(p_mechConfig->ret);
+
+		for (int index = 0; index < PINMAME_MAX_MECHSW; index++) {
+			mechInitData.sw[index].swNo = p_mechConfig->sw[index].swNo;
+			mechInitData.sw[index].startPos = p_mechConfig->sw[index].startPos;
+			mechInitData.sw[index].endPos = p_mechConfig->sw[index].endPos;
+			mechInitData.sw[index].pulse = p_mechConfig->sw[index].pulse;
+		}
+	}
+
+	mech_add((MECH_MAXMECH / 2) + mechNo - 1, &mechInitData);
+
+	return PINMAME_STATUS_OK;
 }
 
 /******************************************************
- * PinmameSetSwitches
+ * PinmameGetMaxSoundCommands
  ******************************************************/
 
-PINMAMEAPI void PinmameSetSwitches(const PinmameSwitchState* const p_states, const int numSwitches)
+PINMAMEAPI int PinmameGetMaxSoundCommands()
 {
-	if (!_isRunning)
-		return;
-
-	for (int i = 0; i < numSwitches; ++i)
-		vp_putSwitch(p_states[i].swNo, p_states[i].state ? 1 : 0);
+	return MAX_CMD_LOG;
 }
 
 /******************************************************
- * PinmameGetSolenoidMask
+ * PinmameGetNewSoundCommands
  ******************************************************/
 
-PINMAMEAPI uint32_t PinmameGetSolenoidMask(const int low)
+PINMAMEAPI int PinmameGetNewSoundCommands(PinmameSoundCommand* const p_newCommands)
 {
-	return vp_getSolMask(low);
+	if (!_isRunning)
+		return -1;
+
+	vp_tChgSound chgSounds;
+	const int count = vp_getNewSoundCommands(chgSounds);
+	if (count > 0)
+		memcpy(p_newCommands, chgSounds, count * sizeof(PinmameSoundCommand));
+	return count;
 }
 
 /******************************************************
- * PinmameSetSolenoidMask
+ * PinmameOpenSoundCommands
+ *
+ * Positions a cursor after the last sound command. Each consumer reads
+ * the commands from its own cursor with PinmameReadSoundCommands, from
+ * any thread, without disturbing the others nor PinmameGetNewSoundCommands.
+ * The history keeps the last 1024 commands with their emulated time, so
+ * the command streams of the DCS games can be read in batches.
  ******************************************************/
 
-PINMAMEAPI void PinmameSetSolenoidMask(const int low, const uint32_t mask)
+PINMAMEAPI void PinmameOpenSoundCommands(PinmameSoundCommandCursor* const p_cursor)
 {
-	vp_setSolMask(low, mask);
+	p_cursor->position = snd_cmd_log_position();
+	p_cursor->lost = 0;
 }
 
 /******************************************************
- * PinmameGetModOutputType
+ * PinmameReadSoundCommands
+ *
+ * Copies up to maxCommands commands following the cursor, oldest first,
+ * and moves the cursor after them. Returns the number of commands copied.
  ******************************************************/
 
-PINMAMEAPI PINMAME_MOD_OUTPUT_TYPE PinmameGetModOutputType(const int output, const int no)
+PINMAMEAPI int PinmameReadSoundCommands(PinmameSoundCommandCursor* const p_cursor, PinmameSoundCommandEntry* const p_commands, const int maxCommands)
 {
-	return (PINMAME_MOD_OUTPUT_TYPE)vp_getModOutputType(output, no);
+	int lost;
+	const int count = snd_read_cmd_log(&p_cursor->position, (snd_tCmdLogEntry*)p_commands, maxCommands, &lost);
+	p_cursor->lost += lost;
+	return count;
 }
 
 /******************************************************
- * PinmameSetModOutputType
+ * PinmameGetDIP
  ******************************************************/
 
-PINMAMEAPI void PinmameSetModOutputType(const int output, const int no, const PINMAME_MOD_OUTPUT_TYPE type)
+PINMAMEAPI int PinmameGetDIP(const int dipBank)
 {
-	vp_setModOutputType(output, no, (int)type);
+	return (_isRunning) ? vp_getDIP(dipBank) : 0;
 }
 
 /******************************************************
- * PinmameSetTimeFence
+ * PinmameSetDIP
  ******************************************************/
 
-PINMAMEAPI void PinmameSetTimeFence(const double timeInS)
+PINMAMEAPI void PinmameSetDIP(const int dipBank, const int value)
 {
-	vp_setTimeFence(timeInS);
+	if (!_isRunning || ReplayHostInput('D', dipBank, value, 0.))
+		return;
+
+	vp_setDIP(dipBank, value);
 }
 
 /******************************************************
- * PinmameGetMaxSolenoids
+ * PinmameGetMaxNVRAM
  ******************************************************/
 
-PINMAMEAPI int PinmameGetMaxSolenoids()
+PINMAMEAPI int PinmameGetMaxNVRAM()
 {
-	return CORE_MODOUT_SOL_MAX;
+	return CORE_MAXNVRAM;
 }
 
 /******************************************************
- * PinmameGetSolenoid
+ * PinmameGetNVRAM
  ******************************************************/
 
-PINMAMEAPI int PinmameGetSolenoid(const int solNo)
+PINMAMEAPI int PinmameGetNVRAM(PinmameNVRAMState* const p_nvramStates)
 {
 	if (!_isRunning)
-		return 0;
+		return -1;
 
-	if (options.usemodsol & (CORE_MODOUT_FORCE_ON | CORE_MODOUT_ENABLE_PHYSOUT_SOLENOIDS | CORE_MODOUT_ENABLE_MODSOL))
-		core_update_pwm_outputs(CORE_MODOUT_SOL0 + solNo - 1, 1);
+	std::vector<uint8_t> image;
+	if (CaptureNVRAM(image) < 0)
+		return -1;
 
-	return vp_getSolenoid(solNo);
+	int size = std::min((int)image.size(), (int)CORE_MAXNVRAM);
+	for (int i = 0; i < size; ++i) {
+		p_nvramStates[i].nvramNo = i;
+		p_nvramStates[i].currStat = image[i];
+		p_nvramStates[i].oldStat = 0;
+	}
+
+	return size;
 }
 
 /******************************************************
- * PinmameGetChangedSolenoids
+ * PinmameGetChangedNVRAM
  ******************************************************/
 
-PINMAMEAPI int PinmameGetChangedSolenoids(PinmameSolenoidState* const p_changedStates)
+PINMAMEAPI int PinmameGetChangedNVRAM(PinmameNVRAMState* const p_nvramStates)
 {
 	if (!_isRunning)
 		return -1;
 
-	core_update_pwm_solenoids();
+	std::vector<uint8_t> image;
+	if (CaptureNVRAM(image) < 0)
+		return -1;
+
+	int count = 0;
+	int size = std::min((int)image.size(), (int)CORE_MAXNVRAM);
+
+	if (_nvramInit == 0) {
+		memcpy(_nvram, image.data(), size);
+		_nvramInit = 1;
+	}
+	else {
+		for (int i = 0; i < size; i += sizeof(uint64_t)) {
+			// skip unchanged blocks
+			const int len = std::min((int)sizeof(uint64_t), size - i);
+			if (!memcmp(_nvram + i, image.data() + i, len))
+				continue;
+
+			for (int j = i; j < i + len; ++j) {
+				if (_nvram[j] != image[j]) {
+					p_nvramStates[count].nvramNo = j;
+					p_nvramStates[count].currStat = image[j];
+					p_nvramStates[count].oldStat = _nvram[j];
+					count++;
+
+					_nvram[j] = image[j];
+				}
+			}
+		}
+	}
 
-	vp_tChgSols chgSols;
-	const int count = vp_getChangedSolenoids(chgSols);
-	if (count > 0)
-		memcpy(p_changedStates, chgSols, count * sizeof(PinmameSolenoidState));
 	return count;
 }
 
 /******************************************************
- * PinmameGetMaxLamps
+ * PinmameWatchMemory
+ *
+ * Reports the changes of the bytes [start, start + length) of a CPU
+ * address space (usually RAM, as the bytes are read back through the
+ * CPU memory map) without polling: the callback gets, on the emulation
+ * thread, all the bytes that changed during each emulation time slice.
+ * Returns the watch id for PinmameUnwatchMemory, or -1 if no game is
+ * running or the parameters are invalid. The watches end with the
+ * game.
  ******************************************************/
 
-PINMAMEAPI int PinmameGetMaxLamps()
+PINMAMEAPI int PinmameWatchMemory(const int cpu, const uint32_t start, const int length, PinmameOnMemoryChangedCallback callback)
 {
-	return CORE_MODOUT_LAMP_MAX;
+	if (!_isRunning || cpu < 0 || cpu >= cpu_gettotalcpu() || length <= 0 || !callback)
+		return -1;
+
+	std::lock_guard<std::mutex> lock(_memoryWatchMutex);
+	MemoryWatch watch;
+	watch.id = _memoryWatchNextId++;
+	watch.cpu = cpu;
+	watch.start = start;
+	watch.length = length;
+	watch.callback = callback;
+	_memoryWatchRequests.push_back(watch);
+	_memoryWatchPending = 1;
+
+	return watch.id;
 }
 
 /******************************************************
- * PinmameGetLamp
+ * PinmameUnwatchMemory
  ******************************************************/
 
-PINMAMEAPI int PinmameGetLamp(const int lampNo)
+PINMAMEAPI PINMAME_STATUS PinmameUnwatchMemory(const int watchId)
 {
-	if (!_isRunning)
-		return 0;
+	std::lock_guard<std::mutex> lock(_memoryWatchMutex);
+	auto it = std::find_if(_memoryWatchRequests.begin(), _memoryWatchRequests.end(), [watchId](const MemoryWatch& watch) { return watch.id == watchId; });
+	if (it == _memoryWatchRequests.end())
+		return PINMAME_STATUS_WATCH_NO_INVALID;
 
-	if (options.usemodsol & (CORE_MODOUT_FORCE_ON | CORE_MODOUT_ENABLE_PHYSOUT_LAMPS))
-		core_update_pwm_outputs(CORE_MODOUT_LAMP0 + lampNo - 1, 1);
+	_memoryWatchRequests.erase(it);
+	_memoryWatchPending = 1;
 
-	return vp_getLamp(lampNo);
+	return PINMAME_STATUS_OK;
 }
 
 /******************************************************
- * PinmameGetChangedLamps
+ * PinmameSetNVRAMAutosave
+ *
+ * Writes the NVRAM file in the background every intervalInS emulated
+ * seconds when it changed (0 to only save on exit, the default).
  ******************************************************/
 
-PINMAMEAPI int PinmameGetChangedLamps(PinmameLampState* const p_changedStates)
+PINMAMEAPI void PinmameSetNVRAMAutosave(const double intervalInS)
 {
-	if (!_isRunning)
-		return -1;
-
-	core_update_pwm_lamps();
-
-	vp_tChgLamps chgLamps;
-	const int count = vp_getChangedLamps(chgLamps);
-	if (count > 0)
-		memcpy(p_changedStates, chgLamps, count * sizeof(PinmameLampState));
-	return count;
+	_nvramAutosaveInterval = intervalInS;
 }
 
 /******************************************************
- * PinmameGetMaxGIs
+ * PinmameSetLatencyTelemetry
+ *
+ * Starts (and resets) or stops the latency measurements
+ * read with PinmameGetLatencyStats.
  ******************************************************/
 
-PINMAMEAPI int PinmameGetMaxGIs()
+PINMAMEAPI void PinmameSetLatencyTelemetry(const int enable)
 {
-	return CORE_MODOUT_GI_MAX;
+	core_latencyEnable(enable ? 1 : 0);
 }
 
 /******************************************************
- * PinmameGetGI
+ * PinmameGetLatencyStats
+ *
+ * Wall clock latency percentiles over the last 1024 samples of a stage:
+ * switch set by PinmameSetSwitch (or a queued switch event) to its first
+ * read by the ROM, or to the next solenoid callback, and DMD frame
+ * rendered by the core to cb_OnDisplayUpdated.
  ******************************************************/
 
-PINMAMEAPI int PinmameGetGI(const int giNo)
+PINMAMEAPI PINMAME_STATUS PinmameGetLatencyStats(const PINMAME_LATENCY stage, PinmameLatencyStats* const p_stats)
 {
-	if (!_isRunning)
-		return 0;
+	if (stage < 0 || stage >= CORE_LATENCY_STAGES || !p_stats)
+		return PINMAME_STATUS_LATENCY_STAGE_INVALID;
 
-	if (options.usemodsol & (CORE_MODOUT_FORCE_ON | CORE_MODOUT_ENABLE_PHYSOUT_GI))
-		core_update_pwm_outputs(CORE_MODOUT_GI0 + giNo - 1, 1);
+	double p50, p95, p99, max;
+	p_stats->samples = core_latencyGet(stage, &p50, &p95, &p99, &max);
+	p_stats->p50 = p50 * 1000.;
+	p_stats->p95 = p95 * 1000.;
+	p_stats->p99 = p99 * 1000.;
+	p_stats->max = max * 1000.;
 
-	return vp_getGI(giNo);
+	return PINMAME_STATUS_OK;
 }
 
 /******************************************************
- * PinmameGetChangedGIs
+ * PinmameSetTimerProfiling
+ *
+ * Measures the time spent in each timer callback (see
+ * PinmameGetTimerStats); the fire counts are always kept.
  ******************************************************/
 
-PINMAMEAPI int PinmameGetChangedGIs(PinmameGIState* const p_changedStates)
+PINMAMEAPI void PinmameSetTimerProfiling(const int enable)
+{
+	_timerProfiling = enable ? 1 : 0;
+}
+
+/******************************************************
+ * PinmameGetTimerStats
+ *
+ * Fills up to maxTimers entries, one per timer callback, and returns
+ * the number of callbacks of the running game (updated every 0.1
+ * emulated second), or -1 if no game is running.
+ ******************************************************/
+
+PINMAMEAPI int PinmameGetTimerStats(PinmameTimerStats* const p_stats, const int maxTimers)
 {
 	if (!_isRunning)
 		return -1;
 
-	core_update_pwm_gis();
+	std::lock_guard<std::mutex> lock(_timerStatsMutex);
+
+	const int count = (int)_timerStats.size();
+	for (int i = 0; i < count && i < maxTimers; i++)
+		p_stats[i] = _timerStats[i];
 
-	vp_tChgGIs chgGIs;
-	const int count = vp_getChangedGI(chgGIs);
-	if (count > 0)
-		memcpy(p_changedStates, chgGIs, count * sizeof(PinmameGIState));
 	return count;
 }
 
 /******************************************************
- * PinmameGetMaxLEDs
+ * PinmameSetAudioProfiling
+ *
+ * Measures the time spent in the mixer and in each sound stream
+ * update, and counts the mixed samples (see
+ * PinmameGetAudioStreamStats); the stream sample counts are always
+ * kept.
  ******************************************************/
 
-PINMAMEAPI int PinmameGetMaxLEDs()
+PINMAMEAPI void PinmameSetAudioProfiling(const int enable)
 {
-	return CORE_MODOUT_SEG_MAX;
+	_audioProfiling = enable ? 1 : 0;
 }
 
 /******************************************************
- * PinmameGetChangedLEDs
+ * PinmameGetAudioStreamStats
+ *
+ * Fills up to maxStreams entries, the mixer first and then one per
+ * sound stream, and returns the number of entries for the running
+ * game (updated every 0.1 emulated second), or -1 if no game is
+ * running. Streams of the same chip type share their time.
  ******************************************************/
 
-PINMAMEAPI int PinmameGetChangedLEDs(const uint64_t mask, const uint64_t mask2, PinmameLEDState* const p_changedStates)
+PINMAMEAPI int PinmameGetAudioStreamStats(PinmameAudioStreamStats* const p_stats, const int maxStreams)
 {
 	if (!_isRunning)
 		return -1;
 
-	core_update_pwm_segments();
+	std::lock_guard<std::mutex> lock(_timerStatsMutex);
+
+	const int count = (int)_audioStreamStats.size();
+	for (int i = 0; i < count && i < maxStreams; i++)
+		p_stats[i] = _audioStreamStats[i];
 
-	vp_tChgLED chgLEDs;
-	const int count = vp_getChangedLEDs(chgLEDs, mask, mask2);
-	if (count > 0)
-		memcpy(p_changedStates, chgLEDs, count * sizeof(PinmameLEDState));
 	return count;
 }
 
 /******************************************************
- * PinmameGetMaxMechs
+ * PinmameGetAudioXruns
+ *
+ * Fills up to maxXruns entries with the most recent audio queue
+ * underruns and overruns, oldest first, and returns the number of
+ * entries filled. The counts since the game started are in
+ * PinmameGetAudioQueueInfo.
  ******************************************************/
 
-PINMAMEAPI int PinmameGetMaxMechs()
+PINMAMEAPI int PinmameGetAudioXruns(PinmameAudioXrun* const p_xruns, const int maxXruns)
 {
-	return (MECH_MAXMECH / 2);
+	std::lock_guard<std::mutex> lock(_audioXrunMutex);
+
+	int count = (int)std::min(_audioXrunCount, (uint32_t)AUDIO_XRUN_LOG);
+	if (count > maxXruns)
+		count = maxXruns;
+
+	for (int i = 0; i < count; i++)
+		p_xruns[i] = _audioXruns[(_audioXrunCount - count + i) % AUDIO_XRUN_LOG];
+
+	return count;
 }
 
 /******************************************************
- * PinmameGetMech
+ * PinmameSetProfiler
+ *
+ * Turns on the subsystem profiler export for the running game and the next
+ * ones: a Chrome trace-event JSON file (chrome://tracing, Perfetto) of the
+ * most recent sections, written when the game stops or the trace is turned
+ * off, and/or a CSV file with per-section counts, times and p50/p95/p99
+ * durations every csvIntervalInS wall clock seconds. NULL or "" turns an
+ * output off. The sections are only recorded in builds with MAME_PROFILER
+ * (the default) or MAME_DEBUG.
  ******************************************************/
 
-PINMAMEAPI int PinmameGetMech(const int mechNo)
+PINMAMEAPI void PinmameSetProfiler(const char* const p_traceFile, const char* const p_csvFile, const double csvIntervalInS)
 {
-	return (_isRunning) ? vp_getMech(mechNo) : 0;
+	std::lock_guard<std::mutex> lock(_profilerMutex);
+
+	_profilerTraceFile = p_traceFile ? p_traceFile : "";
+	_profilerCsvFile = p_csvFile ? p_csvFile : "";
+	_profilerCsvInterval = csvIntervalInS;
+	_profilerPending = _isRunning;
 }
 
 /******************************************************
- * PinmameSetMech
+ * PinmameSetRecording
+ *
+ * Records all inputs of the next games started with PinmameRun into a
+ * text file: switches (PinmameSetSwitch, PinmameSetSwitches and
+ * PinmameQueueSwitchEvents), DIP banks and time fences, with their
+ * emulated time, plus a checkpoint every checkpointIntervalInS emulated
+ * seconds (hashes of the machine state, of the display frames and of the
+ * audio output). Inputs take effect on the next 1 ms switch poll tick of
+ * the core, so that they can be replayed exactly. NULL or "" turns the
+ * recording off. Warm start and rewind must not be used while recording.
  ******************************************************/
 
-PINMAMEAPI PINMAME_STATUS PinmameSetMech(const int mechNo, const PinmameMechConfig* const p_mechConfig)
+PINMAMEAPI PINMAME_STATUS PinmameSetRecording(const char* const p_path, const double checkpointIntervalInS)
 {
-	if (g_fHandleMechanics)
-		return PINMAME_STATUS_MECH_HANDLE_MECHANICS;
-
-	if (mechNo < 1 || mechNo > (MECH_MAXMECH / 2))
-		return PINMAME_STATUS_MECH_NO_INVALID;
+	if (_isRunning)
+		return PINMAME_STATUS_GAME_ALREADY_RUNNING;
 
-	mech_tInitData mechInitData;
-	memset(&mechInitData, 0, sizeof(mech_tInitData));
+	std::lock_guard<std::mutex> lock(_replayMutex);
 
-	if (p_mechConfig) {
-		mechInitData.type = p_mechConfig->type;
+	_replayPath = p_path ? p_path : "";
+	_replayInterval = (checkpointIntervalInS > 0.) ? checkpointIntervalInS : 1.;
+	_replayRequested = _replayPath.empty() ? PINMAME_REPLAY_MODE_NONE : PINMAME_REPLAY_MODE_RECORD;
 
-		mechInitData.sol1 = p_mechConfig->sol1;
-		mechInitData.sol2 = p_mechConfig->sol2;
+	return PINMAME_STATUS_OK;
+}
 
-		mechInitData.length = p_mechConfig->length;
-		mechInitData.steps = p_mechConfig->steps;
-		mechInitData.initialpos = p_mechConfig->initialPos;
+/******************************************************
+ * PinmameSetReplay
+ *
+ * Replays a recording made with PinmameSetRecording in the next games
+ * started with PinmameRun (the game must match), ignoring the host
+ * inputs, and checks the recorded checkpoints (see
+ * PinmameGetReplayStatus). Time fences are not replayed: for a fast
+ * check, run unthrottled. The NVRAM must be the one the recording
+ * started with. NULL or "" turns the replay off.
+ ******************************************************/
 
-		mechInitData.type = (mechInitData.type & 0xff0001ff) | MECH_ACC(p_mechConfig->acc);
-		mechInitData.type = (mechInitData.type & 0x00ffffff) | MECH_RET(p_mechConfig->ret);
+PINMAMEAPI PINMAME_STATUS PinmameSetReplay(const char* const p_path)
+{
+	if (_isRunning)
+		return PINMAME_STATUS_GAME_ALREADY_RUNNING;
 
-		for (int index = 0; index < PINMAME_MAX_MECHSW; index++) {
-			mechInitData.sw[index].swNo = p_mechConfig->sw[index].swNo;
-			mechInitData.sw[index].startPos = p_mechConfig->sw[index].startPos;
-			mechInitData.sw[index].endPos = p_mechConfig->sw[index].endPos;
-			mechInitData.sw[index].pulse = p_mechConfig->sw[index].pulse;
-		}
-	}
+	std::lock_guard<std::mutex> lock(_replayMutex);
 
-	mech_add((MECH_MAXMECH / 2) + mechNo - 1, &mechInitData);
+	_replayPath = p_path ? p_path : "";
+	_replayRequested = _replayPath.empty() ? PINMAME_REPLAY_MODE_NONE : PINMAME_REPLAY_MODE_PLAYBACK;
 
 	return PINMAME_STATUS_OK;
 }
 
 /******************************************************
- * PinmameGetMaxSoundCommands
+ * PinmameGetReplayStatus
  ******************************************************/
 
-PINMAMEAPI int PinmameGetMaxSoundCommands()
+PINMAMEAPI PINMAME_STATUS PinmameGetReplayStatus(PinmameReplayStatus* const p_status)
 {
-	return MAX_CMD_LOG;
+	std::lock_guard<std::mutex> lock(_replayMutex);
+
+	*p_status = _replayStatus;
+
+	return PINMAME_STATUS_OK;
 }
 
 /******************************************************
- * PinmameGetNewSoundCommands
+ * PinmameSetGoldenOutput
+ *
+ * Checksums the outputs of the next games started with PinmameRun,
+ * as a correctness gate for optimizations of the DMD, sound and CPU
+ * code: a CRC of the main DMD luminance and bitplane frames every
+ * framesPerCrc frames (1 locates the first diverging frame exactly)
+ * and of the mixed audio per emulated second. PINMAME_GOLDEN_MODE_RECORD
+ * writes them to p_path, PINMAME_GOLDEN_MODE_VERIFY compares them with
+ * that file (framesPerCrc is then read from it) up to the first
+ * mismatch, see PinmameGetGoldenStatus. The outputs only repeat for the
+ * same inputs: combine it with PinmameSetRecording/PinmameSetReplay,
+ * start from the same NVRAM and run unthrottled (frame skipping is
+ * only possible in throttled mode). PINMAME_GOLDEN_MODE_NONE turns the
+ * checksums off.
  ******************************************************/
 
-PINMAMEAPI int PinmameGetNewSoundCommands(PinmameSoundCommand* const p_newCommands)
+PINMAMEAPI PINMAME_STATUS PinmameSetGoldenOutput(const char* const p_path, const PINMAME_GOLDEN_MODE mode, const int framesPerCrc)
 {
-	if (!_isRunning)
-		return -1;
+	if (_isRunning)
+		return PINMAME_STATUS_GAME_ALREADY_RUNNING;
 
-	vp_tChgSound chgSounds;
-	const int count = vp_getNewSoundCommands(chgSounds);
-	if (count > 0)
-		memcpy(p_newCommands, chgSounds, count * sizeof(PinmameSoundCommand));
-	return count;
+	std::lock_guard<std::mutex> lock(_goldenMutex);
+
+	_goldenPath = p_path ? p_path : "";
+	_goldenFramesPerCrc = (framesPerCrc > 0) ? framesPerCrc : 1;
+	_goldenRequested = _goldenPath.empty() ? PINMAME_GOLDEN_MODE_NONE : mode;
+
+	return PINMAME_STATUS_OK;
 }
 
 /******************************************************
- * PinmameGetDIP
+ * PinmameGetGoldenStatus
  ******************************************************/
 
-PINMAMEAPI int PinmameGetDIP(const int dipBank)
+PINMAMEAPI PINMAME_STATUS PinmameGetGoldenStatus(PinmameGoldenStatus* const p_status)
 {
-	return (_isRunning) ? vp_getDIP(dipBank) : 0;
+	std::lock_guard<std::mutex> lock(_goldenMutex);
+
+	*p_status = _goldenStatus;
+
+	return PINMAME_STATUS_OK;
 }
 
 /******************************************************
- * PinmameSetDIP
+ * PinmameSetCpuTrace
+ *
+ * Writes a trace of the CPUs in cpuMask (bit 0 for the first CPU) for
+ * the next games started with PinmameRun: after each timeslice, the
+ * cycles run, the host time taken, the registers and the disassembly
+ * at the PC (full mnemonics need a build with the MAME_DEBUG
+ * disassemblers), plus a hash of the machine state every
+ * stateIntervalInS emulated seconds (0 for none). Two traces of the
+ * same input replay (PinmameSetReplay) made with different builds of a
+ * CPU core are compared with pinmame_cpudiff. NULL or "" turns the
+ * trace off.
  ******************************************************/
 
-PINMAMEAPI void PinmameSetDIP(const int dipBank, const int value)
+PINMAMEAPI PINMAME_STATUS PinmameSetCpuTrace(const char* const p_path, const uint32_t cpuMask, const double stateIntervalInS)
 {
-	if (!_isRunning)
-		return;
+	if (_isRunning)
+		return PINMAME_STATUS_GAME_ALREADY_RUNNING;
 
-	vp_setDIP(dipBank, value);
+	std::lock_guard<std::mutex> lock(_cpuTraceMutex);
+
+	_cpuTracePath = p_path ? p_path : "";
+	_cpuTraceRequestedMask = cpuMask;
+	_cpuTraceStateInterval = stateIntervalInS;
+
+	return PINMAME_STATUS_OK;
 }
 
 /******************************************************
- * PinmameGetMaxNVRAM
+ * PinmameSetAutoInterleave
+ *
+ * Tunes the CPU interleave from the traffic between the CPUs: after
+ * a frame without sound or other board commands, the timeslices are
+ * stretched up to stretch times (0 keeps the driver interleave), but
+ * never below the driver floor of slices per frame (by default 1/8 of
+ * its interleave). Any command returns to the driver interleave for
+ * at least one frame. Takes effect right away.
  ******************************************************/
 
-PINMAMEAPI int PinmameGetMaxNVRAM()
+PINMAMEAPI void PinmameSetAutoInterleave(const int stretch)
 {
-	return CORE_MAXNVRAM;
+	_autoInterleave = (stretch > 1) ? stretch : 0;
 }
 
 /******************************************************
- * PinmameGetNVRAM
+ * PinmameGetInterleaveStats
+ *
+ * Returns the number of timeslices run since the game started and
+ * their average length in emulated seconds, or
+ * PINMAME_STATUS_EMULATOR_NOT_RUNNING if no game is running.
  ******************************************************/
 
-PINMAMEAPI int PinmameGetNVRAM(PinmameNVRAMState* const p_nvramStates)
+PINMAMEAPI PINMAME_STATUS PinmameGetInterleaveStats(uint32_t* const p_slices, double* const p_average)
 {
 	if (!_isRunning)
-		return -1;
-
-	if (!(Machine && Machine->drv && Machine->drv->nvram_handler))
-		return -1;
-
-	mame_file* nvram_file = (mame_file*)malloc(sizeof(mame_file));
-	memset(nvram_file, 0, sizeof(mame_file));
-	nvram_file->type = RAM_FILE;
-	(*Machine->drv->nvram_handler)(nvram_file, 1);
-
-	if (nvram_file->offset == 0) {
-		mame_fclose(nvram_file);
-		return -1;
-	}
+		return PINMAME_STATUS_EMULATOR_NOT_RUNNING;
 
-	int size = std::min((int)nvram_file->offset, (int)CORE_MAXNVRAM);
-	for (int i = 0; i < size; ++i) {
-		p_nvramStates[i].nvramNo = i;
-		p_nvramStates[i].currStat = nvram_file->data[i];
-		p_nvramStates[i].oldStat = 0;
-	}
+	*p_slices = _interleaveSlices.load(std::memory_order_relaxed);
+	*p_average = _interleaveAverage.load(std::memory_order_relaxed);
 
-	return size;
+	return PINMAME_STATUS_OK;
 }
 
 /******************************************************
- * PinmameGetChangedNVRAM
+ * PinmameSetPcSampling
+ *
+ * Samples the PC of each emulated CPU every intervalInS emulated
+ * seconds (0 turns the sampling off) and, when a game stops, appends
+ * its topN most sampled addresses to p_reportFile, with their share of
+ * the samples, the ROM bank (on banked systems like WPC, "--" outside
+ * the banked window) and the disassembly (full mnemonics need a build
+ * with the MAME_DEBUG disassemblers). Takes effect right away, each
+ * game starts with an empty histogram.
  ******************************************************/
 
-PINMAMEAPI int PinmameGetChangedNVRAM(PinmameNVRAMState* const p_nvramStates)
+PINMAMEAPI void PinmameSetPcSampling(const char* const p_reportFile, const double intervalInS, const int topN)
 {
-	if (!_isRunning)
-		return -1;
-
-	if (!(Machine && Machine->drv && Machine->drv->nvram_handler))
-		return -1;
-
-	mame_file* nvram_file = (mame_file*)malloc(sizeof(mame_file));
-	memset(nvram_file, 0, sizeof(mame_file));
-	nvram_file->type = RAM_FILE;
-	(*Machine->drv->nvram_handler)(nvram_file, 1);
-
-	if (nvram_file->offset == 0) {
-		mame_fclose(nvram_file);
-		return -1;
-	}
-
-	int count = 0;
-	int size = std::min((int)nvram_file->offset, (int)CORE_MAXNVRAM);
-
-	if (_nvramInit == 0) {
-		memcpy(_nvram, nvram_file->data, size);
-		_nvramInit = 1;
+	{
+		std::lock_guard<std::mutex> lock(_pcSamplingMutex);
+		_pcSamplingReport = p_reportFile ? p_reportFile : "";
+		_pcSamplingTop = topN;
 	}
-	else {
-		for (int i = 0; i < size; ++i) {
-			if (_nvram[i] != nvram_file->data[i]) {
-				p_nvramStates[count].nvramNo = i;
-				p_nvramStates[count].currStat = nvram_file->data[i];
-				p_nvramStates[count].oldStat = _nvram[i];
-				count++;
-
-				_nvram[i] = nvram_file->data[i];
-			}
-		}
-	}
-
-	mame_fclose(nvram_file);
-
-	return count;
+	_pcSamplingInterval = (intervalInS > 0.) ? intervalInS : 0.;
 }
 
 /******************************************************
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdarg.h>
 
@@ -30,7 +31,13 @@ typedef enum {
 	PINMAME_STATUS_GAME_ALREADY_RUNNING = 3,
 	PINMAME_STATUS_EMULATOR_NOT_RUNNING = 4,
 	PINMAME_STATUS_MECH_HANDLE_MECHANICS = 5,
-	PINMAME_STATUS_MECH_NO_INVALID = 6
+	PINMAME_STATUS_MECH_NO_INVALID = 6,
+	PINMAME_STATUS_DISPLAY_NO_INVALID = 7,
+	PINMAME_STATUS_BUFFER_TOO_SMALL = 8,
+	PINMAME_STATUS_STATE_INVALID = 9,
+	PINMAME_STATUS_REWIND_NOT_AVAILABLE = 10,
+	PINMAME_STATUS_LATENCY_STAGE_INVALID = 11,
+	PINMAME_STATUS_WATCH_NO_INVALID = 12
 } PINMAME_STATUS;
 
 typedef enum {
@@ -43,14 +50,37 @@ typedef enum {
 
 typedef enum {
 	PINMAME_DMD_MODE_BRIGHTNESS = 0,
-	PINMAME_DMD_MODE_RAW = 1
+	PINMAME_DMD_MODE_RAW = 1,
+	PINMAME_DMD_MODE_COLOR = 2 // uint32_t per dot (0x00BBGGRR), colorized with the DMD options or the palette triggers
 } PINMAME_DMD_MODE;
 
+// Pixel format of the video (PINMAME_DISPLAY_TYPE_VIDEO) display frames
+typedef enum {
+	PINMAME_VIDEO_FORMAT_RGB888 = 0,   // 3 bytes per pixel: R, G, B
+	PINMAME_VIDEO_FORMAT_RGBA8888 = 1, // 4 bytes per pixel: R, G, B, 255
+	PINMAME_VIDEO_FORMAT_BGRA8888 = 2, // 4 bytes per pixel: B, G, R, 255
+	PINMAME_VIDEO_FORMAT_INDEXED16 = 3 // uint16_t pen per pixel, colors from PinmameGetVideoPalette
+} PINMAME_VIDEO_FORMAT;
+
 typedef enum {
 	PINMAME_SOUND_MODE_DEFAULT = 0,
 	PINMAME_SOUND_MODE_ALTSOUND = 1
 } PINMAME_SOUND_MODE;
 
+typedef enum {
+	PINMAME_SPEED_MODE_NORMAL = 0,
+	PINMAME_SPEED_MODE_UNTHROTTLED = 1
+} PINMAME_SPEED_MODE;
+
+typedef enum {
+	PINMAME_AUDIT_STATUS_CORRECT = 0,
+	PINMAME_AUDIT_STATUS_NOT_FOUND = 1,
+	PINMAME_AUDIT_STATUS_INCORRECT = 2,
+	PINMAME_AUDIT_STATUS_CLONE_NOT_FOUND = 3,
+	PINMAME_AUDIT_STATUS_BEST_AVAILABLE = 4,
+	PINMAME_AUDIT_STATUS_MISSING_OPTIONAL = 5
+} PINMAME_AUDIT_STATUS;
+
 typedef enum {
 	PINMAME_AUDIO_FORMAT_INT16 = 0,
 	PINMAME_AUDIO_FORMAT_FLOAT = 1
@@ -296,6 +326,80 @@ typedef enum : unsigned int {
 	PINMAME_KEYCODE_MENU = 104
 } PINMAME_KEYCODE;
 
+// Per emulated CPU counters returned by PinmameGetCpuStats; cycles is the total executed since the game started
+typedef struct {
+	const char* name;
+	int32_t clock;
+	uint64_t cycles;
+} PinmameCpuStats;
+
+typedef enum {
+	PINMAME_LATENCY_SWITCH_READ = 0,     // switch set by the host -> first read by the ROM
+	PINMAME_LATENCY_SWITCH_SOLENOID = 1, // switch set by the host -> next cb_OnSolenoidUpdated
+	PINMAME_LATENCY_DMD = 2              // DMD frame rendered -> cb_OnDisplayUpdated
+} PINMAME_LATENCY;
+
+typedef enum {
+	PINMAME_REPLAY_MODE_NONE = 0,
+	PINMAME_REPLAY_MODE_RECORD = 1,
+	PINMAME_REPLAY_MODE_PLAYBACK = 2
+} PINMAME_REPLAY_MODE;
+
+// State of the input recorder/replayer returned by PinmameGetReplayStatus, for the running or last game.
+// finished is set once a replay reached the end of the recording; firstMismatchTime is in emulated seconds.
+typedef struct {
+	PINMAME_REPLAY_MODE mode;
+	int finished;
+	uint32_t events;
+	uint32_t checkpoints;
+	uint32_t mismatches;
+	double firstMismatchTime;
+} PinmameReplayStatus;
+
+typedef enum {
+	PINMAME_GOLDEN_MODE_NONE = 0,
+	PINMAME_GOLDEN_MODE_RECORD = 1,
+	PINMAME_GOLDEN_MODE_VERIFY = 2
+} PINMAME_GOLDEN_MODE;
+
+typedef enum {
+	PINMAME_GOLDEN_MISMATCH_NONE = 0,
+	PINMAME_GOLDEN_MISMATCH_LUMINANCE = 1, // main DMD luminance frames
+	PINMAME_GOLDEN_MISMATCH_BITPLANE = 2,  // main DMD bitplane frames
+	PINMAME_GOLDEN_MISMATCH_AUDIO = 3,     // mixed audio
+	PINMAME_GOLDEN_MISMATCH_SEQUENCE = 4   // different number of frames per emulated second
+} PINMAME_GOLDEN_MISMATCH;
+
+// State of the golden output checksums returned by PinmameGetGoldenStatus, for the running or last game.
+// checks counts the checksums written or verified; verification stops at the first mismatch, whose first frame
+// (for DMD mismatches, 0 based) or emulated second (for audio mismatches) is reported; finished is set once a
+// verification reached the end of the reference file.
+typedef struct {
+	PINMAME_GOLDEN_MODE mode;
+	int finished;
+	uint32_t checks;
+	PINMAME_GOLDEN_MISMATCH mismatch;
+	uint32_t firstMismatchFrame;
+	double firstMismatchTime;
+} PinmameGoldenStatus;
+
+// Latency percentiles returned by PinmameGetLatencyStats, in milliseconds; samples is the total since enabled
+typedef struct {
+	uint32_t samples;
+	double p50;
+	double p95;
+	double p99;
+	double max;
+} PinmameLatencyStats;
+
+// Per timer callback counters returned by PinmameGetTimerStats, since the game started; time is
+// the wall clock time spent in the callback while timer profiling is on (PinmameSetTimerProfiling)
+typedef struct {
+	char name[32];
+	uint64_t fires;
+	double time;
+} PinmameTimerStats;
+
 typedef struct {
 	const char* name;
 	const char* clone_of;
@@ -303,9 +407,27 @@ typedef struct {
 	const char* year;
 	const char* manufacturer;
 	uint32_t flags;
-	int32_t found;
+	int32_t found; // 1 if the ROM set is available, -1 if not checked (PinmameGetGameList without checkRoms)
 } PinmameGame;
 
+// One ROM file of a game for PinmameGetGameRoms: crc and sha1 are lowercase hex, or empty if no good dump is known
+typedef struct {
+	const char* name;
+	uint32_t length;
+	char crc[9];
+	char sha1[41];
+	int32_t optional; // 1 if the game runs without it
+} PinmameRom;
+
+// Result of one game for PinmameAuditGames: index counts from 0 to count-1 in reporting order
+typedef struct {
+	const char* name;
+	const char* clone_of;
+	PINMAME_AUDIT_STATUS status;
+	int index;
+	int count;
+} PinmameAuditResult;
+
 typedef struct {
 	PINMAME_DISPLAY_TYPE type;
 	int32_t top;
@@ -316,6 +438,19 @@ typedef struct {
 	int32_t depth;
 } PinmameDisplayLayout;
 
+// Stable display frame returned by PinmameGetDisplayFrame: p_data stays valid and unchanged
+// until the next PinmameGetDisplayFrame call for the same display (or PinmameStop)
+// For DMDs, hash identifies the frame content and bit n of dirtyRows is set if row n may have
+// changed since the previously returned frame (both are 0 for other display types)
+typedef struct {
+	uint32_t sequence;
+	double timestamp;
+	const void* p_data;
+	int32_t size;
+	uint64_t hash;
+	uint64_t dirtyRows;
+} PinmameDisplayFrame;
+
 typedef struct {
 	PINMAME_AUDIO_FORMAT format;
 	int channels;
@@ -325,11 +460,62 @@ typedef struct {
 	int bufferSize;
 } PinmameAudioInfo;
 
+// Audio queue state returned by PinmameGetAudioQueueInfo. The queue is only used if cb_OnAudioUpdated
+// is NULL: the emulation thread then pushes each frame's samples there, and the host's audio thread
+// drains it with PinmameGetAudio at its own pace. All counts are in samples (couples of samples in stereo)
+typedef struct {
+	int fill;
+	int capacity;
+	int underruns;
+	int overruns;
+} PinmameAudioQueueInfo;
+
+// Time fence statistics returned by PinmameGetTimeFenceStats, accumulated since the game started: host
+// seconds the emulation thread spent blocked on the fence and emulating between fences, the number of waits,
+// and how many of them were satisfied while spinning, before falling back to a blocking wait
+typedef struct {
+	double waitingTime;
+	double runningTime;
+	uint32_t waits;
+	uint32_t spinHits;
+} PinmameTimeFenceStats;
+
+typedef enum {
+	PINMAME_AUDIO_XRUN_UNDERRUN = 0,     // PinmameGetAudio asked for more samples than queued
+	PINMAME_AUDIO_XRUN_OVERRUN = 1       // the queue was full and samples of a frame were dropped
+} PINMAME_AUDIO_XRUN;
+
+// One audio queue underrun or overrun returned by PinmameGetAudioXruns: samples is the number of missing
+// or dropped samples, time the emulated time of the last queued frame
+typedef struct {
+	PINMAME_AUDIO_XRUN type;
+	int samples;
+	double time;
+} PinmameAudioXrun;
+
+// Mixer and sound stream counters returned by PinmameGetAudioStreamStats, since the game started: samples
+// generated (mixed samples for the mixer), and the wall clock time spent while audio profiling is on
+typedef struct {
+	char name[32];
+	int channels;
+	uint64_t samples;
+	double time;
+} PinmameAudioStreamStats;
+
 typedef struct {
 	int swNo;
 	int state;
 } PinmameSwitchState;
 
+// Switch event for PinmameQueueSwitchEvents: time is the emulated time in seconds (as in the
+// PinmameDisplayFrame and PinmameOutputBatch timestamps) at which the switch changes. Events at
+// or before the current emulated time are applied within 1ms of emulated time
+typedef struct {
+	int swNo;
+	int state;
+	double time;
+} PinmameSwitchEvent;
+
 typedef struct {
 	int solNo;
 	int state;
@@ -378,16 +564,116 @@ typedef struct {
 	int speed;
 } PinmameMechInfo;
 
+typedef struct {
+	int mechNo;
+	int pos;
+	int speed;
+} PinmameMechState;
+
+// Changed outputs returned by PinmameGetChangedOutputs in one call. Before the call, point each p_* array
+// at a buffer of PinmameGetMax*() entries (usually slices of one allocation), or set it to NULL to skip
+// that output type; ledMask/ledMask2 select the LEDs like PinmameGetChangedLEDs. On return, each *Count
+// holds the number of entries written, timestamp is the emulated time in seconds of the last frame, and
+// sequence is the number of this batch. Pass back the sequence of the previous batch: if it doesn't match
+// (first call, or another consumer in between), all mechs are reported, not just the changed ones
+typedef struct {
+	uint64_t sequence;
+	double timestamp;
+	uint64_t ledMask;
+	uint64_t ledMask2;
+	PinmameSolenoidState* p_solenoids;
+	int solenoidCount;
+	PinmameLampState* p_lamps;
+	int lampCount;
+	PinmameGIState* p_gis;
+	int giCount;
+	PinmameLEDState* p_leds;
+	int ledCount;
+	PinmameMechState* p_mechs;
+	int mechCount;
+} PinmameOutputBatch;
+
+// Output change read by PinmameReadChangeJournal: type is a PINMAME_MOD_OUTPUT_TYPE (solenoid, lamp or GI),
+// no and value as returned by PinmameGetChangedSolenoids, PinmameGetChangedLamps and PinmameGetChangedGIs,
+// time the emulated time in seconds of the change
+typedef struct {
+	double time;
+	uint16_t no;
+	uint8_t type;
+	uint8_t value;
+} PinmameOutputChange;
+
+// Position of one consumer in the output change journal, lost is the number of changes overwritten before
+// this consumer read them since the journal was opened
+typedef struct {
+	uint32_t position;
+	uint32_t lost;
+} PinmameChangeJournalCursor;
+
+// SAM node bus bridge (PinmameSetNodeBus). In monitor mode, the node boards are still emulated and the traffic
+// is reported; in bridge mode, their emulation is disabled and the host answers the requests itself with
+// PinmameQueueNodeBusResponse. In both modes, the console port data is reported instead of cb_OnConsoleDataUpdated
+typedef enum {
+	PINMAME_NODEBUS_MODE_OFF = 0,
+	PINMAME_NODEBUS_MODE_MONITOR = 1,
+	PINMAME_NODEBUS_MODE_BRIDGE = 2
+} PINMAME_NODEBUS_MODE;
+
+// Threads of PinmameSetThreadScheduling
+typedef enum {
+	PINMAME_THREAD_EMULATION = 0, // runs the emulated machine and the callbacks
+	PINMAME_THREAD_AUDIO = 1,     // altsound native mixer end of stream processing
+	PINMAME_THREAD_ALTSOUND = 2   // altsound command processing
+} PINMAME_THREAD;
+
+typedef enum {
+	PINMAME_NODEBUS_CHANNEL_REQUEST = 0,  // one whole message sent by the CPU board to the node bus
+	PINMAME_NODEBUS_CHANNEL_RESPONSE = 1, // one response of the emulated node boards (monitor mode only)
+	PINMAME_NODEBUS_CHANNEL_CONSOLE = 2   // bytes sent to the console port
+} PINMAME_NODEBUS_CHANNEL;
+
+// Node bus message: time is the emulated time in seconds at which it was sent, p_data is only valid during the callback
+typedef struct {
+	double time;
+	PINMAME_NODEBUS_CHANNEL channel;
+	int size;
+	const uint8_t* p_data;
+} PinmameNodeBusMessage;
+
 typedef struct {
 	int sndNo;
 } PinmameSoundCommand;
 
+// Sound command read by PinmameReadSoundCommands: time is the emulated time in seconds of the command
+typedef struct {
+	double time;
+	int boardNo;
+	int cmd;
+} PinmameSoundCommandEntry;
+
+// Position of one consumer in the sound command history, lost is the number of commands overwritten before
+// this consumer read them since the cursor was opened
+typedef struct {
+	uint32_t position;
+	uint32_t lost;
+} PinmameSoundCommandCursor;
+
 typedef struct {
 	int nvramNo;
 	uint8_t oldStat;
 	uint8_t currStat;
 } PinmameNVRAMState;
 
+// Change of a byte watched by PinmameWatchMemory: time is the emulated time in seconds of the last write
+// to it, oldValue its value at the previous change (or when the watch was set)
+typedef struct {
+	double time;
+	int cpu;
+	uint32_t address;
+	uint8_t oldValue;
+	uint8_t newValue;
+} PinmameMemoryChange;
+
 typedef struct {
 	const char* name;
 	PINMAME_KEYCODE code;
@@ -395,6 +681,7 @@ typedef struct {
 } PinmameKeyboardInfo;
 
 typedef void (PINMAMECALLBACK *PinmameGameCallback)(PinmameGame* p_game, const void* p_userData);
+typedef void (PINMAMECALLBACK *PinmameAuditCallback)(PinmameAuditResult* p_result, const void* p_userData);
 typedef void (PINMAMECALLBACK *PinmameOnStateUpdatedCallback)(int state, const void* p_userData);
 typedef void (PINMAMECALLBACK *PinmameOnDisplayAvailableCallback)(int index, int displayCount, PinmameDisplayLayout* p_displayLayout, const void* p_userData);
 typedef void (PINMAMECALLBACK *PinmameOnDisplayUpdatedCallback)(int index, void* p_displayData, PinmameDisplayLayout* p_displayLayout, const void* p_userData);
@@ -407,6 +694,9 @@ typedef void (PINMAMECALLBACK *PinmameOnConsoleDataUpdatedCallback)(void* p_data
 typedef int (PINMAMECALLBACK *PinmameIsKeyPressedFunction)(PINMAME_KEYCODE keycode, const void* p_userData);
 typedef void (PINMAMECALLBACK *PinmameOnLogMessageCallback)(PINMAME_LOG_LEVEL logLevel, const char* format, va_list args, const void* p_userData);
 typedef void (PINMAMECALLBACK *PinmameOnSoundCommandCallback)(int boardNo, int cmd, const void* p_userData);
+typedef void (PINMAMECALLBACK *PinmameOnNodeBusMessagesCallback)(const PinmameNodeBusMessage* p_messages, int count, const void* p_userData);
+typedef void (PINMAMECALLBACK *PinmameOnOutputsUpdatedCallback)(const PinmameOutputChange* p_changes, int count, const void* p_userData);
+typedef void (PINMAMECALLBACK *PinmameOnMemoryChangedCallback)(const PinmameMemoryChange* p_changes, int count, const void* p_userData);
 
 typedef struct {
 	const PINMAME_AUDIO_FORMAT audioFormat;
@@ -428,6 +718,10 @@ typedef struct {
 
 PINMAMEAPI PINMAME_STATUS PinmameGetGame(const char* const p_name, PinmameGameCallback callback, const void* p_userData);
 PINMAMEAPI PINMAME_STATUS PinmameGetGames(PinmameGameCallback callback, const void* p_userData);
+PINMAMEAPI int PinmameGetGameList(PinmameGame* const p_games, const int maxGames, const int checkRoms);
+PINMAMEAPI int PinmameGetClones(const char* const p_name, const char** const pp_clones, const int maxClones);
+PINMAMEAPI int PinmameGetGameRoms(const char* const p_name, PinmameRom* const p_roms, const int maxRoms);
+PINMAMEAPI PINMAME_STATUS PinmameAuditGames(const char* const* const pp_names, const int numNames, PinmameAuditCallback callback, const void* p_userData);
 PINMAMEAPI void PinmameSetConfig(const PinmameConfig* const p_config);
 PINMAMEAPI void PinmameSetPath(const PINMAME_FILE_TYPE fileType, const char* const p_path);
 PINMAMEAPI int PinmameGetCheat();
@@ -438,23 +732,68 @@ PINMAMEAPI int PinmameGetHandleMechanics();
 PINMAMEAPI void PinmameSetHandleMechanics(const int handleMechanics);
 PINMAMEAPI PINMAME_DMD_MODE PinmameGetDmdMode();
 PINMAMEAPI void PinmameSetDmdMode(const PINMAME_DMD_MODE dmdMode);
+PINMAMEAPI PINMAME_STATUS PinmameAddDmdPaletteTrigger(const uint64_t bitplaneHash, const uint32_t* const p_colors, const int numColors);
+PINMAMEAPI void PinmameClearDmdPaletteTriggers();
+PINMAMEAPI void PinmameSetDmdOnDemand(const int onDemand);
+PINMAMEAPI int PinmameGetDmdFrame(const int dmdIndex, uint8_t* const p_luminance, uint8_t* const p_bitplane, const int size);
+PINMAMEAPI PINMAME_VIDEO_FORMAT PinmameGetVideoFormat();
+PINMAMEAPI void PinmameSetVideoFormat(const PINMAME_VIDEO_FORMAT videoFormat);
+PINMAMEAPI int PinmameGetVideoPalette(uint32_t* const p_palette, const int maxColors);
 PINMAMEAPI PINMAME_SOUND_MODE PinmameGetSoundMode();
 PINMAMEAPI void PinmameSetSoundMode(const PINMAME_SOUND_MODE soundMode);
+PINMAMEAPI PINMAME_SPEED_MODE PinmameGetSpeedMode();
+PINMAMEAPI void PinmameSetSpeedMode(const PINMAME_SPEED_MODE speedMode, const int frameDecimation);
+PINMAMEAPI void PinmameSetAudioChannels(const int channels);
+PINMAMEAPI void PinmameSetThreadScheduling(const PINMAME_THREAD thread, const uint64_t affinityMask, const int realtimePriority);
+PINMAMEAPI void PinmameSetRomShareDir(const char* const p_path);
+PINMAMEAPI double PinmameGetEmulationSpeed();
+PINMAMEAPI void PinmameSetSpeedGovernor(const int maxLevel);
+PINMAMEAPI int PinmameGetSpeedGovernorLevel();
+PINMAMEAPI void PinmameSetOutputExport(const char* const p_endpoint, const int rate);
+PINMAMEAPI void PinmameSetNetPublish(const char* const p_endpoint, const int dmdRate, const int outputRate, const int raw);
+PINMAMEAPI int PinmameGetCpuStats(PinmameCpuStats* const p_stats, const int maxCpus);
+PINMAMEAPI void PinmameSetLatencyTelemetry(const int enable);
+PINMAMEAPI PINMAME_STATUS PinmameGetLatencyStats(const PINMAME_LATENCY stage, PinmameLatencyStats* const p_stats);
+PINMAMEAPI void PinmameSetTimerProfiling(const int enable);
+PINMAMEAPI int PinmameGetTimerStats(PinmameTimerStats* const p_stats, const int maxTimers);
+PINMAMEAPI void PinmameSetAutoInterleave(const int stretch);
+PINMAMEAPI PINMAME_STATUS PinmameGetInterleaveStats(uint32_t* const p_slices, double* const p_average);
 PINMAMEAPI PINMAME_STATUS PinmameRun(const char* const p_name);
+PINMAMEAPI PINMAME_STATUS PinmameSwitchGame(const char* const p_name);
 PINMAMEAPI int PinmameIsRunning();
 PINMAMEAPI PINMAME_STATUS PinmamePause(const int pause);
 PINMAMEAPI int PinmameIsPaused();
+PINMAMEAPI void PinmameSetEcoMode(const int idleSeconds, const int frameDecimation);
+PINMAMEAPI int PinmameIsEcoActive();
 PINMAMEAPI PINMAME_STATUS PinmameReset();
 PINMAMEAPI void PinmameStop();
+PINMAMEAPI PINMAME_STATUS PinmameSaveState(void* const p_buffer, size_t* const p_size);
+PINMAMEAPI PINMAME_STATUS PinmameLoadState(const void* const p_buffer, const size_t size);
+PINMAMEAPI void PinmameSetRewind(const size_t budgetBytes, const double intervalInS);
+PINMAMEAPI PINMAME_STATUS PinmameRewind(const double timeInS);
+PINMAMEAPI void PinmameSetWarmStart(const double bootTimeInS);
+PINMAMEAPI void PinmameSetProfiler(const char* const p_traceFile, const char* const p_csvFile, const double csvIntervalInS);
+PINMAMEAPI PINMAME_STATUS PinmameSetRecording(const char* const p_path, const double checkpointIntervalInS);
+PINMAMEAPI PINMAME_STATUS PinmameSetReplay(const char* const p_path);
+PINMAMEAPI PINMAME_STATUS PinmameGetReplayStatus(PinmameReplayStatus* const p_status);
+PINMAMEAPI PINMAME_STATUS PinmameSetGoldenOutput(const char* const p_path, const PINMAME_GOLDEN_MODE mode, const int framesPerCrc);
+PINMAMEAPI PINMAME_STATUS PinmameGetGoldenStatus(PinmameGoldenStatus* const p_status);
+PINMAMEAPI PINMAME_STATUS PinmameSetCpuTrace(const char* const p_path, const uint32_t cpuMask, const double stateIntervalInS);
+PINMAMEAPI void PinmameSetPcSampling(const char* const p_reportFile, const double intervalInS, const int topN);
 PINMAMEAPI PINMAME_HARDWARE_GEN PinmameGetHardwareGen();
 PINMAMEAPI int PinmameGetSwitch(const int swNo);
 PINMAMEAPI void PinmameSetSwitch(const int swNo, const int state);
 PINMAMEAPI void PinmameSetSwitches(const PinmameSwitchState* const p_states, const int numSwitches);
+PINMAMEAPI int PinmameQueueSwitchEvents(const PinmameSwitchEvent* const p_events, const int numEvents);
 PINMAMEAPI uint32_t PinmameGetSolenoidMask(const int low);
 PINMAMEAPI void PinmameSetSolenoidMask(const int low, const uint32_t mask);
 PINMAMEAPI PINMAME_MOD_OUTPUT_TYPE PinmameGetModOutputType(const int output, const int no);
 PINMAMEAPI void PinmameSetModOutputType(const int output, const int no, const PINMAME_MOD_OUTPUT_TYPE type);
+PINMAMEAPI int PinmameGetOutputWatched(const int output, const int no);
+PINMAMEAPI void PinmameSetOutputWatched(const int output, const int no, const int watched);
+PINMAMEAPI int PinmameGetOutputOverruns(const int output, const int no);
 PINMAMEAPI void PinmameSetTimeFence(const double timeInS);
+PINMAMEAPI void PinmameGetTimeFenceStats(PinmameTimeFenceStats* const p_stats);
 PINMAMEAPI int PinmameGetMaxSolenoids();
 PINMAMEAPI int PinmameGetSolenoid(const int solNo);
 PINMAMEAPI int PinmameGetChangedSolenoids(PinmameSolenoidState* const p_changedStates);
@@ -466,14 +805,32 @@ PINMAMEAPI int PinmameGetGI(const int giNo);
 PINMAMEAPI int PinmameGetChangedGIs(PinmameGIState* const p_changedStates);
 PINMAMEAPI int PinmameGetMaxLEDs();
 PINMAMEAPI int PinmameGetChangedLEDs(const uint64_t mask, const uint64_t, PinmameLEDState* const p_changedStates);
+PINMAMEAPI PINMAME_STATUS PinmameGetChangedOutputs(PinmameOutputBatch* const p_batch);
+PINMAMEAPI void PinmameOpenChangeJournal(PinmameChangeJournalCursor* const p_cursor);
+PINMAMEAPI void PinmameCloseChangeJournal(PinmameChangeJournalCursor* const p_cursor);
+PINMAMEAPI int PinmameReadChangeJournal(PinmameChangeJournalCursor* const p_cursor, PinmameOutputChange* const p_changes, const int maxChanges);
+PINMAMEAPI void PinmameSetOutputPush(const double intervalInS, const uint64_t immediateSolenoids, PinmameOnOutputsUpdatedCallback callback);
+PINMAMEAPI void PinmameSetNodeBus(const PINMAME_NODEBUS_MODE mode, PinmameOnNodeBusMessagesCallback callback);
+PINMAMEAPI int PinmameQueueNodeBusResponse(const uint8_t* const p_data, const int size);
+PINMAMEAPI PINMAME_STATUS PinmameGetDisplayFrame(const int index, PinmameDisplayFrame* const p_frame);
+PINMAMEAPI int PinmameGetAudio(void* const p_buffer, const int samples);
+PINMAMEAPI void PinmameGetAudioQueueInfo(PinmameAudioQueueInfo* const p_info);
+PINMAMEAPI int PinmameGetAudioXruns(PinmameAudioXrun* const p_xruns, const int maxXruns);
+PINMAMEAPI void PinmameSetAudioProfiling(const int enable);
+PINMAMEAPI int PinmameGetAudioStreamStats(PinmameAudioStreamStats* const p_stats, const int maxStreams);
 PINMAMEAPI int PinmameGetMaxMechs();
 PINMAMEAPI int PinmameGetMech(const int mechNo);
 PINMAMEAPI PINMAME_STATUS PinmameSetMech(const int mechNo, const PinmameMechConfig* const p_mechConfig);
 PINMAMEAPI int PinmameGetMaxSoundCommands();
 PINMAMEAPI int PinmameGetNewSoundCommands(PinmameSoundCommand* const p_newCommands);
+PINMAMEAPI void PinmameOpenSoundCommands(PinmameSoundCommandCursor* const p_cursor);
+PINMAMEAPI int PinmameReadSoundCommands(PinmameSoundCommandCursor* const p_cursor, PinmameSoundCommandEntry* const p_commands, const int maxCommands);
 PINMAMEAPI int PinmameGetDIP(const int dipBank);
 PINMAMEAPI void PinmameSetDIP(const int dipBank, const int value);
 PINMAMEAPI int PinmameGetMaxNVRAM();
 PINMAMEAPI int PinmameGetNVRAM(PinmameNVRAMState* const p_nvramStates);
 PINMAMEAPI int PinmameGetChangedNVRAM(PinmameNVRAMState* const p_nvramStates);
+PINMAMEAPI void PinmameSetNVRAMAutosave(const double intervalInS);
+PINMAMEAPI int PinmameWatchMemory(const int cpu, const uint32_t start, const int length, PinmameOnMemoryChangedCallback callback);
+PINMAMEAPI PINMAME_STATUS PinmameUnwatchMemory(const int watchId);
 PINMAMEAPI void PinmameSetUserData(const void* p_userData);
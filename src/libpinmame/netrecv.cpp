@@ -0,0 +1,211 @@
+// license:BSD-3-Clause
+
+// Reference receiver of the network publisher (see src/wpc/netpub.h for the protocol): joins the multicast
+// group, rebuilds the DMD frames from their changed rows and keeps the output values, then prints the DMD
+// as text and the output changes as they arrive, with the number of lost datagrams.
+//
+//   pinmame_netrecv [-q] address:port
+//
+// -q only prints the output changes and the statistics. IPv6 addresses are given in brackets.
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef SOCKET Socket;
+#else
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+typedef int Socket;
+#define INVALID_SOCKET (-1)
+#define closesocket close
+#endif
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#define NETPUB_VERSION 1
+#define NETPUB_DMD 1
+#define NETPUB_OUTPUTS 2
+#define NETPUB_KEY 0x0001
+#define NETPUB_HEADER 16
+#define NETPUB_DMD_HEADER 32
+
+typedef struct {
+	int width;
+	int height;
+	int format;
+	int frameNo;
+	bool complete; // a full frame was received since the start
+	std::vector<uint8_t> dots;
+} Dmd;
+
+static uint16_t Get16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t Get32(const uint8_t* p) { return Get16(p) | ((uint32_t)Get16(p + 2) << 16); }
+
+static void PrintDmd(const Dmd& dmd, int display, double time)
+{
+	static const char shades[] = " .:-=+*#%@";
+	printf("\x1b[H-- DMD %d  %dx%d  frame %d  t=%.3f\n", display, dmd.width, dmd.height, dmd.frameNo, time);
+	for (int y = 0; y < dmd.height; y++) {
+		std::string line;
+		for (int x = 0; x < dmd.width; x++) {
+			const int level = dmd.format ? dmd.dots[y * dmd.width + x] * 17 : dmd.dots[y * dmd.width + x]; // raw shades are 0..15
+			line += shades[level * 9 / 255];
+		}
+		printf("%s\n", line.c_str());
+	}
+}
+
+static bool Open(const char* p_endpoint, Socket& sock)
+{
+	std::string host = p_endpoint;
+	const size_t colon = host.rfind(':');
+	if (colon == std::string::npos)
+		return false;
+	const std::string port = host.substr(colon + 1);
+	host = host.substr(0, colon);
+	if (host.size() >= 2 && host.front() == '[' && host.back() == ']')
+		host = host.substr(1, host.size() - 2);
+
+	addrinfo hints = {}, *p_res = NULL;
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_DGRAM;
+	if (getaddrinfo(host.c_str(), port.c_str(), &hints, &p_res) != 0 || !p_res)
+		return false;
+
+	sock = socket(p_res->ai_family, SOCK_DGRAM, IPPROTO_UDP);
+	if (sock == INVALID_SOCKET) {
+		freeaddrinfo(p_res);
+		return false;
+	}
+	int on = 1;
+	setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, (const char*)&on, sizeof(on)); // several receivers on the same computer
+
+	// bind to the port on any address, then join the group if the address is a multicast one
+	bool ok;
+	if (p_res->ai_family == AF_INET) {
+		sockaddr_in any = {};
+		any.sin_family = AF_INET;
+		any.sin_port = ((sockaddr_in*)p_res->ai_addr)->sin_port;
+		ok = bind(sock, (sockaddr*)&any, sizeof(any)) == 0;
+		const in_addr group = ((sockaddr_in*)p_res->ai_addr)->sin_addr;
+		if (ok && (ntohl(group.s_addr) >> 28) == 0xE) {
+			ip_mreq mreq = {};
+			mreq.imr_multiaddr = group;
+			ok = setsockopt(sock, IPPROTO_IP, IP_ADD_MEMBERSHIP, (const char*)&mreq, sizeof(mreq)) == 0;
+		}
+	}
+	else {
+		sockaddr_in6 any = {};
+		any.sin6_family = AF_INET6;
+		any.sin6_port = ((sockaddr_in6*)p_res->ai_addr)->sin6_port;
+		ok = bind(sock, (sockaddr*)&any, sizeof(any)) == 0;
+		const in6_addr group = ((sockaddr_in6*)p_res->ai_addr)->sin6_addr;
+		if (ok && group.s6_addr[0] == 0xFF) {
+			ipv6_mreq mreq = {};
+			mreq.ipv6mr_multiaddr = group;
+			ok = setsockopt(sock, IPPROTO_IPV6, IPV6_JOIN_GROUP, (const char*)&mreq, sizeof(mreq)) == 0;
+		}
+	}
+	freeaddrinfo(p_res);
+	return ok;
+}
+
+int main(int argc, char* argv[])
+{
+	bool quiet = false;
+	const char* p_endpoint = NULL;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-q") == 0)
+			quiet = true;
+		else
+			p_endpoint = argv[i];
+	}
+	if (!p_endpoint) {
+		fprintf(stderr, "usage: pinmame_netrecv [-q] address:port\n");
+		return 2;
+	}
+
+#if defined(_WIN32) || defined(_WIN64)
+	WSADATA wsaData;
+	WSAStartup(MAKEWORD(2, 2), &wsaData);
+#endif
+	Socket sock = INVALID_SOCKET;
+	if (!Open(p_endpoint, sock)) {
+		fprintf(stderr, "unable to receive from %s\n", p_endpoint);
+		return 2;
+	}
+	if (!quiet)
+		printf("\x1b[2J");
+
+	Dmd dmds[2] = {};
+	bool started = false;
+	uint32_t nextSequence = 0;
+	uint64_t received = 0, lost = 0;
+	uint8_t datagram[65536];
+
+	for (;;) {
+		const int length = (int)recv(sock, (char*)datagram, sizeof(datagram), 0);
+		if (length < NETPUB_HEADER || memcmp(datagram, "PMNP", 4) != 0 || datagram[4] != NETPUB_VERSION)
+			continue;
+
+		const uint32_t sequence = Get32(datagram + 8);
+		if (started && sequence != nextSequence)
+			lost += (uint32_t)(sequence - nextSequence) < 0x80000000u ? sequence - nextSequence : 0; // late datagrams are not counted
+		started = true;
+		nextSequence = sequence + 1;
+		received++;
+		const double time = Get32(datagram + 12) / 1000000.0;
+		const bool key = (Get16(datagram + 6) & NETPUB_KEY) != 0;
+
+		if (datagram[5] == NETPUB_DMD && length >= NETPUB_DMD_HEADER) {
+			const int display = datagram[16] & 1;
+			Dmd& dmd = dmds[display];
+			const int width = Get16(datagram + 18), height = Get16(datagram + 20), frameNo = Get16(datagram + 22);
+			if (width != dmd.width || height != dmd.height || datagram[17] != dmd.format) {
+				dmd.width = width;
+				dmd.height = height;
+				dmd.format = datagram[17];
+				dmd.complete = false;
+				dmd.dots.assign((size_t)width * height, 0);
+			}
+			if (!quiet && dmd.complete && frameNo != dmd.frameNo) // the previous frame is over
+				PrintDmd(dmd, display, time);
+			dmd.frameNo = frameNo;
+			dmd.complete |= key;
+
+			const int rowSize = dmd.format ? (width + 1) / 2 : width;
+			for (int pos = NETPUB_DMD_HEADER; pos + 1 + rowSize <= length; pos += 1 + rowSize) {
+				const int y = datagram[pos];
+				if (y >= height)
+					break;
+				uint8_t* const p_row = &dmd.dots[(size_t)y * width];
+				if (dmd.format)
+					for (int x = 0; x < width; x++)
+						p_row[x] = (datagram[pos + 1 + x / 2] >> ((x & 1) * 4)) & 0x0f;
+				else
+					memcpy(p_row, datagram + pos + 1, width);
+			}
+		}
+		else if (datagram[5] == NETPUB_OUTPUTS) {
+			std::string line;
+			char entry[32];
+			for (int pos = NETPUB_HEADER; pos + 4 <= length; pos += 4) {
+				snprintf(entry, sizeof(entry), " %c%d=%d", datagram[pos], Get16(datagram + pos + 2), datagram[pos + 1]);
+				line += entry;
+			}
+			if (!line.empty())
+				printf("\x1b[%d;1H\x1b[K%.6f%s%s\n", quiet ? 1 : 2 + dmds[0].height + 1, time, key ? " (full)" : "", line.substr(0, 200).c_str());
+		}
+		printf("\x1b[%d;1H\x1b[Kreceived %llu  lost %llu\n", quiet ? 2 : 2 + dmds[0].height + 2, (unsigned long long)received, (unsigned long long)lost);
+		fflush(stdout);
+	}
+
+	closesocket(sock);
+	return 0;
+}
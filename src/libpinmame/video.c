@@ -447,8 +447,8 @@ void throttle_speed_part(int part, int totalparts)
 	//if (win_sync_refresh)
 	//	return;
 
-	// if we're only syncing on an emulation fence, bail now
-	if (options.time_fence != 0.0 && time_fence_is_supported())
+	// if we're only syncing on an emulation fence, or running unthrottled, bail now
+	if ((options.time_fence != 0.0 && time_fence_is_supported()) || !throttle)
 		return;
 
 	// this counts as idle time
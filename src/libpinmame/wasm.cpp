@@ -0,0 +1,199 @@
+// license:BSD-3-Clause
+
+// Web glue of the Emscripten build (PLATFORM=wasm, see src/libpinmame/web): the emulation runs in its own
+// pthread (a web worker) and hands its output to the browser through the shared wasm memory, so neither
+// the audio nor the displays need a message per frame:
+//
+// - audio: the AudioWorklet (web/pinmame-audio-worklet.js) reads the pull mode audio queue of libpinmame in
+//   place, with the PinmameGetAudio protocol; the emulation keeps pacing itself on the queue fill level.
+// - displays: every display update is copied to a slot of the frame ring below, which the page reads from
+//   requestAnimationFrame (web/pinmame-web.js). Each slot is guarded by a sequence number, odd while the
+//   slot is written and 2 * (frame + 1) once frame was written to it, so the reader can tell a frame it
+//   copied was overwritten meanwhile and drop it.
+//
+// pinmame_wasm_rings returns the address of WasmRings, the layout the JS side reads with Atomics.
+
+#include <emscripten/emscripten.h>
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "libpinmame.h"
+
+extern "C" void PinmameWasmGetAudioQueue(uint8_t** const pp_data, int* const p_samples, uint32_t** const pp_read, uint32_t** const pp_write, int32_t** const pp_underruns);
+
+#define WASM_RINGS_VERSION 1
+#define WASM_FRAME_SLOTS   16    // must be a power of 2
+#define WASM_FRAME_DATA    65536 // 256x64 DMD with a uint32_t per dot (PINMAME_DMD_MODE_COLOR)
+
+typedef struct {
+	std::atomic<uint32_t> sequence;
+	int32_t index;
+	int32_t type;   // PINMAME_DISPLAY_TYPE
+	int32_t width;  // dots for DMDs, characters for the alphanumeric displays
+	int32_t height;
+	int32_t depth;
+	int32_t size;   // bytes of data used
+	uint8_t data[WASM_FRAME_DATA];
+} WasmFrameSlot;
+
+// all the fields are 32 bit words, addresses included (wasm32)
+typedef struct {
+	int32_t version;
+	std::atomic<int32_t> state; // last cb_OnStateUpdated state
+	// audio: PinmameWasmGetAudioQueue, interleaved float samples
+	uint32_t audioData;
+	uint32_t audioRead;
+	uint32_t audioWrite;
+	uint32_t audioUnderruns;
+	int32_t audioSamples;
+	int32_t audioChannels;
+	int32_t audioSampleRate;
+	// displays
+	std::atomic<uint32_t> frameCount; // frames written, the last one is in slot (frameCount - 1) & (frameSlots - 1)
+	int32_t frameSlots;
+	int32_t frameSlotSize;
+	uint32_t frameData;
+	int32_t frameDataOffset; // of WasmFrameSlot::data
+} WasmRings;
+
+static WasmRings _rings;
+static WasmFrameSlot _frameSlots[WASM_FRAME_SLOTS];
+static std::atomic<uint8_t> _keys[256];
+
+/******************************************************
+ * Callbacks
+ ******************************************************/
+
+static void PINMAMECALLBACK OnStateUpdated(int state, const void* p_userData)
+{
+	_rings.state.store(state, std::memory_order_release);
+}
+
+static void PINMAMECALLBACK OnDisplayAvailable(int index, int displayCount, PinmameDisplayLayout* p_displayLayout, const void* p_userData)
+{
+}
+
+static void PINMAMECALLBACK OnDisplayUpdated(int index, void* p_displayData, PinmameDisplayLayout* p_displayLayout, const void* p_userData)
+{
+	if (!p_displayData)
+		return;
+
+	int size;
+	if (p_displayLayout->type == PINMAME_DISPLAY_TYPE_VIDEO)
+		return; // not supported, the video games are not the kiosk ones
+	else if ((p_displayLayout->type & PINMAME_DISPLAY_TYPE_DMD) == PINMAME_DISPLAY_TYPE_DMD)
+		size = p_displayLayout->width * p_displayLayout->height * (int)sizeof(uint32_t);
+	else
+		size = p_displayLayout->length * (int)sizeof(uint16_t);
+	if (size > WASM_FRAME_DATA)
+		return;
+
+	const uint32_t frame = _rings.frameCount.load(std::memory_order_relaxed);
+	WasmFrameSlot* const p_slot = &_frameSlots[frame & (WASM_FRAME_SLOTS - 1)];
+	p_slot->sequence.store(2 * frame + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	p_slot->index = index;
+	p_slot->type = p_displayLayout->type;
+	p_slot->width = (p_displayLayout->type & PINMAME_DISPLAY_TYPE_DMD) == PINMAME_DISPLAY_TYPE_DMD ? p_displayLayout->width : p_displayLayout->length;
+	p_slot->height = p_displayLayout->height;
+	p_slot->depth = p_displayLayout->depth;
+	p_slot->size = size;
+	memcpy(p_slot->data, p_displayData, size);
+	p_slot->sequence.store(2 * (frame + 1), std::memory_order_release);
+	_rings.frameCount.store(frame + 1, std::memory_order_release);
+}
+
+static int PINMAMECALLBACK OnAudioAvailable(PinmameAudioInfo* p_audioInfo, const void* p_userData)
+{
+	_rings.audioChannels = p_audioInfo->channels;
+	_rings.audioSampleRate = (int32_t)p_audioInfo->sampleRate;
+	return p_audioInfo->samplesPerFrame;
+}
+
+static int PINMAMECALLBACK IsKeyPressed(PINMAME_KEYCODE keycode, const void* p_userData)
+{
+	return keycode >= 0 && keycode < 256 && _keys[keycode].load(std::memory_order_relaxed);
+}
+
+static void PINMAMECALLBACK OnLogMessage(PINMAME_LOG_LEVEL logLevel, const char* format, va_list args, const void* p_userData)
+{
+	if (logLevel == PINMAME_LOG_LEVEL_ERROR) {
+		vfprintf(stderr, format, args);
+		fputc('\n', stderr);
+	}
+}
+
+/******************************************************
+ * Exported functions
+ ******************************************************/
+
+// Starts p_name with the ROMs in /pinmame/roms of the Emscripten file system, rendering the audio at
+// sampleRate (the AudioContext one, so the worklet doesn't resample); returns a PINMAME_STATUS
+extern "C" EMSCRIPTEN_KEEPALIVE int pinmame_wasm_start(const char* p_name, int sampleRate)
+{
+	PinmameConfig config = {
+		PINMAME_AUDIO_FORMAT_FLOAT,
+		sampleRate,
+		"/pinmame/",
+		&OnStateUpdated,
+		&OnDisplayAvailable,
+		&OnDisplayUpdated,
+		&OnAudioAvailable,
+		NULL, // pull mode: the worklet reads the audio queue
+		NULL,
+		NULL,
+		NULL,
+		NULL,
+		&IsKeyPressed,
+		&OnLogMessage,
+		NULL,
+	};
+	PinmameSetConfig(&config);
+	PinmameSetHandleKeyboard(0);
+	PinmameSetDmdMode(PINMAME_DMD_MODE_COLOR);
+	PinmameSetAudioChannels(2);
+
+	_rings.state = 0;
+	_rings.frameCount = 0;
+	for (int i = 0; i < WASM_FRAME_SLOTS; i++)
+		_frameSlots[i].sequence = 0;
+	return PinmameRun(p_name);
+}
+
+extern "C" EMSCRIPTEN_KEEPALIVE void pinmame_wasm_stop()
+{
+	PinmameStop();
+}
+
+extern "C" EMSCRIPTEN_KEEPALIVE void pinmame_wasm_set_key(int keycode, int pressed)
+{
+	if (keycode >= 0 && keycode < 256)
+		_keys[keycode].store(pressed ? 1 : 0, std::memory_order_relaxed);
+}
+
+extern "C" EMSCRIPTEN_KEEPALIVE uint32_t pinmame_wasm_rings()
+{
+	uint8_t* p_data;
+	uint32_t *p_read, *p_write;
+	int32_t* p_underruns;
+	PinmameWasmGetAudioQueue(&p_data, &_rings.audioSamples, &p_read, &p_write, &p_underruns);
+
+	_rings.version = WASM_RINGS_VERSION;
+	_rings.audioData = (uint32_t)(uintptr_t)p_data;
+	_rings.audioRead = (uint32_t)(uintptr_t)p_read;
+	_rings.audioWrite = (uint32_t)(uintptr_t)p_write;
+	_rings.audioUnderruns = (uint32_t)(uintptr_t)p_underruns;
+	_rings.frameSlots = WASM_FRAME_SLOTS;
+	_rings.frameSlotSize = (int32_t)sizeof(WasmFrameSlot);
+	_rings.frameData = (uint32_t)(uintptr_t)_frameSlots;
+	_rings.frameDataOffset = (int32_t)offsetof(WasmFrameSlot, data);
+	return (uint32_t)(uintptr_t)&_rings;
+}
+
+int main()
+{
+	return 0; // the module stays alive (EXIT_RUNTIME is off), the page drives it through the exports
+}
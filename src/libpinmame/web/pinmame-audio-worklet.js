@@ -0,0 +1,57 @@
+// license:BSD-3-Clause
+
+// AudioWorklet processor playing the pull mode audio queue of libpinmame straight from the shared wasm
+// memory (see src/libpinmame/wasm.cpp), with the PinmameGetAudio protocol: the interleaved float samples
+// between the read and write positions are copied, then the read position is released to the emulation.
+
+const RINGS_STATE = 1;
+const RINGS_AUDIO_DATA = 2;
+const RINGS_AUDIO_READ = 3;
+const RINGS_AUDIO_WRITE = 4;
+const RINGS_AUDIO_UNDERRUNS = 5;
+const RINGS_AUDIO_SAMPLES = 6;
+const RINGS_AUDIO_CHANNELS = 7;
+const RINGS_WORDS = 14;
+
+class PinmameAudioProcessor extends AudioWorkletProcessor {
+	constructor(options) {
+		super();
+		const { buffer, rings } = options.processorOptions;
+		this.rings = new Int32Array(buffer, rings, RINGS_WORDS);
+		this.words = new Int32Array(buffer);
+		this.readIndex = this.rings[RINGS_AUDIO_READ] >> 2;
+		this.writeIndex = this.rings[RINGS_AUDIO_WRITE] >> 2;
+		this.underrunsIndex = this.rings[RINGS_AUDIO_UNDERRUNS] >> 2;
+		this.mask = this.rings[RINGS_AUDIO_SAMPLES] - 1;
+		this.data = new Float32Array(buffer, this.rings[RINGS_AUDIO_DATA], this.rings[RINGS_AUDIO_SAMPLES] * 2);
+	}
+
+	process(inputs, outputs) {
+		const left = outputs[0][0], right = outputs[0][1] || outputs[0][0];
+		const channels = Atomics.load(this.rings, RINGS_AUDIO_CHANNELS) || 2;
+		const write = Atomics.load(this.words, this.writeIndex);
+		const read = this.words[this.readIndex]; // only written here
+
+		let count = (write - read) | 0;
+		if (count < left.length) {
+			if (Atomics.load(this.rings, RINGS_STATE) === 1)
+				Atomics.add(this.words, this.underrunsIndex, 1);
+			count = Math.max(count, 0);
+		}
+		else
+			count = left.length;
+
+		for (let i = 0; i < count; i++) {
+			const pos = ((read + i) & this.mask) * channels;
+			left[i] = this.data[pos];
+			right[i] = this.data[pos + channels - 1];
+		}
+		left.fill(0, count);
+		right.fill(0, count);
+
+		Atomics.store(this.words, this.readIndex, (read + count) | 0);
+		return true;
+	}
+}
+
+registerProcessor('pinmame-audio', PinmameAudioProcessor);
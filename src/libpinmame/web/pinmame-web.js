@@ -0,0 +1,127 @@
+// license:BSD-3-Clause
+
+// Page side of the Emscripten build: runs the module in a dedicated worker (pinmame-worker.js), plays the
+// audio from an AudioWorklet (pinmame-audio-worklet.js) and draws the main DMD from the frame ring of
+// src/libpinmame/wasm.cpp on each animation frame. Both read the shared wasm memory, the worker is only
+// messaged to start and stop a game and for the inputs, so nothing is posted per frame.
+//
+// The page must be cross-origin isolated (Cross-Origin-Opener-Policy: same-origin and
+// Cross-Origin-Embedder-Policy: require-corp) for the memory to be shared, and start must be called from a
+// user gesture for the audio to play:
+//
+//   const pinmame = new PinmameWeb(canvas);
+//   await pinmame.start('t2_l8', [{ name: 't2_l8.zip', data: arrayBuffer }]);
+//   pinmame.setSwitch(13, 1);
+
+const RINGS_FRAME_COUNT = 9;
+const RINGS_FRAME_SLOTS = 10;
+const RINGS_FRAME_SLOT_SIZE = 11;
+const RINGS_FRAME_DATA = 12;
+const RINGS_FRAME_DATA_OFFSET = 13;
+const RINGS_WORDS = 14;
+
+const SLOT_SEQUENCE = 0;
+const SLOT_INDEX = 1;
+const SLOT_TYPE = 2;
+const SLOT_WIDTH = 3;
+const SLOT_HEIGHT = 4;
+const SLOT_SIZE = 6;
+const SLOT_WORDS = 7;
+
+const DISPLAY_TYPE_DMD = 14;
+const DISPLAY_TYPE_VIDEO = 15;
+
+export class PinmameWeb {
+	constructor(canvas, baseUrl = new URL('.', import.meta.url)) {
+		this.canvas = canvas;
+		this.baseUrl = baseUrl;
+		this.frame = document.createElement('canvas'); // DMD at its own size, scaled onto canvas
+		this.running = false;
+	}
+
+	async start(game, files) {
+		this.audio = new AudioContext({ latencyHint: 'interactive' });
+		await this.audio.audioWorklet.addModule(new URL('pinmame-audio-worklet.js', this.baseUrl));
+
+		this.worker = new Worker(new URL('pinmame-worker.js', this.baseUrl));
+		const started = await new Promise((resolve) => {
+			this.worker.onmessage = (e) => { if (e.data.type === 'started') resolve(e.data); };
+			this.worker.postMessage({ type: 'start', game, files, sampleRate: this.audio.sampleRate }, files.map((file) => file.data));
+		});
+		if (started.status !== 0)
+			throw new Error(`unable to start ${game} (status ${started.status})`);
+
+		this.buffer = started.buffer;
+		this.rings = new Int32Array(this.buffer, started.rings, RINGS_WORDS);
+		this.frameCursor = 0;
+
+		this.node = new AudioWorkletNode(this.audio, 'pinmame-audio', {
+			numberOfInputs: 0,
+			outputChannelCount: [2],
+			processorOptions: { buffer: this.buffer, rings: started.rings }
+		});
+		this.node.connect(this.audio.destination);
+
+		this.running = true;
+		requestAnimationFrame(() => this.draw());
+	}
+
+	async stop() {
+		if (!this.running)
+			return;
+		this.running = false;
+		await new Promise((resolve) => {
+			this.worker.onmessage = (e) => { if (e.data.type === 'stopped') resolve(); };
+			this.worker.postMessage({ type: 'stop' });
+		});
+		this.node.disconnect();
+		await this.audio.close();
+		this.worker.terminate();
+	}
+
+	setSwitch(number, state) {
+		this.worker.postMessage({ type: 'switch', number, state: state ? 1 : 0 });
+	}
+
+	setKey(code, pressed) { // PINMAME_KEYCODE, used by the game if the keyboard is handled
+		this.worker.postMessage({ type: 'key', code, pressed: pressed ? 1 : 0 });
+	}
+
+	// Copies the newest frame of the main DMD out of the ring; frames overwritten before or while they are
+	// copied are skipped, a newer one being there
+	draw() {
+		if (!this.running)
+			return;
+
+		const count = Atomics.load(this.rings, RINGS_FRAME_COUNT);
+		const slots = this.rings[RINGS_FRAME_SLOTS];
+		let dmd = null;
+		for (let frame = Math.max(this.frameCursor, count - slots); frame < count; frame++) {
+			const base = this.rings[RINGS_FRAME_DATA] + (frame & (slots - 1)) * this.rings[RINGS_FRAME_SLOT_SIZE];
+			const slot = new Int32Array(this.buffer, base, SLOT_WORDS);
+			const sequence = 2 * (frame + 1);
+			if (Atomics.load(slot, SLOT_SEQUENCE) !== sequence)
+				continue;
+			const type = slot[SLOT_TYPE];
+			if ((type & DISPLAY_TYPE_DMD) !== DISPLAY_TYPE_DMD || type === DISPLAY_TYPE_VIDEO || slot[SLOT_INDEX] !== 0)
+				continue;
+			const width = slot[SLOT_WIDTH], height = slot[SLOT_HEIGHT];
+			const dots = new Uint8ClampedArray(this.buffer, base + this.rings[RINGS_FRAME_DATA_OFFSET], slot[SLOT_SIZE]).slice();
+			if (Atomics.load(slot, SLOT_SEQUENCE) === sequence)
+				dmd = { width, height, dots };
+		}
+		this.frameCursor = count;
+
+		if (dmd) {
+			for (let i = 3; i < dmd.dots.length; i += 4)
+				dmd.dots[i] = 255; // 0x00BBGGRR dots
+			this.frame.width = dmd.width;
+			this.frame.height = dmd.height;
+			this.frame.getContext('2d').putImageData(new ImageData(dmd.dots, dmd.width, dmd.height), 0, 0);
+			const context = this.canvas.getContext('2d');
+			context.imageSmoothingEnabled = false;
+			context.drawImage(this.frame, 0, 0, this.canvas.width, this.canvas.height);
+		}
+		requestAnimationFrame(() => this.draw());
+	}
+}
@@ -0,0 +1,39 @@
+// license:BSD-3-Clause
+
+// Dedicated worker owning the PinMAME module of the Emscripten build (see src/libpinmame/wasm.cpp). The page
+// (pinmame-web.js) only messages it to start and stop a game and for the inputs: the emulation runs in a
+// pthread of the module, and the audio and the display frames are read from the shared wasm memory.
+
+importScripts('pinmame.js');
+
+let pinmame = null;
+
+onmessage = async (e) => {
+	const msg = e.data;
+	switch (msg.type) {
+	case 'start': {
+		if (!pinmame) {
+			const script = new URL('pinmame.js', self.location.href).href;
+			pinmame = await createPinmame({ mainScriptUrlOrBlob: script }); // the pthreads load pinmame.js, not this worker
+			for (const dir of ['roms', 'nvram', 'cfg'])
+				pinmame.FS.mkdirTree('/pinmame/' + dir);
+		}
+		for (const file of msg.files)
+			pinmame.FS.writeFile('/pinmame/roms/' + file.name, new Uint8Array(file.data));
+		const status = pinmame.ccall('pinmame_wasm_start', 'number', ['string', 'number'], [msg.game, msg.sampleRate]);
+		postMessage({ type: 'started', status, buffer: pinmame.HEAPU8.buffer, rings: pinmame._pinmame_wasm_rings() });
+		break;
+	}
+	case 'stop':
+		if (pinmame)
+			pinmame._pinmame_wasm_stop();
+		postMessage({ type: 'stopped' });
+		break;
+	case 'switch':
+		pinmame?._PinmameSetSwitch(msg.number, msg.state);
+		break;
+	case 'key':
+		pinmame?._pinmame_wasm_set_key(msg.code, msg.pressed);
+		break;
+	}
+};
@@ -12,8 +12,10 @@
 #include "fileio.h"
 #include "opc.h"
 #include "utils.h"
+#include <pthread.h>
 #include <stdio.h>
 #include <string.h>
+#include <unistd.h>
 
 extern char debugbuf[256]; // see hw_lib.c
 
@@ -22,6 +24,39 @@ pixel lisy_fc_leds[512];
 // the sink for our opc device (fadecandy)
 opc_sink lisy_opc_sink;
 
+//frames are sent by a sender thread, at most every LISY_FC_FRAME_US
+//lisy_fc_leds is the frame being built, protected by the mutex
+//lisy_fc_dirty is the number of leading pixels that changed since the last frame sent
+#define LISY_FC_FRAME_US 10000
+static pthread_mutex_t lisy_fc_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t lisy_fc_sender;
+static int lisy_fc_sender_on = 0;
+static int lisy_fc_dirty = 0;
+static int lisy_fc_failed = 0;
+
+//sender thread: one OPC message per frame with changes
+//OPC always starts at pixel 0, so we send up to the last changed pixel
+//and leave the pixels behind as they are on the fadecandy
+static void*
+lisy_fadecandy_sender(void* arg) {
+    pixel frame[512];
+    int count;
+
+    while (!lisy_fc_failed) {
+        usleep(LISY_FC_FRAME_US);
+        pthread_mutex_lock(&lisy_fc_mutex);
+        count = lisy_fc_dirty;
+        if (count)
+            memcpy(frame, lisy_fc_leds, count * sizeof(pixel));
+        lisy_fc_dirty = 0;
+        pthread_mutex_unlock(&lisy_fc_mutex);
+
+        if (count && !opc_put_pixels(lisy_opc_sink, 1, count, frame))
+            lisy_fc_failed = 1;
+    }
+    return NULL;
+}
+
 //init the fadecandy vars
 //and connection to fadecandyserver
 int
@@ -46,6 +81,17 @@ lisy_fadecandy_init(unsigned char system) {
     //set this to all connected LEDs (for activating GI )
     opc_put_pixels(lisy_opc_sink, 1, 512, lisy_fc_leds);
 
+    //from now on, frames are sent by the sender thread
+    if (!lisy_fc_sender_on) {
+        lisy_fc_dirty = lisy_fc_failed = 0;
+        if (pthread_create(&lisy_fc_sender, NULL, lisy_fadecandy_sender, NULL) != 0) {
+            fprintf(stderr, "Error starting fadecandy sender thread\n");
+            return -1;
+        }
+        pthread_detach(lisy_fc_sender);
+        lisy_fc_sender_on = 1;
+    }
+
     //start the fadecandy server: will be done in /usr/local/run_lisy
 
     //check for hw ???
@@ -58,27 +104,35 @@ int
 lisy_fadecandy_set_led(int lamp, unsigned char value) {
 
     int led;
+    pixel color = { 0, 0, 0 };
+
+    //the sender thread lost the connection
+    if (lisy_fc_failed)
+        return 0;
 
     //get the mapped led
     led = lisy_lamp_to_led_map[lamp].mapled;
 
     //assign the new colorcode to the pixel var
     if (value) {
-        lisy_fc_leds[led].r = lisy_lamp_to_led_map[lamp].r;
-        lisy_fc_leds[led].g = lisy_lamp_to_led_map[lamp].g;
-        lisy_fc_leds[led].b = lisy_lamp_to_led_map[lamp].b;
-    } else {
-        lisy_fc_leds[led].r = 0;
-        lisy_fc_leds[led].g = 0;
-        lisy_fc_leds[led].b = 0;
+        color.r = lisy_lamp_to_led_map[lamp].r;
+        color.g = lisy_lamp_to_led_map[lamp].g;
+        color.b = lisy_lamp_to_led_map[lamp].b;
+    }
+
+    //update the frame, we need the first n LED value to set LED n
+    //identical values do not trigger a new frame
+    pthread_mutex_lock(&lisy_fc_mutex);
+    if (memcmp(&lisy_fc_leds[led], &color, sizeof(pixel)) != 0) {
+        lisy_fc_leds[led] = color;
+        if (lisy_fc_dirty < led + 1)
+            lisy_fc_dirty = led + 1;
     }
+    pthread_mutex_unlock(&lisy_fc_mutex);
 
-    //set the LED, we need the first n LED value to set LED n
-    //we use channel No 1
     if (ls80dbg.bitv.lamps) {
-        sprintf(debugbuf, "Fadecandy: we set led %d with %d : %d %d %d \n", led, value, lisy_fc_leds[led].r,
-                lisy_fc_leds[led].g, lisy_fc_leds[led].b);
+        sprintf(debugbuf, "Fadecandy: we set led %d with %d : %d %d %d \n", led, value, color.r, color.g, color.b);
         lisy80_debug(debugbuf);
     }
-    return (opc_put_pixels(lisy_opc_sink, 1, led + 1, lisy_fc_leds));
+    return 1;
 }
@@ -11,6 +11,7 @@
 #include "lisy_api.h"
 #include "utils.h"
 #include <errno.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <string.h>
 #include <unistd.h>
@@ -22,11 +23,60 @@ extern char debugbuf[256]; // see hw_lib.c
 int fd_api;
 static long lisy_api_counter = 0;
 
-//lisy routine for writing to usb serial device
-//we do it here in order to beable to log all bytes send to APC
-//exceptions are 'init' and switch poll routine 'lisy_api_ask_for_changed_switch'
-int
-lisy_api_write(unsigned char* data, int count, int debug) {
+//batched commands
+//commands without answer (lamps, solenoids, displays) issued between lisy_api_batch_begin
+//and lisy_api_batch_end are collected here and sent with one write
+#define LISY_API_BATCH_SIZE 512
+static unsigned char lisy_api_batch[LISY_API_BATCH_SIZE];
+static int lisy_api_batch_len = 0;
+static int lisy_api_batch_level = 0;
+
+//switch reader thread
+//keeps one 'changed switch' poll on the line and queues the changed switches,
+//commands with an answer get the line once the pending poll is answered
+#define LISY_API_SW_QUEUE 64
+static pthread_t lisy_api_reader;
+static pthread_mutex_t lisy_api_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t lisy_api_cond = PTHREAD_COND_INITIALIZER;
+static int lisy_api_reader_on = 0;
+static int lisy_api_reader_paused = 0;
+static int lisy_api_sync_waiting = 0;
+static int lisy_api_poll_pending = 0;
+static unsigned char lisy_api_sw_queue[LISY_API_SW_QUEUE];
+static int lisy_api_sw_head = 0, lisy_api_sw_count = 0;
+
+//write to usb serial device, with the batched commands first
+//return number of bytes of data written
+static int
+lisy_api_send(unsigned char* data, int count) {
+
+    int ret, len;
+
+    pthread_mutex_lock(&lisy_api_mutex);
+    if (lisy_api_batch_len + count <= LISY_API_BATCH_SIZE) {
+        //all in one go
+        memcpy(lisy_api_batch + lisy_api_batch_len, data, count);
+        len = lisy_api_batch_len + count;
+        lisy_api_batch_len = 0;
+        ret = write(fd_api, lisy_api_batch, len);
+        if (ret == len)
+            ret = count;
+        else if (ret >= 0)
+            ret = -1;
+    } else {
+        if (lisy_api_batch_len > 0 && write(fd_api, lisy_api_batch, lisy_api_batch_len) != lisy_api_batch_len)
+            fprintf(stderr, "Batch Error writing to serial %s\n", strerror(errno));
+        lisy_api_batch_len = 0;
+        ret = write(fd_api, data, count);
+    }
+    pthread_mutex_unlock(&lisy_api_mutex);
+
+    return ret;
+}
+
+//log the bytes send to APC
+static void
+lisy_api_log(unsigned char* data, int count, int debug) {
 
     int i;
     char helpstr[10];
@@ -50,16 +100,200 @@ lisy_api_write(unsigned char* data, int count, int debug) {
             lisy_api_counter = 0;
         }
     }
+}
+
+//lisy routine for writing to usb serial device
+//we do it here in order to beable to log all bytes send to APC
+//exceptions are 'init' and switch poll routine 'lisy_api_ask_for_changed_switch'
+int
+lisy_api_write(unsigned char* data, int count, int debug) {
+
+    lisy_api_log(data, count, debug);
+    return (lisy_api_send(data, count));
+}
+
+//send the batched commands now
+void
+lisy_api_flush(void) {
+
+    pthread_mutex_lock(&lisy_api_mutex);
+    if (lisy_api_batch_len > 0 && write(fd_api, lisy_api_batch, lisy_api_batch_len) != lisy_api_batch_len)
+        fprintf(stderr, "Batch Error writing to serial %s\n", strerror(errno));
+    lisy_api_batch_len = 0;
+    pthread_mutex_unlock(&lisy_api_mutex);
+}
+
+//lisy routine for commands without answer
+//queued while a batch is open, written right away otherwise
+static int
+lisy_api_post(unsigned char* data, int count, int debug) {
+
+    if (lisy_api_batch_level == 0)
+        return (lisy_api_write(data, count, debug));
+
+    //full batch, send it first
+    if (lisy_api_batch_len + count > LISY_API_BATCH_SIZE)
+        lisy_api_flush();
+
+    lisy_api_log(data, count, debug);
+    pthread_mutex_lock(&lisy_api_mutex);
+    memcpy(lisy_api_batch + lisy_api_batch_len, data, count);
+    lisy_api_batch_len += count;
+    pthread_mutex_unlock(&lisy_api_mutex);
+
+    return (count);
+}
+
+//open a batch, batches can be nested
+void
+lisy_api_batch_begin(void) {
+    lisy_api_batch_level++;
+}
+
+//close a batch, the outermost one sends all commands with one write
+void
+lisy_api_batch_end(void) {
+    if (lisy_api_batch_level > 0 && --lisy_api_batch_level == 0)
+        lisy_api_flush();
+}
+
+//get the line for a command with an answer
+//the switch reader, if running, hands it over once its pending poll is answered
+static void
+lisy_api_sync_begin(void) {
+
+    pthread_mutex_lock(&lisy_api_mutex);
+    if (lisy_api_reader_on) {
+        lisy_api_sync_waiting = 1;
+        pthread_cond_broadcast(&lisy_api_cond);
+        while (!lisy_api_reader_paused)
+            pthread_cond_wait(&lisy_api_cond, &lisy_api_mutex);
+    }
+    pthread_mutex_unlock(&lisy_api_mutex);
+}
+
+//give the line back to the switch reader
+static void
+lisy_api_sync_end(void) {
+
+    pthread_mutex_lock(&lisy_api_mutex);
+    lisy_api_sync_waiting = 0;
+    pthread_cond_broadcast(&lisy_api_cond);
+    pthread_mutex_unlock(&lisy_api_mutex);
+}
+
+//switch reader thread
+//the APC answers in order, so with at most one poll pending every byte read is its answer
+static void*
+lisy_api_switch_reader(void* arg) {
+
+    unsigned char cmd = LISY_G_CHANGED_SW;
+    unsigned char my_switch;
+    int ret, timeouts = 0;
+
+    pthread_mutex_lock(&lisy_api_mutex);
+    while (lisy_api_reader_on) {
+        //a command with an answer is waiting for the line
+        if (lisy_api_sync_waiting && !lisy_api_poll_pending) {
+            lisy_api_reader_paused = 1;
+            pthread_cond_broadcast(&lisy_api_cond);
+            while (lisy_api_sync_waiting && lisy_api_reader_on)
+                pthread_cond_wait(&lisy_api_cond, &lisy_api_mutex);
+            lisy_api_reader_paused = 0;
+            continue;
+        }
+
+        //next poll, as long as there is room for the answer
+        if (!lisy_api_poll_pending && lisy_api_sw_count < LISY_API_SW_QUEUE && write(fd_api, &cmd, 1) == 1)
+            lisy_api_poll_pending = 1;
+        if (!lisy_api_poll_pending) {
+            pthread_mutex_unlock(&lisy_api_mutex);
+            delay(1);
+            pthread_mutex_lock(&lisy_api_mutex);
+            continue;
+        }
+
+        //wait for the answer, with the 0.1 sec driver timeout
+        pthread_mutex_unlock(&lisy_api_mutex);
+        ret = read(fd_api, &my_switch, 1);
+        pthread_mutex_lock(&lisy_api_mutex);
+
+        if (ret == 1) {
+            lisy_api_poll_pending = 0;
+            timeouts = 0;
+            if (my_switch != 0x7f) {
+                lisy_api_sw_queue[(lisy_api_sw_head + lisy_api_sw_count) % LISY_API_SW_QUEUE] = my_switch;
+                lisy_api_sw_count++;
+            } else {
+                //no change, poll again in a msec
+                pthread_mutex_unlock(&lisy_api_mutex);
+                delay(1);
+                pthread_mutex_lock(&lisy_api_mutex);
+            }
+        } else if (++timeouts >= 10) {
+            //no answer within a second, consider the poll lost
+            fprintf(stderr, "Switch reader: no answer from serial\n");
+            lisy_api_poll_pending = 0;
+            timeouts = 0;
+        }
+    }
+    lisy_api_reader_paused = 1;
+    pthread_cond_broadcast(&lisy_api_cond);
+    pthread_mutex_unlock(&lisy_api_mutex);
+
+    return NULL;
+}
+
+//start polling the switches from a thread
+//lisy_api_ask_for_changed_switch then never waits for the serial line
+int
+lisy_api_start_switch_reader(void) {
+
+    if (lisy_api_reader_on)
+        return 0;
+
+    lisy_api_reader_on = 1;
+    lisy_api_reader_paused = 0;
+    lisy_api_poll_pending = 0;
+    lisy_api_sw_head = lisy_api_sw_count = 0;
+    if (pthread_create(&lisy_api_reader, NULL, lisy_api_switch_reader, NULL) != 0) {
+        fprintf(stderr, "Error starting switch reader thread\n");
+        lisy_api_reader_on = 0;
+        return -1;
+    }
+
+    if (ls80dbg.bitv.basic)
+        lisy80_debug("switch reader thread started");
+
+    return 0;
+}
+
+//stop the switch reader thread
+void
+lisy_api_stop_switch_reader(void) {
+
+    if (!lisy_api_reader_on)
+        return;
+
+    pthread_mutex_lock(&lisy_api_mutex);
+    lisy_api_reader_on = 0;
+    pthread_cond_broadcast(&lisy_api_cond);
+    pthread_mutex_unlock(&lisy_api_mutex);
+    pthread_join(lisy_api_reader, NULL);
+}
 
-    return (write(fd_api, data, count));
+//are the switches polled from the reader thread?
+int
+lisy_api_switch_reader_running(void) {
+    return lisy_api_reader_on;
 }
 
 //send command cmd
 //read \0 terminated string and store into string content
 //return -2 in case we had problems to send  cmd
 //return -1 in case we had problems to receive string
-int
-lisy_api_read_string(unsigned char cmd, char* content) {
+static int
+lisy_api_read_string_locked(unsigned char cmd, char* content) {
 
     char nextbyte;
     int i, n, ret;
@@ -96,12 +330,24 @@ lisy_api_read_string(unsigned char cmd, char* content) {
     return (i);
 }
 
+//lisy_api_read_string with the line held for the answer (see lisy_api_sync_begin)
+int
+lisy_api_read_string(unsigned char cmd, char* content) {
+
+    int ret;
+
+    lisy_api_sync_begin();
+    ret = lisy_api_read_string_locked(cmd, content);
+    lisy_api_sync_end();
+    return ret;
+}
+
 //read one byte, and return data into *data
 //return -2 in case we had problems to send  cmd
 //return -1 in case we had problems to receive byte
 //return 0 otherwise
-unsigned char
-lisy_api_read_byte(unsigned char cmd, unsigned char* data) {
+static unsigned char
+lisy_api_read_byte_locked(unsigned char cmd, unsigned char* data) {
 
     //send command
     if (lisy_api_write(&cmd, 1, ls80dbg.bitv.basic) != 1)
@@ -121,13 +367,25 @@ lisy_api_read_byte(unsigned char cmd, unsigned char* data) {
     return (0);
 }
 
+//lisy_api_read_byte with the line held for the answer (see lisy_api_sync_begin)
+unsigned char
+lisy_api_read_byte(unsigned char cmd, unsigned char* data) {
+
+    unsigned char ret;
+
+    lisy_api_sync_begin();
+    ret = lisy_api_read_byte_locked(cmd, data);
+    lisy_api_sync_end();
+    return ret;
+}
+
 //read one byte, and return data into *data
 //blocking version, we wait 5 seconds before send error back
 //return -2 in case we had problems to send  cmd
 //return -1 in case we had problems to receive byte
 //return 0 otherwise
-unsigned char
-lisy_api_read_byte_wblock(unsigned char cmd, unsigned char* data) {
+static unsigned char
+lisy_api_read_byte_wblock_locked(unsigned char cmd, unsigned char* data) {
     uint8_t tries = 0;
     int ret;
 
@@ -168,13 +426,25 @@ lisy_api_read_byte_wblock(unsigned char cmd, unsigned char* data) {
     return (-1);
 }
 
+//lisy_api_read_byte_wblock with the line held for the answer (see lisy_api_sync_begin)
+unsigned char
+lisy_api_read_byte_wblock(unsigned char cmd, unsigned char* data) {
+
+    unsigned char ret;
+
+    lisy_api_sync_begin();
+    ret = lisy_api_read_byte_wblock_locked(cmd, data);
+    lisy_api_sync_end();
+    return ret;
+}
+
 //this command has an option
 //read answer of two byte, and return data into *data1 and *data2
 //return -2 in case we had problems to send  cmd
 //return -1 in case we had problems to receive byte
 //return 0 otherwise
-unsigned char
-lisy_api_read_2bytes(unsigned char cmd, unsigned char option, unsigned char* data1, unsigned char* data2) {
+static unsigned char
+lisy_api_read_2bytes_locked(unsigned char cmd, unsigned char option, unsigned char* data1, unsigned char* data2) {
 
     unsigned char cmd_data[2];
     //send command
@@ -199,6 +469,18 @@ lisy_api_read_2bytes(unsigned char cmd, unsigned char option, unsigned char* dat
     return (0);
 }
 
+//lisy_api_read_2bytes with the line held for the answer (see lisy_api_sync_begin)
+unsigned char
+lisy_api_read_2bytes(unsigned char cmd, unsigned char option, unsigned char* data1, unsigned char* data2) {
+
+    unsigned char ret;
+
+    lisy_api_sync_begin();
+    ret = lisy_api_read_2bytes_locked(cmd, option, data1, data2);
+    lisy_api_sync_end();
+    return ret;
+}
+
 //print some usefull parameters
 int
 lisy_api_print_hw_info(void) {
@@ -368,7 +650,7 @@ lisy_api_send_SEG7_to_disp(unsigned char disp, int num, uint16_t* data) {
     }
 
     //send it all
-    if (lisy_api_write(seg7_data, len + 2, ls80dbg.bitv.displays) != len + 2) {
+    if (lisy_api_post(seg7_data, len + 2, ls80dbg.bitv.displays) != len + 2) {
         fprintf(stderr, "ERROR write display\n");
         return (-2);
     }
@@ -467,7 +749,7 @@ lisy_api_send_SEG14_to_disp(unsigned char disp, int num, uint16_t* data) {
     }
 
     //send it all
-    if (lisy_api_write(seg14_data, len + 2, ls80dbg.bitv.displays) != len + 2) {
+    if (lisy_api_post(seg14_data, len + 2, ls80dbg.bitv.displays) != len + 2) {
         fprintf(stderr, "ERROR write display\n");
         return (-2);
     }
@@ -522,7 +804,7 @@ lisy_api_send_str_to_disp(unsigned char num, char* str) {
         for (i = 0; i < len; i++)
             cmd_data[i + 2] = str[i];
 
-        if (lisy_api_write(cmd_data, len + 2, ls80dbg.bitv.displays) != len + 2) {
+        if (lisy_api_post(cmd_data, len + 2, ls80dbg.bitv.displays) != len + 2) {
             fprintf(stderr, "ERROR write display\n");
             return (-2);
         }
@@ -532,12 +814,31 @@ lisy_api_send_str_to_disp(unsigned char num, char* str) {
 }
 
 //ask for changed switches
+//with the switch reader running, take the next queued switch (0x7f if none) without waiting
 unsigned char
 lisy_api_ask_for_changed_switch(void) {
 
     unsigned char my_switch, cmd;
     int ret;
 
+    if (lisy_api_reader_on) {
+        my_switch = 0x7f;
+        pthread_mutex_lock(&lisy_api_mutex);
+        if (lisy_api_sw_count > 0) {
+            my_switch = lisy_api_sw_queue[lisy_api_sw_head];
+            lisy_api_sw_head = (lisy_api_sw_head + 1) % LISY_API_SW_QUEUE;
+            lisy_api_sw_count--;
+        }
+        pthread_mutex_unlock(&lisy_api_mutex);
+
+        //USB debug? only if reurn is not 0x7f == no switch changed
+        if ((ls80dbg.bitv.switches) & (my_switch != 0x7f)) {
+            sprintf(debugbuf, "API_switch_reader: 0x%02x", my_switch);
+            lisy80_debug(debugbuf);
+        }
+        return my_switch;
+    }
+
     //do some statistics
     lisy_api_counter++;
 
@@ -561,8 +862,8 @@ lisy_api_ask_for_changed_switch(void) {
 }
 
 //get status of specific switch
-unsigned char
-lisy_api_get_switch_status(unsigned char number) {
+static unsigned char
+lisy_api_get_switch_status_locked(unsigned char number) {
 
     int ret;
     unsigned char cmd, status;
@@ -590,6 +891,18 @@ lisy_api_get_switch_status(unsigned char number) {
     return status;
 }
 
+//lisy_api_get_switch_status with the line held for the answer (see lisy_api_sync_begin)
+unsigned char
+lisy_api_get_switch_status(unsigned char number) {
+
+    unsigned char ret;
+
+    lisy_api_sync_begin();
+    ret = lisy_api_get_switch_status_locked(number);
+    lisy_api_sync_end();
+    return ret;
+}
+
 //lamp control
 void
 lisy_api_lamp_ctrl(int lamp_no, unsigned char action) {
@@ -606,7 +919,7 @@ lisy_api_lamp_ctrl(int lamp_no, unsigned char action) {
     //send lamp number
     cmd_data[1] = lamp_no;
 
-    if (lisy_api_write(cmd_data, 2, ls80dbg.bitv.lamps) != 2)
+    if (lisy_api_post(cmd_data, 2, ls80dbg.bitv.lamps) != 2)
         fprintf(stderr, "Lamps Error writing to serial %s\n", strerror(errno));
 }
 
@@ -627,7 +940,7 @@ lisy_api_sol_ctrl(int sol_no, unsigned char action) {
     //send lamp number
     cmd_data[1] = sol_no;
 
-    if (lisy_api_write(cmd_data, 2, ls80dbg.bitv.coils) != 2)
+    if (lisy_api_post(cmd_data, 2, ls80dbg.bitv.coils) != 2)
         fprintf(stderr, "Solenoids Error writing to serial %s\n", strerror(errno));
 }
 
@@ -644,7 +957,7 @@ lisy_api_sol_pulse(int sol_no) {
     //send lamp number
     cmd_data[1] = sol_no;
 
-    if (lisy_api_write(cmd_data, 2, ls80dbg.bitv.coils) != 2)
+    if (lisy_api_post(cmd_data, 2, ls80dbg.bitv.coils) != 2)
         fprintf(stderr, "Solenoids Error writing to serial %s\n", strerror(errno));
 }
 
@@ -673,7 +986,7 @@ lisy_api_sol_set_hwrule(int sol_no, int special_switch) {
     }
 
     //11 bytes to follow
-    if (lisy_api_write(cmd_data, 11, ls80dbg.bitv.basic) != 11)
+    if (lisy_api_post(cmd_data, 11, ls80dbg.bitv.basic) != 11)
         fprintf(stderr, "Setting hW rules, Error writing to serial\n");
 }
 
@@ -701,7 +1014,7 @@ lisy_api_display_set_prot(uint8_t display_no, uint8_t protocol) {
     //send protocol number
     cmd_data[2] = protocol;
 
-    if (lisy_api_write(cmd_data, 3, ls80dbg.bitv.displays) != 3)
+    if (lisy_api_post(cmd_data, 3, ls80dbg.bitv.displays) != 3)
         fprintf(stderr, "display option Error writing to serial\n");
 }
 
@@ -883,8 +1196,8 @@ lisy_api_set_apc_game_setting(unsigned char number, unsigned char value) {
 }
 
 //get value of APC game setting
-unsigned char
-lisy_api_get_apc_game_setting(unsigned char number) {
+static unsigned char
+lisy_api_get_apc_game_setting_locked(unsigned char number) {
 
     int ret;
     unsigned char cmd, status;
@@ -917,11 +1230,23 @@ lisy_api_get_apc_game_setting(unsigned char number) {
     return status;
 }
 
+//lisy_api_get_apc_game_setting with the line held for the answer (see lisy_api_sync_begin)
+unsigned char
+lisy_api_get_apc_game_setting(unsigned char number) {
+
+    unsigned char ret;
+
+    lisy_api_sync_begin();
+    ret = lisy_api_get_apc_game_setting_locked(number);
+    lisy_api_sync_end();
+    return ret;
+}
+
 
 //Rmake sure connected hardware is of type 'idstr'
 //will also sync in case there are still bytes in the send/recv queue
-int
-lisy_api_check_con_hw(char* idstr) {
+static int
+lisy_api_check_con_hw_locked(char* idstr) {
     char nextbyte;
     int i, n, ret;
     unsigned char cmd;
@@ -975,3 +1300,15 @@ lisy_api_check_con_hw(char* idstr) {
 
     return (0);
 }
+
+//lisy_api_check_con_hw with the line held for the answer (see lisy_api_sync_begin)
+int
+lisy_api_check_con_hw(char* idstr) {
+
+    int ret;
+
+    lisy_api_sync_begin();
+    ret = lisy_api_check_con_hw_locked(idstr);
+    lisy_api_sync_end();
+    return ret;
+}
@@ -25,6 +25,12 @@ int lisy_api_get_con_hw(char* idstr);
 unsigned char lisy_api_get_apc_game_setting(unsigned char number);
 int lisy_api_set_apc_game_setting(unsigned char number, unsigned char value);
 int lisy_api_check_con_hw(char* idstr);
+void lisy_api_flush(void);
+void lisy_api_batch_begin(void);
+void lisy_api_batch_end(void);
+int lisy_api_start_switch_reader(void);
+void lisy_api_stop_switch_reader(void);
+int lisy_api_switch_reader_running(void);
 
 //mapping for segemnts
 typedef union {
@@ -312,6 +312,9 @@ lisy_w_init(void) {
         }
     }
 
+    //poll the switches from a thread from now on, the emulation never waits for the serial line
+    lisy_api_start_switch_reader();
+
     //show green light for now, lisy mini is running
     lisy80_set_red_led(0);
     lisy80_set_yellow_led(0);
@@ -1164,6 +1167,9 @@ lisy_w_display_handler_SYS11C(void) {
 void
 lisy_w_display_handler(void) {
 
+    //send all display updates with one write
+    lisy_api_batch_begin();
+
     switch (lisymini_game.typeno) {
         case LISYW_TYPE_SYS3:
         case LISYW_TYPE_SYS4:
@@ -1191,6 +1197,8 @@ lisy_w_display_handler(void) {
             fprintf(stderr, "\nERROR\nunknown lisymini_game.typeno %d\n", lisymini_game.typeno);
             break;
     }
+
+    lisy_api_batch_end();
 }
 
 /*
@@ -1645,6 +1653,8 @@ lisy_w_solenoid_handler(void) {
 
     //did something change?
     if (mysol != coreGlobals.solenoids) {
+        //send all changed solenoids with one write
+        lisy_api_batch_begin();
         //check all solenoids
         for (bitpos = 0; bitpos <= 31; bitpos++) {
             //send to APC in case something changed
@@ -1879,6 +1889,7 @@ lisy_w_solenoid_handler(void) {
 
             } //something changed
         }     //for
+        lisy_api_batch_end();
         //store it for next call
         mysol = coreGlobals.solenoids;
     }
@@ -1921,8 +1932,9 @@ lisy_w_switch_reader(unsigned char* action) {
     static int num = 0;
 
     //this routine is called every 0,5 msec, which 2000 per second
+    //the switch reader thread queues the changes, so we can take them at each call
     num++;
-    if (num > 40) {
+    if ((num > 40) || lisy_api_switch_reader_running()) {
         num = 0;
         switch_number = lisy_api_ask_for_changed_switch();
     } else
@@ -1968,6 +1980,8 @@ lisy_w_lamp_handler() {
 
     //something changed?
     if (memcmp(mylampMatrix, coreGlobals.lampMatrix, sizeof(mylampMatrix)) != 0) {
+        //send all changed lamps with one write
+        lisy_api_batch_begin();
         //check all lamps
         for (i = 0; i <= 7; i++) {
             for (j = 0; j <= 7; j++) {
@@ -1986,6 +2000,7 @@ lisy_w_lamp_handler() {
                 }     //if changed
             }         //j
         }             //i
+        lisy_api_batch_end();
         //store it
         memcpy(mylampMatrix, coreGlobals.lampMatrix, sizeof(mylampMatrix));
     } //changed
@@ -2044,6 +2059,7 @@ void
 lisy_mini_shutdown(void) {
 
     fprintf(stderr, "LISY Mini graceful shutdown initiated\n");
+    lisy_api_stop_switch_reader();
     //show the 'shutdown' message
     //set displays  one and two to ASCII with dot (6)  for boot message
     lisy_api_display_set_prot(1, 6);
@@ -115,15 +115,76 @@ struct Node_sound_element* mpf_sound_list = NULL;
 //flag for sound ( phat soundcard on LISY Board)
 static unsigned char has_sound = 0;
 
+//buffered connection I/O: the commands are read in blocks, and the answers are
+//collected and written at once when all the commands received so far are handled
+static unsigned char mpf_rx_buf[1024];
+static int mpf_rx_pos = 0, mpf_rx_len = 0;
+static unsigned char mpf_tx_buf[1024];
+static int mpf_tx_len = 0;
+
 void
 error(const char* msg) {
     perror(msg);
 }
 
+//write the collected answers
+static void
+mpf_flush(int sockfd) {
+    int sent = 0, n;
+
+    while (sent < mpf_tx_len) {
+        n = write(sockfd, mpf_tx_buf + sent, mpf_tx_len - sent);
+        if (n <= 0) {
+            fprintf(stderr, "mpf_flush: could not write to socket\n");
+            break;
+        }
+        sent += n;
+    }
+    mpf_tx_len = 0;
+}
+
+//queue an answer to be written with the next flush
+static void
+mpf_write(int sockfd, const void* data, int len) {
+    if (mpf_tx_len + len > sizeof(mpf_tx_buf))
+        mpf_flush(sockfd);
+    if (len > sizeof(mpf_tx_buf)) {
+        write(sockfd, data, len);
+        return;
+    }
+    memcpy(mpf_tx_buf + mpf_tx_len, data, len);
+    mpf_tx_len += len;
+}
+
+//get the next received byte, reading a new block when needed
+//answers are flushed before waiting for new commands
+//returns 1 if we got a byte, 0 if the connection is closed
+static int
+mpf_read(int sockfd, unsigned char* value) {
+    if (mpf_rx_pos == mpf_rx_len) {
+        mpf_flush(sockfd);
+        mpf_rx_pos = 0;
+        mpf_rx_len = read(sockfd, mpf_rx_buf, sizeof(mpf_rx_buf));
+        if (mpf_rx_len <= 0) {
+            mpf_rx_len = 0;
+            *value = 0;
+            return 0;
+        }
+    }
+    *value = mpf_rx_buf[mpf_rx_pos++];
+    return 1;
+}
+
+//start a new connection with empty buffers
+static void
+mpf_reset_io(void) {
+    mpf_rx_pos = mpf_rx_len = mpf_tx_len = 0;
+}
+
 //send back string
 void
 send_back_string(int sockfd, unsigned char code, char* str) {
-    write(sockfd, str, strlen(str) + 1);
+    mpf_write(sockfd, str, strlen(str) + 1);
 
     if (ls80dbg.bitv.basic) {
         if ((code < 100) && (code != 41)) {
@@ -136,9 +197,7 @@ send_back_string(int sockfd, unsigned char code, char* str) {
 //send back byte
 void
 send_back_byte(int sockfd, unsigned char code, unsigned char answer) {
-    if (write(sockfd, &answer, 1) != 1) {
-        fprintf(stderr, "send_back_byte: could not write to socket\n");
-    }
+    mpf_write(sockfd, &answer, 1);
 
     if (ls80dbg.bitv.basic) {
         if ((code < 100) && (code != 41)) //not for watchdog & status switch
@@ -154,7 +213,7 @@ unsigned char
 read_next_byte(int sockfd, unsigned char code) {
     unsigned char nextbyte;
 
-    read(sockfd, &nextbyte, 1);
+    mpf_read(sockfd, &nextbyte);
 
     /*
  if (ls80dbg.bitv.basic)
@@ -175,7 +234,8 @@ read_next_string(int sockfd, char* content) {
     int i = 0;
 
     do {
-        read(sockfd, &nextbyte, 1);
+        if (!mpf_read(sockfd, &nextbyte))
+            nextbyte = '\0';
         content[i] = nextbyte;
         i++;
     } while (nextbyte != '\0');
@@ -189,7 +249,8 @@ read_next_n_bytes(int sockfd, int n, char* content) {
     int i = 0;
 
     do {
-        read(sockfd, &nextbyte, 1);
+        if (!mpf_read(sockfd, &nextbyte))
+            nextbyte = '\0';
         content[i] = nextbyte;
         i++;
     } while (i < n);
@@ -353,7 +414,7 @@ set_coil_pulsetime(int sockfd, int number) {
 
     unsigned char value;
 
-    read(sockfd, &value, 1);
+    mpf_read(sockfd, &value);
     lisy_coil_pulse_time[number] = value;
 
     if (ls80dbg.bitv.coils) {
@@ -825,15 +886,15 @@ set_hw_rule(int sockfd, unsigned char sol) {
     unsigned char sw2_flag;
     unsigned char sw3_flag;
 
-    read(sockfd, &sw1, 1);
-    read(sockfd, &sw2, 1);
-    read(sockfd, &sw3, 1);
-    read(sockfd, &pulse_time, 1);
-    read(sockfd, &pulse_pwm_power, 1);
-    read(sockfd, &hold_pwm_power, 1);
-    read(sockfd, &sw1_flag, 1);
-    read(sockfd, &sw2_flag, 1);
-    read(sockfd, &sw3_flag, 1);
+    mpf_read(sockfd, &sw1);
+    mpf_read(sockfd, &sw2);
+    mpf_read(sockfd, &sw3);
+    mpf_read(sockfd, &pulse_time);
+    mpf_read(sockfd, &pulse_pwm_power);
+    mpf_read(sockfd, &hold_pwm_power);
+    mpf_read(sockfd, &sw1_flag);
+    mpf_read(sockfd, &sw2_flag);
+    mpf_read(sockfd, &sw3_flag);
 
     //for autofire only at the moment, flags to be ignored
     if (sw1 < 80) {
@@ -1223,8 +1284,9 @@ main(int argc, char* argv[]) {
             newsockfd = serfd; //otherwise our new socket is the serial fd
         }
 
-        //read it byte by byte
-        while (read(newsockfd, &code, 1) == 1) {
+        //read it byte by byte, from the receive buffer
+        mpf_reset_io();
+        while (mpf_read(newsockfd, &code) == 1) {
 
             switch (code) {
                 //info, parameter none
@@ -81,6 +81,9 @@ struct via6522
 
 	double cycles_to_sec;
 	double sec_to_cycles;
+
+	UINT8 in_cached;	/* ports only read from the interface when marked dirty */
+	UINT8 in_dirty;
 };
 
 
@@ -89,6 +92,8 @@ struct via6522
 #define V_CYCLES_TO_TIME(c) ((double)(c) * v->cycles_to_sec)
 #define V_TIME_TO_CYCLES(t) ((int)((t) * v->sec_to_cycles + 0.5)) // round
 
+#define INPUT_STALE(v, port)	(!((v)->in_cached & (port)) || ((v)->in_dirty & (port)))
+
 /* Macros for PCR */
 #define CA1_LOW_TO_HIGH(c)		(c & 0x01)
 #define CA1_HIGH_TO_LOW(c)		(!(c & 0x01))
@@ -294,6 +299,8 @@ void via_reset(void)
 		v.time2 = via[i].time2;
 		v.sec_to_cycles = via[i].sec_to_cycles;
 		v.cycles_to_sec = via[i].cycles_to_sec;
+		v.in_cached = via[i].in_cached;
+		v.in_dirty = VIA_INPUT_A | VIA_INPUT_B;
 
 		v.t1 = timer_alloc(via_t1_timeout);
 		v.t1_active = 0;
@@ -304,6 +311,20 @@ void via_reset(void)
     }
 }
 
+/******************* input caching *******************/
+
+void via_set_input_cache(int which, int ports)
+{
+	if (which >= MAX_VIA) return;
+	via[which].in_cached = ports & (VIA_INPUT_A | VIA_INPUT_B);
+	via[which].in_dirty = VIA_INPUT_A | VIA_INPUT_B;
+}
+
+void via_mark_input_dirty(int which, int ports)
+{
+	via[which].in_dirty |= ports;
+}
+
 /******************* CPU interface for VIA read *******************/
 
 int via_read(int which, int offset)
@@ -320,7 +341,13 @@ int via_read(int which, int offset)
 		if (PB_LATCH_ENABLE(v->acr) == 0)
 		{
 			if (v->intf->in_b_func)
-				v->in_b = v->intf->in_b_func(0);
+			{
+				if (INPUT_STALE(v, VIA_INPUT_B))
+				{
+					v->in_dirty &= ~VIA_INPUT_B;
+					v->in_b = v->intf->in_b_func(0);
+				}
+			}
 			else
 				LOG(("6522VIA chip %d: Port B is being read but has no handler.  PC: %08X\n", which, activecpu_get_pc()));
 		}
@@ -339,7 +366,13 @@ int via_read(int which, int offset)
 		if (PA_LATCH_ENABLE(v->acr) == 0)
 		{
 			if (v->intf->in_a_func)
-				v->in_a = v->intf->in_a_func(0);
+			{
+				if (INPUT_STALE(v, VIA_INPUT_A))
+				{
+					v->in_dirty &= ~VIA_INPUT_A;
+					v->in_a = v->intf->in_a_func(0);
+				}
+			}
 			else
 				LOG(("6522VIA chip %d: Port A is being read but has no handler.  PC: %08X\n", which, activecpu_get_pc()));
 		}
@@ -373,7 +406,13 @@ int via_read(int which, int offset)
 		if (PA_LATCH_ENABLE(v->acr) == 0)
 		{
 			if (v->intf->in_a_func)
-				v->in_a = v->intf->in_a_func(0);
+			{
+				if (INPUT_STALE(v, VIA_INPUT_A))
+				{
+					v->in_dirty &= ~VIA_INPUT_A;
+					v->in_a = v->intf->in_a_func(0);
+				}
+			}
 			else
 				LOG(("6522VIA chip %d: Port A is being read but has no handler.  PC: %08X\n", which, activecpu_get_pc()));
 		}
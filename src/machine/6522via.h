@@ -76,6 +76,12 @@ void via_set_input_cb2(int which, int data);
 
 void via_set_input_si(int which, int data);
 
+/* ports A/B only read from in_a_func/in_b_func after via_mark_input_dirty() */
+#define VIA_INPUT_A 0x01
+#define VIA_INPUT_B 0x02
+void via_set_input_cache(int which, int ports);
+void via_mark_input_dirty(int which, int ports);
+
 /******************* Standard 8-bit CPU interfaces, D0-D7 *******************/
 
 READ_HANDLER( via_0_r );
@@ -59,11 +59,16 @@ struct riot6532
 
 	double cycles_to_sec;
 	double sec_to_cycles;
+
+	UINT8 in_cached;	/* ports only read from the interface when marked dirty */
+	UINT8 in_dirty;
 };
 
 #define V_CYCLES_TO_TIME(c) ((double)(c) * p->cycles_to_sec)
 #define V_TIME_TO_CYCLES(t) ((int)((t) * p->sec_to_cycles + 0.5)) // round
 
+#define INPUT_STALE(p, port)	(!((p)->in_cached & (port)) || ((p)->in_dirty & (port)))
+
 
 /******************* convenince macros and defines *******************/
 
@@ -153,6 +158,7 @@ void riot6532_reset(void)
 		riot[i].timer_irq_enabled = 0;
 
 		riot[i].time = timer_get_time();
+		riot[i].in_dirty = RIOT6532_INPUT_A | RIOT6532_INPUT_B;
 
 		if ( riot[i].inUse ) {
 			riot[i].t = timer_alloc(riot_timeout);
@@ -236,6 +242,20 @@ static void riot_timeout(int which)
 	}
 }
 
+/******************* input caching *******************/
+
+void riot6532_set_input_cache(int which, int ports)
+{
+	if (which >= MAX_RIOT_6532) return;
+	riot[which].in_cached = ports & (RIOT6532_INPUT_A | RIOT6532_INPUT_B);
+	riot[which].in_dirty = RIOT6532_INPUT_A | RIOT6532_INPUT_B;
+}
+
+void riot6532_mark_input_dirty(int which, int ports)
+{
+	riot[which].in_dirty |= ports;
+}
+
 /******************* CPU interface for RIOT read *******************/
 
 int riot6532_read(int which, int offset)
@@ -250,7 +270,11 @@ int riot6532_read(int which, int offset)
 		switch( offset & 0x03 ) {
 		case RIOT6532_PORTA:
 			/* update the input */
-			if (p->intf->in_a_func) p->in_a = p->intf->in_a_func(0);
+			if (p->intf->in_a_func && INPUT_STALE(p, RIOT6532_INPUT_A))
+			{
+				p->in_dirty &= ~RIOT6532_INPUT_A;
+				p->in_a = p->intf->in_a_func(0);
+			}
 
 			/* combine input and output values */
 			val = (p->out_a & p->ddr_a) + (p->in_a & ~p->ddr_a);
@@ -265,7 +289,11 @@ int riot6532_read(int which, int offset)
 		
 		case RIOT6532_PORTB:
 			/* update the input */
-			if (p->intf->in_b_func) p->in_b = p->intf->in_b_func(0);
+			if (p->intf->in_b_func && INPUT_STALE(p, RIOT6532_INPUT_B))
+			{
+				p->in_dirty &= ~RIOT6532_INPUT_B;
+				p->in_b = p->intf->in_b_func(0);
+			}
 
 			/* combine input and output values */
 			val = (p->out_b & p->ddr_b) + (p->in_b & ~p->ddr_b);
@@ -37,6 +37,12 @@ void riot6532_write(int which, int offset, int data);
 void riot6532_set_input_a(int which, int data);
 void riot6532_set_input_b(int which, int data);
 
+/* ports A/B only read from in_a_func/in_b_func after riot6532_mark_input_dirty() */
+#define RIOT6532_INPUT_A 0x01
+#define RIOT6532_INPUT_B 0x02
+void riot6532_set_input_cache(int which, int ports);
+void riot6532_mark_input_dirty(int which, int ports);
+
 /******************* Standard 8-bit CPU interfaces, D0-D7 *******************/
 
 READ_HANDLER( riot6532_0_r );
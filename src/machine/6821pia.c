@@ -53,6 +53,8 @@ struct pia6821
 	UINT8 irq_b2;
 	UINT8 irq_b_state;
 	UINT8 in_set; // which input ports are set
+	UINT8 in_cached; // inputs only read from their callback when marked dirty
+	UINT8 in_dirty;
 };
 
 
@@ -87,6 +89,9 @@ struct pia6821
 #define PIA_IN_SET_CB1 0x10
 #define PIA_IN_SET_CB2 0x20
 
+/* cached inputs are only refreshed from the interface after pia_mark_input_dirty() */
+#define INPUT_STALE(p, line)	(!((p)->in_cached & (line)) || ((p)->in_dirty & (line)))
+
 /******************* static variables *******************/
 
 static struct pia6821 pia[MAX_PIA];
@@ -102,6 +107,7 @@ static void update_6821_interrupts(struct pia6821 *p);
 static void pia_postload(int which)
 {
 	struct pia6821 *p = pia + which;
+	p->in_dirty = PIA_IN_SET_A | PIA_IN_SET_CA1 | PIA_IN_SET_CA2 | PIA_IN_SET_B | PIA_IN_SET_CB1 | PIA_IN_SET_CB2;
 	update_6821_interrupts(p);
 	if (p->intf->out_a_func && p->ddr_a) p->intf->out_a_func(0, p->out_a & p->ddr_a);
 	if (p->intf->out_b_func && p->ddr_b) p->intf->out_b_func(0, p->out_b & p->ddr_b);
@@ -231,8 +237,28 @@ void pia_reset(void)
 {
 	int i;
 
-	/* zap each structure, preserving the interface and swizzle */
-	for (i = 0; i < MAX_PIA; i++) pia_config(i, pia[i].addr, pia[i].intf);
+	/* zap each structure, preserving the interface, swizzle and input caching */
+	for (i = 0; i < MAX_PIA; i++)
+	{
+		UINT8 cached = pia[i].in_cached;
+		pia_config(i, pia[i].addr, pia[i].intf);
+		pia_set_input_cache(i, cached);
+	}
+}
+
+
+/******************* input caching *******************/
+
+void pia_set_input_cache(int which, int lines)
+{
+	if (which >= MAX_PIA) return;
+	pia[which].in_cached = lines & PIA_INPUT_ALL;
+	pia[which].in_dirty = PIA_INPUT_ALL;
+}
+
+void pia_mark_input_dirty(int which, int lines)
+{
+	pia[which].in_dirty |= lines;
 }
 
 
@@ -313,7 +339,13 @@ int pia_read(int which, int offset)
 			{
 				/* update the input */
 				if ((FPTR)(p->intf->in_a_func) > 0x100)
-					p->in_a = p->intf->in_a_func(0);
+				{
+					if (INPUT_STALE(p, PIA_IN_SET_A))
+					{
+						p->in_dirty &= ~PIA_IN_SET_A;
+						p->in_a = p->intf->in_a_func(0);
+					}
+				}
 #ifdef MAME_DEBUG
 				else if ((p->ddr_a ^ 0xff) && !(p->in_set & PIA_IN_SET_A)) {
 					logerror("PIA%d: Warning! no port A read handler. Assuming pins %02x not connected\n",
@@ -364,7 +396,13 @@ int pia_read(int which, int offset)
 			{
 				/* update the input */
 				if ((FPTR)(p->intf->in_b_func) > 0x100)
-					p->in_b = p->intf->in_b_func(0);
+				{
+					if (INPUT_STALE(p, PIA_IN_SET_B))
+					{
+						p->in_dirty &= ~PIA_IN_SET_B;
+						p->in_b = p->intf->in_b_func(0);
+					}
+				}
 #ifdef MAME_DEBUG
 				else if ((p->ddr_b ^ 0xff) && !(p->in_set & PIA_IN_SET_B)) {
 					logerror("PIA%d: Error! no port B read handler. Three-state pins %02x are undefined\n",
@@ -396,7 +434,13 @@ int pia_read(int which, int offset)
 
 			/* Update CA1 & CA2 if callback exists, these in turn may update IRQ's */
 			if ((FPTR)(p->intf->in_ca1_func) > 0x100)
-				pia_set_input_ca1(which, p->intf->in_ca1_func(0));
+			{
+				if (INPUT_STALE(p, PIA_IN_SET_CA1))
+				{
+					p->in_dirty &= ~PIA_IN_SET_CA1;
+					pia_set_input_ca1(which, p->intf->in_ca1_func(0));
+				}
+			}
 #ifdef MAME_DEBUG
 			else if (!(p->in_set & PIA_IN_SET_CA1)) {
 				logerror("PIA%d: Warning! no CA1 read handler. Assuming pin not connected\n",which);
@@ -404,7 +448,13 @@ int pia_read(int which, int offset)
 			}
 #endif // MAME_DEBUG
 			if ((FPTR)(p->intf->in_ca2_func) > 0x100)
-				pia_set_input_ca2(which, p->intf->in_ca2_func(0));
+			{
+				if (INPUT_STALE(p, PIA_IN_SET_CA2))
+				{
+					p->in_dirty &= ~PIA_IN_SET_CA2;
+					pia_set_input_ca2(which, p->intf->in_ca2_func(0));
+				}
+			}
 #ifdef MAME_DEBUG
 			else if (C2_INPUT(p->ctl_a) && !(p->in_set & PIA_IN_SET_CA2)) {
 				logerror("PIA%d: Warning! no CA2 read handler. Assuming pin not connected\n",which);
@@ -427,7 +477,13 @@ int pia_read(int which, int offset)
 
 			/* Update CB1 & CB2 if callback exists, these in turn may update IRQ's */
 			if ((FPTR)(p->intf->in_cb1_func) > 0x100)
-				pia_set_input_cb1(which, p->intf->in_cb1_func(0));
+			{
+				if (INPUT_STALE(p, PIA_IN_SET_CB1))
+				{
+					p->in_dirty &= ~PIA_IN_SET_CB1;
+					pia_set_input_cb1(which, p->intf->in_cb1_func(0));
+				}
+			}
 #ifdef MAME_DEBUG
 			else if (!(p->in_set & PIA_IN_SET_CB1)) {
 				logerror("PIA%d: Error! no CB1 read handler. Three-state pin is undefined\n",which);
@@ -435,7 +491,13 @@ int pia_read(int which, int offset)
 			}
 #endif // MAME_DEBUG
 			if ((FPTR)(p->intf->in_cb2_func) > 0x100)
-				pia_set_input_cb2(which, p->intf->in_cb2_func(0));
+			{
+				if (INPUT_STALE(p, PIA_IN_SET_CB2))
+				{
+					p->in_dirty &= ~PIA_IN_SET_CB2;
+					pia_set_input_cb2(which, p->intf->in_cb2_func(0));
+				}
+			}
 #ifdef MAME_DEBUG
 			else if (C2_INPUT(p->ctl_b) && !(p->in_set & PIA_IN_SET_CB2)) {
 				logerror("PIA%d: Error! no CB2 read handler. Three-state pin is undefined\n",which);
@@ -68,8 +68,19 @@ void pia_set_input_ca2(int which, int data);
 void pia_set_input_b(int which, int data);
 void pia_set_input_cb1(int which, int data);
 void pia_set_input_cb2(int which, int data);
+void pia_set_input_cache(int which, int lines);
+void pia_mark_input_dirty(int which, int lines);
 
 #define PIA_UNUSED_VAL(x) ((mem_read_handler)(x+1))
+
+/* input lines for pia_set_input_cache() / pia_mark_input_dirty() */
+#define PIA_INPUT_A   0x01
+#define PIA_INPUT_CA1 0x02
+#define PIA_INPUT_CA2 0x04
+#define PIA_INPUT_B   0x08
+#define PIA_INPUT_CB1 0x10
+#define PIA_INPUT_CB2 0x20
+#define PIA_INPUT_ALL 0x3f
 /******************* Standard 8-bit CPU interfaces, D0-D7 *******************/
 
 READ_HANDLER( pia_0_r );
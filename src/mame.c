@@ -172,6 +172,7 @@ struct mame_display *current_display_ptr = &current_display;
 
 /* video updating */
 static UINT8 full_refresh_pending;
+static UINT32 full_refresh_count;
 static int last_partial_scanline;
 
 /* speed computation */
@@ -181,6 +182,11 @@ static int rendered_frames_since_last_fps;
 static int vfcount;
 static struct performance_info performance;
 
+/* startup timing */
+static struct startup_info startup;
+static cycles_t startup_start_time, startup_last_time;
+static int startup_pending;
+
 /* misc other statics */
 static int settingsloaded;
 static int leds_status;
@@ -237,6 +243,8 @@ static void recompute_fps(int skipped_it);
 static int vh_open(void);
 static void vh_close(void);
 static int init_game_options(void);
+static void startup_begin(void);
+static void startup_mark(int stage);
 static int decode_graphics(const struct GfxDecodeInfo *gfxdecodeinfo);
 static void compute_aspect_ratio(const struct InternalMachineDriver *drv, int *aspect_x, int *aspect_y);
 static void scale_vectorgames(int gfx_width, int gfx_height, int *width, int *height);
@@ -328,6 +336,7 @@ int run_game(int game)
 	else
 	{
 		begin_resource_tracking();
+		startup_begin();
 
 		/* then finish setting up our local machine */
 		if (init_machine())
@@ -405,6 +414,7 @@ static int init_machine(void)
 			goto cant_allocate_input_ports_default;
 		}
 	}
+	startup_mark(STARTUP_INPUT);
 
 	/* init the hard drive interface now, before attempting to load */
 	hard_disk_set_interface(&mame_hard_disk_interface);
@@ -418,6 +428,7 @@ static int init_machine(void)
 #endif /* PINMAME && LISY_SUPPORT */
 		goto cant_load_roms;
 	}
+	startup_mark(STARTUP_ROMS);
 
 	/* first init the timers; some CPUs have built-in timers and will need */
 	/* to allocate them up front */
@@ -426,6 +437,7 @@ static int init_machine(void)
 
 	/* now set up all the CPUs */
 	cpu_init();
+	startup_mark(STARTUP_CPUS);
 
 #ifdef MESS
 	/* initialize the devices */
@@ -448,12 +460,14 @@ static int init_machine(void)
 		logerror("memory_init failed\n");
 		goto cant_init_memory;
 	}
+	startup_mark(STARTUP_MEMORY);
 
 	vgm_start(Machine);
 
 	/* call the game driver's init function */
 	if (gamedrv->driver_init)
 		(*gamedrv->driver_init)();
+	startup_mark(STARTUP_DRIVER);
 #ifdef MESS
 	/* initialize the devices */
 	if (devices_initialload(gamedrv, FALSE))
@@ -504,6 +518,8 @@ static int run_machine(void)
 			bail_and_print("Unable to start video emulation");
 		else
 		{
+			startup_mark(STARTUP_VIDEO);
+
 			/* start the audio system */
 			if (sound_start())
 				bail_and_print("Unable to start audio emulation");
@@ -511,6 +527,8 @@ static int run_machine(void)
 			{
 				int region;
 
+				startup_mark(STARTUP_SOUND);
+
 				/* free memory regions allocated with REGIONFLAG_DISPOSE (typically gfx roms) */
 				for (region = 0; region < MAX_MEMORY_REGIONS; region++)
 					if (Machine->memory_region[region].flags & ROMREGION_DISPOSE)
@@ -592,6 +610,14 @@ void run_machine_core(void)
 				/* run the emulation! */
 				cpu_run();
 
+#ifdef LIBPINMAME
+				/* finish the background NVRAM writes first */
+				{
+					extern void libpinmame_stop_nvram_autosave(void);
+					libpinmame_stop_nvram_autosave();
+				}
+#endif
+
 				/* save the NVRAM */
 				if (Machine->drv->nvram_handler)
 				{
@@ -896,6 +922,16 @@ static void compute_aspect_ratio(const struct InternalMachineDriver *drv, int *a
 
 static int init_game_options(void)
 {
+	/* a minimal core (for hosts that drive the emulation themselves) leaves */
+	/* out the subsystems that only the MAME front end makes use of */
+	if (options.minimal_core)
+	{
+		options.cheat = 0;
+		options.use_artwork = ARTWORK_USE_NONE;
+		options.skip_disclaimer = 1;
+		options.skip_gameinfo = 1;
+	}
+
 	/* copy some settings into easier-to-handle variables */
 	record	   = options.record;
 	playback   = options.playback;
@@ -1145,6 +1181,18 @@ void schedule_full_refresh(void)
 
 
 
+/*-------------------------------------------------
+	get_full_refresh_count - number of full erases
+	done so far
+-------------------------------------------------*/
+
+UINT32 get_full_refresh_count(void)
+{
+	return full_refresh_count;
+}
+
+
+
 /*-------------------------------------------------
 	reset_partial_updates - reset the partial
 	updating mechanism for a new frame
@@ -1181,6 +1229,7 @@ void force_partial_update(int scanline)
 	{
 		fillbitmap(Machine->scrbitmap, get_black_pen(), NULL);
 		full_refresh_pending = 0;
+		full_refresh_count++;
 	}
 
 	/* set the start/end scanlines */
@@ -1285,6 +1334,10 @@ void update_video_and_audio(void)
 	/* render */
 	artwork_update_video_and_audio(&current_display);
 
+	/* the first frame completes the startup timings */
+	if (startup_pending)
+		startup_mark(STARTUP_FIRST_FRAME);
+
 	/* update FPS */
 	recompute_fps(skipped_it);
 
@@ -1445,6 +1498,66 @@ const struct performance_info *mame_get_performance_info(void)
 
 
 
+/*-------------------------------------------------
+	mame_get_startup_info - return the startup
+	timings of the current session
+-------------------------------------------------*/
+
+const struct startup_info *mame_get_startup_info(void)
+{
+	return &startup;
+}
+
+
+
+/*-------------------------------------------------
+	startup_begin - start timing a new session
+-------------------------------------------------*/
+
+static void startup_begin(void)
+{
+	memset(&startup, 0, sizeof(startup));
+	startup_start_time = startup_last_time = osd_cycles();
+	startup_pending = 1;
+}
+
+
+
+/*-------------------------------------------------
+	startup_mark - account the time since the
+	previous mark to the given stage
+-------------------------------------------------*/
+
+static void startup_mark(int stage)
+{
+	static const char *const stage_names[STARTUP_STAGES] =
+	{
+		"input", "roms", "cpus", "memory", "driver", "video", "sound", "first frame"
+	};
+	double scale = 1000.0 / (double)osd_cycles_per_second();
+	cycles_t curr = osd_cycles();
+
+	if (!startup_pending)
+		return;
+
+	startup.stage_ms[stage] += (double)(curr - startup_last_time) * scale;
+	startup.total_ms = (double)(curr - startup_start_time) * scale;
+	startup_last_time = curr;
+
+	/* report everything once the first frame is out */
+	if (stage == STARTUP_FIRST_FRAME)
+	{
+		int i;
+
+		startup_pending = 0;
+		for (i = 0; i < STARTUP_STAGES; i++)
+			logerror("startup: %-12s %8.1f ms\n", stage_names[i], startup.stage_ms[i]);
+		logerror("startup: %-12s %8.1f ms\n", "total", startup.total_ms);
+	}
+}
+
+
+
 /*-------------------------------------------------
 	mame_find_cpu_index - return the index of the
 	given CPU, or -1 if not found
@@ -192,6 +192,7 @@ struct GameOptions
 	int 	gui_host;			/* 1 to tweak some UI-related things for better GUI integration */
 	int 	skip_disclaimer;	/* 1 to skip the disclaimer screen at startup */
 	int 	skip_gameinfo;		/* 1 to skip the game info screen at startup */
+	int		minimal_core;		/* 1 to leave out cheats, hiscores, artwork and startup screens */
 
 	int		samplerate;		/* sound sample playback rate, in Hz */
 	int		use_samples;	/* 1 to enable external .wav samples */
@@ -303,6 +304,27 @@ struct performance_info
 };
 
 
+/* stages timed between the OSD layer coming up and the first frame */
+enum
+{
+	STARTUP_INPUT = 0,		/* input system and input port allocation */
+	STARTUP_ROMS,			/* ROM loading */
+	STARTUP_CPUS,			/* timers and CPU cores */
+	STARTUP_MEMORY,			/* input port settings and memory system */
+	STARTUP_DRIVER,			/* driver init */
+	STARTUP_VIDEO,			/* display, palette and driver video start */
+	STARTUP_SOUND,			/* sound chips and mixer */
+	STARTUP_FIRST_FRAME,	/* machine reset up to the first displayed frame */
+	STARTUP_STAGES
+};
+
+struct startup_info
+{
+	double					stage_ms[STARTUP_STAGES];	/* time spent in each stage */
+	double					total_ms;					/* time to first frame */
+};
+
+
 
 /***************************************************************************
 
@@ -343,6 +365,9 @@ void set_visible_area(int min_x, int max_x, int min_y, int max_y);
 /* force an erase and a complete redraw of the video next frame */
 void schedule_full_refresh(void);
 
+/* number of full erases done so far, for video updates that only redraw what changed */
+UINT32 get_full_refresh_count(void);
+
 /* called by cpuexec.c to reset updates at the end of VBLANK */
 void reset_partial_updates(void);
 
@@ -372,6 +397,9 @@ void set_led_status(int num, int on);
 /* return current performance data */
 const struct performance_info *mame_get_performance_info(void);
 
+/* return the startup timings of the current session */
+const struct startup_info *mame_get_startup_info(void);
+
 /* return the index of the given CPU, or -1 if not found */
 int mame_find_cpu_index(const char *tag);
 
@@ -359,6 +359,8 @@ static void cmd_search_memory( void );
 static void bpr_set(void);
 void edit_cmds_reset( void );
 #endif /* DBG_BPR */
+static int hit_brk_any( void );
+static void brk_arm( int cpu );
 
 #ifdef PINMAME
 static void cmd_jumpover( void );
@@ -499,6 +501,16 @@ typedef struct {
 #endif /* PINMAME */
 }	s_trace;
 
+/****************************************************************************
+ * Breakpoint bitmaps: one bit per page of the CPU's address space, with
+ * the page size chosen so that no map exceeds 64K bits (16 bit CPUs get
+ * one bit per address). A clear bit rules out a hit with a single test
+ ****************************************************************************/
+#define BRK_MAP_BITS	16
+#define BRK_MAP_SIZE	((1 << BRK_MAP_BITS) / 8)
+#define BRK_MAP_TEST(map,shift,adr) \
+	((map)[(((adr) >> (shift)) & ((1 << BRK_MAP_BITS) - 1)) >> 3] & (1 << (((adr) >> (shift)) & 7)))
+
 /****************************************************************************
  * Debugger structure. There is one instance per CPU
  ****************************************************************************/
@@ -519,10 +531,14 @@ typedef struct {
 	UINT32	brk_regs_newval;	/* expected new value (INVALID: always break) */
 	UINT32	brk_regs_mask;		/* mask register value before comparing */
 	UINT32	brk_temp;			/* temporary execution breakpoint */
+	int		(*hit_brk)(void);	/* breakpoint checks, NULL while none is set */
+	UINT32	brk_shift;			/* address bits dropped for the bitmaps */
+	UINT8	brk_exec_map[BRK_MAP_SIZE]; /* pages with an exec or temp breakpoint */
 #if defined(PINMAME) && defined(DBG_BPR)
 	UINT32	bprstart, bprend;
 	int		bprnext;
 	struct { UINT32 adr; int length; } bprdata[10];
+	UINT8	bpr_map[BRK_MAP_SIZE];	/* pages inside the BPR range */
 #endif
 
 	s_regs	regs;
@@ -1822,6 +1838,8 @@ static int hit_brk_exec(void)
 	static char dbg_info[63+1];
 	UINT32 pc = activecpu_get_pc();
 
+	if( !BRK_MAP_TEST(DBG.brk_exec_map, DBG.brk_shift, pc) ) return 0;
+
 	if( DBG.brk_temp != INVALID && DBG.brk_temp == pc )
 	{
 		sprintf( dbg_info, "Hit temp breakpoint at $%X", DBG.brk_temp);
@@ -1889,10 +1907,17 @@ static int hit_brk_data(void)
 }
 #if defined(PINMAME) && defined(DBG_BPR)
 /**************************************************************************
- * hit_brk_bpr
- * Return non zero if the bpr watchpoint for the activecpu was hit
+ * bpr_memref
+ * Memory system hook, installed while a bpr watchpoint is set.
+ * Records references that touch a page of the bpr range of the activecpu
  **************************************************************************/
-void bpr_memref(UINT32 adr, int length) {
+void (*bpr_memref_hook)(UINT32 adr, int length) = NULL;
+
+static void bpr_memref(UINT32 adr, int length) {
+	const s_dbg *d = &dbg[cpu_getactivecpu()];
+	if (!BRK_MAP_TEST(d->bpr_map, d->brk_shift, adr) &&
+	    !BRK_MAP_TEST(d->bpr_map, d->brk_shift, adr+length-1))
+		return;
 	if (mame_debug && !dbg_fast && !dbg_active) {
 		active_cpu = cpu_getactivecpu();
 		if (!DBG.ignore && DBG.bprstart != INVALID && DBG.bprnext < 10) {
@@ -1938,6 +1963,69 @@ static void bpr_set(void) {
 }
 #endif
 
+/**************************************************************************
+ * hit_brk_any
+ * Return non zero if any breakpoint or watchpoint of the active_cpu
+ * was hit. Only called while brk_arm found one to be set
+ **************************************************************************/
+static int hit_brk_any(void)
+{
+#if defined(PINMAME) && defined(DBG_BPR)
+	return hit_brk_exec() || hit_brk_data() || hit_brk_regs() || bpr_check();
+#else
+	return hit_brk_exec() || hit_brk_data() || hit_brk_regs();
+#endif
+}
+
+/**************************************************************************
+ * brk_map_set
+ * Mark the pages between start and end in a breakpoint bitmap
+ **************************************************************************/
+static void brk_map_set(UINT8 *map, UINT32 shift, UINT32 start, UINT32 end)
+{
+	UINT32 page;
+
+	for( page = start >> shift; page <= (end >> shift) && page < (1 << BRK_MAP_BITS); page++ )
+		map[page >> 3] |= 1 << (page & 7);
+}
+
+/**************************************************************************
+ * brk_arm
+ * Rebuild the bitmaps of a CPU from its breakpoints and install the
+ * checks only if at least one is set, so MAME_Debug and the memory
+ * system skip them entirely otherwise
+ **************************************************************************/
+static void brk_arm(int cpu)
+{
+	s_dbg *d = &dbg[cpu];
+	int bits = cpunum_address_bits(cpu);
+
+	d->brk_shift = (bits > BRK_MAP_BITS) ? bits - BRK_MAP_BITS : 0;
+
+	memset(d->brk_exec_map, 0, sizeof(d->brk_exec_map));
+	if( d->brk_exec != INVALID )
+		brk_map_set(d->brk_exec_map, d->brk_shift, d->brk_exec, d->brk_exec);
+	if( d->brk_temp != INVALID )
+		brk_map_set(d->brk_exec_map, d->brk_shift, d->brk_temp, d->brk_temp);
+
+	d->hit_brk = (d->brk_exec != INVALID || d->brk_temp != INVALID ||
+		d->brk_data != INVALID || d->brk_regs != INVALID) ? hit_brk_any : NULL;
+
+#if defined(PINMAME) && defined(DBG_BPR)
+	memset(d->bpr_map, 0, sizeof(d->bpr_map));
+	if( d->bprstart != INVALID )
+	{
+		brk_map_set(d->bpr_map, d->brk_shift, d->bprstart, d->bprend);
+		d->hit_brk = hit_brk_any;
+	}
+
+	bpr_memref_hook = NULL;
+	for( cpu = 0; cpu < total_cpu; cpu++ )
+		if( dbg[cpu].bprstart != INVALID )
+			bpr_memref_hook = bpr_memref;
+#endif /* DBG_BPR */
+}
+
 /**************************************************************************
  * hit_brk_regs
  * Return non zero if the register breakpoint for the active CPU
@@ -5490,6 +5578,7 @@ void mame_debug_init(void)
 		DBG.bprstart = INVALID;
 		DBG.bprnext = 0;
 #endif /* DBG_BPR */
+		brk_arm(active_cpu);
 		DBGMEM[0].base = 0x0000;
 		DBGMEM[1].base = 1 << (ABITS / 2);
 		switch( cpunum_align_unit(active_cpu) )
@@ -5590,6 +5679,8 @@ void mame_debug_exit(void)
  **************************************************************************/
 void MAME_Debug(void)
 {
+	int in_debugger = 0;
+
 	if( ++debug_key_delay == 0x7fff )
 	{
 		debug_key_delay = 0;
@@ -5635,6 +5726,7 @@ void MAME_Debug(void)
 		{
 			/* if so, set the temporary breakpoint on the return PC */
 			DBG.brk_temp = DBG.next_pc;
+			brk_arm(active_cpu);
 			dbg_update = 0;
 			dbg_active = 0;
 			osd_sound_enable(1);
@@ -5643,11 +5735,7 @@ void MAME_Debug(void)
 		DBG.prev_sp = 0;
 	}
 
-#if defined(PINMAME) && defined(DBG_BPR)
-	if ( (first_time || hit_brk_exec() || hit_brk_data() || hit_brk_regs() || bpr_check() || debug_key_pressed) && !dbg_active )
-#else /* DBG_BPR */
-	if ( (first_time || hit_brk_exec() || hit_brk_data() || hit_brk_regs() || debug_key_pressed) && !dbg_active )
-#endif /* DBG_BPR */
+	if ( (first_time || (DBG.hit_brk && (*DBG.hit_brk)()) || debug_key_pressed) && !dbg_active )
 	{
 		debug_key_pressed = 0;
 
@@ -5682,6 +5770,9 @@ void MAME_Debug(void)
 	/* Assume we need to update the windows */
 	dbg_update = 1;
 
+	if( dbg_active && !dbg_step )
+		in_debugger = 1;
+
 	while( dbg_active && !dbg_step )
 	{
 		if( dbg_trace )
@@ -5754,6 +5845,14 @@ void MAME_Debug(void)
 		}
 	}
 
+	/* breakpoints may have been changed while in the debugger */
+	if( in_debugger )
+	{
+		int cpu;
+		for( cpu = 0; cpu < total_cpu; cpu++ )
+			brk_arm(cpu);
+	}
+
 	/* update backup copies of memory and registers */
 	if( DBGMEM[0].changed )
 	{
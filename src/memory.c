@@ -53,11 +53,18 @@
 
 ***************************************************************************/
 
-/* macros for the profiler */
+/* macros for the profiler (debug builds only, far too frequent otherwise) */
+#ifdef MAME_DEBUG
 #define MEMREADSTART			profiler_mark(PROFILER_MEMREAD);
 #define MEMREADEND(ret)			{ profiler_mark(PROFILER_END); return ret; }
 #define MEMWRITESTART			profiler_mark(PROFILER_MEMWRITE);
 #define MEMWRITEEND(ret)		{ (ret); profiler_mark(PROFILER_END); return; }
+#else
+#define MEMREADSTART
+#define MEMREADEND(ret)			{ return ret; }
+#define MEMWRITESTART
+#define MEMWRITEEND(ret)		{ (ret); return; }
+#endif
 
 #define DATABITS_TO_SHIFT(d)	(((d) == 32) ? 2 : ((d) == 16) ? 1 : 0)
 
@@ -72,6 +79,9 @@
 #define HANDLER_TO_BANK(h)		((FPTR)(h))
 #define BANK_TO_HANDLER(b)		((genf *)(b))
 
+#define HANDLER_HASH_SIZE		64
+#define HANDLER_HASH(h,o)		((((FPTR)(h) >> 4) ^ ((FPTR)(h) >> 10) ^ (o) ^ ((o) >> 8) ^ ((o) >> 16)) & (HANDLER_HASH_SIZE - 1))
+
 
 /*-------------------------------------------------
 	TYPE DEFINITIONS
@@ -84,6 +94,8 @@ struct bank_data
 	offs_t 				base;				/* the base offset */
 	offs_t				readoffset;			/* original base offset for reads */
 	offs_t				writeoffset;		/* original base offset for writes */
+	int					entrycount;			/* number of configured bank entries */
+	UINT8 *				entry[MAX_BANK_ENTRIES];/* pre-registered bank bases */
 };
 
 struct handler_data
@@ -93,12 +105,20 @@ struct handler_data
 	offs_t				top;				/* maximum offset for handler */
 };
 
+struct handler_index
+{
+	UINT8				head[HANDLER_HASH_SIZE];/* first entry in each (handler, offset) bucket */
+	UINT8				next[ENTRY_COUNT];	/* next entry in the same bucket */
+	UINT8				count;				/* next dynamic entry to hand out */
+};
+
 struct table_data
 {
 	UINT8 *				table;				/* pointer to base of table */
 	UINT8 				subtable_count;		/* number of subtables used */
 	UINT8 				subtable_alloc;		/* number of subtables allocated */
 	struct handler_data *handlers;			/* pointer to which set of handlers */
+	struct handler_index *index;			/* lookup index for the dynamic handlers */
 };
 
 struct memport_data
@@ -126,6 +146,15 @@ struct cpu_data
 
 	struct memport_data	mem;				/* memory tables */
 	struct memport_data	port;				/* port tables */
+
+	UINT8				readpage_valid;		/* page table usable (8-bit data, 16-bit address) */
+	UINT8				readpage_entry[256];/* handler entry covering each 256-byte page */
+	UINT8 *				readpage[256];		/* direct read base per page, NULL if not direct */
+	UINT8				readpage_first[ENTRY_COUNT];/* first page covered by each entry */
+	UINT8				readpage_last[ENTRY_COUNT];/* last page covered by each entry */
+
+	offs_t				watch_start;		/* write watch range (see memory_set_write_watch) */
+	offs_t				watch_length;		/* 0 if no write watch */
 };
 
 struct memory_address_table
@@ -149,7 +178,11 @@ offs_t						OP_MEM_MAX;						/* opcode memory maximum */
 UINT8		 				opcode_entry;					/* opcode readmem entry */
 
 UINT8 *						readmem_lookup;					/* memory read lookup table */
+static UINT8 **				readmem_page;					/* direct read page table (NULL if none) */
 static UINT8 *				writemem_lookup;				/* memory write lookup table */
+static offs_t				writewatch_start;				/* write watch range of the current context */
+static offs_t				writewatch_length;				/* 0 if none */
+void (*memory_write_watch_hook)(int cpunum, offs_t address, int length);
 static UINT8 *				readport_lookup;				/* port read lookup table */
 static UINT8 *				writeport_lookup;				/* port write lookup table */
 
@@ -182,6 +215,11 @@ static struct handler_data 	wporthandler8[ENTRY_COUNT];		/* 8-bit port write han
 static struct handler_data 	wporthandler16[ENTRY_COUNT];	/* 16-bit port write handlers */
 static struct handler_data 	wporthandler32[ENTRY_COUNT];	/* 32-bit port write handlers */
 
+static struct handler_index	rmemindex8, rmemindex16, rmemindex32;	/* memory read handler lookups */
+static struct handler_index	wmemindex8, wmemindex16, wmemindex32;	/* memory write handler lookups */
+static struct handler_index	rportindex8, rportindex16, rportindex32;	/* port read handler lookups */
+static struct handler_index	wportindex8, wportindex16, wportindex32;	/* port write handler lookups */
+
 static read8_handler 		rmemhandler8s[STATIC_COUNT];	/* copy of 8-bit static read memory handlers */
 static write8_handler 		wmemhandler8s[STATIC_COUNT];	/* copy of 8-bit static write memory handlers */
 
@@ -196,7 +234,7 @@ offs_t encrypted_opcode_start[MAX_CPU],encrypted_opcode_end[MAX_CPU];
 -------------------------------------------------*/
 
 static int CLIB_DECL fatalerror(const char *string, ...);
-static UINT8 get_handler_index(struct handler_data *table, genf *handler, offs_t start);
+static UINT8 get_handler_index(struct table_data *tabledata, genf *handler, offs_t start);
 static UINT8 alloc_new_subtable(const struct memport_data *memport, struct table_data *tabledata, UINT8 previous_value);
 static void populate_table(struct memport_data *memport, int iswrite, offs_t start, offs_t stop, UINT8 handler);
 static genf *assign_dynamic_bank(int cpunum, offs_t start);
@@ -206,6 +244,8 @@ static void set_static_handler(int idx,
 		read8_handler r8handler, read16_handler r16handler, read32_handler r32handler,
 		write8_handler w8handler, write16_handler w16handler, write32_handler w32handler);
 static int init_cpudata(void);
+static void build_read_pages(int cpunum);
+static void update_read_pages(int cpunum, int bank);
 static int init_memport(int cpunum, struct memport_data *data, int abits, int dbits, int ismemory);
 static int verify_memory(void);
 static int verify_ports(void);
@@ -232,6 +272,8 @@ static void verify_masks(void);
 
 int memory_init(void)
 {
+	int cpunum;
+
 #ifdef CHECK_MASKS
 	verify_masks();
 #endif
@@ -266,6 +308,10 @@ int memory_init(void)
 
 	register_banks();
 
+	/* build the direct read page tables */
+	for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
+		build_read_pages(cpunum);
+
 #ifdef MEM_DUMP
 	/* dump the final memory configuration */
 	mem_dump();
@@ -298,6 +344,8 @@ void memory_shutdown(void)
 			free(cpudata[cpunum].port.write.table);
 	}
 	memset(&cpudata, 0, sizeof(cpudata));
+	readmem_page = NULL;
+	writewatch_length = 0;
 
 	/* free all the external memory */
 	ext = ext_memory;
@@ -365,7 +413,10 @@ void memory_set_context(int activecpu)
 	//opcode_entry = opcode_entry;
 
 	readmem_lookup = cpudata[activecpu].mem.read.table;
+	readmem_page = cpudata[activecpu].readpage_valid ? cpudata[activecpu].readpage : NULL;
 	writemem_lookup = cpudata[activecpu].mem.write.table;
+	writewatch_start = cpudata[activecpu].watch_start;
+	writewatch_length = cpudata[activecpu].watch_length;
 	readport_lookup = cpudata[activecpu].port.read.table;
 	writeport_lookup = cpudata[activecpu].port.write.table;
 
@@ -376,6 +427,152 @@ void memory_set_context(int activecpu)
 }
 
 
+/*-------------------------------------------------
+	build_read_pages - scan the read lookup table
+	of an 8-bit CPU with a 16-bit address space
+	and record which handler covers each page
+-------------------------------------------------*/
+
+static void build_read_pages(int cpunum)
+{
+	struct cpu_data *cpu = &cpudata[cpunum];
+	const struct memport_data *mem = &cpu->mem;
+	int page, block;
+
+	cpu->readpage_valid = (mem->read.table && mem->dbits == 8 && mem->abits == 16 && mem->ebits == 16 && mem->mask == 0xffff);
+	if (!cpu->readpage_valid)
+		return;
+
+	memset(cpu->readpage_first, 0xff, sizeof(cpu->readpage_first));
+	memset(cpu->readpage_last, 0, sizeof(cpu->readpage_last));
+	for (page = 0; page < 256; page++)
+	{
+		/* a page is direct only if all its level 1 entries map to the same handler */
+		UINT8 entry = mem->read.table[LEVEL1_INDEX(page << 8,16,0)];
+		for (block = 1 << LEVEL2_BITS(16); block < 256; block += 1 << LEVEL2_BITS(16))
+			if (mem->read.table[LEVEL1_INDEX((page << 8) + block,16,0)] != entry)
+				entry = STATIC_INVALID;
+		if (entry >= SUBTABLE_BASE)
+			entry = STATIC_INVALID;
+		cpu->readpage_entry[page] = entry;
+		if (page < cpu->readpage_first[entry])
+			cpu->readpage_first[entry] = page;
+		cpu->readpage_last[entry] = page;
+	}
+	update_read_pages(cpunum, -1);
+}
+
+
+/*-------------------------------------------------
+	update_read_pages - refresh the direct read
+	pointers of the pages covered by a bank (or
+	all pages if bank is -1)
+-------------------------------------------------*/
+
+static void update_read_pages(int cpunum, int bank)
+{
+	struct cpu_data *cpu = &cpudata[cpunum];
+	int page = 0, last = 255;
+
+	if (bank != -1)
+		page = cpu->readpage_first[bank], last = cpu->readpage_last[bank];
+	for ( ; page <= last; page++)
+	{
+		UINT8 entry = cpu->readpage_entry[page];
+		if (bank != -1 && entry != bank)
+			continue;
+
+		/* banks with a custom handler (setbankhandler) must still go through it */
+		if (entry == STATIC_RAM)
+			cpu->readpage[page] = cpu->rambase;
+		else if (entry >= STATIC_BANK1 && entry <= STATIC_BANKMAX && cpu_bankbase[entry] &&
+				 rmemhandler8[entry].handler == (genf *)rmemhandler8s[entry])
+			cpu->readpage[page] = cpu_bankbase[entry] - rmemhandler8[entry].offset;
+		else
+			cpu->readpage[page] = NULL;
+	}
+}
+
+
+/*-------------------------------------------------
+	memory_update_bank_pages - refresh the direct
+	read pages after a bank base change
+-------------------------------------------------*/
+
+void memory_update_bank_pages(int bank)
+{
+	int cpunum;
+
+	if (bank >= 0 && bank <= MAX_BANKS && bankdata[bank].cpunum < MAX_CPU)
+	{
+		if (cpudata[bankdata[bank].cpunum].readpage_valid)
+			update_read_pages(bankdata[bank].cpunum, bank);
+		return;
+	}
+	for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
+		if (cpudata[cpunum].readpage_valid)
+			update_read_pages(cpunum, bank);
+}
+
+
+/*-------------------------------------------------
+	memory_configure_bank - register the bases a
+	bank can be switched to
+-------------------------------------------------*/
+
+void memory_configure_bank(int bank, int startentry, int numentries, void *base, offs_t stride)
+{
+	int entrynum;
+
+	if (bank < STATIC_BANK1 || bank > MAX_BANKS || startentry < 0 || startentry + numentries > MAX_BANK_ENTRIES)
+	{
+		fatalerror("memory_configure_bank called with invalid bank %d (entries %d-%d)\n", bank, startentry, startentry + numentries - 1);
+		return;
+	}
+
+	for (entrynum = 0; entrynum < numentries; entrynum++)
+		bankdata[bank].entry[startentry + entrynum] = (UINT8 *)base + entrynum * stride;
+	if (startentry + numentries > bankdata[bank].entrycount)
+		bankdata[bank].entrycount = startentry + numentries;
+}
+
+
+/*-------------------------------------------------
+	memory_set_bank - switch a bank to one of its
+	pre-registered bases
+-------------------------------------------------*/
+
+void memory_set_bank(int bank, int entrynum)
+{
+	UINT8 *oldbase;
+
+	if (bank < STATIC_BANK1 || bank > MAX_BANKS || entrynum < 0 || entrynum >= bankdata[bank].entrycount)
+	{
+		logerror("memory_set_bank: bank %d has no entry %d\n", bank, entrynum);
+		return;
+	}
+
+	oldbase = cpu_bankbase[bank];
+	cpu_bankbase[bank] = bankdata[bank].entry[entrynum];
+	memory_update_bank_pages(bank);
+
+	/* executing from the bank: the entry and bounds are unchanged, only rebase the opcode pointers */
+	if (opcode_entry == bank && cur_context >= 0 && cpu_getactivecpu() >= 0)
+	{
+		if (!opbasefunc && oldbase)
+		{
+			OP_RAM += cpu_bankbase[bank] - oldbase;
+			OP_ROM += cpu_bankbase[bank] - oldbase;
+		}
+		else
+		{
+			opcode_entry = 0xff;
+			activecpu_set_op_base(activecpu_get_pc_byte());
+		}
+	}
+}
+
+
 /*-------------------------------------------------
 	memory_set_unmap_value - set the unmapped
 	memory value
@@ -406,6 +603,9 @@ void memory_set_bankhandler_r(int bank, offs_t offset, mem_read_handler handler)
 	if (HANDLER_IS_STATIC(handler))
 		handler = rmemhandler8s[(FPTR)handler];
 	rmemhandler8[bank].handler = (genf *)handler;
+
+	/* pages of this bank may no longer be direct */
+	memory_update_bank_pages(bank);
 }
 
 
@@ -462,6 +662,9 @@ data8_t *install_mem_read_handler(int cpunum, offs_t start, offs_t end, mem_read
 
 	/* install the handler */
 	install_mem_handler(&cpudata[cpunum].mem, 0, start, end, (genf *)handler);
+	build_read_pages(cpunum);
+	if (cpunum == cur_context)
+		readmem_page = cpudata[cpunum].readpage_valid ? cpudata[cpunum].readpage : NULL;
 #ifdef MEM_DUMP
 	/* dump the new memory configuration */
 	mem_dump();
@@ -744,6 +947,24 @@ int CLIB_DECL fatalerror(const char *string, ...)
 }
 
 
+/*-------------------------------------------------
+	memory_set_write_watch - call the write watch
+	hook before each write of the CPU that starts
+	in [start,end], end < start disables it
+-------------------------------------------------*/
+
+void memory_set_write_watch(int cpunum, offs_t start, offs_t end)
+{
+	cpudata[cpunum].watch_start = start;
+	cpudata[cpunum].watch_length = (end >= start) ? end - start + 1 : 0;
+	if (cpunum == cur_context)
+	{
+		writewatch_start = cpudata[cpunum].watch_start;
+		writewatch_length = cpudata[cpunum].watch_length;
+	}
+}
+
+
 /*-------------------------------------------------
 	memory_find_base - return a pointer to the
 	base of RAM associated with the given CPU
@@ -798,6 +1019,31 @@ void *memory_get_read_ptr(int cpunum, offs_t offset)
 }
 
 
+/*-------------------------------------------------
+	memory_get_read_bankid - return the id of the
+	bank read at the given CPU and offset, or
+	FAKE_BANKID outside of banks
+-------------------------------------------------*/
+
+UINT32 memory_get_read_bankid(int cpunum, offs_t offset)
+{
+	struct memport_data *memport = &cpudata[cpunum].mem;
+	UINT8 minbits = memport->abits - memport->ebits;
+	UINT8 entry;
+
+	/* perform the lookup */
+	offset &= memport->mask;
+	entry = memport->read.table[LEVEL1_INDEX(offset, memport->abits, minbits)];
+	if (entry >= SUBTABLE_BASE)
+		entry = memport->read.table[LEVEL2_INDEX(entry, offset, memport->abits, minbits)];
+
+	/* only banks have an id (set by the drivers for CODELIST) */
+	if (entry < STATIC_BANK1 || entry > STATIC_BANKMAX)
+		return (UINT32)FAKE_BANKID;
+	return cpu_bankid[entry];
+}
+
+
 /*-------------------------------------------------
 	memory_get_write_ptr - return a pointer to the
 	base of RAM associated with the given CPU
@@ -825,31 +1071,62 @@ void *memory_get_write_ptr(int cpunum, offs_t offset)
 }
 
 
+/*-------------------------------------------------
+	memory_get_ram_page - return a pointer to the
+	given range if it is plain, unbanked RAM for
+	both reads and writes, NULL otherwise
+-------------------------------------------------*/
+
+void *memory_get_ram_page(int cpunum, offs_t offset, offs_t size)
+{
+	UINT8 *rbase = memory_get_read_ptr(cpunum, offset);
+	UINT8 *wbase = memory_get_write_ptr(cpunum, offset);
+
+	/* bank contents can be switched, and handlers must see every access */
+	if (!rbase || rbase != wbase || memory_get_read_bankid(cpunum, offset) != (UINT32)FAKE_BANKID)
+		return NULL;
+
+	/* the whole range must be the same RAM entry */
+	if (memory_get_read_ptr(cpunum, offset + size - 1) != rbase + size - 1 ||
+		memory_get_write_ptr(cpunum, offset + size - 1) != wbase + size - 1 ||
+		memory_get_read_bankid(cpunum, offset + size - 1) != (UINT32)FAKE_BANKID)
+		return NULL;
+	return rbase;
+}
+
+
 /*-------------------------------------------------
 	get_handler_index - finds the index of a
 	handler, or allocates a new one as necessary
 -------------------------------------------------*/
 
-UINT8 get_handler_index(struct handler_data *table, genf *handler, offs_t start)
+UINT8 get_handler_index(struct table_data *tabledata, genf *handler, offs_t start)
 {
+	struct handler_data *table = tabledata->handlers;
+	struct handler_index *index = tabledata->index;
+	int bucket = HANDLER_HASH(handler, start);
 	int i;
 
 	/* all static handlers are hardcoded */
 	if (HANDLER_IS_STATIC(handler))
 		return (FPTR)handler;
 
-	/* otherwise, we have to search */
-	for (i = STATIC_COUNT; i < SUBTABLE_BASE; i++)
-	{
-		if (table[i].handler == NULL)
-		{
-			table[i].handler = handler;
-			table[i].offset = start;
-		}
+	/* otherwise, look it up in the (handler, offset) buckets */
+	for (i = index->head[bucket]; i != 0; i = index->next[i])
 		if (table[i].handler == handler && table[i].offset == start)
 			return i;
-	}
-	return 0;
+
+	/* not found; hand out the next free entry */
+	if (index->count < STATIC_COUNT)
+		index->count = STATIC_COUNT;
+	if (index->count >= SUBTABLE_BASE)
+		return 0;
+	i = index->count++;
+	table[i].handler = handler;
+	table[i].offset = start;
+	index->next[i] = index->head[bucket];
+	index->head[bucket] = i;
+	return i;
 }
 
 
@@ -868,7 +1145,7 @@ UINT8 alloc_new_subtable(const struct memport_data *memport, struct table_data *
 		fatalerror("error: ran out of memory subtables\n");
 
 	/* allocate more memory if we need to */
-	if (tabledata->subtable_count <= tabledata->subtable_alloc)
+	if (tabledata->subtable_count >= tabledata->subtable_alloc)
 	{
 		tabledata->subtable_alloc += SUBTABLE_ALLOC;
 		tabledata->table = realloc(tabledata->table, (1 << l1bits) + (tabledata->subtable_alloc << l2bits));
@@ -1029,7 +1306,7 @@ void install_mem_handler(struct memport_data *memport, int iswrite, offs_t start
 		handler = (genf *)assign_dynamic_bank(memport->cpunum, start);
 
 	/* set the handler */
-	idx = get_handler_index(tabledata->handlers, handler, start);
+	idx = get_handler_index(tabledata, handler, start);
 	populate_table(memport, iswrite, start, end, idx);
 
 	/* if this is a bank, set the bankbase as well */
@@ -1052,7 +1329,7 @@ void install_mem_handler(struct memport_data *memport, int iswrite, offs_t start
 void install_port_handler(struct memport_data *memport, int iswrite, offs_t start, offs_t end, genf *handler)
 {
 	struct table_data *tabledata = iswrite ? &memport->write : &memport->read;
-	UINT8 idx = get_handler_index(tabledata->handlers, handler, start);
+	UINT8 idx = get_handler_index(tabledata, handler, start);
 	populate_table(memport, iswrite, start, end, idx);
 }
 
@@ -1175,11 +1452,15 @@ static int init_memport(int cpunum, struct memport_data *data, int abits, int db
 	{
 		data->read.handlers = (dbits == 32) ? rmemhandler32 : (dbits == 16) ? rmemhandler16 : rmemhandler8;
 		data->write.handlers = (dbits == 32) ? wmemhandler32 : (dbits == 16) ? wmemhandler16 : wmemhandler8;
+		data->read.index = (dbits == 32) ? &rmemindex32 : (dbits == 16) ? &rmemindex16 : &rmemindex8;
+		data->write.index = (dbits == 32) ? &wmemindex32 : (dbits == 16) ? &wmemindex16 : &wmemindex8;
 	}
 	else
 	{
 		data->read.handlers = (dbits == 32) ? rporthandler32 : (dbits == 16) ? rporthandler16 : rporthandler8;
 		data->write.handlers = (dbits == 32) ? wporthandler32 : (dbits == 16) ? wporthandler16 : wporthandler8;
+		data->read.index = (dbits == 32) ? &rportindex32 : (dbits == 16) ? &rportindex16 : &rportindex8;
+		data->write.index = (dbits == 32) ? &wportindex32 : (dbits == 16) ? &wportindex16 : &wportindex8;
 	}
 	return 1;
 }
@@ -1443,6 +1724,36 @@ static int allocate_memory(void)
 }
 
 
+/*-------------------------------------------------
+	can_coalesce - true if two map entries can be
+	installed as a single range; only static
+	handlers that don't depend on their base
+	offset qualify
+-------------------------------------------------*/
+
+static int can_coalesce(const struct memport_data *memport, genf *handler, genf *other)
+{
+	return handler == other && HANDLER_IS_STATIC(handler) && !HANDLER_IS_BANK(handler) && !IS_SPARSE(memport->abits);
+}
+
+
+/*-------------------------------------------------
+	extend_range - grow [start,end] by an adjacent
+	range; returns 0 if the two don't touch
+-------------------------------------------------*/
+
+static int extend_range(offs_t *start, offs_t *end, offs_t otherstart, offs_t otherend)
+{
+	if (otherend != (offs_t)~0 && otherend + 1 == *start)
+		*start = otherstart;
+	else if (*end != (offs_t)~0 && *end + 1 == otherstart)
+		*end = otherend;
+	else
+		return 0;
+	return 1;
+}
+
+
 /*-------------------------------------------------
 	populate_memory - populate the memory mapping
 	tables with entries
@@ -1467,10 +1778,16 @@ static int populate_memory(void)
 				if (IS_MEMPORT_MARKER(mra) && (mra->end & MEMPORT_ABITS_MASK))
 					cpudata[cpunum].mem.mask = 0xffffffffUL >> (32 - (mra->end & MEMPORT_ABITS_VAL_MASK));
 
-			/* then work backwards */
+			/* then work backwards, merging neighbouring entries that map the same static handler */
 			for (mra--; mra >= mra_start; mra--)
 				if (!IS_MEMPORT_MARKER(mra))
-					install_mem_handler(&cpudata[cpunum].mem, 0, mra->start, mra->end, (genf *)mra->handler);
+				{
+					offs_t start = mra->start, end = mra->end;
+					while (mra > mra_start && can_coalesce(&cpudata[cpunum].mem, (genf *)mra->handler, (genf *)mra[-1].handler) &&
+						   !IS_MEMPORT_MARKER(&mra[-1]) && extend_range(&start, &end, mra[-1].start, mra[-1].end))
+						mra--;
+					install_mem_handler(&cpudata[cpunum].mem, 0, start, end, (genf *)mra->handler);
+				}
 		}
 
 		/* install the write handlers */
@@ -1482,11 +1799,16 @@ static int populate_memory(void)
 				if (IS_MEMPORT_MARKER(mwa) && (mwa->end & MEMPORT_ABITS_MASK))
 					cpudata[cpunum].mem.mask = 0xffffffffUL >> (32 - (mwa->end & MEMPORT_ABITS_VAL_MASK));
 
-			/* then work backwards */
+			/* then work backwards, merging neighbouring entries that map the same static handler */
 			for (mwa--; mwa >= mwa_start; mwa--)
 				if (!IS_MEMPORT_MARKER(mwa))
 				{
-					install_mem_handler(&cpudata[cpunum].mem, 1, mwa->start, mwa->end, (genf *)mwa->handler);
+					offs_t start = mwa->start, end = mwa->end;
+					while (mwa > mwa_start && !mwa->base && !mwa->size && !mwa[-1].base && !mwa[-1].size &&
+						   can_coalesce(&cpudata[cpunum].mem, (genf *)mwa->handler, (genf *)mwa[-1].handler) &&
+						   !IS_MEMPORT_MARKER(&mwa[-1]) && extend_range(&start, &end, mwa[-1].start, mwa[-1].end))
+						mwa--;
+					install_mem_handler(&cpudata[cpunum].mem, 1, start, end, (genf *)mwa->handler);
 					if (mwa->base) *mwa->base = memory_find_base(cpunum, mwa->start);
 					if (mwa->size) *mwa->size = mwa->end - mwa->start + 1;
 				}
@@ -1814,11 +2136,16 @@ void register_banks(void)
 	READBYTE - generic byte-sized read handler
 -------------------------------------------------*/
 #if defined(PINMAME) && defined(DBG_BPR) && defined(MAME_DEBUG)
-extern void bpr_memref(UINT32 adr, int length);
+/* installed by the debugger only while a BPR watchpoint is set */
+extern void (*bpr_memref_hook)(UINT32 adr, int length);
+#define bpr_memref(a,l) { if (bpr_memref_hook) (*bpr_memref_hook)(a,l); }
 #else
 #define bpr_memref(a,l)
 #endif
 
+/* write watch (memory_set_write_watch), a single range test unless a write hits the range */
+#define writewatch(a,l) { if ((offs_t)((a) - writewatch_start) < writewatch_length) (*memory_write_watch_hook)(cur_context,a,l); }
+
 #define READBYTE8(name,abits,lookup,handlist,mask)										\
 data8_t name(offs_t address)															\
 {																						\
@@ -1827,6 +2154,13 @@ data8_t name(offs_t address)															\
 																						\
 	/* perform lookup */																\
 	address &= mask;bpr_memref(address,1);																	\
+	if (abits == 16 && readmem_page)													\
+	{																					\
+		/* direct RAM/ROM/bank page */													\
+		UINT8 *page = readmem_page[address >> 8];										\
+		if (page)																		\
+			MEMREADEND(page[address])													\
+	}																					\
 	entry = lookup[LEVEL1_INDEX(address,abits,0)];										\
 	if (entry >= SUBTABLE_BASE)															\
 		entry = lookup[LEVEL2_INDEX(entry,address,abits,0)];							\
@@ -2083,7 +2417,7 @@ void name(offs_t address, data8_t data)													\
 	MEMWRITESTART																		\
 																						\
 	/* perform lookup */																\
-	address &= mask;bpr_memref(address,1);																	\
+	address &= mask;bpr_memref(address,1);writewatch(address,1);																	\
 	entry = lookup[LEVEL1_INDEX(address,abits,0)];										\
 	if (entry >= SUBTABLE_BASE)															\
 		entry = lookup[LEVEL2_INDEX(entry,address,abits,0)];							\
@@ -2108,7 +2442,7 @@ void name(offs_t address, data8_t data)													\
 	MEMWRITESTART																		\
 																						\
 	/* perform lookup */																\
-	address &= mask;bpr_memref(address,1);																	\
+	address &= mask;bpr_memref(address,1);writewatch(address,1);																	\
 	entry = lookup[LEVEL1_INDEX(address,abits,1)];										\
 	if (entry >= SUBTABLE_BASE)															\
 		entry = lookup[LEVEL2_INDEX(entry,address,abits,1)];							\
@@ -2134,7 +2468,7 @@ void name(offs_t address, data8_t data)													\
 	MEMWRITESTART																		\
 																						\
 	/* perform lookup */																\
-	address &= mask;bpr_memref(address,1);																	\
+	address &= mask;bpr_memref(address,1);writewatch(address,1);																	\
 	entry = lookup[LEVEL1_INDEX(address,abits,1)];										\
 	if (entry >= SUBTABLE_BASE)															\
 		entry = lookup[LEVEL2_INDEX(entry,address,abits,1)];							\
@@ -2160,7 +2494,7 @@ void name(offs_t address, data8_t data)													\
 	MEMWRITESTART																		\
 																						\
 	/* perform lookup */																\
-	address &= mask;bpr_memref(address,1);																	\
+	address &= mask;bpr_memref(address,1);writewatch(address,1);																	\
 	entry = lookup[LEVEL1_INDEX(address,abits,2)];										\
 	if (entry >= SUBTABLE_BASE)															\
 		entry = lookup[LEVEL2_INDEX(entry,address,abits,2)];							\
@@ -2186,7 +2520,7 @@ void name(offs_t address, data8_t data)													\
 	MEMWRITESTART																		\
 																						\
 	/* perform lookup */																\
-	address &= mask;bpr_memref(address,1);																	\
+	address &= mask;bpr_memref(address,1);writewatch(address,1);																	\
 	entry = lookup[LEVEL1_INDEX(address,abits,2)];										\
 	if (entry >= SUBTABLE_BASE)															\
 		entry = lookup[LEVEL2_INDEX(entry,address,abits,2)];							\
@@ -2218,7 +2552,7 @@ void name(offs_t address, data16_t data)												\
 	MEMWRITESTART																		\
 																						\
 	/* perform lookup */																\
-	address &= mask & ~1;bpr_memref(address,2);																	\
+	address &= mask & ~1;bpr_memref(address,2);writewatch(address,2);																	\
 	entry = lookup[LEVEL1_INDEX(address,abits,1)];										\
 	if (entry >= SUBTABLE_BASE)															\
 		entry = lookup[LEVEL2_INDEX(entry,address,abits,1)];							\
@@ -2243,7 +2577,7 @@ void name(offs_t address, data16_t data)												\
 	MEMWRITESTART																		\
 																						\
 	/* perform lookup */																\
-	address &= mask & ~1;bpr_memref(address,2);																	\
+	address &= mask & ~1;bpr_memref(address,2);writewatch(address,2);																	\
 	entry = lookup[LEVEL1_INDEX(address,abits,2)];										\
 	if (entry >= SUBTABLE_BASE)															\
 		entry = lookup[LEVEL2_INDEX(entry,address,abits,2)];							\
@@ -2269,7 +2603,7 @@ void name(offs_t address, data16_t data)												\
 	MEMWRITESTART																		\
 																						\
 	/* perform lookup */																\
-	address &= mask & ~1;bpr_memref(address,2);																	\
+	address &= mask & ~1;bpr_memref(address,2);writewatch(address,2);																	\
 	entry = lookup[LEVEL1_INDEX(address,abits,2)];										\
 	if (entry >= SUBTABLE_BASE)															\
 		entry = lookup[LEVEL2_INDEX(entry,address,abits,2)];							\
@@ -2301,7 +2635,7 @@ void name(offs_t address, data32_t data)												\
 	MEMWRITESTART																		\
 																						\
 	/* perform lookup */																\
-	address &= mask & ~3;bpr_memref(address,4);																	\
+	address &= mask & ~3;bpr_memref(address,4);writewatch(address,4);																	\
 	entry = lookup[LEVEL1_INDEX(address,abits,2)];										\
 	if (entry >= SUBTABLE_BASE)															\
 		entry = lookup[LEVEL2_INDEX(entry,address,abits,2)];							\
@@ -2773,6 +3107,19 @@ static int init_static(void)
 	memset(wporthandler16, 0, sizeof(wporthandler16));
 	memset(wporthandler32, 0, sizeof(wporthandler32));
 
+	memset(&rmemindex8,  0, sizeof(rmemindex8));
+	memset(&rmemindex16, 0, sizeof(rmemindex16));
+	memset(&rmemindex32, 0, sizeof(rmemindex32));
+	memset(&wmemindex8,  0, sizeof(wmemindex8));
+	memset(&wmemindex16, 0, sizeof(wmemindex16));
+	memset(&wmemindex32, 0, sizeof(wmemindex32));
+	memset(&rportindex8,  0, sizeof(rportindex8));
+	memset(&rportindex16, 0, sizeof(rportindex16));
+	memset(&rportindex32, 0, sizeof(rportindex32));
+	memset(&wportindex8,  0, sizeof(wportindex8));
+	memset(&wportindex16, 0, sizeof(wportindex16));
+	memset(&wportindex32, 0, sizeof(wportindex32));
+
 	set_static_handler(STATIC_BANK1,  mrh8_bank1,  NULL,         NULL,         mwh8_bank1,  NULL,         NULL);
 	set_static_handler(STATIC_BANK2,  mrh8_bank2,  NULL,         NULL,         mwh8_bank2,  NULL,         NULL);
 	set_static_handler(STATIC_BANK3,  mrh8_bank3,  NULL,         NULL,         mwh8_bank3,  NULL,         NULL);
@@ -228,6 +228,7 @@ struct ExtMemory
 
 /* ----- banking constants ----- */
 #define MAX_BANKS				24						/* maximum number of banks */
+#define MAX_BANK_ENTRIES		256						/* maximum number of pre-registered bases per bank */
 #define STATIC_BANKMAX			(STATIC_RAM - 1)		/* handler constant of last bank */
 
 
@@ -820,6 +821,9 @@ void		memory_set_unmap_value(data32_t value);
 
 /* ----- dynamic bank handlers ----- */
 void		memory_set_bankhandler_r(int bank, offs_t offset, mem_read_handler handler);
+void		memory_update_bank_pages(int bank);
+void		memory_configure_bank(int bank, int startentry, int numentries, void *base, offs_t stride);
+void		memory_set_bank(int bank, int entrynum);
 void		memory_set_bankhandler_w(int bank, offs_t offset, mem_write_handler handler);
 
 /* ----- opcode base control ---- */
@@ -830,10 +834,16 @@ void		memory_set_opcode_base(int cpunum, void *base);
 void		memory_set_encrypted_opcode_range(int cpunum, offs_t min_address,offs_t max_address);
 extern offs_t encrypted_opcode_start[],encrypted_opcode_end[];
 
+/* ----- write watch ---- */
+void		memory_set_write_watch(int cpunum, offs_t start, offs_t end);
+extern void (*memory_write_watch_hook)(int cpunum, offs_t address, int length);
+
 /* ----- return a base pointer to memory ---- */
 void *		memory_find_base(int cpunum, offs_t offset);
 void *		memory_get_read_ptr(int cpunum, offs_t offset);
 void *		memory_get_write_ptr(int cpunum, offs_t offset);
+UINT32		memory_get_read_bankid(int cpunum, offs_t offset);
+void *		memory_get_ram_page(int cpunum, offs_t offset, offs_t size);
 
 /* ----- dynamic memory mapping ----- */
 data8_t *	install_mem_read_handler    (int cpunum, offs_t start, offs_t end, mem_read_handler handler);
@@ -951,6 +961,7 @@ do {																					\
 	if ((bank) >= STATIC_BANK1 && (bank) <= STATIC_BANKMAX)								\
 	{																					\
 		cpu_bankbase[bank] = (UINT8 *)(base);											\
+		memory_update_bank_pages(bank);													\
 		if (opcode_entry == (bank) && cpu_getactivecpu() >= 0)							\
 		{																				\
 			opcode_entry = 0xff;														\
@@ -160,6 +160,14 @@ const char *osd_get_fps_text(const struct performance_info *performance);
 */
 int osd_start_audio_stream(int stereo);
 int osd_update_audio_stream(INT16 *buffer);
+#ifdef LIBPINMAME
+/*
+  Only called if osd_start_audio_stream() enabled mixer_set_float_output():
+  same contract as osd_update_audio_stream(), but the samples are floats in the
+  -1..1 range, straight from the mixer accumulators (no dither).
+*/
+int osd_update_audio_stream_float(float *buffer);
+#endif
 void osd_stop_audio_stream(void);
 
 /*
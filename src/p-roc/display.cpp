@@ -9,6 +9,23 @@ extern "C" {
 // Buffer to hold the next full DMD frame to send to the P-ROC
 UINT8 procdmd[PROC_NUM_DMD_FRAMES][0x200];
 
+// Last frame sent to the P-ROC, to only upload frames that changed
+static UINT8 procdmdSent[PROC_NUM_DMD_FRAMES][0x200];
+static int procdmdSentValid = 0;
+
+// Bit order reversal of each byte value, built on first use
+static UINT8 procReversedBits[256];
+static int procReversedBitsReady = 0;
+
+static void procInitReversedBits(void) {
+	int i;
+	for (i = 0; i < 256; i++) {
+		procReversedBits[i] = (UINT8)(((i & 0x01) << 7) | ((i & 0x02) << 5) | ((i & 0x04) << 3) | ((i & 0x08) << 1) |
+		                              ((i & 0x10) >> 1) | ((i & 0x20) >> 3) | ((i & 0x40) >> 5) | ((i & 0x80) >> 7));
+	}
+	procReversedBitsReady = 1;
+}
+
 // Initialize the DMD logic in the P-ROC
 void procDMDInit(void) {
 	int i;
@@ -40,6 +57,7 @@ void procDMDInit(void) {
 	for (i = 0; i < PROC_NUM_DMD_FRAMES; i++) {
 		memset(procdmd[i], 0, 0x200);
 	}
+	procdmdSentValid = 0;
 }
 
 // Reset the buffer.
@@ -74,20 +92,21 @@ void procFillDMDSubFrame(int frameIndex, UINT8 *dotData, int length)
 	memcpy(procdmd[frameIndex], dotData, length);
 }
 
+// Copy the incoming dotData into a subframe, reversing the bit order of each byte.
+void procFillDMDSubFrameReversed(int frameIndex, const UINT8 *dotData, int length)
+{
+	int i;
+	if (!procReversedBitsReady) procInitReversedBits();
+	for (i = 0; i < length; i++) {
+		procdmd[frameIndex][i] = procReversedBits[dotData[i]];
+	}
+}
+
 void procReverseSubFrameBytes(int frameIndex) {
 	int i;
-	uint8_t byte, new_byte;
+	if (!procReversedBitsReady) procInitReversedBits();
 	for (i=0; i<0x200; i++) {
-		byte = procdmd[frameIndex][i];
-		new_byte = ((byte & 0x1) << 7) |
-		           ((byte & 0x2) << 5) |
-		           ((byte & 0x4) << 3) |
-		           ((byte & 0x8) << 1) |
-		           ((byte & 0x10) >> 1) |
-		           ((byte & 0x20) >> 3) |
-		           ((byte & 0x40) >> 5) |
-		           ((byte & 0x80) >> 7);
-		procdmd[frameIndex][i] = new_byte;
+		procdmd[frameIndex][i] = procReversedBits[procdmd[frameIndex][i]];
 	}
 }
 
@@ -297,10 +316,14 @@ void procDrawSegment(int x, int y, int seg) {
     }
 }
 
-// Send the current DMD Frame to the P-ROC
+// Send the current DMD Frame to the P-ROC, unless it is the one already sent
 void procUpdateDMD(void) {
 	if (proc) {
+		if (procdmdSentValid && memcmp(procdmdSent, procdmd, sizeof(procdmd)) == 0)
+			return;
 		PRDMDDraw(proc, procdmd[0]);
+		memcpy(procdmdSent, procdmd, sizeof(procdmd));
+		procdmdSentValid = 1;
 	}
 }
 
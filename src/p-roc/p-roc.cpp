@@ -152,13 +152,35 @@ void setMachineType(char *yaml_filename) {
 	}
 }
 
+// Set when driver commands are waiting for the next procSync.
+static int procFlushPending = 0;
+
 // Send all pending commands to the P-ROC.
 void procFlush(void) {
+	procFlushPending = 0;
 	PRFlushWriteData(proc);
 }
 
+// Send the pending commands on the next procSync, so that all the lamp and
+// coil changes of the same emulated millisecond go out in one write.
+void procRequestFlush(void) {
+	procFlushPending = 1;
+}
+
+// Called every emulated millisecond: pull the switch (and DMD frame) events
+// and flush the driver commands requested since the last call.
+void procSync(void) {
+	if (proc) {
+		procGetSwitchEvents();
+		if (procFlushPending)
+			procFlush();
+	}
+}
+
 void procDeinitialize() {
 	if (proc) {
+		if (procFlushPending)
+			procFlush();
 		PRDelete(proc);
 	}
 }
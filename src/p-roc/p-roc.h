@@ -45,6 +45,7 @@ void procClearDMD(void);
 void procDrawDot(int x, int y, int color);
 void procDrawSegment(int x, int y, int seg);
 void procFillDMDSubFrame(int frameIndex, UINT8 *dotData, int length);
+void procFillDMDSubFrameReversed(int frameIndex, const UINT8 *dotData, int length);
 void procReverseSubFrameBytes(int frameIndex);
 void procUpdateDMD(void);
 void procUpdateAlphaDisplay(UINT16 *top, UINT16 *bottom);
@@ -86,6 +87,8 @@ void procBallCreditDisplay(void);
 int procGetYamlPinmameSettingInt(const char *key, int defaultValue);
 void procTickleWatchdog(void);
 void procFlush(void);
+void procRequestFlush(void);
+void procSync(void);
 void procCheckArduinoF14(void);
 
 int osd_is_proc_pressed(int code);
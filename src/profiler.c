@@ -6,6 +6,12 @@
 extern int uirotcharwidth, uirotcharheight;
 
 
+/* what the profiler is running for */
+#define PROFILE_OVERLAY	1
+#define PROFILE_TRACE	2
+#define PROFILE_CSV		4
+#define PROFILE_TOTALS	8
+
 static int use_profiler;
 
 
@@ -24,7 +30,7 @@ static int use_profiler;
 
 struct profile_data
 {
-	UINT64 count[MEMORY][PROFILER_TOTAL];
+	UINT64 count[MEMORY][PROFILER_MAX_LABELS];
 	unsigned int cpu_context_switches[MEMORY];
 };
 
@@ -32,19 +38,338 @@ static struct profile_data profile;
 static int memory;
 
 
-static int FILO_type[10];
-static cycles_t FILO_start[10];
+/* duration histograms, one log2 bucket per power of two ticks */
+#define HISTOGRAM_BUCKETS 48
+
+struct profile_stats
+{
+	UINT64 inclusive[PROFILER_MAX_LABELS];
+	UINT64 exclusive[PROFILER_MAX_LABELS];
+	UINT64 longest[PROFILER_MAX_LABELS];
+	unsigned int calls[PROFILER_MAX_LABELS];
+	UINT64 count[PROFILER_MAX_LABELS];
+	unsigned int histogram[PROFILER_MAX_LABELS][HISTOGRAM_BUCKETS];
+};
+
+static struct profile_stats stats;
+
+/* running totals (PROFILE_TOTALS) */
+static UINT64 totals_inclusive[PROFILER_MAX_LABELS];
+static UINT64 totals_calls[PROFILER_MAX_LABELS];
+static UINT64 totals_count[PROFILER_MAX_LABELS];
+
+
+/* trace ring buffer */
+#define TRACE_EVENTS (256*1024)
+
+struct trace_event
+{
+	cycles_t start;
+	cycles_t duration;	/* the count for instant events */
+	int type;
+	int depth;			/* -1 for instant events */
+};
+
+static struct trace_event *trace;
+static unsigned int trace_count;
+static char trace_filename[256];
+
+
+/* CSV output */
+static FILE *csv_file;
+static cycles_t csv_interval;	/* in osd_cycles() */
+static cycles_t csv_last;
+
+
+/* profiling ticks to seconds calibration, against osd_cycles() */
+static cycles_t calib_ticks, calib_cycles;
+
+
+static char label_names[PROFILER_MAX_LABELS][32] =
+{
+	"CPU 1  ",
+	"CPU 2  ",
+	"CPU 3  ",
+	"CPU 4  ",
+	"CPU 5  ",
+	"CPU 6  ",
+	"CPU 7  ",
+	"CPU 8  ",
+	"Mem rd ",
+	"Mem wr ",
+	"Video  ",
+	"drawgfx",
+	"copybmp",
+	"tmdraw ",
+	"tmdrroz",
+	"tmupdat",
+	"Artwork",
+	"Blit   ",
+	"Sound  ",
+	"Mixer  ",
+	"Callbck",
+	"Hiscore",
+	"Input  ",
+	"Extra  ",
+	"User1  ",
+	"User2  ",
+	"User3  ",
+	"User4  ",
+	"Profilr",
+	"Idle   ",
+};
+static int label_count = PROFILER_TOTAL;
+
+
+#define FILO_DEPTH 32
+
+static int FILO_type[FILO_DEPTH];
+static cycles_t FILO_start[FILO_DEPTH];	/* start of the current exclusive slice */
+static cycles_t FILO_begin[FILO_DEPTH];	/* start of the section */
 static int FILO_length;
+static int FILO_overflow;
+
+
+/* the nesting is tracked even while the profiler is off, so it can be
+   started from anywhere: the open sections then start now */
+static void profiler_enable(int what)
+{
+	if (!use_profiler)
+	{
+		const cycles_t curr_cycles = osd_profiling_ticks();
+		int i;
+
+		for (i = 0;i < FILO_length;i++)
+			FILO_start[i] = FILO_begin[i] = curr_cycles;
+
+		calib_ticks = curr_cycles;
+		calib_cycles = osd_cycles();
+	}
+	use_profiler |= what;
+}
+
+static double profiler_ticks_per_second(void)
+{
+	const cycles_t ticks = osd_profiling_ticks() - calib_ticks;
+	const cycles_t cycles = osd_cycles() - calib_cycles;
+
+	if (cycles == 0 || ticks == 0)
+		return 1000000.0;
+	return (double)ticks * osd_cycles_per_second() / cycles;
+}
+
+static const char *profiler_name(int type, char *buf)
+{
+	int i = strlen(label_names[type]);
+
+	/* the overlay names are padded */
+	strcpy(buf, label_names[type]);
+	while (i > 0 && buf[i-1] == ' ')
+		buf[--i] = 0;
+	return buf;
+}
 
 void profiler_start(void)
 {
-	use_profiler = 1;
-	FILO_length = 0;
+	profiler_enable(PROFILE_OVERLAY);
 }
 
 void profiler_stop(void)
 {
-	use_profiler = 0;
+	use_profiler &= ~PROFILE_OVERLAY;
+}
+
+int profiler__label(const char *name, int fallback)
+{
+	int i;
+
+	if (!name || !name[0])
+		return fallback;
+
+	for (i = PROFILER_TOTAL;i < label_count;i++)
+		if (!strcmp(label_names[i], name))
+			return i;
+
+	if (label_count >= PROFILER_MAX_LABELS || strlen(name) >= sizeof(label_names[0]))
+		return fallback;
+
+	strcpy(label_names[label_count], name);
+	return label_count++;
+}
+
+static void profiler_write_csv(void)
+{
+	const double ticks_per_usec = profiler_ticks_per_second() / 1000000.0;
+	const double time = (double)(osd_cycles() - calib_cycles) / osd_cycles_per_second();
+	char buf[32];
+	int i;
+
+	for (i = 0;i < label_count;i++)
+	{
+		double percentile[3];
+		int p, bucket, seen;
+
+		if (!stats.calls[i] && !stats.count[i])
+			continue;
+
+		/* upper bound of the bucket holding the p50/p95/p99 call */
+		for (p = 0;p < 3;p++)
+		{
+			static const double rank[3] = { 0.50, 0.95, 0.99 };
+			const unsigned int target = (unsigned int)(stats.calls[i] * rank[p]);
+
+			seen = 0;
+			for (bucket = 0;bucket < HISTOGRAM_BUCKETS - 1;bucket++)
+				if ((seen += stats.histogram[i][bucket]) > target)
+					break;
+			percentile[p] = (double)((UINT64)2 << bucket) / ticks_per_usec;
+			if (percentile[p] > stats.longest[i] / ticks_per_usec)
+				percentile[p] = stats.longest[i] / ticks_per_usec;
+		}
+
+		fprintf(csv_file, "%.3f,%s,%u,%.1f,%.1f,%.2f,%.2f,%.2f,%.2f,%llu\n", time, profiler_name(i, buf), stats.calls[i],
+				stats.inclusive[i] / ticks_per_usec, stats.exclusive[i] / ticks_per_usec,
+				percentile[0], percentile[1], percentile[2], stats.longest[i] / ticks_per_usec, (unsigned long long)stats.count[i]);
+	}
+	fflush(csv_file);
+
+	memset(&stats, 0, sizeof(stats));
+}
+
+int profiler_set_csv(const char *filename, double interval)
+{
+	if (csv_file)
+	{
+		fclose(csv_file);
+		csv_file = NULL;
+	}
+	use_profiler &= ~PROFILE_CSV;
+
+	if (!filename || !filename[0])
+		return 0;
+
+	if ((csv_file = fopen(filename, "w")) == NULL)
+	{
+		logerror("Profiler: cannot create %s\n", filename);
+		return 1;
+	}
+	fprintf(csv_file, "time_s,section,calls,inclusive_us,exclusive_us,p50_us,p95_us,p99_us,max_us,count\n");
+
+	memset(&stats, 0, sizeof(stats));
+	csv_interval = (cycles_t)((interval > 0.0 ? interval : 1.0) * osd_cycles_per_second());
+	csv_last = osd_cycles();
+	profiler_enable(PROFILE_CSV);
+	return 0;
+}
+
+static int profiler_write_trace(void)
+{
+	const double ticks_per_usec = profiler_ticks_per_second() / 1000000.0;
+	const unsigned int count = trace_count < TRACE_EVENTS ? trace_count : TRACE_EVENTS;
+	const unsigned int first = trace_count - count;
+	char buf[32];
+	unsigned int i;
+	FILE *f;
+
+	if ((f = fopen(trace_filename, "w")) == NULL)
+	{
+		logerror("Profiler: cannot create %s\n", trace_filename);
+		return 1;
+	}
+
+	fprintf(f, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+	fprintf(f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"%s\"}}", Machine && Machine->gamedrv ? Machine->gamedrv->name : "emulation");
+	for (i = 0;i < count;i++)
+	{
+		const struct trace_event *e = &trace[(first + i) % TRACE_EVENTS];
+
+		if (e->depth < 0)
+			fprintf(f, ",\n{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"args\":{\"count\":%lld}}",
+					profiler_name(e->type, buf), (e->start - calib_ticks) / ticks_per_usec, (long long)e->duration);
+		else
+			fprintf(f, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"depth\":%d}}",
+					profiler_name(e->type, buf), (e->start - calib_ticks) / ticks_per_usec, e->duration / ticks_per_usec, e->depth);
+	}
+	fprintf(f, "\n]}\n");
+	fclose(f);
+	return 0;
+}
+
+int profiler_set_trace(const char *filename)
+{
+	int res = 0;
+
+	if (trace)
+	{
+		use_profiler &= ~PROFILE_TRACE;
+		res = profiler_write_trace();
+		free(trace);
+		trace = NULL;
+	}
+
+	if (!filename || !filename[0])
+		return res;
+
+	if (strlen(filename) >= sizeof(trace_filename) || (trace = malloc(TRACE_EVENTS * sizeof(trace[0]))) == NULL)
+		return 1;
+
+	strcpy(trace_filename, filename);
+	trace_count = 0;
+	profiler_enable(PROFILE_TRACE);
+	return res;
+}
+
+void profiler_set_totals(int enable)
+{
+	if (!enable)
+	{
+		use_profiler &= ~PROFILE_TOTALS;
+		return;
+	}
+
+	if (!(use_profiler & PROFILE_TOTALS))
+	{
+		memset(totals_inclusive, 0, sizeof(totals_inclusive));
+		memset(totals_calls, 0, sizeof(totals_calls));
+		memset(totals_count, 0, sizeof(totals_count));
+		profiler_enable(PROFILE_TOTALS);
+	}
+}
+
+double profiler_get_total(int type, UINT64 *calls)
+{
+	if (type < 0 || type >= PROFILER_MAX_LABELS)
+		return 0.0;
+
+	if (calls)
+		*calls = totals_calls[type];
+	return totals_inclusive[type] / profiler_ticks_per_second();
+}
+
+UINT64 profiler_get_count(int type)
+{
+	if (type < 0 || type >= PROFILER_MAX_LABELS)
+		return 0;
+
+	return totals_count[type];
+}
+
+void profiler__count(int type, unsigned int count, int event)
+{
+	if (!use_profiler || type < 0 || type >= PROFILER_MAX_LABELS)
+		return;
+
+	stats.count[type] += count;
+	totals_count[type] += count;
+
+	if (event && (use_profiler & PROFILE_TRACE))
+	{
+		struct trace_event *e = &trace[trace_count++ % TRACE_EVENTS];
+		e->start = osd_profiling_ticks();
+		e->duration = count;
+		e->type = type;
+		e->depth = -1;
+	}
 }
 
 void profiler__mark(int type)
@@ -54,7 +379,18 @@ void profiler__mark(int type)
 
 	if (!use_profiler)
 	{
-		FILO_length = 0;
+		/* only keep the nesting */
+		if (type != PROFILER_END)
+		{
+			if (FILO_length >= FILO_DEPTH)
+				FILO_overflow++;
+			else
+				FILO_type[FILO_length++] = type;
+		}
+		else if (FILO_overflow > 0)
+			FILO_overflow--;
+		else if (FILO_length > 0)
+			FILO_length--;
 		return;
 	}
 
@@ -65,23 +401,37 @@ void profiler__mark(int type)
 
 	if (type != PROFILER_END)
 	{
-		if (FILO_length > 0)
+		if (FILO_length >= FILO_DEPTH)
 		{
-			if (FILO_length >= 10)
-			{
+			if (!FILO_overflow++)
 logerror("Profiler error: FILO buffer overflow\n");
-				return;
-			}
+			return;
+		}
 
+		if (FILO_length > 0)
+		{
 			/* handle nested calls */
-			profile.count[memory][FILO_type[FILO_length-1]] += curr_cycles - FILO_start[FILO_length-1];
+			const int parent = FILO_type[FILO_length-1];
+			const cycles_t slice = curr_cycles - FILO_start[FILO_length-1];
+
+			profile.count[memory][parent] += slice;
+			stats.exclusive[parent] += slice;
 		}
 		FILO_type[FILO_length] = type;
 		FILO_start[FILO_length] = curr_cycles;
+		FILO_begin[FILO_length] = curr_cycles;
 		FILO_length++;
 	}
 	else
 	{
+		int section, bucket;
+		cycles_t duration;
+
+		if (FILO_overflow > 0)
+		{
+			FILO_overflow--;
+			return;
+		}
 		if (FILO_length <= 0)
 		{
 logerror("Profiler error: FILO buffer underflow\n");
@@ -89,12 +439,43 @@ logerror("Profiler error: FILO buffer underflow\n");
 		}
 
 		FILO_length--;
-		profile.count[memory][FILO_type[FILO_length]] += curr_cycles - FILO_start[FILO_length];
+		section = FILO_type[FILO_length];
+		profile.count[memory][section] += curr_cycles - FILO_start[FILO_length];
+		stats.exclusive[section] += curr_cycles - FILO_start[FILO_length];
+
+		duration = curr_cycles - FILO_begin[FILO_length];
+		totals_inclusive[section] += duration;
+		totals_calls[section]++;
+		stats.inclusive[section] += duration;
+		stats.calls[section]++;
+		if (duration > stats.longest[section])
+			stats.longest[section] = duration;
+		for (bucket = 0;bucket < HISTOGRAM_BUCKETS - 1 && (duration >> (bucket + 1)) != 0;bucket++)
+			;
+		stats.histogram[section][bucket]++;
+
+		if (use_profiler & PROFILE_TRACE)
+		{
+			struct trace_event *e = &trace[trace_count++ % TRACE_EVENTS];
+			e->start = FILO_begin[FILO_length];
+			e->duration = duration;
+			e->type = section;
+			e->depth = FILO_length;
+		}
+
 		if (FILO_length > 0)
 		{
 			/* handle nested calls */
 			FILO_start[FILO_length-1] = curr_cycles;
 		}
+		else if ((use_profiler & PROFILE_CSV) && osd_cycles() - csv_last >= csv_interval)
+		{
+			/* top level: no section is open, a good time for the periodic output */
+			csv_last += csv_interval;
+			if (osd_cycles() - csv_last >= csv_interval)
+				csv_last = osd_cycles();
+			profiler_write_csv();
+		}
 	}
 }
 
@@ -104,68 +485,35 @@ void profiler_show(struct mame_bitmap *bitmap)
 	UINT64 total,normalize;
 	UINT64 computed;
 	int line;
-	char buf[30];
-	static const char *names[PROFILER_TOTAL] =
-	{
-		"CPU 1  ",
-		"CPU 2  ",
-		"CPU 3  ",
-		"CPU 4  ",
-		"CPU 5  ",
-		"CPU 6  ",
-		"CPU 7  ",
-		"CPU 8  ",
-		"Mem rd ",
-		"Mem wr ",
-		"Video  ",
-		"drawgfx",
-		"copybmp",
-		"tmdraw ",
-		"tmdrroz",
-		"tmupdat",
-		"Artwork",
-		"Blit   ",
-		"Sound  ",
-		"Mixer  ",
-		"Callbck",
-		"Hiscore",
-		"Input  ",
-		"Extra  ",
-		"User1  ",
-		"User2  ",
-		"User3  ",
-		"User4  ",
-		"Profilr",
-		"Idle   ",
-	};
-	static int showdelay[PROFILER_TOTAL];
-
-
-	if (!use_profiler) return;
+	char buf[64];
+	static int showdelay[PROFILER_MAX_LABELS];
+
+
+	if (!(use_profiler & PROFILE_OVERLAY)) return;
 
 	profiler_mark(PROFILER_PROFILER);
 
+	/* the dynamic labels split the subsystems further, so they are normalized too */
 	computed = 0;
-	i = 0;
-	while (i < PROFILER_PROFILER)
+	for (i = 0;i < label_count;i++)
 	{
+		if (i == PROFILER_PROFILER)
+			i = PROFILER_TOTAL;
 		for (j = 0;j < MEMORY;j++)
 			computed += profile.count[j][i];
-		i++;
 	}
 	normalize = computed;
-	while (i < PROFILER_TOTAL)
+	for (i = PROFILER_PROFILER;i < PROFILER_TOTAL;i++)
 	{
 		for (j = 0;j < MEMORY;j++)
 			computed += profile.count[j][i];
-		i++;
 	}
 	total = computed;
 
 	if (total == 0 || normalize == 0) return;	/* we have been just reset */
 
 	line = 0;
-	for (i = 0;i < PROFILER_TOTAL;i++)
+	for (i = 0;i < label_count;i++)
 	{
 		computed = 0;
 		{
@@ -177,12 +525,12 @@ void profiler_show(struct mame_bitmap *bitmap)
 			if (computed) showdelay[i] = (int)Machine->drv->frames_per_second;
 			showdelay[i]--;
 
-			if (i < PROFILER_PROFILER)
-				sprintf(buf,"%s%3d%%%3d%%",names[i],
+			if (i < PROFILER_PROFILER || i >= PROFILER_TOTAL)
+				sprintf(buf,i < PROFILER_TOTAL ? "%s%3d%%%3d%%" : "%-16.16s%3d%%%3d%%",label_names[i],
 						(int)((computed * 100 + total/2) / total),
 						(int)((computed * 100 + normalize/2) / normalize));
 			else
-				sprintf(buf,"%s%3d%%",names[i],
+				sprintf(buf,"%s%3d%%",label_names[i],
 						(int)((computed * 100 + total/2) / total));
 			ui_text(bitmap,buf,0,(line++)*uirotcharheight);
 		}
@@ -197,7 +545,7 @@ void profiler_show(struct mame_bitmap *bitmap)
 	/* reset the counters */
 	memory = (memory + 1) % MEMORY;
 	profile.cpu_context_switches[memory] = 0;
-	for (i = 0;i < PROFILER_TOTAL;i++)
+	for (i = 0;i < PROFILER_MAX_LABELS;i++)
 		profile.count[memory][i] = 0;
 
 	profiler_mark(PROFILER_END);
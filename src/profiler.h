@@ -44,6 +44,9 @@ enum {
 	PROFILER_TOTAL
 };
 
+/* dynamic labels (profiler_label) are numbered from PROFILER_TOTAL up */
+#define PROFILER_MAX_LABELS	256
+
 
 /*
 To start profiling a certain section, e.g. video:
@@ -53,19 +56,60 @@ to end profiling the current section:
 profiler_mark(PROFILER_END);
 
 the profiler handles a FILO list so calls may be nested.
+
+Sections can also be given a name at runtime, e.g. one per sound stream:
+label = profiler_label("YM2151", PROFILER_SOUND);
+profiler_mark(label);
+profiler_label() returns the given fallback once the label table is full
+(or when the profiler is compiled out).
+
+The marks are compiled in with MAME_DEBUG or MAME_PROFILER. The memory
+handler marks (PROFILER_MEMREAD/MEMWRITE) stay MAME_DEBUG only, as they
+are too frequent for a release build.
 */
 
-#ifdef MAME_DEBUG
+#if defined(MAME_DEBUG) || defined(MAME_PROFILER)
 #define profiler_mark(type) profiler__mark(type)
+#define profiler_label(name,fallback) profiler__label(name,fallback)
+#define profiler_count(type,count) profiler__count(type,count,0)
+#define profiler_event(type,count) profiler__count(type,count,1)
 #else
 #define profiler_mark(type)
+#define profiler_label(name,fallback) (fallback)
+#define profiler_count(type,count)
+#define profiler_event(type,count)
 #endif
 
 void profiler__mark(int type);
+int profiler__label(const char *name, int fallback);
+
+/* A section can also carry a count (e.g. the samples a sound stream
+generated), exported in the CSV count column:
+profiler_count(label, samples);
+profiler_event() adds a count that is also an instant event in the trace
+(e.g. an audio buffer underrun). */
+void profiler__count(int type, unsigned int count, int event);
 
 /* functions called by usrintf.c */
 void profiler_start(void);
 void profiler_stop(void);
 void profiler_show(struct mame_bitmap *bitmap);
 
+/* Export, to be called from the emulation thread.
+   profiler_set_trace() records every section (up to about 256K of them,
+   the oldest are dropped) and writes them as a Chrome trace-event JSON
+   file (chrome://tracing, Perfetto) when stopped with a NULL filename.
+   profiler_set_csv() appends, every 'interval' seconds, one line per
+   active section with the call count, inclusive and exclusive time,
+   the p50/p95/p99/max durations and the profiler_count() total. Both
+   return 0 on success. */
+int profiler_set_trace(const char *filename);
+int profiler_set_csv(const char *filename, double interval);
+
+/* running totals per section since profiler_set_totals(1): the calls
+   and inclusive time in seconds (used for the timer callback counters) */
+void profiler_set_totals(int enable);
+double profiler_get_total(int type, UINT64 *calls);
+UINT64 profiler_get_count(int type);
+
 #endif	/* PROFILER_H */
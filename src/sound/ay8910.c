@@ -968,6 +968,23 @@ WRITE16_HANDLER( AY8910_write_port_4_msb_w ) { if (ACCESSING_MSB) AY8910Write(4,
 
 
 
+/* number of whole samples, up to length, during which none of the tone, noise */
+/* or envelope counters expires; the output is constant over that run */
+INLINE int AY8910_steady_run(const struct AY8910 *PSG, int length)
+{
+	INT32 count = PSG->CountA;
+
+	if (PSG->CountB < count) count = PSG->CountB;
+	if (PSG->CountC < count) count = PSG->CountC;
+	if (PSG->CountN < count) count = PSG->CountN;
+	if (PSG->Holding == 0 && PSG->CountE < count) count = PSG->CountE;
+	if (count <= STEP)
+		return 0;
+
+	count = (count - 1) / STEP;
+	return (count < length) ? count : length;
+}
+
 static void AY8910Update(int chip,
 #ifdef SINGLE_CHANNEL_MIXER
                          INT16 *buffer,
@@ -1060,6 +1077,41 @@ static void AY8910Update(int chip,
 	{
 		int vola,volb,volc;
 		int left;
+		int run = AY8910_steady_run(PSG, length);
+
+		/* nothing toggles for a while: the square waves are simply high or */
+		/* low for the whole run, so write it out as a constant */
+		if (run)
+		{
+			int i;
+			vola = ((outn & 0x08) && PSG->OutputA) ? STEP : 0;
+			volb = ((outn & 0x10) && PSG->OutputB) ? STEP : 0;
+			volc = ((outn & 0x20) && PSG->OutputC) ? STEP : 0;
+			PSG->CountA -= run*STEP;
+			PSG->CountB -= run*STEP;
+			PSG->CountC -= run*STEP;
+			PSG->CountN -= run*STEP;
+			if (PSG->Holding == 0)
+				PSG->CountE -= run*STEP;
+#ifdef SINGLE_CHANNEL_MIXER
+			tmp_buf = (vola * (int)PSG->VolA * (int)PSG->mix_vol[0] + volb * (int)PSG->VolB * (int)PSG->mix_vol[1] + volc * (int)PSG->VolC * (int)PSG->mix_vol[2])/(int)(100*STEP);
+			tmp_buf = (tmp_buf < -32768) ? -32768 : ((tmp_buf > 32767) ? 32767 : tmp_buf);
+			for (i = 0; i < run; i++)
+				buf1[i] = tmp_buf;
+#else
+			for (i = 0; i < run; i++)
+			{
+				buf1[i] = (vola * PSG->VolA) / STEP;
+				buf2[i] = (volb * PSG->VolB) / STEP;
+				buf3[i] = (volc * PSG->VolC) / STEP;
+			}
+			buf2 += run;
+			buf3 += run;
+#endif
+			buf1 += run;
+			length -= run;
+			continue;
+		}
 
 		/* vola, volb and volc keep track of how long each square wave stays */
 		/* in the 1 position during the sample period. */
@@ -370,7 +370,23 @@ static void bsmt2000_update(int num, INT16 **buffer, int _length)
 				rvol = lvol = chip->adpcm_77;
 			}
 
+			/* muted voice: only advance the position, same as the loop below */
+			if (lvol == 0 && rvol == 0)
+			{
+				for (samp = 0; samp < length; samp++)
+				{
+					frac += rate;
+					pos += frac >> 11;
+					frac &= 0x7ff;
+					if (pos >= voice->reg[REG_LOOPEND])
+					{
+						pos += voice->reg[REG_LOOPSTART] - voice->reg[REG_LOOPEND];
+						frac = 0;
+					}
+				}
+			}
 			/* loop while we still have samples to generate */
+			else
             for (samp = 0; samp < length; samp++)
             {
                 INT32 val1 = base[pos];
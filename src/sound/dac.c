@@ -19,6 +19,72 @@ static double integrator[MAX_DAC];
 static int UnsignedVolTable[256];
 static int SignedVolTable[256];
 
+/* CPU driven DACs are written from IRQs at tens of kHz.  Instead of a partial
+   stream update per write, the writes are queued with their time stamp and
+   rendered in one go when the stream is updated at the end of the frame */
+#define DAC_EVENT_COUNT 2048	/* power of 2; a full ring falls back to a stream update */
+
+struct dac_event
+{
+	double time;
+	int value;
+};
+
+static struct dac_event events[MAX_DAC][DAC_EVENT_COUNT];
+static unsigned int event_head[MAX_DAC], event_tail[MAX_DAC];
+
+static void DAC_write(int num,int out)
+{
+#ifdef DAC_ENABLE_INTERPOLATION
+	/* update the output buffer before changing the registers */
+	stream_update(channel[num],0);
+	output[num] = out;
+#else
+	/* no sound: nothing will ever consume the ring */
+	if (Machine->sample_rate == 0)
+	{
+		output[num] = out;
+		return;
+	}
+
+	/* ring full: render what we have so far, which empties it */
+	if (event_head[num] - event_tail[num] == DAC_EVENT_COUNT)
+	{
+		stream_update(channel[num],0);
+		/* nothing was rendered since the last update, so the oldest write is already due */
+		if (event_head[num] - event_tail[num] == DAC_EVENT_COUNT)
+			output[num] = events[num][event_tail[num]++ & (DAC_EVENT_COUNT-1)].value;
+	}
+
+	events[num][event_head[num] & (DAC_EVENT_COUNT-1)].time = timer_get_time();
+	events[num][event_head[num] & (DAC_EVENT_COUNT-1)].value = out;
+	event_head[num]++;
+#endif
+}
+
+#ifndef DAC_ENABLE_INTERPOLATION
+/* apply the queued writes that happened before each sample; the buffer ends "now" */
+static void DAC_apply_events(int num,INT16 *const buffer,int length)
+{
+	const double now = timer_get_time();
+	int i = 0;
+
+	while (event_tail[num] != event_head[num])
+	{
+		const struct dac_event *ev = &events[num][event_tail[num] & (DAC_EVENT_COUNT-1)];
+		int pos = length - (int)((now - ev->time) * DAC_SAMPLE_RATE);
+		if (pos > length)
+			break;	/* still in the future, keep it for the next update */
+		for (; i < pos; i++)
+			buffer[i] = output[num];
+		output[num] = ev->value;
+		event_tail[num]++;
+	}
+	for (; i < length; i++)
+		buffer[i] = output[num];
+}
+#endif
+
 static void DAC_update(int num,INT16 *const buffer,int length)
 {
 	/* zero-length? bail */
@@ -26,8 +92,8 @@ static void DAC_update(int num,INT16 *const buffer,int length)
 		return;
 	else
 	{
-		int i;
 #ifdef DAC_ENABLE_INTERPOLATION
+		int i;
 		INT32 data = curr_output[num];
 		INT32 slope = ((output[num] - data) << 15) / length;
 		data <<= 15;
@@ -37,8 +103,7 @@ static void DAC_update(int num,INT16 *const buffer,int length)
 
 		curr_output[num] = output[num];
 #else
-		for (i = 0; i < length; i++)
-			buffer[i] = output[num];
+		DAC_apply_events(num,buffer,length);
 #endif
 	}
 }
@@ -48,12 +113,7 @@ void DAC_data_w(int num,int data)
 {
 	int out = UnsignedVolTable[data];
 
-	//if (output[num] != out)
-	{
-		/* update the output buffer before changing the registers */
-		stream_update(channel[num],0);
-		output[num] = out;
-	}
+	DAC_write(num,out);
 }
 
 
@@ -61,12 +121,7 @@ void DAC_signed_data_w(int num,int data)
 {
 	int out = SignedVolTable[data];
 
-	//if (output[num] != out)
-	{
-		/* update the output buffer before changing the registers */
-		stream_update(channel[num],0);
-		output[num] = out;
-	}
+	DAC_write(num,out);
 }
 
 
@@ -74,12 +129,7 @@ void DAC_data_16_w(int num,int data)
 {
 	int out = data >> 1;		/* range      0..32767 */
 
-	//if (output[num] != out)
-	{
-		/* update the output buffer before changing the registers */
-		stream_update(channel[num],0);
-		output[num] = out;
-	}
+	DAC_write(num,out);
 }
 
 void DAC_DC_offset_correction_data_16_w(int num, int data)
@@ -97,24 +147,14 @@ void DAC_DC_offset_correction_data_16_w(int num, int data)
 
 	prev_data[num] = data;
 
-	//if (output[num] != out)
-	{
-		/* update the output buffer before changing the registers */
-		stream_update(channel[num], 0);
-		output[num] = out;
-	}
+	DAC_write(num,out);
 }
 
 void DAC_signed_data_16_w(int num,int data)
 {
 	int out = data - 0x8000;	/* range -32768..32767 */
 
-	//if (output[num] != out)
-	{
-		/* update the output buffer before changing the registers */
-		stream_update(channel[num],0);
-		output[num] = out;
-	}
+	DAC_write(num,out);
 }
 
 
@@ -155,6 +195,7 @@ int DAC_sh_start(const struct MachineSound *msound)
 #endif
 		integrator[i] = 0.;
 		prev_data[i] = 0;
+		event_head[i] = event_tail[i] = 0;
 	}
 
 	return 0;
@@ -73,6 +73,20 @@ static struct node_description *output_node=NULL;
 static int discrete_stream=0;
 static int discrete_stereo=0;
 
+/* Flattened running order, built once the nodes are initialised.  Each op */
+/* holds the step function and the input links that are actually connected */
+/* so the per-sample loop doesn't have to look them up again.              */
+struct discrete_op
+{
+	struct node_description *node;
+	int (*step)(struct node_description *node);
+	int link_count;
+	double *link_dst[DISCRETE_MAX_INPUTS];
+	const double *link_src[DISCRETE_MAX_INPUTS];
+};
+static struct discrete_op *op_list=NULL;
+static int op_count=0;
+
 /* Uncomment this line to log discrete sound output to a file */
 //#define DISCRETE_WAVELOG
 /* Uncomment this line to log discrete sound debug log information to a file */
@@ -198,32 +212,73 @@ struct node_description* find_node(int node)
 	return NULL;
 }
 
-static void discrete_stream_update_stereo(int ch, INT16 **buffer, int length)
+/* Build the flattened op list from the running order.  Nodes without a  */
+/* step function (DSS_NULL) are dropped, links to NODE_NC are skipped.    */
+static int discrete_build_ops(void)
 {
-	/* Now we must do length iterations of the node list, one output for each step */
-	int loop,loop2,loop3;
-	struct node_description *node;
+	int loop,loop2;
 
-	for(loop=0;loop<length;loop++)
+	if((op_list=malloc(node_count*sizeof(struct discrete_op)))==NULL)
 	{
-		for(loop2=0;loop2<node_count;loop2++)
-		{
-			/* Pick the first node to process */
-			node=running_order[loop2];
+		logerror("discrete_sh_start() - Failed to allocate op list array.\n");
+		return 1;
+	}
+	op_count=0;
 
-			/* Work out what nodes/inputs are required, dont process NO CONNECT nodes */
-			/* these are ones that are connected to NODE_LIST[0]                      */
-			for(loop3=0;loop3<node->active_inputs;loop3++)
+	for(loop=0;loop<node_count;loop++)
+	{
+		struct node_description *node=running_order[loop];
+		struct discrete_op *op;
+
+		if(!module_list[node->module].step) continue;
+
+		op=&op_list[op_count++];
+		op->node=node;
+		op->step=module_list[node->module].step;
+		op->link_count=0;
+		for(loop2=0;loop2<node->active_inputs;loop2++)
+		{
+			if(node->input_node[loop2] && (node->input_node[loop2])->node!=NODE_NC)
 			{
-				if(node->input_node[loop3] && (node->input_node[loop3])->node!=NODE_NC) node->input[loop3]=(node->input_node[loop3])->output;
+				op->link_dst[op->link_count]=&node->input[loop2];
+				op->link_src[op->link_count]=&(node->input_node[loop2])->output;
+				op->link_count++;
 			}
-			/* Now step the node */
-			if(module_list[node->module].step) (*module_list[node->module].step)(node);
 		}
+	}
+	discrete_log("discrete_sh_start() - Op list built, %d of %d nodes stepped", op_count, node_count);
+	return 0;
+}
+
+/* Run one time step over the whole op list */
+INLINE void discrete_step_ops(void)
+{
+	const struct discrete_op *op=op_list;
+	const struct discrete_op * const end=op_list+op_count;
+
+	for(;op<end;op++)
+	{
+		int loop;
+
+		/* Fetch the connected inputs, then step the node */
+		for(loop=0;loop<op->link_count;loop++) *op->link_dst[loop]=*op->link_src[loop];
+		(*op->step)(op->node);
+	}
+}
+
+static void discrete_stream_update_stereo(int ch, INT16 **buffer, int length)
+{
+	/* Now we must do length iterations of the node list, one output for each step */
+	const struct dso_output_context *out=(const struct dso_output_context*)(output_node->context);
+	int loop;
+
+	for(loop=0;loop<length;loop++)
+	{
+		discrete_step_ops();
 
 		/* Now put the output into the buffers */
-		buffer[0][loop]=((struct dso_output_context*)(output_node->context))->left;
-		buffer[1][loop]=((struct dso_output_context*)(output_node->context))->right;
+		buffer[0][loop]=out->left;
+		buffer[1][loop]=out->right;
 	}
 #ifdef DISCRETE_WAVELOG
 	wav_add_data_16lr(wav_file, buffer[0],buffer[1], length);
@@ -233,29 +288,15 @@ static void discrete_stream_update_stereo(int ch, INT16 **buffer, int length)
 static void discrete_stream_update_mono(int ch,INT16 *buffer, int length)
 {
 	/* Now we must do length iterations of the node list, one output for each step */
-	int loop,loop2,loop3;
-	struct node_description *node;
+	const struct dso_output_context *out=(const struct dso_output_context*)(output_node->context);
+	int loop;
 
 	for(loop=0;loop<length;loop++)
 	{
-		for(loop2=0;loop2<node_count;loop2++)
-		{
-			/* Pick the first node to process */
-			node=running_order[loop2];
-
-			/* Work out what nodes/inputs are required, dont process NO CONNECT nodes */
-			/* these are ones that are connected to NODE_LIST[0]                      */
-			for(loop3=0;loop3<node->active_inputs;loop3++)
-			{
-				if(node->input_node[loop3] && (node->input_node[loop3])->node!=NODE_NC) node->input[loop3]=(node->input_node[loop3])->output;
-			}
-
-			/* Now step the node */
-			if(module_list[node->module].step) (*module_list[node->module].step)(node);
-		}
+		discrete_step_ops();
 
 		/* Now put the output into the buffer */
-		buffer[loop]=(((struct dso_output_context*)(output_node->context))->left+((struct dso_output_context*)(output_node->context))->right)/2;
+		buffer[loop]=(out->left+out->right)/2;
 	}
 #ifdef DISCRETE_WAVELOG
 	wav_add_data_16(wav_file, buffer, length);
@@ -469,6 +510,9 @@ int discrete_sh_start (const struct MachineSound *msound)
 
 	discrete_log("discrete_sh_start() - Nodes initialised", node_count);
 
+	/* Flatten the running order for the stream update */
+	if(!failed && discrete_build_ops()) failed=1;
+
 	/* Different setup for Mono/Stereo systems */
 	if ((Machine->drv->sound_attributes&SOUND_SUPPORTS_STEREO) == SOUND_SUPPORTS_STEREO)
 	{
@@ -522,9 +566,12 @@ void discrete_sh_stop (void)
 	}
 	if(node_list) free(node_list);
 	if(running_order) free(running_order);
+	if(op_list) free(op_list);
 	node_count=0;
+	op_count=0;
 	node_list=NULL;
 	running_order=NULL;
+	op_list=NULL;
 
 #ifdef DISCRETE_DEBUGLOG
     if(disclogfile) fclose(disclogfile);
@@ -332,6 +332,7 @@ typedef struct fm_opl_f {
 
 	signed int phase_modulation;	/* phase modulation input (SLOT 2) */
 	signed int output[1];
+	UINT32 active;					/* channels that can sound in the current block */
 #if BUILD_Y8950
 	INT32 output_deltat[4];			/* for Y8950 DELTA-T, chip is mono, that 4 here is just for safety */
 #endif
@@ -766,6 +767,25 @@ INLINE void refresh_eg(FM_OPL* OPL)
 	return;
 }
 
+/* find the channels that can make sound in the next block. A channel with
+   all operators off and its feedback drained outputs nothing, and its phase
+   is reset on key-on. Key-on only happens between blocks, since register
+   writes update the stream first, so the set can only shrink within a block.
+   The rhythm channels are always run, since they share phases. */
+INLINE void OPL_find_active(FM_OPL *OPL)
+{
+	int ch;
+
+	OPL->active = (OPL->rhythm & 0x20) ? 0x1c0 : 0;
+	for (ch = 0; ch < 9; ch++)
+	{
+		OPL_CH *CH = &OPL->P_CH[ch];
+		if (CH->SLOT[SLOT1].state != EG_OFF || CH->SLOT[SLOT2].state != EG_OFF ||
+			CH->SLOT[SLOT1].op1_out[0] || CH->SLOT[SLOT1].op1_out[1])
+			OPL->active |= 1 << ch;
+	}
+}
+
 /* advance to next sample */
 INLINE void advance(FM_OPL *OPL)
 {
@@ -783,6 +803,9 @@ INLINE void advance(FM_OPL *OPL)
 
 		for (i=0; i<9*2; i++)
 		{
+			if (!(OPL->active & (1 << (i/2))))
+				continue;
+
 			CH  = &OPL->P_CH[i/2];
 			op  = &CH->SLOT[i&1];
 
@@ -862,6 +885,9 @@ INLINE void advance(FM_OPL *OPL)
 
 	for (i=0; i<9*2; i++)
 	{
+		if (!(OPL->active & (1 << (i/2))))
+			continue;
+
 		CH  = &OPL->P_CH[i/2];
 		op  = &CH->SLOT[i&1];
 
@@ -962,6 +988,9 @@ INLINE void OPL_CALC_CH( FM_OPL *OPL, OPL_CH *CH )
 
 	OPL->phase_modulation = 0;
 
+	if (!(OPL->active & (1 << (CH - OPL->P_CH))))
+		return;
+
 	/* SLOT 1 */
 	SLOT = &CH->SLOT[SLOT1];
 	env  = volume_calc(SLOT);
@@ -2164,6 +2193,8 @@ void YM3812UpdateOne(int which, INT16 *buffer, int length)
 		return;
 	}
 
+	OPL_find_active(OPL);
+
 	for( i=0; i < length ; i++ )
 	{
 		int lt;
@@ -2316,6 +2347,8 @@ void YM3526UpdateOne(int which, INT16 *buffer, int length)
 		return;
 	}
 
+	OPL_find_active(OPL);
+
 	for( i=0; i < length ; i++ )
 	{
 		int lt;
@@ -2511,6 +2544,8 @@ void Y8950UpdateOne(int which, INT16 *buffer, int length)
 		return;
 	}
 
+	OPL_find_active(OPL);
+
 	for( i=0; i < length ; i++ )
 	{
 		int lt;
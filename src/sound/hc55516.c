@@ -422,8 +422,8 @@ struct hc55516_data
 		} dbl;
 	} filter;
 
-	// Bit processor function
-	void (*process_bit)(struct hc55516_data *chip, const UINT8 bit, const double output_rate_ratio);
+	// Bit processor function, returns the decoded sample for the bit
+	double (*process_bit)(struct hc55516_data *chip, const UINT8 bit);
 
 	// Loudness compression function
 	float (*compress_loudness)(struct hc55516_data *chip, double sample);
@@ -592,59 +592,70 @@ static void init_output_filter(struct hc55516_data *chip)
 
 // ---------------------------------------------------------------------------
 //
-// Add a decoded output sample.  This takes a raw sample from the CVSD 
-// decoder, resamples it using the PCM sample rate of the MAME output stream,
-// and adds it to our output buffer to eventually pass to the MAME stream.
+// Add a block of decoded output samples.  This takes raw samples from the
+// CVSD decoder, resamples them using the PCM sample rate of the MAME output
+// stream, and adds them to our output buffer to eventually pass to the MAME
+// stream.  The whole block goes through libsamplerate at once, which yields
+// exactly the same output as feeding it one sample at a time, at a fraction
+// of the per-call overhead.
 //
-static void add_sample_out(struct hc55516_data *chip, const double sample, const double output_rate_ratio)
+static void add_samples_out(struct hc55516_data *chip, const float *samples, long count, const double output_rate_ratio)
 {
-	float fOut[128];
+	float fOut[1024];
 	SRC_DATA sd;
 	long i;
 
-	// resample at the MAME stream rate
-	const float fIn = (float)sample;
-	sd.data_in = &fIn;
-	sd.input_frames = 1;
-	sd.input_frames_used = 0;
-	sd.data_out = fOut;
-	sd.output_frames = _countof(fOut);
-	sd.output_frames_gen = 0;
-	sd.end_of_input = 0;
-	sd.src_ratio = output_rate_ratio;
-
 	// When using the src_process or src_callback_process APIs and updating the src_ratio field of the SRC_STATE struct,
 	// the library will try to smoothly transition between the conversion ratio of the last call and the conversion ratio of the current call.
 	// BUT we can disable this via:
-	src_set_ratio(chip->resample_state, sd.src_ratio);
+	src_set_ratio(chip->resample_state, output_rate_ratio);
 
-	if (src_process(chip->resample_state, &sd) != SRC_ERR_NO_ERROR)
+	while (count > 0)
 	{
-		// error processing the sample - not much we can do, so just discard
-		// the sample
-		return;
-	}
+		// resample at the MAME stream rate
+		sd.data_in = samples;
+		sd.input_frames = count;
+		sd.input_frames_used = 0;
+		sd.data_out = fOut;
+		sd.output_frames = _countof(fOut);
+		sd.output_frames_gen = 0;
+		sd.end_of_input = 0;
+		sd.src_ratio = output_rate_ratio;
 
-	// Add the resampled output(s) to the PCM sample buffer.  Note that the HC55516
-	// clock rates are in the 20kHz range (the exact rate varies by game and even
-	// clip), whereas the MAME stream will be at the PC sound card hardware rate,
-	// typically 44.1 kHz or 48 kHz.  Each HC55516 sample therefore turns into 
-	// approximately two MAME samples.  That's the main reason we need this extra
-	// buffering step - MAME might not be ready to accept all the PCM samples that
-	// convert from the current single HC55516 sample, so we need to be prepared
-	// to stash extras for the next MAME buffer refill.
-	for (i = 0; i < sd.output_frames_gen; ++i)
-	{
-		/* add the sample at the write pointer */
-		chip->pcm_out.pcm[chip->pcm_out.write++] = fOut[i];
-		if (chip->pcm_out.write >= _countof(chip->pcm_out.pcm))
-			chip->pcm_out.write = 0;
-
-		/* if the write pointer bumped into the read pointer, drop the oldest sample */
-		if (chip->pcm_out.write == chip->pcm_out.read) {
-			if (++chip->pcm_out.read >= _countof(chip->pcm_out.pcm))
-				chip->pcm_out.read = 0;
+		if (src_process(chip->resample_state, &sd) != SRC_ERR_NO_ERROR)
+		{
+			// error processing the samples - not much we can do, so just discard
+			// them
+			return;
 		}
+		samples += sd.input_frames_used;
+		count -= sd.input_frames_used;
+
+		// Add the resampled output(s) to the PCM sample buffer.  Note that the HC55516
+		// clock rates are in the 20kHz range (the exact rate varies by game and even
+		// clip), whereas the MAME stream will be at the PC sound card hardware rate,
+		// typically 44.1 kHz or 48 kHz.  Each HC55516 sample therefore turns into 
+		// approximately two MAME samples.  That's the main reason we need this extra
+		// buffering step - MAME might not be ready to accept all the PCM samples that
+		// convert from the current HC55516 samples, so we need to be prepared
+		// to stash extras for the next MAME buffer refill.
+		for (i = 0; i < sd.output_frames_gen; ++i)
+		{
+			/* add the sample at the write pointer */
+			chip->pcm_out.pcm[chip->pcm_out.write++] = fOut[i];
+			if (chip->pcm_out.write >= _countof(chip->pcm_out.pcm))
+				chip->pcm_out.write = 0;
+
+			/* if the write pointer bumped into the read pointer, drop the oldest sample */
+			if (chip->pcm_out.write == chip->pcm_out.read) {
+				if (++chip->pcm_out.read >= _countof(chip->pcm_out.pcm))
+					chip->pcm_out.read = 0;
+			}
+		}
+
+		// no progress at all (should not happen), bail out instead of spinning
+		if (sd.input_frames_used == 0 && sd.output_frames_gen == 0)
+			return;
 	}
 }
 
@@ -653,7 +664,7 @@ static void add_sample_out(struct hc55516_data *chip, const double sample, const
 // Process an input bit to the CVSD decoder.  This applies the CVSD decoding
 // algorithm to the bit to produce the next PCM sample.  The PCM sample is at
 // the CVSD clock rate, so it must be resampled to the MAME output stream rate
-// before being passed to MAME.
+// (see add_samples_out()) before being passed to MAME.
 //
 // This version uses a fixed-point fraction implementation, based on the 2020
 // decap analysis of the HC55516's internal circuit traces.   The calculations
@@ -747,7 +758,7 @@ INLINE int signext10bits(int v)
 }
 
 // bit processor
-static void process_bit_HC555XX(struct hc55516_data *chip, const UINT8 bit, const double output_rate_ratio)
+static double process_bit_HC555XX(struct hc55516_data *chip, const UINT8 bit)
 {
 	// shift the bit into the shift register
 	chip->shiftreg = ((chip->shiftreg << 1) | bit) & SHIFTMASK;
@@ -772,10 +783,7 @@ static void process_bit_HC555XX(struct hc55516_data *chip, const UINT8 bit, cons
 	chip->filter.intg.integrator = clip10bits(chip->filter.intg.integrator + sum);
 
 	// scale the sample from 10-bit signed (-512..511) to 16-bit signed (-32768..32767)
-	int sample = (chip->filter.intg.integrator << 6) | (((chip->filter.intg.integrator & 0x3FF) ^ 0x200) >> 4);
-
-	// buffer the sample
-	add_sample_out(chip, sample / 32768.0, output_rate_ratio);
+	const int sample = (chip->filter.intg.integrator << 6) | (((chip->filter.intg.integrator & 0x3FF) ^ 0x200) >> 4);
 
 	// Charge the integrator from the syllabic filter according to the 
 	// current data bit.
@@ -808,6 +816,9 @@ static void process_bit_HC555XX(struct hc55516_data *chip, const UINT8 bit, cons
 	if ((chip->shiftreg & 1) != 0)
 		sum = -sum;
 	chip->filter.intg.integrator = clip10bits(chip->filter.intg.integrator + sum);
+
+	// return the sample from before the charge update
+	return sample / 32768.0;
 }
 
 // We don't need any loudness compression for the integer math implementation,
@@ -846,7 +857,7 @@ static float flat_loudness(struct hc55516_data *chip, double sample)
 // be more detrimental to the sound quality than the precision and range
 // upgrades are positives.
 //
-static void process_bit_dbl(struct hc55516_data *chip, const UINT8 bit, const double output_rate_ratio)
+static double process_bit_dbl(struct hc55516_data *chip, const UINT8 bit)
 {
 	// add/subtract the syllabic filter output to/from the integrator
 	const double di = (1.0 - DECAY) * chip->filter.dbl.syl_level;
@@ -865,8 +876,7 @@ static void process_bit_dbl(struct hc55516_data *chip, const UINT8 bit, const do
 	chip->filter.dbl.syl_level *= CHARGE;
 	chip->filter.dbl.syl_level += (1.0 - CHARGE) * ((chip->shiftreg == 0 || chip->shiftreg == SHIFTMASK) ? V_HIGH : V_LOW);
 
-	// buffer the sample
-	add_sample_out(chip, chip->filter.dbl.integrator, output_rate_ratio);
+	return chip->filter.dbl.integrator;
 }
 
 // Loudness compression function.  This takes a sample in linear space form
@@ -1060,13 +1070,19 @@ static void hc55516_update(int num, INT16 *buffer_ptr, int length)
 		if (ratio < 0.5)
 			ratio = 1.0;
 
-		// generate these samples
-		for (i = chip->bits_in.read; n > 0; --n)
+		// generate these samples, decoding them in blocks and resampling each block at once
+		for (i = chip->bits_in.read; n > 0;)
 		{
-			// process this bit
-			(*chip->process_bit)(chip, chip->bits_in.bits[i++].bit, ratio);
-			if (i >= _countof(chip->bits_in.bits))
-				i = 0;
+			float decoded[256];
+			int count;
+			for (count = 0; count < _countof(decoded) && n > 0; --n)
+			{
+				// process this bit
+				decoded[count++] = (float)(*chip->process_bit)(chip, chip->bits_in.bits[i++].bit);
+				if (i >= _countof(chip->bits_in.bits))
+					i = 0;
+			}
+			add_samples_out(chip, decoded, count, ratio);
 		}
 
 		// update the read pointer
@@ -346,7 +346,38 @@ static INT16 read_sample(struct M114SChannel * const channel, const UINT32 lengt
 
 /**********************************************************************************************
 
-	 read_table -- Reads the two tables of rom data into a temporary buffer,
+	 table_sample -- returns entry i of a table as the chip reads it, i.e. with each ROM byte
+	 read 'rep' times (and optionally interpolated towards the next byte)
+
+***********************************************************************************************/
+INLINE int table_sample(const INT8 * const tab, const int len, const int rep, const int i)
+{
+#ifdef USE_LERP_FOR_REPEATED_SAMPLES
+	if (rep == 1)
+		return tab[i];
+	else
+	{
+		const int idx = (rep == 2) ? (i >> 1) : (i >> 2);
+		const int val1 = (int)tab[idx];
+		const int val2 = (int)tab[(idx < len-1) ? idx+1 : idx];
+		if (rep == 2)
+			return (i & 1) ? (val1 + val2)/2 : val1;
+		switch (i & 3)
+		{
+			case 0:  return val1;
+			case 1:  return (val1*3 + val2  )/4;
+			case 2:  return (val1   + val2  )/2;
+			default: return (val1   + val2*3)/4;
+		}
+	}
+#else
+	return tab[i / rep];
+#endif
+}
+
+/**********************************************************************************************
+
+	 read_table -- Reads the two tables of rom data straight from the ROM,
 	 mixes the samples using the chip's internal interpolation equation,
 	 applies the volume, and writes the single mixed sample to the output buffer for the channel.
 	 It processes the entire table1 length of data.
@@ -354,88 +385,31 @@ static INT16 read_sample(struct M114SChannel * const channel, const UINT32 lengt
 	 Note: Eventually this should flag an End of Table, and should process new table data
 
 ***********************************************************************************************/
-static void read_table(struct M114SChip * const chip, struct M114SChannel * const channel) // get rid of this and write directly to output buffer?!
+static void read_table(struct M114SChip * const chip, struct M114SChannel * const channel)
 {
 	int i;
-#ifndef USE_LERP_FOR_REPEATED_SAMPLES
-	int j;
-#endif
-	const INT8 * const rom = &chip->region_base[0];
-	const int t1start = channel->table1.start_address;
-	const int t2start = channel->table2.start_address;
+	const INT8 * const tab1 = &chip->region_base[channel->table1.start_address];
+	const INT8 * const tab2 = &chip->region_base[channel->table2.start_address + 0x2000]; //A13 is toggled high on Table 2 reading (Implementation specific - ie, Mr. Game)
 	const int lent1 = channel->table1.length;
 	const int lent2 = channel->table2.length;
 	const int rep1 = channel->table1.reread;
 	const int rep2 = channel->table2.reread;
+	const int total1 = lent1*rep1;
+	const int total2 = lent2*rep2;
 	const int intp = channel->regs.interp;
 
-	INT8 tb1[4096];	// Temp copy buffer for Table 1 // long enough to hold max sizes of 2048*2 or 1024*4
-	INT8 tb2[4096];	// Temp copy buffer for Table 2 // dto.
-	memset(&tb1,0,sizeof(tb1));
-	memset(&tb2,0,sizeof(tb2));
-
 	//LOG(("t1s = %d t2s = %d, l1=%d l2=%d, r1=%d, r2=%d, int = %d\n",t1start,t2start,lent1,lent2,rep1,rep2,intp));
 
-	// datasheet says: multiple reading permits interpolation between two adjoining samples on the same table, so do we really need to lerp instead of just repeating same values here?
-#ifdef USE_LERP_FOR_REPEATED_SAMPLES
-	//Scan Table 1
-	if(rep1 == 1)
-		memcpy(tb1,&rom[t1start],lent1);
-	else if(rep1 == 2)
-		for(i=0; i<lent1; i++)
-		{
-			tb1[i*2+0] =       rom[i+t1start];
-			tb1[i*2+1] = ((int)rom[i+t1start] + (int)rom[t1start + ((i < lent1-1) ? i+1 : i)])/2;
-		}
-	else //if(rep1 == 4)
-		for(i=0; i<lent1; i++)
-		{
-			int val1 = (int)rom[i+t1start];
-			int val2 = (int)rom[t1start + ((i < lent1-1) ? i+1 : i)];
-			tb1[i*4+0] =    rom[i+t1start];
-			tb1[i*4+1] = (val1*3 + val2  )/4;
-			tb1[i*4+2] = (val1   + val2  )/2;
-			tb1[i*4+3] = (val1   + val2*3)/4;
-		}
-		
-	//Scan Table 2
-	if (rep2 == 1)
-		memcpy(tb2,&rom[t2start+0x2000],lent2); //A13 is toggled high on Table 2 reading (Implementation specific - ie, Mr. Game)
-	else if(rep2 == 2)
-		for(i=0; i<lent2; i++)
-		{
-			tb2[i*2+0] =       rom[i+t2start+0x2000];
-			tb2[i*2+1] = ((int)rom[i+t2start+0x2000] + (int)rom[t2start+0x2000 + ((i < lent2-1) ? i+1 : i)])/2;
-		}
-	else //if(rep2 == 4)
-		for(i=0; i<lent2; i++)
-		{
-			int val1 = (int)rom[i+t2start+0x2000];
-			int val2 = (int)rom[t2start+0x2000 + ((i < lent2-1) ? i+1 : i)];
-			tb2[i*4+0] =    rom[i+t2start+0x2000];
-			tb2[i*4+1] = (val1*3 + val2  )/4;
-			tb2[i*4+2] = (val1   + val2  )/2;
-			tb2[i*4+3] = (val1   + val2*3)/4;
-		}
-#else
-	//Scan Table 1
-	for(i=0; i<lent1; i++)
-		for(j=0; j<rep1; j++)
-			tb1[j+(i*rep1)] = rom[i+t1start];
-	//Scan Table 2
-	for(i=0; i<lent2; i++)
-		for(j=0; j<rep2; j++)
-			tb2[j+(i*rep2)] = rom[i+t2start+0x2000];		//A13 is toggled high on Table 2 reading (Implementation specific - ie, Mr. Game)
-#endif
+	// datasheet says: multiple reading permits interpolation between two adjoining samples on the same table, so do we really need to lerp instead of just repeating same values here? (see table_sample())
 
 	// Table1 is always larger, so use that as the size
 
-	// How to make up difference (table 2 can be shorter than table 1)? -> was memset above already, so zero for now
-	/*for(i=lent2*rep2; i<lent1*rep1; i++)
-		tb2[i] = ?;*/
+	// How to make up difference (table 2 can be shorter than table 1)? -> zero for now
 
 	// Now Mix based on Interpolation Bits
-	for(i=0; i<lent1*rep1; i++)	{
+	for(i=0; i<total1; i++)	{
+		const int t1 = table_sample(tab1, lent1, rep1, i);
+		const int t2 = (i < total2) ? table_sample(tab2, lent2, rep2, i) : 0;
 		int l;
 		//Apply volume - If envelope - inc/dec volume to calculate sample volume (only 8 most significant bits from the 10 bits, thus +/-4), otherwise, apply directly
 #ifdef USE_VOL_ENVELOPE
@@ -452,10 +426,10 @@ static void read_table(struct M114SChip * const chip, struct M114SChannel * cons
 #endif
 		//write to output buffer
 #ifdef DO_FULL_PRECISION_MIXING
-		l = (int)tb1[i] * (intp + 1) + (int)tb2[i] * (15 - intp);
+		l = t1 * (intp + 1) + t2 * (15 - intp);
 		channel->output[i] = (INT16)(0x6f * l * (channel->current_volume + 1) / (1024*16)); // Max Volume would be 256 for an INT16 value (so why was 0x6f chosen??)
 #else
-		l = ((int)tb1[i] * (intp + 1) / 16) + ((int)tb2[i] * (15 - intp) / 16); // formula seen in datasheet, but unclear what this means precision wise (i.e. is this only meant as real number pseudo code?)
+		l = (t1 * (intp + 1) / 16) + (t2 * (15 - intp) / 16); // formula seen in datasheet, but unclear what this means precision wise (i.e. is this only meant as real number pseudo code?)
 		channel->output[i] = (INT16)(0x6f * l * (channel->current_volume + 1) / 1024); // Max Volume would be 256 for an INT16 value (so why was 0x6f chosen??) //!! do 0x6f scale AFTER division??
 #endif
 	}
@@ -465,7 +439,12 @@ static void read_table(struct M114SChip * const chip, struct M114SChannel * cons
 
      m114s_update -- update the sound chip so that it is in sync with CPU execution
 
+     Works channel by channel over blocks of samples, so inactive channels cost nothing and
+     the per channel loops stay tight.
+
 ***********************************************************************************************/
+#define M114S_BLOCK 256
+
 //Seems this sometimes still produces some static, but I don't know why!
 static void m114s_update(int num,
 #if M114S_OUTPUT_CHANNELS == 1
@@ -476,57 +455,58 @@ static void m114s_update(int num,
 	int samples)
 {
 	struct M114SChip * const chip = &m114schip[num];
+	INT32 accum[M114S_OUTPUT_CHANNELS][M114S_BLOCK];
 
 	while (samples > 0)
 	{
-#if M114S_OUTPUT_CHANNELS == 1
-		INT32 accum = 0;
-#else
-		INT32 accum[M114S_OUTPUT_CHANNELS];
-#endif
-		int c;
+		const int length = (samples < M114S_BLOCK) ? samples : M114S_BLOCK;
+		int c, i;
 
-#if M114S_OUTPUT_CHANNELS != 1
 		/* clear accum */
-		for(c = 0; c < M114S_OUTPUT_CHANNELS; c++)
-			accum[c] = 0;
-#endif
+		memset(accum, 0, sizeof(accum));
 
 		/* loop over channels */
 		for (c = 0; c < M114S_CHANNELS; c++)
 		{
 			struct M114SChannel * const channel = &chip->channels[c];
-			/* Grab the next sample from the table data if the channel is active */
+			/* Grab the next samples from the table data if the channel is active */
 			if (channel->active)
 			{
 				//We use Table 1 to drive everything, as Table 2 is really for mixing into Table 1..
-				INT32 sample = read_sample(channel, channel->table1.total_length); //!! INT16 if MR_GAME_VOLUME_HACK would be off
-
-#ifdef MR_GAME_VOLUME_HACK
-				sample = sample*chip->channel_volume[channel->regs.outputs] / 100; // boost percussion on Dakar, penalty some of the other instruments
-#endif
+				const UINT32 total_length = channel->table1.total_length;
 				//Mix the output of this channel to the appropriate output channel
 #if M114S_OUTPUT_CHANNELS == 1
-				accum
+				INT32 * const dst = accum[0];
 #elif M114S_OUTPUT_CHANNELS == 4
-				accum[channel->regs.outputs]
+				INT32 * const dst = accum[channel->regs.outputs];
 #else
-				accum[c]
+				INT32 * const dst = accum[c];
+#endif
+#ifdef MR_GAME_VOLUME_HACK
+				const INT32 volume = chip->channel_volume[channel->regs.outputs]; // boost percussion on Dakar, penalty some of the other instruments
+				for (i = 0; i < length; i++)
+					dst[i] += (INT32)read_sample(channel, total_length) * volume / 100;
+#else
+				for (i = 0; i < length; i++)
+					dst[i] += read_sample(channel, total_length);
 #endif
-				+= sample;
 			}
 		}
 
 		/* Update the buffer & Ensure we don't clip */
 #if M114S_OUTPUT_CHANNELS == 1
-		accum /= (INT32)4;
-		*buffer++ = (accum < -32768) ? -32768 : ((accum > 32767) ? 32767 : accum);
+		for (i = 0; i < length; i++)
+		{
+			const INT32 a = accum[0][i] / (INT32)4;
+			*buffer++ = (a < -32768) ? -32768 : ((a > 32767) ? 32767 : a);
+		}
 #else
 		for (c = 0; c < M114S_OUTPUT_CHANNELS; c++)
-			*buffer[c]++ = (accum[c] < -32768) ? -32768 : ((accum[c] > 32767) ? 32767 : accum[c]);
+			for (i = 0; i < length; i++)
+				*buffer[c]++ = (accum[c][i] < -32768) ? -32768 : ((accum[c][i] > 32767) ? 32767 : accum[c][i]);
 #endif
 
-		samples--;
+		samples -= length;
 	}
 }
 
@@ -55,6 +55,9 @@
  #define MIN(x,y) ((x)<(y)?(x):(y))
 #endif
 
+/* Number of seconds of zero source samples after which a playing channel goes back to the silent path */
+#define MIXER_SILENCE_TIME		0.5
+
 /***************************************************************************/
 /* Static data */
 
@@ -87,8 +90,12 @@ struct mixer_channel_data
 	int lr_silent_value[2];// detect complete silence of a channel
 	float lr_silent_value_f[2]; // detect complete silence of a float channel
 	bool lr_silence[2];
+	bool lr_resume[2];     // silence was re-entered after playing, so the filter state must be reset when waking up
+	unsigned lr_zero_run[2]; // number of trailing zero source samples while playing
+	unsigned skipped_samples; // output samples skipped because of silence
 
 	bool legacy_resample;  // fallback to old legacy samples playback
+	bool ignore_global_enable; // keep playing while mixer_sound_enable_global_w(0) mutes everything else
 
 	bool is_reset_requested; // resample state reset requested
 
@@ -133,26 +140,58 @@ static float out_f[ACCUMULATOR_SAMPLES];
 /* 16-bit mix buffers */
 static INT16 mix_buffer[ACCUMULATOR_SAMPLES*2]; /* *2 for stereo */
 
+#ifdef LIBPINMAME
+/* float output, set by the OSD layer from osd_start_audio_stream() to skip the dithered 16-bit conversion */
+static UINT8 float_output;
+static float mix_buffer_f[ACCUMULATOR_SAMPLES*2]; /* *2 for stereo */
+/* 1 to mix stereo games down to mono for a mono host, 0 to follow the game; kept across games */
+static int output_channels;
+#endif
+
 /* global sample tracking */
 static unsigned samples_this_frame;
 
-static void mixer_apply_reverb_filter(struct mixer_channel_data* const channel, float * const __restrict buf, const int len, const unsigned left_right)
+/* Post-processing of a resampled channel block: all enabled stages (reverb, then volume) are applied
+   while accumulating into the mix, so the block is walked only once. The work is split into runs where
+   none of the ring buffers wraps, which keeps the inner loops branch-free so the compiler can vectorise them */
+static unsigned mixer_channel_post(struct mixer_channel_data* const channel, const float* __restrict src, int len, const float volume, float* const __restrict dst, unsigned dst_pos, const unsigned left_right)
 {
-	if (channel->reverbDelay[left_right] != 0.f && len) {
+	if (channel->reverbDelay[left_right] != 0.f) {
 		float * const __restrict rev_buf = channel->reverbBuffer[left_right];
-		int i;
 		const float rev_force = channel->reverbForce[left_right] * (left_right ? 1.f : 1.04f); // magic: slightly different parameters for left and right makes reverb sound a bit more natural
 		int rev_pos = channel->reverbPos[left_right];
 		int newPos = rev_pos - (int)(channel->reverbDelay[left_right] * channel->to_frequency * (left_right ? 1.04f : 1.f)); // magic: slightly different parameters for left and right makes reverb sound a bit more natural
 		if (newPos < 0) newPos += REVERB_LENGTH;
-		for (i = 0; i < len; i++) {
-			buf[i] = buf[i] + (rev_buf[newPos] - buf[i]) * rev_force;
-			rev_buf[rev_pos] = buf[i];
-			rev_pos++; if (rev_pos > REVERB_LENGTH) rev_pos = 0;
-			newPos++; if (newPos > REVERB_LENGTH) newPos = 0;
+		while (len > 0) {
+			int i, n = len;
+			if (n > (int)(ACCUMULATOR_SAMPLES - dst_pos)) n = ACCUMULATOR_SAMPLES - dst_pos;
+			if (n > REVERB_LENGTH - rev_pos) n = REVERB_LENGTH - rev_pos;
+			if (n > REVERB_LENGTH - newPos) n = REVERB_LENGTH - newPos;
+			for (i = 0; i < n; i++) {
+				const float x = src[i] + (rev_buf[newPos + i] - src[i]) * rev_force;
+				rev_buf[rev_pos + i] = x;
+				dst[dst_pos + i] += x * volume;
+			}
+			src += n;
+			len -= n;
+			rev_pos += n; if (rev_pos >= REVERB_LENGTH) rev_pos = 0;
+			newPos += n; if (newPos >= REVERB_LENGTH) newPos = 0;
+			dst_pos = (dst_pos + n) & ACCUMULATOR_MASK;
 		}
 		channel->reverbPos[left_right] = rev_pos;
 	}
+	else {
+		while (len > 0) {
+			int i, n = len;
+			if (n > (int)(ACCUMULATOR_SAMPLES - dst_pos)) n = ACCUMULATOR_SAMPLES - dst_pos;
+			for (i = 0; i < n; i++)
+				dst[dst_pos + i] += src[i] * volume;
+			src += n;
+			len -= n;
+			dst_pos = (dst_pos + n) & ACCUMULATOR_MASK;
+		}
+	}
+	return dst_pos;
 }
 
 //
@@ -196,6 +235,79 @@ INLINE float xorshift(uint4 *const __restrict state)
 	return int_as_float(0x3F800000 | (xorshiftu(state)>>9))-1.0f; //!! could use &8388607 instead of >>9
 }
 
+#if defined(RESAMPLER_SSE_OPT) && defined(MIXER_USE_CLIPPING)
+// same generator, 4 independent lanes at once, for the vectorised accumulator flush below
+typedef struct { __m128i x, y, z, w; } uint4x4;
+
+// 2 states, as we need 2(TPDF) per sample, seeded from the scalar states in mixer_sh_start()
+static uint4x4 xorshift4_state[2];
+
+INLINE __m128 xorshift4(uint4x4 *const __restrict state)
+{
+	const __m128i t = _mm_xor_si128(state->x, _mm_slli_epi32(state->x, 11));
+	state->x = state->y;
+	state->y = state->z;
+	state->z = state->w;
+	state->w = _mm_xor_si128(_mm_xor_si128(state->w, _mm_srli_epi32(state->w, 19)), _mm_xor_si128(t, _mm_srli_epi32(t, 8)));
+	return _mm_sub_ps(_mm_castsi128_ps(_mm_or_si128(_mm_set1_epi32(0x3F800000), _mm_srli_epi32(state->w, 9))), _mm_set1_ps(1.0f));
+}
+
+static void xorshift4_init(void)
+{
+	int i;
+	for (i = 0; i < 2; i++)
+	{
+		unsigned int v[4][4];
+		int j, k;
+		for (j = 0; j < 4; j++)
+			for (k = 0; k < 4; k++)
+				v[j][k] = xorshiftu(&xorshift_state[k]);
+		xorshift4_state[i].x = _mm_setr_epi32((int)v[0][0], (int)v[0][1], (int)v[0][2], (int)v[0][3]);
+		xorshift4_state[i].y = _mm_setr_epi32((int)v[1][0], (int)v[1][1], (int)v[1][2], (int)v[1][3]);
+		xorshift4_state[i].z = _mm_setr_epi32((int)v[2][0], (int)v[2][1], (int)v[2][2], (int)v[2][3]);
+		xorshift4_state[i].w = _mm_setr_epi32((int)v[3][0], (int)v[3][1], (int)v[3][2], (int)v[3][3]);
+	}
+}
+
+// scale, add TPDF dither and clip 4 accumulator samples, returning them as 32-bit ints
+INLINE __m128i mixer_dither_clip4(const float *const __restrict accum)
+{
+	const __m128 dither = _mm_sub_ps(xorshift4(&xorshift4_state[0]), xorshift4(&xorshift4_state[1]));
+	const __m128 sample = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(accum), _mm_set1_ps(32768.f)), dither);
+	return _mm_cvtps_epi32(_mm_max_ps(_mm_min_ps(sample, _mm_set1_ps(32767.f)), _mm_set1_ps(-32768.f)));
+}
+
+// flush len (multiple of 8) contiguous mono accumulator samples to mix, zeroing them behind us
+static INT16* mixer_flush_mono_sse(float *const __restrict left, INT16* __restrict mix, const unsigned int len)
+{
+	unsigned int i;
+	for (i = 0; i < len; i += 8, mix += 8)
+	{
+		const __m128i s0 = mixer_dither_clip4(left + i);
+		const __m128i s1 = mixer_dither_clip4(left + i + 4);
+		_mm_storeu_si128((__m128i*)mix, _mm_packs_epi32(s0, s1));
+		_mm_storeu_ps(left + i, _mm_setzero_ps());
+		_mm_storeu_ps(left + i + 4, _mm_setzero_ps());
+	}
+	return mix;
+}
+
+// flush len (multiple of 4) contiguous stereo accumulator samples to mix, interleaved, zeroing them behind us
+static INT16* mixer_flush_stereo_sse(float *const __restrict left, float *const __restrict right, INT16* __restrict mix, const unsigned int len)
+{
+	unsigned int i;
+	for (i = 0; i < len; i += 4, mix += 8)
+	{
+		const __m128i l = mixer_dither_clip4(left + i);
+		const __m128i r = mixer_dither_clip4(right + i);
+		_mm_storeu_si128((__m128i*)mix, _mm_packs_epi32(_mm_unpacklo_epi32(l, r), _mm_unpackhi_epi32(l, r)));
+		_mm_storeu_ps(left + i, _mm_setzero_ps());
+		_mm_storeu_ps(right + i, _mm_setzero_ps());
+	}
+	return mix;
+}
+#endif
+
 #if 0
 INLINE float triangular(const float r) // from -1..1, c=0 (with random no r=0..1)
 {
@@ -332,6 +444,47 @@ static unsigned mixer_channel_resample_16(struct mixer_channel_data* const chann
 				break;
 			}
 		}
+
+		// woke up after a silence that followed some playback: drop what is left of the old filter history
+		if (!channel->lr_silence[left_right] && channel->lr_resume[left_right])
+		{
+			channel->lr_resume[left_right] = 0;
+			src_reset(src_state);
+		}
+	}
+
+	// Complete silence at 0: nothing to accumulate, just advance the source and destination positions like the loop below would
+	if (!channel->legacy_resample && (scale_copy == 0.f || (channel->lr_silence[left_right] && (channel->is_float ? channel->lr_silent_value_f[left_right] == 0.f : channel->lr_silent_value[left_right] == 0))))
+	{
+		const int step = ((unsigned long long)(channel->from_frequency+0.5) << FRACTION_BITS) / (unsigned long long)(channel->to_frequency+0.5);
+		const unsigned long long src_end = (unsigned long long)src_len << FRACTION_BITS;
+		unsigned long long pos = (unsigned int)channel->frac;
+		unsigned n = 0;
+
+		if (pos < src_end && step > 0)
+		{
+			n = (unsigned)((src_end - pos + step - 1) / step);
+			if (n > dst_len)
+				n = dst_len;
+			pos += (unsigned long long)n * step;
+		}
+
+		/* adjust the end if it's too big */
+		if (pos > src_end)
+		{
+			channel->frac = (int)((pos - src_end) & FRACTION_MASK) + (int)(((pos >> FRACTION_BITS) - src_len) << FRACTION_BITS);
+			pos = src_end;
+		}
+		else
+			channel->frac = (int)(pos & FRACTION_MASK);
+
+		if (channel->is_float)
+			*psrc = (INT16*)(srcf + (pos >> FRACTION_BITS));
+		else
+			*psrc = src + (pos >> FRACTION_BITS);
+
+		channel->skipped_samples += n;
+		return n;
 	}
 
 	// Special/Legacy samples playback code-path:
@@ -396,6 +549,25 @@ static unsigned mixer_channel_resample_16(struct mixer_channel_data* const chann
 
 	// Normal libsamplerate code-path:
 
+	// Track the trailing zeros of a playing channel, to go back to the silent path after a while (not with reverb, as the tail would be cut)
+	if (!channel->legacy_resample && channel->reverbDelay[left_right] == 0.f)
+	{
+		if (channel->is_float)
+			for (i = src_len; i > 0 && srcf[i - 1] == 0.f; --i) ;
+		else
+			for (i = src_len; i > 0 && src[i - 1] == 0; --i) ;
+		channel->lr_zero_run[left_right] = (i == 0) ? channel->lr_zero_run[left_right] + src_len : src_len - (unsigned)i;
+
+		if (channel->lr_zero_run[left_right] >= (unsigned)(channel->from_frequency * MIXER_SILENCE_TIME))
+		{
+			channel->lr_zero_run[left_right] = 0;
+			channel->lr_silence[left_right] = 1;
+			channel->lr_resume[left_right] = 1;
+			channel->lr_silent_value[left_right] = 0;
+			channel->lr_silent_value_f[left_right] = 0.f;
+		}
+	}
+
 	if (!channel->is_float)
 		src_short_to_float_array(src, in_f, src_len);
 
@@ -417,13 +589,7 @@ static unsigned mixer_channel_resample_16(struct mixer_channel_data* const chann
 		return (dst_pos - dst_base) & ACCUMULATOR_MASK;
 	}
 
-	mixer_apply_reverb_filter(channel, out_f, data.output_frames_gen, left_right);
-
-	for (i = 0; i < data.output_frames_gen; ++i)
-	{
-		dst[dst_pos] += out_f[i] * volume;
-		dst_pos = (dst_pos + 1) & ACCUMULATOR_MASK;
-	}
+	dst_pos = mixer_channel_post(channel, out_f, data.output_frames_gen, volume, dst, dst_pos, left_right);
 
 	*psrc = channel->is_float ? (INT16*)(srcf+data.input_frames_used) : (src+data.input_frames_used);
 	return (dst_pos - dst_base) & ACCUMULATOR_MASK;
@@ -524,13 +690,7 @@ static unsigned mixer_channel_resample_8(struct mixer_channel_data * const chann
 		return (dst_pos - dst_base) & ACCUMULATOR_MASK;
 	}
 
-	mixer_apply_reverb_filter(channel, out_f, data.output_frames_gen, left_right);
-
-	for (i = 0; i < data.output_frames_gen; ++i)
-	{
-		dst[dst_pos] += out_f[i] * volume;
-		dst_pos = (dst_pos + 1) & ACCUMULATOR_MASK;
-	}
+	dst_pos = mixer_channel_post(channel, out_f, data.output_frames_gen, volume, dst, dst_pos, left_right);
 
 	*psrc = src + data.input_frames_used;
 	return (dst_pos - dst_base) & ACCUMULATOR_MASK;
@@ -718,6 +878,22 @@ static void mixer_flush(struct mixer_channel_data * const channel)
 	channel->samples_available = save_available;
 }
 
+/***************************************************************************
+	mixer_src_converter
+***************************************************************************/
+
+static int mixer_src_converter(const int quality)
+{
+	switch (quality)
+	{
+		case MIXER_RESAMPLE_NORMAL: return SRC_SINC_MEDIUM_QUALITY; //!! if changing quality, change src_sinc_opt again to include the other table (search for //!! there)
+		case MIXER_RESAMPLE_LINEAR: return SRC_LINEAR;
+		case MIXER_RESAMPLE_ZOH:    return SRC_ZERO_ORDER_HOLD;
+		default:                    return SRC_SINC_FASTEST;
+	}
+}
+
+
 /***************************************************************************
 	mixer_sh_start
 ***************************************************************************/
@@ -739,8 +915,8 @@ int mixer_sh_start()
 		channel->config_mixing_level 			= config_mixing_level[i];
 		channel->config_default_mixing_level 	= config_default_mixing_level[i];
 
-		channel->src_left  = src_new((pmoptions.resampling_quality == 0) ? SRC_SINC_FASTEST : SRC_SINC_MEDIUM_QUALITY, 1, &error); //!! if changing quality, change src_sinc_opt again to include the other table (search for //!! there)
-		channel->src_right = src_new((pmoptions.resampling_quality == 0) ? SRC_SINC_FASTEST : SRC_SINC_MEDIUM_QUALITY, 1, &error);
+		channel->src_left  = src_new(mixer_src_converter(pmoptions.resampling_quality), 1, &error);
+		channel->src_right = src_new(mixer_src_converter(pmoptions.resampling_quality), 1, &error);
 
 		channel->lr_silent_value[0] = INT_MAX;
 		channel->lr_silent_value_f[0] = FLT_MAX;
@@ -753,6 +929,15 @@ int mixer_sh_start()
 	/* determine if we're playing in stereo or not */
 	first_free_channel = 0;
 	is_stereo = ((Machine->drv->sound_attributes & SOUND_SUPPORTS_STEREO) != 0);
+#ifdef LIBPINMAME
+	float_output = 0;
+	/* mixing to mono right away also saves resampling the right channel */
+	if (output_channels == 1)
+		is_stereo = 0;
+#endif
+#if defined(RESAMPLER_SSE_OPT) && defined(MIXER_USE_CLIPPING)
+	xorshift4_init();
+#endif
 
 	/* clear the accumulators */
 	accum_base = 0;
@@ -784,6 +969,8 @@ void mixer_sh_stop()
 
 	for (i = 0, channel = mixer_channel; i < MIXER_MAX_CHANNELS; i++, channel++)
 	{
+		if (channel->skipped_samples)
+			mixerlogerror(("Mixer:%s: %u silent samples skipped\n", channel->name, channel->skipped_samples));
 		src_delete(channel->src_left);
 		src_delete(channel->src_right);
 	}
@@ -829,6 +1016,7 @@ void mixer_sh_update()
 	int i;
 
 	profiler_mark(PROFILER_MIXER);
+	profiler_count(PROFILER_MIXER, samples_this_frame);
 
 	/* update all channels (for streams this is a no-op) */
 	for (i = 0, channel = mixer_channel; i < first_free_channel; i++, channel++)
@@ -842,12 +1030,60 @@ void mixer_sh_update()
 			channel->samples_available -= samples_this_frame;
 	}
 
+#ifdef LIBPINMAME
+	/* interleave the float data as is, only clipping along the way (no dither, no 16-bit round trip) */
+	if (float_output)
+	{
+		float* __restrict mix = mix_buffer_f;
+		for (i = 0; (unsigned int)i < samples_this_frame; i++)
+		{
+			float sample = left_accum[accum_pos];
+#ifdef MIXER_USE_CLIPPING
+			sample = sample < -1.f ? -1.f : sample > 32767.f/32768.f ? 32767.f/32768.f : sample;
+#endif
+			*mix++ = sample;
+			left_accum[accum_pos] = 0;
+
+			if (is_stereo)
+			{
+				sample = right_accum[accum_pos];
+#ifdef MIXER_USE_CLIPPING
+				sample = sample < -1.f ? -1.f : sample > 32767.f/32768.f ? 32767.f/32768.f : sample;
+#endif
+				*mix++ = sample;
+				right_accum[accum_pos] = 0;
+			}
+
+			accum_pos = (accum_pos + 1) & ACCUMULATOR_MASK;
+		}
+
+		/* play the result (the wave recorder only handles 16-bit data, so it is not fed in this mode) */
+		samples_this_frame = osd_update_audio_stream_float(mix_buffer_f);
+
+		accum_base = accum_pos;
+
+		profiler_mark(PROFILER_END);
+		return;
+	}
+#endif
+
 	/* copy the mono 32-bit data to a 16-bit buffer, clipping along the way */
 	if (!is_stereo)
 	{
 		INT16* __restrict mix = mix_buffer;
 		for (i = 0; (unsigned int)i < samples_this_frame; i++)
 		{
+#if defined(RESAMPLER_SSE_OPT) && defined(MIXER_USE_CLIPPING)
+			/* do as much as possible in contiguous runs of 8, until the ring wraps */
+			const unsigned int run = MIN(samples_this_frame - (unsigned int)i, ACCUMULATOR_SAMPLES - accum_pos) & ~7u;
+			if (run)
+			{
+				mix = mixer_flush_mono_sse(left_accum + accum_pos, mix, run);
+				accum_pos = (accum_pos + run) & ACCUMULATOR_MASK;
+				i += run - 1;
+				continue;
+			}
+#endif
 			const float dither = xorshift(&xorshift_state[0]) - xorshift(&xorshift_state[1]); // add TPDF dither
 
 			/* fetch and clip the sample */
@@ -880,6 +1116,17 @@ void mixer_sh_update()
 		INT16* __restrict mix = mix_buffer;
 		for (i = 0; (unsigned int)i < samples_this_frame; i++)
 		{
+#if defined(RESAMPLER_SSE_OPT) && defined(MIXER_USE_CLIPPING)
+			/* do as much as possible in contiguous runs of 4, until the ring wraps */
+			const unsigned int run = MIN(samples_this_frame - (unsigned int)i, ACCUMULATOR_SAMPLES - accum_pos) & ~3u;
+			if (run)
+			{
+				mix = mixer_flush_stereo_sse(left_accum + accum_pos, right_accum + accum_pos, mix, run);
+				accum_pos = (accum_pos + run) & ACCUMULATOR_MASK;
+				i += run - 1;
+				continue;
+			}
+#endif
 			float dither = xorshift(&xorshift_state[0]) - xorshift(&xorshift_state[1]); // add TPDF dither
 
 			/* fetch and clip the left sample */
@@ -1216,7 +1463,7 @@ void mixer_play_streamed_sample_16(const int ch, const INT16 *data, int len, con
 	profiler_mark(PROFILER_MIXER);
 
 	/* compute the overall mixing volume */
-	if (mixer_sound_enabled) {
+	if (mixer_sound_enabled || channel->ignore_global_enable) {
 		mixing_volume[0] = (float)(((channel->left_volume  * channel->mixing_level) << channel->gain) / (double)(100*100));
 		mixing_volume[1] = (float)(((channel->right_volume * channel->mixing_level) << channel->gain) / (double)(100*100));
 	} else {
@@ -1242,6 +1489,27 @@ int mixer_samples_this_frame()
 }
 
 
+#ifdef LIBPINMAME
+/***************************************************************************
+	mixer_set_float_output
+***************************************************************************/
+
+void mixer_set_float_output(const UINT8 enable)
+{
+	float_output = enable;
+}
+
+/***************************************************************************
+	mixer_set_output_channels
+***************************************************************************/
+
+void mixer_set_output_channels(const int channels)
+{
+	output_channels = channels;
+}
+#endif
+
+
 /***************************************************************************
 	mixer_need_samples_this_frame
 ***************************************************************************/
@@ -1402,3 +1670,30 @@ void mixer_set_channel_legacy_resample(const int ch, const UINT8 enable)
 
 	channel->legacy_resample = enable;
 }
+
+void mixer_set_channel_ignore_global_enable(const int ch, const UINT8 enable)
+{
+	struct mixer_channel_data * const channel = &mixer_channel[ch];
+
+	channel->ignore_global_enable = enable;
+}
+
+void mixer_set_channel_resample_quality(const int ch, const int quality)
+{
+	struct mixer_channel_data * const channel = &mixer_channel[ch];
+	const int converter = mixer_src_converter((quality == MIXER_RESAMPLE_DEFAULT) ? pmoptions.resampling_quality : quality);
+	int error;
+
+	src_delete(channel->src_left);
+	src_delete(channel->src_right);
+	channel->src_left  = src_new(converter, 1, &error);
+	channel->src_right = src_new(converter, 1, &error);
+}
+
+void mixer_set_resample_quality(const int quality)
+{
+	int ch;
+
+	for (ch = 0; ch < first_free_channel; ch++)
+		mixer_set_channel_resample_quality(ch, quality);
+}
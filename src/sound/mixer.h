@@ -102,6 +102,10 @@ void mixer_sound_enable_global_w(const UINT8 enable);
 
 void mixer_play_streamed_sample_16(const int channel, const INT16 *data, int len, const double freq);
 int mixer_samples_this_frame(void);
+#ifdef LIBPINMAME
+void mixer_set_float_output(const UINT8 enable);
+void mixer_set_output_channels(const int channels);
+#endif
 int mixer_need_samples_this_frame(const int channel, const double freq);
 
 /* private functions for user interface only - don't call them from drivers! */
@@ -128,4 +132,17 @@ void mixer_set_reverb_filter(const int ch, const float delay, const float force)
 
 void mixer_set_channel_legacy_resample(const int ch, const UINT8 enable);
 
+/* let a stream channel keep playing while mixer_sound_enable_global_w(0) mutes the emulated sound (e.g. altsound) */
+void mixer_set_channel_ignore_global_enable(const int ch, const UINT8 enable);
+
+/* resampling quality, for pmoptions.resampling_quality and per channel overrides */
+#define MIXER_RESAMPLE_DEFAULT  -1  /* per channel only: use pmoptions.resampling_quality */
+#define MIXER_RESAMPLE_FAST      0  /* sinc, fastest */
+#define MIXER_RESAMPLE_NORMAL    1  /* sinc, medium quality */
+#define MIXER_RESAMPLE_LINEAR    2  /* linear interpolation, for low power systems */
+#define MIXER_RESAMPLE_ZOH       3  /* zero order hold, cheapest */
+
+void mixer_set_channel_resample_quality(const int ch, const int quality);
+void mixer_set_resample_quality(const int quality); /* all allocated channels */
+
 #endif
@@ -112,6 +112,17 @@ static void ComputeTables (void)
  *
  */
 
+/* The VCLK callback feeds the driver a nibble at 4-32kHz.  Instead of a
+   partial stream update per nibble, the decoded levels are queued with
+   their time stamp and rendered in one go when the stream is updated */
+#define MSM5205_EVENT_COUNT 1024	/* power of 2; a full ring falls back to a stream update */
+
+struct msm5205_event
+{
+	double time;
+	int signal;
+};
+
 struct MSM5205Voice
 {
 	int stream;             /* number of stream system      */
@@ -123,26 +134,62 @@ struct MSM5205Voice
 	int bitwidth;           /* bit width selector -3B/4B    */
 	int signal;             /* current ADPCM signal         */
 	int step;               /* current ADPCM step           */
+	int output;             /* level being rendered         */
+	struct msm5205_event events[MSM5205_EVENT_COUNT];
+	unsigned int event_head, event_tail;
 };
 
 static const struct MSM5205interface *msm5205_intf;
 static struct MSM5205Voice msm5205[MAX_MSM5205];
 
+/* queue a new output level at the current time */
+static void MSM5205_queue(int chip,int signal)
+{
+	struct MSM5205Voice *voice = &msm5205[chip];
+
+	/* ring full: render what we have so far, which empties it */
+	if (voice->event_head - voice->event_tail == MSM5205_EVENT_COUNT)
+	{
+		stream_update(voice->stream,0);
+		/* nothing was rendered since the last update, so the oldest level is already due */
+		if (voice->event_head - voice->event_tail == MSM5205_EVENT_COUNT)
+			voice->output = voice->events[voice->event_tail++ & (MSM5205_EVENT_COUNT-1)].signal;
+	}
+
+	voice->events[voice->event_head & (MSM5205_EVENT_COUNT-1)].time = timer_get_time();
+	voice->events[voice->event_head & (MSM5205_EVENT_COUNT-1)].signal = signal;
+	voice->event_head++;
+}
+
 /* stream update callbacks */
 static void MSM5205_update(int chip,INT16 *buffer,int length)
 {
 	struct MSM5205Voice *voice = &msm5205[chip];
+	const double now = timer_get_time();
+	int i = 0;
+
+	/* apply the queued levels that changed before each sample; the buffer ends "now" */
+	while (voice->event_tail != voice->event_head)
+	{
+		const struct msm5205_event *ev = &voice->events[voice->event_tail & (MSM5205_EVENT_COUNT-1)];
+		int pos = length - (int)((now - ev->time) * Machine->sample_rate);
+		if (pos > length)
+			break;	/* still in the future, keep it for the next update */
+		for (; i < pos; i++)
+			buffer[i] = voice->output * 16;
+		voice->output = ev->signal;
+		voice->event_tail++;
+	}
 
 	/* if this voice is active */
-	if(voice->signal)
+	if(voice->output)
 	{
-		const INT16 val = voice->signal * 16;
-		int i;
-		for (i = 0; i < length; i++)
+		const INT16 val = voice->output * 16;
+		for (; i < length; i++)
 			buffer[i] = val;
 	}
-	else
-		memset (buffer,0,length*sizeof(INT16));
+	else if (i < length)
+		memset (buffer+i,0,(length-i)*sizeof(INT16));
 }
 
 /* timer callback at VCLK low eddge */
@@ -172,11 +219,12 @@ static void MSM5205_vclk_callback(int num)
 		if (voice->step > 48) voice->step = 48;
 		else if (voice->step < 0) voice->step = 0;
 	}
-	/* update when signal changed */
+	/* queue when signal changed */
 	if( voice->signal != new_signal)
 	{
-		stream_update(voice->stream,0);
 		voice->signal = new_signal;
+		if (Machine->sample_rate != 0)
+			MSM5205_queue(num,new_signal);
 	}
 }
 /*
@@ -250,6 +298,8 @@ void MSM5205_sh_reset(void)
 		voice->reset   = 0;
 		voice->signal  = 0;
 		voice->step    = 0;
+		voice->output  = 0;
+		voice->event_head = voice->event_tail = 0;
 		/* timer and bitwidth set */
 		MSM5205_playmode_w(i,msm5205_intf->select[i]);
 	}
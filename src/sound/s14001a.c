@@ -188,10 +188,15 @@ BOOL m_bStart;
 UINT8 m_uWord;              // 6 bit word noumber to be spoken
 
 // emulator variables
-// statistics
+// statistics, only kept by the debug builds
+#ifdef MAME_DEBUG
+#define S14001A_STATISTICS
+#endif
+#ifdef S14001A_STATISTICS
 UINT32 m_uNPitchPeriods;
 UINT32 m_uNVoiced;
 UINT32 m_uNControlWords;
+#endif
 
 // diagnostic output
 static const UINT32 m_uPrintLevel = 0;
@@ -203,8 +208,10 @@ BOOL Clock(void); // called once to toggle external clock twice
 UINT8 Mux8To2(BOOL bVoicedP2, UINT8 uPPQtrP2, UINT8 uDeltaAdrP2, UINT8 uRomDataP2);
 void CalculateIncrement(BOOL bVoicedP2, UINT8 uPPQtrP2, BOOL bPPQStartP2, UINT8 uDeltaP2, UINT8 uDeltaOldP2, UINT8 *uDeltaOldP1, UINT8 *uIncrementP2, BOOL *bAddP2);
 UINT8 CalculateOutput(BOOL bVoicedP2, BOOL bXSilenceP2, UINT8 uPPQtrP2, BOOL bPPQStartP2, UINT8 uLOutputP2, UINT8 uIncrementP2, BOOL bAddP2);
+#ifdef S14001A_STATISTICS
 void ClearStatistics();
 void GetStatistics(UINT32 *uNPitchPeriods, UINT32 *uNVoiced, UINT32 *uNControlWords);
+#endif
 
 void s14001a_update(int ch, INT16 *buffer, int length);
 
@@ -344,7 +351,9 @@ int s14001a_sh_start(const struct MachineSound *msound)
 	m_bStart = 0;
 	m_uWord = 0;
 
+#ifdef S14001A_STATISTICS
 	ClearStatistics();
+#endif
 	m_uOutputP1 = m_uOutputP2 = 7;
 
 	// register for savestates
@@ -401,15 +410,143 @@ void s14001a_sh_stop(void)
 //  sound_stream_update - handle a stream update
 //-------------------------------------------------
 
+#define S14001A_SAMPLE(output) ((INT16)(((INT16)(output) - 7) * 0xf00)) // range -7..8
+
+// Renders whole PLAY cycles (phase 1 then phase 2, one sample each) until the state
+// changes or the buffer is full, and returns the number of cycles rendered.
+// Called at the start of a cycle, where the phase 2 registers are a copy of the phase 1
+// ones and START is low (it can't change during a stream update): each cycle is then
+// computed once from a single set of registers kept in locals, the carries derived from
+// them, and the ROM byte read once per address.
+static int PlayCycles(INT16 *buffer, int cycles)
+{
+	const BOOL bVoiced = m_bVoicedP2;
+	const BOOL bSilence = m_bSilenceP2;
+	const BOOL bStop = m_bStopP2;
+	const UINT8 uXRepeat = m_uXRepeatP1;
+	UINT16 uDAR13To05 = m_uDAR13To05P2;
+	UINT16 uDAR04To00 = m_uDAR04To00P2;
+	UINT16 uRomAddr = m_uRomAddrP2;
+	UINT8 uLength = m_uLengthP2;
+	UINT8 uDeltaOld = m_uDeltaOldP2;
+	UINT8 uOutput = m_uOutputP2;
+	UINT16 uRomDataAddr = uRomAddr ^ 0xffff; // no byte read yet
+	UINT8 uRomData = 0;
+	int state = PLAY;
+	int n;
+
+	for (n = 0; n < cycles && state == PLAY; n++)
+	{
+		const BOOL bDAR04To00Carry = uDAR04To00 == 0x1F;
+		const BOOL bPPQCarry       = bDAR04To00Carry && ((uLength&0x03) == 0x03);
+		const BOOL bRepeatCarry    = bPPQCarry       && ((uLength&0x0C) == 0x0C);
+		const BOOL bLengthCarry    = bRepeatCarry    && ( uLength       == 0x7F);
+		UINT8 uDelta, uIncrement, uNewOutput;
+		BOOL bAdd;
+
+#ifdef S14001A_STATISTICS
+		if (bPPQCarry)
+		{
+			m_uNPitchPeriods++;
+			if (bVoiced) m_uNVoiced++;
+		}
+#endif
+		if (uRomAddr != uRomDataAddr)
+		{
+			uRomDataAddr = uRomAddr;
+			uRomData = readmem(uRomAddr, TRUE);
+		}
+
+		// phase 1: modify output
+		uDelta = Mux8To2(bVoiced, uLength & 0x03, uDAR04To00 & 0x03, uRomData);
+		CalculateIncrement(bVoiced, uLength & 0x03, uDAR04To00 == 0, uDelta, uDeltaOld, &uDeltaOld, &uIncrement, &bAdd);
+		uNewOutput = CalculateOutput(bVoiced, bSilence, uLength & 0x03, uDAR04To00 == 0, uOutput, uIncrement, bAdd);
+
+		// the output pins change on phase 2
+		buffer[0] = S14001A_SAMPLE(uOutput);
+		buffer[1] = S14001A_SAMPLE(uNewOutput);
+		buffer += 2;
+		uOutput = uNewOutput;
+
+		// advance counters
+		uDAR04To00++;
+		if (bDAR04To00Carry) // pitch period quarter end
+		{
+			uDAR04To00 = 0; // emulate 5 bit counter
+			uLength++; // lower two bits of length count quarter pitch periods
+			if (uLength >= 0x80)
+				uLength = 0; // emulate 7 bit counter
+		}
+		if (bVoiced ? bRepeatCarry : bDAR04To00Carry) // repeat complete, unvoiced advances each quarter pitch period
+		{
+			if (bVoiced)
+			{
+				uLength &= 0x70; // keep current "length"
+				uLength |= (uXRepeat<<2); // load repeat from external repeat
+			}
+			uDAR13To05++; // advances ROM address 8 bytes
+			if (uDAR13To05 >= 0x200) uDAR13To05 = 0; // emulate 9 bit counter
+		}
+
+		// construct the rom address
+		uRomAddr = uDAR04To00;
+		if (bVoiced && uLength&0x1) // mirroring
+			uRomAddr ^= 0x1f; // count backwards
+		uRomAddr = (uDAR13To05<<3) | uRomAddr>>2;
+
+		// next state
+		if (bStop && bLengthCarry) state = DELAY;
+		else if (bLengthCarry)
+		{
+			state    = DARMSB;
+			uRomAddr = m_uCWARP1; // output correct address
+		}
+	}
+
+	// back to the registers, as left by the phase 2 transfer of the last cycle
+	m_uStateP1     = m_uStateP2     = state;
+	m_uDAR13To05P1 = m_uDAR13To05P2 = uDAR13To05;
+	m_uDAR04To00P1 = m_uDAR04To00P2 = uDAR04To00;
+	m_uLengthP1    = m_uLengthP2    = uLength;
+	m_uDeltaOldP1  = m_uDeltaOldP2  = uDeltaOld;
+	m_uOutputP1    = m_uOutputP2    = uOutput;
+	m_RomAddrP1    = m_uRomAddrP2   = uRomAddr;
+	m_bDAR04To00CarryP2  = m_uDAR04To00P2 == 0x1F;
+	m_bPPQCarryP2        = m_bDAR04To00CarryP2 && ((m_uLengthP2&0x03) == 0x03);
+	m_bRepeatCarryP2     = m_bPPQCarryP2       && ((m_uLengthP2&0x0C) == 0x0C);
+	m_bLengthCarryP2     = m_bRepeatCarryP2    && ( m_uLengthP2       == 0x7F);
+	m_bPhase1 = FALSE;
+	return n;
+}
+
+// one sample per Clock() call, i.e. per half cycle: the idle runs are filled at once,
+// the speech is rendered a cycle at a time by PlayCycles, the few control word cycles
+// between the phrases go through Clock()
 void s14001a_update(int ch, INT16 *buffer, int length)
 {
-	int i;
-	for (i = 0; i < length; i++)
+	int i = 0;
+	while (i < length)
 	{
-		INT16 sample;
+		if (!m_bPhase1 && !m_bStart)
+		{
+			if (m_uStateP1 == IDLE && m_uStateP2 == IDLE && !m_bBusyP1 && m_uOutputP1 == 7 && m_uOutputP2 == 7)
+			{
+				// idle, nothing changes until START
+				const INT16 sample = S14001A_SAMPLE(7);
+				if ((length - i) & 1)
+					m_bPhase1 = TRUE;
+				for (; i < length; i++)
+					buffer[i] = sample;
+				break;
+			}
+			if (m_uStateP1 == PLAY && length - i >= 2)
+			{
+				i += 2 * PlayCycles(buffer + i, (length - i) / 2);
+				continue;
+			}
+		}
 		Clock();
-		sample = m_uOutputP2 - 7; // range -7..8
-		buffer[i] = sample * 0xf00;
+		buffer[i++] = S14001A_SAMPLE(m_uOutputP2);
 	}
 }
 
@@ -576,7 +713,9 @@ BOOL Clock(void)
 		m_uDAR04To00P1 = 0;
 		m_uCWARP1++;
 		m_RomAddrP1 = m_uCWARP1;
+#ifdef S14001A_STATISTICS
 		m_uNControlWords++; // statistics
+#endif
 
 		m_uOutputP1 = 7;
 		if (m_bStart) m_uStateP1 = WORDWAIT;
@@ -608,7 +747,7 @@ BOOL Clock(void)
 		UINT8 uIncrementP2; // signal lines
 		BOOL bAddP2;        // signal line
 
-		// statistics
+#ifdef S14001A_STATISTICS
 		if (m_bPPQCarryP2)
 		{
 			// pitch period end
@@ -618,7 +757,7 @@ BOOL Clock(void)
 			m_uNPitchPeriods++;
 			if (m_bVoicedP2) m_uNVoiced++;
 		}
-		// end statistics
+#endif
 
 		// modify output
 		uDeltaP2 = Mux8To2(m_bVoicedP2,
@@ -702,6 +841,7 @@ BOOL Clock(void)
 	return TRUE;
 }
 
+#ifdef S14001A_STATISTICS
 void ClearStatistics()
 {
 	m_uNPitchPeriods = 0;
@@ -716,3 +856,4 @@ void GetStatistics(UINT32 *uNPitchPeriods, UINT32 *uNVoiced, UINT32 *uNControlWo
 	*uNVoiced = m_uNVoiced;
 	*uNControlWords = m_uNControlWords;
 }
+#endif
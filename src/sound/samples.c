@@ -7,6 +7,8 @@ static int firstchannel,numchannels;
 /* mixer_play_sample() */
 void sample_start(int channel,int samplenum,int loop)
 {
+	struct GameSample *sample;
+
 	if (Machine->sample_rate == 0) return;
 	if (Machine->samples == 0) return;
 	if (channel >= numchannels)
@@ -19,24 +21,25 @@ void sample_start(int channel,int samplenum,int loop)
 		logerror("error: sample_start() called with samplenum = %d, but only %d samples available\n",samplenum,Machine->samples->total);
 		return;
 	}
-	if (Machine->samples->sample[samplenum] == 0) return;
+	sample = getsample(Machine->samples,samplenum);
+	if (sample == 0) return;
 
-	if ( Machine->samples->sample[samplenum]->resolution == 8 )
+	if ( sample->resolution == 8 )
 	{
 		logerror("play 8 bit sample %d, channel %d\n",samplenum,channel);
 		mixer_play_sample(firstchannel + channel,
-				Machine->samples->sample[samplenum]->data,
-				Machine->samples->sample[samplenum]->length,
-				Machine->samples->sample[samplenum]->smpfreq,
+				sample->data,
+				sample->length,
+				sample->smpfreq,
 				loop);
 	}
 	else
 	{
 		logerror("play 16 bit sample %d, channel %d\n",samplenum,channel);
 		mixer_play_sample_16(firstchannel + channel,
-				(short *) Machine->samples->sample[samplenum]->data,
-				Machine->samples->sample[samplenum]->length,
-				Machine->samples->sample[samplenum]->smpfreq,
+				(short *) sample->data,
+				sample->length,
+				sample->smpfreq,
 				loop);
 	}
 }
@@ -126,11 +129,16 @@ int samples_sh_start(const struct MachineSound *msound)
 	 + ((hi_samples ? Machine->samples->total : 0) + game_samples[hi_samples]->total) * sizeof(struct GameSample));
 	hi_samples++;
 	Machine->samples->total = 0;
+	for (i=0; i < hi_samples; i++)
+		Machine->samples->total += game_samples[i]->total;
+	Machine->samples->source = auto_malloc(Machine->samples->total * sizeof(struct GameSampleSource));
 	for (i=0; i < hi_samples; i++) {
 		int j;
-		Machine->samples->total += game_samples[i]->total;
-		for (j=0; j < game_samples[i]->total; j++)
-			Machine->samples->sample[hi_sample++] = game_samples[i]->sample[j];
+		for (j=0; j < game_samples[i]->total; j++) {
+			/* samples are read on first use, so the load state has to be merged too */
+			Machine->samples->sample[hi_sample] = game_samples[i]->sample[j];
+			Machine->samples->source[hi_sample++] = game_samples[i]->source[j];
+		}
 	}
 
 	for (i = 0; i < intf->channels; i++)
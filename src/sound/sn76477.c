@@ -26,6 +26,7 @@
  *****************************************************************************/
 
 #include "driver.h"
+#include <math.h>
 
 #define VERBOSE 0
 
@@ -83,7 +84,8 @@ struct SN76477 {
 	UINT32 noise_poly; 		/* polynome */
 	UINT32 noise_out;		/* rectangular output signal state */
 
-	void *envelope_timer;	/* ENVELOPE timer */
+	double envelope_count;	/* ENVELOPE samples until the next toggle */
+	double envelope_period;	/* ENVELOPE toggle period in samples, 0 = off */
 	UINT32 envelope_state; 	/* attack / decay toggle */
 
 	double attack_time; 	/* ATTACK time (time until vol reaches 100%) */
@@ -139,9 +141,11 @@ static void attack_decay(int param)
     }
 }
 
-static void vco_envelope_cb(int param)
+/* the VCO envelope toggles are counted off in samples by the stream update */
+static void vco_envelope_start(struct SN76477 *sn, double freq)
 {
-	attack_decay(param);
+	sn->envelope_period = sn->samplerate / freq;
+	sn->envelope_count = sn->envelope_period;
 }
 
 static void oneshot_envelope_cb(int param)
@@ -318,7 +322,7 @@ void SN76477_enable_w(int chip, UINT32 data)
 	sn->enable = data;
 	sn->envelope_state = data;
 
-	timer_adjust(sn->envelope_timer, TIME_NEVER, chip, 0);
+	sn->envelope_period = 0;
 	timer_adjust(sn->oneshot_timer, TIME_NEVER, chip, 0);
 
 	if( sn->enable == 0 )
@@ -327,7 +331,7 @@ void SN76477_enable_w(int chip, UINT32 data)
 		{
 		case 0: /* VCO */
 			if( sn->vco_res > 0 && sn->vco_cap > 0 )
-				timer_adjust(sn->envelope_timer, TIME_IN_HZ(0.64/(sn->vco_res * sn->vco_cap)), chip, TIME_IN_HZ(0.64/(sn->vco_res * sn->vco_cap)));
+				vco_envelope_start(sn, 0.64/(sn->vco_res * sn->vco_cap));
 			else
 				oneshot_envelope_cb(chip);
 			break;
@@ -343,7 +347,7 @@ void SN76477_enable_w(int chip, UINT32 data)
 		default:  /* VCO with alternating polariy */
 			/* huh? */
 			if( sn->vco_res > 0 && sn->vco_cap > 0 )
-				timer_adjust(sn->envelope_timer, TIME_IN_HZ(0.64/(sn->vco_res * sn->vco_cap)/2), chip, TIME_IN_HZ(0.64/(sn->vco_res * sn->vco_cap)/2));
+				vco_envelope_start(sn, 0.64/(sn->vco_res * sn->vco_cap)/2);
 			else
 				oneshot_envelope_cb(chip);
 			break;
@@ -355,7 +359,7 @@ void SN76477_enable_w(int chip, UINT32 data)
 		{
 		case 0: /* VCO */
 			if( sn->vco_res > 0 && sn->vco_cap > 0 )
-				timer_adjust(sn->envelope_timer, TIME_IN_HZ(0.64/(sn->vco_res * sn->vco_cap)), chip, TIME_IN_HZ(0.64/(sn->vco_res * sn->vco_cap)));
+				vco_envelope_start(sn, 0.64/(sn->vco_res * sn->vco_cap));
 			else
 				oneshot_envelope_cb(chip);
 			break;
@@ -368,7 +372,7 @@ void SN76477_enable_w(int chip, UINT32 data)
 		default:  /* VCO with alternating polariy */
 			/* huh? */
 			if( sn->vco_res > 0 && sn->vco_cap > 0 )
-				timer_adjust(sn->envelope_timer, TIME_IN_HZ(0.64/(sn->vco_res * sn->vco_cap)/2), chip, TIME_IN_HZ(0.64/(sn->vco_res * sn->vco_cap)/2));
+				vco_envelope_start(sn, 0.64/(sn->vco_res * sn->vco_cap)/2);
 			else
 				oneshot_envelope_cb(chip);
 			break;
@@ -944,7 +948,7 @@ static void SN76477_update_7(int chip, INT16 *buffer, int length)
 		*buffer++ = 0;
 }
 
-static void SN76477_sound_update(int param, INT16 *buffer, int length)
+static void SN76477_render(int param, INT16 *buffer, int length)
 {
 	struct SN76477 *sn = sn76477[param];
 	if( sn->enable )
@@ -983,6 +987,32 @@ static void SN76477_sound_update(int param, INT16 *buffer, int length)
 	}
 }
 
+static void SN76477_sound_update(int param, INT16 *buffer, int length)
+{
+	struct SN76477 *sn = sn76477[param];
+
+	/* split the block at the VCO envelope toggles, so they land on the */
+	/* right sample without running a timer at the VCO rate */
+	while( length > 0 )
+	{
+		int run = length;
+		if( sn->envelope_period > 0 && sn->envelope_count < run )
+			run = (int)ceil(sn->envelope_count);
+		SN76477_render(param,buffer,run);
+		buffer += run;
+		length -= run;
+		if( sn->envelope_period > 0 )
+		{
+			sn->envelope_count -= run;
+			while( sn->envelope_count <= 0 )
+			{
+				sn->envelope_count += sn->envelope_period;
+				attack_decay(param);
+			}
+		}
+	}
+}
+
 int SN76477_sh_start(const struct MachineSound *msound)
 {
 	int i;
@@ -1009,7 +1039,6 @@ int SN76477_sh_start(const struct MachineSound *msound)
 		}
 		sn76477[i]->samplerate = Machine->sample_rate != 0. ? (int)(Machine->sample_rate+0.5) : 1;
 		
-		sn76477[i]->envelope_timer = timer_alloc(vco_envelope_cb);
 		sn76477[i]->oneshot_timer = timer_alloc(oneshot_envelope_cb);
 		
 		/* set up interface (default) values */
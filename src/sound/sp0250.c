@@ -37,6 +37,7 @@ static struct {
 	int pcount, rcount;
 	UINT16 lfsr;
 	int stream;
+	mame_timer *timer;
 	int voiced;
 	UINT8 fifo[15];
 	int fifo_pos;
@@ -59,9 +60,10 @@ int sp0250_sh_start( const struct MachineSound *msound )
 	sp0250.lfsr = 0x7fff;
 	sp0250.drq = intf->drq_callback;
 	sp0250.drq(ASSERT_LINE);
-	timer_pulse(TIME_IN_HZ(3120000 / CLOCK_DIVIDER), 0, sp0250_timer_tick);
+	sp0250.timer = timer_alloc(sp0250_timer_tick);
 
 	sp0250.stream = stream_init("SP0250", intf->volume, 3120000. / CLOCK_DIVIDER, 0, sp0250_update);
+	timer_adjust(sp0250.timer, TIME_IN_HZ(3120000 / CLOCK_DIVIDER), 0, 0);
 
 	return 0;
 }
@@ -136,6 +138,17 @@ static void sp0250_timer_tick(int param)
 	stream_update(sp0250.stream, 0);
 }
 
+/* The DRQ line only changes when a new frame is loaded from the FIFO, so
+   instead of updating the stream every sample, wake up when the current
+   frame's repeat count runs out */
+static void sp0250_schedule_load(void)
+{
+	int samples = 1;
+	if (sp0250.rcount < sp0250.repeat)
+		samples += (sp0250.pitch + 1 - sp0250.pcount) + (sp0250.repeat - sp0250.rcount - 1) * (sp0250.pitch + 1);
+	timer_adjust(sp0250.timer, samples * TIME_IN_HZ(3120000 / CLOCK_DIVIDER), 0, 0);
+}
+
 static void sp0250_update(int num, INT16 *output, int length)
 {
 	int i;
@@ -202,6 +215,9 @@ static void sp0250_update(int num, INT16 *output, int length)
 			sp0250.rcount++;
 		}
 	}
+
+	if (sp0250.timer)
+		sp0250_schedule_load();
 }
 
 void sp0250_sh_stop( void )
@@ -26,6 +26,14 @@ static int stream_param[MIXER_MAX_CHANNELS];
 static bool stream_is_float[MIXER_MAX_CHANNELS];
 static void (*stream_callback[MIXER_MAX_CHANNELS])(int param,INT16 *buffer,int length);
 static void (*stream_callback_multi[MIXER_MAX_CHANNELS])(int param,INT16 **buffer,int length);
+static int stream_profiler[MIXER_MAX_CHANNELS];	/* profiler label, one per chip/stream name */
+static UINT64 stream_samples[MIXER_MAX_CHANNELS];	/* generated since the stream was created */
+
+INLINE void stream_update_count(int channel,int samples)
+{
+	stream_samples[channel] += samples;
+	profiler_count(stream_profiler[channel],samples);
+}
 
 int streams_sh_start(void)
 {
@@ -85,7 +93,10 @@ void streams_sh_update(void)
 						buf[i] = (UINT8*)(stream_buffer[channel+i]) + stream_buffer_pos[channel+i]*(stream_is_float[channel+i] ? sizeof(float) : sizeof(INT16));
 					}
 
+					profiler_mark(stream_profiler[channel]);
 					(*stream_callback_multi[channel])(stream_param[channel],(INT16**)buf,buflen);
+					profiler_mark(PROFILER_END);
+					stream_update_count(channel,buflen);
 				}
 
 				for (i = 0;i < stream_joined_channels[channel];i++)
@@ -97,7 +108,10 @@ void streams_sh_update(void)
 				{
 					void *buf = (UINT8*)(stream_buffer[channel]) + stream_buffer_pos[channel] * (stream_is_float[channel] ? sizeof(float) : sizeof(INT16));
 
+					profiler_mark(stream_profiler[channel]);
 					(*stream_callback[channel])(stream_param[channel],buf,buflen);
+					profiler_mark(PROFILER_END);
+					stream_update_count(channel,buflen);
 				}
 
 				stream_buffer_pos[channel] = 0;
@@ -138,6 +152,8 @@ int stream_init_float(const char *name,int default_mixing_level,
 	mixer_set_channel_legacy_resample(channel,0);
 
 	mixer_set_name(channel,name);
+	stream_profiler[channel] = profiler_label(name,PROFILER_SOUND);
+	stream_samples[channel] = 0;
 
 	if ((stream_buffer[channel] = malloc((is_float ? sizeof(float) : sizeof(INT16))*BUFFER_LEN)) == 0)
 		return -1;
@@ -175,6 +191,22 @@ double stream_get_sample_rate(int channel)
 	return stream_sample_rate[channel];
 }
 
+/* the counters of the stream starting at 'channel', returns 0 if there is none;
+   the time is only measured while the profiler totals are on (profiler_set_totals) */
+int stream_get_stats(int channel, const char **name, UINT64 *samples, double *seconds)
+{
+	if (channel < 0 || channel >= MIXER_MAX_CHANNELS || !stream_buffer[channel])
+		return 0;
+
+	if (name)
+		*name = mixer_get_name(channel);
+	if (samples)
+		*samples = stream_samples[channel];
+	if (seconds)
+		*seconds = (stream_profiler[channel] != PROFILER_SOUND) ? profiler_get_total(stream_profiler[channel], NULL) : 0.;
+	return stream_joined_channels[channel];
+}
+
 void stream_free(int channel)
 {
 	if(stream_buffer[channel])
@@ -219,6 +251,9 @@ int stream_init_multi_float(int channels,const char **names,const int *default_m
 			stream_sample_length[channel+i] = 0;
 	}
 
+	/* the first name is enough to tell the chip */
+	stream_profiler[channel] = profiler_label(names[0],PROFILER_SOUND);
+	stream_samples[channel] = 0;
 	stream_param[channel] = param;
 	stream_callback_multi[channel] = callback;
 
@@ -249,9 +284,10 @@ void stream_update(int channel,int min_interval)
 			for (i = 0;i < stream_joined_channels[channel];i++)
 				buf[i] = (UINT8*)(stream_buffer[channel+i]) + stream_buffer_pos[channel+i] * (stream_is_float[channel+i] ? sizeof(float) : sizeof(INT16));
 
-			profiler_mark(PROFILER_SOUND);
+			profiler_mark(stream_profiler[channel]);
 			(*stream_callback_multi[channel])(stream_param[channel],(INT16**)buf,buflen);
 			profiler_mark(PROFILER_END);
+			stream_update_count(channel,buflen);
 
 			for (i = 0;i < stream_joined_channels[channel];i++)
 				stream_buffer_pos[channel+i] += buflen;
@@ -260,9 +296,10 @@ void stream_update(int channel,int min_interval)
 		{
 			void *buf = (UINT8*)(stream_buffer[channel]) + stream_buffer_pos[channel] * (stream_is_float[channel] ? sizeof(float) : sizeof(INT16));
 
-			profiler_mark(PROFILER_SOUND);
+			profiler_mark(stream_profiler[channel]);
 			(*stream_callback[channel])(stream_param[channel],buf,buflen);
 			profiler_mark(PROFILER_END);
+			stream_update_count(channel,buflen);
 
 			stream_buffer_pos[channel] += buflen;
 		}
@@ -30,6 +30,7 @@ void stream_update(int channel,int min_interval);	/* min_interval is in usec */
 
 void stream_set_sample_rate(int channel, double sample_rate);
 double stream_get_sample_rate(int channel);
+int stream_get_stats(int channel, const char **name, UINT64 *samples, double *seconds);
 
 #ifdef __cplusplus
 }
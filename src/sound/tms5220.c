@@ -514,6 +514,34 @@ static void parse_frame(struct tms5220 *tms);
 static void set_interrupt_state(struct tms5220 *tms, int state);
 static void update_ready_state(struct tms5220 *tms);
 static INT32 lattice_filter(struct tms5220 *tms);
+
+/* RNG state after the 20 LFSR shifts done for every sample.  The 16 bit
+   register is completely refilled after 16 shifts and only bits 0-12 feed
+   the taps, so the result only depends on the low 13 bits. */
+static UINT16 rng_after_sample[0x2000];
+static int rng_table_ready = 0;
+
+static void init_rng_table(void)
+{
+  int i, j;
+  if (rng_table_ready)
+    return;
+  for (i = 0; i < 0x2000; i++)
+  {
+    UINT16 rng = (UINT16)i;
+    for (j = 0; j < 20; j++)
+    {
+      const int bitout = ((rng >> 12) & 1) ^
+                         ((rng >>  3) & 1) ^
+                         ((rng >>  2) & 1) ^
+                         ((rng >>  0) & 1);
+      rng <<= 1;
+      rng |= bitout;
+    }
+    rng_after_sample[i] = rng;
+  }
+  rng_table_ready = 1;
+}
 static INT16 clip_analog(INT16 clip);
 
 /**********************************************************************************************
@@ -564,6 +592,7 @@ void tms5220_reset_chip(void *chip)
   tms->OLDE = tms->OLDP = 1;
   tms->interp_period = reload_table[tms->tms5220c_rate&0x3];
   tms->RNG = 0x1FFF;
+  init_rng_table();
   memset(tms->u, 0, sizeof(tms->u));
   memset(tms->x, 0, sizeof(tms->x));
   tms->schedule_dummy_read = 0;
@@ -964,7 +993,7 @@ void tms5220_process_chip(void *chip, INT16 *buffer, unsigned int size)
 {
   struct tms5220 *tms = chip;
   int buf_count=0;
-  int i, bitout, zpar;
+  int i, zpar;
   INT32 this_sample;
 
   /* the following gotos are probably safe to remove */
@@ -1218,15 +1247,8 @@ void tms5220_process_chip(void *chip, INT16 *buffer, unsigned int size)
 #endif
     }
 
-    /* Update LFSR *20* times every sample (once per T cycle), like patent shows */
-    for (i=0; i < 20; i++) {
-      bitout = ((tms->RNG >> 12) & 1) ^
-               ((tms->RNG >>  3) & 1) ^
-               ((tms->RNG >>  2) & 1) ^
-               ((tms->RNG >>  0) & 1);
-      tms->RNG <<= 1;
-      tms->RNG |= bitout;
-    }
+    /* Update LFSR *20* times every sample (once per T cycle), like patent shows (see init_rng_table) */
+    tms->RNG = rng_after_sample[tms->RNG & 0x1FFF];
     this_sample = lattice_filter(tms); /* execute lattice filter */
 #ifdef DEBUG_GENERATION_VERBOSE
     //fprintf(stderr,"C:%01d; ",tms->subcycle);
@@ -1367,10 +1389,8 @@ static INT16 clip_analog(INT16 cliptemp)
 static INT32 matrix_multiply(INT32 a, INT32 b)
 {
   INT32 result;
-  while (a>511) { a-=1024; }
-  while (a<-512) { a+=1024; }
-  while (b>16383) { b-=32768; }
-  while (b<-16384) { b+=32768; }
+  a = ((a + 512) & 0x3FF) - 512;      /* wrap to 10 bits signed */
+  b = ((b + 16384) & 0x7FFF) - 16384; /* wrap to 15 bits signed */
   result = ((a*b)>>9); /** TODO: this isn't technically right to the chip, which truncates the lowest result bit, but it causes glitches otherwise. **/
 #ifdef VERBOSE
   if (result>16383) fprintf(stderr,"matrix multiplier overflowed! a: %x, b: %x, result: %x", a, b, result);
@@ -160,6 +160,10 @@ static struct {
 	double fx_a[1],  fx_b[2];                   // Final filtering
 	double fn_a[3],  fn_b[3];                   // Noise shaping
 
+	// Silence detection, to skip the analog path while the chip is muted
+	UINT32 quiet_samples;                            // Samples rendered with zero voice and noise volume
+	bool idle;                                       // Filter histories are all zero, output is exactly zero
+
 	int stream;
 
 	int type; // 0 = old SC-01, 1 = newer SC-01-A
@@ -1106,6 +1110,31 @@ void filters_commit(int force)
 		return total;
 	}
 
+// The analog path is linear, so with zero voice/noise input and all filter
+// histories decayed to (practically) zero, its output stays exactly zero
+#define VOTRAX_QUIET_CHECK 256                     // Samples between two checks of the histories
+#define VOTRAX_QUIET_LEVEL 1e-7                    // Below -140dB of a full scale glottal pulse
+
+#define HIST_QUIET(h) { size_t k; for (k = 0; k < sizeof(h)/sizeof(h[0]); k++) if (fabs(h[k]) > VOTRAX_QUIET_LEVEL) return 0; }
+#define HIST_CLEAR(h) memset(h, 0, sizeof(h))
+
+static int analog_quiet()
+{
+	HIST_QUIET(votraxsc01_locals.voice_1) HIST_QUIET(votraxsc01_locals.voice_2) HIST_QUIET(votraxsc01_locals.voice_3)
+	HIST_QUIET(votraxsc01_locals.noise_1) HIST_QUIET(votraxsc01_locals.noise_2) HIST_QUIET(votraxsc01_locals.noise_3) HIST_QUIET(votraxsc01_locals.noise_4)
+	HIST_QUIET(votraxsc01_locals.vn_1) HIST_QUIET(votraxsc01_locals.vn_2) HIST_QUIET(votraxsc01_locals.vn_3)
+	HIST_QUIET(votraxsc01_locals.vn_4) HIST_QUIET(votraxsc01_locals.vn_5) HIST_QUIET(votraxsc01_locals.vn_6)
+	return 1;
+}
+
+static void analog_clear()
+{
+	HIST_CLEAR(votraxsc01_locals.voice_1); HIST_CLEAR(votraxsc01_locals.voice_2); HIST_CLEAR(votraxsc01_locals.voice_3);
+	HIST_CLEAR(votraxsc01_locals.noise_1); HIST_CLEAR(votraxsc01_locals.noise_2); HIST_CLEAR(votraxsc01_locals.noise_3); HIST_CLEAR(votraxsc01_locals.noise_4);
+	HIST_CLEAR(votraxsc01_locals.vn_1); HIST_CLEAR(votraxsc01_locals.vn_2); HIST_CLEAR(votraxsc01_locals.vn_3);
+	HIST_CLEAR(votraxsc01_locals.vn_4); HIST_CLEAR(votraxsc01_locals.vn_5); HIST_CLEAR(votraxsc01_locals.vn_6);
+}
+
 static float analog_calc()
 {
 	double v,n,n2,vn;
@@ -1551,7 +1580,20 @@ static void Votrax_Update(int num, INT16 *buffer, int length)
 		votraxsc01_locals.sample_count++;
 		if (votraxsc01_locals.sample_count & 1)
 			chip_update();
-		buffer_f[i] = analog_calc();
+
+		if (votraxsc01_locals.filt_va || votraxsc01_locals.filt_fa) {
+			votraxsc01_locals.idle = 0;
+			votraxsc01_locals.quiet_samples = 0;
+		}
+		else if (!votraxsc01_locals.idle && ++votraxsc01_locals.quiet_samples >= VOTRAX_QUIET_CHECK) {
+			votraxsc01_locals.quiet_samples = 0;
+			if (analog_quiet()) {
+				analog_clear();
+				votraxsc01_locals.idle = 1;
+			}
+		}
+
+		buffer_f[i] = votraxsc01_locals.idle ? 0.f : analog_calc();
 		//LOG(("Votrax SC-01: buffer %d\n", ac));
 	}
 #else
@@ -239,6 +239,7 @@ typedef struct {
 
 	signed int chanout[18];			/* 18 channels */
 	signed int phase_modulation;	/* phase modulation input (SLOT 2) */
+	UINT32 active;					/* channels that can sound in the current block */
 	signed int phase_modulation2;	/* phase modulation input (SLOT 3 in 4 operator channels) */
 
 	UINT32	eg_cnt;					/* global envelope generator counter	*/
@@ -694,6 +695,25 @@ INLINE void advance_lfo(OPL3 *chip)
 	chip->LFO_PM = ((chip->lfo_pm_cnt>>LFO_SH) & 7) | chip->lfo_pm_depth_range;
 }
 
+/* find the channels that can make sound in the next block. A channel with
+   all operators off and its feedback drained outputs nothing, and its phase
+   is reset on key-on. Key-on only happens between blocks, since register
+   writes update the stream first, so the set can only shrink within a block.
+   The rhythm channels are always run, since they share phases. */
+INLINE void find_active(OPL3 *chip)
+{
+	int ch;
+
+	chip->active = (chip->rhythm & 0x20) ? 0x1c0 : 0;
+	for (ch = 0; ch < 18; ch++)
+	{
+		OPL3_CH *CH = &chip->P_CH[ch];
+		if (CH->SLOT[SLOT1].state != EG_OFF || CH->SLOT[SLOT2].state != EG_OFF ||
+			CH->SLOT[SLOT1].op1_out[0] || CH->SLOT[SLOT1].op1_out[1])
+			chip->active |= 1 << ch;
+	}
+}
+
 /* advance to next sample */
 INLINE void advance(OPL3 *chip)
 {
@@ -712,6 +732,9 @@ INLINE void advance(OPL3 *chip)
 
 		for (i=0; i<9*2*2; i++)
 		{
+			if (!(chip->active & (1 << (i/2))))
+				continue;
+
 			CH  = &chip->P_CH[i/2];
 			op  = &CH->SLOT[i&1];
 #if 1
@@ -798,6 +821,9 @@ INLINE void advance(OPL3 *chip)
 //profiler_mark(PROFILER_USER4);
 	for (i=0; i<9*2*2; i++)
 	{
+		if (!(chip->active & (1 << (i/2))))
+			continue;
+
 		CH  = &chip->P_CH[i/2];
 		op  = &CH->SLOT[i&1];
 
@@ -899,6 +925,9 @@ INLINE void chan_calc( OPL3 *chip, OPL3_CH *CH )
 	chip->phase_modulation = 0;
 	chip->phase_modulation2= 0;
 
+	if (!(chip->active & (1 << (CH - chip->P_CH))))
+		return;
+
 	/* SLOT 1 */
 	SLOT = &CH->SLOT[SLOT1];
 	env  = volume_calc(SLOT);
@@ -932,6 +961,9 @@ INLINE void chan_calc_ext( OPL3 *chip, OPL3_CH *CH )
 
 	chip->phase_modulation = 0;
 
+	if (!(chip->active & (1 << (CH - chip->P_CH))))
+		return;
+
 	/* SLOT 1 */
 	SLOT = &CH->SLOT[SLOT1];
 	env  = volume_calc(SLOT);
@@ -2629,6 +2661,8 @@ void YMF262UpdateOne(int which, INT16 **buffers, int length)
 		SLOT8_1 = &chip->P_CH[8].SLOT[SLOT1];
 		SLOT8_2 = &chip->P_CH[8].SLOT[SLOT2];
 	}
+	find_active(chip);
+
 	for( i=0; i < length ; i++ )
 	{
 		int a,b,c,d;
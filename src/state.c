@@ -15,8 +15,20 @@
  *	a..13  Game name padded with \0
  * 14..17  Signature
  * 18..end Save game data
+ *
+ * Delta snapshot format (state_save_delta_encode), relative to a previous
+ * snapshot of the same size:
+ *
+ *	0.. 7  'MAMEDLTA'
+ *	8.. b  Snapshot size (LSB first)
+ *	c.. f  Number of changed pages (LSB first)
+ * 10..end For each changed page: page number (4 bytes, LSB first),
+ *         followed by SS_DELTA_PAGE bytes (less for the last page)
  */
 
+/* Page size used to find the changed parts of a snapshot */
+#define SS_DELTA_PAGE	256
+
 /* Available flags */
 enum {
 	SS_NO_SOUND = 0x01,
@@ -87,9 +99,38 @@ static ss_func *ss_prefunc_reg;
 static ss_func *ss_postfunc_reg;
 static int ss_current_tag;
 
+/* Compiled registry: the entries flattened into a copy list grouped by tag
+ * (registry order within a tag, adjacent entries of the same type merged) and
+ * the functions grouped by tag in call order. It is built by the first save or
+ * load after a registration, with the offsets, size and signature, so the
+ * snapshots (rewind, warm start) do no name or list work. */
+typedef struct ss_copy {
+	void *data;
+	unsigned offset;
+	unsigned length;	/* bytes */
+	int type;
+} ss_copy;
+
+typedef struct ss_compiled_funcs {
+	void (**funcs)(void);
+	int *first;			/* per tag, plus the end: funcs[first[tag]..first[tag+1]-1] */
+} ss_compiled_funcs;
+
+static struct {
+	int valid;
+	int tags;
+	size_t size;
+	UINT32 signature;
+	ss_copy *copies;
+	int *copy_first;	/* per tag, plus the end */
+	ss_compiled_funcs prefuncs;
+	ss_compiled_funcs postfuncs;
+} ss_compiled;
+
 static unsigned char *ss_dump_array;
 static mame_file *ss_dump_file;
 static size_t ss_dump_size;
+static int ss_dump_external;	/* ss_dump_array belongs to the caller (memory save/load) */
 
 
 static UINT32 ss_get_signature(void)
@@ -142,6 +183,17 @@ static UINT32 ss_get_signature(void)
 	return signature;
 }
 
+static void ss_free_compiled(void)
+{
+	free(ss_compiled.copies);
+	free(ss_compiled.copy_first);
+	free(ss_compiled.prefuncs.funcs);
+	free(ss_compiled.prefuncs.first);
+	free(ss_compiled.postfuncs.funcs);
+	free(ss_compiled.postfuncs.first);
+	memset(&ss_compiled, 0, sizeof(ss_compiled));
+}
+
 void state_save_reset(void)
 {
 	ss_func *f;
@@ -179,10 +231,13 @@ void state_save_reset(void)
 	}
 	ss_postfunc_reg = 0;
 
+	ss_free_compiled();
+
 	ss_current_tag = 0;
 	ss_dump_array = 0;
 	ss_dump_file = 0;
 	ss_dump_size = 0;
+	ss_dump_external = 0;
 }
 
 static ss_module *ss_get_module(const char *name)
@@ -214,6 +269,7 @@ static ss_entry *ss_register_entry(const char *module, int instance, const char
 	ss_module *m = ss_get_module(module);
 	ss_entry **ep = &(m->instances[instance]);
 	ss_entry *e;
+	ss_compiled.valid = 0;
 	while((e = *ep) != 0) {
 		int pos = strcmp(e->name, name);
 		if(!pos) {
@@ -297,6 +353,7 @@ void state_save_register_float(const char *module, int instance,
 static void ss_register_func(ss_func **root, void (*func)(void))
 {
 	ss_func *next = *root;
+	ss_compiled.valid = 0;
 	while (next)
 	{
 		if (next->func == func && next->tag == ss_current_tag)
@@ -382,23 +439,127 @@ static void ss_c8(unsigned char *data, unsigned size)
 }
 
 
-void state_save_save_begin(mame_file *file)
+/* Assign the offsets of all the entries, returns the total size */
+static size_t ss_compute_offsets(void)
 {
 	ss_module *m;
-	TRACE(logerror("Beginning save\n"));
-	ss_dump_size = 0x18;
-	ss_dump_file = file;
+	size_t size = 0x18;
 	for(m = ss_registry; m; m=m->next) {
 		int i;
 		for(i=0; i<MAX_INSTANCES; i++) {
 			ss_entry *e;
 			for(e = m->instances[i]; e; e=e->next) {
-				e->offset = ss_dump_size;
-				ss_dump_size += ss_size[e->type]*e->size;
+				e->offset = size;
+				size += ss_size[e->type]*e->size;
+			}
+		}
+	}
+	return size;
+}
+
+static int ss_compile_funcs(ss_compiled_funcs *c, ss_func *root, int tags)
+{
+	ss_func *f;
+	int tag, count = 0;
+
+	for(f = root; f; f=f->next)
+		count++;
+	c->funcs = malloc((count ? count : 1) * sizeof(*c->funcs));
+	c->first = malloc((tags + 1) * sizeof(*c->first));
+	if (c->funcs == NULL || c->first == NULL)
+		return 0;
+
+	count = 0;
+	for(tag=0; tag<tags; tag++) {
+		c->first[tag] = count;
+		for(f = root; f; f=f->next)
+			if(f->tag == tag)
+				c->funcs[count++] = f->func;
+	}
+	c->first[tags] = count;
+	return 1;
+}
+
+/* Builds ss_compiled if a registration changed the registry, returns 0 if out of memory */
+static int ss_compile(void)
+{
+	ss_module *m;
+	ss_func *f;
+	int i, tag, count = 0, tags = 1;
+
+	if (ss_compiled.valid)
+		return 1;
+	ss_free_compiled();
+
+	for(m = ss_registry; m; m=m->next)
+		for(i=0; i<MAX_INSTANCES; i++) {
+			ss_entry *e;
+			for(e = m->instances[i]; e; e=e->next) {
+				count++;
+				if (e->tag >= tags)
+					tags = e->tag + 1;
 			}
 		}
+	for(f = ss_prefunc_reg; f; f=f->next)
+		if (f->tag >= tags)
+			tags = f->tag + 1;
+	for(f = ss_postfunc_reg; f; f=f->next)
+		if (f->tag >= tags)
+			tags = f->tag + 1;
+
+	ss_compiled.tags = tags;
+	ss_compiled.size = ss_compute_offsets();
+	ss_compiled.signature = ss_get_signature();
+	ss_compiled.copies = malloc((count ? count : 1) * sizeof(ss_copy));
+	ss_compiled.copy_first = malloc((tags + 1) * sizeof(int));
+	if (ss_compiled.copies == NULL || ss_compiled.copy_first == NULL
+		|| !ss_compile_funcs(&ss_compiled.prefuncs, ss_prefunc_reg, tags)
+		|| !ss_compile_funcs(&ss_compiled.postfuncs, ss_postfunc_reg, tags))
+	{
+		logerror("malloc failed in ss_compile\n");
+		ss_free_compiled();
+		return 0;
 	}
 
+	count = 0;
+	for(tag=0; tag<tags; tag++) {
+		ss_compiled.copy_first[tag] = count;
+		for(m = ss_registry; m; m=m->next)
+			for(i=0; i<MAX_INSTANCES; i++) {
+				ss_entry *e;
+				for(e = m->instances[i]; e; e=e->next)
+					if(e->tag == tag) {
+						const unsigned length = ss_size[e->type]*e->size;
+						ss_copy *c = count > ss_compiled.copy_first[tag] ? &ss_compiled.copies[count-1] : NULL;
+						/* the ints are stored LSB first, one by one */
+						if(c && e->type != SS_INT && c->type == e->type
+							&& (UINT8 *)c->data + c->length == (UINT8 *)e->data && c->offset + c->length == e->offset)
+							c->length += length;
+						else {
+							c = &ss_compiled.copies[count];
+							c->data = e->data;
+							c->offset = e->offset;
+							c->length = length;
+							c->type = e->type;
+							count++;
+						}
+					}
+			}
+	}
+	ss_compiled.copy_first[tags] = count;
+	ss_compiled.valid = 1;
+	TRACE(logerror("Compiled %d copies, %d tags, size %u\n", count, tags, (unsigned)ss_compiled.size));
+	return 1;
+}
+
+void state_save_save_begin(mame_file *file)
+{
+	TRACE(logerror("Beginning save\n"));
+	ss_compile();
+	ss_dump_size = ss_compiled.size;
+	ss_dump_file = file;
+	ss_dump_external = 0;
+
 	TRACE(logerror("   total size %u\n", ss_dump_size));
 	ss_dump_array = malloc(ss_dump_size);
 	if (ss_dump_array == NULL)
@@ -407,42 +568,44 @@ void state_save_save_begin(mame_file *file)
 	}
 }
 
+size_t state_save_get_size(void)
+{
+	ss_compile();
+	return ss_compiled.size;
+}
+
+void state_save_save_begin_mem(UINT8 *buffer)
+{
+	TRACE(logerror("Beginning save to memory\n"));
+	ss_compile();
+	ss_dump_size = ss_compiled.size;
+	ss_dump_file = 0;
+	ss_dump_array = buffer;
+	ss_dump_external = 1;
+}
+
 void state_save_save_continue(void)
 {
-	ss_module *m;
-	ss_func * f;
-	int count = 0;
+	const ss_copy *c, *end;
+	int i;
 	TRACE(logerror("Saving tag %d\n", ss_current_tag));
+	if(!ss_compiled.valid || ss_dump_array == NULL || ss_current_tag >= ss_compiled.tags)
+		return;
 	TRACE(logerror("  calling pre-save functions\n"));
-	f = ss_prefunc_reg;
-	while(f) {
-		if(f->tag == ss_current_tag) {
-			count++;
-			(f->func)();
-		}
-		f = f->next;
-	}
-	TRACE(logerror("    %d functions called\n", count));
+	for(i = ss_compiled.prefuncs.first[ss_current_tag]; i < ss_compiled.prefuncs.first[ss_current_tag+1]; i++)
+		ss_compiled.prefuncs.funcs[i]();
 	TRACE(logerror("  copying data\n"));
-	for(m = ss_registry; m; m=m->next) {
-		int i;
-		for(i=0; i<MAX_INSTANCES; i++) {
-			ss_entry *e;
-			for(e = m->instances[i]; e; e=e->next)
-				if(e->tag == ss_current_tag) {
-					if(e->type == SS_INT) {
-						int v = *(int *)(e->data);
-						ss_dump_array[e->offset]   = v ;
-						ss_dump_array[e->offset+1] = v >> 8;
-						ss_dump_array[e->offset+2] = v >> 16;
-						ss_dump_array[e->offset+3] = v >> 24;
-						TRACE(logerror("    %s.%d.%s: %x..%x\n", m->name, i, e->name, e->offset, e->offset+3));
-					} else {
-						memcpy(ss_dump_array + e->offset, e->data, ss_size[e->type]*e->size);
-						TRACE(logerror("    %s.%d.%s: %x..%x\n", m->name, i, e->name, e->offset, e->offset+ss_size[e->type]*e->size-1));
-					}
-				}
-		}
+	end = ss_compiled.copies + ss_compiled.copy_first[ss_current_tag+1];
+	for(c = ss_compiled.copies + ss_compiled.copy_first[ss_current_tag]; c < end; c++) {
+		if(c->type == SS_INT) {
+			int v = *(int *)(c->data);
+			ss_dump_array[c->offset]   = v ;
+			ss_dump_array[c->offset+1] = v >> 8;
+			ss_dump_array[c->offset+2] = v >> 16;
+			ss_dump_array[c->offset+3] = v >> 24;
+		} else
+			memcpy(ss_dump_array + c->offset, c->data, c->length);
+		TRACE(logerror("    %x..%x\n", c->offset, c->offset+c->length-1));
 	}
 }
 
@@ -453,7 +616,9 @@ void state_save_save_finish(void)
 
 	TRACE(logerror("Finishing save\n"));
 
-	signature = ss_get_signature();
+	if (ss_dump_array == NULL)
+		return;
+	signature = ss_compiled.signature;
 	if(Machine->sample_rate == 0.)
 		flags |= SS_NO_SOUND;
 
@@ -472,29 +637,26 @@ void state_save_save_finish(void)
 	ss_dump_array[0x16] = signature >> 16;
 	ss_dump_array[0x17] = signature >> 24;
 
-	mame_fwrite(ss_dump_file, ss_dump_array, ss_dump_size);
-	free(ss_dump_array);
+	if (!ss_dump_external)
+	{
+		mame_fwrite(ss_dump_file, ss_dump_array, ss_dump_size);
+		free(ss_dump_array);
+	}
 	ss_dump_array = 0;
 	ss_dump_size = 0;
 	ss_dump_file = 0;
 }
 
-int state_save_load_begin(mame_file *file)
+/* Check the header of the state in ss_dump_array and set up the entry offsets */
+static int ss_load_header(void)
 {
-	ss_module *m;
-	unsigned int offset;
 	UINT32 signature, file_sig;
 
-	TRACE(logerror("Beginning load\n"));
-
-	signature = ss_get_signature();
-
-	ss_dump_size = mame_fsize(file);
-	ss_dump_array = malloc(ss_dump_size);
-	ss_dump_file = file;
-	mame_fread(ss_dump_file, ss_dump_array, ss_dump_size);
+	if(!ss_compile())
+		goto bad;
+	signature = ss_compiled.signature;
 
-	if(memcmp(ss_dump_array, "MAMESAVE", 8)) {
+	if(ss_dump_size < 0x18 || memcmp(ss_dump_array, "MAMESAVE", 8)) {
 		usrintf_showmessage("Error: This is not a mame save file");
 		goto bad;
 	}
@@ -527,31 +689,64 @@ int state_save_load_begin(mame_file *file)
 			usrintf_showmessage("Warning: Game was saved with sound on, but sound is off.  Result may be interesting.");
 	}
 
-	offset = 0x18;
-	for(m = ss_registry; m; m=m->next) {
-		int i;
-		for(i=0; i<MAX_INSTANCES; i++) {
-			ss_entry *e;
-			for(e = m->instances[i]; e; e=e->next) {
-				e->offset = offset;
-				offset += ss_size[e->type]*e->size;
-			}
-		}
+	if(ss_compiled.size > ss_dump_size) {
+		usrintf_showmessage("Error: Truncated save file");
+		return 1;
 	}
 	return 0;
 
  bad:
-	free(ss_dump_array);
 	return 1;
 }
 
+int state_save_load_begin(mame_file *file)
+{
+	TRACE(logerror("Beginning load\n"));
+
+	ss_dump_size = mame_fsize(file);
+	ss_dump_array = malloc(ss_dump_size);
+	ss_dump_file = file;
+	ss_dump_external = 0;
+	if (ss_dump_array == NULL)
+		return 1;
+	mame_fread(ss_dump_file, ss_dump_array, ss_dump_size);
+
+	if (ss_load_header())
+	{
+		free(ss_dump_array);
+		ss_dump_array = 0;
+		return 1;
+	}
+	return 0;
+}
+
+int state_save_load_begin_mem(const UINT8 *buffer, size_t size)
+{
+	TRACE(logerror("Beginning load from memory\n"));
+
+	/* loads only read from the array */
+	ss_dump_size = size;
+	ss_dump_array = (UINT8 *)buffer;
+	ss_dump_file = 0;
+	ss_dump_external = 1;
+
+	if (ss_load_header())
+	{
+		ss_dump_array = 0;
+		return 1;
+	}
+	return 0;
+}
+
 void state_save_load_continue(void)
 {
-	ss_module *m;
-	ss_func * f;
-	int count = 0;
+	const ss_copy *c, *end;
+	int i;
 	int need_convert;
 
+	if(!ss_compiled.valid || ss_dump_array == NULL || ss_current_tag >= ss_compiled.tags)
+		return;
+
 #ifdef LSB_FIRST
 	need_convert = (ss_dump_array[9] & SS_MSB_FIRST) != 0;
 #else
@@ -560,48 +755,103 @@ void state_save_load_continue(void)
 
 	TRACE(logerror("Loading tag %d\n", ss_current_tag));
 	TRACE(logerror("  copying data\n"));
-	for(m = ss_registry; m; m=m->next) {
-		int i;
-		for(i=0; i<MAX_INSTANCES; i++) {
-			ss_entry *e;
-			for(e = m->instances[i]; e; e=e->next)
-				if(e->tag == ss_current_tag) {
-					if(e->type == SS_INT) {
-						int v;
-						v = ss_dump_array[e->offset]
-							| (ss_dump_array[e->offset+1] << 8)
-							| (ss_dump_array[e->offset+2] << 16)
-							| (ss_dump_array[e->offset+3] << 24);
-						TRACE(logerror("    %s.%d.%s: %x..%x\n", m->name, i, e->name, e->offset, e->offset+3));
-						*(int *)(e->data) = v;
-					} else {
-						memcpy(e->data, ss_dump_array + e->offset, ss_size[e->type]*e->size);
-						if (need_convert && ss_conv[e->type])
-							ss_conv[e->type](e->data, e->size);
-						TRACE(logerror("    %s.%d.%s: %x..%x\n", m->name, i, e->name, e->offset, e->offset+ss_size[e->type]*e->size-1));
-					}
-				}
+	end = ss_compiled.copies + ss_compiled.copy_first[ss_current_tag+1];
+	for(c = ss_compiled.copies + ss_compiled.copy_first[ss_current_tag]; c < end; c++) {
+		if(c->type == SS_INT) {
+			int v;
+			v = ss_dump_array[c->offset]
+				| (ss_dump_array[c->offset+1] << 8)
+				| (ss_dump_array[c->offset+2] << 16)
+				| (ss_dump_array[c->offset+3] << 24);
+			*(int *)(c->data) = v;
+		} else {
+			memcpy(c->data, ss_dump_array + c->offset, c->length);
+			if (need_convert && ss_conv[c->type])
+				ss_conv[c->type](c->data, c->length / ss_size[c->type]);
 		}
+		TRACE(logerror("    %x..%x\n", c->offset, c->offset+c->length-1));
 	}
 	TRACE(logerror("  calling post-load functions\n"));
-	f = ss_postfunc_reg;
-	while(f) {
-		if(f->tag == ss_current_tag) {
-			count++;
-			(f->func)();
-		}
-		f = f->next;
-	}
-	TRACE(logerror("    %d functions called\n", count));
+	for(i = ss_compiled.postfuncs.first[ss_current_tag]; i < ss_compiled.postfuncs.first[ss_current_tag+1]; i++)
+		ss_compiled.postfuncs.funcs[i]();
 }
 
 void state_save_load_finish(void)
 {
 	TRACE(logerror("Finishing load\n"));
-	free(ss_dump_array);
+	if (!ss_dump_external)
+		free(ss_dump_array);
 	ss_dump_array = 0;
 	ss_dump_size = 0;
 	ss_dump_file = 0;
+	ss_dump_external = 0;
+}
+
+static void ss_write_le32(UINT8 *dst, UINT32 v)
+{
+	dst[0] = v;
+	dst[1] = v >> 8;
+	dst[2] = v >> 16;
+	dst[3] = v >> 24;
+}
+
+static UINT32 ss_read_le32(const UINT8 *src)
+{
+	return src[0] | (src[1] << 8) | (src[2] << 16) | ((UINT32)src[3] << 24);
+}
+
+size_t state_save_delta_max_size(size_t size)
+{
+	const size_t pages = (size + SS_DELTA_PAGE - 1) / SS_DELTA_PAGE;
+	return 0x10 + pages * 4 + size;
+}
+
+size_t state_save_delta_encode(const UINT8 *prev, const UINT8 *cur, size_t size, UINT8 *delta)
+{
+	size_t pos = 0x10, offs;
+	UINT32 count = 0;
+
+	for (offs = 0; offs < size; offs += SS_DELTA_PAGE)
+	{
+		const size_t len = (size - offs < SS_DELTA_PAGE) ? (size - offs) : SS_DELTA_PAGE;
+		if (memcmp(prev + offs, cur + offs, len) != 0)
+		{
+			ss_write_le32(delta + pos, (UINT32)(offs / SS_DELTA_PAGE));
+			memcpy(delta + pos + 4, cur + offs, len);
+			pos += 4 + len;
+			count++;
+		}
+	}
+
+	memcpy(delta, "MAMEDLTA", 8);
+	ss_write_le32(delta + 8, (UINT32)size);
+	ss_write_le32(delta + 0xc, count);
+	return pos;
+}
+
+int state_save_delta_apply(UINT8 *state, size_t size, const UINT8 *delta, size_t delta_size)
+{
+	size_t pos = 0x10;
+	UINT32 count;
+
+	if (delta_size < 0x10 || memcmp(delta, "MAMEDLTA", 8) || ss_read_le32(delta + 8) != size)
+		return 1;
+
+	for (count = ss_read_le32(delta + 0xc); count; count--)
+	{
+		size_t offs, len;
+		if (pos + 4 > delta_size)
+			return 1;
+		offs = (size_t)ss_read_le32(delta + pos) * SS_DELTA_PAGE;
+		if (offs >= size)
+			return 1;
+		len = (size - offs < SS_DELTA_PAGE) ? (size - offs) : SS_DELTA_PAGE;
+		if (pos + 4 + len > delta_size)
+			return 1;
+		memcpy(state + offs, delta + pos + 4, len);
+		pos += 4 + len;
+	}
+	return 0;
 }
 
 void state_save_dump_registry(void)
@@ -46,6 +46,19 @@ void state_save_load_continue(void);
 void state_save_save_finish(void);
 void state_save_load_finish(void);
 
+/* Memory save and load: same layout as the save file, in a caller buffer of
+   state_save_get_size() bytes (used instead of the _begin functions above) */
+size_t state_save_get_size(void);
+void state_save_save_begin_mem(UINT8 *buffer);
+int  state_save_load_begin_mem(const UINT8 *buffer, size_t size);
+
+/* Delta snapshots: only the pages of cur that differ from prev (both of the
+   same size), in a buffer of state_save_delta_max_size() bytes. Returns the
+   delta size; apply returns 0 on success */
+size_t state_save_delta_max_size(size_t size);
+size_t state_save_delta_encode(const UINT8 *prev, const UINT8 *cur, size_t size, UINT8 *delta);
+int    state_save_delta_apply(UINT8 *state, size_t size, const UINT8 *delta, size_t delta_size);
+
 /* Display function */
 void state_save_dump_registry(void);
 
@@ -30,12 +30,14 @@
 
 ***************************************************************************/
 
+#include <math.h>
 #include "cpuintrf.h"
 #include "driver.h"
 #include "timer.h"
 
 
-#define MAX_TIMERS 256
+/* timers are allocated in blocks of this many, a new block being added when all are in use */
+#define TIMER_BLOCK_SIZE 256
 
 
 #define VERBOSE 0
@@ -56,18 +58,130 @@
 double cycles_to_sec[MAX_CPU];
 double sec_to_cycles[MAX_CPU];
 
+/* timer pool: the first block is static, further ones are kept for the life of the process */
+struct timer_block
+{
+	struct timer_block *next;
+	mame_timer timers[TIMER_BLOCK_SIZE];
+};
+static struct timer_block timer_block_base;
+static int timer_count = TIMER_BLOCK_SIZE;
+
 /* list of active timers */
-static mame_timer timers[MAX_TIMERS];
+#if TIMER_USE_HEAP
+static mame_timer *timer_heap_base[TIMER_BLOCK_SIZE];
+static mame_timer **timer_heap = timer_heap_base;
+static int timer_heap_count;
+static UINT32 timer_heap_seq;
+#define timer_head timer_heap[0]
+#else
 static mame_timer *timer_head;
+#endif
 static mame_timer *timer_free_head;
 static mame_timer *timer_free_tail;
 
 /* other internal states */
-static double global_offset;
+static mame_time global_offset;
+
+/* emulated time published for the other threads, under a sequence lock (odd while being updated) */
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define TIMER_SEQ_INCREMENT(p)	_InterlockedIncrement((volatile long *)(p))
+#define TIMER_SEQ_READ(p)		_InterlockedOr((volatile long *)(p), 0)
+#else
+#define TIMER_SEQ_INCREMENT(p)	__sync_add_and_fetch((p), 1)
+#define TIMER_SEQ_READ(p)		__sync_fetch_and_or((p), 0)
+#endif
+static volatile long published_seq;
+static volatile double published_time;
+static volatile double published_slice;
+static volatile cycles_t published_host;
+static void timer_publish_time(double slice);
 static mame_timer *callback_timer;
 static int callback_timer_modified;
 static double callback_timer_expire_time;
 
+/* per callback counters */
+struct callback_stats
+{
+	const char *name;     /* as passed to _timer_alloc, to spot the same call site quickly */
+	char label[32];       /* cleaned up name, shared by all call sites of a callback */
+	UINT64 fires;
+	int profiler;         /* profiler section */
+};
+static struct callback_stats callback_stats[TIMER_MAX_CALLBACK_STATS];
+static int callback_stats_count;
+
+
+
+/*-------------------------------------------------
+	mame_time helpers - conversion and arithmetic
+	for the absolute time base
+-------------------------------------------------*/
+
+mame_time double_to_mame_time(double t)
+{
+	mame_time result;
+
+	/* TIME_NEVER and friends saturate instead of overflowing */
+	if (t >= 9.0e18)
+	{
+		result.seconds = (INT64)9000000000000000000LL;
+		result.attoseconds = 0;
+		return result;
+	}
+	result.seconds = (INT64)floor(t);
+	result.attoseconds = (INT64)((t - (double)result.seconds) * (double)ATTOSECONDS_PER_SECOND);
+	if (result.attoseconds >= ATTOSECONDS_PER_SECOND)
+	{
+		result.seconds++;
+		result.attoseconds -= ATTOSECONDS_PER_SECOND;
+	}
+	else if (result.attoseconds < 0)
+		result.attoseconds = 0;
+	return result;
+}
+
+double mame_time_to_double(mame_time t)
+{
+	return (double)t.seconds + (double)t.attoseconds * (1.0 / (double)ATTOSECONDS_PER_SECOND);
+}
+
+mame_time add_mame_times(mame_time a, mame_time b)
+{
+	mame_time result;
+	result.seconds = a.seconds + b.seconds;
+	result.attoseconds = a.attoseconds + b.attoseconds;
+	if (result.attoseconds >= ATTOSECONDS_PER_SECOND)
+	{
+		result.seconds++;
+		result.attoseconds -= ATTOSECONDS_PER_SECOND;
+	}
+	return result;
+}
+
+mame_time sub_mame_times(mame_time a, mame_time b)
+{
+	mame_time result;
+	result.seconds = a.seconds - b.seconds;
+	result.attoseconds = a.attoseconds - b.attoseconds;
+	if (result.attoseconds < 0)
+	{
+		result.seconds--;
+		result.attoseconds += ATTOSECONDS_PER_SECOND;
+	}
+	return result;
+}
+
+int compare_mame_times(mame_time a, mame_time b)
+{
+	if (a.seconds != b.seconds)
+		return (a.seconds < b.seconds) ? -1 : 1;
+	if (a.attoseconds != b.attoseconds)
+		return (a.attoseconds < b.attoseconds) ? -1 : 1;
+	return 0;
+}
+
 
 
 /*-------------------------------------------------
@@ -94,6 +208,75 @@ INLINE double get_relative_time(void)
 
 
 
+/*-------------------------------------------------
+	timer_block_reset - mark all timers of a block
+	inactive and append them to the free list
+-------------------------------------------------*/
+
+static void timer_block_reset(struct timer_block *block)
+{
+	int i;
+
+	memset(block->timers, 0, sizeof(block->timers));
+	for (i = 0; i < TIMER_BLOCK_SIZE; i++)
+	{
+		block->timers[i].tag = -1;
+#if TIMER_USE_HEAP
+		block->timers[i].heap_index = -1;
+#endif
+		block->timers[i].next = (i < TIMER_BLOCK_SIZE-1) ? &block->timers[i+1] : NULL;
+	}
+
+	if (timer_free_tail)
+		timer_free_tail->next = &block->timers[0];
+	else
+		timer_free_head = &block->timers[0];
+	timer_free_tail = &block->timers[TIMER_BLOCK_SIZE-1];
+}
+
+
+
+/*-------------------------------------------------
+	timer_add_block - grow the pool when all the
+	timers are in use
+-------------------------------------------------*/
+
+static int timer_add_block(void)
+{
+	struct timer_block *block = malloc(sizeof(*block)), *last;
+
+	if (!block)
+		return 0;
+
+#if TIMER_USE_HEAP
+	/* the heap must be able to hold every timer */
+	{
+		mame_timer **heap = malloc((timer_count + TIMER_BLOCK_SIZE) * sizeof(*heap));
+		if (!heap)
+		{
+			free(block);
+			return 0;
+		}
+		memcpy(heap, timer_heap, timer_heap_count * sizeof(*heap));
+		if (timer_heap != timer_heap_base)
+			free(timer_heap);
+		timer_heap = heap;
+	}
+#endif
+
+	block->next = NULL;
+	for (last = &timer_block_base; last->next; last = last->next)
+		;
+	last->next = block;
+	timer_count += TIMER_BLOCK_SIZE;
+
+	timer_block_reset(block);
+	LOG(("timer_add_block: %d timers\n", timer_count));
+	return 1;
+}
+
+
+
 /*-------------------------------------------------
 	timer_new - allocate a new timer
 -------------------------------------------------*/
@@ -102,8 +285,8 @@ INLINE mame_timer *timer_new(void)
 {
 	mame_timer *timer;
 
-	/* remove an empty entry */
-	if (!timer_free_head)
+	/* remove an empty entry, growing the pool if needed */
+	if (!timer_free_head && !timer_add_block())
 		return NULL;
 	timer = timer_free_head;
 	timer_free_head = timer->next;
@@ -115,6 +298,124 @@ INLINE mame_timer *timer_new(void)
 
 
 
+#if TIMER_USE_HEAP
+
+/*-------------------------------------------------
+	timer_heap_before - heap ordering; like the
+	list, expire times within 1ns of each other
+	fire in the order they were inserted
+-------------------------------------------------*/
+
+INLINE int timer_heap_before(const mame_timer *a, const mame_timer *b)
+{
+	const double diff = b->heap_key - a->heap_key;
+	if (diff > TIME_IN_NSEC(1))
+		return 1;
+	if (diff < -TIME_IN_NSEC(1))
+		return 0;
+	return (INT32)(a->heap_seq - b->heap_seq) < 0;
+}
+
+
+
+/*-------------------------------------------------
+	timer_heap_up/down - restore the heap order
+	after the entry at index has moved
+-------------------------------------------------*/
+
+INLINE void timer_heap_up(int index)
+{
+	mame_timer *timer = timer_heap[index];
+
+	while (index > 0)
+	{
+		const int parent = (index - 1) >> 1;
+		if (!timer_heap_before(timer, timer_heap[parent]))
+			break;
+		timer_heap[index] = timer_heap[parent];
+		timer_heap[index]->heap_index = index;
+		index = parent;
+	}
+	timer_heap[index] = timer;
+	timer->heap_index = index;
+}
+
+INLINE void timer_heap_down(int index)
+{
+	mame_timer *timer = timer_heap[index];
+
+	for (;;)
+	{
+		int child = 2 * index + 1;
+		if (child >= timer_heap_count)
+			break;
+		if (child + 1 < timer_heap_count && timer_heap_before(timer_heap[child + 1], timer_heap[child]))
+			child++;
+		if (!timer_heap_before(timer_heap[child], timer))
+			break;
+		timer_heap[index] = timer_heap[child];
+		timer_heap[index]->heap_index = index;
+		index = child;
+	}
+	timer_heap[index] = timer;
+	timer->heap_index = index;
+}
+
+
+
+/*-------------------------------------------------
+	timer_list_insert - insert a new timer into
+	the heap at the appropriate location
+-------------------------------------------------*/
+
+INLINE void timer_list_insert(mame_timer *timer)
+{
+	/* sanity checks for the debug build */
+	#ifdef MAME_DEBUG
+	if (timer->heap_index >= 0)
+		printf("This timer is already inserted in the list!\n");
+	if (timer_heap_count >= timer_count)
+		printf("Timer list is full!\n");
+	#endif
+
+	timer->heap_key = timer->enabled ? timer->expire : TIME_NEVER;
+	timer->heap_seq = timer_heap_seq++;
+	timer_heap[timer_heap_count] = timer;
+	timer_heap_up(timer_heap_count++);
+}
+
+
+
+/*-------------------------------------------------
+	timer_list_remove - remove a timer from the
+	heap
+-------------------------------------------------*/
+
+INLINE void timer_list_remove(mame_timer *timer)
+{
+	const int index = timer->heap_index;
+
+	/* sanity checks for the debug build */
+	#ifdef MAME_DEBUG
+	if (index < 0 || index >= timer_heap_count || timer_heap[index] != timer)
+		printf("Timer not found in list");
+	#endif
+
+	timer->heap_index = -1;
+
+	/* move the last entry into the hole and let it find its place */
+	if (index != --timer_heap_count)
+	{
+		timer_heap[index] = timer_heap[timer_heap_count];
+		if (index > 0 && timer_heap_before(timer_heap[index], timer_heap[(index - 1) >> 1]))
+			timer_heap_up(index);
+		else
+			timer_heap_down(index);
+	}
+}
+
+#else
+
 /*-------------------------------------------------
 	timer_list_insert - insert a new timer into
 	the list at the appropriate location
@@ -135,7 +436,7 @@ INLINE void timer_list_insert(mame_timer *timer)
 		{
 			if (t == timer)
 				printf("This timer is already inserted in the list!\n");
-			if (tnum == MAX_TIMERS-1)
+			if (tnum == timer_count-1)
 				printf("Timer list is full!\n");
 		}
 	}
@@ -203,6 +504,8 @@ INLINE void timer_list_remove(mame_timer *timer)
 		timer->next->prev = timer->prev;
 }
 
+#endif /* TIMER_USE_HEAP */
+
 
 
 /*-------------------------------------------------
@@ -211,26 +514,31 @@ INLINE void timer_list_remove(mame_timer *timer)
 
 void timer_init(void)
 {
-	int i;
+	struct timer_block *block;
 
 	/* we need to wait until the first call to timer_cyclestorun before using real CPU times */
-	global_offset = 0.0;
+	global_offset.seconds = 0;
+	global_offset.attoseconds = 0;
+	timer_publish_time(0.);
 	callback_timer = NULL;
 	callback_timer_modified = 0;
 
-	/* reset the timers */
-	memset(timers, 0, sizeof(timers));
+	/* reset the per callback counters */
+	callback_stats_count = 0;
+	memset(callback_stats, 0, sizeof(callback_stats));
 
 	/* initialize the lists */
+#if TIMER_USE_HEAP
+	timer_heap_count = 0;
+	timer_heap_seq = 0;
+#else
 	timer_head = NULL;
-	timer_free_head = &timers[0];
-	for (i = 0; i < MAX_TIMERS-1; i++)
-	{
-		timers[i].tag = -1;
-		timers[i].next = &timers[i+1];
-	}
-	timers[MAX_TIMERS-1].next = NULL;
-	timer_free_tail = &timers[MAX_TIMERS-1];
+#endif
+
+	/* reset the timers of all the blocks grown so far */
+	timer_free_head = timer_free_tail = NULL;
+	for (block = &timer_block_base; block; block = block->next)
+		timer_block_reset(block);
 }
 
 
@@ -243,6 +551,16 @@ void timer_init(void)
 void timer_free(void)
 {
 	int tag = get_resource_tag();
+#if TIMER_USE_HEAP
+	struct timer_block *block;
+	int i;
+
+	/* every allocated timer is queued, so scan the pool (the heap reorders on removal) */
+	for (block = &timer_block_base; block; block = block->next)
+		for (i = 0; i < TIMER_BLOCK_SIZE; i++)
+			if (block->timers[i].tag == tag && block->timers[i].heap_index >= 0)
+				timer_remove(&block->timers[i]);
+#else
 	mame_timer *timer, *next;
 
 	/* scan the list */
@@ -255,6 +573,7 @@ void timer_free(void)
 		if (timer->tag == tag)
 			timer_remove(timer);
 	}
+#endif
 }
 
 
@@ -272,6 +591,22 @@ double timer_time_until_next_timer(void)
 
 
 
+/*-------------------------------------------------
+	timer_publish_time - make the current global
+	time available to the other threads
+-------------------------------------------------*/
+
+static void timer_publish_time(double slice)
+{
+	TIMER_SEQ_INCREMENT(&published_seq);
+	published_time = mame_time_to_double(global_offset);
+	published_slice = slice;
+	published_host = osd_cycles();
+	TIMER_SEQ_INCREMENT(&published_seq);
+}
+
+
+
 /*-------------------------------------------------
 	timer_adjust_global_time - adjust the global
 	time; this is also where we fire the timers
@@ -282,14 +617,29 @@ void timer_adjust_global_time(double delta)
 	mame_timer *timer;
 
 	/* add the delta to the global offset */
-	global_offset += delta;
+	global_offset = add_mame_times(global_offset, double_to_mame_time(delta));
+	timer_publish_time(delta);
 
 	/* scan the list and adjust the times */
+#if TIMER_USE_HEAP
+	{
+		int i;
+		/* a uniform shift keeps the heap order intact */
+		for (i = 0; i < timer_heap_count; i++)
+		{
+			timer = timer_heap[i];
+			timer->start -= delta;
+			timer->expire -= delta;
+			timer->heap_key -= delta;
+		}
+	}
+#else
 	for (timer = timer_head; timer != NULL; timer = timer->next)
 	{
 		timer->start -= delta;
 		timer->expire -= delta;
 	}
+#endif
 
 	LOG(("timer_adjust_global_time: delta=%.9f head->expire=%.9f\n", delta, timer_head->expire));
 
@@ -312,7 +662,8 @@ void timer_adjust_global_time(double delta)
 		if (was_enabled && timer->callback)
 		{
 			LOG(("Timer %08X fired (expire=%.9f)\n", (UINT32)timer, timer->expire));
-			profiler_mark(PROFILER_TIMER_CALLBACK);
+			callback_stats[timer->callback_stats].fires++;
+			profiler_mark(callback_stats[timer->callback_stats].profiler);
 			(*timer->callback)(timer->callback_param);
 			profiler_mark(PROFILER_END);
 		}
@@ -342,12 +693,87 @@ void timer_adjust_global_time(double delta)
 
 
 
+/*-------------------------------------------------
+	get_callback_stats - find or add the counters
+	for a callback name
+-------------------------------------------------*/
+
+static int get_callback_stats(const char *name)
+{
+	const char *site = name;
+	char label[sizeof(callback_stats[0].label)];
+	int i, len;
+
+	/* same call site as before: the name is the same string */
+	for (i = 0; i < callback_stats_count; i++)
+		if (callback_stats[i].name == site)
+			return i;
+
+	/* "&timer_callback" and "(void (*)(int))timer_callback" are the same callback */
+	if (name == NULL)
+		name = "?";
+	if (*name == '(')
+	{
+		const char *end = strrchr(name, ')');
+		if (end)
+			name = end + 1;
+	}
+	while (*name == '&' || *name == ' ')
+		name++;
+	for (len = 0; name[len] && len < (int)sizeof(label) - 1; len++)
+		label[len] = name[len];
+	label[len] = 0;
+
+	for (i = 0; i < callback_stats_count; i++)
+		if (!strcmp(callback_stats[i].label, label))
+			return i;
+
+	/* the last entry collects the callbacks we run out of entries for */
+	if (callback_stats_count >= TIMER_MAX_CALLBACK_STATS - 1)
+	{
+		site = NULL;
+		strcpy(label, "other");
+		if (callback_stats_count == TIMER_MAX_CALLBACK_STATS)
+			return TIMER_MAX_CALLBACK_STATS - 1;
+	}
+
+	i = callback_stats_count++;
+	callback_stats[i].name = site;
+	strcpy(callback_stats[i].label, label);
+	callback_stats[i].fires = 0;
+	callback_stats[i].profiler = profiler_label(callback_stats[i].label, PROFILER_TIMER_CALLBACK);
+	return i;
+}
+
+
+
+/*-------------------------------------------------
+	timer_get_callback_stats - the counters for
+	one callback, returns 0 past the last one
+-------------------------------------------------*/
+
+int timer_get_callback_stats(int index, const char **name, UINT64 *fires, double *seconds)
+{
+	if (index < 0 || index >= callback_stats_count)
+		return 0;
+
+	if (name)
+		*name = callback_stats[index].label;
+	if (fires)
+		*fires = callback_stats[index].fires;
+	if (seconds)
+		*seconds = (callback_stats[index].profiler != PROFILER_TIMER_CALLBACK) ? profiler_get_total(callback_stats[index].profiler, NULL) : 0.;
+	return 1;
+}
+
+
+
 /*-------------------------------------------------
 	timer_alloc - allocate a permament timer that
 	isn't primed yet
 -------------------------------------------------*/
 
-mame_timer *timer_alloc(void (*callback)(int))
+mame_timer *_timer_alloc(void (*callback)(int), const char *name)
 {
 	double time = get_relative_time();
 	mame_timer *timer = timer_new();
@@ -359,6 +785,7 @@ mame_timer *timer_alloc(void (*callback)(int))
 	/* fill in the record */
 	timer->callback = callback;
 	timer->callback_param = 0;
+	timer->callback_stats = get_callback_stats(name);
 	timer->enabled = 0;
 	timer->temporary = 0;
 	timer->tag = get_resource_tag();
@@ -420,9 +847,9 @@ LOG(("timer_adjust %08X to expire @ %.9f\n", (UINT32)which, which->expire));
 	period
 -------------------------------------------------*/
 
-void timer_pulse(double period, int param, void (*callback)(int))
+void _timer_pulse(double period, int param, void (*callback)(int), const char *name)
 {
-	mame_timer *timer = timer_alloc(callback);
+	mame_timer *timer = _timer_alloc(callback, name);
 
 	/* fail if we can't allocate */
 	if (!timer)
@@ -439,9 +866,9 @@ void timer_pulse(double period, int param, void (*callback)(int))
 	calls the callback after the given duration
 -------------------------------------------------*/
 
-void timer_set(double duration, int param, void (*callback)(int))
+void _timer_set(double duration, int param, void (*callback)(int), const char *name)
 {
-	mame_timer *timer = timer_alloc(callback);
+	mame_timer *timer = _timer_alloc(callback, name);
 
 	/* fail if we can't allocate */
 	if (!timer)
@@ -551,7 +978,51 @@ double timer_timeleft(mame_timer *which)
 
 double timer_get_time(void)
 {
-	return global_offset + get_relative_time();
+	return mame_time_to_double(timer_get_time_mame());
+}
+
+mame_time timer_get_time_mame(void)
+{
+	return add_mame_times(global_offset, double_to_mame_time(get_relative_time()));
+}
+
+
+
+/*-------------------------------------------------
+	timer_get_published_time - return the time of
+	the last timeslice boundary, from any thread
+-------------------------------------------------*/
+
+double timer_get_published_time(void)
+{
+	long seq;
+	double time;
+	do
+	{
+		seq = TIMER_SEQ_READ(&published_seq);
+		time = published_time;
+	} while ((seq & 1) || seq != TIMER_SEQ_READ(&published_seq));
+	return time;
+}
+
+double timer_get_extrapolated_time(void)
+{
+	long seq;
+	double time, slice;
+	cycles_t host;
+	do
+	{
+		seq = TIMER_SEQ_READ(&published_seq);
+		time = published_time;
+		slice = published_slice;
+		host = published_host;
+	} while ((seq & 1) || seq != TIMER_SEQ_READ(&published_seq));
+
+	/* timeslices have roughly the same length, so this mostly stays behind the next published time */
+	{
+		const double elapsed = (double)(osd_cycles() - host) / (double)osd_cycles_per_second();
+		return time + (elapsed < slice ? (elapsed > 0. ? elapsed : 0.) : slice);
+	}
 }
 
 
@@ -563,7 +1034,7 @@ double timer_get_time(void)
 
 double timer_starttime(mame_timer *which)
 {
-	return global_offset + which->start;
+	return mame_time_to_double(add_mame_times(global_offset, double_to_mame_time(which->start)));
 }
 
 
@@ -575,7 +1046,7 @@ double timer_starttime(mame_timer *which)
 
 double timer_firetime(mame_timer *which)
 {
-	return global_offset + which->expire;
+	return mame_time_to_double(add_mame_times(global_offset, double_to_mame_time(which->expire)));
 }
 
 #ifdef PINMAME
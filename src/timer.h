@@ -34,6 +34,35 @@ extern double sec_to_cycles[];
 
 #define TIME_TO_CYCLES(cpu,t) ((int)((t) * sec_to_cycles[cpu] + 0.5)) // round
 
+/*-------------------------------------------------
+	absolute time base: relative times (durations,
+	CPU local times, timer expirations) stay small
+	and are kept as double seconds, but the global
+	emulated time grows without bound, so it is
+	accumulated as integer seconds + attoseconds
+	and only converted to double at the API edge
+-------------------------------------------------*/
+
+#define ATTOSECONDS_PER_SECOND ((INT64)1000000000 * (INT64)1000000000)
+
+typedef struct
+{
+	INT64 seconds;
+	INT64 attoseconds;    /* always 0 .. ATTOSECONDS_PER_SECOND-1 */
+} mame_time;
+
+mame_time double_to_mame_time(double t);
+double mame_time_to_double(mame_time t);
+mame_time add_mame_times(mame_time a, mame_time b);
+mame_time sub_mame_times(mame_time a, mame_time b);
+int compare_mame_times(mame_time a, mame_time b);
+
+/* active timers are kept in a binary min-heap (O(log n) rearm) instead of the */
+/* classic sorted doubly linked list; define as 0 to get the list back for A/B tests */
+#ifndef TIMER_USE_HEAP
+#define TIMER_USE_HEAP        1
+#endif
+
 /*-------------------------------------------------
 	internal timer structure
 -------------------------------------------------*/
@@ -42,8 +71,14 @@ struct _mame_timer
 {
 	struct _mame_timer *next;
 	struct _mame_timer *prev;
+#if TIMER_USE_HEAP
+	int heap_index;       /* slot in the heap, -1 if not queued */
+	UINT32 heap_seq;      /* insertion order, breaks ties between equal expire times */
+	double heap_key;      /* expire time the heap is ordered on (TIME_NEVER if disabled) */
+#endif
 	void (*callback)(int);
 	int callback_param;
+	int callback_stats;   /* index in the per callback counters (timer_get_callback_stats) */
 	int tag;
 	UINT8 enabled;
 	UINT8 temporary;
@@ -59,16 +94,23 @@ void timer_init(void);
 void timer_free(void);
 double timer_time_until_next_timer(void);
 void timer_adjust_global_time(double delta);
-mame_timer *timer_alloc(void (*callback)(int));
+/* the callback name is recorded with each timer, for the per callback counters */
+mame_timer *_timer_alloc(void (*callback)(int), const char *name);
 void timer_adjust(mame_timer *which, double duration, int param, double period);
-void timer_pulse(double period, int param, void (*callback)(int));
-void timer_set(double duration, int param, void (*callback)(int));
+void _timer_pulse(double period, int param, void (*callback)(int), const char *name);
+void _timer_set(double duration, int param, void (*callback)(int), const char *name);
+
+#define timer_alloc(callback)                 _timer_alloc(callback, #callback)
+#define timer_pulse(period, param, callback)  _timer_pulse(period, param, callback, #callback)
+#define timer_set(duration, param, callback)  _timer_set(duration, param, callback, #callback)
+
 void timer_reset(mame_timer *which, double duration);
 void timer_remove(mame_timer *which);
 int timer_enable(mame_timer *which, int enable);
 double timer_timeelapsed(mame_timer *which);
 double timer_timeleft(mame_timer *which);
 double timer_get_time(void);
+mame_time timer_get_time_mame(void);
 double timer_starttime(mame_timer *which);
 double timer_firetime(mame_timer *which);
 
@@ -78,6 +120,16 @@ int timer_param(mame_timer *which);
 int timer_enabled(mame_timer *which);
 #endif
 
+/* emulated time as published at the last timeslice boundary, safe to call from any thread; */
+/* the extrapolated variant adds the host time elapsed since, up to the length of the last timeslice */
+double timer_get_published_time(void);
+double timer_get_extrapolated_time(void);
+
+/* per callback counters since timer_init: one entry per callback name, with */
+/* the number of calls and, while profiler totals are on, the time spent in it */
+#define TIMER_MAX_CALLBACK_STATS 128
+int timer_get_callback_stats(int index, const char **name, UINT64 *fires, double *seconds);
+
 #ifdef __cplusplus
 }
 #endif
@@ -96,6 +96,8 @@ struct rc_option pinmame_opts[] = {
 #ifdef PINMAME_HOST_UART
 	{ "serial_device", NULL, rc_string, &pmoptions.serial_device, NULL, 0, 0, NULL, "/dev/tty serial port mapped to WPC UART" },
 #endif
+	{ "soundrip", NULL, rc_bool, &pmoptions.soundrip, "0", 0, 0, NULL, "Dump every sound command to its own wave file plus an altsound CSV unthrottled, then exit" },
+	{ "soundrip_prefix", NULL, rc_int, &pmoptions.soundrip_prefix, "-1", -1, 255, NULL, "First byte sent before each ripped sound command (-1 = none)" },
 	{ NULL,	NULL, rc_end, NULL, NULL, 0, 0,	NULL, NULL }
 };
 #endif /* PINMAME */
@@ -369,6 +371,12 @@ int config_init (int argc, char *argv[])
 			return OSD_NOT_OK;
 	}
 
+#ifdef PINMAME
+	/* the sound ripper runs as fast as the machine allows */
+	if (pmoptions.soundrip)
+		throttle = 0;
+#endif /* PINMAME */
+
 	/* setup stderr_file and stdout_file */
 	if (!stderr_file) stderr_file = stderr;
 	if (!stdout_file) stdout_file = stdout;
@@ -129,28 +129,33 @@ int uart_baudrate(data32_t baudrate)
 }
 
 
-int uart_getch(void)
+int uart_read(data8_t *buffer, int size)
 {
-    data8_t value;
+    ssize_t count = read(uart_fd, buffer, size);
 
-    if (read(uart_fd, &value, 1) == -1) {
+    if (count == -1) {
         if (errno == EAGAIN) {
-            return -EAGAIN;
+            return 0;
         }
         ERRMSG("%s: error %d\n", __FUNCTION__, errno);
         return -errno;
     }
 
-    return value;
+    return (int)count;
 }
 
 
-int uart_putch(data8_t value)
+int uart_write(const data8_t *buffer, int size)
 {
-    if (write(uart_fd, &value, 1) < 0) {
+    ssize_t count = write(uart_fd, buffer, size);
+
+    if (count < 0) {
+        if (errno == EAGAIN) {
+            return 0;
+        }
         ERRMSG("%s: error %d\n", __FUNCTION__, errno);
         return -errno;
     }
     
-    return 0;
+    return (int)count;
 }
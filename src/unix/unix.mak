@@ -58,6 +58,7 @@ LIBS.svgafx     = $(X11LIB) -lvga -lvgagl -lglide2x
 LIBS.openstep	= -framework AppKit
 LIBS.sdl        = $(X11LIB) `$(SDL_CONFIG) --libs`
 LIBS.photon2	= -L/usr/lib -lph -lphrender
+LIBS.kmsdrm     = `pkg-config --libs libdrm`
 
 CFLAGS.x11      = $(X11INC) $(JOY_X11_CFLAGS) $(XINPUT_DEVICES_CFLAGS)
 CFLAGS.xgl      = $(X11INC) $(JOY_X11_CFLAGS) $(GLCFLAGS)
@@ -65,6 +66,7 @@ CFLAGS.xfx      = $(X11INC) $(JOY_X11_CFLAGS) -I/usr/include/glide
 CFLAGS.svgafx   = -I/usr/include/glide
 CFLAGS.sdl      = $(X11INC) `$(SDL_CONFIG) --cflags` -D_REENTRANT
 CFLAGS.photon2	=
+CFLAGS.kmsdrm   = `pkg-config --cflags libdrm`
 
 ifdef X11_DGA
 INST.x11        = doinstallsuid
@@ -78,6 +80,7 @@ INST.xfx        = doinstallsuid
 INST.svgafx     = doinstallsuid
 INST.sdl        = doinstall
 INST.photon2	= doinstall
+INST.kmsdrm     = doinstall
 
 # handle X11 display method additonal settings
 ifdef X11_MITSHM
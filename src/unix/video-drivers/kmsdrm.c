@@ -0,0 +1,465 @@
+/***************************************************************************
+
+ Linux KMS/DRM display driver, for cabinets running without X.
+
+ The display is driven directly through the kernel modesetting API (libdrm):
+ two dumb buffers are allocated in the scanout format of the selected output,
+ the emulated bitmap is blitted into the one not being scanned out and a page
+ flip to it is queued, which the kernel performs on the next vblank. There is
+ no compositor and no intermediate copy: the dumb buffers are mapped and
+ written to directly (scaled lines are built in a line buffer, as reading back
+ from scanout memory is slow). Before drawing into a buffer, the flip away from it is
+ waited for, so the emulation is synced to the display refresh.
+
+ There is no keyboard or mouse handling, the switches of a cabinet come from
+ its own hardware (P-ROC, LISY, ...).
+
+***************************************************************************/
+#define __KMSDRM_C
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <xf86drm.h>
+#include <xf86drmMode.h>
+#include "xmame.h"
+#include "effect.h"
+
+struct kmsdrm_buffer
+{
+   unsigned int handle;
+   unsigned int fb_id;
+   unsigned int pitch;
+   unsigned long size;
+   unsigned char *map;
+};
+
+static char *drm_device = NULL;
+static int drm_connector_id = -1;
+static int drm_fd = -1;
+static unsigned int crtc_id;
+static unsigned int connector_id;
+static drmModeModeInfo mode;
+static drmModeCrtc *saved_crtc = NULL;
+static struct kmsdrm_buffer buffers[2];
+static int back_buffer;
+static int flip_pending;
+static int flip_warned;
+static int startx, starty;
+static unsigned char *doublebuffer_buffer = NULL;
+
+typedef void (*update_func_t)(struct mame_bitmap *bitmap, unsigned int *dest, int dest_width);
+
+static update_func_t update_function;
+
+struct rc_option display_opts[] = {
+   /* name, shortname, type, dest, deflt, min, max, func, help */
+   { "KMS/DRM Related",	NULL,			rc_seperator,	NULL,
+     NULL,		0,			0,		NULL,
+     NULL },
+   { "drmdevice",	NULL,			rc_string,	&drm_device,
+     "/dev/dri/card0",	0,			0,		NULL,
+     "DRM device to use" },
+   { "drmconnector",	NULL,			rc_int,		&drm_connector_id,
+     "-1",		0,			0,		NULL,
+     "Id of the connector (output) to use, -1 for the first connected one" },
+   { NULL,		NULL,			rc_link,	mode_opts,
+     NULL,		0,			0,		NULL,
+     NULL },
+   { NULL,		NULL,			rc_end,		NULL,
+     NULL,		0,			0,		NULL,
+     NULL }
+};
+
+static void kmsdrm_update_16_to_32bpp(struct mame_bitmap *bitmap, unsigned int *dest, int dest_width)
+{
+#define INDIRECT current_palette->lookup
+#define SRC_PIXEL unsigned short
+#define DEST_PIXEL unsigned int
+#define DEST dest
+#define DEST_WIDTH dest_width
+#define DOUBLEBUFFER
+#include "blit.h"
+#undef DOUBLEBUFFER
+#undef DEST_WIDTH
+#undef DEST
+#undef DEST_PIXEL
+#undef SRC_PIXEL
+#undef INDIRECT
+}
+
+static void kmsdrm_update_rgb_direct_32bpp(struct mame_bitmap *bitmap, unsigned int *dest, int dest_width)
+{
+#define SRC_PIXEL unsigned int
+#define DEST_PIXEL unsigned int
+#define DEST dest
+#define DEST_WIDTH dest_width
+#define DOUBLEBUFFER
+#include "blit.h"
+#undef DOUBLEBUFFER
+#undef DEST_WIDTH
+#undef DEST
+#undef DEST_PIXEL
+#undef SRC_PIXEL
+}
+
+static int kmsdrm_create_buffer(struct kmsdrm_buffer *buffer)
+{
+   struct drm_mode_create_dumb create;
+   struct drm_mode_map_dumb map;
+   struct drm_mode_destroy_dumb destroy;
+
+   memset(&create, 0, sizeof(create));
+   create.width  = mode.hdisplay;
+   create.height = mode.vdisplay;
+   create.bpp    = 32;
+   if (drmIoctl(drm_fd, DRM_IOCTL_MODE_CREATE_DUMB, &create) < 0)
+   {
+      fprintf(stderr_file, "KMS/DRM: Error: unable to create a %dx%d buffer: %s\n",
+         mode.hdisplay, mode.vdisplay, strerror(errno));
+      return OSD_NOT_OK;
+   }
+   buffer->handle = create.handle;
+   buffer->pitch  = create.pitch;
+   buffer->size   = create.size;
+
+   if (drmModeAddFB(drm_fd, mode.hdisplay, mode.vdisplay, 24, 32, buffer->pitch,
+          buffer->handle, &buffer->fb_id))
+   {
+      fprintf(stderr_file, "KMS/DRM: Error: unable to add a framebuffer: %s\n", strerror(errno));
+      goto error;
+   }
+
+   memset(&map, 0, sizeof(map));
+   map.handle = buffer->handle;
+   if (drmIoctl(drm_fd, DRM_IOCTL_MODE_MAP_DUMB, &map) < 0)
+   {
+      fprintf(stderr_file, "KMS/DRM: Error: unable to map a buffer: %s\n", strerror(errno));
+      goto error;
+   }
+   buffer->map = mmap(NULL, buffer->size, PROT_READ | PROT_WRITE, MAP_SHARED, drm_fd, map.offset);
+   if (buffer->map == MAP_FAILED)
+   {
+      buffer->map = NULL;
+      fprintf(stderr_file, "KMS/DRM: Error: unable to map a buffer: %s\n", strerror(errno));
+      goto error;
+   }
+   memset(buffer->map, 0, buffer->size);
+   return OSD_OK;
+
+error:
+   if (buffer->fb_id)
+      drmModeRmFB(drm_fd, buffer->fb_id);
+   memset(&destroy, 0, sizeof(destroy));
+   destroy.handle = buffer->handle;
+   drmIoctl(drm_fd, DRM_IOCTL_MODE_DESTROY_DUMB, &destroy);
+   memset(buffer, 0, sizeof(*buffer));
+   return OSD_NOT_OK;
+}
+
+static void kmsdrm_destroy_buffer(struct kmsdrm_buffer *buffer)
+{
+   struct drm_mode_destroy_dumb destroy;
+
+   if (!buffer->handle)
+      return;
+   if (buffer->map)
+      munmap(buffer->map, buffer->size);
+   if (buffer->fb_id)
+      drmModeRmFB(drm_fd, buffer->fb_id);
+   memset(&destroy, 0, sizeof(destroy));
+   destroy.handle = buffer->handle;
+   drmIoctl(drm_fd, DRM_IOCTL_MODE_DESTROY_DUMB, &destroy);
+   memset(buffer, 0, sizeof(*buffer));
+}
+
+static void kmsdrm_flip_handler(int fd, unsigned int frame, unsigned int sec,
+   unsigned int usec, void *data)
+{
+   flip_pending = 0;
+}
+
+/* wait for the queued page flip, after which the back buffer is not scanned out anymore */
+static void kmsdrm_wait_flip(void)
+{
+   drmEventContext evctx;
+   struct pollfd pfd;
+
+   memset(&evctx, 0, sizeof(evctx));
+   evctx.version = 2;
+   evctx.page_flip_handler = kmsdrm_flip_handler;
+   pfd.fd = drm_fd;
+   pfd.events = POLLIN;
+   while (flip_pending)
+   {
+      pfd.revents = 0;
+      if (poll(&pfd, 1, 1000) < 0)
+      {
+         if (errno == EINTR)
+            continue;
+         break;
+      }
+      if (pfd.revents & POLLIN)
+         drmHandleEvent(drm_fd, &evctx);
+      else /* no vblank for a second, the output is gone, don't hang */
+         break;
+   }
+   flip_pending = 0;
+}
+
+/* find a crtc which can drive the connector, preferring the one it is attached to */
+static int kmsdrm_find_crtc(drmModeRes *resources, drmModeConnector *connector)
+{
+   drmModeEncoder *encoder;
+   int i, j;
+
+   if (connector->encoder_id)
+   {
+      encoder = drmModeGetEncoder(drm_fd, connector->encoder_id);
+      if (encoder)
+      {
+         if (encoder->crtc_id)
+         {
+            crtc_id = encoder->crtc_id;
+            drmModeFreeEncoder(encoder);
+            return OSD_OK;
+         }
+         drmModeFreeEncoder(encoder);
+      }
+   }
+
+   for (i = 0; i < connector->count_encoders; i++)
+   {
+      encoder = drmModeGetEncoder(drm_fd, connector->encoders[i]);
+      if (!encoder)
+         continue;
+      for (j = 0; j < resources->count_crtcs; j++)
+      {
+         if (encoder->possible_crtcs & (1 << j))
+         {
+            crtc_id = resources->crtcs[j];
+            drmModeFreeEncoder(encoder);
+            return OSD_OK;
+         }
+      }
+      drmModeFreeEncoder(encoder);
+   }
+   return OSD_NOT_OK;
+}
+
+int sysdep_init(void)
+{
+   return OSD_OK;
+}
+
+void sysdep_close(void)
+{
+}
+
+int sysdep_create_display(int depth)
+{
+   drmModeRes *resources;
+   drmModeConnector *connector = NULL;
+   int i;
+
+   switch (depth)
+   {
+      case 16:
+         update_function = kmsdrm_update_16_to_32bpp;
+         break;
+      case 32:
+         update_function = kmsdrm_update_rgb_direct_32bpp;
+         break;
+      default:
+         fprintf(stderr_file, "KMS/DRM: Error: unsupported depth %d\n", depth);
+         return OSD_NOT_OK;
+   }
+
+   drm_fd = open(drm_device, O_RDWR | O_CLOEXEC);
+   if (drm_fd < 0)
+   {
+      fprintf(stderr_file, "KMS/DRM: Error: unable to open %s: %s\n", drm_device, strerror(errno));
+      return OSD_NOT_OK;
+   }
+
+   resources = drmModeGetResources(drm_fd);
+   if (!resources)
+   {
+      fprintf(stderr_file, "KMS/DRM: Error: %s is not a modesetting device\n", drm_device);
+      goto error;
+   }
+
+   for (i = 0; i < resources->count_connectors; i++)
+   {
+      connector = drmModeGetConnector(drm_fd, resources->connectors[i]);
+      if (connector && connector->connection == DRM_MODE_CONNECTED && connector->count_modes > 0 &&
+          (drm_connector_id < 0 || (unsigned int)drm_connector_id == connector->connector_id))
+         break;
+      if (connector)
+         drmModeFreeConnector(connector);
+      connector = NULL;
+   }
+   if (!connector)
+   {
+      fprintf(stderr_file, "KMS/DRM: Error: no connected output found\n");
+      drmModeFreeResources(resources);
+      goto error;
+   }
+   connector_id = connector->connector_id;
+
+   /* the preferred mode is the native one of the screen, or the first one listed */
+   mode = connector->modes[0];
+   for (i = 0; i < connector->count_modes; i++)
+   {
+      if (connector->modes[i].type & DRM_MODE_TYPE_PREFERRED)
+      {
+         mode = connector->modes[i];
+         break;
+      }
+   }
+
+   if (kmsdrm_find_crtc(resources, connector) != OSD_OK)
+   {
+      fprintf(stderr_file, "KMS/DRM: Error: no display controller available for connector %u\n", connector_id);
+      drmModeFreeConnector(connector);
+      drmModeFreeResources(resources);
+      goto error;
+   }
+   drmModeFreeConnector(connector);
+   drmModeFreeResources(resources);
+
+   if (visual_width * widthscale > mode.hdisplay || visual_height * heightscale > mode.vdisplay)
+   {
+      fprintf(stderr_file, "KMS/DRM: Error: a %dx%d display does not fit the %dx%d output\n",
+         visual_width * widthscale, visual_height * heightscale, mode.hdisplay, mode.vdisplay);
+      goto error;
+   }
+   startx = (mode.hdisplay - visual_width * widthscale) / 2;
+   starty = (mode.vdisplay - visual_height * heightscale) / 2;
+
+   if (widthscale > 1 || heightscale > 1 || yarbsize)
+   {
+      doublebuffer_buffer = malloc(visual_width * widthscale * 4);
+      if (!doublebuffer_buffer)
+      {
+         fprintf(stderr_file, "KMS/DRM: Error: Couldn't allocate doublebuffer buffer\n");
+         goto error;
+      }
+   }
+
+   if (kmsdrm_create_buffer(&buffers[0]) != OSD_OK || kmsdrm_create_buffer(&buffers[1]) != OSD_OK)
+      goto error;
+
+   saved_crtc = drmModeGetCrtc(drm_fd, crtc_id);
+   if (drmModeSetCrtc(drm_fd, crtc_id, buffers[0].fb_id, 0, 0, &connector_id, 1, &mode))
+   {
+      fprintf(stderr_file, "KMS/DRM: Error: unable to set the %s mode: %s\n", mode.name, strerror(errno));
+      goto error;
+   }
+   back_buffer = 1;
+   flip_pending = 0;
+
+   fprintf(stderr_file, "KMS/DRM: Info: using connector %u, mode %s (%dx%d@%dHz), starting at %d x %d\n",
+      connector_id, mode.name, mode.hdisplay, mode.vdisplay, mode.vrefresh, startx, starty);
+
+   /* fill the display_palette_info struct, dumb buffers are XRGB8888 */
+   memset(&display_palette_info, 0, sizeof(struct sysdep_palette_info));
+   display_palette_info.depth      = 32;
+   display_palette_info.red_mask   = 0x00FF0000;
+   display_palette_info.green_mask = 0x0000FF00;
+   display_palette_info.blue_mask  = 0x000000FF;
+
+   effect_init2(depth, display_palette_info.depth, mode.hdisplay);
+
+   return OSD_OK;
+
+error:
+   sysdep_display_close();
+   return OSD_NOT_OK;
+}
+
+/* shut up the display */
+void sysdep_display_close(void)
+{
+   if (drm_fd < 0)
+      return;
+
+   kmsdrm_wait_flip();
+
+   /* give the output back the way we found it (usually the console) */
+   if (saved_crtc)
+   {
+      drmModeSetCrtc(drm_fd, saved_crtc->crtc_id, saved_crtc->buffer_id,
+         saved_crtc->x, saved_crtc->y, &connector_id, 1, &saved_crtc->mode);
+      drmModeFreeCrtc(saved_crtc);
+      saved_crtc = NULL;
+   }
+
+   kmsdrm_destroy_buffer(&buffers[0]);
+   kmsdrm_destroy_buffer(&buffers[1]);
+   close(drm_fd);
+   drm_fd = -1;
+
+   if (doublebuffer_buffer)
+   {
+      free(doublebuffer_buffer);
+      doublebuffer_buffer = NULL;
+   }
+}
+
+int sysdep_display_alloc_palette(int writable_colors)
+{
+   return 0;
+}
+
+int sysdep_display_set_pen(int pen, unsigned char red, unsigned char green,
+   unsigned char blue)
+{
+   return 0;
+}
+
+/* Update the display. */
+void sysdep_update_display(struct mame_bitmap *bitmap)
+{
+   struct kmsdrm_buffer *buffer = &buffers[back_buffer];
+   const int dest_width = buffer->pitch / 4;
+
+   /* the back buffer is the one scanned out until the last flip is done */
+   kmsdrm_wait_flip();
+
+   (*update_function)(bitmap, (unsigned int *)buffer->map + starty * dest_width + startx, dest_width);
+
+   if (drmModePageFlip(drm_fd, crtc_id, buffer->fb_id, DRM_MODE_PAGE_FLIP_EVENT, NULL) == 0)
+   {
+      flip_pending = 1;
+      back_buffer ^= 1;
+   }
+   else if (!flip_warned) /* the flip was refused (e.g. vt switched away), draw into the same buffer next time */
+   {
+      fprintf(stderr_file, "KMS/DRM: Warn: page flip failed: %s\n", strerror(errno));
+      flip_warned = 1;
+   }
+}
+
+void sysdep_mouse_poll(void)
+{
+}
+
+/* Keyboard procs */
+/* Lighting keyboard leds */
+void sysdep_set_leds(int leds)
+{
+}
+
+void sysdep_update_keyboard(void)
+{
+}
+
+int sysdep_display_16bpp_capable(void)
+{
+   return 1;
+}
@@ -217,6 +217,11 @@ ZIP* openzip(int pathtype, int pathindex, const char* zipfile) {
 	if (!zip) {
 		return 0;
 	}
+	zip->index = 0;
+	zip->index_count = 0;
+	zip->index_name_hash = 0;
+	zip->index_crc_hash = 0;
+	zip->index_hash_size = 0;
 
 	/* open */
 	zip->fp = osd_fopen(pathtype, pathindex, zipfile, "rb");
@@ -383,7 +388,14 @@ struct zipent* readzip(ZIP* zip) {
 
 /* Closes a zip stream */
 void closezip(ZIP* zip) {
+	unsigned i;
+
 	/* release all */
+	for (i=0;i<zip->index_count;++i)
+		free(zip->index[i].name);
+	free(zip->index);
+	free(zip->index_name_hash);
+	free(zip->index_crc_hash);
 	free(zip->ent.name);
 	free(zip->cd);
 	free(zip->ecd);
@@ -647,8 +659,9 @@ int readuncompresszip(ZIP* zip, struct zipent* ent, char* data) {
 
 #ifdef ZIP_CACHE
 
-/* ZIP cache entries */
-#define ZIP_CACHE_MAX 5
+/* ZIP cache entries (enough for a game, its parent and the BIOS/sound sets
+   they share, so audits of consecutive clones don't reopen them) */
+#define ZIP_CACHE_MAX 16
 
 /* ZIP cache buffer LRU ( Last Recently Used )
      zip_cache_map[0] is the newer
@@ -791,6 +804,116 @@ static int equal_filename(const char* zipfile, const char* file) {
 	return !*s1 && !*s2;
 }
 
+/* -------------------------------------------------------------------------
+   Central directory index
+ ------------------------------------------------------------------------- */
+
+#define ZIP_INDEX_NONE 0xffffffff
+
+/* Hash of a file name, ignoring the directory and the case like equal_filename */
+static unsigned hash_filename(const char* name) {
+	unsigned h = 0;
+	const char* s = strrchr(name,'/');
+	for (s = s ? s+1 : name; *s; ++s)
+		h = h*31 + toupper(*s);
+	return h;
+}
+
+/* Parse the whole central directory once, so that entries can be looked up
+   by name or by CRC without walking it again
+   return:
+	==0 success
+	<0 error
+*/
+static int buildindexzip(ZIP* zip) {
+	struct zipent* ent;
+	unsigned count = 0, size, i;
+
+	if (zip->index)
+		return 0;
+
+	/* count entries */
+	rewindzip(zip);
+	while (readzip(zip))
+		++count;
+
+	size = 16;
+	while (size < count*2)
+		size <<= 1;
+
+	zip->index = (struct zipent*)malloc((count ? count : 1) * sizeof(struct zipent));
+	zip->index_name_hash = (unsigned*)malloc((size + count) * sizeof(unsigned));
+	zip->index_crc_hash = (unsigned*)malloc((size + count) * sizeof(unsigned));
+	if (!zip->index || !zip->index_name_hash || !zip->index_crc_hash) {
+		free(zip->index);
+		free(zip->index_name_hash);
+		free(zip->index_crc_hash);
+		zip->index = 0;
+		zip->index_name_hash = zip->index_crc_hash = 0;
+		return -1;
+	}
+	zip->index_hash_size = size;
+	for (i=0;i<size;++i)
+		zip->index_name_hash[i] = zip->index_crc_hash[i] = ZIP_INDEX_NONE;
+
+	/* copy entries, chaining them in directory order (first match wins, as with readzip) */
+	rewindzip(zip);
+	for (i=0;i<count && (ent = readzip(zip)) != 0;++i) {
+		unsigned *link;
+
+		zip->index[i] = *ent;
+		zip->index[i].name = (char*)malloc(strlen(ent->name)+1);
+		if (zip->index[i].name)
+			strcpy(zip->index[i].name, ent->name);
+		else
+			zip->index[i].name = (char*)calloc(1,1);
+
+		zip->index_name_hash[size+i] = zip->index_crc_hash[size+i] = ZIP_INDEX_NONE;
+		for (link = &zip->index_name_hash[hash_filename(ent->name) & (size-1)]; *link != ZIP_INDEX_NONE; link = &zip->index_name_hash[size+*link])
+			;
+		*link = i;
+		for (link = &zip->index_crc_hash[ent->crc32 & (size-1)]; *link != ZIP_INDEX_NONE; link = &zip->index_crc_hash[size+*link])
+			;
+		*link = i;
+	}
+	zip->index_count = i;
+	rewindzip(zip);
+	return 0;
+}
+
+/* Find an entry by name (see equal_filename) */
+static struct zipent* findnamezip(ZIP* zip, const char* filename) {
+	unsigned i;
+
+	if (buildindexzip(zip) != 0)
+		return 0;
+	for (i = zip->index_name_hash[hash_filename(filename) & (zip->index_hash_size-1)]; i != ZIP_INDEX_NONE; i = zip->index_name_hash[zip->index_hash_size+i])
+		if (equal_filename(zip->index[i].name, filename))
+			return &zip->index[i];
+	return 0;
+}
+
+/* Find an entry by CRC (0 never matches) */
+static struct zipent* findcrczip(ZIP* zip, UINT32 crc) {
+	unsigned i;
+
+	if (!crc || buildindexzip(zip) != 0)
+		return 0;
+	for (i = zip->index_crc_hash[crc & (zip->index_hash_size-1)]; i != ZIP_INDEX_NONE; i = zip->index_crc_hash[zip->index_hash_size+i])
+		if (zip->index[i].crc32 == crc)
+			return &zip->index[i];
+	return 0;
+}
+
+/* Find an entry by name, or by CRC if filename is a CRC in printable hex
+   ("load by CRC", NS981003) */
+static struct zipent* findzip(ZIP* zip, const char* filename) {
+	struct zipent* ent = findnamezip(zip, filename);
+	if (!ent && strlen(filename) == 8 && strspn(filename, "0123456789abcdef") == 8)
+		ent = findcrczip(zip, (UINT32)strtoul(filename, 0, 16));
+	return ent;
+}
+
 /* Pass the path to the zipfile and the name of the file within the zipfile.
    buf will be set to point to the uncompressed image of that zipped file.
    length will be set to the length of the uncompressed data. */
@@ -802,44 +925,36 @@ int /* error */ load_zipped_file (int pathtype, int pathindex, const char* zipfi
 	if (!zip)
 		return -1;
 
-	while (readzip(zip)) {
-		/* NS981003: support for "load by CRC" */
-		char crc[9];
-
-		ent = &(zip->ent);
-
-		sprintf(crc,"%08x",ent->crc32);
-		if (equal_filename(ent->name, filename) ||
-				(ent->crc32 && !strcmp(crc, filename)))
-		{
-			*length = ent->uncompressed_size;
-			*buf = (unsigned char*)malloc( *length );
-			if (!*buf) {
-				if (!gUnzipQuiet)
-					printf("load_zipped_file(): Unable to allocate %d bytes of RAM\n",*length);
-				cache_closezip(zip);
-				return -1;
-			}
-
-			if (readuncompresszip(zip, ent, (char*)*buf)!=0) {
-				free(*buf);
-				cache_closezip(zip);
-				return -1;
-			}
+	ent = findzip(zip, filename);
+	if (ent)
+	{
+		*length = ent->uncompressed_size;
+		*buf = (unsigned char*)malloc( *length );
+		if (!*buf) {
+			if (!gUnzipQuiet)
+				printf("load_zipped_file(): Unable to allocate %d bytes of RAM\n",*length);
+			cache_closezip(zip);
+			return -1;
+		}
 
-			cache_suspendzip(zip);
-			return 0;
+		if (readuncompresszip(zip, ent, (char*)*buf)!=0) {
+			free(*buf);
+			cache_closezip(zip);
+			return -1;
 		}
+
+		cache_suspendzip(zip);
+		return 0;
 	}
 
 	cache_suspendzip(zip);
 	return -1;
 }
 
-/*	Pass the path to the zipfile and the name of the file within the zipfile.
-	sum will be set to the CRC-32 of that zipped file. */
-/*  The caller can preset sum to the expected checksum to enable "load by CRC" */
-int /* error */ checksum_zipped_file (int pathtype, int pathindex, const char *zipfile, const char *filename, unsigned int *length, unsigned int *sum) {
+/*	Pass the path to the zipfile and the name of the file within the zipfile
+	(or its CRC as printable hex, like load_zipped_file). length, sum and stamp
+	will be set to the uncompressed length, CRC-32 and DOS date/time of the entry. */
+int /* error */ stat_zipped_file (int pathtype, int pathindex, const char *zipfile, const char *filename, unsigned int *length, unsigned int *sum, unsigned int *stamp) {
 	ZIP* zip;
 	struct zipent* ent;
 
@@ -847,35 +962,43 @@ int /* error */ checksum_zipped_file (int pathtype, int pathindex, const char *z
 	if (!zip)
 		return -1;
 
-	while (readzip(zip)) {
-		ent = &(zip->ent);
-
-		if (equal_filename(ent->name, filename))
-		{
-			*length = ent->uncompressed_size;
-			*sum = ent->crc32;
-			cache_suspendzip(zip);
-			return 0;
-		}
+	ent = findzip(zip, filename);
+	if (ent)
+	{
+		*length = ent->uncompressed_size;
+		*sum = ent->crc32;
+		*stamp = ((unsigned int)ent->last_mod_file_date << 16) | ent->last_mod_file_time;
+		cache_suspendzip(zip);
+		return 0;
 	}
 
 	cache_suspendzip(zip);
+	return -1;
+}
+
+/*	Pass the path to the zipfile and the name of the file within the zipfile.
+	sum will be set to the CRC-32 of that zipped file. */
+/*  The caller can preset sum to the expected checksum to enable "load by CRC" */
+int /* error */ checksum_zipped_file (int pathtype, int pathindex, const char *zipfile, const char *filename, unsigned int *length, unsigned int *sum) {
+	ZIP* zip;
+	struct zipent* ent;
 
-	/* NS981003: support for "load by CRC" */
 	zip = cache_openzip(pathtype, pathindex, zipfile);
 	if (!zip)
 		return -1;
 
-	while (readzip(zip)) {
-		ent = &(zip->ent);
+	ent = findnamezip(zip, filename);
 
-		if (*sum && ent->crc32 == *sum)
-		{
-			*length = ent->uncompressed_size;
-			*sum = ent->crc32;
-			cache_suspendzip(zip);
-			return 0;
-		}
+	/* NS981003: support for "load by CRC" */
+	if (!ent)
+		ent = findcrczip(zip, *sum);
+
+	if (ent)
+	{
+		*length = ent->uncompressed_size;
+		*sum = ent->crc32;
+		cache_suspendzip(zip);
+		return 0;
 	}
 
 	cache_suspendzip(zip);
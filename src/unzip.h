@@ -54,6 +54,12 @@ typedef struct _ZIP {
 
 	struct zipent ent; /* buffer for readzip */
 
+	struct zipent* index; /* all entries, built on first lookup by name/CRC */
+	unsigned index_count;
+	unsigned* index_name_hash; /* index_hash_size heads, then index_count chain links */
+	unsigned* index_crc_hash;
+	unsigned index_hash_size; /* power of 2 */
+
 	/* end_of_cent_dir */
 	UINT32	end_of_cent_dir_sig;
 	UINT16	number_of_this_disk;
@@ -130,6 +136,7 @@ int readuncompresszip(ZIP* zip, struct zipent* ent, char* data);
 int /* error */ load_zipped_file (int pathtype, int pathindex, const char *zipfile, const char *filename,
 	unsigned char **buf, unsigned int *length);
 int /* error */ checksum_zipped_file (int pathtype, int pathindex, const char *zipfile, const char *filename, unsigned int *length, unsigned int *sum);
+int /* error */ stat_zipped_file (int pathtype, int pathindex, const char *zipfile, const char *filename, unsigned int *length, unsigned int *sum, unsigned int *stamp);
 
 void unzip_cache_clear(void);
 
@@ -3859,6 +3859,9 @@ int handle_user_interface(struct mame_bitmap *bitmap)
 #ifdef MESS
 	extern int mess_pause_for_ui;
 #endif
+#ifdef PINMAME
+	extern int snd_cmd_rip_done(void);
+#endif /* PINMAME */
 
 	/* if the user pressed F12, save the screen to a file */
 	if (input_ui_pressed(IPT_UI_SNAPSHOT))
@@ -3878,6 +3881,9 @@ int handle_user_interface(struct mame_bitmap *bitmap)
         //and quit if we received it
         || lisy_time_to_quit()
 #endif /* LISY_SUPPORT */
+#ifdef PINMAME
+	    || snd_cmd_rip_done()
+#endif /* PINMAME */
 	   )) {
 #if defined(PINMAME) && defined(PROC_SUPPORT)
 		procClearDMD();
@@ -4001,6 +4007,15 @@ int handle_user_interface(struct mame_bitmap *bitmap)
 		while (g_fPause) {
         if (input_ui_pressed(IPT_UI_PAUSE))
           g_fPause = 0;
+#ifdef LIBPINMAME
+        /* serve save/load state requests while paused */
+        { extern void libpinmame_update_state(void);
+          libpinmame_update_state(); }
+        /* nothing changes while paused: sleep until resumed instead of redrawing the screen */
+        { extern void libpinmame_wait_pause(void);
+          libpinmame_wait_pause(); }
+        continue;
+#endif
 #else /* VPINMAME */
 		while (!input_ui_pressed(IPT_UI_PAUSE))
 		{
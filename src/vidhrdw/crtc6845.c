@@ -43,6 +43,7 @@ typedef struct {
 	int page_flip;		/* This seems to be present in the HD46505 */
 	mame_timer* vsync_timer;
 	double clock_freq;
+	double vsync_period;	/* period the vsync timer is running at, 0 if disabled */
 } CRTC6845;
 
 static CRTC6845 crtc6845[MAX_6845];
@@ -61,6 +62,12 @@ void update_vsync_timer(int chipnum)
 		int nCycles = (crtc6845[chipnum].horiz_total + 1) * ((crtc6845[chipnum].vert_total + 1) * (crtc6845[chipnum].max_ras_addr + 1) + crtc6845[chipnum].vert_total_adj);
 		double period = nCycles / crtc6845[chipnum].clock_freq;
 		if (period < 1e-3) // Hack: disable timer if values are too low (less than 1ms here)
+			period = 0.;
+		// Games rewrite the timing registers with unchanged values: keep the running frame instead of restarting it
+		if (period == crtc6845[chipnum].vsync_period)
+			return;
+		crtc6845[chipnum].vsync_period = period;
+		if (period == 0.)
 			timer_enable(crtc6845[chipnum].vsync_timer, 0);
 		else
 			timer_adjust(crtc6845[chipnum].vsync_timer, period, chipnum, period);
@@ -73,6 +80,7 @@ void crtc6845_set_vsync(int chipnum, double clockFreq, void (*handler)(int))
 	if (crtc6845[chipnum].vsync_timer != NULL)
 		timer_remove(crtc6845[chipnum].vsync_timer);
 	crtc6845[chipnum].vsync_timer = NULL;
+	crtc6845[chipnum].vsync_period = 0.;
 	crtc6845[chipnum].clock_freq = clockFreq;
 	if (handler && clockFreq > 0.)
 	{
@@ -57,6 +57,14 @@
 #include "vidhrdw/generic.h"
 #include "tms9928a.h"
 
+#if (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || defined(__x86_64__)
+ #define SSE_TMS_OPT
+ #include <emmintrin.h>
+#elif (defined(_M_ARM) || defined(_M_ARM64) || defined(__arm__) || defined(__arm64__) || defined(__aarch64__)) && (!defined(__ARM_ARCH) || __ARM_ARCH >= 7) && (!defined(_MSC_VER) || defined(__clang__))
+ #define SSE_TMS_OPT // uses sse2neon then
+ #include "../../ext/sse2neon.h"
+#endif
+
 /*
 	New palette (R. Nabet, updated by G. Volkenborn).
 
@@ -133,6 +141,17 @@ static unsigned char TMS9928A_palette[32*3] =
 #define MAX_DIRTY_PATTERN       (256*3)
 #define MAX_DIRTY_NAME          (40*24)
 
+/*
+** The picture is composited again only in the 8x8 screen cells where a
+** chip redrew its background or where sprites are or were. The cells
+** are shared by all chips, as they are all drawn on the same bitmap.
+*/
+#define CELL_COLS               32
+#define CELL_ROWS               24
+
+static UINT8 DirtyCell[CELL_ROWS*CELL_COLS];
+static UINT32 RefreshCount; /* full erases of the screen bitmap seen so far */
+
 /*
 ** Forward declarations of internal functions.
 */
@@ -143,7 +162,8 @@ static void _TMS9928A_mode12 (int which,struct mame_bitmap*);
 static void _TMS9928A_mode3 (int which,struct mame_bitmap*);
 static void _TMS9928A_mode23 (int which,struct mame_bitmap*);
 static void _TMS9928A_modebogus (int which,struct mame_bitmap*);
-static void _TMS9928A_sprites (int which, struct mame_bitmap*);
+static void _TMS9928A_sprites (int which, struct mame_bitmap*, const UINT8 *clip);
+static int _TMS9928A_sprite_boxes (int which, struct rectangle *box);
 static void _TMS9928A_change_register (int which, int reg, UINT8 data);
 static void _TMS9928A_set_dirty (int which, char);
 
@@ -174,6 +194,9 @@ typedef struct {
     /* dirty tables */
     char anyDirtyColour, anyDirtyName, anyDirtyPattern;
     char *DirtyColour, *DirtyName, *DirtyPattern;
+    /* sprite bounding boxes, in dBackMem and on the screen bitmap */
+    struct rectangle SpriteBox[32], ShownBox[32];
+    int SpriteBoxes, ShownBoxes;
 } TMS9928A;
 
 static TMS9928A tms[MAX_VDP];
@@ -205,6 +228,7 @@ void TMS9928A_reset (int which) {
 	tms[which].FirstByte = 0;
 	tms[which].latch = 0;
 	_TMS9928A_set_dirty (which,1);
+	memset (DirtyCell, 1, sizeof(DirtyCell));
 }
 
 int TMS9928A_start(int which, int model, unsigned int vram) {
@@ -226,6 +250,8 @@ int TMS9928A_start(int which, int model, unsigned int vram) {
 		free (tms[which].vMem);
 		return 1;
 	}
+	memset (tms[which].dBackMem, 0, IMAGE_SIZE);
+	tms[which].SpriteBoxes = tms[which].ShownBoxes = 0;
 
 	/* dirty buffers */
 	tms[which].DirtyName = (char*)malloc (MAX_DIRTY_NAME);
@@ -355,25 +381,31 @@ void TMS9928A_vram_w(int which,int offset,int data)
 
     if (tms[which].vMem[tms[which].Addr] != data) {
         tms[which].vMem[tms[which].Addr] = data;
-        tms[which].Change = 1;
-        /* dirty optimization */
+        /* dirty optimization, writes outside of the tables in use leave the picture as is */
         if ( (tms[which].Addr >= tms[which].nametbl) &&
             (tms[which].Addr < (tms[which].nametbl + MAX_DIRTY_NAME) ) ) {
             tms[which].DirtyName[tms[which].Addr - tms[which].nametbl] = 1;
             tms[which].anyDirtyName = 1;
+            tms[which].Change = 1;
         }
 
         i = (tms[which].Addr - tms[which].colour) >> 3;
         if ( (i >= 0) && (i < MAX_DIRTY_COLOUR) ) {
             tms[which].DirtyColour[i] = 1;
             tms[which].anyDirtyColour = 1;
+            tms[which].Change = 1;
         }
 
         i = (tms[which].Addr - tms[which].pattern) >> 3;
         if ( (i >= 0) && (i < MAX_DIRTY_PATTERN) ) {
             tms[which].DirtyPattern[i] = 1;
             tms[which].anyDirtyPattern = 1;
+            tms[which].Change = 1;
         }
+
+        if ( ((unsigned int)(tms[which].Addr - tms[which].spriteattribute) < 128) ||
+            ((unsigned int)(tms[which].Addr - tms[which].spritepattern) < 2048) )
+            tms[which].Change = 1;
     }
     tms[which].Addr = (tms[which].Addr + 1) & (tms[which].vramsize - 1);
     tms[which].ReadAhead = data;
@@ -524,12 +556,70 @@ void TMS9928A_set_spriteslimit (int which, int limit) {
 */
 
 
+/*
+** Marks the screen cells of the sprites, where they were last time
+** the bitmap was composited and where they are now.
+*/
+static void _TMS9928A_sprite_cells (int which) {
+	struct rectangle *box;
+	int i,x,y;
+
+	for (i=0;i<tms[which].ShownBoxes;i++) {
+		box = &tms[which].ShownBox[i];
+		for (y=box->min_y/8;y<=box->max_y/8;y++)
+			for (x=box->min_x/8;x<=box->max_x/8;x++)
+				DirtyCell[y*CELL_COLS+x] = 1;
+	}
+	tms[which].ShownBoxes = TMS_SPRITES_ENABLED ? _TMS9928A_sprite_boxes (which, tms[which].ShownBox) : 0;
+	for (i=0;i<tms[which].ShownBoxes;i++) {
+		box = &tms[which].ShownBox[i];
+		for (y=box->min_y/8;y<=box->max_y/8;y++)
+			for (x=box->min_x/8;x<=box->max_x/8;x++)
+				DirtyCell[y*CELL_COLS+x] = 1;
+	}
+}
+
+/*
+** Copies the back bitmap of a chip to the screen, all of it or only the
+** dirty cells (as one rectangle per run of cells on a row).
+*/
+static void _TMS9928A_copy_cells (int which, struct mame_bitmap *bmp, int all) {
+	const int transparency = which ? TRANSPARENCY_COLOR : TRANSPARENCY_NONE;
+	struct rectangle clip;
+	int x,x2,y;
+
+	if (all) {
+		copybitmap (bmp, tms[which].tmpbmp, 0, 0, 0, 0,&Machine->visible_area, transparency, 0);
+		return;
+	}
+	for (y=0;y<CELL_ROWS;y++) {
+		for (x=0;x<CELL_COLS;x=x2) {
+			if (!DirtyCell[y*CELL_COLS+x]) {
+				x2 = x+1;
+				continue;
+			}
+			for (x2=x+1;x2<CELL_COLS && DirtyCell[y*CELL_COLS+x2];x2++) ;
+			clip.min_x = x*8; clip.max_x = x2*8-1;
+			clip.min_y = y*8; clip.max_y = y*8+7;
+			sect_rect (&clip, &Machine->visible_area);
+			if (clip.min_x <= clip.max_x && clip.min_y <= clip.max_y)
+				copybitmap (bmp, tms[which].tmpbmp, 0, 0, 0, 0, &clip, transparency, 0);
+		}
+	}
+}
+
 /* REWRITTEN TO SUPPORT MULTI-CHIPS IN 1 FUNCTION CALL */
 
 void TMS9928A_refresh (int num_chips, struct mame_bitmap *bmp, int full_refresh) {
     int c,which;
 	int update=0;
 
+	/* the screen bitmap was erased, it must be drawn completely */
+	if (RefreshCount != get_full_refresh_count()) {
+		RefreshCount = get_full_refresh_count();
+		full_refresh = 1;
+	}
+
 	/*For each chip*/
 	for (which = 0; which < num_chips; which++) {
 		if (tms[which].Change) {
@@ -558,6 +648,7 @@ void TMS9928A_refresh (int num_chips, struct mame_bitmap *bmp, int full_refresh)
 		for (which = 0; which < num_chips; which++) {
 			if (! (tms[which].Regs[1] & 0x40) ) {
 				fillbitmap (bmp, Machine->pens[tms[which].BackColour],&Machine->visible_area);
+				full_refresh = 1;
 			}
 			else {
 				if (tms[which].Change)
@@ -565,15 +656,21 @@ void TMS9928A_refresh (int num_chips, struct mame_bitmap *bmp, int full_refresh)
 			}
 		}
 
+		/*For each chip*/
+		for (which = 0; which < num_chips; which++)
+			_TMS9928A_sprite_cells (which);
+		if (full_refresh)
+			memset (DirtyCell, 1, sizeof(DirtyCell));
+
 		/*For each chip*/
 		for (which = 0; which < num_chips; which++) {
 			/* Master Chip, set as chip 0, is always drawn opaque */
 			/* Any other slave chips will have transparent color 0 */
-			copybitmap (bmp, tms[which].tmpbmp, 0, 0, 0, 0,&Machine->visible_area,
-			  (which ? TRANSPARENCY_COLOR : TRANSPARENCY_NONE), 0);
+			_TMS9928A_copy_cells (which, bmp, full_refresh);
 			if (TMS_SPRITES_ENABLED)
-				_TMS9928A_sprites (which, bmp);
+				_TMS9928A_sprites (which, bmp, DirtyCell);
 		}
+		memset (DirtyCell, 0, sizeof(DirtyCell));
 	}
 
 	/*For each chip*/
@@ -652,7 +749,7 @@ void TMS9928A_refresh_test (int num_chips, struct mame_bitmap *bmp, int full_ref
 		for (which = 0; which < MAX_VDP; which++) {
 			if (TMS_SPRITES_ENABLED) {
 				fillbitmap (tms[which].tmpsbmp, 0,&Machine->visible_area);
-				_TMS9928A_sprites (which, tms[which].tmpsbmp);
+				_TMS9928A_sprites (which, tms[which].tmpsbmp, NULL);
 			}
 		}
 
@@ -683,7 +780,7 @@ int TMS9928A_interrupt (int which) {
     if (osd_skip_this_frame() ) {
         if (tms[which].Change) {
             if (TMS_SPRITES_ENABLED) {
-                _TMS9928A_sprites (which, NULL);
+                _TMS9928A_sprites (which, NULL, NULL);
             }
         } else {
 	    	tms[which].StatusReg = tms[which].oldStatusReg;
@@ -700,6 +797,54 @@ int TMS9928A_interrupt (int which) {
     return b;
 }
 
+/*
+** Draws the 8 pixels of a pattern byte (bit 7 leftmost) to a row of the
+** back bitmap, pen fg for the bits set and bg for the others.
+*/
+INLINE void _TMS9928A_pattern8 (struct mame_bitmap *bmp, int x, int y, int pattern, pen_t fg, pen_t bg) {
+    int xx;
+
+    if (bmp->depth == 15 || bmp->depth == 16) {
+        UINT16 *dst = (UINT16*)bmp->line[y] + x;
+#ifdef SSE_TMS_OPT
+        const __m128i bits = _mm_set_epi16 (0x01,0x02,0x04,0x08,0x10,0x20,0x40,0x80);
+        const __m128i set = _mm_cmpeq_epi16 (_mm_and_si128 (_mm_set1_epi16 ((short)pattern), bits), bits);
+        _mm_storeu_si128 ((__m128i*)dst, _mm_or_si128 (_mm_and_si128 (set, _mm_set1_epi16 ((short)fg)),
+            _mm_andnot_si128 (set, _mm_set1_epi16 ((short)bg))));
+#else
+        for (xx=0;xx<8;xx++) {
+            dst[xx] = (pattern & 0x80) ? fg : bg;
+            pattern *= 2;
+        }
+#endif
+    }
+    else if (bmp->depth == 32) {
+        UINT32 *dst = (UINT32*)bmp->line[y] + x;
+#ifdef SSE_TMS_OPT
+        const __m128i bitsl = _mm_set_epi32 (0x10,0x20,0x40,0x80);
+        const __m128i bitsr = _mm_set_epi32 (0x01,0x02,0x04,0x08);
+        const __m128i pat = _mm_set1_epi32 (pattern);
+        const __m128i fg4 = _mm_set1_epi32 ((int)fg), bg4 = _mm_set1_epi32 ((int)bg);
+        const __m128i setl = _mm_cmpeq_epi32 (_mm_and_si128 (pat, bitsl), bitsl);
+        const __m128i setr = _mm_cmpeq_epi32 (_mm_and_si128 (pat, bitsr), bitsr);
+        _mm_storeu_si128 ((__m128i*)dst, _mm_or_si128 (_mm_and_si128 (setl, fg4), _mm_andnot_si128 (setl, bg4)));
+        _mm_storeu_si128 ((__m128i*)(dst+4), _mm_or_si128 (_mm_and_si128 (setr, fg4), _mm_andnot_si128 (setr, bg4)));
+#else
+        for (xx=0;xx<8;xx++) {
+            dst[xx] = (pattern & 0x80) ? fg : bg;
+            pattern *= 2;
+        }
+#endif
+    }
+    else {
+        UINT8 *dst = (UINT8*)bmp->line[y] + x;
+        for (xx=0;xx<8;xx++) {
+            dst[xx] = (pattern & 0x80) ? fg : bg;
+            pattern *= 2;
+        }
+    }
+}
+
 static void _TMS9928A_mode1 (int which, struct mame_bitmap *bmp) {
     int pattern,x,y,yy,xx,name,charcode;
     UINT8 fg,bg,*patternptr;
@@ -719,6 +864,8 @@ static void _TMS9928A_mode1 (int which, struct mame_bitmap *bmp) {
 		rt.min_y = 0; rt.max_y = 191;
 		rt.min_x = 248; rt.max_x = 255;
 		fillbitmap (bmp, bg, &rt);
+		for (y=0;y<CELL_ROWS;y++)
+			DirtyCell[y*CELL_COLS] = DirtyCell[y*CELL_COLS+CELL_COLS-1] = 1;
     }
 
     name = 0;
@@ -728,6 +875,7 @@ static void _TMS9928A_mode1 (int which, struct mame_bitmap *bmp) {
             if ( !(tms[which].DirtyName[name++] || tms[which].DirtyPattern[charcode]) &&
 				!tms[which].anyDirtyColour)
                 continue;
+            DirtyCell[y*CELL_COLS+(8+x*6)/8] = DirtyCell[y*CELL_COLS+(13+x*6)/8] = 1;
             patternptr = tms[which].vMem + tms[which].pattern + (charcode*8);
             for (yy=0;yy<8;yy++) {
                 pattern = *patternptr++;
@@ -761,6 +909,8 @@ static void _TMS9928A_mode12 (int which, struct mame_bitmap *bmp) {
 		rt.min_y = 0; rt.max_y = 191;
 		rt.min_x = 248; rt.max_x = 255;
 		fillbitmap (bmp, bg, &rt);
+		for (y=0;y<CELL_ROWS;y++)
+			DirtyCell[y*CELL_COLS] = DirtyCell[y*CELL_COLS+CELL_COLS-1] = 1;
     }
 
     name = 0;
@@ -770,6 +920,7 @@ static void _TMS9928A_mode12 (int which, struct mame_bitmap *bmp) {
             if ( !(tms[which].DirtyName[name++] || tms[which].DirtyPattern[charcode]) &&
 					!tms[which].anyDirtyColour)
                 continue;
+            DirtyCell[y*CELL_COLS+(8+x*6)/8] = DirtyCell[y*CELL_COLS+(13+x*6)/8] = 1;
             patternptr = tms[which].vMem + tms[which].pattern + (charcode*8);
             for (yy=0;yy<8;yy++) {
                 pattern = *patternptr++;
@@ -785,8 +936,12 @@ static void _TMS9928A_mode12 (int which, struct mame_bitmap *bmp) {
 }
 
 static void _TMS9928A_mode0 (int which, struct mame_bitmap *bmp) {
-    int pattern,x,y,yy,xx,name,charcode,colour;
-    UINT8 fg,bg,*patternptr;
+    int x,y,yy,name,charcode,colour;
+    UINT8 *patternptr;
+    pen_t fg,bg;
+
+    if ( !(tms[which].anyDirtyColour || tms[which].anyDirtyName || tms[which].anyDirtyPattern) )
+         return;
 
     name = 0;
     for (y=0;y<24;y++) {
@@ -795,18 +950,13 @@ static void _TMS9928A_mode0 (int which, struct mame_bitmap *bmp) {
             if ( !(tms[which].DirtyName[name++] || tms[which].DirtyPattern[charcode] ||
                 tms[which].DirtyColour[charcode/64]) )
                 continue;
+            DirtyCell[y*CELL_COLS+x] = 1;
             patternptr = tms[which].vMem + tms[which].pattern + charcode*8;
             colour = tms[which].vMem[tms[which].colour+charcode/8];
             fg = Machine->pens[colour / 16];
             bg = Machine->pens[colour & 15];
-            for (yy=0;yy<8;yy++) {
-                pattern=*patternptr++;
-                for (xx=0;xx<8;xx++) {
-		    		plot_pixel (bmp, x*8+xx, y*8+yy,
-						(pattern & 0x80) ? fg : bg);
-                    pattern *= 2;
-                }
-            }
+            for (yy=0;yy<8;yy++)
+                _TMS9928A_pattern8 (bmp, x*8, y*8+yy, *patternptr++, fg, bg);
         }
     }
     _TMS9928A_set_dirty (which,0);
@@ -814,7 +964,7 @@ static void _TMS9928A_mode0 (int which, struct mame_bitmap *bmp) {
 
 // patched for Granny & The Gators
 static void _TMS9928A_mode2 (int which, struct mame_bitmap *bmp) {
-    int colour,name,x,y,yy,pattern,xx,charcode;
+    int colour,name,x,y,yy,pattern,charcode;
     UINT8 fg,bg;
     UINT8 *colourptr,*patternptr;
 
@@ -830,6 +980,7 @@ static void _TMS9928A_mode2 (int which, struct mame_bitmap *bmp) {
             if ( !(tms[which].DirtyName[name++] || tms[which].DirtyPattern[pattern] ||
                 tms[which].DirtyColour[colour]) )
                 continue;
+            DirtyCell[y*CELL_COLS+x] = 1;
             patternptr = tms[which].vMem+tms[which].pattern+colour*8;
             colourptr = tms[which].vMem+tms[which].colour+pattern*8;
             for (yy=0;yy<8;yy++) {
@@ -841,10 +992,7 @@ static void _TMS9928A_mode2 (int which, struct mame_bitmap *bmp) {
                     bg = (bg < 2) ? 0 : bg+16;
                     fg = (fg < 2) ? 0 : fg+16;
                 }
-                for (xx=0;xx<8;xx++) {
-                    plot_pixel (bmp, x*8+xx, y*8+yy, Machine->pens[(pattern & 0x80) ? fg : bg]);
-                    pattern *= 2;
-                }
+                _TMS9928A_pattern8 (bmp, x*8, y*8+yy, pattern, Machine->pens[fg], Machine->pens[bg]);
             }
         }
     }
@@ -853,7 +1001,8 @@ static void _TMS9928A_mode2 (int which, struct mame_bitmap *bmp) {
 
 static void _TMS9928A_mode3 (int which, struct mame_bitmap *bmp) {
     int x,y,yy,yyy,name,charcode;
-    UINT8 fg,bg,*patternptr;
+    UINT8 *patternptr;
+    pen_t fg,bg;
 
     if ( !(tms[which].anyDirtyColour || tms[which].anyDirtyName || tms[which].anyDirtyPattern) )
          return;
@@ -865,20 +1014,13 @@ static void _TMS9928A_mode3 (int which, struct mame_bitmap *bmp) {
             if ( !(tms[which].DirtyName[name++] || tms[which].DirtyPattern[charcode]) &&
 					!tms[which].anyDirtyColour)
                 continue;
+            DirtyCell[y*CELL_COLS+x] = 1;
             patternptr = tms[which].vMem+tms[which].pattern+charcode*8+(y&3)*2;
             for (yy=0;yy<2;yy++) {
                 fg = Machine->pens[(*patternptr / 16)];
                 bg = Machine->pens[((*patternptr++) & 15)];
-                for (yyy=0;yyy<4;yyy++) {
-		    plot_pixel (bmp, x*8+0, y*8+yy*4+yyy, fg);
-		    plot_pixel (bmp, x*8+1, y*8+yy*4+yyy, fg);
-		    plot_pixel (bmp, x*8+2, y*8+yy*4+yyy, fg);
-		    plot_pixel (bmp, x*8+3, y*8+yy*4+yyy, fg);
-		    plot_pixel (bmp, x*8+4, y*8+yy*4+yyy, bg);
-		    plot_pixel (bmp, x*8+5, y*8+yy*4+yyy, bg);
-		    plot_pixel (bmp, x*8+6, y*8+yy*4+yyy, bg);
-		    plot_pixel (bmp, x*8+7, y*8+yy*4+yyy, bg);
-                }
+                for (yyy=0;yyy<4;yyy++)
+                    _TMS9928A_pattern8 (bmp, x*8, y*8+yy*4+yyy, 0xf0, fg, bg);
             }
         }
     }
@@ -887,7 +1029,8 @@ static void _TMS9928A_mode3 (int which, struct mame_bitmap *bmp) {
 
 static void _TMS9928A_mode23 (int which, struct mame_bitmap *bmp) {
     int x,y,yy,yyy,name,charcode;
-    UINT8 fg,bg,*patternptr;
+    UINT8 *patternptr;
+    pen_t fg,bg;
 
     if ( !(tms[which].anyDirtyColour || tms[which].anyDirtyName || tms[which].anyDirtyPattern) )
          return;
@@ -899,21 +1042,14 @@ static void _TMS9928A_mode23 (int which, struct mame_bitmap *bmp) {
             if ( !(tms[which].DirtyName[name++] || tms[which].DirtyPattern[charcode]) &&
 		!tms[which].anyDirtyColour)
                 continue;
+            DirtyCell[y*CELL_COLS+x] = 1;
             patternptr = tms[which].vMem + tms[which].pattern +
                 ((charcode+(y&3)*2+(y/8)*256)&tms[which].patternmask)*8;
             for (yy=0;yy<2;yy++) {
                 fg = Machine->pens[(*patternptr / 16)];
                 bg = Machine->pens[((*patternptr++) & 15)];
-                for (yyy=0;yyy<4;yyy++) {
-		    plot_pixel (bmp, x*8+0, y*8+yy*4+yyy, fg);
-		    plot_pixel (bmp, x*8+1, y*8+yy*4+yyy, fg);
-		    plot_pixel (bmp, x*8+2, y*8+yy*4+yyy, fg);
-		    plot_pixel (bmp, x*8+3, y*8+yy*4+yyy, fg);
-		    plot_pixel (bmp, x*8+4, y*8+yy*4+yyy, bg);
-		    plot_pixel (bmp, x*8+5, y*8+yy*4+yyy, bg);
-		    plot_pixel (bmp, x*8+6, y*8+yy*4+yyy, bg);
-		    plot_pixel (bmp, x*8+7, y*8+yy*4+yyy, bg);
-                }
+                for (yyy=0;yyy<4;yyy++)
+                    _TMS9928A_pattern8 (bmp, x*8, y*8+yy*4+yyy, 0xf0, fg, bg);
             }
         }
     }
@@ -939,6 +1075,7 @@ static void _TMS9928A_modebogus (int which, struct mame_bitmap *bmp) {
         }
         n=8; while (n--) plot_pixel (bmp, xx++, y, bg);
     }
+    memset (DirtyCell, 1, sizeof(DirtyCell));
 
     _TMS9928A_set_dirty (which,0);
 }
@@ -950,13 +1087,28 @@ static void _TMS9928A_modebogus (int which, struct mame_bitmap *bmp) {
 ** collision bit to be set, and ``illegal'' sprites do not count
 ** (they're not displayed)).
 **
-** This code should be optimized. One day.
+** Only the bounding boxes of the sprites are cleared in the back buffer,
+** and pixels are drawn to bmp only in the screen cells set in clip (if
+** not NULL).
 */
-static void _TMS9928A_sprites (int which, struct mame_bitmap *bmp) {
+#define SPRITE_PLOT(xx,yy) \
+    if (bmp && (!clip || clip[((yy)/8)*CELL_COLS+(xx)/8])) \
+        plot_pixel (bmp, xx, yy, Machine->pens[c])
+
+static void _TMS9928A_sprites (int which, struct mame_bitmap *bmp, const UINT8 *clip) {
     UINT8 *attributeptr,*patternptr,c;
     int p,x,y,size,i,j,large,yy,xx,limit[192],
         illegalsprite,illegalspriteline;
     UINT16 line,line2;
+    struct rectangle *box;
+
+    /* clear the back buffer where the sprites were drawn last time */
+    for (i=0;i<tms[which].SpriteBoxes;i++) {
+        box = &tms[which].SpriteBox[i];
+        for (yy=box->min_y;yy<=box->max_y;yy++)
+            memset (tms[which].dBackMem+yy*256+box->min_x, 0, box->max_x-box->min_x+1);
+    }
+    tms[which].SpriteBoxes = _TMS9928A_sprite_boxes (which, tms[which].SpriteBox);
 
     attributeptr = tms[which].vMem + tms[which].spriteattribute;
     size = (tms[which].Regs[1] & 2) ? 16 : 8;
@@ -967,7 +1119,6 @@ static void _TMS9928A_sprites (int which, struct mame_bitmap *bmp) {
     illegalspriteline = 255;
     illegalsprite = 0;
 
-    memset (tms[which].dBackMem, 0, IMAGE_SIZE);
     for (p=0;p<32;p++) {
         y = *attributeptr++;
         if (y == 208) break;
@@ -1012,8 +1163,7 @@ static void _TMS9928A_sprites (int which, struct mame_bitmap *bmp) {
                             if (c && ! (tms[which].dBackMem[yy*256+xx] & 0x02))
                             {
                             	tms[which].dBackMem[yy*256+xx] |= 0x02;
-                            	if (bmp)
-									plot_pixel (bmp, xx, yy, Machine->pens[c]);
+                            	SPRITE_PLOT (xx, yy);
 							}
                         }
                     }
@@ -1051,8 +1201,7 @@ static void _TMS9928A_sprites (int which, struct mame_bitmap *bmp) {
 		                            if (c && ! (tms[which].dBackMem[yy*256+xx] & 0x02))
         		                    {
                 		            	tms[which].dBackMem[yy*256+xx] |= 0x02;
-                                        if (bmp)
-                                        	plot_pixel (bmp, xx, yy, Machine->pens[c]);
+                                        SPRITE_PLOT (xx, yy);
                 		            }
                                 }
                                 if (((xx+1) >=0) && ((xx+1) < 256)) {
@@ -1064,8 +1213,7 @@ static void _TMS9928A_sprites (int which, struct mame_bitmap *bmp) {
 		                            if (c && ! (tms[which].dBackMem[yy*256+xx+1] & 0x02))
         		                    {
                 		            	tms[which].dBackMem[yy*256+xx+1] |= 0x02;
-                                        if (bmp)
-                                        	plot_pixel (bmp, xx+1, yy, Machine->pens[c]);
+                                        SPRITE_PLOT (xx+1, yy);
 									}
                                 }
                             }
@@ -1084,6 +1232,35 @@ static void _TMS9928A_sprites (int which, struct mame_bitmap *bmp) {
     }
 }
 
+/*
+** Gets the bounding boxes of the sprites shown, clipped to the screen,
+** without the sprite limit per line (so the boxes may be too large).
+*/
+static int _TMS9928A_sprite_boxes (int which, struct rectangle *box) {
+    const UINT8 *attributeptr = tms[which].vMem + tms[which].spriteattribute;
+    const int size = ((tms[which].Regs[1] & 2) ? 16 : 8) << (tms[which].Regs[1] & 1);
+    int p,x,y,n = 0;
+
+    for (p=0;p<32;p++,attributeptr+=4) {
+        y = attributeptr[0];
+        if (y == 208) break;
+        if (y > 208) {
+            y=-(~y&255);
+        } else {
+            y++;
+        }
+        x = attributeptr[1];
+        if (attributeptr[3] & 0x80) x -= 32;
+        if ( (x+size <= 0) || (x > 255) || (y+size <= 0) || (y > 191) ) continue;
+        box[n].min_x = (x < 0) ? 0 : x;
+        box[n].max_x = (x+size > 256) ? 255 : x+size-1;
+        box[n].min_y = (y < 0) ? 0 : y;
+        box[n].max_y = (y+size > 192) ? 191 : y+size-1;
+        n++;
+    }
+    return n;
+}
+
 /* I/O Routetines */
 READ_HANDLER (TMS9928A_vram_0_r)		{ return TMS9928A_vram_r(0,offset); }
 WRITE_HANDLER (TMS9928A_vram_0_w)		{ TMS9928A_vram_w(0,offset,data); }
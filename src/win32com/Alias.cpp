@@ -2,6 +2,7 @@
 extern "C" {
   #include "driver.h"
   #include "audit.h"
+  #include "gamealias.h"
 }
 
 #ifndef WIN32_LEAN_AND_MEAN
@@ -26,8 +27,6 @@ static const struct tAliasTable { const char* alias; const char* real; } aliasTa
 	  { NULL, NULL }
 };
 
-static char alias_from_file[50];
-
 static const char* crcOfGamesNotSupported[] = {
 	NULL
 };
@@ -46,28 +45,9 @@ const char* checkGameAlias(const char* aRomName) {
 	{
 		strcpy_s(ptr + 1, 13, "VPMAlias.txt");
 
-		FILE *f = fopen(AliasFilename, "r");
-
-		if (f != NULL)
-		{
-			char line[128];
-			while (fgets(line, sizeof(line), f) != NULL)
-			{
-				// Skip lines that start with "#"
-				if (line[0] == '#') {
-					continue;
-				}
-				char *token = strtok(line, ", ");
-				
-				if (_stricmp(token, aRomName) == 0)
-				{
-					strcpy_s(alias_from_file, sizeof(alias_from_file), strtok(NULL, " ,\n#;'"));
-					fclose(f);
-					return alias_from_file;
-				}
-			}
-			fclose(f);
-		}
+		const char* const alias_from_file = gamealias_find(AliasFilename, aRomName);
+		if (alias_from_file != NULL)
+			return alias_from_file;
 	}
 	for (const tAliasTable* ii = aliasTable; ii->alias; ++ii)
 		if (_stricmp(aRomName, ii->alias) == 0) return ii->real;
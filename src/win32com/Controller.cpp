@@ -25,6 +25,7 @@
 #include "ControllerDisclaimerDlg.h"
 #include "ControllerGames.h"
 #include "ControllerRegkeys.h"
+#include "VPinMAMESharedState.h"
 
 extern "C" {
 #include "driver.h"
@@ -43,7 +44,8 @@ extern UINT32 g_raw_colordmdbuffer[DMD_MAXY*DMD_MAXX];
 extern UINT32 g_raw_dmdx;
 extern UINT32 g_raw_dmdy;
 extern UINT8  g_needs_DMD_update;
-extern int g_cpu_affinity_mask;
+extern UINT64 g_raw_dmd_hash;
+extern UINT64 g_raw_dmd_dirty_rows;
 
 extern char g_fShowWinDMD;
 extern char g_szGameName[256];
@@ -63,6 +65,10 @@ extern int deprecated_synclevel;
 void CreateEventWindow(CController* pController);
 void DestroyEventWindow(CController* pController);
 
+// in ControllerRun.cpp: startup phases timing, logged once the machine runs
+void vpm_startup_timing_begin(void);
+void vpm_startup_timing_phase(const char* const pszPhase);
+
 extern "C" { 
 	extern void set_lowest_possible_win_timer_resolution();
 	extern void restore_win_timer_resolution();
@@ -205,6 +211,12 @@ CController::CController() {
 
 CController::~CController() {
 	Stop();
+	if (g_pSharedState) {
+		UnmapViewOfFile(g_pSharedState);
+		g_pSharedState = NULL;
+		CloseHandle(g_hSharedState);
+		g_hSharedState = NULL;
+	}
 	CloseHandle(m_hEmuIsRunning);
 	restore_win_timer_resolution();
 	m_pGame->Release();
@@ -212,6 +224,8 @@ CController::~CController() {
 	m_pGames->Release();
 	m_pControllerSettings->Release();
 
+	FlushSettingsCache();
+
 	cli_frontend_exit();
 }
 
@@ -221,6 +235,8 @@ CController::~CController() {
  *****************************************/
 STDMETHODIMP CController::Run(/*[in]*/ LONG_PTR hParentWnd, /*[in,defaultvalue(100)]*/ int nMinVersion)
 {
+	vpm_startup_timing_begin();
+
 	/*Make sure GameName Specified!*/
 	if (m_szROM[0] == '\0')
 		return Error(TEXT("Game name not specified!"));
@@ -247,6 +263,9 @@ STDMETHODIMP CController::Run(/*[in]*/ LONG_PTR hParentWnd, /*[in,defaultvalue(1
 		return Error(TEXT(szTemp));
 	}
 
+	// write the settings changed by the script before the run
+	FlushSettingsCache();
+
 	// set the parent window
 	m_hParentWnd = (HWND) hParentWnd;
 
@@ -337,6 +356,10 @@ STDMETHODIMP CController::Run(/*[in]*/ LONG_PTR hParentWnd, /*[in,defaultvalue(1
 
 	ResetEvent(m_hEmuIsRunning);
 
+	vpm_startup_timing_phase("checks");
+
+	ConfigThreadScheduling();
+
 	CreateEventWindow(this);
 
 	DWORD dwThreadID;
@@ -351,9 +374,6 @@ STDMETHODIMP CController::Run(/*[in]*/ LONG_PTR hParentWnd, /*[in,defaultvalue(1
 		return Error(TEXT("Unable to start thread!"));
 	}
 
-	if (g_cpu_affinity_mask > 0)
-		SetThreadAffinityMask(m_hThreadRun, g_cpu_affinity_mask);
-
 	// ok, let's wait for either the machine is set up or the thread terminates for some reason
 	HANDLE StartHandles[2] = {m_hEmuIsRunning, m_hThreadRun};
 
@@ -387,6 +407,7 @@ STDMETHODIMP CController::Stop()
 	
 	CloseHandle(m_hThreadRun);
 	m_hThreadRun = INVALID_HANDLE_VALUE; 
+	vpm_clear_shared_state();
 
 	DestroyEventWindow(this);
 
@@ -533,6 +554,256 @@ STDMETHODIMP CController::get_RawDmdHeight(int *pVal)
 	return S_OK;
 }
 
+/*****************************************************************************************
+ * IController.RawDmdHash property (read-only): hash of the current DMD frame (hex string)
+ *****************************************************************************************/
+STDMETHODIMP CController::get_RawDmdHash(BSTR *pVal)
+{
+	char szHash[17];
+	sprintf(szHash, "%016llx", (unsigned long long)g_raw_dmd_hash);
+	CComBSTR Val(szHash);
+	*pVal = Val.Detach();
+	return S_OK;
+}
+
+/*****************************************************************************************************
+ * IController.RawDmdDirtyRows (read-only): array of booleans, set for the DMD rows that changed since
+ * the last RawDmdPixels/RawDmdColoredPixels read (so it must be read before them)
+ *****************************************************************************************************/
+STDMETHODIMP CController::get_RawDmdDirtyRows(VARIANT *pVal)
+{
+	if (!Machine || (int)g_raw_dmdy <= 0 || !pVal)
+		return S_FALSE;
+
+	SAFEARRAY *psa = SafeArrayCreateVector(VT_VARIANT, 0, g_raw_dmdy);
+
+	VARIANT* pData;
+	SafeArrayAccessData(psa, (void**)&pData);
+	for (UINT32 i = 0; i < g_raw_dmdy; ++i)
+	{
+		pData[i].vt = VT_BOOL;
+		pData[i].boolVal = (i < 64) && ((g_raw_dmd_dirty_rows >> i) & 1) ? VARIANT_TRUE : VARIANT_FALSE;
+	}
+	SafeArrayUnaccessData(psa);
+
+	pVal->vt = VT_ARRAY|VT_VARIANT;
+	pVal->parray = psa;
+
+	return S_OK;
+}
+
+/****************************************************************************************
+ * Shared memory output view (see VPinMAMESharedState.h), created on first MapSharedState
+ * call and updated by the emulation thread on each video frame
+ ****************************************************************************************/
+static HANDLE g_hSharedState = NULL;
+static VPinMAMESharedState* volatile g_pSharedState = NULL;
+static char g_szSharedStateName[64];
+
+extern "C" void vpm_update_shared_state(void)
+{
+	VPinMAMESharedState* const pState = g_pSharedState;
+	if (!pState)
+		return;
+
+	core_update_pwm_lamps();
+	core_update_pwm_solenoids();
+	core_update_pwm_gis();
+
+	const int physSols = coreGlobals.nSolenoids && (options.usemodsol & (CORE_MODOUT_ENABLE_PHYSOUT_SOLENOIDS | CORE_MODOUT_ENABLE_MODSOL | CORE_MODOUT_FORCE_ON));
+	int lampCount = coreGlobals.nLamps > 89 ? coreGlobals.nLamps : 89;
+	if (lampCount > VPM_SHAREDSTATE_MAXLAMPS)
+		lampCount = VPM_SHAREDSTATE_MAXLAMPS;
+
+	InterlockedIncrement(&pState->sequence); // odd: update in progress
+	pState->frame++;
+	pState->running = 1;
+	pState->lampCount = lampCount;
+	for (int ix = 0; ix < lampCount; ix++)
+		pState->lamps[ix] = (unsigned char)vp_getLamp(ix);
+	for (int ix = 0; ix < VPM_SHAREDSTATE_MAXSOLS; ix++) {
+		const int val = vp_getSolenoid(ix);
+		pState->solenoids[ix] = physSols ? (unsigned char)(val > 255 ? 255 : val) : (val ? 1 : 0);
+	}
+	for (int ix = 0; ix < VPM_SHAREDSTATE_MAXGIS; ix++)
+		pState->gis[ix] = (unsigned char)vp_getGI(ix);
+	for (int ix = 0; ix < VPM_SHAREDSTATE_MAXLEDS; ix++)
+		pState->leds[ix] = coreGlobals.drawSeg[ix];
+	pState->dmdWidth = g_raw_dmdx;
+	pState->dmdHeight = g_raw_dmdy;
+	if (pState->dmdHash != g_raw_dmd_hash && (int)g_raw_dmdx > 0 && (int)g_raw_dmdy > 0) {
+		memcpy(pState->dmd, g_raw_dmdbuffer, g_raw_dmdx * g_raw_dmdy);
+		pState->dmdHash = g_raw_dmd_hash;
+	}
+	InterlockedIncrement(&pState->sequence); // even: consistent again
+}
+
+// Publish a changed main DMD frame to the shared memory ring, called by core_dmd_video_update
+extern "C" void vpm_publish_dmd_frame(const int display, const int width, const int height, const UINT8* const dmdDotLum, const UINT8* const dmdDotRaw, const int rawFrameCount, const UINT8* const rawFrames, const UINT64 hash)
+{
+	VPinMAMESharedState* const pState = g_pSharedState;
+	if (!pState || width > VPM_SHAREDSTATE_DMDMAXX || height > VPM_SHAREDSTATE_DMDMAXY)
+		return;
+
+	const unsigned int frame = (unsigned int)pState->dmdFrameCount + 1;
+	VPinMAMESharedDmdFrame* const pFrame = &pState->dmdFrames[(frame - 1) % VPM_SHAREDSTATE_DMDFRAMES];
+	const int count = rawFrameCount > VPM_SHAREDSTATE_DMDRAWFRAMES ? VPM_SHAREDSTATE_DMDRAWFRAMES : rawFrameCount;
+	InterlockedIncrement(&pFrame->sequence); // odd: update in progress
+	pFrame->frame = frame;
+	pFrame->display = display;
+	pFrame->width = width;
+	pFrame->height = height;
+	pFrame->hash = hash;
+	memcpy(pFrame->luminance, dmdDotLum, width * height);
+	memcpy(pFrame->bitplane, dmdDotRaw, width * height);
+	pFrame->rawFrameCount = rawFrames ? count : 0;
+	if (rawFrames)
+		memcpy(pFrame->rawFrames, rawFrames, count * width * height / 8);
+	InterlockedIncrement(&pFrame->sequence); // even: consistent again
+	InterlockedExchange(&pState->dmdFrameCount, (LONG)frame);
+}
+
+static void vpm_clear_shared_state(void)
+{
+	VPinMAMESharedState* const pState = g_pSharedState;
+	if (!pState)
+		return;
+
+	InterlockedIncrement(&pState->sequence);
+	pState->frame++;
+	pState->running = 0;
+	pState->dmdWidth = pState->dmdHeight = 0;
+	pState->dmdHash = 0;
+	memset(pState->lamps, 0, sizeof(pState->lamps));
+	memset(pState->solenoids, 0, sizeof(pState->solenoids));
+	memset(pState->gis, 0, sizeof(pState->gis));
+	memset(pState->leds, 0, sizeof(pState->leds));
+	InterlockedIncrement(&pState->sequence);
+}
+
+/*********************************************************************************************
+ * IController.MapSharedState() method: create (on first call) a named shared memory section
+ * holding the outputs (lamps, solenoids, GI, LEDs, DMD) and return its name, so that hosts
+ * can read them without any COM call (see VPinMAMESharedState.h for layout and locking)
+ *********************************************************************************************/
+STDMETHODIMP CController::MapSharedState(BSTR *pName)
+{
+	if (!pName)
+		return S_FALSE;
+
+	if (!g_pSharedState) {
+		sprintf_s(g_szSharedStateName, sizeof(g_szSharedStateName), "VPinMAMESharedState_%u", (unsigned int)GetCurrentProcessId());
+		HANDLE hMap = CreateFileMapping(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, sizeof(VPinMAMESharedState), g_szSharedStateName);
+		if (!hMap)
+			return E_FAIL;
+		VPinMAMESharedState* const pState = (VPinMAMESharedState*)MapViewOfFile(hMap, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(VPinMAMESharedState));
+		if (!pState) {
+			CloseHandle(hMap);
+			return E_FAIL;
+		}
+		memset(pState, 0, sizeof(VPinMAMESharedState));
+		pState->magic = VPM_SHAREDSTATE_MAGIC;
+		pState->version = VPM_SHAREDSTATE_VERSION;
+		pState->size = sizeof(VPinMAMESharedState);
+		g_hSharedState = hMap;
+		MemoryBarrier();
+		g_pSharedState = pState; // emulation thread starts publishing from here
+	}
+
+	CComBSTR Val(g_szSharedStateName);
+	*pName = Val.Detach();
+	return S_OK;
+}
+
+/*************************************************************************************
+ * IController.LatencyTelemetry property (write-only): start (and reset) or stop the
+ * latency measurements read with Controller.LatencyStats
+ *************************************************************************************/
+STDMETHODIMP CController::put_LatencyTelemetry(VARIANT_BOOL newVal)
+{
+	core_latencyEnable(newVal == VARIANT_TRUE ? 1 : 0);
+	return S_OK;
+}
+
+/*************************************************************************************
+ * IController.LatencyStats property (read-only): wall clock latency of a stage over the
+ * last 1024 samples, as an array (samples, p50, p95, p99, max), times in milliseconds.
+ * Stages: 0 = Switch set to its first read by the ROM, 1 = Switch set to the next
+ * ChangedSolenoids with changes, 2 = DMD frame rendered to RawDmdPixels/RawDmdColoredPixels
+ *************************************************************************************/
+STDMETHODIMP CController::get_LatencyStats(int stage, VARIANT *pVal)
+{
+	if (!pVal || stage < 0 || stage >= CORE_LATENCY_STAGES)
+		return S_FALSE;
+
+	double values[5];
+	values[0] = core_latencyGet(stage, &values[1], &values[2], &values[3], &values[4]);
+
+	SAFEARRAY *psa = SafeArrayCreateVector(VT_VARIANT, 0, 5);
+	VARIANT* pData;
+	SafeArrayAccessData(psa, (void**)&pData);
+	for (int i = 0; i < 5; i++)
+	{
+		pData[i].vt = VT_R8;
+		pData[i].dblVal = i ? values[i] * 1000. : values[i];
+	}
+	SafeArrayUnaccessData(psa);
+
+	pVal->vt = VT_ARRAY|VT_VARIANT;
+	pVal->parray = psa;
+
+	return S_OK;
+}
+
+/*---------------------
+ * Profiler export (Controller.SetProfiler): the request is handed over to the emulation thread,
+ * which applies it on its next video frame; the trace is written when the game stops
+ ****************************************************************************************/
+typedef struct {
+	char traceFile[MAX_PATH];
+	char csvFile[MAX_PATH];
+	double csvInterval;
+} VPMProfilerRequest;
+
+static VPMProfilerRequest* volatile g_pProfilerRequest = NULL;
+
+extern "C" void vpm_update_profiler(void)
+{
+	VPMProfilerRequest* const pRequest = (VPMProfilerRequest*)InterlockedExchangePointer((PVOID volatile*)&g_pProfilerRequest, NULL);
+	if (!pRequest)
+		return;
+
+	profiler_set_trace(pRequest->traceFile[0] ? pRequest->traceFile : NULL);
+	profiler_set_csv(pRequest->csvFile[0] ? pRequest->csvFile : NULL, pRequest->csvInterval);
+	delete pRequest;
+}
+
+void vpm_stop_profiler(void)
+{
+	profiler_set_trace(NULL);
+	profiler_set_csv(NULL, 0.);
+}
+
+/*************************************************************************************
+ * IController.SetProfiler() method: record the emulation subsystems (CPUs, timer
+ * callbacks, video, each sound chip, ...) of the running or next game to a Chrome
+ * trace-event JSON file and/or a CSV file with per section counts, times and p50/p95/p99
+ * durations every csvInterval seconds. Empty file names turn the outputs off.
+ *************************************************************************************/
+STDMETHODIMP CController::SetProfiler(BSTR traceFile, BSTR csvFile, double csvInterval)
+{
+	VPMProfilerRequest* const pRequest = new VPMProfilerRequest;
+	pRequest->traceFile[0] = pRequest->csvFile[0] = 0;
+	if (traceFile)
+		WideCharToMultiByte(CP_ACP, 0, traceFile, -1, pRequest->traceFile, sizeof pRequest->traceFile, NULL, NULL);
+	if (csvFile)
+		WideCharToMultiByte(CP_ACP, 0, csvFile, -1, pRequest->csvFile, sizeof pRequest->csvFile, NULL, NULL);
+	pRequest->csvInterval = csvInterval;
+
+	delete (VPMProfilerRequest*)InterlockedExchangePointer((PVOID volatile*)&g_pProfilerRequest, pRequest);
+	return S_OK;
+}
+
 /**************************************************************************
 * IController.NVRAM (read-only): Copy whole NVRAM to a self allocated array
 ***************************************************************************/
@@ -707,6 +978,8 @@ STDMETHODIMP CController::get_RawDmdPixels(VARIANT *pVal)
 		pVal->parray = psa;
 
 		g_needs_DMD_update = 0;
+		g_raw_dmd_dirty_rows = 0;
+		core_latencyStop(CORE_LATENCY_DMD, -1);
 
 		return S_OK;
 	}
@@ -737,6 +1010,8 @@ STDMETHODIMP CController::get_RawDmdColoredPixels(VARIANT *pVal)
 		pVal->parray = psa;
 
 		g_needs_DMD_update = 0;
+		g_raw_dmd_dirty_rows = 0;
+		core_latencyStop(CORE_LATENCY_DMD, -1);
 
 		return S_OK;
 	}
@@ -949,6 +1224,8 @@ STDMETHODIMP CController::get_ChangedSolenoidsState(int **buf, int *pVal)
 	if (uCount == 0)
 	{ *pVal = 0; return S_OK; }
 
+	core_latencyStop(CORE_LATENCY_SWITCH_SOL, -1);
+
 	/*-- add changed solenoids to array --*/
 	int *dst = reinterpret_cast<int*>(buf);
 	for (int i = 0; i < uCount; i++)
@@ -1206,11 +1483,16 @@ STDMETHODIMP CController::get_Machines(BSTR sMachine, VARIANT *pVal)
 
 	long lCount = pMainGameDriver?1:0;
 
-	long lHelp = 0;
-	while ( drivers[lHelp] ) {
-		if ( !pMainGameDriver || (drivers[lHelp]->clone_of==pMainGameDriver) )
+	// clones come from the driver index, the full list from drivers[]
+	const int nMainGameNo = pMainGameDriver?GetGameNumFromString(pMainGameDriver->name):-1;
+	long lHelp;
+	if ( pMainGameDriver ) {
+		for (lHelp = driver_get_first_clone(nMainGameNo); lHelp>=0; lHelp = driver_get_next_clone(lHelp))
+			lCount++;
+	}
+	else {
+		for (lHelp = 0; drivers[lHelp]; lHelp++)
 			lCount++;
-		lHelp++;
 	}
 
 	SAFEARRAY *psa = SafeArrayCreateVector(VT_VARIANT, 0, lCount);
@@ -1224,15 +1506,19 @@ STDMETHODIMP CController::get_Machines(BSTR sMachine, VARIANT *pVal)
 		lCount++;
 	}
 
-	lHelp = 0;
-	while ( drivers[lHelp] ) {
-		if ( !pMainGameDriver || (drivers[lHelp]->clone_of==pMainGameDriver) ) {
+	if ( pMainGameDriver ) {
+		for (lHelp = driver_get_first_clone(nMainGameNo); lHelp>=0; lHelp = driver_get_next_clone(lHelp)) {
+			varMachineName = drivers[lHelp]->name;
+			SafeArrayPutElement(psa, &lCount, &varMachineName);
+			lCount++;
+		}
+	}
+	else {
+		for (lHelp = 0; drivers[lHelp]; lHelp++) {
 			varMachineName = drivers[lHelp]->name;
 			SafeArrayPutElement(psa, &lCount, &varMachineName);
 			lCount++;
 		}
-
-		lHelp++;
 	}
 
 	pVal->vt = VT_ARRAY|VT_VARIANT;
@@ -1533,6 +1819,8 @@ STDMETHODIMP CController::get_ChangedSolenoids(VARIANT *pVal)
   if (uCount == 0)
 	{ pVal->vt = 0; return S_OK; }
 
+  core_latencyStop(CORE_LATENCY_SWITCH_SOL, -1);
+
   /*-- Create array --*/
   SAFEARRAYBOUND Bounds[] = {{(ULONG)uCount,0}, {2,0}};
   SAFEARRAY *psa = SafeArrayCreate(VT_VARIANT, 2, Bounds);
@@ -1722,6 +2010,33 @@ STDMETHODIMP CController::put_ModOutputType(int output, int no, int newVal)
 	return S_OK;
 }
 
+/****************************************************************************
+ * IController.OutputWatched property: selects the physical outputs that are
+ * integrated (all by default). Output is one of the ModOutputType output
+ * types, 'no' starts at 1, 0 applies to all the outputs of the type.
+ * Unwatched outputs keep their last value and are not reported as changed.
+ ****************************************************************************/
+STDMETHODIMP CController::get_OutputWatched(int output, int no, VARIANT_BOOL* pVal)
+{
+	if (!pVal)
+		return S_FALSE;
+
+	const int watched = vp_getOutputWatched(output, no);
+	if (watched < 0)
+		return S_FALSE;
+
+	*pVal = watched ? VARIANT_TRUE : VARIANT_FALSE;
+
+	return S_OK;
+}
+
+STDMETHODIMP CController::put_OutputWatched(int output, int no, VARIANT_BOOL newVal)
+{
+	vp_setOutputWatched(output, no, newVal == VARIANT_TRUE);
+
+	return S_OK;
+}
+
 /****************************************************************************
  * IController.TimeFence property: sets a time marker that suspend the 
  * emulation when reached until the time fence is moved further away.
@@ -206,6 +206,15 @@ public:
 
 	STDMETHOD(put_TimeFence)(/*[in]*/ double fenceIns);
 	STDMETHOD(get_PMBuildVersion)(/*[out, retval]*/ double *pVal);
+
+	STDMETHOD(get_RawDmdHash)(/*[out, retval]*/ BSTR *pVal);
+	STDMETHOD(get_RawDmdDirtyRows)(/*[out, retval]*/ VARIANT *pVal);
+	STDMETHOD(MapSharedState)(/*[out, retval]*/ BSTR *pName);
+	STDMETHOD(SetProfiler)(/*[in]*/ BSTR traceFile, /*[in]*/ BSTR csvFile, /*[in]*/ double csvInterval);
+	STDMETHOD(put_LatencyTelemetry)(/*[in]*/ VARIANT_BOOL newVal);
+	STDMETHOD(get_LatencyStats)(/*[in]*/ int stage, /*[out, retval]*/ VARIANT *pVal);
+	STDMETHOD(get_OutputWatched)(/*[in]*/ int output, /*[in]*/ int no, /*[out, retval]*/ VARIANT_BOOL *pVal);
+	STDMETHOD(put_OutputWatched)(/*[in]*/ int output, /*[in]*/ int no, /*[in]*/ VARIANT_BOOL newVal);
 };
 
 #endif // !defined(AFX_Controller_H__D2811491_40D6_4656_9AA7_8FF85FD63543__INCLUDED_)
@@ -6,6 +6,7 @@ extern "C"
 #include "gen.h"
 #include "driver.h"
 #include "core.h"
+#include "threadsched.h"
 }
 
 #ifndef WIN32_LEAN_AND_MEAN
@@ -81,6 +82,140 @@ static UINT16      dmd_width = 0; // Only valid if dmd_hasDMD is set
 static UINT16      dmd_height = 0; // Only valid if dmd_hasDMD is set
 static dmddevice_t dmdDevices[2] = { {0} };
 
+// Optional output thread (enabled by the 'dmddevice_queue' setting): frames are copied to a bounded single producer (emulation)
+// / single consumer (output thread) ring, so that a slow device (USB or serial write) does not stall the emulation.
+// When the device falls behind, only the most recent pending frame is sent and older ones are dropped.
+#define DMDDEV_QUEUE_MAX 8
+
+typedef struct {
+	bool isAlphanumeric;
+	// DMD frame
+	int width, height, isDMD2;
+	UINT32 noOfRawFrames;
+	UINT8 lum[DMD_MAXX * DMD_MAXY];
+	UINT8 raw[DMD_MAXX * DMD_MAXY];
+	UINT8 rawbuffer[CORE_MAX_RAW_DMD_FRAMES * DMD_MAXX * DMD_MAXY / 8];
+	// Alphanumeric frame
+	core_segOverallLayout_t layout;
+	UINT16 seg_data[CORE_SEGCOUNT];
+	UINT16 seg_data2[CORE_SEGCOUNT];
+	char seg_dim[CORE_SEGCOUNT];
+} dmddevice_frame_t;
+
+extern int g_dmddevice_queue; // from VPinMAMEConfig.cpp
+
+static dmddevice_frame_t* dmd_queue = NULL;
+static int                dmd_queue_size = 0;   // Number of slots (one more than the configured depth, one slot is always kept free)
+static volatile LONG      dmd_queue_head = 0;   // Next slot written by the emulation thread
+static volatile LONG      dmd_queue_tail = 0;   // Next slot read by the output thread
+static volatile LONG      dmd_queue_dropped = 0;
+static volatile LONG      dmd_queue_quit = 0;
+static HANDLE             dmd_queue_event = NULL;
+static HANDLE             dmd_queue_thread = NULL;
+static CRITICAL_SECTION   dmd_device_lock; // Serialize calls to the plugins between the output thread and the emulation thread (console data)
+
+static void RenderDMDFrame(const int width, const int height, UINT8* dmdDotLum, UINT8* dmdDotRaw, UINT32 noOfRawFrames, UINT8* rawbuffer, const int isDMD2);
+static void RenderAlphanumericFrame(core_segOverallLayout_t layout, UINT16* seg_data, UINT16* seg_data2, char* seg_dim);
+
+static DWORD WINAPI dmddeviceOutputThread(LPVOID lpParam)
+{
+	threadsched_apply(THREADSCHED_DMDDEVICE);
+
+	while (!dmd_queue_quit)
+	{
+		WaitForSingleObject(dmd_queue_event, INFINITE);
+		MemoryBarrier();
+		const LONG tail = dmd_queue_tail;
+		const LONG head = dmd_queue_head;
+		if (tail == head)
+			continue;
+		// Only send the last pending DMD frame and the last pending alphanumeric frame
+		int lastDMD = -1, lastAlpha = -1, pending = 0;
+		for (LONG i = tail; i != head; i = (i + 1) % dmd_queue_size, pending++)
+			if (dmd_queue[i].isAlphanumeric)
+				lastAlpha = i;
+			else
+				lastDMD = i;
+		EnterCriticalSection(&dmd_device_lock);
+		if (lastDMD >= 0) {
+			dmddevice_frame_t* const f = &dmd_queue[lastDMD];
+			RenderDMDFrame(f->width, f->height, f->lum, f->raw, f->noOfRawFrames, f->rawbuffer, f->isDMD2);
+			pending--;
+		}
+		if (lastAlpha >= 0) {
+			dmddevice_frame_t* const f = &dmd_queue[lastAlpha];
+			RenderAlphanumericFrame(f->layout, f->seg_data, f->seg_data2, f->seg_dim);
+			pending--;
+		}
+		LeaveCriticalSection(&dmd_device_lock);
+		if (pending > 0)
+			InterlockedExchangeAdd(&dmd_queue_dropped, pending);
+		InterlockedExchange(&dmd_queue_tail, head);
+	}
+	return 0;
+}
+
+// Returns the next slot to fill, or NULL if the queue is full (the frame is then dropped)
+static dmddevice_frame_t* dmddeviceQueueAcquire()
+{
+	MemoryBarrier();
+	if ((dmd_queue_head + 1) % dmd_queue_size == dmd_queue_tail) {
+		InterlockedIncrement(&dmd_queue_dropped);
+		return NULL;
+	}
+	return &dmd_queue[dmd_queue_head];
+}
+
+static void dmddeviceQueuePublish()
+{
+	InterlockedExchange(&dmd_queue_head, (dmd_queue_head + 1) % dmd_queue_size);
+	SetEvent(dmd_queue_event);
+}
+
+static void dmddeviceStartOutputThread()
+{
+	if (g_dmddevice_queue <= 0)
+		return;
+	InitializeCriticalSection(&dmd_device_lock);
+	dmd_queue_size = (g_dmddevice_queue > DMDDEV_QUEUE_MAX ? DMDDEV_QUEUE_MAX : g_dmddevice_queue) + 1;
+	dmd_queue = (dmddevice_frame_t*)malloc(dmd_queue_size * sizeof(dmddevice_frame_t));
+	dmd_queue_head = dmd_queue_tail = dmd_queue_dropped = dmd_queue_quit = 0;
+	dmd_queue_event = CreateEvent(NULL, FALSE, FALSE, NULL);
+	if (dmd_queue)
+		dmd_queue_thread = CreateThread(NULL, 0, dmddeviceOutputThread, NULL, 0, NULL);
+	if (!dmd_queue_thread) { // Fall back to synchronous output
+		free(dmd_queue);
+		dmd_queue = NULL;
+		CloseHandle(dmd_queue_event);
+		dmd_queue_event = NULL;
+		DeleteCriticalSection(&dmd_device_lock);
+	}
+}
+
+static void dmddeviceStopOutputThread()
+{
+	if (dmd_queue_thread) {
+		InterlockedExchange(&dmd_queue_quit, 1);
+		SetEvent(dmd_queue_event);
+		WaitForSingleObject(dmd_queue_thread, INFINITE);
+		CloseHandle(dmd_queue_thread);
+		dmd_queue_thread = NULL;
+		free(dmd_queue);
+		dmd_queue = NULL;
+		CloseHandle(dmd_queue_event);
+		dmd_queue_event = NULL;
+		DeleteCriticalSection(&dmd_device_lock);
+	}
+}
+
+// Output queue statistics, exposed through the Controller settings ('dmddevice_queued' & 'dmddevice_dropped')
+extern "C" void dmddeviceGetQueueStats(int* pQueued, int* pDropped)
+{
+	const LONG head = dmd_queue_head, tail = dmd_queue_tail;
+	*pQueued = dmd_queue ? (int)((head - tail + dmd_queue_size) % dmd_queue_size) : 0;
+	*pDropped = (int)dmd_queue_dropped;
+}
+
 extern "C"
 {
 	#include "cpu/at91/at91.h"
@@ -88,9 +223,13 @@ extern "C"
 }
 
 extern "C" void dmddeviceFwdConsoleData(UINT8 data) {
+	if (dmd_queue)
+		EnterCriticalSection(&dmd_device_lock);
 	for (int i = 0; i < 2; i++)
 		if (dmdDevices[i].Console_Data)
 			dmdDevices[i].Console_Data(data);
+	if (dmd_queue)
+		LeaveCriticalSection(&dmd_device_lock);
 }
 
 extern "C" int dmddeviceRcvConsoleInput(UINT8* buf, int size)
@@ -173,10 +312,12 @@ extern "C" int dmddeviceInit(const char* GameName, UINT64 HardwareGeneration, co
 		MessageBox(NULL, "No external DMD driver found or DMD driver functions not found", "Visual PinMame Error", MB_ICONERROR);
 		return 0;
 	}
+	dmddeviceStartOutputThread();
 	return 1;
 }
 
 extern "C" void dmddeviceDeInit() {
+	dmddeviceStopOutputThread();
 	for (int i = 0; i < 2; i++)
 	{
 		if (dmd_hasDMD && dmdDevices[i].Render_4_Shades) {
@@ -196,6 +337,26 @@ extern "C" void dmddeviceRenderDMDFrame(const int width, const int height, UINT8
 	dmd_width = width; // store for DeInit
 	dmd_height = height;
 	dmd_hasDMD = true;
+	if (dmd_queue == NULL) {
+		RenderDMDFrame(width, height, dmdDotLum, dmdDotRaw, noOfRawFrames, rawbuffer, isDMD2);
+		return;
+	}
+	dmddevice_frame_t* const f = dmddeviceQueueAcquire();
+	if (f == NULL)
+		return;
+	f->isAlphanumeric = false;
+	f->width = width;
+	f->height = height;
+	f->isDMD2 = isDMD2;
+	f->noOfRawFrames = noOfRawFrames > CORE_MAX_RAW_DMD_FRAMES ? CORE_MAX_RAW_DMD_FRAMES : noOfRawFrames;
+	memcpy(f->lum, dmdDotLum, width * height);
+	memcpy(f->raw, dmdDotRaw, width * height);
+	if (f->noOfRawFrames)
+		memcpy(f->rawbuffer, rawbuffer, f->noOfRawFrames * width * height / 8);
+	dmddeviceQueuePublish();
+}
+
+static void RenderDMDFrame(const int width, const int height, UINT8* dmdDotLum, UINT8* dmdDotRaw, UINT32 noOfRawFrames, UINT8* rawbuffer, const int isDMD2) {
 	for (int i = 0; i < 2; i++)
 	{
 		if ((isDMD2 & (1 << i)) == 0)
@@ -240,6 +401,22 @@ extern "C" void dmddeviceRenderDMDFrame(const int width, const int height, UINT8
 }
 
 extern "C" void dmddeviceRenderAlphanumericFrame(core_segOverallLayout_t layout, UINT16* seg_data, UINT16* seg_data2, char* seg_dim) {
+	if (dmd_queue == NULL) {
+		RenderAlphanumericFrame(layout, seg_data, seg_data2, seg_dim);
+		return;
+	}
+	dmddevice_frame_t* const f = dmddeviceQueueAcquire();
+	if (f == NULL)
+		return;
+	f->isAlphanumeric = true;
+	f->layout = layout;
+	memcpy(f->seg_data, seg_data, sizeof(f->seg_data));
+	memcpy(f->seg_data2, seg_data2, sizeof(f->seg_data2));
+	memcpy(f->seg_dim, seg_dim, sizeof(f->seg_dim));
+	dmddeviceQueuePublish();
+}
+
+static void RenderAlphanumericFrame(core_segOverallLayout_t layout, UINT16* seg_data, UINT16* seg_data2, char* seg_dim) {
 	for (int i = 0; i < 2; i++)
 	{
 		if (dmdDevices[i].Render_PM_Alphanumeric_Dim_Frame)
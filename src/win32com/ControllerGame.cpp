@@ -386,16 +386,7 @@ STDMETHODIMP CGame::get_Settings(IGameSettings **pVal)
 /* Determine Game # from Given GameName String */
 int GetGameNumFromString(const char * const name)
 {
-	int gamenum = 0;
-	while (drivers[gamenum]) {
-		if ( !_stricmp(drivers[gamenum]->name, name) )
-			break;
-		gamenum++;
-	}
-	if ( !drivers[gamenum] )
-		return -1;
-	else
-		return gamenum;
+	return driver_get_index(name);
 }
 
 char* GetGameRegistryKey(char *pszRegistryKey, const char* const pszROMName)
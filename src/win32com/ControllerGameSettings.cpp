@@ -507,6 +507,8 @@ private:
 		bool fGameWasNeverStarted = GameWasNeverStarted(m_szROM);
 
 		/* Delete Game Specific Options from Registry and Reload Defaults */
+		ReloadSettingsCache();
+
 		char szKey[MAX_PATH];
 		lstrcpy(szKey, REG_BASEKEY);
 
@@ -245,17 +245,14 @@ STDMETHODIMP CGames::get_Item(VARIANT *pKey, IGame **pGame)
 		if ( sKey.Length() )
 			sKey.ToLower();
 
-		int i = 0;
-		while ( i<m_lGames ) {
-			if ( m_pGamesList[i] ) {
-				CComBSTR sGameName;
-				m_pGamesList[i]->get_Name(&sGameName);
-				if ( sGameName.Length() )
-					sGameName.ToLower();
-				if ( sGameName==sKey )
-					break;
-			}
-			i++;
+		// m_pGamesList[0] is the default game, drivers[n] is m_pGamesList[n+1]
+		int i = m_lGames+1;
+		if ( sKey.Length() ) {
+			char szKey[256];
+			WideCharToMultiByte(CP_ACP, 0, sKey, -1, szKey, sizeof szKey, NULL, NULL);
+			const int nGameNo = driver_get_index(szKey);
+			if ( nGameNo>=0 )
+				i = nGameNo+1;
 		}
 
 		if ( i>m_lGames )
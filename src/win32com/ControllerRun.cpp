@@ -7,6 +7,7 @@ extern "C" {
 #include "mame.h"
 #include "driver.h"
 #include "./windows/window.h"
+#include "threadsched.h"
 }
 
 #include "VPinMAME.h"
@@ -19,6 +20,9 @@ extern "C" {
 #include "ControllerSplashWnd.h"
 #include "resource.h"
 
+// in Controller.cpp: writes the profiler trace of the game that just stopped
+extern void vpm_stop_profiler(void);
+
 extern "C" {
 int	g_fHandleKeyboard   = TRUE;		// Signals wpc core to handle the keyboard
 int	g_fHandleMechanics  = FALSE;	// Signals wpc core to handle the mechanics for use
@@ -44,6 +48,7 @@ extern int dmd_width;
 extern int dmd_height;
 
 extern int threadpriority;
+extern int splash_mode;
 
 #define VPINMAMEONEVENTMSG	"VPinMAMEOnEventMsg"
 
@@ -53,6 +58,57 @@ extern int threadpriority;
 // we need this, if we call OnSolenoid from the wpc core
 static CController*	m_pController = NULL;
 
+// time spent in each startup phase, from IController.Run to the running machine
+static struct {
+	bool fActive;
+	LARGE_INTEGER liStart;
+	LARGE_INTEGER liLast;
+	char szPhases[512];
+} startupTiming;
+
+void vpm_startup_timing_begin(void)
+{
+	QueryPerformanceCounter(&startupTiming.liStart);
+	startupTiming.liLast = startupTiming.liStart;
+	startupTiming.szPhases[0] = '\0';
+	startupTiming.fActive = true;
+}
+
+void vpm_startup_timing_phase(const char* const pszPhase)
+{
+	if ( !startupTiming.fActive )
+		return;
+
+	LARGE_INTEGER liNow, liFreq;
+	QueryPerformanceCounter(&liNow);
+	QueryPerformanceFrequency(&liFreq);
+
+	const size_t len = strlen(startupTiming.szPhases);
+	_snprintf(startupTiming.szPhases + len, sizeof(startupTiming.szPhases) - len - 1, "%s %s %.1fms",
+		len ? "," : "", pszPhase, (double)(liNow.QuadPart - startupTiming.liLast.QuadPart) * 1000.0 / (double)liFreq.QuadPart);
+	startupTiming.szPhases[sizeof(startupTiming.szPhases) - 1] = '\0';
+	startupTiming.liLast = liNow;
+}
+
+static void vpm_startup_timing_end(void)
+{
+	if ( !startupTiming.fActive )
+		return;
+
+	vpm_startup_timing_phase("machine init");
+	startupTiming.fActive = false;
+
+	LARGE_INTEGER liFreq;
+	QueryPerformanceFrequency(&liFreq);
+
+	char szLine[640];
+	_snprintf(szLine, sizeof(szLine) - 1, "VPinMAME startup %.1fms:%s\n",
+		(double)(startupTiming.liLast.QuadPart - startupTiming.liStart.QuadPart) * 1000.0 / (double)liFreq.QuadPart, startupTiming.szPhases);
+	szLine[sizeof(szLine) - 1] = '\0';
+	OutputDebugString(szLine);
+	logerror("%s", szLine);
+}
+
 BOOL IsEmulationRunning()
 {
 	if ( !m_pController )
@@ -77,6 +133,7 @@ extern "C" void	OnStateChange(int nState)  {
 		return;
 
 	if ( nState ) {
+		vpm_startup_timing_end();
 		SetEvent(m_pController->m_hEmuIsRunning);
 	}
 	else
@@ -92,6 +149,8 @@ DWORD FAR PASCAL CController::RunController(CController* pController)
 	if ( !pController )
 		return 0;
 
+	threadsched_apply(THREADSCHED_EMULATION);
+
 	VARIANT_BOOL fIsSupported;
 	pController->m_pGame->get_IsSupported(&fIsSupported);
 	if ( fIsSupported==VARIANT_FALSE ) {
@@ -105,6 +164,7 @@ DWORD FAR PASCAL CController::RunController(CController* pController)
 
 	// Load the game specific settings
 	LoadGameSettings(pController->m_szROM);
+	vpm_startup_timing_phase("settings");
 
 	// set some options for the mamew environment
 	// set_option("window", "1", 0);
@@ -125,10 +185,15 @@ DWORD FAR PASCAL CController::RunController(CController* pController)
 		options.samplerate = 0; // indicates game sound disabled
 
 #ifndef DEBUG
+	// display the splash screen: it stays while the ROMs are loaded and the
+	// machine is initialized, unless the game should wait for it to close
 	void* pSplashWnd = NULL;
-	if(!cabinetMode)
-	// display the splash screen
-	CreateSplashWnd(&pSplashWnd, pController->m_szSplashInfoLine);
+	if ( !cabinetMode && splash_mode ) {
+		CreateSplashWnd(&pSplashWnd, pController->m_szSplashInfoLine);
+		if ( splash_mode==2 )
+			WaitForSplashWndToClose(&pSplashWnd);
+	}
+	vpm_startup_timing_phase("splash");
 #endif
 
 	// set the global pointer to Controller
@@ -150,6 +215,7 @@ DWORD FAR PASCAL CController::RunController(CController* pController)
 	vpm_game_init(pController->m_nGameNo);
 	run_game(pController->m_nGameNo);
 	vpm_game_exit(pController->m_nGameNo);
+	vpm_stop_profiler();
 
 	SetThreadPriority(pController->m_hThreadRun, THREAD_PRIORITY_NORMAL);
 
@@ -160,9 +226,8 @@ DWORD FAR PASCAL CController::RunController(CController* pController)
 	m_pController = NULL;
 
 #ifndef DEBUG
-	if(!cabinetMode)
-	// destroy the splash screensync
-		DestroySplashWnd(&pSplashWnd); 
+	// destroy the splash screen
+	DestroySplashWnd(&pSplashWnd);
 #endif
 
 	return 0;
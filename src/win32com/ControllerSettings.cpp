@@ -25,6 +25,9 @@ extern BOOL IsEmulationRunning();
 // from VPinMAMEConfig.c
 extern int fAllowWriteAccess;
 
+// from ControllerDmdDevice.cpp
+extern "C" void dmddeviceGetQueueStats(int* pQueued, int* pDropped);
+
 // we need this to adjust the game window if a game is running
 #include "Controller.h"
 extern "C" HWND win_video_window;
@@ -356,6 +359,15 @@ STDMETHODIMP CControllerSettings::get_Value(BSTR sName, VARIANT *pVal)
 	char szName[4096];
 	WideCharToMultiByte(CP_ACP, 0, sName, -1, szName, sizeof szName, NULL, NULL);
 
+	// Read-only DMD device output queue statistics (see 'dmddevice_queue' setting)
+	if ( !lstrcmpi(szName, "dmddevice_queued") || !lstrcmpi(szName, "dmddevice_dropped") ) {
+		int nQueued, nDropped;
+		dmddeviceGetQueueStats(&nQueued, &nDropped);
+		pVal->vt = VT_I4;
+		pVal->lVal = !lstrcmpi(szName, "dmddevice_queued") ? nQueued : nDropped;
+		return S_OK;
+	}
+
 	return GetSetting(NULL, szName, pVal)?S_OK:S_FALSE;
 }
 
@@ -189,8 +189,8 @@ void CreateSplashWnd(void **ppData, char* pszCredits)
 		pSplashWnd->Create((HWND) 0, CWindow::rcDefault, NULL, WS_VISIBLE|WS_POPUP, NULL, 0U, pszCredits);
 		*ppData = pSplashWnd;
 
-		/* remove this line if you want to run the game at once */
-		WaitForSplashWndToClose(ppData);
+		// paint it now, the messages of the thread may only be pumped once the machine runs
+		pSplashWnd->UpdateWindow();
 	}
 }
 
@@ -17,6 +17,9 @@
 #define WINVER _WIN32_WINNT
 #endif
 #include <windows.h>
+#include <map>
+#include <string>
+#include <vector>
 #include "VPinMAMEConfig.h"
 #include "ControllerRegkeys.h"
 
@@ -28,6 +31,7 @@ extern "C" {
   #include "driver.h"
   #include "rc.h"
   #include "misc.h"
+  #include "threadsched.h"
 
   extern struct rc_option fileio_opts[];
   extern struct rc_option input_opts[];
@@ -43,9 +47,26 @@ extern "C" {
   extern char g_fShowPinDMD;
   extern char g_fShowWinDMD;
   extern int g_low_latency_throttle;
+  extern int g_speed_governor;
+  extern char* g_output_export;
+  extern int g_output_export_rate;
+  extern char* g_net_publish;
+  extern int g_net_publish_dmd_rate;
+  extern int g_net_publish_output_rate;
+  extern int g_net_publish_raw;
+  extern int g_net_publish_ttl;
   int g_cpu_affinity_mask = 0;
 }
 
+// affinity masks and realtime scheduling of the other threads, see threadsched.h
+static int emulation_realtime = 0;
+static int audio_affinity_mask = 0;
+static int audio_realtime = 0;
+static int altsound_affinity_mask = 0;
+static int altsound_realtime = 0;
+static int dmddevice_affinity_mask = 0;
+static int dmddevice_realtime = 0;
+
 int fAllowWriteAccess = 1;
 
 int dmd_border = 1;
@@ -72,6 +93,8 @@ int g_vgmwrite = 0;
 int g_force_mono_to_stereo = 0;
 
 int threadpriority = 1;
+int splash_mode = 1;
+int g_dmddevice_queue = 0;
 static int deprecated_synclevel = 0;
 
 static FILE *logfile = NULL;
@@ -91,6 +114,7 @@ static struct rc_option vpinmame_opts[] = {
 	{ "fastframes",  NULL, rc_int,  &fastfrms,  "-1", -1, 100000, NULL, "Unthrottled frames at game start" },
 	{ "ignore_rom_crc", NULL, rc_bool, &ignoreRomCRC,  "0", -1, 1, NULL, "Ignore ROM CRC Errors" },
 	{ "cabinet_mode", NULL, rc_bool, &cabinetMode,  "0", -1, 1, NULL, "Enables Cabinet Mode" },
+	{ "splash", NULL, rc_int, &splash_mode, "1", 0, 2, NULL, "Splash screen (0=None, start immediately,1=Shown while the game starts,2=Start the game when it is closed)" },
 
 	{ "dmd_colorize", NULL, rc_bool, &dmd_colorize, "0", 0, 0, NULL, "Set DMD intensity levels as independent colors" },
 	{ "dmd_red66", NULL, rc_int, &dmd_red66, "225", 0, 255, NULL, "Colorized DMD: red level for 66% intensity" },
@@ -104,7 +128,7 @@ static struct rc_option vpinmame_opts[] = {
 	{ "dmd_blue0", NULL, rc_int, &dmd_blue0, "0", 0, 255, NULL, "Colorized DMD: blue level for 0% intensity" },
 	{ "dmd_opacity", NULL, rc_int, &dmd_opacity, "100", 0, 100, NULL, "Set DMD opacity" },
 
-	{ "resampling_quality", NULL, rc_int, &resampling_quality, "0", 0, 1, NULL, "Quality of the resampling implementation (0=Fast,1=Normal)" },
+	{ "resampling_quality", NULL, rc_int, &resampling_quality, "0", 0, 3, NULL, "Quality of the resampling implementation (0=Fast,1=Normal,2=Linear,3=Zero order hold)" },
 #if defined(VPINMAME_ALTSOUND) || defined(VPINMAME_PINSOUND)
 	{ "sound_mode", NULL, rc_int, &sound_mode, "0", 0, 3, NULL, "Sound processing mode (PinMAME, Alternative, PinSound, PinSound + Recordings)" },
 #endif
@@ -114,7 +138,23 @@ static struct rc_option vpinmame_opts[] = {
 	{ "showwindmd", NULL, rc_bool, &g_fShowWinDMD, "1", 0, 0, NULL, "Show DMD display" },
 
 	{ "cpu_affinity_mask", NULL, rc_int, &g_cpu_affinity_mask, "0", 0, 0, NULL, "CPU affinity mask" },
+	{ "emulation_realtime", NULL, rc_bool, &emulation_realtime, "0", 0, 0, NULL, "Register the emulation thread to MMCSS Pro Audio" },
+	{ "audio_affinity_mask", NULL, rc_int, &audio_affinity_mask, "0", 0, 0, NULL, "CPU affinity mask of the altsound mixer thread" },
+	{ "audio_realtime", NULL, rc_bool, &audio_realtime, "0", 0, 0, NULL, "Register the altsound mixer thread to MMCSS Pro Audio" },
+	{ "altsound_affinity_mask", NULL, rc_int, &altsound_affinity_mask, "0", 0, 0, NULL, "CPU affinity mask of the altsound command thread" },
+	{ "altsound_realtime", NULL, rc_bool, &altsound_realtime, "0", 0, 0, NULL, "Register the altsound command thread to MMCSS Pro Audio" },
+	{ "dmddevice_affinity_mask", NULL, rc_int, &dmddevice_affinity_mask, "0", 0, 0, NULL, "CPU affinity mask of the dmddevice output thread" },
+	{ "dmddevice_realtime", NULL, rc_bool, &dmddevice_realtime, "0", 0, 0, NULL, "Register the dmddevice output thread to MMCSS Pro Audio" },
 	{ "low_latency_throttle", NULL, rc_bool, &g_low_latency_throttle, "1", 0, 0, NULL, "Distribute CPU execution across one emulated frame to minimize flipper latency" },
+	{ "dmddevice_queue", NULL, rc_int, &g_dmddevice_queue, "0", 0, 8, NULL, "Frames queued for the DMD device output thread (0 = send frames synchronously)" },
+	{ "speed_governor", NULL, rc_int, &g_speed_governor, "0", 0, 4, NULL, "Highest accuracy reduction used when the emulation is too slow (0=Off,1=Interleave,2=DMD filter,3=Resampling,4=DMD rendering)" },
+	{ "output_export", NULL, rc_string, &g_output_export, "", 0, 0, NULL, "Named pipe streaming the output changes to DOF or other toy controllers (empty = disabled)" },
+	{ "output_export_rate", NULL, rc_int, &g_output_export_rate, "250", 1, 1000, NULL, "Output export updates per emulated second" },
+	{ "net_publish", NULL, rc_string, &g_net_publish, "", 0, 0, NULL, "UDP address:port (usually a multicast group) streaming the DMD frames and the output changes to networked displays (empty = disabled)" },
+	{ "net_publish_dmd_rate", NULL, rc_int, &g_net_publish_dmd_rate, "60", 0, 1000, NULL, "Network publisher DMD frames per emulated second (0 = no DMD)" },
+	{ "net_publish_output_rate", NULL, rc_int, &g_net_publish_output_rate, "100", 0, 1000, NULL, "Network publisher output updates per emulated second (0 = no outputs)" },
+	{ "net_publish_raw", NULL, rc_bool, &g_net_publish_raw, "0", 0, 0, NULL, "Network publisher sends the raw DMD shades instead of the luminance" },
+	{ "net_publish_ttl", NULL, rc_int, &g_net_publish_ttl, "1", 0, 255, NULL, "Network publisher multicast TTL (1 = local network)" },
 
 	{ "vgmwrite", NULL, rc_bool, &g_vgmwrite, "0", 0, 0, NULL, "Enable to write a VGM of the current session (name is based on romname)" },
 	{ "force_stereo", NULL, rc_bool, &g_force_mono_to_stereo, "0", 0, 0, NULL, "Always force stereo output (e.g. to better support multi channel sound systems)" },
@@ -166,7 +206,19 @@ static const char* GlobalSettings[] = {
 
 	// performance opts
 	"cpu_affinity_mask",
+	"emulation_realtime",
+	"audio_affinity_mask",
+	"audio_realtime",
+	"altsound_affinity_mask",
+	"altsound_realtime",
+	"dmddevice_affinity_mask",
+	"dmddevice_realtime",
 	"low_latency_throttle",
+	"dmddevice_queue",
+	"speed_governor",
+	"output_export",
+	"output_export_rate",
+	"splash",
 
 	NULL
 };
@@ -448,7 +500,173 @@ BOOL SettingAffectsRunningGame(const char* const pszName)
 	return FindSettingInList(RunningGameSettings, pszName);
 }
 
-bool RegLoadOpts(HKEY hKey, rc_option *pOpt, char* pszDefault, char* pszValue)
+static UINT64 AffinityMask(const int mask)
+{
+	return (mask > 0) ? (UINT64)mask : 0;
+}
+
+void ConfigThreadScheduling()
+{
+	threadsched_config(THREADSCHED_EMULATION, AffinityMask(g_cpu_affinity_mask), emulation_realtime);
+	threadsched_config(THREADSCHED_AUDIO, AffinityMask(audio_affinity_mask), audio_realtime);
+	threadsched_config(THREADSCHED_ALTSOUND, AffinityMask(altsound_affinity_mask), altsound_realtime);
+	threadsched_config(THREADSCHED_DMDDEVICE, AffinityMask(dmddevice_affinity_mask), dmddevice_realtime);
+}
+
+/* Settings cache
+
+   The table scripts read and write the settings one by one through the
+   Settings objects. Each registry key is read once, with one enumeration of
+   its values, into this cache. Writes only update the cache and are written
+   back to the registry by FlushSettingsCache(). */
+
+struct RegCacheLess {
+	bool operator()(const std::string& a, const std::string& b) const {
+		return _stricmp(a.c_str(), b.c_str()) < 0;
+	}
+};
+
+struct RegCacheValue {
+	DWORD dwType;
+	std::vector<BYTE> data;
+	bool fDirty;
+};
+
+struct RegCacheKey {
+	std::map<std::string, RegCacheValue, RegCacheLess> values;
+	bool fDirty;
+};
+
+typedef std::map<std::string, RegCacheKey, RegCacheLess> RegCache;
+
+static RegCache regCache;
+
+// the game settings are loaded by the emulation thread, while the script may access them
+static struct RegCacheLock {
+	CRITICAL_SECTION cs;
+	RegCacheLock() { InitializeCriticalSection(&cs); }
+	~RegCacheLock() { DeleteCriticalSection(&cs); }
+} regCacheLock;
+
+struct RegCacheGuard {
+	RegCacheGuard() { EnterCriticalSection(&regCacheLock.cs); }
+	~RegCacheGuard() { LeaveCriticalSection(&regCacheLock.cs); }
+};
+
+static RegCacheKey* RegCacheOpen(const char* const pszKey)
+{
+	RegCache::iterator it = regCache.find(pszKey);
+	if ( it!=regCache.end() )
+		return &it->second;
+
+	RegCacheKey& key = regCache[pszKey];
+	key.fDirty = false;
+
+	HKEY hKey;
+	if ( RegOpenKeyEx(HKEY_CURRENT_USER, pszKey, 0, KEY_QUERY_VALUE, &hKey)!=ERROR_SUCCESS )
+		return &key;
+
+	char szName[256];
+	BYTE data[4096];
+	for ( DWORD dwIndex = 0; ; dwIndex++ ) {
+		DWORD dwNameSize = sizeof szName;
+		DWORD dwSize = sizeof data;
+		DWORD dwType;
+		const LONG lResult = RegEnumValue(hKey, dwIndex, szName, &dwNameSize, NULL, &dwType, data, &dwSize);
+		if ( lResult==ERROR_NO_MORE_ITEMS )
+			break;
+		if ( lResult!=ERROR_SUCCESS ) // name or value too long to be a setting
+			continue;
+
+		RegCacheValue& value = key.values[szName];
+		value.dwType = dwType;
+		value.data.assign(data, data+dwSize);
+		value.fDirty = false;
+	}
+	RegCloseKey(hKey);
+
+	return &key;
+}
+
+/* Same behaviour as RegQueryValueEx, from the cache */
+static LONG RegCacheQuery(const RegCacheKey* const pKey, const char* const pszName, LPDWORD lpType, LPBYTE lpData, LPDWORD lpcbData)
+{
+	if ( !pKey )
+		return ERROR_FILE_NOT_FOUND;
+
+	std::map<std::string, RegCacheValue, RegCacheLess>::const_iterator it = pKey->values.find(pszName);
+	if ( it==pKey->values.end() )
+		return ERROR_FILE_NOT_FOUND;
+
+	const DWORD dwSize = (DWORD)it->second.data.size();
+	*lpType = it->second.dwType;
+	if ( dwSize>*lpcbData ) {
+		*lpcbData = dwSize;
+		return ERROR_MORE_DATA;
+	}
+	if ( dwSize )
+		memcpy(lpData, &it->second.data[0], dwSize);
+	*lpcbData = dwSize;
+
+	return ERROR_SUCCESS;
+}
+
+static LONG RegCacheSet(RegCacheKey* const pKey, const char* const pszName, DWORD dwType, const BYTE* lpData, DWORD cbData)
+{
+	RegCacheValue& value = pKey->values[pszName];
+	value.dwType = dwType;
+	value.data.assign(lpData, lpData+cbData);
+	value.fDirty = true;
+	pKey->fDirty = true;
+
+	return ERROR_SUCCESS;
+}
+
+/* Forget a key (and its pending writes) that is about to be deleted */
+static void RegCacheDrop(const char* const pszKey)
+{
+	regCache.erase(pszKey);
+}
+
+void FlushSettingsCache()
+{
+	RegCacheGuard guard;
+
+	for ( RegCache::iterator it = regCache.begin(); it!=regCache.end(); ++it ) {
+		RegCacheKey& key = it->second;
+		if ( !key.fDirty )
+			continue;
+
+		HKEY hKey;
+		DWORD dwDisposition;
+		if ( RegCreateKeyEx(HKEY_CURRENT_USER, it->first.c_str(), 0, NULL, REG_OPTION_NON_VOLATILE, KEY_SET_VALUE, NULL, &hKey, &dwDisposition)!=ERROR_SUCCESS )
+			continue;
+
+		for ( std::map<std::string, RegCacheValue, RegCacheLess>::iterator itValue = key.values.begin(); itValue!=key.values.end(); ++itValue ) {
+			RegCacheValue& value = itValue->second;
+			if ( !value.fDirty )
+				continue;
+
+			RegSetValueEx(hKey, itValue->first.c_str(), 0, value.dwType, value.data.empty() ? NULL : &value.data[0], (DWORD)value.data.size());
+			value.fDirty = false;
+		}
+		key.fDirty = false;
+
+		RegCloseKey(hKey);
+	}
+}
+
+/* Write the pending changes and read the registry again on next access,
+   to see the changes made outside of this process */
+void ReloadSettingsCache()
+{
+	RegCacheGuard guard;
+
+	FlushSettingsCache();
+	regCache.clear();
+}
+
+bool RegLoadOpts(const RegCacheKey* pKey, rc_option *pOpt, char* pszDefault, char* pszValue)
 {
 	if ( !pszValue )
 		return false;
@@ -467,7 +685,7 @@ bool RegLoadOpts(HKEY hKey, rc_option *pOpt, char* pszDefault, char* pszValue)
 	case rc_float:
 		dwType = REG_SZ;
 		dwSize = sizeof szValue;
-		if ( !hKey || (RegQueryValueEx(hKey, pOpt->name, 0, &dwType, (LPBYTE) &szValue, &dwSize)!=ERROR_SUCCESS) ) {
+		if ( RegCacheQuery(pKey, pOpt->name, &dwType, (LPBYTE) &szValue, &dwSize)!=ERROR_SUCCESS ) {
 			if ( pszDefault )
 				lstrcpy(szValue, pszDefault);
 			else {
@@ -488,7 +706,7 @@ bool RegLoadOpts(HKEY hKey, rc_option *pOpt, char* pszDefault, char* pszValue)
 	case rc_int:
 		dwType = REG_DWORD;
 		dwSize = sizeof dwValue;
-		if ( !hKey || (RegQueryValueEx(hKey, pOpt->name, 0, &dwType, (LPBYTE) &dwValue, &dwSize)!=ERROR_SUCCESS) ) {
+		if ( RegCacheQuery(pKey, pOpt->name, &dwType, (LPBYTE) &dwValue, &dwSize)!=ERROR_SUCCESS ) {
 			if ( pszDefault )
 				lstrcpy(szValue, pszDefault);
 			else {
@@ -506,7 +724,7 @@ bool RegLoadOpts(HKEY hKey, rc_option *pOpt, char* pszDefault, char* pszValue)
 	case rc_bool:
 		dwType = REG_DWORD;
 		dwSize = sizeof dwValue;
-		if ( !hKey || (RegQueryValueEx(hKey, pOpt->name, 0, &dwType, (LPBYTE) &dwValue, &dwSize)!=ERROR_SUCCESS) ) {
+		if ( RegCacheQuery(pKey, pOpt->name, &dwType, (LPBYTE) &dwValue, &dwSize)!=ERROR_SUCCESS ) {
 			if ( pszDefault )
 				lstrcpy(szValue, pszDefault);
 			else {
@@ -527,7 +745,7 @@ bool RegLoadOpts(HKEY hKey, rc_option *pOpt, char* pszDefault, char* pszValue)
 	return fNew;
 }
 
-bool RegSaveOpts(HKEY hKey, rc_option *pOpt, void* pValue)
+bool RegSaveOpts(RegCacheKey* pKey, rc_option *pOpt, void* pValue)
 {
 	bool fFailed = true;
 	char *pszValue;
@@ -541,25 +759,25 @@ bool RegSaveOpts(HKEY hKey, rc_option *pOpt, void* pValue)
 	case rc_string:
 		pszValue = *(char**) pValue;
 		if ( pszValue )
-			fFailed = (RegSetValueEx(hKey, pOpt->name, 0, REG_SZ, (LPBYTE) pszValue, (DWORD)strlen(pszValue)+1)!=ERROR_SUCCESS);
+			fFailed = (RegCacheSet(pKey, pOpt->name, REG_SZ, (const BYTE*) pszValue, (DWORD)strlen(pszValue)+1)!=ERROR_SUCCESS);
 		else {
 			lstrcpy(szTemp, "");
-			fFailed = (RegSetValueEx(hKey, pOpt->name, 0, REG_SZ, (LPBYTE) &szTemp, (DWORD)strlen(szTemp)+1)!=ERROR_SUCCESS);
+			fFailed = (RegCacheSet(pKey, pOpt->name, REG_SZ, (const BYTE*) szTemp, (DWORD)strlen(szTemp)+1)!=ERROR_SUCCESS);
 		}
 		break;
 
 	case rc_int:
-		fFailed = (RegSetValueEx(hKey, pOpt->name, 0, REG_DWORD, (LPBYTE) pValue, sizeof(DWORD))!=ERROR_SUCCESS);
+		fFailed = (RegCacheSet(pKey, pOpt->name, REG_DWORD, (const BYTE*) pValue, sizeof(DWORD))!=ERROR_SUCCESS);
 		break;
 
 	case rc_bool:
 		dwValue = *(int*) pValue?1:0;
-		fFailed = (RegSetValueEx(hKey, pOpt->name, 0, REG_DWORD, (LPBYTE) &dwValue, sizeof(dwValue))!=ERROR_SUCCESS);
+		fFailed = (RegCacheSet(pKey, pOpt->name, REG_DWORD, (const BYTE*) &dwValue, sizeof(dwValue))!=ERROR_SUCCESS);
 		break;
 
 	case rc_float:
 		sprintf(szTemp, "%f", *(float*)pValue);
-		fFailed = (RegSetValueEx(hKey, pOpt->name, 0, REG_SZ, (LPBYTE) szTemp, (DWORD)strlen(szTemp)+1)!=ERROR_SUCCESS);
+		fFailed = (RegCacheSet(pKey, pOpt->name, REG_SZ, (const BYTE*) szTemp, (DWORD)strlen(szTemp)+1)!=ERROR_SUCCESS);
 		break;
 	}
 
@@ -573,10 +791,8 @@ void SaveGlobalSettings()
 	lstrcat(szKey, "\\");
 	lstrcat(szKey, REG_GLOBALS);
 
-	HKEY hKey;
-	DWORD dwDisposition;
-	if ( RegCreateKeyEx(HKEY_CURRENT_USER, szKey, 0, NULL, REG_OPTION_NON_VOLATILE, KEY_SET_VALUE, NULL, &hKey, &dwDisposition)!=ERROR_SUCCESS )
-		return;
+	RegCacheGuard guard;
+	RegCacheKey* pKey = RegCacheOpen(szKey);
 
 	rc_option* opts[10];
 	int sp = 0;
@@ -591,7 +807,7 @@ void SaveGlobalSettings()
 				if ( !IsGlobalSetting(opts[sp]->name) || IgnoreSetting(opts[sp]->name) )
 					break;
 
-				RegSaveOpts(hKey, opts[sp], opts[sp]->dest);
+				RegSaveOpts(pKey, opts[sp], opts[sp]->dest);
 				break;
 
 			case rc_end:
@@ -607,7 +823,7 @@ void SaveGlobalSettings()
 		opts[sp]++;
 	}
 
-	RegCloseKey(hKey);
+	FlushSettingsCache();
 }
 
 void LoadGlobalSettings()
@@ -623,9 +839,11 @@ void LoadGlobalSettings()
 	lstrcat(szKey, "\\");
 	lstrcat(szKey, REG_GLOBALS);
 
-	HKEY hKey = 0;
-	if ( RegOpenKeyEx(HKEY_CURRENT_USER, szKey, 0, KEY_QUERY_VALUE, &hKey)!=ERROR_SUCCESS )
-		hKey = 0;
+	// a new controller: see the changes made to the registry since the last one
+	ReloadSettingsCache();
+
+	RegCacheGuard guard;
+	const RegCacheKey* pKey = RegCacheOpen(szKey);
 
 	rc_option* opts[10];
 	int sp = 0;
@@ -650,7 +868,7 @@ void LoadGlobalSettings()
 				if (opts[sp]->deflt)
 					lstrcat(szDefault, opts[sp]->deflt);
 
-				fNew |= RegLoadOpts(hKey, opts[sp], szDefault, szValue);
+				fNew |= RegLoadOpts(pKey, opts[sp], szDefault, szValue);
 				rc_set_option3(opts[sp], szValue, 0);
 				break;
 
@@ -667,9 +885,6 @@ void LoadGlobalSettings()
 		opts[sp]++;
 	}
 
-	if ( hKey )
-		RegCloseKey(hKey);
-
 	if ( fNew )
 		SaveGlobalSettings();
 }
@@ -679,6 +894,13 @@ void DeleteGlobalSettings()
 	char szKey[MAX_PATH];
 	lstrcpy(szKey, REG_BASEKEY);
 
+	RegCacheGuard guard;
+	char szCacheKey[MAX_PATH];
+	lstrcpy(szCacheKey, REG_BASEKEY);
+	lstrcat(szCacheKey, "\\");
+	lstrcat(szCacheKey, REG_GLOBALS);
+	RegCacheDrop(szCacheKey);
+
 	HKEY hKey;
 	if ( RegOpenKeyEx(HKEY_CURRENT_USER, szKey, 0, KEY_WRITE, &hKey)!=ERROR_SUCCESS )
 		return;
@@ -698,10 +920,8 @@ void SaveGameSettings(const char* const pszGameName)
 	else
 		lstrcat(szKey, REG_DEFAULT);
 
-	HKEY hKey;
-	DWORD dwDisposition;
-	if ( RegCreateKeyEx(HKEY_CURRENT_USER, szKey, 0, NULL, REG_OPTION_NON_VOLATILE, KEY_SET_VALUE, NULL, &hKey, &dwDisposition)!=ERROR_SUCCESS )
-		return;
+	RegCacheGuard guard;
+	RegCacheKey* pKey = RegCacheOpen(szKey);
 
 	rc_option* opts[10];
 	int sp = 0;
@@ -716,7 +936,7 @@ void SaveGameSettings(const char* const pszGameName)
 				if ( IsGlobalSetting(opts[sp]->name) || IgnoreSetting(opts[sp]->name) )
 					break;
 
-				RegSaveOpts(hKey, opts[sp], opts[sp]->dest);
+				RegSaveOpts(pKey, opts[sp], opts[sp]->dest);
 				break;
 
 			case rc_end:
@@ -732,31 +952,29 @@ void SaveGameSettings(const char* const pszGameName)
 		opts[sp]++;
 	}
 
-	RegCloseKey(hKey);
+	FlushSettingsCache();
 }
 
 void LoadGameSettings(const char* const pszGameName)
 {
 	bool fNew = false;
 
-	HKEY hDefaultKey = 0;
+	RegCacheGuard guard;
 
 	char szDefaultKey[MAX_PATH];
 	lstrcpy(szDefaultKey, REG_BASEKEY);
 	lstrcat(szDefaultKey, "\\");
 	lstrcat(szDefaultKey, REG_DEFAULT);
 
-	if ( RegOpenKeyEx(HKEY_CURRENT_USER, szDefaultKey, 0, KEY_QUERY_VALUE, &hDefaultKey)!=ERROR_SUCCESS )
-		hDefaultKey = 0;
+	const RegCacheKey* pDefaultKey = RegCacheOpen(szDefaultKey);
 
-	HKEY hGameKey = 0;
+	const RegCacheKey* pGameKey = NULL;
 	if ( pszGameName && *pszGameName ) {
 		char szGameKey[MAX_PATH];
 		lstrcpy(szGameKey, REG_BASEKEY);
 		lstrcat(szGameKey, "\\");
 		lstrcat(szGameKey, pszGameName);
-		if ( RegOpenKeyEx(HKEY_CURRENT_USER, szGameKey, 0, KEY_QUERY_VALUE, &hGameKey)!=ERROR_SUCCESS )
-			hGameKey = 0;
+		pGameKey = RegCacheOpen(szGameKey);
 	}
 
 	char szValue[4096];
@@ -775,9 +993,9 @@ void LoadGameSettings(const char* const pszGameName)
 					break;
 
 				char szDefault[4096];
-				RegLoadOpts(hDefaultKey, opts[sp], NULL, szDefault);
+				RegLoadOpts(pDefaultKey, opts[sp], NULL, szDefault);
 
-				fNew |= RegLoadOpts(hGameKey, opts[sp], szDefault, szValue);
+				fNew |= RegLoadOpts(pGameKey, opts[sp], szDefault, szValue);
 				rc_set_option3(opts[sp], szValue, 0);
 				break;
 
@@ -794,12 +1012,6 @@ void LoadGameSettings(const char* const pszGameName)
 		opts[sp]++;
 	}
 
-	if ( hGameKey )
-		RegCloseKey(hGameKey);
-
-	if ( hDefaultKey )
-		RegCloseKey(hDefaultKey);
-
 	if ( fNew )
 		SaveGameSettings(pszGameName);
 }
@@ -809,6 +1021,13 @@ void DeleteGameSettings(const char * const pszGameName)
 	char szKey[MAX_PATH];
 	lstrcpy(szKey, REG_BASEKEY);
 
+	RegCacheGuard guard;
+	char szCacheKey[MAX_PATH];
+	lstrcpy(szCacheKey, REG_BASEKEY);
+	lstrcat(szCacheKey, "\\");
+	lstrcat(szCacheKey, (pszGameName && *pszGameName) ? pszGameName : REG_GLOBALS);
+	RegCacheDrop(szCacheKey);
+
 	HKEY hKey;
 	if ( RegOpenKeyEx(HKEY_CURRENT_USER, szKey, 0, KEY_WRITE, &hKey)!=ERROR_SUCCESS )
 		return;
@@ -833,7 +1052,6 @@ BOOL GetSetting(const char* const pszGameName, const char* const pszName, VARIAN
 	if(!(option = rc_get_option2(opts, pszName)))
 		return FALSE;
 
-	HKEY hKey = 0;
 	char szKey[MAX_PATH];
 	lstrcpy(szKey, REG_BASEKEY);
 	lstrcat(szKey, "\\");
@@ -843,17 +1061,16 @@ BOOL GetSetting(const char* const pszGameName, const char* const pszName, VARIAN
 	else
 		lstrcat(szKey, REG_DEFAULT);
 
-	if ( RegOpenKeyEx(HKEY_CURRENT_USER, szKey, 0, KEY_QUERY_VALUE, &hKey)!=ERROR_SUCCESS )
-		hKey = 0;
+	RegCacheGuard guard;
+	const RegCacheKey* pKey = RegCacheOpen(szKey);
 
-	HKEY hGameKey = 0;
+	const RegCacheKey* pGameKey = NULL;
 	if ( pszGameName && *pszGameName ) {
 		char szGameKey[MAX_PATH];
 		lstrcpy(szGameKey, REG_BASEKEY);
 		lstrcat(szGameKey, "\\");
 		lstrcat(szGameKey, pszGameName);
-		if ( RegOpenKeyEx(HKEY_CURRENT_USER, szGameKey, 0, KEY_QUERY_VALUE, &hGameKey)!=ERROR_SUCCESS )
-			hGameKey = 0;
+		pGameKey = RegCacheOpen(szGameKey);
 	}
 
 	char szValue[4096];
@@ -867,8 +1084,8 @@ BOOL GetSetting(const char* const pszGameName, const char* const pszName, VARIAN
 	lstrcat(szHelp, option->deflt);
 
 	char szDefault[4096];
-	RegLoadOpts(hKey, option, szHelp, szDefault);
-	RegLoadOpts(hGameKey, option, szDefault, szValue);
+	RegLoadOpts(pKey, option, szHelp, szDefault);
+	RegLoadOpts(pGameKey, option, szDefault, szValue);
 	CComVariant vValue(szValue);
 
 	switch ( option->type ) {
@@ -885,12 +1102,6 @@ BOOL GetSetting(const char* const pszGameName, const char* const pszName, VARIAN
 		break;
 	}
 
-	if ( hGameKey )
-		RegCloseKey(hGameKey);
-
-	if ( hKey )
-		RegCloseKey(hKey);
-
 	vValue.Detach(pVal);
 
 	return TRUE;
@@ -918,10 +1129,8 @@ BOOL PutSetting(const char* const pszGameName, const char* const pszName, VARIAN
 	else
 		lstrcat(szKey, REG_DEFAULT);
 
-	HKEY hKey;
-	DWORD dwDisposition;
-	if ( RegCreateKeyEx(HKEY_CURRENT_USER, szKey, 0, NULL, REG_OPTION_NON_VOLATILE, KEY_SET_VALUE, NULL, &hKey, &dwDisposition)!=ERROR_SUCCESS )
-		return FALSE;
+	RegCacheGuard guard;
+	RegCacheKey* pKey = RegCacheOpen(szKey);
 
 	BOOL fSuccess = TRUE;
 
@@ -930,7 +1139,7 @@ BOOL PutSetting(const char* const pszGameName, const char* const pszName, VARIAN
 			VariantChangeType(&vValue, &vValue, 0, VT_BOOL);
 			int nValue;
 			nValue = vValue.boolVal ? 1 : 0;
-			RegSaveOpts(hKey, option, &nValue);
+			RegSaveOpts(pKey, option, &nValue);
 			break;
 
 		case rc_string:
@@ -940,17 +1149,17 @@ BOOL PutSetting(const char* const pszGameName, const char* const pszName, VARIAN
 
 			char* pszValue;
 			pszValue = szValue;
-			RegSaveOpts(hKey, option, &pszValue);
+			RegSaveOpts(pKey, option, &pszValue);
 			break;
 
 		case rc_int:
 			VariantChangeType(&vValue, &vValue, 0, VT_I4);
-			RegSaveOpts(hKey, option, &vValue.lVal);
+			RegSaveOpts(pKey, option, &vValue.lVal);
 			break;
 
 		case rc_float:
 			VariantChangeType(&vValue, &vValue, 0, VT_R4);
-			RegSaveOpts(hKey, option, &vValue.fltVal);
+			RegSaveOpts(pKey, option, &vValue.fltVal);
 			break;
 
 		default:
@@ -958,8 +1167,6 @@ BOOL PutSetting(const char* const pszGameName, const char* const pszName, VARIAN
 			break;
 	}
 
-	RegCloseKey(hKey);
-
 	return fSuccess;
 }
 
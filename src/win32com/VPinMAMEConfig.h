@@ -31,4 +31,9 @@ BOOL GetSetting(const char* const pszGameName, const char* const pszName, VARIAN
 
 BOOL SettingAffectsRunningGame(const char* const pszName);
 
+void ConfigThreadScheduling();
+
+void FlushSettingsCache();
+void ReloadSettingsCache();
+
 #endif // VPINMAMECONFIG_H
\ No newline at end of file
@@ -0,0 +1,84 @@
+// VPinMAMESharedState.h : layout of the shared memory output view returned by Controller.MapSharedState
+//
+// The section is created by VPinMAME and updated by the emulation thread once per video frame. Hosts open
+// it with OpenFileMapping(FILE_MAP_READ, FALSE, name) and read it without any further COM call.
+//
+// Consistency is guaranteed by a sequence lock: the writer increments 'sequence' to an odd value before
+// updating the data and to the next even value afterwards. A reader copies what it needs between two
+// reads of 'sequence' and retries if the value was odd or changed:
+//
+//   do {
+//     seq = state->sequence; MemoryBarrier();
+//     ... copy data ...
+//     MemoryBarrier();
+//   } while ((seq & 1) || seq != state->sequence);
+//
+// Values follow the COM getters, with the same numbering: lamps (lampCount entries, like Controller.Lamp),
+// solenoids and GI are 0/1 or, when physical outputs are enabled (ModOutputType), a 0..255 intensity
+// (GI uses the 0..8 WPC levels otherwise). LEDs are the segment bitmasks of ChangedLEDs. The DMD holds the
+// RawDmdPixels luminance values (0..100), row after row, dmdWidth x dmdHeight.
+//
+// Since version 2, each changed main DMD frame is also published, as soon as it is computed, to a ring of
+// VPM_SHAREDSTATE_DMDFRAMES slots with the data sent to dmddevice plugins: linear luminance (0..255), combined
+// bitplane shades and the last raw single bitplane frames (GTS3, WPC and Alvin G. 2 only, 1 bit per dot, high bit
+// first). dmdFrameCount is the number of frames published so far, the last one being in slot
+// (dmdFrameCount - 1) % VPM_SHAREDSTATE_DMDFRAMES. Each slot has its own sequence lock, used like the one above,
+// so that readers can take a frame while the next one is written, and check with 'frame' that they did not miss one.
+
+#ifndef VPINMAMESHAREDSTATE_H
+#define VPINMAMESHAREDSTATE_H
+#pragma once
+
+#define VPM_SHAREDSTATE_MAGIC      0x53534D56 /* 'VMSS' */
+#define VPM_SHAREDSTATE_VERSION    2
+
+#define VPM_SHAREDSTATE_MAXLAMPS  624 /* CORE_MAXLAMPCOL*8 */
+#define VPM_SHAREDSTATE_MAXSOLS    65 /* 0..CORE_MAXSOL, same indexing as Controller.Solenoid */
+#define VPM_SHAREDSTATE_MAXGIS      5 /* CORE_MAXGI */
+#define VPM_SHAREDSTATE_MAXLEDS   128 /* CORE_SEGCOUNT */
+#define VPM_SHAREDSTATE_DMDMAXX   256 /* DMD_MAXX */
+#define VPM_SHAREDSTATE_DMDMAXY    64 /* DMD_MAXY */
+#define VPM_SHAREDSTATE_DMDFRAMES   4 /* DMD frame ring slots */
+#define VPM_SHAREDSTATE_DMDRAWFRAMES 5 /* CORE_MAX_RAW_DMD_FRAMES */
+
+typedef struct {
+	volatile LONG  sequence;                                // sequence lock of this slot (odd while the writer is updating)
+	unsigned int   frame;                                   // number of this frame (dmdFrameCount once written)
+	unsigned int   display;                                 // 0 for the main DMD, 1 for the second DMD of Strikes N' Spares
+	unsigned int   width;
+	unsigned int   height;
+	unsigned int   rawFrameCount;                           // number of frames in rawFrames (0 if not provided by the driver)
+	unsigned long long hash;                                // hash of the luminance and bitplane frames
+	unsigned char  luminance[VPM_SHAREDSTATE_DMDMAXY * VPM_SHAREDSTATE_DMDMAXX];
+	unsigned char  bitplane[VPM_SHAREDSTATE_DMDMAXY * VPM_SHAREDSTATE_DMDMAXX];
+	unsigned char  rawFrames[VPM_SHAREDSTATE_DMDRAWFRAMES * VPM_SHAREDSTATE_DMDMAXY * VPM_SHAREDSTATE_DMDMAXX / 8];
+} VPinMAMESharedDmdFrame;
+
+typedef struct {
+	// header, never changes once the section exists
+	unsigned int   magic;                                   // VPM_SHAREDSTATE_MAGIC
+	unsigned int   version;                                 // VPM_SHAREDSTATE_VERSION
+	unsigned int   size;                                    // sizeof(VPinMAMESharedState)
+
+	volatile LONG  sequence;                                // sequence lock (odd while the writer is updating)
+
+	// data, only consistent under the sequence lock
+	unsigned int   frame;                                   // incremented on each update
+	unsigned int   running;                                 // 0 if no game is running (all outputs are then 0)
+	unsigned int   lampCount;                               // number of valid entries in lamps[]
+	unsigned int   dmdWidth;                                // 0 if the game has no DMD
+	unsigned int   dmdHeight;
+	unsigned long long dmdHash;                             // same as Controller.RawDmdHash
+
+	unsigned char  lamps[VPM_SHAREDSTATE_MAXLAMPS];
+	unsigned char  solenoids[VPM_SHAREDSTATE_MAXSOLS];
+	unsigned char  gis[VPM_SHAREDSTATE_MAXGIS];
+	unsigned short leds[VPM_SHAREDSTATE_MAXLEDS];
+	unsigned char  dmd[VPM_SHAREDSTATE_DMDMAXY * VPM_SHAREDSTATE_DMDMAXX];
+
+	// version 2: DMD frame ring, not covered by the sequence lock above
+	volatile LONG  dmdFrameCount;                           // number of DMD frames published
+	VPinMAMESharedDmdFrame dmdFrames[VPM_SHAREDSTATE_DMDFRAMES];
+} VPinMAMESharedState;
+
+#endif // VPINMAMESHAREDSTATE_H
@@ -31,6 +31,14 @@
 #include "window.h"
 #include "vidhrdw/vector.h"
 
+#if defined(_WIN64) && ((defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || defined(__x86_64__))
+ #define SSE_BLIT_OPT
+ #include <emmintrin.h>
+#elif defined(_WIN64) && (defined(_M_ARM64) || defined(__aarch64__)) && (!defined(_MSC_VER) || defined(__clang__))
+ #define SSE_BLIT_OPT // uses sse2neon then
+ #include "../../ext/sse2neon.h"
+#endif
+
 
 
 //============================================================
@@ -488,6 +496,69 @@ static inline UINT32 sqri(const UINT32 x)
 	return x*x;
 }
 
+#ifdef _WIN64
+//============================================================
+//	expand_row16/expand_row32 - look up a row of 16 bpp
+//	source pixels and write each of them xscale times
+//	(the x2 scales, and x3 for 32 bpp, store 4 or 8 pixels
+//	at once)
+//============================================================
+
+static void expand_row16(UINT16 * __restrict dst, const UINT8 * __restrict src, const int srcstep, const int count, const int xscale, const UINT32 * __restrict lookup)
+{
+	int x = 0;
+#ifdef SSE_BLIT_OPT
+	if (xscale == 2)
+		for (; x <= count - 8; x += 8, src += 8 * srcstep, dst += 16)
+		{
+			const __m128i col = _mm_set_epi16(
+				(short)lookup[*(const UINT16 *)(src + 7 * srcstep)], (short)lookup[*(const UINT16 *)(src + 6 * srcstep)],
+				(short)lookup[*(const UINT16 *)(src + 5 * srcstep)], (short)lookup[*(const UINT16 *)(src + 4 * srcstep)],
+				(short)lookup[*(const UINT16 *)(src + 3 * srcstep)], (short)lookup[*(const UINT16 *)(src + 2 * srcstep)],
+				(short)lookup[*(const UINT16 *)(src + srcstep)], (short)lookup[*(const UINT16 *)src]);
+			_mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi16(col, col));
+			_mm_storeu_si128((__m128i *)(dst + 8), _mm_unpackhi_epi16(col, col));
+		}
+#endif
+	for (; x < count; ++x, src += srcstep)
+	{
+		const UINT16 col = (UINT16)lookup[*(const UINT16 *)src];
+		int s;
+		for (s = 0; s < xscale; ++s)
+			*dst++ = col;
+	}
+}
+
+static void expand_row32(UINT32 * __restrict dst, const UINT16 * __restrict src, const int count, const int xscale, const UINT32 * __restrict lookup)
+{
+	int x = 0;
+#ifdef SSE_BLIT_OPT
+	if (xscale == 2)
+		for (; x <= count - 4; x += 4, src += 4, dst += 8)
+		{
+			const __m128i col = _mm_set_epi32(lookup[src[3]], lookup[src[2]], lookup[src[1]], lookup[src[0]]);
+			_mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi32(col, col));
+			_mm_storeu_si128((__m128i *)(dst + 4), _mm_unpackhi_epi32(col, col));
+		}
+	else if (xscale == 3)
+		for (; x <= count - 4; x += 4, src += 4, dst += 12)
+		{
+			const __m128i col = _mm_set_epi32(lookup[src[3]], lookup[src[2]], lookup[src[1]], lookup[src[0]]);
+			_mm_storeu_si128((__m128i *)dst, _mm_shuffle_epi32(col, _MM_SHUFFLE(1, 0, 0, 0)));
+			_mm_storeu_si128((__m128i *)(dst + 4), _mm_shuffle_epi32(col, _MM_SHUFFLE(2, 2, 1, 1)));
+			_mm_storeu_si128((__m128i *)(dst + 8), _mm_shuffle_epi32(col, _MM_SHUFFLE(3, 3, 3, 2)));
+		}
+#endif
+	for (; x < count; ++x)
+	{
+		const UINT32 col = lookup[*src++];
+		int s;
+		for (s = 0; s < xscale; ++s)
+			*dst++ = col;
+	}
+}
+#endif
+
 int win_perform_blit(const struct win_blit_params * const blit, int update)
 {
 	int srcdepth = (blit->srcdepth + 7) / 8;
@@ -616,18 +687,11 @@ int win_perform_blit(const struct win_blit_params * const blit, int update)
 
 		for (int c = 0; c < blit_srcheight; ++c) // y loop
 		{
-			int c2,c2d=0;
-			const UINT8* __restrict pushed_src = src;
-			for (c2 = 0; c2 < blit_srcwidth; ++c2) // x loop
-			{
-				const UINT16 col = blit->srclookup[*(UINT16*)src];
-				for (int s = 0; s < blit->dstxscale; ++s,++c2d)
-					((UINT16*)dst)[c2d] = col;
-				src += valuefixups[FIXUPVAL_SRCBYTES1];
-			}
+			int c2;
+			expand_row16((UINT16*)dst, src, valuefixups[FIXUPVAL_SRCBYTES1], blit_srcwidth, blit->dstxscale, blit->srclookup);
 			for (c2 = 1; c2 < blit->dstyscale; ++c2)
 				memcpy(dst + blit->dstpitch*c2, dst, blit->dstpitch);
-			src = pushed_src + valuefixups[FIXUPVAL_SRCADVANCE];
+			src += valuefixups[FIXUPVAL_SRCADVANCE];
 			dst += blit->dstpitch * blit->dstyscale;
 		}
 #endif
@@ -640,14 +704,8 @@ int win_perform_blit(const struct win_blit_params * const blit, int update)
 
 		for (c = 0; c < asmblit_srcheight; ++c)
 		{
-			int c2,c2d=0;
-			for (c2 = 0; c2 < blit->srcwidth; ++c2)
-			{
-				const UINT32 col = blit->srclookup[((UINT16*)src)[c2]];
-				int s;
-				for (s = 0; s < blit->dstxscale; ++s,++c2d)
-					((UINT32*)dst)[c2d] = col;
-			}
+			int c2;
+			expand_row32((UINT32*)dst, (const UINT16*)src, blit->srcwidth, blit->dstxscale, blit->srclookup);
 			for (c2 = 1; c2 < blit->dstyscale; ++c2)
 				memcpy(dst + blit->dstpitch*c2, dst, blit->dstpitch);
 			src += blit->srcpitch;
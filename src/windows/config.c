@@ -51,6 +51,7 @@ extern struct rc_option fileio_opts[];
 extern struct rc_option input_opts[];
 extern struct rc_option sound_opts[];
 extern struct rc_option video_opts[];
+extern int g_speed_governor;
 
 #ifdef MESS
 #include "configms.h"
@@ -90,10 +91,11 @@ struct rc_option pinmame_opts[] = {
         { "dmd_green0", NULL, rc_int, &pmoptions.dmd_green0, "0", 0, 255, NULL, "Colorized DMD: 0%: Green" },
         { "dmd_blue0", NULL, rc_int, &pmoptions.dmd_blue0, "0", 0, 255, NULL, "Colorized DMD: 0%: Blue" },
         { "dmd_opacity", NULL, rc_int, &pmoptions.dmd_opacity, "100", 0, 100, NULL, "DMD opacity" },
-        { "resampling_quality", NULL, rc_int, &pmoptions.resampling_quality, "0", 0, 1, NULL, "Quality of the resampling implementation (0=Fast,1=Normal)" },
+        { "resampling_quality", NULL, rc_int, &pmoptions.resampling_quality, "0", 0, 3, NULL, "Quality of the resampling implementation (0=Fast,1=Normal,2=Linear,3=Zero order hold)" },
 #if defined(VPINMAME_ALTSOUND) || defined(VPINMAME_PINSOUND)
         { "sound_mode", NULL, rc_int, &pmoptions.sound_mode, "0", 0, 3, NULL, "Sound processing mode (PinMAME, Alternative, PinSound, PinSound + Recordings)" },
 #endif
+        { "speed_governor", NULL, rc_int, &g_speed_governor, "0", 0, 4, NULL, "Highest accuracy reduction used when the emulation is too slow (0=Off,1=Interleave,2=DMD filter,3=Resampling,4=DMD rendering)" },
 #ifdef PROC_SUPPORT
 // TODO/PROC: Correct implementation?
         { "p-roc", NULL, rc_string, &pmoptions.p_roc, "None",  0, 0, NULL, "YAML Machine description file" },
@@ -101,6 +103,8 @@ struct rc_option pinmame_opts[] = {
         { "virtual_dmd",  NULL, rc_bool, &pmoptions.virtual_dmd,  "1",  0, 0, NULL, "Enable DMD emulation" },
 #endif /* PROC_SUPPORT */
         { "vgmwrite", NULL, rc_bool, &pmoptions.vgmwrite, "0", 0, 0, NULL, "Enable to write a VGM of the current session (name is based on romname)" },
+        { "soundrip", NULL, rc_bool, &pmoptions.soundrip, "0", 0, 0, NULL, "Dump every sound command to its own wave file plus an altsound CSV unthrottled, then exit" },
+        { "soundrip_prefix", NULL, rc_int, &pmoptions.soundrip_prefix, "-1", -1, 255, NULL, "First byte sent before each ripped sound command (-1 = none)" },
         { "force_stereo", NULL, rc_bool, &pmoptions.force_mono_to_stereo, "0", 0, 0, NULL, "Always force stereo output (e.g. to better support multi channel sound systems)" },
 #ifdef PINMAME_HOST_UART
         { "serial_device", NULL, rc_string, &pmoptions.serial_device, NULL, 0, 0, NULL, "COM port mapped to WPC UART" },
@@ -723,6 +727,12 @@ int cli_frontend_init (int argc, char **argv)
         if (!enable_sound)
                 options.samplerate = 0;
 
+#ifdef PINMAME
+        /* the sound ripper runs as fast as the machine allows */
+        if (pmoptions.soundrip)
+                throttle = 0;
+#endif /* PINMAME */
+
         /* set the artwork options */
         options.use_artwork = ARTWORK_USE_ALL;
         if (use_backdrops == 0)
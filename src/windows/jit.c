@@ -2,6 +2,7 @@
 #include <string.h>
 #include <assert.h>
 
+#ifdef _WIN32
 #ifndef WIN32_LEAN_AND_MEAN
 #define WIN32_LEAN_AND_MEAN
 #endif
@@ -17,6 +18,10 @@
 #define WINVER _WIN32_WINNT
 #endif
 #include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 #include "memory.h"
 
@@ -26,39 +31,31 @@
 #if JIT_ENABLED
 
 #if JIT_DEBUG
-//
-// debug mode
-//
-
 // enable ASSERTions
 #define ASSERT(x) assert(x)
-
-// In debug mode, set generated code pages to EXECUTE+READ mode only (no write access)
-// during normal execution.  This protects our generated code against stray pointer overwrites
-// when we're not explicitly generating code, which can be helpful in isolating bugs that
-// corrupt random memory by causing a hard memory fault if we try to write a code page in
-// error.  We only use this mode during debugging, because it costs us some extra time when
-// we generate new JIT code, because we have to make a couple of Windows API calls to change
-// the memory protection for the memory holding the generated code (to make it writable, then
-// set it back to execute-only).
-#define DbgVirtualProtect(addr, len, mode, pOldMode) { BOOL VPres = VirtualProtect(addr, len, mode, pOldMode); assert(VPres != 0); }
-
 #else
-//
-// Release mode
-//
-
 // turn off assertions
 #define ASSERT(x)
-
-// Release mode - keep the code page in EXECUTE+READ+WRITE mode all the time.  This makes
-// write access during code generation faster, the trade-off being that it exposes generated
-// code pages to stray pointer overwrites.  That's only a problem if there are bugs, and
-// release code *should* be bug-free, so...
-#define DbgVirtualProtect(addr, len, mode, pOldMode) (*(pOldMode) = 0)
-
 #endif // JIT_DEBUG
 
+// In W^X mode (always in debug mode, and on every host but 32-bit Intel),
+// generated code pages are EXECUTE+READ only (no write access) during normal
+// execution.  This protects our generated code against stray pointer overwrites
+// when we're not explicitly generating code, which can be helpful in isolating
+// bugs that corrupt random memory by causing a hard memory fault if we try to
+// write a code page in error, and it's mandatory on hosts that refuse to map
+// pages writable and executable at the same time.
+//
+// Otherwise we keep the code page in EXECUTE+READ+WRITE mode all the time.
+// This makes write access during code generation faster, the trade-off being
+// that it exposes generated code pages to stray pointer overwrites.  That's
+// only a problem if there are bugs, and release code *should* be bug-free, so...
+#if JIT_WX_STRICT
+#define JitProtect(addr, len, writable) jit_code_protect(addr, len, writable)
+#else
+#define JitProtect(addr, len, writable)
+#endif
+
 static struct jit_page *jit_add_page(struct jit_ctl *jit, int min_siz);
 static byte *emit_lookup_code(struct jit_ctl *jit, int patch);
 static void init_code_pages(struct jit_ctl *jit);
@@ -76,6 +73,7 @@ struct jit_ctl *_jit_create(int *cycle_counter, int rshift)
 	jit->minAddr = 0;
 	jit->maxAddr = 0;
 	jit->native = 0;
+	jit->codePages = 0;
 	jit->rshift = rshift;
 	jit->pages = 0;
 	jit->mem_count = 0;
@@ -101,6 +99,10 @@ void jit_reset(struct jit_ctl *jit)
 	for (i = 0 ; i < nAddrs ; ++i)
 		jit->native[i] = jit->pEmulate;
 
+	// there's no translated code left in any page
+	if (jit->codePages != 0)
+		memset(jit->codePages, 0, ((jit->maxAddr - jit->minAddr) >> JIT_CODE_PAGE_SHIFT) + 1);
+
 	// delete all native code pages
 	delete_code_pages(jit);
 
@@ -189,26 +191,22 @@ static byte *rtlookup_patch(struct jit_ctl *jit, data32_t addr, byte *caller)
 	// so go back 10 bytes and replace the MOV.
 	if (nat != jit->pEmulate && nat != jit->pPending)
 	{
-		DWORD prvPro;
-		BOOL res;
-
 		// back up the caller address to the MOV instruction
 		caller -= 10;
 		ASSERT(caller[0] == 0xB8 && caller[5] == 0xE8);  // MOV, CALL
 
 		// make the code page temporarily writable
-		DbgVirtualProtect(caller, 10, PAGE_EXECUTE_READWRITE, &prvPro);
+		JitProtect(caller, 10, 1);
 
 		// patch the MOV with JMP ofs32
 		caller[0] = 0xE9;       // JMP ofs32
 		*(UINT32 *)&caller[1] = (UINT32)(nat - (caller+5));
 
-		// restore the old page protection
-		DbgVirtualProtect(caller, 10, prvPro, &prvPro);
+		// restore the execute-only page protection
+		JitProtect(caller, 10, 0);
 
 		// flush the CPU instruction cache for the area where the new code resides
-		res = FlushInstructionCache(GetCurrentProcess(), caller, 10);
-		ASSERT(res != 0);
+		jit_code_flush(caller, 10);
 	}
 
 	// return the native address to invoke
@@ -331,8 +329,7 @@ static void delete_code_pages(struct jit_ctl *jit)
 		struct jit_page *nxt = p->nxt;
 
 		// free the code space
-		BOOL res = VirtualFree(p->b, 0, MEM_RELEASE);
-		ASSERT(res != 0);
+		jit_code_free(p->b, p->siz);
 
 		// free the page descriptor
 		free(p);
@@ -359,6 +356,8 @@ void jit_create_map(struct jit_ctl *jit, data32_t minAddr, data32_t maxAddr)
 	// if there's an existing map, delete it
 	if (jit->native != 0)
 		free(jit->native);
+	if (jit->codePages != 0)
+		free(jit->codePages);
 
 	// figure the size in bytes of the address space (NB: the range is
 	// exclusive of maxAddr)
@@ -381,6 +380,9 @@ void jit_create_map(struct jit_ctl *jit, data32_t minAddr, data32_t maxAddr)
 	// translation until the bootstrapping process is finished
 	for (i = 0 ; i < nAddrs ; ++i)
 		jit->native[i] = jit->pEmulate;
+
+	// allocate the code page flags, nothing is translated yet
+	jit->codePages = (byte *)calloc((nBytes >> JIT_CODE_PAGE_SHIFT) + 1, 1);
 }
 
 void jit_set_mem_callbacks(
@@ -429,14 +431,14 @@ void jit_untranslate(struct jit_ctl *jit, data32_t addr)
 	p = JIT_NATIVE(jit, addr);
 	if (p != jit->pEmulate && p != jit->pPending)
 	{
-		BOOL res;
-
 		// Replace the code with MOV EAX,<emulator address>, RETN.
 		// This will return to the emulator and resume emulation at the
 		// replaced code address.
+		JitProtect(p, 6, 1);
 		p[0] = 0xB8;                 // MOV EAX,Imm32
 		*(UINT32 *)(&p[1]) = addr;   // ... the immediate data for the MOV
 		p[5] = 0xC3;                 // RETN
+		JitProtect(p, 6, 0);
 
 		// Set the opcode mapping to 'emulate', so that we don't try
 		// to translate it again in the future.  Once a location is written,
@@ -446,8 +448,50 @@ void jit_untranslate(struct jit_ctl *jit, data32_t addr)
 		jit->native[(addr - jit->minAddr) >> jit->rshift] = jit->pEmulate;
 
 		// flush the instruction cache for this section of code
-		res = FlushInstructionCache(GetCurrentProcess(), p, 128); //!! 128?!
-		ASSERT(res != 0);
+		jit_code_flush(p, 128); //!! 128?!
+	}
+}
+
+void jit_untranslate_range(struct jit_ctl *jit, data32_t addr, data32_t len, int retranslate)
+{
+	data32_t end, page, opsiz = (data32_t)1 << jit->rshift;
+
+	// clip the range to the JIT covered memory space
+	if (len == 0 || addr >= jit->maxAddr || addr + len <= jit->minAddr)
+		return;
+	end = (addr + len > jit->maxAddr) ? jit->maxAddr : addr + len;
+	if (addr < jit->minAddr)
+		addr = jit->minAddr;
+
+	// include the opcode that the first byte belongs to
+	addr -= (addr - jit->minAddr) & (opsiz - 1);
+
+	// visit the code pages covering the range
+	for (page = (addr - jit->minAddr) >> JIT_CODE_PAGE_SHIFT ; ; ++page)
+	{
+		data32_t pgStart = jit->minAddr + (page << JIT_CODE_PAGE_SHIFT);
+		data32_t pgEnd = pgStart + JIT_CODE_PAGE_SIZE;
+		data32_t from, to, a;
+
+		if (pgStart >= end)
+			break;
+
+		// nothing was ever translated in this page
+		if (!jit->codePages[page])
+			continue;
+
+		from = (addr > pgStart) ? addr : pgStart;
+		to = (end < pgEnd) ? end : pgEnd;
+		for (a = from ; a < to ; a += opsiz)
+		{
+			jit_untranslate(jit, a);
+			if (retranslate && JIT_NATIVE(jit, a) == jit->pEmulate)
+				JIT_NATIVE(jit, a) = jit->pPending;
+		}
+
+		// if the whole page was processed, none of its code is translated anymore
+		if (from == pgStart && to == pgEnd)
+			jit->codePages[page] = 0;
 	}
 }
 
@@ -459,6 +503,8 @@ void jit_delete(struct jit_ctl **jit)
 	// free the mapping array
 	if ((*jit)->native != 0)
 		free((*jit)->native);
+	if ((*jit)->codePages != 0)
+		free((*jit)->codePages);
 
 	// free the control structure
 	free(*jit);
@@ -469,7 +515,6 @@ byte *jit_reserve_native(struct jit_ctl *jit, int len, struct jit_page **pgp)
 {
 	struct jit_page *pg;
 	byte *res;
-	DWORD prvPro;
 
 	// find an existing page with space for the new code
 	for (pg = jit->pages ; pg != 0 && pg->siz - pg->ofsFree < len ; pg = pg->nxt) ;
@@ -489,7 +534,7 @@ byte *jit_reserve_native(struct jit_ctl *jit, int len, struct jit_page **pgp)
 	res = pg->b + pg->ofsFree;
 
 	// open this memory to writing
-	DbgVirtualProtect(res, len, PAGE_EXECUTE_READWRITE, &prvPro);
+	JitProtect(res, len, 1);
 
 	// return the destination pointer
 	return pg->b + pg->ofsFree;
@@ -497,10 +542,8 @@ byte *jit_reserve_native(struct jit_ctl *jit, int len, struct jit_page **pgp)
 
 void jit_close_native(struct jit_ctl *jit, byte *addr, int len)
 {
-	DWORD prvPro;
-
 	// make the reserved memory executable and non-writable
-	DbgVirtualProtect(addr, len, PAGE_EXECUTE_READ, &prvPro);
+	JitProtect(addr, len, 0);
 }
 
 byte *jit_store_native(struct jit_ctl *jit, const byte *code, int len)
@@ -512,8 +555,6 @@ byte *jit_store_native(struct jit_ctl *jit, const byte *code, int len)
 	// copy the data, if any
 	if (len != 0)
 	{
-		BOOL res;
-
 		// store the instruction data
 		memcpy(dst, code, len);
 
@@ -521,8 +562,7 @@ byte *jit_store_native(struct jit_ctl *jit, const byte *code, int len)
 		pg->ofsFree += len;
 		
 		// flush the CPU instruction cache for the area where the new code resides
-		res = FlushInstructionCache(GetCurrentProcess(), dst, len);
-		ASSERT(res != 0);
+		jit_code_flush(dst, len);
 	}
 
 	// return the new code address
@@ -534,8 +574,6 @@ void jit_store_native_from_reserved(struct jit_ctl *jit, const byte *code, int l
 	// copy the data, if any
 	if (len != 0)
 	{
-		BOOL res;
-
 		// store the instruction data
 		memcpy(dst, code, len);
 
@@ -543,17 +581,12 @@ void jit_store_native_from_reserved(struct jit_ctl *jit, const byte *code, int l
 		pg->ofsFree += len;
 		
 		// flush the CPU instruction cache for the area where the new code resides
-		res = FlushInstructionCache(GetCurrentProcess(), dst, len);
-		ASSERT(res != 0);
+		jit_code_flush(dst, len);
 	}
 }
 
 static struct jit_page *jit_add_page(struct jit_ctl *jit, int min_siz)
 {
-#if JIT_DEBUG
-	DWORD prvPro;
-	BOOL res;
-#endif
 	int siz;
 	struct jit_page *p;
 
@@ -653,21 +686,83 @@ static struct jit_page *jit_add_page(struct jit_ctl *jit, int min_siz)
 	p->nxt = jit->pages;
 	jit->pages = p;
 
-	// allocate the code space
-	p->b = (byte *)VirtualAlloc(0, siz, MEM_RESERVE | MEM_COMMIT, PAGE_EXECUTE_READWRITE);
+	// allocate the code space (jit_reserve_native/jit_close_native take
+	// care of the protection of the parts we actually store code in)
+	p->b = jit_code_alloc(siz);
 	ASSERT(p->b != NULL);
 
-#if JIT_DEBUG
-	res = FlushInstructionCache(GetCurrentProcess(), p->b, siz);
+	// return the new page pointer
+	jit->mem_count+=siz;
+	return p;
+}
+
+// --------------------------------------------------------------------------
+//
+// Host code memory primitives
+//
+
+#ifndef _WIN32
+// round a code range out to whole host pages, as mprotect() requires
+static void jit_page_range(byte *addr, int len, byte **start, size_t *size)
+{
+	const size_t pgsiz = (size_t)sysconf(_SC_PAGESIZE);
+	const size_t a = (size_t)addr & ~(pgsiz - 1);
+	*start = (byte *)a;
+	*size = (((size_t)addr + len + pgsiz - 1) & ~(pgsiz - 1)) - a;
+}
+#endif
+
+byte *jit_code_alloc(int siz)
+{
+#ifdef _WIN32
+	return (byte *)VirtualAlloc(0, siz, MEM_RESERVE | MEM_COMMIT, JIT_WX_STRICT ? PAGE_READWRITE : PAGE_EXECUTE_READWRITE);
+#else
+	int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+	void *b;
+#ifdef MAP_JIT
+	// required for executable mappings under the hardened runtime on macOS
+	flags |= MAP_JIT;
+#endif
+	b = mmap(0, siz, JIT_WX_STRICT ? (PROT_READ | PROT_WRITE) : (PROT_READ | PROT_WRITE | PROT_EXEC), flags, -1, 0);
+	return b == MAP_FAILED ? NULL : (byte *)b;
+#endif
+}
+
+void jit_code_free(byte *b, int siz)
+{
+#ifdef _WIN32
+	BOOL res = VirtualFree(b, 0, MEM_RELEASE);
 	ASSERT(res != 0);
+#else
+	munmap(b, siz);
+#endif
+}
 
-	// make the code space non-accessable (jit_reserve_native will redo it later-on on its own) 
-	DbgVirtualProtect(p->b, siz, PAGE_NOACCESS, &prvPro);
+void jit_code_protect(byte *addr, int len, int writable)
+{
+#ifdef _WIN32
+	DWORD prvPro;
+	BOOL res = VirtualProtect(addr, len, writable ? PAGE_READWRITE : PAGE_EXECUTE_READ, &prvPro);
+	ASSERT(res != 0);
+#else
+	byte *start;
+	size_t size;
+	int res;
+	jit_page_range(addr, len, &start, &size);
+	res = mprotect(start, size, writable ? (PROT_READ | PROT_WRITE) : (PROT_READ | PROT_EXEC));
+	ASSERT(res == 0);
 #endif
+}
 
-	// return the new page pointer
-	jit->mem_count+=siz;
-	return p;
+void jit_code_flush(byte *addr, int len)
+{
+#ifdef _WIN32
+	BOOL res = FlushInstructionCache(GetCurrentProcess(), addr, len);
+	ASSERT(res != 0);
+#else
+	// no-op on Intel hosts, required on ARM hosts with split I/D caches
+	__builtin___clear_cache((char *)addr, (char *)addr + len);
+#endif
 }
 
 #endif /* JIT_ENABLED */
@@ -253,7 +253,20 @@
 
 typedef unsigned char byte;
 
-#if defined(_MSC_VER) && (_MSC_VER >= 1400) && !defined(__LP64__) && !defined(_M_ARM) // visual studio & > 6 & 32bit compile
+// Host instruction set.  The code page management in jit.c (allocation,
+// W^X protection switching, instruction cache flushing) works on all of
+// these, but only the 32-bit Intel host has an emitter (jitemit.c) and a
+// native call thunk (the __asm block in the emulator loop), so translation
+// stays disabled on the other hosts until their back ends exist.
+#if defined(_M_IX86) || defined(__i386__)
+#define JIT_HOST_X86   1
+#elif defined(_M_X64) || defined(__x86_64__)
+#define JIT_HOST_X64   1
+#elif defined(_M_ARM64) || defined(__aarch64__)
+#define JIT_HOST_ARM64 1
+#endif
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1400) && defined(JIT_HOST_X86) && !defined(__LP64__) // visual studio & > 6 & 32bit compile
 #define JIT_ENABLED  1   // enable the JIT (false -> use only the standard emulator code)
 #else
 #define JIT_ENABLED  0
@@ -261,6 +274,20 @@ typedef unsigned char byte;
 
 #define JIT_DEBUG    0   // enable additional debugging code in the JIT
 
+// Strict W^X mode: generated code pages are never writable and executable
+// at the same time.  Pages are switched to read/write while code is being
+// stored or patched, and back to read/execute afterwards.  This is required
+// by hardened hosts (macOS/iOS on ARM64, SELinux, some Linux distributions),
+// so it's always on for anything but the legacy 32-bit Intel host, where it
+// is only used for debugging since the page protection calls cost time.
+#ifndef JIT_WX_STRICT
+# if JIT_DEBUG || !defined(JIT_HOST_X86)
+#  define JIT_WX_STRICT 1
+# else
+#  define JIT_WX_STRICT 0
+# endif
+#endif
+
 #if JIT_ENABLED
 
 // figure the address-to-index right shift based on the opcode alignment
@@ -289,6 +316,11 @@ struct jit_ctl
 	// emulated opcode address scaled by 'rshift'.
 	byte **native;
 
+	// One flag per JIT_CODE_PAGE_SIZE bytes of the map, set once any
+	// opcode in that page has been translated.  Writes to pages that
+	// never held translated code don't have to look at the opcodes.
+	byte *codePages;
+
 	// Address range for the map (inclusive of minAddr, exclusive
 	// of maxAddr)
 	data32_t minAddr, maxAddr;
@@ -491,6 +523,39 @@ void jit_untranslate(struct jit_ctl *jit, data32_t addr);
  */
 #define JIT_NATIVE(jit, addr) ((jit)->native[((addr) - (jit)->minAddr) >> JIT_RSHIFT])
 
+/*
+ *   Code page flags (see jit_ctl.codePages).  The same range check caveat
+ *   as for JIT_NATIVE applies.
+ */
+#define JIT_CODE_PAGE_SHIFT  12
+#define JIT_CODE_PAGE_SIZE   (1 << JIT_CODE_PAGE_SHIFT)
+#define JIT_CODE_PAGE(jit, addr) ((jit)->codePages[((addr) - (jit)->minAddr) >> JIT_CODE_PAGE_SHIFT])
+
+/*
+ *   Un-translate every instruction overlapping the 'len' bytes at 'addr'.
+ *   Pages of the map that never held translated code are skipped, so this
+ *   is cheap for writes to data areas.
+ *   
+ *   If 'retranslate' is false, the instructions are set to "emulate", like
+ *   jit_untranslate() does for self-modifying code.  If it's true, they go
+ *   back to "pending" and are translated again when they're next executed.
+ *   Use this when the memory contents are replaced wholesale, for example
+ *   by a bank switch or a block copy of new program code.
+ */
+void jit_untranslate_range(struct jit_ctl *jit, data32_t addr, data32_t len, int retranslate);
+
+/*
+ *   Memory write hook for the CPU write handlers, so that every write into
+ *   translated code un-translates it, whether it comes from the emulator or
+ *   from generated code.  This is inline up to the code page test.
+ */
+#define JIT_NOTIFY_WRITE(jit, addr, len) \
+	do { \
+		if ((data32_t)(addr) - (jit)->minAddr < (jit)->maxAddr - (jit)->minAddr \
+			&& JIT_CODE_PAGE(jit, (data32_t)(addr))) \
+			jit_untranslate_range(jit, addr, len, 0); \
+	} while (0)
+
 /*
  *   Fetch the next instruction, try translating to native, and jump to
  *   native if possible.  This must be placed just before the emulator code
@@ -761,10 +826,24 @@ struct jit_page {
 	// offset of next free byte
 	int ofsFree;
 
-	// native code (allocated as a separate block via VirtualAlloc())
+	// native code (allocated as a separate block via jit_code_alloc(),
+	// i.e. VirtualAlloc() on Windows and mmap() elsewhere)
 	byte *b;
 };
 
+/*
+ *   Host code memory primitives.  These hide the platform differences in
+ *   allocating executable memory, switching its protection between
+ *   read/write (while generating or patching code) and read/execute (while
+ *   running it), and making freshly written code visible to the instruction
+ *   fetch unit.  The protection switching is a no-op unless JIT_WX_STRICT
+ *   is set, in which case the pages start out read/write.
+ */
+byte *jit_code_alloc(int siz);
+void jit_code_free(byte *b, int siz);
+void jit_code_protect(byte *addr, int len, int writable);
+void jit_code_flush(byte *addr, int len);
+
 #else /* JIT_ENABLED */
 
 struct jit_ctl { int foo; };
@@ -774,6 +853,8 @@ struct jit_ctl { int foo; };
 #define jit_enable(jit)
 #define jit_reset(jit)
 #define jit_delete(jitp)
+#define jit_untranslate_range(jit, addr, len, retranslate)
+#define JIT_NOTIFY_WRITE(jit, addr, len)
 #define JIT_FETCH(jit,pc)
 
 #endif /* JIT_ENABLED */
@@ -986,6 +986,7 @@ void jit_emit_commit(struct jit_ctl *jit)
 		if (i->emuaddr != emuaddr) {
 			emuaddr = i->emuaddr;
 			JIT_NATIVE(jit, emuaddr) = i->nataddr;
+			JIT_CODE_PAGE(jit, emuaddr) = 1;
 		}
 	}
 
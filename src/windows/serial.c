@@ -40,8 +40,8 @@ int uart_open(const char *device, data32_t baudrate)
         return -EIO;
     }
 
-    // Set up transmit and receive buffers.
-    SetupComm(hCom, 128, 128);
+    // Set up transmit and receive buffers, large enough for the batched transfers of uart_host.c
+    SetupComm(hCom, 1024, 1024);
 
     /*  Set the COMMTIMEOUTS structure.  Per MSDN documentation for
         ReadIntervalTimeout, "A value of MAXDWORD, combined with zero values
@@ -122,27 +122,27 @@ int uart_baudrate(data32_t baudrate)
 }
 
 
-int uart_getch(void)
+int uart_read(data8_t *buffer, int size)
 {
-    DWORD dwRead;
-    data8_t value;
+    DWORD dwRead = 0;
 
-    if (!ReadFile(uart_hCom, &value, 1, &dwRead, NULL)) {
+    if (!ReadFile(uart_hCom, buffer, (DWORD)size, &dwRead, NULL)) {
         ERRMSG("%s: ReadFile error %lu\n", __FUNCTION__, GetLastError());
+        return -EIO;
     }
 
-    return dwRead ? value : -EIO;
+    return (int)dwRead;
 }
 
 
-int uart_putch(data8_t value)
+int uart_write(const data8_t *buffer, int size)
 {
-    DWORD dwWrote;
+    DWORD dwWrote = 0;
 
-    if (!WriteFile(uart_hCom, &value, 1, &dwWrote, NULL)) {
+    if (!WriteFile(uart_hCom, buffer, (DWORD)size, &dwWrote, NULL)) {
         ERRMSG("%s: WriteFile error %lu\n", __FUNCTION__, GetLastError());
         return -EIO;
     }
 
-    return 0;
+    return (int)dwWrote;
 }
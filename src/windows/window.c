@@ -1505,6 +1505,24 @@ void win_process_events_periodic(void)
 
 
 
+//============================================================
+//	win_process_events_slice
+//============================================================
+
+// set when a wait was woken up by a message, to process it on the next timeslice
+volatile int win_events_pending;
+
+void win_process_events_slice(void)
+{
+	// a cycle counter check is much cheaper than a PeekMessage per timeslice
+	if (!win_events_pending && osd_cycles() - last_event_check < osd_cycles_per_second() / 1000)
+		return;
+	win_events_pending = 0;
+	win_process_events();
+}
+
+
+
 //============================================================
 //	win_process_events
 //============================================================
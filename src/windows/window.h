@@ -144,6 +144,7 @@ void win_set_palette_entry(int _index, UINT8 red, UINT8 green, UINT8 blue);
 
 int win_process_events(void);
 void win_process_events_periodic(void);
+void win_process_events_slice(void);
 void osd_set_leds(int state);
 int osd_get_leds(void);
 
@@ -35,6 +35,16 @@
 // Global Data Structures
 // ----------------------------------------------------------------------------
 
+enum AltsoundSampleType {
+	UNDEFINED = 0,
+	MUSIC,
+	JINGLE,
+	SFX,
+	CALLOUT,
+	SOLO,
+	OVERLAY
+};
+
 struct _stream_info;  // forward declaration for clarity
 typedef _stream_info AltsoundStreamInfo;
 typedef std::array<AltsoundStreamInfo*, ALT_MAX_CHANNELS> StreamArray;
@@ -53,16 +63,6 @@ struct _stream_info {
 	float gain = 1.0f;
 };
 
-enum AltsoundSampleType {
-	UNDEFINED = 0,
-	MUSIC,
-	JINGLE,
-	SFX,
-	CALLOUT,
-	SOLO,
-	OVERLAY
-};
-
 // Structure for storing G-Sound ducking profiles
 typedef struct _ducking_profile {
 	float music_duck_vol = 1.0f;
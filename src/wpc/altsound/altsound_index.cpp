@@ -0,0 +1,256 @@
+// ---------------------------------------------------------------------------
+// altsound_index.cpp
+//
+// Reader/writer for the binary sample index of traditional and legacy
+// AltSound packages
+// ---------------------------------------------------------------------------
+// license:BSD-3-Clause
+// copyright-holders: Dave Roscoe
+// ---------------------------------------------------------------------------
+#include "altsound_index.hpp"
+
+// Std Library includes
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sys/stat.h>
+
+// local includes
+#include <dirent.h>
+#include "altsound_logger.hpp"
+
+extern AltsoundLogger alog;
+
+// ---------------------------------------------------------------------------
+// File layout (native byte order, written and read on the same platform):
+//
+// char[8]   magic "ALTSIDX1"
+// uint64    source stamp (see getSourceStamp())
+// uint32    sample count
+// per sample:
+//   uint32  id
+//   int32   channel
+//   float   gain
+//   float   ducking
+//   uint8   loop
+//   uint8   stop
+//   uint16  name length, followed by the name
+//   uint16  fname length, followed by fname relative to the package path
+// ---------------------------------------------------------------------------
+
+static const char index_magic[8] = { 'A', 'L', 'T', 'S', 'I', 'D', 'X', '1' };
+
+template<class T>
+static void write_value(std::ofstream& out, const T& value)
+{
+	out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<class T>
+static bool read_value(std::ifstream& in, T& value)
+{
+	return !!in.read(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+static void write_string(std::ofstream& out, const std::string& str)
+{
+	const uint16_t len = static_cast<uint16_t>(std::min<size_t>(str.size(), 0xFFFF));
+	write_value(out, len);
+	out.write(str.data(), len);
+}
+
+static bool read_string(std::ifstream& in, std::string& str)
+{
+	uint16_t len;
+	if (!read_value(in, len))
+		return false;
+
+	str.resize(len);
+	return len == 0 || !!in.read(&str[0], len);
+}
+
+static unsigned long long get_mtime(const std::string& path_in)
+{
+	struct stat info;
+	if (stat(path_in.c_str(), &info) != 0)
+		return 0;
+
+	return static_cast<unsigned long long>(info.st_mtime);
+}
+
+// ---------------------------------------------------------------------------
+// CTOR/DTOR
+// ---------------------------------------------------------------------------
+
+AltsoundIndex::AltsoundIndex(const std::string& altsound_path_in, const std::string& format_in)
+: altsound_path(altsound_path_in),
+  format(format_in)
+{
+	filename = altsound_path + "/altsound.idx";
+}
+
+// ---------------------------------------------------------------------------
+
+// For the CSV format this is the modification time of altsound.csv.  For the
+// legacy format it is the newest modification time of the type directories
+// and their sample directories, which change when samples are added, removed
+// or renamed.  Editing gain.txt/ducking.txt in place isn't detected, re-run
+// the packer after doing so
+unsigned long long AltsoundIndex::getSourceStamp()
+{
+	if (format == "altsound")
+		return get_mtime(altsound_path + "/altsound.csv");
+
+	static const char* const subpaths[] = { "jingle", "music", "sfx", "single", "voice" };
+
+	unsigned long long stamp = 0;
+	for (const char* subpath : subpaths) {
+		const std::string path = altsound_path + '/' + subpath;
+		stamp = std::max(stamp, get_mtime(path));
+
+		DIR* dir = opendir(path.c_str());
+		if (!dir)
+			continue;
+
+		struct dirent* entry;
+		while ((entry = readdir(dir)) != nullptr) {
+			if (entry->d_name[0] != '.')
+				stamp = std::max(stamp, get_mtime(path + '/' + entry->d_name));
+		}
+		closedir(dir);
+	}
+	return stamp;
+}
+
+// ---------------------------------------------------------------------------
+
+bool AltsoundIndex::read(std::vector<AltsoundSampleInfo>& samples_out)
+{
+	ALT_DEBUG(0, "BEGIN AltsoundIndex::read()");
+	INDENT;
+
+	std::ifstream in(filename, std::ios::binary);
+	if (!in.is_open()) {
+		ALT_INFO(0, "No sample index found: %s", filename.c_str());
+
+		OUTDENT;
+		ALT_DEBUG(0, "END AltsoundIndex::read()");
+		return false;
+	}
+
+	char magic[sizeof(index_magic)];
+	unsigned long long stamp;
+	uint32_t count;
+	if (!in.read(magic, sizeof(magic)) || memcmp(magic, index_magic, sizeof(magic)) != 0
+		|| !read_value(in, stamp) || !read_value(in, count)) {
+		ALT_WARNING(0, "Invalid sample index: %s", filename.c_str());
+
+		OUTDENT;
+		ALT_DEBUG(0, "END AltsoundIndex::read()");
+		return false;
+	}
+
+	const unsigned long long source_stamp = getSourceStamp();
+	if (source_stamp == 0 || stamp != source_stamp) {
+		ALT_WARNING(0, "Sample index is out of date, re-run the packer: %s", filename.c_str());
+
+		OUTDENT;
+		ALT_DEBUG(0, "END AltsoundIndex::read()");
+		return false;
+	}
+
+	std::vector<AltsoundSampleInfo> samples;
+	samples.reserve(count);
+
+	for (uint32_t i = 0; i < count; ++i) {
+		AltsoundSampleInfo sample;
+		uint32_t id;
+		int32_t channel;
+		uint8_t loop, stop;
+		std::string fname;
+
+		if (!read_value(in, id) || !read_value(in, channel)
+			|| !read_value(in, sample.gain) || !read_value(in, sample.ducking)
+			|| !read_value(in, loop) || !read_value(in, stop)
+			|| !read_string(in, sample.name) || !read_string(in, fname)) {
+			ALT_ERROR(0, "Truncated sample index: %s", filename.c_str());
+
+			OUTDENT;
+			ALT_DEBUG(0, "END AltsoundIndex::read()");
+			return false;
+		}
+
+		sample.id = id;
+		sample.channel = channel;
+		sample.loop = loop != 0;
+		sample.stop = stop != 0;
+		sample.fname = altsound_path + '/' + fname;
+		samples.push_back(sample);
+	}
+
+	samples_out.insert(samples_out.end(), samples.begin(), samples.end());
+	ALT_INFO(0, "Loaded %u samples from index", count);
+
+	OUTDENT;
+	ALT_DEBUG(0, "END AltsoundIndex::read()");
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+
+bool AltsoundIndex::write(const std::vector<AltsoundSampleInfo>& samples_in)
+{
+	ALT_DEBUG(0, "BEGIN AltsoundIndex::write()");
+	INDENT;
+
+	std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+	if (!out.is_open()) {
+		ALT_ERROR(0, "Unable to create sample index: %s", filename.c_str());
+
+		OUTDENT;
+		ALT_DEBUG(0, "END AltsoundIndex::write()");
+		return false;
+	}
+
+	const std::string prefix = altsound_path + '/';
+
+	out.write(index_magic, sizeof(index_magic));
+	write_value(out, getSourceStamp());
+	write_value(out, static_cast<uint32_t>(samples_in.size()));
+
+	for (const auto& sample : samples_in) {
+		// store the filename relative to the package, so it can be moved
+		if (sample.fname.compare(0, prefix.size(), prefix) != 0) {
+			ALT_ERROR(0, "Sample is outside of the package: %s", sample.fname.c_str());
+			out.close();
+			remove(filename.c_str());
+
+			OUTDENT;
+			ALT_DEBUG(0, "END AltsoundIndex::write()");
+			return false;
+		}
+
+		write_value(out, static_cast<uint32_t>(sample.id));
+		write_value(out, static_cast<int32_t>(sample.channel));
+		write_value(out, sample.gain);
+		write_value(out, sample.ducking);
+		write_value(out, static_cast<uint8_t>(sample.loop));
+		write_value(out, static_cast<uint8_t>(sample.stop));
+		write_string(out, sample.name);
+		write_string(out, sample.fname.substr(prefix.size()));
+	}
+
+	const bool success = !!out;
+	if (!success) {
+		ALT_ERROR(0, "Failed writing sample index: %s", filename.c_str());
+	}
+	else {
+		ALT_INFO(0, "Wrote %u samples to index: %s", static_cast<unsigned int>(samples_in.size()), filename.c_str());
+	}
+
+	OUTDENT;
+	ALT_DEBUG(0, "END AltsoundIndex::write()");
+	return success;
+}
@@ -0,0 +1,70 @@
+// ---------------------------------------------------------------------------
+// altsound_index.hpp
+//
+// Reader/writer for the binary sample index of traditional and legacy
+// AltSound packages.  The index is written by the standalone packer and
+// used at startup instead of parsing altsound.csv or scanning the legacy
+// sample directories
+// ---------------------------------------------------------------------------
+// license:BSD-3-Clause
+// copyright-holders: Dave Roscoe
+// ---------------------------------------------------------------------------
+#ifndef ALTSOUND_INDEX_HPP
+#define ALTSOUND_INDEX_HPP
+#if !defined(__GNUC__) || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || (__GNUC__ >= 4)	// GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#if _MSC_VER >= 1700
+ #ifdef inline
+  #undef inline
+ #endif
+#endif
+
+// Std Library includes
+#include <string>
+#include <vector>
+
+// local includes
+#include "altsound_data.hpp"
+
+// ---------------------------------------------------------------------------
+// Class definitions
+// ---------------------------------------------------------------------------
+
+class AltsoundIndex {
+public: // methods
+
+	// Standard constructor, format_in is "altsound" or "legacy"
+	AltsoundIndex(const std::string& altsound_path_in, const std::string& format_in);
+
+	// Load samples from the index.  Returns false if the index is missing,
+	// corrupt or doesn't match the package it was built from
+	bool read(std::vector<AltsoundSampleInfo>& samples_out);
+
+	// Write the provided samples to the index
+	bool write(const std::vector<AltsoundSampleInfo>& samples_in);
+
+public: // data
+
+protected:
+
+	// Default constructor
+	AltsoundIndex() {/* not used */ };
+
+	// Copy constructor
+	AltsoundIndex(AltsoundIndex&) {/* not used */ };
+
+private: // functions
+
+	// newest modification time of the package sources the index covers
+	unsigned long long getSourceStamp();
+
+private: // data
+
+	std::string altsound_path;
+	std::string format;
+	std::string filename;
+};
+
+#endif // ALTSOUND_INDEX_HPP
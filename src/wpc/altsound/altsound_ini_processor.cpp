@@ -110,6 +110,31 @@ bool AltsoundIniProcessor::parse_altsound_ini(const string& path_in)
 		return false;
 	}
 
+	// get sample preload flag
+	string preload_str;
+	inipp::get_value(ini.sections["system"], "preload_samples", preload_str);
+	preload_samples = (preload_str == "1");
+	ALT_INFO(0, "Parsed \"preload_samples\": %s", preload_samples ? "true" : "false");
+
+	// get preload arena size
+	string preload_mb_str;
+	inipp::get_value(ini.sections["system"], "preload_cache_mb", preload_mb_str);
+	try {
+		if (!preload_mb_str.empty()) {
+			const int val = std::stoi(preload_mb_str);
+			preload_cache_mb = static_cast<unsigned int>(clamp(val, 1, 2048));
+			ALT_INFO(0, "Parsed \"preload_cache_mb\": %u", preload_cache_mb);
+		}
+	}
+	catch (const std::invalid_argument& e) {
+		ALT_ERROR(0, "Invalid number format while parsing preload_cache_mb value: %s\n", preload_mb_str.c_str());
+		return false;
+	}
+	catch (const std::out_of_range& e) {
+		ALT_ERROR(0, "Number out of range while parsing preload_cache_mb value: %s\n", preload_mb_str.c_str());
+		return false;
+	}
+
 	// get AltSound format type
 	inipp::get_value(ini.sections["format"], "format", altsound_format);
 	altsound_format = normalizeString(altsound_format);
@@ -601,12 +626,23 @@ bool AltsoundIniProcessor::create_altsound_ini(const std::string& path_in)
 		";                     specify how many initial commands to ignore at startup.\n"
 		";                     NOTE:  If the record_sound_cmds flag is set, the skipped\n"
 		";                     commands will be included in the recording file.\n"
+		";\n"
+		"; preload_samples   : reads sample files into memory when the table starts,\n"
+		";                     so playback doesn't wait on the disk when a command\n"
+		";                     fires. Looping samples (usually music) are loaded on\n"
+		";                     first use instead. When the cache is full, the least\n"
+		";                     recently used samples that aren't playing are dropped.\n"
+		";                     This feature is turned off by default\n"
+		";\n"
+		"; preload_cache_mb  : size of the preload cache in megabytes (1-2048)\n"
 		"; ----------------------------------------------------------------------------\n"
 		"\n"
 		"[system]\n"
 		"record_sound_cmds = 0\n"
 		"rom_volume_ctrl = 1\n"
 		"cmd_skip_count = 0\n"
+		"preload_samples = 0\n"
+		"preload_cache_mb = 64\n"
 		"\n"
 		"; ----------------------------------------------------------------------------\n"
 		"; There are three supported AltSound formats:\n"
@@ -60,6 +60,12 @@ public:
 	// Return parsed skip count value
 	const unsigned int getSkipCount() const;
 
+	// Return parsed sample preload flag
+	const bool preloadSamples() const;
+
+	// Return parsed preload arena size in megabytes
+	const unsigned int getPreloadCacheMb() const;
+
 private: // functions
 
 	// helper function to parse behavior variable values
@@ -94,6 +100,8 @@ private: // data
 	bool rom_volume_control = true;
 	std::string altsound_format;
 	unsigned int skip_count = 0;
+	bool preload_samples = false;
+	unsigned int preload_cache_mb = 64;
 };
 
 // ----------------------------------------------------------------------------
@@ -123,4 +131,16 @@ inline const unsigned int AltsoundIniProcessor::getSkipCount() const {
 	return skip_count;
 }
 
+// ----------------------------------------------------------------------------
+
+inline const bool AltsoundIniProcessor::preloadSamples() const {
+	return preload_samples;
+}
+
+// ----------------------------------------------------------------------------
+
+inline const unsigned int AltsoundIniProcessor::getPreloadCacheMb() const {
+	return preload_cache_mb;
+}
+
 #endif // ALTSOUND_INI_PROCESSOR_H
@@ -0,0 +1,557 @@
+// ---------------------------------------------------------------------------
+// altsound_mixer.cpp
+//
+// Native altsound playback backend, mixing decoded samples into PinMAME's
+// mixer in place of BASS
+// ---------------------------------------------------------------------------
+// license:BSD-3-Clause
+// copyright-holders: Dave Roscoe
+// ---------------------------------------------------------------------------
+#ifdef ALTSOUND_NATIVE_MIXER
+
+#define NOMINMAX
+
+#include "altsound_mixer.hpp"
+
+// Std Library includes
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifdef __cplusplus
+  extern "C" {
+#endif
+  #include "driver.h"
+  #include "threadsched.h"
+#ifdef __cplusplus
+  }
+#endif
+
+// local includes
+#include "../../ext/bass/bass.h"
+#include "altsound_data.hpp"
+#include "altsound_logger.hpp"
+
+extern AltsoundLogger alog;
+
+// ---------------------------------------------------------------------------
+// Constants
+// ---------------------------------------------------------------------------
+
+#define WAVE_FORMAT_PCM        0x0001
+#define WAVE_FORMAT_IEEE_FLOAT 0x0003
+#define WAVE_FORMAT_EXTENSIBLE 0xFFFE
+
+// ---------------------------------------------------------------------------
+// Data
+// ---------------------------------------------------------------------------
+
+// Decoded sample stream, interleaved stereo at the sample's own rate
+typedef struct _native_stream {
+	std::vector<INT16> pcm;
+	unsigned int frames = 0;
+	double rate = 0.;
+	double pos = 0.;
+	bool loop = false;
+	DWORD state = BASS_ACTIVE_STOPPED;
+	float vol = 1.0f;     // BASS_ATTRIB_VOL, set by the processors (ducking included)
+	float cur_vol = 1.0f; // volume at the end of the last update, ramped to vol
+	HSYNC hsync = 0;
+	DWORD sync_type = 0;
+	SYNCPROC* sync_proc = nullptr;
+	void* sync_user = nullptr;
+} NativeStream;
+
+// Pending SYNCPROC call, run on the sync thread
+typedef struct _pending_sync {
+	HSTREAM hstream;
+	HSYNC hsync;
+	SYNCPROC* proc;
+	void* user;
+} PendingSync;
+
+static int mixer_channel = -1;
+static bool bass_initialized = false;
+
+// stream table, shared by the altsound worker, the sync thread and the
+// emulation thread (mixing).  Decoding happens outside of the lock
+static std::mutex stream_mutex;
+static std::unordered_map<HSTREAM, NativeStream> streams;
+static HSTREAM next_handle = 1;
+
+// end-of-stream callbacks, run on their own thread like BASS does, so the
+// processors' callbacks never block the emulation thread
+static std::thread sync_thread;
+static std::mutex sync_mutex;
+static std::condition_variable sync_cv;
+static std::vector<PendingSync> sync_queue;
+static bool sync_run = false;
+
+static thread_local int last_error = BASS_OK;
+
+// ---------------------------------------------------------------------------
+// Helper functions
+// ---------------------------------------------------------------------------
+
+static inline BOOL set_error(const int error)
+{
+	last_error = error;
+	return error == BASS_OK;
+}
+
+// ---------------------------------------------------------------------------
+
+static inline unsigned int read_le16(const unsigned char* p)
+{
+	return p[0] | (p[1] << 8);
+}
+
+// ---------------------------------------------------------------------------
+
+static inline unsigned int read_le32(const unsigned char* p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+// ---------------------------------------------------------------------------
+
+static inline INT16 decode_wav_sample(const unsigned char* p, const unsigned int format,
+                                      const unsigned int bits)
+{
+	if (format == WAVE_FORMAT_IEEE_FLOAT) {
+		float f;
+		const unsigned int u = read_le32(p);
+		memcpy(&f, &u, sizeof(f));
+		return static_cast<INT16>(std::max(-32768.f, std::min(32767.f, f * 32768.f)));
+	}
+
+	switch (bits) {
+		case 8:  return static_cast<INT16>((p[0] - 0x80) << 8);
+		case 16: return static_cast<INT16>(read_le16(p));
+		case 24: return static_cast<INT16>(read_le16(p + 1));
+		default: return static_cast<INT16>(read_le16(p + 2));
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Decode a RIFF/WAVE image into interleaved stereo 16-bit PCM.  Mono is
+// duplicated to both sides, any channels past the first two are dropped
+// ---------------------------------------------------------------------------
+
+static bool decode_wav(const unsigned char* data, const size_t size, NativeStream& stream_out)
+{
+	if (size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0)
+		return false;
+
+	unsigned int format = 0, channels = 0, rate = 0, bits = 0, block_align = 0;
+	const unsigned char* pcm = nullptr;
+	size_t pcm_size = 0;
+
+	size_t offset = 12;
+	while (offset + 8 <= size) {
+		const unsigned char* chunk = data + offset;
+		const size_t chunk_size = std::min(static_cast<size_t>(read_le32(chunk + 4)), size - offset - 8);
+
+		if (memcmp(chunk, "fmt ", 4) == 0 && chunk_size >= 16) {
+			format = read_le16(chunk + 8);
+			channels = read_le16(chunk + 10);
+			rate = read_le32(chunk + 12);
+			block_align = read_le16(chunk + 20);
+			bits = read_le16(chunk + 22);
+			if (format == WAVE_FORMAT_EXTENSIBLE && chunk_size >= 40)
+				format = read_le16(chunk + 32); // first two bytes of the SubFormat GUID
+		}
+		else if (memcmp(chunk, "data", 4) == 0) {
+			pcm = chunk + 8;
+			pcm_size = chunk_size;
+		}
+		offset += 8 + chunk_size + (chunk_size & 1);
+	}
+
+	const bool supported = (format == WAVE_FORMAT_PCM && (bits == 8 || bits == 16 || bits == 24 || bits == 32))
+	                    || (format == WAVE_FORMAT_IEEE_FLOAT && bits == 32);
+	if (!pcm || !supported || channels == 0 || rate == 0 || block_align < channels * (bits / 8))
+		return false;
+
+	const unsigned int frames = static_cast<unsigned int>(pcm_size / block_align);
+	const unsigned int sample_size = bits / 8;
+	stream_out.pcm.resize(static_cast<size_t>(frames) * 2);
+	stream_out.frames = frames;
+	stream_out.rate = rate;
+
+	INT16* __restrict dst = stream_out.pcm.data();
+	for (unsigned int i = 0; i < frames; ++i, pcm += block_align) {
+		const INT16 l = decode_wav_sample(pcm, format, bits);
+		*dst++ = l;
+		*dst++ = (channels > 1) ? decode_wav_sample(pcm + sample_size, format, bits) : l;
+	}
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+// Sync thread main loop
+// ---------------------------------------------------------------------------
+
+static void sync_worker()
+{
+	threadsched_apply(THREADSCHED_AUDIO);
+
+	std::vector<PendingSync> pending;
+
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(sync_mutex);
+			sync_cv.wait(lock, [] { return !sync_queue.empty() || !sync_run; });
+			if (!sync_run)
+				break;
+			pending.swap(sync_queue);
+		}
+
+		for (const PendingSync& sync : pending) {
+			// the stream may have been freed since it ended
+			{
+				std::lock_guard<std::mutex> guard(stream_mutex);
+				if (streams.find(sync.hstream) == streams.end())
+					continue;
+			}
+			sync.proc(sync.hsync, sync.hstream, 0, sync.user);
+		}
+		pending.clear();
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Mixer stream update, runs on the emulation thread
+// ---------------------------------------------------------------------------
+
+static void alt_sound_mixer_update(int param, INT16** buffer, int length)
+{
+	float* const __restrict left = reinterpret_cast<float*>(buffer[0]);
+	float* const __restrict right = reinterpret_cast<float*>(buffer[1]);
+	memset(left, 0, length * sizeof(float));
+	memset(right, 0, length * sizeof(float));
+
+	const double out_rate = Machine->sample_rate;
+	const float inv_len = 1.0f / static_cast<float>(length);
+	bool notify = false;
+
+	std::lock_guard<std::mutex> guard(stream_mutex);
+
+	for (auto& entry : streams) {
+		NativeStream& stream = entry.second;
+		if (stream.state != BASS_ACTIVE_PLAYING)
+			continue;
+
+		// ramp volume changes (ducking) over the update to avoid clicks
+		const float vol_start = stream.cur_vol * (1.0f / 32768.f);
+		const float vol_step = (stream.vol - stream.cur_vol) * (1.0f / 32768.f) * inv_len;
+		stream.cur_vol = stream.vol;
+
+		const double step = stream.rate / out_rate;
+		const INT16* const pcm = stream.pcm.data();
+		const unsigned int frames = stream.frames;
+		double pos = stream.pos;
+		bool hit_end = false;
+
+		for (int i = 0; i < length; ++i) {
+			if (pos >= frames) {
+				hit_end = true;
+				if (!stream.loop) {
+					stream.state = BASS_ACTIVE_STOPPED;
+					break;
+				}
+				pos -= frames;
+				if (pos >= frames)
+					pos = 0.;
+			}
+
+			// linear interpolation, wrapping to the start on looping streams
+			const unsigned int idx = static_cast<unsigned int>(pos);
+			const unsigned int next = (idx + 1 < frames) ? idx + 1 : (stream.loop ? 0 : idx);
+			const float frac = static_cast<float>(pos - idx);
+			const float vol = vol_start + vol_step * static_cast<float>(i);
+			left[i]  += vol * (pcm[idx * 2]     + frac * (pcm[next * 2]     - pcm[idx * 2]));
+			right[i] += vol * (pcm[idx * 2 + 1] + frac * (pcm[next * 2 + 1] - pcm[idx * 2 + 1]));
+			pos += step;
+		}
+		stream.pos = pos;
+
+		if (hit_end && stream.sync_proc) {
+			std::lock_guard<std::mutex> sync_guard(sync_mutex);
+			sync_queue.push_back({ entry.first, stream.hsync, stream.sync_proc, stream.sync_user });
+			if (stream.sync_type & BASS_SYNC_ONETIME)
+				stream.sync_proc = nullptr;
+			notify = true;
+		}
+	}
+
+	if (notify)
+		sync_cv.notify_one();
+}
+
+// ---------------------------------------------------------------------------
+// Functional code
+// ---------------------------------------------------------------------------
+
+extern "C" int alt_sound_mixer_start(void)
+{
+	static const char* names[2] = { "Altsound Left", "Altsound Right" };
+	static const int levels[2] = { MIXER(100, MIXER_PAN_LEFT), MIXER(100, MIXER_PAN_RIGHT) };
+
+	mixer_channel = -1;
+	if (Machine->sample_rate == 0)
+		return -1;
+
+	mixer_channel = stream_init_multi_float(2, names, levels, Machine->sample_rate, 0, alt_sound_mixer_update, 1);
+	if (mixer_channel < 0)
+		return -1;
+
+	// altsound mutes the emulated sound through the global enable, but
+	// must keep playing itself
+	mixer_set_channel_ignore_global_enable(mixer_channel, 1);
+	mixer_set_channel_ignore_global_enable(mixer_channel + 1, 1);
+	return mixer_channel;
+}
+
+// ---------------------------------------------------------------------------
+// BASS API subset
+// ---------------------------------------------------------------------------
+
+int BASSDEF(BASS_ErrorGetCode)(void)
+{
+	return last_error;
+}
+
+// ---------------------------------------------------------------------------
+
+#if defined(_WIN32) && !defined(_WIN32_WCE) && !(defined(WINAPI_FAMILY) && WINAPI_FAMILY != WINAPI_FAMILY_DESKTOP_APP)
+BOOL BASSDEF(BASS_Init)(int device, DWORD freq, DWORD flags, HWND win, const void *dsguid)
+#else
+BOOL BASSDEF(BASS_Init)(int device, DWORD freq, DWORD flags, void *win, const void *dsguid)
+#endif
+{
+	// device and output rate are PinMAME's, the arguments don't apply
+	if (mixer_channel < 0)
+		return set_error(BASS_ERROR_INIT);
+	if (bass_initialized)
+		return set_error(BASS_ERROR_ALREADY);
+
+	sync_run = true;
+	sync_thread = std::thread(sync_worker);
+	bass_initialized = true;
+	ALT_INFO(0, "Native mixer on PinMAME mixer channel %d", mixer_channel);
+	return set_error(BASS_OK);
+}
+
+// ---------------------------------------------------------------------------
+
+BOOL BASSDEF(BASS_Free)(void)
+{
+	if (!bass_initialized)
+		return set_error(BASS_ERROR_INIT);
+
+	{
+		std::lock_guard<std::mutex> guard(sync_mutex);
+		sync_run = false;
+		sync_queue.clear();
+	}
+	sync_cv.notify_one();
+	sync_thread.join();
+
+	{
+		std::lock_guard<std::mutex> guard(stream_mutex);
+		streams.clear();
+	}
+	bass_initialized = false;
+	return set_error(BASS_OK);
+}
+
+// ---------------------------------------------------------------------------
+
+HSTREAM BASSDEF(BASS_StreamCreateFile)(BOOL mem, const void *file, QWORD offset, QWORD length, DWORD flags)
+{
+	if (!bass_initialized) {
+		set_error(BASS_ERROR_INIT);
+		return BASS_NO_STREAM;
+	}
+
+	std::vector<unsigned char> file_data;
+	const unsigned char* data;
+	size_t size;
+
+	if (mem) {
+		data = static_cast<const unsigned char*>(file) + offset;
+		size = static_cast<size_t>(length);
+	}
+	else {
+		std::ifstream file_in(static_cast<const char*>(file), std::ios::binary | std::ios::ate);
+		if (!file_in.good()) {
+			set_error(BASS_ERROR_FILEOPEN);
+			return BASS_NO_STREAM;
+		}
+		const std::streamoff file_size = file_in.tellg();
+		if (file_size <= static_cast<std::streamoff>(offset)) {
+			set_error(BASS_ERROR_FILEFORM);
+			return BASS_NO_STREAM;
+		}
+		size = static_cast<size_t>(length ? std::min<QWORD>(length, file_size - offset) : file_size - offset);
+		file_data.resize(size);
+		file_in.seekg(offset, std::ios::beg);
+		if (!file_in.read(reinterpret_cast<char*>(file_data.data()), size)) {
+			set_error(BASS_ERROR_FILEOPEN);
+			return BASS_NO_STREAM;
+		}
+		data = file_data.data();
+	}
+
+	// decode outside of the lock, the mixer must never wait on it
+	NativeStream stream;
+	if (!decode_wav(data, size, stream)) {
+		// only RIFF/WAVE PCM is decoded natively
+		set_error(BASS_ERROR_CODEC);
+		return BASS_NO_STREAM;
+	}
+	stream.loop = (flags & BASS_SAMPLE_LOOP) != 0;
+
+	std::lock_guard<std::mutex> guard(stream_mutex);
+	const HSTREAM hstream = next_handle++;
+	streams[hstream] = std::move(stream);
+	set_error(BASS_OK);
+	return hstream;
+}
+
+// ---------------------------------------------------------------------------
+
+BOOL BASSDEF(BASS_StreamFree)(HSTREAM handle)
+{
+	std::lock_guard<std::mutex> guard(stream_mutex);
+	return set_error(streams.erase(handle) ? BASS_OK : BASS_ERROR_HANDLE);
+}
+
+// ---------------------------------------------------------------------------
+
+HSYNC BASSDEF(BASS_ChannelSetSync)(DWORD handle, DWORD type, QWORD param, SYNCPROC *proc, void *user)
+{
+	std::lock_guard<std::mutex> guard(stream_mutex);
+
+	const auto it = streams.find(handle);
+	if (it == streams.end()) {
+		set_error(BASS_ERROR_HANDLE);
+		return 0;
+	}
+	if ((type & ~BASS_SYNC_ONETIME) != BASS_SYNC_END) {
+		set_error(BASS_ERROR_ILLTYPE);
+		return 0;
+	}
+
+	NativeStream& stream = it->second;
+	stream.hsync = next_handle++;
+	stream.sync_type = type;
+	stream.sync_proc = proc;
+	stream.sync_user = user;
+	set_error(BASS_OK);
+	return stream.hsync;
+}
+
+// ---------------------------------------------------------------------------
+
+DWORD BASSDEF(BASS_ChannelIsActive)(DWORD handle)
+{
+	std::lock_guard<std::mutex> guard(stream_mutex);
+
+	const auto it = streams.find(handle);
+	if (it == streams.end()) {
+		set_error(BASS_ERROR_HANDLE);
+		return BASS_ACTIVE_STOPPED;
+	}
+	set_error(BASS_OK);
+	return it->second.state;
+}
+
+// ---------------------------------------------------------------------------
+
+BOOL BASSDEF(BASS_ChannelPlay)(DWORD handle, BOOL restart)
+{
+	std::lock_guard<std::mutex> guard(stream_mutex);
+
+	const auto it = streams.find(handle);
+	if (it == streams.end())
+		return set_error(BASS_ERROR_HANDLE);
+
+	NativeStream& stream = it->second;
+	if (restart || stream.pos >= stream.frames)
+		stream.pos = 0.;
+	stream.cur_vol = (stream.state == BASS_ACTIVE_STOPPED) ? stream.vol : stream.cur_vol;
+	stream.state = BASS_ACTIVE_PLAYING;
+	return set_error(BASS_OK);
+}
+
+// ---------------------------------------------------------------------------
+
+BOOL BASSDEF(BASS_ChannelStop)(DWORD handle)
+{
+	std::lock_guard<std::mutex> guard(stream_mutex);
+
+	const auto it = streams.find(handle);
+	if (it == streams.end())
+		return set_error(BASS_ERROR_HANDLE);
+
+	it->second.state = BASS_ACTIVE_STOPPED;
+	return set_error(BASS_OK);
+}
+
+// ---------------------------------------------------------------------------
+
+BOOL BASSDEF(BASS_ChannelPause)(DWORD handle)
+{
+	std::lock_guard<std::mutex> guard(stream_mutex);
+
+	const auto it = streams.find(handle);
+	if (it == streams.end())
+		return set_error(BASS_ERROR_HANDLE);
+	if (it->second.state != BASS_ACTIVE_PLAYING)
+		return set_error(BASS_ERROR_NOPLAY);
+
+	it->second.state = BASS_ACTIVE_PAUSED;
+	return set_error(BASS_OK);
+}
+
+// ---------------------------------------------------------------------------
+
+BOOL BASSDEF(BASS_ChannelSetAttribute)(DWORD handle, DWORD attrib, float value)
+{
+	std::lock_guard<std::mutex> guard(stream_mutex);
+
+	const auto it = streams.find(handle);
+	if (it == streams.end())
+		return set_error(BASS_ERROR_HANDLE);
+	if (attrib != BASS_ATTRIB_VOL)
+		return set_error(BASS_ERROR_ILLTYPE);
+
+	it->second.vol = std::max(value, 0.0f);
+	return set_error(BASS_OK);
+}
+
+// ---------------------------------------------------------------------------
+
+BOOL BASSDEF(BASS_ChannelGetAttribute)(DWORD handle, DWORD attrib, float *value)
+{
+	std::lock_guard<std::mutex> guard(stream_mutex);
+
+	const auto it = streams.find(handle);
+	if (it == streams.end())
+		return set_error(BASS_ERROR_HANDLE);
+	if (attrib != BASS_ATTRIB_VOL)
+		return set_error(BASS_ERROR_ILLTYPE);
+
+	*value = it->second.vol;
+	return set_error(BASS_OK);
+}
+
+#endif // ALTSOUND_NATIVE_MIXER
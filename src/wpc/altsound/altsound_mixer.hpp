@@ -0,0 +1,34 @@
+// ---------------------------------------------------------------------------
+// altsound_mixer.hpp
+//
+// Native altsound playback backend.  When ALTSOUND_NATIVE_MIXER is defined,
+// this provides the subset of the BASS API used by the altsound processors.
+// Samples are decoded into memory and mixed straight into a stereo float
+// stream channel of PinMAME's mixer, so altsound shares the emulated sound's
+// audio clock and output stream instead of opening a second device
+// ---------------------------------------------------------------------------
+// license:BSD-3-Clause
+// copyright-holders: Dave Roscoe
+// ---------------------------------------------------------------------------
+#ifndef ALTSOUND_MIXER_HPP
+#define ALTSOUND_MIXER_HPP
+#if !defined(__GNUC__) || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || (__GNUC__ >= 4)	// GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#ifdef ALTSOUND_NATIVE_MIXER
+
+#ifdef __cplusplus
+  extern "C" {
+#endif
+  // Allocate the altsound mixer channel.  Must be called while the machine
+  // is being initialized, before the first sound command is processed.
+  // Returns the mixer channel, or -1 on failure
+  int alt_sound_mixer_start(void);
+#ifdef __cplusplus
+  }
+#endif
+
+#endif // ALTSOUND_NATIVE_MIXER
+
+#endif // ALTSOUND_MIXER_HPP
@@ -20,6 +20,7 @@
 #include "osdepend.h"
 #include "altsound_csv_parser.hpp"
 #include "altsound_file_parser.hpp"
+#include "altsound_index.hpp"
 #include "altsound_logger.hpp"
 
 using std::string;
@@ -261,6 +262,12 @@ void AltsoundProcessor::init()
 	}
 	ALT_INFO(0, "SUCCESS AltsoundProcessor::loadSamples()");
 
+	// fill the preload arena with the non-looping samples, if enabled
+	for (const auto& sample : samples) {
+		if (!sample.loop)
+			preloadSample(sample.fname);
+	}
+
 	// if we are here, initialization succeeded
 	is_initialized = true;
 
@@ -307,7 +314,12 @@ bool AltsoundProcessor::loadSamples()
 		altsound_path += game_name;
 	}
 
-	if (format == "altsound") {
+	// use the packed sample index when it's present and up to date
+	AltsoundIndex index(altsound_path, format);
+	if (ALT_CALL(index.read(samples))) {
+		ALT_INFO(0, "SUCCESS AltsoundIndex::read()");
+	}
+	else if (format == "altsound") {
 		AltsoundCsvParser csv_parser(altsound_path);
 
 		if (!csv_parser.parse(samples)) {
@@ -331,6 +343,20 @@ bool AltsoundProcessor::loadSamples()
 		ALT_INFO(0, "SUCCESS AltsoundFileParser::parse()");
 	}
 
+	// index the first run of samples for each command ID, that's the run
+	// getSample() picks from
+	sample_index.clear();
+	for (size_t i = 0; i < samples.size(); ) {
+		const unsigned int id = samples[i].id;
+		size_t num_samples = 1;
+		while (i + num_samples < samples.size() && samples[i + num_samples].id == id)
+			num_samples++;
+
+		sample_index.emplace(id, std::make_pair(static_cast<unsigned int>(i), static_cast<unsigned int>(num_samples)));
+		i += num_samples;
+	}
+	ALT_INFO(0, "Indexed %u command ID(s)", static_cast<unsigned int>(sample_index.size()));
+
 	OUTDENT;
 	ALT_DEBUG(0, "END AltsoundProcessor::loadSamples");
 	return true;
@@ -345,28 +371,14 @@ unsigned int AltsoundProcessor::getSample(const unsigned int cmd_combined_in)
 
 	unsigned int sample_idx = UNSET_IDX;
 
-	// Look for sample that matches the current command
-	for (size_t i = 0; i < samples.size(); ++i) {
-		if (samples[i].id == cmd_combined_in) {
-			// Current ID matches the command. Check if there are more samples for this
-			// command and randomly pick one
-			unsigned int num_samples = 0;
-			do {
-				num_samples++;
-
-				if (i + num_samples >= samples.size())
-					// sample index exceeds the number of samples
-					break;
-
-				// Loop while the next sample ID matches the command
-			} while (samples[i + num_samples].id == cmd_combined_in);
-			ALT_INFO(0, "SUCCESS Found %d sample(s) for ID: %04X", num_samples, cmd_combined_in);
-
-			// num_samples now contains the number of samples with the same ID
-			// pick one to play at random
-			sample_idx = static_cast<unsigned int>(i) + rand() % num_samples;
-			break;
-		}
+	// Look for samples that match the current command
+	const auto it = sample_index.find(cmd_combined_in);
+	if (it != sample_index.end()) {
+		const unsigned int num_samples = it->second.second;
+		ALT_INFO(0, "SUCCESS Found %d sample(s) for ID: %04X", num_samples, cmd_combined_in);
+
+		// pick one to play at random
+		sample_idx = it->second.first + rand() % num_samples;
 	}
 
 	if (sample_idx == UNSET_IDX) {
@@ -23,6 +23,8 @@
 // Library includes
 #include <string>
 #include <array>
+#include <unordered_map>
+#include <utility>
 
 // Local includes
 #include "altsound_processor_base.hpp"
@@ -103,6 +105,9 @@ private: // data
 	bool is_initialized;
 	bool is_stable; // future use
 	std::vector<AltsoundSampleInfo> samples;
+
+	// command ID -> (first index, count) of its run of samples
+	std::unordered_map<unsigned int, std::pair<unsigned int, unsigned int>> sample_index;
 };
 
 // ---------------------------------------------------------------------------
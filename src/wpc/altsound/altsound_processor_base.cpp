@@ -9,7 +9,9 @@
 // ---------------------------------------------------------------------------
 #include "altsound_processor_base.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <fstream>
 #include <iomanip>
 
 #include "altsound_logger.hpp"
@@ -232,8 +234,16 @@ bool AltsoundProcessorBase::createStream(void* syncproc_in, AltsoundStreamInfo*
 	stream_out->channel_idx = ch_idx; // store channel assignment
 	const bool loop = stream_out->loop;
 
-    // Create playback stream
-	HSTREAM hstream = BASS_StreamCreateFile(FALSE, stream_out->sample_path.c_str(), 0, 0, loop ? BASS_SAMPLE_LOOP : 0);
+	// Create playback stream, from the preload arena if the sample is cached
+	const std::vector<char>* cached = preload ? getCachedSample(stream_out->sample_path) : nullptr;
+	HSTREAM hstream;
+	if (cached) {
+		ALT_DEBUG(1, "Creating stream from preloaded sample: %s", short_path.c_str());
+		hstream = BASS_StreamCreateFile(TRUE, cached->data(), 0, cached->size(), loop ? BASS_SAMPLE_LOOP : 0);
+	}
+	else {
+		hstream = BASS_StreamCreateFile(FALSE, stream_out->sample_path.c_str(), 0, 0, loop ? BASS_SAMPLE_LOOP : 0);
+	}
 
 	if (hstream == BASS_NO_STREAM) {
 		// Failed to create stream
@@ -274,6 +284,118 @@ bool AltsoundProcessorBase::createStream(void* syncproc_in, AltsoundStreamInfo*
 
 // ----------------------------------------------------------------------------
 
+bool AltsoundProcessorBase::preloadSample(const std::string& path_in)
+{
+	if (!preload)
+		return false;
+
+	if (sample_cache.find(path_in) != sample_cache.end())
+		return true;
+
+	// at init time, only fill the arena; never evict
+	return cacheSample(path_in, false) != nullptr;
+}
+
+// ----------------------------------------------------------------------------
+
+const std::vector<char>* AltsoundProcessorBase::getCachedSample(const std::string& path_in)
+{
+	const auto it = sample_cache.find(path_in);
+	if (it != sample_cache.end()) {
+		// move to the front of the LRU list
+		cache_lru.splice(cache_lru.begin(), cache_lru, it->second.lru_it);
+		return &it->second.data;
+	}
+
+	return cacheSample(path_in, true);
+}
+
+// ----------------------------------------------------------------------------
+
+const std::vector<char>* AltsoundProcessorBase::cacheSample(const std::string& path_in, const bool evict)
+{
+	ALT_DEBUG(0, "BEGIN AltsoundProcessorBase::cacheSample()");
+	INDENT;
+
+	std::ifstream file_in(path_in, std::ios::binary | std::ios::ate);
+	if (!file_in.good()) {
+		ALT_ERROR(1, "Unable to open sample: %s", getShortPath(path_in).c_str());
+
+		OUTDENT;
+		ALT_DEBUG(0, "END AltsoundProcessorBase::cacheSample()");
+		return nullptr;
+	}
+	const std::streamoff file_size = file_in.tellg();
+
+	if (file_size <= 0 || static_cast<size_t>(file_size) > cache_cap) {
+		ALT_INFO(1, "Sample does not fit preload arena: %s", getShortPath(path_in).c_str());
+
+		OUTDENT;
+		ALT_DEBUG(0, "END AltsoundProcessorBase::cacheSample()");
+		return nullptr;
+	}
+	const size_t size = static_cast<size_t>(file_size);
+
+	// make room, least recently used first.  Samples backing an active
+	// stream must stay, BASS reads them in place
+	if (evict) {
+		auto lru_it = cache_lru.end();
+		while (cache_used + size > cache_cap && lru_it != cache_lru.begin()) {
+			--lru_it;
+			if (sampleInUse(*lru_it))
+				continue;
+
+			const auto entry = sample_cache.find(*lru_it);
+			ALT_INFO(1, "Evicting preloaded sample: %s", getShortPath(*lru_it).c_str());
+			cache_used -= entry->second.data.size();
+			sample_cache.erase(entry);
+			lru_it = cache_lru.erase(lru_it);
+		}
+	}
+
+	if (cache_used + size > cache_cap) {
+		ALT_INFO(1, "Preload arena full, not caching: %s", getShortPath(path_in).c_str());
+
+		OUTDENT;
+		ALT_DEBUG(0, "END AltsoundProcessorBase::cacheSample()");
+		return nullptr;
+	}
+
+	std::vector<char> data(size);
+	file_in.seekg(0, std::ios::beg);
+	if (!file_in.read(data.data(), size)) {
+		ALT_ERROR(1, "Unable to read sample: %s", getShortPath(path_in).c_str());
+
+		OUTDENT;
+		ALT_DEBUG(0, "END AltsoundProcessorBase::cacheSample()");
+		return nullptr;
+	}
+
+	cache_lru.push_front(path_in);
+	CachedSample& entry = sample_cache[path_in];
+	entry.data.swap(data);
+	entry.lru_it = cache_lru.begin();
+	cache_used += size;
+	ALT_INFO(1, "Preloaded sample: %s (%u bytes, %u/%u used)", getShortPath(path_in).c_str(),
+	         static_cast<unsigned int>(size), static_cast<unsigned int>(cache_used),
+	         static_cast<unsigned int>(cache_cap));
+
+	OUTDENT;
+	ALT_DEBUG(0, "END AltsoundProcessorBase::cacheSample()");
+	return &entry.data;
+}
+
+// ----------------------------------------------------------------------------
+
+bool AltsoundProcessorBase::sampleInUse(const std::string& path_in)
+{
+	return std::any_of(channel_stream.begin(), channel_stream.end(), [&](const AltsoundStreamInfo* stream) {
+		return stream && stream->sample_path == path_in;
+	});
+}
+
+// ----------------------------------------------------------------------------
+
 bool AltsoundProcessorBase::freeStream(const HSTREAM hstream_in)
 {
 	ALT_INFO(0, "BEGIN AltsoundProcessorBase::freeStream()");
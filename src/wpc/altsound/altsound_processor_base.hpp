@@ -21,7 +21,11 @@
 #endif
 
 // Library includes
+#include <list>
 #include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 // Local includes
 #include "altsound_data.hpp"
@@ -74,6 +78,9 @@ public:
 	void setSkipCount(const unsigned int skip_count_in);
 	unsigned int getSkipCount() const;
 
+	// sample preload mutator, cache_size_in is the arena cap in bytes
+	void preloadSamples(const bool preload_in, const size_t cache_size_in);
+
 public: // data
 
 protected: // functions
@@ -87,6 +94,9 @@ protected: // functions
 	// Create stream for BASS playback
 	bool createStream(void* syncproc_in, AltsoundStreamInfo* stream_out);
 
+	// load sample file into the preload arena, if enabled and it fits
+	bool preloadSample(const std::string& path_in);
+
 	// get short path of current game <gamename>/subpath/filename
 	std::string getShortPath(const std::string& path_in);
 
@@ -124,8 +134,29 @@ protected: // data
 
 private: // functions
 
+	// find sample in the preload arena, loading it (and evicting least
+	// recently used samples) on a miss.  Returns nullptr if not cached
+	const std::vector<char>* getCachedSample(const std::string& path_in);
+
+	// read sample file into the preload arena
+	const std::vector<char>* cacheSample(const std::string& path_in, const bool evict);
+
+	// determine if the provided sample is used by an active stream
+	static bool sampleInUse(const std::string& path_in);
+
 private: // data
 
+	struct CachedSample {
+		std::vector<char> data;
+		std::list<std::string>::iterator lru_it;
+	};
+
+	bool preload = false;
+	size_t cache_cap = 0;
+	size_t cache_used = 0;
+	std::unordered_map<std::string, CachedSample> sample_cache;
+	std::list<std::string> cache_lru; // most recently used first
+
 	bool rec_snd_cmds = false;
 	bool use_rom_ctrl = true;
 	static float global_vol;
@@ -195,4 +226,11 @@ inline void AltsoundProcessorBase::setSkipCount(const unsigned int skip_count_in
 	skip_count = skip_count_in;
 }
 
+// ----------------------------------------------------------------------------
+
+inline void AltsoundProcessorBase::preloadSamples(const bool preload_in, const size_t cache_size_in) {
+	preload = preload_in;
+	cache_cap = cache_size_in;
+}
+
 #endif // ALTSOUND_PROCESSOR_BASE_HPP
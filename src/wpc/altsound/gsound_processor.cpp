@@ -258,7 +258,7 @@ bool GSoundProcessor::handleCmd(const unsigned int cmd_combined_in)
 	new_stream->loop = samples[sample_idx].loop;
 	new_stream->ducking_profile = samples[sample_idx].ducking_profile;
 
-	const AltsoundSampleType sample_type = toSampleType(samples[sample_idx].type);
+	const AltsoundSampleType sample_type = sample_types[sample_idx];
 
 	switch (sample_type) {
 	case MUSIC:
@@ -381,6 +381,12 @@ void GSoundProcessor::init()
 	}
 	ALT_INFO(1, "SUCCESS: GSoundProcessor::loadSamples()");
 
+	// fill the preload arena with the non-looping samples, if enabled
+	for (const auto& sample : samples) {
+		if (!sample.loop)
+			preloadSample(sample.fname);
+	}
+
 	// populate group volumes
 	group_vol[streamTypeToIndex[MUSIC]]   = music_behavior.group_vol;
 	group_vol[streamTypeToIndex[CALLOUT]] = callout_behavior.group_vol;
@@ -423,6 +429,16 @@ bool GSoundProcessor::loadSamples()
 	}
 	ALT_INFO(1, "SUCCESS GSoundCsvParser::parse()");
 
+	// resolve sample types and index samples by command ID
+	sample_types.clear();
+	sample_index.clear();
+	sample_types.reserve(samples.size());
+	for (size_t i = 0; i < samples.size(); ++i) {
+		sample_types.push_back(toSampleType(samples[i].type));
+		sample_index[samples[i].id].push_back(static_cast<unsigned int>(i));
+	}
+	ALT_INFO(1, "Indexed %u command ID(s)", static_cast<unsigned int>(sample_index.size()));
+
 	OUTDENT;
 	ALT_DEBUG(0, "END GSoundProcessor::init()");
 	return true;
@@ -440,15 +456,16 @@ unsigned int GSoundProcessor::getSample(const unsigned int cmd_combined_in)
 
 	std::uniform_int_distribution<int> distribution(0, std::numeric_limits<int>::max());
 
-	for (size_t i = 0; i < samples.size(); ++i) {
-		if (samples[i].id == cmd_combined_in) {
+	const auto it = sample_index.find(cmd_combined_in);
+	if (it != sample_index.end()) {
+		for (const unsigned int i : it->second) {
 			matching_sample_count++;
 
 			// reservoir sampling approach
 			// Each matching sample has equal chance (1/matching_sample_count) to
 			// become the selected one.
 			if (distribution(generator) % matching_sample_count == 0) {
-				sample_idx = static_cast<unsigned int>(i);
+				sample_idx = i;
 			}
 		}
 	}
@@ -107,6 +107,8 @@ private: // data
 	bool is_initialized;
 	bool is_stable; // future use
 	std::vector<GSoundSampleInfo> samples;
+	std::vector<AltsoundSampleType> sample_types; // resolved samples[].type
+	std::unordered_map<unsigned int, std::vector<unsigned int>> sample_index; // command ID -> sample indices
 	std::mt19937 generator; // mersenne twister
 };
 
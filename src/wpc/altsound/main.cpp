@@ -40,6 +40,8 @@
 #include "altsound_processor.hpp"
 #include "gsound_processor.hpp"
 #include "altsound_file_parser.hpp"
+#include "altsound_csv_parser.hpp"
+#include "altsound_index.hpp"
 #include "altsound_ini_processor.hpp"
 #include "inipp.h"
 #include "altsound_data.hpp"
@@ -107,6 +109,9 @@ bool parseCmdFile(InitData& init_data);
 // Handle playback of stored sound commands
 bool playbackCommands(const std::vector<TestData>& testData);
 
+// Write the binary sample index for the AltSound package at altsound_path
+bool packSamples(const std::string& altsound_path);
+
 // ---------------------------------------------------------------------------
 // Functional code
 // ---------------------------------------------------------------------------
@@ -116,9 +121,20 @@ int main(int argc, const char* argv[]) {
 		std::cout << "Usage: " << argv[0] << " <gamename>-cmdlog.txt path" << std::endl;
 		std::cout << "Where <gamename>-cmdlog.txt path is the full path and "
 			      << "filename of recording file" << std::endl;
+		std::cout << "   or: " << argv[0] << " --pack <altsound path>" << std::endl;
+		std::cout << "Where <altsound path> is the folder of an AltSound or "
+			      << "Legacy format package (altsound/<gamename>)" << std::endl;
 		return 1;
 	}
 
+	if (std::strcmp(argv[1], "--pack") == 0) {
+		if (argc < 3) {
+			std::cout << "Missing <altsound path>" << std::endl;
+			return 1;
+		}
+		return packSamples(argv[2]) ? 0 : 1;
+	}
+
 	auto init_result = init(argv[1]);
 
 	if (!init_result.first) {
@@ -243,6 +259,9 @@ std::pair<bool, InitData> init(const std::string& log_path)
 		// set sound command recording preference
 		processor->recordSoundCmds(ini_proc.recordSoundCmds());
 
+		// set sample preload preference
+		processor->preloadSamples(ini_proc.preloadSamples(), static_cast<size_t>(ini_proc.getPreloadCacheMb()) << 20);
+
 		processor->init();
 
 		// Initialize BASS
@@ -263,6 +282,60 @@ std::pair<bool, InitData> init(const std::string& log_path)
 	}
 }
 
+// ----------------------------------------------------------------------------
+// Sample index packer
+// ----------------------------------------------------------------------------
+
+bool packSamples(const std::string& altsound_path_in)
+{
+	ALT_DEBUG(0, "BEGIN packSamples()");
+
+	std::string altsound_path = altsound_path_in;
+	std::replace(altsound_path.begin(), altsound_path.end(), '\\', '/');
+	while (!altsound_path.empty() && altsound_path.back() == '/')
+		altsound_path.pop_back();
+
+	AltsoundIniProcessor ini_proc;
+	if (!ini_proc.parse_altsound_ini(altsound_path)) {
+		ALT_ERROR(0, "Failed to parse_altsound_ini(%s)", altsound_path.c_str());
+		ALT_DEBUG(0, "END packSamples()");
+		return false;
+	}
+
+	const string format = ini_proc.getAltsoundFormat();
+	std::vector<AltsoundSampleInfo> samples;
+	bool success;
+
+	if (format == "altsound") {
+		AltsoundCsvParser csv_parser(altsound_path);
+		success = csv_parser.parse(samples);
+	}
+	else if (format == "legacy") {
+		AltsoundFileParser file_parser(altsound_path);
+		success = file_parser.parse(samples);
+	}
+	else {
+		ALT_ERROR(0, "Sample index not supported for format: %s", format.c_str());
+		ALT_DEBUG(0, "END packSamples()");
+		return false;
+	}
+
+	if (success) {
+		AltsoundIndex index(altsound_path, format);
+		success = index.write(samples);
+	}
+
+	if (success) {
+		std::cout << "Packed " << samples.size() << " samples into " << altsound_path << "/altsound.idx" << std::endl;
+	}
+	else {
+		std::cout << "Packing failed, see altsound.log" << std::endl;
+	}
+
+	ALT_DEBUG(0, "END packSamples()");
+	return success;
+}
+
 // ----------------------------------------------------------------------------
 // Command file parser
 // ----------------------------------------------------------------------------
@@ -7,9 +7,13 @@
 
 // Std Library includes
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <ctime>
 #include <cstring>
 #include <ostream>
+#include <thread>
 #include <sys/stat.h>
 
 #ifdef __cplusplus
@@ -17,6 +21,7 @@
 #endif
   #include "core.h"
   #include "osdepend.h"
+  #include "threadsched.h"
 #ifdef __cplusplus
   }
 #endif
@@ -59,6 +64,10 @@ StreamArray channel_stream;
 
 #define FILTERED_INCOMPLETE 999
 
+// size of the command queue between the emulation and the worker thread,
+// must be a power of 2
+#define ALT_CMD_QUEUE_SIZE 256
+
 // ---------------------------------------------------------------------------
 // Externals
 // ---------------------------------------------------------------------------
@@ -83,6 +92,30 @@ AltsoundProcessorBase *processor = nullptr;
 // Use ROM control commands to control master volume
 bool use_rom_ctrl = true;
 
+// Command queue entry, filled on the emulation thread
+typedef struct _queued_cmd {
+	std::chrono::steady_clock::time_point timestamp;
+	int board_no;
+	int cmd;
+} QueuedCmd;
+
+// Single producer (emulation thread), single consumer (worker thread)
+static QueuedCmd cmd_queue[ALT_CMD_QUEUE_SIZE];
+static std::atomic<unsigned int> cmd_queue_read(0);
+static std::atomic<unsigned int> cmd_queue_write(0);
+static unsigned int cmd_queue_dropped = 0;
+
+// Worker thread state
+static std::thread cmd_worker;
+static std::atomic<bool> cmd_worker_run(false);
+static std::mutex cmd_worker_mutex;
+static std::condition_variable cmd_worker_cv;
+
+// Queue latency statistics, only touched by the worker thread
+static long long cmd_latency_max_us = 0;
+static long long cmd_latency_total_us = 0;
+static unsigned int cmd_latency_count = 0;
+
 // ---------------------------------------------------------------------------
 // Function prototypes
 // ---------------------------------------------------------------------------
@@ -90,29 +123,96 @@ bool use_rom_ctrl = true;
 // get path to VPinMAME
 std::string get_vpinmame_path();
 
+// process one queued command on the worker thread
+static void alt_sound_process(int boardNo, int cmd);
+
+// worker thread main loop
+static void alt_sound_worker();
+
 // ---------------------------------------------------------------------------
 // Functional code
 // ---------------------------------------------------------------------------
 
 extern "C" void alt_sound_handle(int boardNo, int cmd)
 {
-	ALT_DEBUG(0, "");
-	ALT_DEBUG(0, "BEGIN alt_sound_handle()");
-	INDENT;
-
 	if (!is_initialized && altsound_stable) {
 		is_initialized = alt_sound_init(&cmds);
 		altsound_stable = is_initialized;
+
+		if (is_initialized) {
+			// start command processing off the emulation thread
+			cmd_queue_read = 0;
+			cmd_queue_write = 0;
+			cmd_queue_dropped = 0;
+			cmd_worker_run = true;
+			cmd_worker = std::thread(alt_sound_worker);
+		}
 	}
 
 	if (!is_initialized || !altsound_stable) {
 		ALT_ERROR(0, "Altsound unstable. Processing skipped.");
+		return;
+	}
 
-		OUTDENT;
-		ALT_DEBUG(0, "END alt_sound_handle()");
+	// queue the command for the worker; never block the emulation thread
+	const unsigned int write = cmd_queue_write.load(std::memory_order_relaxed);
+	if (write - cmd_queue_read.load(std::memory_order_acquire) >= ALT_CMD_QUEUE_SIZE) {
+		cmd_queue_dropped++;
+		ALT_WARNING(0, "Command queue full, dropped command: %04X", cmd);
 		return;
 	}
 
+	QueuedCmd& entry = cmd_queue[write & (ALT_CMD_QUEUE_SIZE - 1)];
+	entry.timestamp = std::chrono::steady_clock::now();
+	entry.board_no = boardNo;
+	entry.cmd = cmd;
+	cmd_queue_write.store(write + 1, std::memory_order_release);
+
+	cmd_worker_cv.notify_one();
+}
+
+// ---------------------------------------------------------------------------
+
+static void alt_sound_worker()
+{
+	threadsched_apply(THREADSCHED_ALTSOUND);
+
+	while (true) {
+		const unsigned int read = cmd_queue_read.load(std::memory_order_relaxed);
+
+		if (read == cmd_queue_write.load(std::memory_order_acquire)) {
+			if (!cmd_worker_run)
+				break;
+
+			// the producer doesn't take the mutex, so don't rely on the
+			// notification alone and poll at a short interval as well
+			std::unique_lock<std::mutex> lock(cmd_worker_mutex);
+			cmd_worker_cv.wait_for(lock, std::chrono::milliseconds(2));
+			continue;
+		}
+
+		const QueuedCmd entry = cmd_queue[read & (ALT_CMD_QUEUE_SIZE - 1)];
+		cmd_queue_read.store(read + 1, std::memory_order_release);
+
+		const long long latency_us = std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now() - entry.timestamp).count();
+		cmd_latency_max_us = std::max(cmd_latency_max_us, latency_us);
+		cmd_latency_total_us += latency_us;
+		cmd_latency_count++;
+		ALT_INFO(0, "Command %04X queue latency: %lld us", entry.cmd, latency_us);
+
+		alt_sound_process(entry.board_no, entry.cmd);
+	}
+}
+
+// ---------------------------------------------------------------------------
+
+static void alt_sound_process(int boardNo, int cmd)
+{
+	ALT_DEBUG(0, "");
+	ALT_DEBUG(0, "BEGIN alt_sound_process()");
+	INDENT;
+
 	//DAR@20230519 not sure what this does
 	int	attenuation = osd_get_mastervolume();
 
@@ -156,7 +256,7 @@ extern "C" void alt_sound_handle(int boardNo, int cmd)
 		}
 		
 		OUTDENT;
-		ALT_DEBUG(0, "END alt_sound_handle");
+		ALT_DEBUG(0, "END alt_sound_process()");
 		return;
 	}
 	ALT_DEBUG(0, "Command complete. Processing...");
@@ -171,7 +271,7 @@ extern "C" void alt_sound_handle(int boardNo, int cmd)
 		postprocess_commands(cmd_combined);
 		
 		OUTDENT;
-		ALT_DEBUG(0, "END alt_sound_handle()");
+		ALT_DEBUG(0, "END alt_sound_process()");
 		return;
 	}
 	ALT_INFO(0, "SUCCESS processor::handleCmd()");
@@ -180,7 +280,7 @@ extern "C" void alt_sound_handle(int boardNo, int cmd)
 	postprocess_commands(cmd_combined);
 
 	OUTDENT;
-	ALT_DEBUG(0, "END alt_sound_handle()");
+	ALT_DEBUG(0, "END alt_sound_process()");
 	ALT_DEBUG(0, "");
 }
 
@@ -259,6 +359,7 @@ BOOL alt_sound_init(CmdData* cmds_out)
 	processor->romControlsVol(ini_proc.usingRomVolumeControl());
 	processor->recordSoundCmds(ini_proc.recordSoundCmds());
 	processor->setSkipCount(ini_proc.getSkipCount());
+	processor->preloadSamples(ini_proc.preloadSamples(), static_cast<size_t>(ini_proc.getPreloadCacheMb()) << 20);
 
 	// perform processor initialization (load samples, etc)
 	processor->init();
@@ -312,6 +413,24 @@ extern "C" void alt_sound_exit() {
 	ALT_DEBUG(0, "BEGIN alt_sound_exit()");
 	INDENT;
 
+	// drain the command queue and stop the worker before the processor goes
+	if (cmd_worker.joinable()) {
+		cmd_worker_run = false;
+		cmd_worker_cv.notify_one();
+		cmd_worker.join();
+
+		if (cmd_latency_count > 0) {
+			ALT_INFO(0, "Command queue latency: avg %lld us, max %lld us over %u commands",
+			         cmd_latency_total_us / cmd_latency_count, cmd_latency_max_us, cmd_latency_count);
+		}
+		if (cmd_queue_dropped > 0) {
+			ALT_WARNING(0, "Command queue overflowed, %u commands dropped", cmd_queue_dropped);
+		}
+		cmd_latency_max_us = 0;
+		cmd_latency_total_us = 0;
+		cmd_latency_count = 0;
+	}
+
 	// Initialization support
 	is_initialized = FALSE;
 	run_once = TRUE;
@@ -343,6 +462,9 @@ extern "C" void alt_sound_pause(BOOL pause) {
 	ALT_DEBUG(0, "BEGIN alt_sound_pause()");
 	INDENT;
 
+	// the worker thread may be creating or freeing streams right now
+	std::lock_guard<std::mutex> guard(io_mutex);
+
 	if (pause) {
 		ALT_INFO(0, "Pausing stream playback (ALL)");
 
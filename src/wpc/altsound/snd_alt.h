@@ -20,6 +20,7 @@
 
 // Local includes
 #include "../../ext/bass/bass.h"
+#include "altsound_mixer.hpp"
 
 #ifdef __cplusplus
   extern "C" {
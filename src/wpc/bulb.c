@@ -48,6 +48,7 @@ typedef struct {
    double r0;       /* resistance at 293K, computed from previous ratings */
    double cool_factor[BULB_T_MAX + 1]; /* precomputed cool down factor = Energy / (Mass * Specific Heat) */
    double heat_factor[BULB_T_MAX + 1]; /* precomputed heat factor = 1.0 / (R * Mass * Specific Heat) */
+   double cool_time[BULB_T_MAX + 1];   /* precomputed time (s) to cool down from BULB_T_MAX to a temperature, down to 294K */
 } bulb_tLampCharacteristics;
 
 // Impact of coil form factor approximated values based on "The Coiling Factor in the Tungsten Filament Lamps" by D. C. Agrawal
@@ -178,6 +179,26 @@ void bulb_init()
          bulbs[bulb].heat_factor[i] /= bulbs[bulb].mass * specific_heat;
       }
    }
+
+   // Precompute the cool down time to temperature LUT by integrating the cool down once, with the same 1ms steps than the per call integration did
+   for (int bulb=0; bulb<BULB_MAX; bulb++)
+   {
+      double T = BULB_T_MAX, t = 0.0;
+      int next = BULB_T_MAX - 1;
+      bulbs[bulb].cool_time[BULB_T_MAX] = 0.0;
+      while (next >= 294)
+      {
+         const double Tn = T + 0.001 * bulbs[bulb].cool_factor[(int) T];
+         if (Tn >= T)
+            break;
+         for (; next >= 294 && next >= Tn; next--)
+            bulbs[bulb].cool_time[next] = t + 0.001 * (T - next) / (T - Tn);
+         T = Tn;
+         t += 0.001;
+      }
+      for (; next >= 0; next--)
+         bulbs[bulb].cool_time[next] = t;
+   }
 }
 
 /*-------------------------------
@@ -246,19 +267,39 @@ double bulb_cool_down_factor(const int bulb, const double T)
 /-------------------------------*/
 double bulb_cool_down(const int bulb, double T, float duration)
 {
+   #if !ENABLE_COMPUTE_CHARACTERISTICS
+   // Look up the time at which the cool down from BULB_T_MAX reaches T, then the temperature reached after the given duration
+   const double* const cool_time = bulbs[bulb].cool_time;
+   if (duration <= 0.0f)
+      return T;
+   if (T <= 294.0)
+      return 293.0;
+   if (T > BULB_T_MAX)
+      T = BULB_T_MAX;
+   const int Ti = (int) T;
+   const double t = (Ti >= BULB_T_MAX ? cool_time[BULB_T_MAX] : cool_time[Ti] + (T - Ti) * (cool_time[Ti + 1] - cool_time[Ti])) + duration;
+   if (t >= cool_time[294])
+      return 293.0;
+   // cool_time decreases with the temperature: find lo < hi with cool_time[lo] > t >= cool_time[hi]
+   int lo = 294, hi = Ti >= BULB_T_MAX ? BULB_T_MAX : Ti + 1;
+   while (hi - lo > 1)
+   {
+      const int mid = (lo + hi) / 2;
+      if (cool_time[mid] > t)
+         lo = mid;
+      else
+         hi = mid;
+   }
+   return lo + (cool_time[lo] - t) / (cool_time[lo] - cool_time[hi]);
+   #else
    while (duration > 0.0f)
    {
       const float dt = duration > 0.001f ? 0.001f : duration;
       T += dt * bulbs[bulb].cool_factor[(int) T];
-      #if !ENABLE_COMPUTE_CHARACTERISTICS
-      if (T <= 294.0)
-      {
-         return 293.0;
-      }
-      #endif
       duration -= dt;
    }
    return T;
+   #endif
 }
 
 /*-------------------------------
@@ -275,6 +316,22 @@ float bulb_heat_up_factor(const int bulb, const float T, const float U, const fl
    return (float)(U1 * U1 * bulbs[bulb].heat_factor[(int)T] + bulbs[bulb].cool_factor[(int)T]);
 }
 
+/*-------------------------------
+/  Batch versions of bulb_heat_up_factor and bulb_filament_temperature_to_emission over n filaments stored as arrays
+/  (same results, only the LUT lookups are done lane after lane)
+/-------------------------------*/
+void bulb_heat_up_factors(const int n, const int* bulb, const float* T, const float* U, const float* serial_R, float* factor)
+{
+   for (int i = 0; i < n; i++)
+      factor[i] = bulb_heat_up_factor(bulb[i], T[i], U[i], serial_R[i]);
+}
+
+void bulb_filament_temperature_to_emissions(const int n, const int* bulb, const float* T, float* emission)
+{
+   for (int i = 0; i < n; i++)
+      emission[i] = bulb_filament_temperature_to_emission(bulb[i], T[i]);
+}
+
 /*-------------------------------
 /  Compute temperature of a filament under a given voltage over a given period (sum of heating and cooldown)
 /-------------------------------*/
@@ -21,6 +21,8 @@ extern double bulb_emission_to_filament_temperature(const double p);
 extern double bulb_cool_down_factor(const int bulb, const double T);
 extern double bulb_cool_down(const int bulb, double T, float duration);
 extern float bulb_heat_up_factor(const int bulb, const float T, const float U, const float serial_R);
+extern void bulb_heat_up_factors(const int n, const int* bulb, const float* T, const float* U, const float* serial_R, float* factor);
+extern void bulb_filament_temperature_to_emissions(const int n, const int* bulb, const float* T, float* emission);
 extern double bulb_heat_up(const int bulb, double T, float duration, const float U, const float serial_R);
 
 #endif /* INC_BULB */
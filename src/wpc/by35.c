@@ -68,6 +68,7 @@ static struct {
   int bcd[7], lastbcd;
   const int *bcd2seg;
   int lampadr1, lampadr2;
+  UINT8 lampData[2][16]; /* lamp data strobed since the last lamp update, by board and lamp address */
   UINT32 solenoids;
   core_tSeg segments,pseg;
   int diagnosticLed;
@@ -128,20 +129,32 @@ static void by35_dispStrobe(int mask) {
   }
 }
 
+/* The lamps are strobed on every write of the lamp data, many times per multiplex cycle:
+   the data is only gathered by address here, and spread to the lamp matrix once per lamp update */
 static void by35_lampStrobe(int board, int lampadr) {
   if (lampadr != 0x0f) {
     int lampdata = (locals.a0>>4)^0x0f;
 #ifdef LISY_SUPPORT
     if ( lampdata ) lisy35_lamp_handler( 0, board, lampadr, lampdata);
 #endif
-    UINT8 *matrix = &coreGlobals.tmpLampMatrix[(lampadr>>3)+8*board];
-    int bit = 1<<(lampadr & 0x07);
+    locals.lampData[board][lampadr] |= lampdata;
+  }
+}
+
+static void by35_updateLamps(void) {
+  int board, lampadr;
+  for (board = 0; board < 2; board++)
+    for (lampadr = 0; lampadr < 0x0f; lampadr++) {
+      int lampdata = locals.lampData[board][lampadr];
+      UINT8 *matrix = &coreGlobals.tmpLampMatrix[(lampadr>>3)+8*board];
+      int bit = 1<<(lampadr & 0x07);
 
-    while (lampdata) {
-      if (lampdata & 0x01) *matrix |= bit;
-      lampdata >>= 1; matrix += 2;
+      while (lampdata) {
+        if (lampdata & 0x01) *matrix |= bit;
+        lampdata >>= 1; matrix += 2;
+      }
     }
-  }
+  memset(locals.lampData, 0, sizeof(locals.lampData));
 }
 
 /* PIA0:A-W  Control what is read from PIA0:B */
@@ -353,6 +366,7 @@ static INTERRUPT_GEN(by35_vblank) {
 
   /*-- lamps --*/
   if ((locals.vblankCount % BY35_LAMPSMOOTH) == 0) {
+    by35_updateLamps();
     memcpy(coreGlobals.lampMatrix, coreGlobals.tmpLampMatrix, sizeof(coreGlobals.tmpLampMatrix));
     memset(coreGlobals.tmpLampMatrix, 0, sizeof(coreGlobals.tmpLampMatrix));
 #ifdef LISY_SUPPORT
@@ -458,7 +458,8 @@ static VIDEO_STOP(byVP) {
 }
 
 static PINMAME_VIDEO_UPDATE(byVP_update) {
-  TMS9928A_refresh((core_gameData->hw.display ? 2 : 1), bitmap, 1);
+  // only what changed is drawn, unless the UI drew over the screen
+  TMS9928A_refresh((core_gameData->hw.display ? 2 : 1), bitmap, ui_dirty != 0);
   return 0;
 }
 
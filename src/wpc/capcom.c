@@ -135,6 +135,9 @@ static struct {
   int u16IRQ4Mask, u16IRQState, u16IRQ1Adjust;
   double u16IRQ1Period, u16IRQ4Line1Period, u16IRQ4Line2Period, u16IRQ4Line3Period;
   mame_timer *u16IRQ1timer, *u16IRQ4Line1timer, *u16IRQ4Line2timer, *u16IRQ4Line3timer;
+
+  UINT16 dmdRows[64][32]; // frame buffer words of the rows last decoded into dmdDotRaw
+  int dmdRowsValid;
 } locals;
 
 static NVRAM_HANDLER(cc);
@@ -933,23 +936,40 @@ MACHINE_DRIVER_START(cc2)
 MACHINE_DRIVER_END
 
 
+/* The frame buffer holds a 2 bit shade per dot, 8 dots per word (high bits first) */
+/* Each byte is expanded through a table to its 4 dots (one byte per dot, in memory order) */
+static UINT32 cc_dmd_dots[256];
+static int cc_dmd_dots_valid;
+
+/* Decode a row of words into dmdDotRaw, unless it is unchanged since it was last decoded */
+static void cc_dmd_decode_row(UINT8 *line, const UINT16 *RAM, int words, UINT16 *last) {
+  if (!cc_dmd_dots_valid) {
+    for (int ii = 0; ii < 256; ii++) {
+      const UINT8 dots[4] = { (ii >> 6) & 3, (ii >> 4) & 3, (ii >> 2) & 3, ii & 3 };
+      memcpy(&cc_dmd_dots[ii], dots, 4);
+    }
+    cc_dmd_dots_valid = 1;
+  }
+  if (locals.dmdRowsValid && memcmp(last, RAM, words * sizeof(UINT16)) == 0)
+    return;
+  memcpy(last, RAM, words * sizeof(UINT16));
+  for (int kk = 0; kk < words; kk++) {
+    memcpy(line, &cc_dmd_dots[RAM[kk] >> 8], 4);
+    memcpy(line + 4, &cc_dmd_dots[RAM[kk] & 0xff], 4);
+    line += 8;
+  }
+}
+
 /********************************/
 /*** 128 X 32 NORMAL SIZE DMD ***/
 /********************************/
 PINMAME_VIDEO_UPDATE(cc_dmd128x32) {
   const UINT16 *RAM = ramptr + 0x800 * locals.visible_page + 0x10;
-  UINT8* line = &coreGlobals.dmdDotRaw[0];
   for (int ii = 0; ii < 32; ii++) {
-    for (int kk = 0; kk < 16; kk++) {
-      UINT16 intens1 = RAM[0];
-      for(int jj = 0; jj < 8; jj++) {
-         *line++ = (intens1 >> 14) & 0x0003;
-         intens1 <<= 2;
-      }
-      RAM += 1;
-    }
-    RAM += 16;
+    cc_dmd_decode_row(&coreGlobals.dmdDotRaw[ii * layout->length], RAM, 16, locals.dmdRows[ii]);
+    RAM += 32;
   }
+  locals.dmdRowsValid = 1;
   core_dmd_video_update(bitmap, cliprect, layout, NULL);
   return 0;
 }
@@ -959,22 +979,11 @@ PINMAME_VIDEO_UPDATE(cc_dmd128x32) {
 /*******************************/
 PINMAME_VIDEO_UPDATE(cc_dmd256x64) {
   const UINT16 *RAM = ramptr + 0x800 * locals.visible_page;
-  for (int ii = 0; ii < 64; ii++) {
-    UINT8 *linel = &coreGlobals.dmdDotRaw[ii * layout->length];
-    UINT8 *liner = &coreGlobals.dmdDotRaw[ii * layout->length + 128];
-    for (int kk = 0; kk < 16; kk++) {
-      UINT16 intensl = RAM[0];
-      UINT16 intensr = RAM[0x10];
-      for(int jj=0;jj<8;jj++) {
-         *linel++ = (intensl >> 14) & 0x0003;
-         intensl <<= 2;
-         *liner++ = (intensr >> 14) & 0x0003;
-         intensr <<= 2;
-      }
-      RAM += 1;
-    }
-    RAM += 16;
+  for (int ii = 0; ii < 64; ii++) { // left half in the first 16 words of the row, right half in the next 16
+    cc_dmd_decode_row(&coreGlobals.dmdDotRaw[ii * layout->length], RAM, 32, locals.dmdRows[ii]);
+    RAM += 32;
   }
+  locals.dmdRowsValid = 1;
   core_dmd_video_update(bitmap, cliprect, layout, NULL);
   return 0;
 }
@@ -10,11 +10,30 @@
 #include "core.h"
 #include "video.h"
 #include "bulb.h"
+#if defined(VPINMAME) || defined(LIBPINMAME)
+ #include "outexport.h"
+ #include "netpub.h"
+#endif
 
 #ifdef PROC_SUPPORT
  #include "p-roc/p-roc.h"
 #endif
 
+#if (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || defined(__x86_64__)
+ #define SSE_DMD_OPT
+ #include <emmintrin.h>
+ #if defined(_MSC_VER) || defined(__GNUC__) || defined(__clang__)
+  #define AVX2_DMD_OPT // selected at runtime
+  #include <immintrin.h>
+  #if defined(_MSC_VER) && !defined(__clang__)
+   #include <intrin.h>
+  #endif
+ #endif
+#elif (defined(_M_ARM) || defined(_M_ARM64) || defined(__arm__) || defined(__arm64__) || defined(__aarch64__)) && (!defined(__ARM_ARCH) || __ARM_ARCH >= 7) && (!defined(_MSC_VER) || defined(__clang__)) //!! disable sse2neon if MSVC&non-clang
+ #define SSE_DMD_OPT // uses sse2neon then
+ #include "../../ext/sse2neon.h"
+#endif
+
 #if defined(VPINMAME) || defined(LIBPINMAME)
  #ifndef LIBPINMAME
   #ifndef WIN32_LEAN_AND_MEAN
@@ -51,11 +70,18 @@
 
  static UINT8 has_DMD_Video = 0;
 
-#define CORE_MAX_RAW_DMD_FRAMES 5
- static UINT8  raw_dmd_frames[CORE_MAX_RAW_DMD_FRAMES * DMD_MAXX*DMD_MAXY / 8];
- static UINT32 raw_dmd_frame_count = 0;
+ // Main DMD palette triggers, see core_dmd_colorize
+ static struct {
+   int    count;                                     // Number of defined triggers
+   int    active;                                    // Trigger whose palette is used, -1 for the user LUT
+   UINT64 hash[CORE_DMD_MAX_PALETTE_TRIGGERS];       // Bitplane frame hash (see core_dmd_bitplane_hash)
+   int    nColors[CORE_DMD_MAX_PALETTE_TRIGGERS];    // 4 or 16 colors
+   UINT32 colors[CORE_DMD_MAX_PALETTE_TRIGGERS][16]; // 0x00BBGGRR, like the user LUT
+ } dmdPalettes = { 0, -1 };
 
  UINT8 g_needs_DMD_update = 1;
+ UINT64 g_raw_dmd_hash = 0;       // Hash of the last frame stored in g_raw_dmdbuffer
+ UINT64 g_raw_dmd_dirty_rows = 0; // Rows changed since a consumer last cleared this mask (together with g_needs_DMD_update)
 
  #ifdef VPINMAME
   UINT8 g_VPM_ignore_pwm_segments_update = 0; // workaround if both the VPM/external DMD is running AND the table script also renders/pulls the segment data
@@ -97,6 +123,10 @@ void vp_setDIP(int bank, int value) { }
 
 #ifdef LIBPINMAME
   extern void libpinmame_update_display(const int index, const struct core_dispLayout* p_layout, const void* p_data);
+  extern int libpinmame_get_switch_event(int* p_swNo, int* p_state, double* p_time);
+  extern int libpinmame_replay_poll(void);
+  extern void libpinmame_golden_dmd(const UINT8* p_luminance, const UINT8* p_bitplane, const int size);
+  extern void libpinmame_output_push(void);
 #endif
 
 #ifndef LIBPINMAME
@@ -121,6 +151,8 @@ INLINE UINT8 saturatedByte(float v)
 static void drawChar(struct mame_bitmap *bitmap, int row, int col, UINT16 seg_bits, int type, UINT8 dimming[16]);
 static UINT32 core_initDisplaySize(const struct core_dispLayout *layout);
 static VIDEO_UPDATE(core_status);
+static void core_init_ac_heating(void);
+static void core_init_gen_dispatch(void);
 
 /*---------------------------
 /  Global variables
@@ -722,9 +754,18 @@ static struct {
   int       displaySize;   // 1=compact 2=normal
   tSegData  *segData;      // segments to use (normal/compact)
   void      *timers[5];    // allocated timers
+  #ifdef LIBPINMAME
+    void    *swEventTimer; // polls the host switch event queue
+  #endif
+  #ifdef PROC_SUPPORT
+    void    *procSyncTimer; // P-ROC switch events and driver flush
+  #endif
   int       flipTimer[4];  // time since flipper was activated (used for EOS simulation)
   UINT8     flipMask;      // Flipper bits used for flippers
   int       firstSimRow, maxSimRows; // space available for simulator
+  /*-- Alphanumeric characters as last drawn by updateDisplay, to skip the unchanged ones --*/
+  struct { int row, col; UINT16 segBits; UINT8 type, dimmed, valid; UINT8 dim[16]; } drawnChar[CORE_SEGCOUNT];
+  UINT32    drawnCharRefresh; // full refresh count when drawnChar was last valid
   int       solLog[4];
   int       solLogCount;
   /*-- Event reporting (used LibPinMAME and on screen display) --*/
@@ -734,17 +775,75 @@ static struct {
   UINT64    lastSol;
   /*-- VPinMAME specifics --*/
   #if defined(VPINMAME) || defined(LIBPINMAME)
-    UINT8   vpm_dmd_last_lum[DMD_MAXY * DMD_MAXX];
+    UINT64  vpm_dmd_row_hashes[2][DMD_MAXY]; // Row hashes of main DMDs without PWM state
+    core_segOverallLayout_t alphaLayout;     // Alphanumeric layout class, identified once (see alphaLayoutValid)
+    int     alphaLayoutValid;
+    int     alphaSentValid;                  // Segments sent to dmddevice / rendered to the virtual DMD (alphaSent...) are valid
+    UINT32  alphaSentRefresh;                // full refresh count when the segments were last sent
+    UINT16  alphaSentSeg[CORE_SEGCOUNT], alphaSentSeg2[CORE_SEGCOUNT];
+    UINT8   alphaSentDim[CORE_SEGCOUNT];
     UINT8   vpm_dmd_luminance_lut[256];
-  #endif
-  #if defined(VPINMAME)
     UINT32  vpm_dmd_color_lut[256];
   #endif
 } locals;
 
+/*-- Hardware generation dependent behaviour of the hot paths, resolved from core_gameData->gen by
+     core_init_gen_dispatch when the machine starts and when the modulated solenoid options change --*/
+#define CORE_SOLSRC_NONE  0 // no such solenoid for this generation
+#define CORE_SOLSRC_SOL   1 // binary state in coreGlobals.solenoids
+#define CORE_SOLSRC_SOL2  2 // binary state in coreGlobals.solenoids2
+#define CORE_SOLSRC_PHYS  3 // modulated state in coreGlobals.physicOutputState
+#define CORE_SOL33_NONE   0
+#define CORE_SOL33_WPC    1 // WPC upper flipper solenoids
+#define CORE_SOL33_SAM    2 // SAM fake GameOn solenoid for fast flips
+#define CORE_SOL33_WS     3 // Whitestar aux board outputs
+static struct {
+  struct { UINT8 type, index; UINT32 mask; } sol[48]; // core_getSol sources of solenoids 1..48 (index in physicOutputState from CORE_MODOUT_SOL0)
+  int wpc, wpc95;         // WPC GameOn in 29..32, WPC95 extra solenoids 37..44 duplicated from 29..32
+  int sol33;              // CORE_SOL33_xxx: use of solenoids 33..36
+  int sol37;              // S11, SAM and Spike extra solenoids 37..44 in solenoids2
+  int modFlippers;        // WPC Fliptronics and later flipper solenoids are read modulated
+  int reportPhysicSols;   // core_updateSw reports the modulated solenoids to the OSD
+  int flipSwCol;          // switch column of the flipper buttons
+  int dmdDepth;           // bits per dot of the DMD bitplane frames: 4 (16 shades) or 2 (4 shades)
+  const UINT8* dmdBitplaneLum; // luminance of the shades of DMDs without PWM state, NULL if the driver provides it (SAM)
+  void (*dmdShadeFrame)(UINT32*, const UINT8*, const int, const UINT32, const int);
+  void (*dmdLuminance)(UINT8*, const UINT32*, const int, const UINT32);
+#if defined(VPINMAME) || defined(LIBPINMAME)
+  void (*dmdExportRaw)(core_tDMDPWMState*); // raw single bitplane frames for the colorization plugins, NULL if not provided
+#endif
+} genDispatch;
+
 /*-------------------------------
 /  Initialize the game palette
 /-------------------------------*/
+/*-- latency telemetry (core_latency*) --*/
+static struct {
+  int enabled;
+  struct {
+    volatile cycles_t start; /* 0: no measurement pending */
+    volatile int param;
+    volatile UINT32 count;   /* samples since enabled */
+    float window[CORE_LATENCY_WINDOW]; /* in seconds */
+  } stage[CORE_LATENCY_STAGES];
+} latency;
+
+/*-- speed governor (core_governor*) --*/
+#define CORE_GOVERNOR_WINDOW  1.0  /* emulated seconds per speed measurement */
+#define CORE_GOVERNOR_STALL   0.25 /* longer frames (pause, time fence, debugger) are not measured */
+#define CORE_GOVERNOR_SLOW    0.97 /* speed below which the next level is selected */
+#define CORE_GOVERNOR_FAST    0.995
+int g_speed_governor = CORE_GOVERNOR_OFF;
+static struct {
+  int      level;
+  int      holdWindows;  /* fast windows needed before stepping back, doubled when that did not hold */
+  int      fastWindows;
+  int      lastStepDown;
+  cycles_t lastWall;
+  double   lastEmu, windowEmu, windowWall;
+} governor;
+static void core_governorUpdate(void);
+
 static PALETTE_INIT(core) {
   const int palSize = sizeof(core_palette)/3;
   unsigned char tmpPalette[sizeof(core_palette)/3][3];
@@ -904,7 +1003,8 @@ static PALETTE_INIT(core) {
 /  Generic segment display handler
 /------------------------------------*/
 #ifdef VPINMAME
-void core_dmd_capture_frame(const int width, const int height, const UINT8* const dmdDotRaw, const int rawFrameCount, const UINT8* const rawFrame);
+void core_dmd_capture_frame(const int width, const int height, const UINT8* const dmdDotRaw, const int rawFrameCount, const UINT8* const rawFrame, const int isDMD2);
+void core_dmd_capture_close(void);
 
 // VPinMAME function to send DMD/Alphanumeric information to an external dmddevice/dmdscreen.dll plugin
 // Note that this part of the header is not used externally of VPinMAME (move it to something like core_dmdevice.h/core_dmddevice.c ?)
@@ -913,6 +1013,12 @@ extern void dmddeviceRenderDMDFrame(const int width, const int height, UINT8* dm
 extern void dmddeviceRenderAlphanumericFrame(core_segOverallLayout_t layout, UINT16* seg_data, UINT16* seg_data2, char* seg_dim);
 extern void dmddeviceFwdConsoleData(UINT8 data);
 extern void dmddeviceDeInit(void);
+
+// VPinMAME functions to publish outputs and main DMD frames to the shared memory view (Controller.MapSharedState)
+extern void vpm_update_shared_state(void);
+extern void vpm_publish_dmd_frame(const int display, const int width, const int height, const UINT8* const dmdDotLum, const UINT8* const dmdDotRaw, const int rawFrameCount, const UINT8* const rawFrames, const UINT64 hash);
+// VPinMAME function to apply a pending profiler export request (Controller.SetProfiler)
+extern void vpm_update_profiler(void);
 #endif /* VPINMAME */
 
 core_segOverallLayout_t layoutAlphanumericFrame(UINT64 gen, UINT8 total_disp, UINT8 *disp_num_segs, const char* GameName) {
@@ -1089,6 +1195,14 @@ static void updateDisplay(struct mame_bitmap *bitmap, const struct rectangle *cl
     int display_index = 0;
   #endif
 
+  // The bitmap is kept between frames, except when it is erased or the UI draws over it: only then all characters are drawn
+  // again. P-ROC draws the characters to its DMD from drawChar after clearing it each frame, so it always needs them all.
+  int redrawAllChars = ui_dirty || locals.drawnCharRefresh != get_full_refresh_count();
+  #ifdef PROC_SUPPORT
+    redrawAllChars |= coreGlobals.p_rocEn;
+  #endif
+  locals.drawnCharRefresh = get_full_refresh_count();
+
   int pos = 0;
   const struct core_dispLayout* layout = layout_array;
   const struct core_dispLayout* parent_layout = NULL;
@@ -1119,7 +1233,9 @@ static void updateDisplay(struct mame_bitmap *bitmap, const struct rectangle *cl
       }
       #ifdef LIBPINMAME
       else if ((layout->type & CORE_SEGALL) == CORE_DMD) {
-         libpinmame_update_display(display_index, layout, g_raw_dmdbuffer);
+         // Only hand over the frame if core_dmd_render_lpm stored a new one, so libpinmame can skip comparing it
+         libpinmame_update_display(display_index, layout, !g_needs_DMD_update ? NULL : g_fDmdMode == 2 /* PINMAME_DMD_MODE_COLOR */ ? (void*)g_raw_colordmdbuffer : (void*)g_raw_dmdbuffer);
+         g_needs_DMD_update = 0;
          display_index++;
       }
       #endif
@@ -1191,7 +1307,25 @@ static void updateDisplay(struct mame_bitmap *bitmap, const struct rectangle *cl
             seg_data[seg_idx++] = tmpSeg;
           #endif
           if (!pmoptions.dmd_only || !(layout->fptr || layout->lptr)) {
-            drawChar(bitmap, top, left, tmpSeg, tmpType, (coreGlobals.nAlphaSegs && (options.usemodsol & (CORE_MODOUT_FORCE_ON | CORE_MODOUT_ENABLE_PHYSOUT_ALPHASEGS))) ? tmpSegDim : NULL);
+            const int dimmed = coreGlobals.nAlphaSegs && (options.usemodsol & (CORE_MODOUT_FORCE_ON | CORE_MODOUT_ENABLE_PHYSOUT_ALPHASEGS));
+            if (pos < CORE_SEGCOUNT) {
+              // Draw only if anything that drawChar uses differs from the last time this character was drawn
+              UINT8 *const lastDim = locals.drawnChar[pos].dim;
+              if (redrawAllChars || !locals.drawnChar[pos].valid || locals.drawnChar[pos].segBits != tmpSeg || locals.drawnChar[pos].type != tmpType
+                || locals.drawnChar[pos].row != top || locals.drawnChar[pos].col != left || locals.drawnChar[pos].dimmed != dimmed
+                || (dimmed && memcmp(lastDim, tmpSegDim, sizeof(tmpSegDim)) != 0)) {
+                drawChar(bitmap, top, left, tmpSeg, tmpType, dimmed ? tmpSegDim : NULL);
+                locals.drawnChar[pos].row = top;
+                locals.drawnChar[pos].col = left;
+                locals.drawnChar[pos].segBits = tmpSeg;
+                locals.drawnChar[pos].type = (UINT8)tmpType;
+                locals.drawnChar[pos].dimmed = (UINT8)dimmed;
+                locals.drawnChar[pos].valid = 1;
+                memcpy(lastDim, tmpSegDim, sizeof(tmpSegDim));
+              }
+            }
+            else
+              drawChar(bitmap, top, left, tmpSeg, tmpType, dimmed ? tmpSegDim : NULL);
             #ifdef PROC_SUPPORT
               if (coreGlobals.p_rocEn) {
                 if ((core_gameData->gen & (GEN_WPCALPHA_1 | GEN_WPCALPHA_2 | GEN_ALLS11)) && (!pmoptions.alpha_on_dmd)) {
@@ -1233,8 +1367,12 @@ static void updateDisplay(struct mame_bitmap *bitmap, const struct rectangle *cl
     // Some GTS3 games like Teed Off update both empty alpha and real DMD. If a DMD frame has been seen, block this from running.
     if(!has_DMD_Video)
     {
-      // Identify alphaseg layout
-      const core_segOverallLayout_t alpha_layout = layoutAlphanumericFrame(core_gameData->gen, n_seg_layouts, disp_num_segs, Machine->gamedrv->name);
+      // Identify alphaseg layout (it only depends on the game, so once per run)
+      if (!locals.alphaLayoutValid) {
+        locals.alphaLayout = layoutAlphanumericFrame(core_gameData->gen, n_seg_layouts, disp_num_segs, Machine->gamedrv->name);
+        locals.alphaLayoutValid = 1;
+      }
+      const core_segOverallLayout_t alpha_layout = locals.alphaLayout;
       assert(alpha_layout != CORE_SEGLAYOUT_Invalid);
 
       // Port of legacy hack that would call updateDisplay twice, once with the default display (4x7 and 2x2) then once for the additional display (3x2)
@@ -1243,46 +1381,62 @@ static void updateDisplay(struct mame_bitmap *bitmap, const struct rectangle *cl
       if ((core_gameData->gen == GEN_BY35) && (disp_num_segs[0] == 7) && (strncasecmp(Machine->gamedrv->name, "medusa", 6) == 0))
          memcpy(seg_data2, seg_data + 4 * 7 + 2 * 2, 3 * 2 * sizeof(UINT16));
 
+      // Only send and render segments when a digit or its dimming changed, or on full refresh (screen erased or UI shown)
+      const int alphaChanged = !locals.alphaSentValid || ui_dirty || locals.alphaSentRefresh != get_full_refresh_count()
+        || memcmp(locals.alphaSentSeg, seg_data, sizeof(seg_data)) != 0 || memcmp(locals.alphaSentSeg2, seg_data2, sizeof(seg_data2)) != 0
+        || memcmp(locals.alphaSentDim, seg_dim, sizeof(seg_dim)) != 0;
+      if (alphaChanged) {
+        memcpy(locals.alphaSentSeg, seg_data, sizeof(seg_data));
+        memcpy(locals.alphaSentSeg2, seg_data2, sizeof(seg_data2));
+        memcpy(locals.alphaSentDim, seg_dim, sizeof(seg_dim));
+        locals.alphaSentRefresh = get_full_refresh_count();
+        locals.alphaSentValid = 1;
+      }
+
       // Sends segment data to dmddevice plugin
       #ifdef VPINMAME
-        if(g_fShowPinDMD)
+        if(g_fShowPinDMD && alphaChanged)
            dmddeviceRenderAlphanumericFrame(alpha_layout, seg_data, seg_data2, seg_dim);
       #endif
 
       // Render segments into a virtual DMD (at the moment only to pass easily to VP, e.g. tournament mode verification)
-      memset(AlphaNumericFrameBuffer,0,sizeof(AlphaNumericFrameBuffer));
-      switch (alpha_layout) {
-        case CORE_SEGLAYOUT_2x16Alpha: _2x16Alpha(seg_data); break;
-        case CORE_SEGLAYOUT_2x20Alpha: _2x20Alpha(seg_data); break;
-        case CORE_SEGLAYOUT_2x7Alpha_2x7Num: _2x7Alpha_2x7Num(seg_data); break;
-        case CORE_SEGLAYOUT_2x7Alpha_2x7Num_4x1Num: _2x7Alpha_2x7Num_4x1Num(seg_data); break;
-        case CORE_SEGLAYOUT_2x7Num_2x7Num_4x1Num: _2x7Num_2x7Num_4x1Num(seg_data); break;
-        case CORE_SEGLAYOUT_2x7Num_2x7Num_10x1Num: _2x7Num_2x7Num_10x1Num(seg_data,seg_data2); break;
-        case CORE_SEGLAYOUT_2x7Num_2x7Num_4x1Num_gen7: _2x7Num_2x7Num_4x1Num_gen7(seg_data); break;
-        case CORE_SEGLAYOUT_2x7Num10_2x7Num10_4x1Num: _2x7Num10_2x7Num10_4x1Num(seg_data); break;
-        case CORE_SEGLAYOUT_2x6Num_2x6Num_4x1Num: _2x6Num_2x6Num_4x1Num(seg_data); break;
-        case CORE_SEGLAYOUT_2x6Num10_2x6Num10_4x1Num: _2x6Num10_2x6Num10_4x1Num(seg_data); break;
-        case CORE_SEGLAYOUT_4x7Num10: _4x7Num10(seg_data); break;
-        case CORE_SEGLAYOUT_6x4Num_4x1Num: _6x4Num_4x1Num(seg_data); break;
-        case CORE_SEGLAYOUT_2x7Num_4x1Num_1x16Alpha: _2x7Num_4x1Num_1x16Alpha(seg_data); break;
-        case CORE_SEGLAYOUT_1x16Alpha_1x16Num_1x7Num: _1x16Alpha_1x16Num_1x7Num(seg_data); break;
-        case CORE_SEGLAYOUT_1x7Num_1x16Alpha_1x16Num: _1x7Num_1x16Alpha_1x16Num(seg_data); break;
-        case CORE_SEGLAYOUT_1x16Alpha_1x16Num_1x7Num_1x4Num : _1x16Alpha_1x16Num_1x7Num_1x4Num(seg_data); break;
-        default: break;
-      }
-      #ifdef VPINMAME
-        g_raw_dmdx = 128;
-        g_raw_dmdy = 32;
-        for (unsigned int i = 0; i < g_raw_dmdx * g_raw_dmdy; ++i)
-          g_raw_dmdbuffer[i] = (UINT8)((int)AlphaNumericFrameBuffer[i] * 100 / 3);
-        if (memcmp(old_g_raw_dmdbuffer, g_raw_dmdbuffer, g_raw_dmdx * g_raw_dmdy) != 0) {
-          memcpy(old_g_raw_dmdbuffer, g_raw_dmdbuffer, g_raw_dmdx * g_raw_dmdy);
-          core_dmd_capture_frame(g_raw_dmdx, g_raw_dmdy, AlphaNumericFrameBuffer, 0, NULL);
-          g_needs_DMD_update = 1;
+      if (alphaChanged) {
+        memset(AlphaNumericFrameBuffer,0,sizeof(AlphaNumericFrameBuffer));
+        switch (alpha_layout) {
+          case CORE_SEGLAYOUT_2x16Alpha: _2x16Alpha(seg_data); break;
+          case CORE_SEGLAYOUT_2x20Alpha: _2x20Alpha(seg_data); break;
+          case CORE_SEGLAYOUT_2x7Alpha_2x7Num: _2x7Alpha_2x7Num(seg_data); break;
+          case CORE_SEGLAYOUT_2x7Alpha_2x7Num_4x1Num: _2x7Alpha_2x7Num_4x1Num(seg_data); break;
+          case CORE_SEGLAYOUT_2x7Num_2x7Num_4x1Num: _2x7Num_2x7Num_4x1Num(seg_data); break;
+          case CORE_SEGLAYOUT_2x7Num_2x7Num_10x1Num: _2x7Num_2x7Num_10x1Num(seg_data,seg_data2); break;
+          case CORE_SEGLAYOUT_2x7Num_2x7Num_4x1Num_gen7: _2x7Num_2x7Num_4x1Num_gen7(seg_data); break;
+          case CORE_SEGLAYOUT_2x7Num10_2x7Num10_4x1Num: _2x7Num10_2x7Num10_4x1Num(seg_data); break;
+          case CORE_SEGLAYOUT_2x6Num_2x6Num_4x1Num: _2x6Num_2x6Num_4x1Num(seg_data); break;
+          case CORE_SEGLAYOUT_2x6Num10_2x6Num10_4x1Num: _2x6Num10_2x6Num10_4x1Num(seg_data); break;
+          case CORE_SEGLAYOUT_4x7Num10: _4x7Num10(seg_data); break;
+          case CORE_SEGLAYOUT_6x4Num_4x1Num: _6x4Num_4x1Num(seg_data); break;
+          case CORE_SEGLAYOUT_2x7Num_4x1Num_1x16Alpha: _2x7Num_4x1Num_1x16Alpha(seg_data); break;
+          case CORE_SEGLAYOUT_1x16Alpha_1x16Num_1x7Num: _1x16Alpha_1x16Num_1x7Num(seg_data); break;
+          case CORE_SEGLAYOUT_1x7Num_1x16Alpha_1x16Num: _1x7Num_1x16Alpha_1x16Num(seg_data); break;
+          case CORE_SEGLAYOUT_1x16Alpha_1x16Num_1x7Num_1x4Num : _1x16Alpha_1x16Num_1x7Num_1x4Num(seg_data); break;
+          default: break;
         }
-      #elif defined(LIBPINMAME)
+        #ifdef VPINMAME
+          g_raw_dmdx = 128;
+          g_raw_dmdy = 32;
+          for (unsigned int i = 0; i < g_raw_dmdx * g_raw_dmdy; ++i)
+            g_raw_dmdbuffer[i] = (UINT8)((int)AlphaNumericFrameBuffer[i] * 100 / 3);
+          if (memcmp(old_g_raw_dmdbuffer, g_raw_dmdbuffer, g_raw_dmdx * g_raw_dmdy) != 0) {
+            memcpy(old_g_raw_dmdbuffer, g_raw_dmdbuffer, g_raw_dmdx * g_raw_dmdy);
+            core_dmd_capture_frame(g_raw_dmdx, g_raw_dmdy, AlphaNumericFrameBuffer, 0, NULL, 0);
+            g_needs_DMD_update = 1;
+          }
+        #endif
+      }
+      #if defined(LIBPINMAME)
+        // Unchanged frames are not handed over, so that libpinmame can skip comparing them
         static struct core_dispLayout segDmdDispLayout = { 0, 0, 32, 128, CORE_DMD | CORE_DMDSEG, NULL, NULL };
-        libpinmame_update_display(display_index, &segDmdDispLayout, AlphaNumericFrameBuffer);
+        libpinmame_update_display(display_index, &segDmdDispLayout, alphaChanged ? AlphaNumericFrameBuffer : NULL);
         display_index++;
       #endif
     }
@@ -1327,6 +1481,14 @@ VIDEO_UPDATE(core_gen) {
 
   // Update lamp, solenoids, status LEDs, misc. infos...
   video_update_core_status(bitmap, cliprect);
+
+  core_governorUpdate();
+
+  // Publish outputs to the shared memory view (Controller.MapSharedState), if mapped
+  #ifdef VPINMAME
+    vpm_update_shared_state();
+    vpm_update_profiler();
+  #endif
 }
 
 /*---------------------
@@ -1335,7 +1497,7 @@ VIDEO_UPDATE(core_gen) {
 void core_updateSw(int flipEn) {
   /*-- handle flippers--*/
   const int flip = core_gameData->hw.flippers;
-  const int flipSwCol = (core_gameData->gen & (GEN_GTS3 | GEN_SPA | GEN_ALVG | GEN_ALVG_DMD2 | GEN_WICO)) ? 15 : CORE_FLIPPERSWCOL;
+  const int flipSwCol = genDispatch.flipSwCol;
   int inports[CORE_MAXPORTS];
   UINT8 swFlip;
   int ii;
@@ -1426,8 +1588,7 @@ void core_updateSw(int flipEn) {
             (SIM_BALLS(inports[CORE_SIMINPORT])));
 
   /*-- Report changed solenoids --*/
-  if (coreGlobals.nSolenoids && 
-     ((options.usemodsol & (CORE_MODOUT_ENABLE_PHYSOUT_SOLENOIDS | CORE_MODOUT_FORCE_ON)) || ((core_gameData->gen & (GEN_ALLWPC | GEN_SAM)) && (options.usemodsol & CORE_MODOUT_ENABLE_MODSOL)) ))
+  if (genDispatch.reportPhysicSols)
   {
     float state[CORE_MODOUT_SOL_MAX];
     core_getAllPhysicSols(state);
@@ -1436,9 +1597,13 @@ void core_updateSw(int flipEn) {
       if (v != locals.lastPhysicsOutput[CORE_MODOUT_SOL0 + ii - 1]) {
         #ifdef LIBPINMAME
         OnSolenoid(ii, v);
+        core_latencyStop(CORE_LATENCY_SWITCH_SOL, -1);
         #else
         if ((v > 128) != (locals.lastPhysicsOutput[CORE_MODOUT_SOL0 + ii - 1] > 128)) {
           OnSolenoid(ii, v);
+          #ifndef VPINMAME /* VPinMAME hosts poll Controller.ChangedSolenoids, measured there */
+          core_latencyStop(CORE_LATENCY_SWITCH_SOL, -1);
+          #endif
           /*-- log solenoid number on the display (except flippers) --*/
           if ((!pmoptions.dmd_only && ((ii < CORE_FIRSTLFLIPSOL) || (ii >= CORE_FIRSTSIMSOL)))) {
             locals.solLog[locals.solLogCount] = ii;
@@ -1467,6 +1632,9 @@ void core_updateSw(int flipEn) {
     {
       if (chgSol & 0x01) {
         OnSolenoid(ii, allSol & 0x01);
+        #ifndef VPINMAME
+        core_latencyStop(CORE_LATENCY_SWITCH_SOL, -1);
+        #endif
         /*-- log solenoid number on the display (except flippers) --*/
         if ((!pmoptions.dmd_only && (allSol & 0x01)) && ((ii < CORE_FIRSTLFLIPSOL) || (ii >= CORE_FIRSTSIMSOL))) {
           locals.solLog[locals.solLogCount] = ii;
@@ -1487,6 +1655,12 @@ void core_updateSw(int flipEn) {
     }
   }
 
+  /*-- journal the changed outputs for the host consumers (see vp_readJournal) --*/
+  vp_updateJournal();
+#ifdef LIBPINMAME
+  libpinmame_output_push();
+#endif
+
   /*-- check if we should use simulator keys --*/
   if (g_fHandleKeyboard &&
       (!coreGlobals.simAvail || inports[CORE_SIMINPORT] & SIM_SWITCHKEY)) {
@@ -1751,20 +1925,186 @@ int core_m2swSeq(int col, int row) { return col*8+row-7; }
 /-------------------------------------------*/
 int core_getSw(int swNo) {
   if (coreData->sw2m) swNo = coreData->sw2m(swNo); else swNo = (swNo/10)*8+(swNo%10-1);
+  if (latency.stage[CORE_LATENCY_SWITCH_READ].start) core_latencyStop(CORE_LATENCY_SWITCH_READ, swNo/8);
   return (coreGlobals.swMatrix[swNo/8] ^ coreGlobals.invSw[swNo/8]) & (1<<(swNo%8));
 }
 
 int core_getSwCol(int colEn) {
-  int ii = 1;
-  if (colEn) {
-    while ((colEn & 0x01) == 0) {
-      colEn >>= 1;
-      ii++;
+  /* the first strobed column wins, swMatrix already holds the inverted switches */
+  const int ii = colEn ? (int)__ctz((unsigned int)colEn) + 1 : 1;
+  if (latency.stage[CORE_LATENCY_SWITCH_READ].start) core_latencyStop(CORE_LATENCY_SWITCH_READ, ii);
+  return coreGlobals.swMatrix[ii];
+}
+
+/*------------------------------------------
+/  Latency telemetry
+/
+/  A measurement starts on a host input (if
+/  none is pending for that stage) and ends
+/  on the first matching output. Starts and
+/  stops may come from the host thread, so a
+/  sample can be lost, but never blocks.
+/-------------------------------------------*/
+void core_latencyEnable(int enable) {
+  int ii;
+  if (enable && !latency.enabled)
+    for (ii = 0; ii < CORE_LATENCY_STAGES; ii++) {
+      latency.stage[ii].start = 0;
+      latency.stage[ii].count = 0;
+    }
+  latency.enabled = enable;
+}
+
+/*-- a switch was set by the host --*/
+void core_latencySwitch(int swNo) {
+  if (!latency.enabled || !coreData) return;
+  if (coreData->sw2m) swNo = coreData->sw2m(swNo); else swNo = (swNo/10)*8+(swNo%10-1);
+  core_latencyStart(CORE_LATENCY_SWITCH_READ, swNo/8);
+  core_latencyStart(CORE_LATENCY_SWITCH_SOL, -1);
+}
+
+/*-- param: switch column for CORE_LATENCY_SWITCH_READ, -1 otherwise --*/
+void core_latencyStart(int stage, int param) {
+  cycles_t now;
+  if (!latency.enabled || latency.stage[stage].start) return;
+  now = osd_cycles();
+  latency.stage[stage].param = param;
+  latency.stage[stage].start = now ? now : 1;
+}
+
+void core_latencyStop(int stage, int param) {
+  const cycles_t start = latency.stage[stage].start;
+  if (!start || (param >= 0 && latency.stage[stage].param >= 0 && param != latency.stage[stage].param)) return;
+  latency.stage[stage].start = 0;
+  latency.stage[stage].window[latency.stage[stage].count++ % CORE_LATENCY_WINDOW] =
+    (float)((double)(osd_cycles() - start) / (double)osd_cycles_per_second());
+}
+
+static int core_latencyCmp(const void *a, const void *b) {
+  const float fa = *(const float *)a, fb = *(const float *)b;
+  return (fa > fb) - (fa < fb);
+}
+
+/*-- returns the number of samples since enabled, percentiles in seconds over the window --*/
+UINT32 core_latencyGet(int stage, double *p50, double *p95, double *p99, double *max) {
+  float sorted[CORE_LATENCY_WINDOW];
+  const UINT32 count = latency.stage[stage].count;
+  const int n = count < CORE_LATENCY_WINDOW ? (int)count : CORE_LATENCY_WINDOW;
+
+  *p50 = *p95 = *p99 = *max = 0.0;
+  if (n == 0) return count;
+  memcpy(sorted, latency.stage[stage].window, n * sizeof(float));
+  qsort(sorted, n, sizeof(float), core_latencyCmp);
+  *p50 = sorted[(n - 1) * 50 / 100];
+  *p95 = sorted[(n - 1) * 95 / 100];
+  *p99 = sorted[(n - 1) * 99 / 100];
+  *max = sorted[n - 1];
+  return count;
+}
+
+/*-----------------------------------------------------------------
+/  Speed governor: measures the emulated speed over windows of one
+/  emulated second and raises the level when it falls behind real
+/  time. Throttled emulation never runs faster than real time, so
+/  the level is lowered again after a few windows at full speed,
+/  and that delay doubles each time it turns out too short.
+/------------------------------------------------------------------*/
+int core_governorLevel(void) { return governor.level; }
+
+static void core_governorApply(int level) {
+  static const char * const names[] = { "off", "coarser interleave boosts", "shorter DMD PWM filter", "linear audio resampling", "DMD rendered every other frame" };
+  if (level == governor.level) return;
+  logerror("Speed governor: level %d (%s)\n", level, names[level]);
+  cpu_set_interleave_boost_scale(level >= CORE_GOVERNOR_INTERLEAVE ? 4 : 1);
+  if ((level >= CORE_GOVERNOR_RESAMPLE) != (governor.level >= CORE_GOVERNOR_RESAMPLE) && pmoptions.resampling_quality < MIXER_RESAMPLE_LINEAR)
+    mixer_set_resample_quality(level >= CORE_GOVERNOR_RESAMPLE ? MIXER_RESAMPLE_LINEAR : MIXER_RESAMPLE_DEFAULT);
+  governor.lastStepDown = level < governor.level;
+  governor.level = level;
+}
+
+static void core_governorUpdate(void) {
+  const int maxLevel = g_speed_governor < 0 ? 0 : g_speed_governor > CORE_GOVERNOR_MAXLEVEL ? CORE_GOVERNOR_MAXLEVEL : g_speed_governor;
+  const cycles_t now = osd_cycles();
+  const double emu = timer_get_time();
+  double speed;
+
+  if (governor.level > maxLevel)
+    core_governorApply(maxLevel);
+  if (maxLevel == 0) {
+    governor.lastWall = 0;
+    return;
+  }
+  if (governor.lastWall) {
+    const double wall = (double)(now - governor.lastWall) / (double)osd_cycles_per_second();
+    if (wall < CORE_GOVERNOR_STALL) {
+      governor.windowWall += wall;
+      governor.windowEmu += emu - governor.lastEmu;
     }
   }
-  return coreGlobals.swMatrix[ii];
+  governor.lastWall = now;
+  governor.lastEmu = emu;
+  if (governor.windowEmu < CORE_GOVERNOR_WINDOW || governor.windowWall <= 0.)
+    return;
+
+  speed = governor.windowEmu / governor.windowWall;
+  governor.windowEmu = governor.windowWall = 0.;
+  if (speed < CORE_GOVERNOR_SLOW) {
+    governor.fastWindows = 0;
+    if (governor.level < maxLevel) {
+      if (governor.lastStepDown && governor.holdWindows < 64)
+        governor.holdWindows *= 2;
+      core_governorApply(governor.level + 1);
+    }
+  }
+  else if (speed >= CORE_GOVERNOR_FAST) {
+    if (governor.level > 0 && ++governor.fastWindows >= governor.holdWindows) {
+      governor.fastWindows = 0;
+      core_governorApply(governor.level - 1);
+    }
+  }
+  else
+    governor.fastWindows = 0;
+}
+
+static void core_governorReset(void) {
+  cpu_set_interleave_boost_scale(1);
+  memset(&governor, 0, sizeof(governor));
+  governor.holdWindows = 5;
+}
+
+#ifdef PROC_SUPPORT
+static void core_procSync(int param) {
+  procSync();
+}
+#endif
+
+#ifdef LIBPINMAME
+/*------------------------------------------
+/  Timestamped switch events from the host
+/-------------------------------------------*/
+static void core_swEventApply(int param) {
+  core_setSw(param >> 1, param & 1);
+  core_latencySwitch(param >> 1);
 }
 
+/*-- events due now are applied right away, later ones at their exact emulated time --*/
+static void core_swEventPoll(int param) {
+  const double now = timer_get_time();
+  int swNo, state;
+  double time;
+  if (libpinmame_replay_poll()) /* recording or replaying inputs: all of them are applied on these ticks */
+    return;
+  while (libpinmame_get_switch_event(&swNo, &state, &time)) {
+    if (time > now)
+      timer_set(time - now, (swNo << 1) | (state ? 1 : 0), core_swEventApply);
+    else {
+      core_setSw(swNo, state);
+      core_latencySwitch(swNo);
+    }
+  }
+}
+#endif
+
 /*----------------------
 /  Set/reset a switch
 /-----------------------*/
@@ -1806,47 +2146,16 @@ void core_updInvSw(int swNo, int inv) {
 /  the "smoothed" value
 /--------------------------------------*/
 int core_getSol(int solNo) {
-  if (solNo <= 28)
-    return coreGlobals.nSolenoids && (options.usemodsol & (CORE_MODOUT_ENABLE_PHYSOUT_SOLENOIDS | CORE_MODOUT_ENABLE_MODSOL | CORE_MODOUT_FORCE_ON)) ? saturatedByte(coreGlobals.physicOutputState[CORE_MODOUT_SOL0 + solNo - 1].value) : coreGlobals.solenoids & CORE_SOLBIT(solNo);
-  else if (solNo <= 32) { // 29-32
-    if (core_gameData->gen & GEN_ALLS11)
-      return coreGlobals.nSolenoids && (options.usemodsol & (CORE_MODOUT_ENABLE_PHYSOUT_SOLENOIDS | CORE_MODOUT_ENABLE_MODSOL | CORE_MODOUT_FORCE_ON)) ? saturatedByte(coreGlobals.physicOutputState[CORE_MODOUT_SOL0 + solNo - 1].value) : coreGlobals.solenoids & CORE_SOLBIT(solNo);
-    else if (core_gameData->gen & GEN_ALLWPC) // WPC GameOn
-      return coreGlobals.solenoids2 & (1<<(solNo-29+8));
-  }
-  else if (solNo <= 36) { // 33-36 driver specific sols
-    if (core_gameData->gen & GEN_ALLWPC) { // WPC only: Upper flipper 
-      if ((core_gameData->gen & (GEN_WPCFLIPTRON | GEN_WPCDCS | GEN_WPCSECURITY | GEN_WPC95 | GEN_WPC95DCS)) && (coreGlobals.nSolenoids && (options.usemodsol & (CORE_MODOUT_ENABLE_PHYSOUT_SOLENOIDS | CORE_MODOUT_ENABLE_MODSOL | CORE_MODOUT_FORCE_ON))))
-        return saturatedByte(coreGlobals.physicOutputState[CORE_MODOUT_SOL0 + solNo - 1].value);
-      int mask;
-      /*-- flipper coils --*/
-      if      ((solNo == sURFlip) && (core_gameData->hw.flippers & FLIP_SOL(FLIP_UR)))
-        mask = CORE_URFLIPSOLBITS;
-      else if ((solNo == sULFlip) && (core_gameData->hw.flippers & FLIP_SOL(FLIP_UL)))
-        mask = CORE_ULFLIPSOLBITS;
-      else
-        mask = 1<<(solNo - 33 + 4);
-      return coreGlobals.solenoids2 & mask;
-    }
-    else if (core_gameData->gen & GEN_SAM) // SAM only: fake GameOn solenoid for fast flips
-       return coreGlobals.solenoids2 & 0x10;
-  }
-  else if (solNo <= 44) { // 37-44 WPC95 & S11 extra
-    if (core_gameData->gen & (GEN_WPC95|GEN_WPC95DCS)) // Duplicated in 37..40 / 41..44, so always read from 41..44 (hence the |4 in the index/mask)
-      return coreGlobals.nSolenoids && (options.usemodsol & (CORE_MODOUT_ENABLE_PHYSOUT_SOLENOIDS | CORE_MODOUT_ENABLE_MODSOL | CORE_MODOUT_FORCE_ON)) ? saturatedByte(coreGlobals.physicOutputState[CORE_MODOUT_SOL0 + ((solNo - 13) | 4)].value) : coreGlobals.solenoids & (1<<((solNo - 13)|4));
-    if (core_gameData->gen & GEN_ALLS11)
-      return coreGlobals.nSolenoids && (options.usemodsol & (CORE_MODOUT_ENABLE_PHYSOUT_SOLENOIDS | CORE_MODOUT_ENABLE_MODSOL | CORE_MODOUT_FORCE_ON)) ? saturatedByte(coreGlobals.physicOutputState[CORE_MODOUT_SOL0 + 32 + solNo - 37 + 8].value) : coreGlobals.solenoids2 & (1<<(solNo - 37 + 8));
-  }
-  else if (solNo <= 48) { // 45-48 Lower flippers
-    if ((core_gameData->gen & (GEN_WPCFLIPTRON | GEN_WPCDCS | GEN_WPCSECURITY | GEN_WPC95 | GEN_WPC95DCS)) && (coreGlobals.nSolenoids && (options.usemodsol & (CORE_MODOUT_ENABLE_PHYSOUT_SOLENOIDS | CORE_MODOUT_ENABLE_MODSOL | CORE_MODOUT_FORCE_ON))))
-      return saturatedByte(coreGlobals.physicOutputState[CORE_MODOUT_SOL0 + solNo - 1].value);
-    int mask = 1<<(solNo - 45);
-    /*-- Game must have lower flippers but for symmetry we check anyway --*/
-    if      ((solNo == sLRFlip) /*&& (core_gameData->hw.flippers & FLIP_SOL(FLIP_LR))*/)
-      mask = CORE_LRFLIPSOLBITS;
-    else if ((solNo == sLLFlip) /*&& (core_gameData->hw.flippers & FLIP_SOL(FLIP_LL))*/)
-      mask = CORE_LLFLIPSOLBITS;
-    return coreGlobals.solenoids2 & mask;
+  if (solNo <= 48) { // 1-48 hardware solenoids, sources resolved by core_init_gen_dispatch
+    const int ii = solNo - 1;
+    if (ii < 0)
+      return 0;
+    switch (genDispatch.sol[ii].type) {
+    case CORE_SOLSRC_SOL:  return coreGlobals.solenoids & genDispatch.sol[ii].mask;
+    case CORE_SOLSRC_SOL2: return coreGlobals.solenoids2 & genDispatch.sol[ii].mask;
+    case CORE_SOLSRC_PHYS: return saturatedByte(coreGlobals.physicOutputState[CORE_MODOUT_SOL0 + genDispatch.sol[ii].index].value);
+    default:               return 0;
+    }
   }
   else if (solNo <= 50) // 49-50 simulated
     return sim_getSol(solNo);
@@ -1861,7 +2170,7 @@ int core_getSol(int solNo) {
 int core_getPulsedSol(int solNo) {
   if (solNo <= 32)
     return coreGlobals.pulsedSolState & CORE_SOLBIT(solNo);
-  else if ((core_gameData->gen & (GEN_WPC95|GEN_WPC95DCS)) && (solNo >= 37) && (solNo <= 44))
+  else if (genDispatch.wpc95 && (solNo >= 37) && (solNo <= 44))
     // This is a little messy. Pulsed state is in 29-32 but 29-32 non pulsed is GameOn sol
     return coreGlobals.pulsedSolState & (1<<((solNo-13)|4));
   return core_getSol(solNo); /* sol is not smoothed anyway */
@@ -1872,13 +2181,13 @@ int core_getPulsedSol(int solNo) {
 /--------------------------------------------------*/
 UINT64 core_getAllSol(void) {
   UINT64 sol = coreGlobals.solenoids;
-  if (core_gameData->gen & GEN_ALLWPC) // 29-32 GameOn
+  if (genDispatch.wpc) // 29-32 GameOn
     sol = (sol & 0x0fffffffull) | ((coreGlobals.solenoids2 & 0x0f00ull)<<20);
-  if (core_gameData->gen & (GEN_WPC95|GEN_WPC95DCS)) { // 37-44 WPC95 extra, duplicated at 0x......XX........
+  if (genDispatch.wpc95) { // 37-44 WPC95 extra, duplicated at 0x......XX........
     UINT64 tmp = coreGlobals.solenoids & 0xf0000000;
     sol |= (tmp<<12)|(tmp<<8);
   }
-  if (core_gameData->gen & GEN_ALLWPC) { // 33-36 WPC upper flipper solenoids (hold coil is set if either coil is set)
+  if (genDispatch.sol33 == CORE_SOL33_WPC) { // 33-36 WPC upper flipper solenoids (hold coil is set if either coil is set)
     UINT8 uFlip = (coreGlobals.solenoids2 & (CORE_URFLIPSOLBITS|CORE_ULFLIPSOLBITS));
     if (core_gameData->hw.flippers & FLIP_SOL(FLIP_UR))
       uFlip |= (uFlip & 0x10)<<1;
@@ -1886,11 +2195,11 @@ UINT64 core_getAllSol(void) {
       uFlip |= (uFlip & 0x40)<<1;
     sol |= (((UINT64)uFlip)<<28);
   }
-  else if (core_gameData->gen & GEN_SAM) // 33 SAM fake GameOn sol for fast flips
+  else if (genDispatch.sol33 == CORE_SOL33_SAM) // 33 SAM fake GameOn sol for fast flips
      sol |= (((UINT64)(coreGlobals.solenoids2 & 0x10)) << 28);
-  else if (core_gameData->gen & GEN_ALLWS) // 33..36 various aux board outputs
+  else if (genDispatch.sol33 == CORE_SOL33_WS) // 33..36 various aux board outputs
      sol |= ((UINT64)(coreGlobals.solenoids2 & 0x00f0)) << 28;
-  if (core_gameData->gen & (GEN_ALLS11 | GEN_SAM | GEN_SPA)) // 37-44 S11, SAM extra
+  if (genDispatch.sol37) // 37-44 S11, SAM extra
      sol |= ((UINT64)(coreGlobals.solenoids2 & 0xff00)) << 28;
   { // 45-48 flipper solenoids (hold coil is set if either coil is set)
     UINT8 lFlip = (coreGlobals.solenoids2 & (CORE_LRFLIPSOLBITS|CORE_LLFLIPSOLBITS));
@@ -1918,7 +2227,7 @@ void core_getAllPhysicSols(float* const state)
 {
   assert(coreGlobals.nSolenoids && (options.usemodsol & (CORE_MODOUT_ENABLE_PHYSOUT_SOLENOIDS | CORE_MODOUT_ENABLE_MODSOL | CORE_MODOUT_FORCE_ON)));
   memset(state, 0, CORE_MODOUT_SOL_MAX * sizeof(float)); // To avoid reporting garbage states for unused solenoid slots
-  if (core_gameData->gen & GEN_ALLWPC) {
+  if (genDispatch.wpc) {
      /*-- 1..28, hardware solenoids --*/
      for (int i = 0; i < 28; i++)
       state[i] = coreGlobals.physicOutputState[CORE_MODOUT_SOL0 + i].value;
@@ -1931,8 +2240,8 @@ void core_getAllPhysicSols(float* const state)
      for (int i = 0; i < 32; i++)
       state[i] = coreGlobals.physicOutputState[CORE_MODOUT_SOL0 + i].value;
   /*-- 33..36 [WPC only] upper flipper solenoids --*/
-  if (core_gameData->gen & GEN_ALLWPC) {
-    if ((core_gameData->gen & (GEN_WPCFLIPTRON | GEN_WPCDCS | GEN_WPCSECURITY | GEN_WPC95 | GEN_WPC95DCS)) && (coreGlobals.nSolenoids && (options.usemodsol & (CORE_MODOUT_ENABLE_PHYSOUT_SOLENOIDS | CORE_MODOUT_ENABLE_MODSOL | CORE_MODOUT_FORCE_ON))))
+  if (genDispatch.sol33 == CORE_SOL33_WPC) {
+    if (genDispatch.modFlippers)
       for (int i = 32; i < 36; i++)
         state[i] = coreGlobals.physicOutputState[CORE_MODOUT_SOL0 + i].value;
     else {
@@ -1948,24 +2257,24 @@ void core_getAllPhysicSols(float* const state)
     }
   }
   /*-- 33 [SAM only] fake GameOn solenoid for fast flips --*/
-  else if (core_gameData->gen & GEN_SAM)
+  else if (genDispatch.sol33 == CORE_SOL33_SAM)
     state[32] = coreGlobals.physicOutputState[CORE_MODOUT_SOL0 + 33 - 1].value;
   /*-- 33..36 Whitestar various aux board outputs --*/
-  else if (core_gameData->gen & GEN_ALLWS)
+  else if (genDispatch.sol33 == CORE_SOL33_WS)
      for (int i = 32; i < 36; i++)
         state[i] = coreGlobals.physicOutputState[CORE_MODOUT_SOL0 + i].value;
   /*-- 37..44, extra solenoids --*/
-  if (core_gameData->gen & (GEN_WPC95 | GEN_WPC95DCS)) { // 37-44 WPC95 extra (duplicated 37..40 / 41..44)
+  if (genDispatch.wpc95) { // 37-44 WPC95 extra (duplicated 37..40 / 41..44)
     for (int i = 28; i < 32; i++) {
       state[i +  8] = coreGlobals.physicOutputState[CORE_MODOUT_SOL0 + i].value;
       state[i + 12] = coreGlobals.physicOutputState[CORE_MODOUT_SOL0 + i].value;
     }
   }
-  else if (core_gameData->gen & (GEN_ALLS11 | GEN_SAM | GEN_SPA)) // 37-44 S11, SAM extra
+  else if (genDispatch.sol37) // 37-44 S11, SAM extra
     for (int i = 40; i < 48; i++)
       state[i - 4] = coreGlobals.physicOutputState[CORE_MODOUT_SOL0 + i].value;
   /*-- 45..48 lower flipper solenoids (only modulated for WPC) --*/
-  if ((core_gameData->gen & (GEN_WPCFLIPTRON | GEN_WPCDCS | GEN_WPCSECURITY | GEN_WPC95 | GEN_WPC95DCS)) && (coreGlobals.nSolenoids && (options.usemodsol & (CORE_MODOUT_ENABLE_PHYSOUT_SOLENOIDS | CORE_MODOUT_ENABLE_MODSOL | CORE_MODOUT_FORCE_ON))))
+  if (genDispatch.modFlippers)
     for (int i = 44; i < 48; i++)
       state[i] = coreGlobals.physicOutputState[CORE_MODOUT_SOL0 + i].value;
   else {
@@ -2077,6 +2386,7 @@ static MACHINE_INIT(core) {
     /*-- init variables --*/
     memset(&coreGlobals, 0, sizeof(coreGlobals));
     memset(&locals, 0, sizeof(locals));
+    core_governorReset();
     coreData = (struct pinMachine *)&Machine->drv->pinmame;
     coreGlobals.flipperCoils = 0xFFFFFFFFFFFFFFFFull;
     //-- initialise timers --
@@ -2093,6 +2403,10 @@ static MACHINE_INIT(core) {
         }
       }
     }
+#ifdef LIBPINMAME
+    locals.swEventTimer = timer_alloc(core_swEventPoll);
+    timer_adjust(locals.swEventTimer, TIME_IN_MSEC(1), 0, TIME_IN_MSEC(1));
+#endif
     /*-- init switch matrix --*/
     memcpy(coreGlobals.invSw, core_gameData->wpc.invSw, sizeof(core_gameData->wpc.invSw));
     memcpy(coreGlobals.swMatrix, coreGlobals.invSw, sizeof(coreGlobals.invSw));
@@ -2118,6 +2432,10 @@ static MACHINE_INIT(core) {
 
         // We don't want the PC to make the noises of pop bumpers etc
         g_fHandleMechanics= 0;
+
+        // Pull switch events and flush driver changes every emulated ms
+        locals.procSyncTimer = timer_alloc(core_procSync);
+        timer_adjust(locals.procSyncTimer, TIME_IN_MSEC(1), 0, TIME_IN_MSEC(1));
       }
     }
 #endif
@@ -2179,8 +2497,12 @@ static MACHINE_INIT(core) {
 #endif
     //options.usemodsol |= CORE_MODOUT_ENABLE_PHYSOUT_ALL; // For debugging, enable/test all physical/PWM outputs
 
+    /*-- drive the outputs without physical model directly, without recording their flips --*/
+    core_init_pwm_output_models();
+
     /*-- init bulb model LUTs --*/
     bulb_init();
+    core_init_ac_heating();
 
     /*-- init sound commander --*/
     snd_cmd_init();
@@ -2188,6 +2510,10 @@ static MACHINE_INIT(core) {
   /*-- now reset everything --*/
   if (coreData->reset) coreData->reset();
   mech_emuInit();
+#if defined(VPINMAME) || defined(LIBPINMAME)
+  outexport_start();
+  netpub_start();
+#endif
 
 #ifdef VPINMAME
   // DMD USB Init
@@ -2195,8 +2521,8 @@ static MACHINE_INIT(core) {
     dmddeviceInit(g_szGameName, core_gameData->gen, &pmoptions);
 #endif
 
-  /*-- Generate LUTs for VPinMAME DMD --*/
-  #ifdef VPINMAME
+  /*-- Generate LUTs for VPinMAME and LibPinMAME DMD --*/
+  #if defined(VPINMAME) || defined(LIBPINMAME)
   {
     int rStart = 0xff, gStart = 0xe0, bStart = 0x20;
     int perc66 = 67, perc33 = 33, perc00 = 20;
@@ -2261,6 +2587,7 @@ static MACHINE_STOP(core) {
   // DMD USB Kill
   if(g_fShowPinDMD && !time_to_reset)
    dmddeviceDeInit();
+  core_dmd_capture_close();
 #endif
 #if defined(VPINMAME) || defined(LIBPINMAME)
   g_raw_dmdx = ~0u;
@@ -2268,12 +2595,16 @@ static MACHINE_STOP(core) {
 
   has_DMD_Video = 0;
 
-  raw_dmd_frame_count = 0;
-
   g_needs_DMD_update = 1;
+
+  dmdPalettes.active = -1;
 #endif
 
   mech_emuExit();
+#if defined(VPINMAME) || defined(LIBPINMAME)
+  outexport_stop();
+  netpub_stop();
+#endif
   if (coreData->stop) coreData->stop();
   snd_cmd_exit();
   for (ii = 0; ii < 5; ii++) {
@@ -2281,7 +2612,11 @@ static MACHINE_STOP(core) {
       timer_remove(locals.timers[ii]);
   }
   memset(locals.timers, 0, sizeof(locals.timers));
+  core_governorReset();
 #ifdef PROC_SUPPORT
+  if (locals.procSyncTimer)
+    timer_remove(locals.procSyncTimer);
+  locals.procSyncTimer = NULL;
   if (coreGlobals.p_rocEn) {
     procDeinitialize();
   }
@@ -2452,13 +2787,13 @@ void core_update_pwm_output_sol_2_state(const double now, const int index, const
     if (sol < 28)
       coreGlobals.solenoids = (coreGlobals.solenoids & ~(1 << sol)) | (state << sol);
     else if (sol < 32) {
-      if (core_gameData->gen & (GEN_WPC95 | GEN_WPC95DCS)) {
+      if (genDispatch.wpc95) {
         coreGlobals.solenoids = (coreGlobals.solenoids & ~(1 << (sol +  8))) | (state << (sol + 8));
         coreGlobals.solenoids = (coreGlobals.solenoids & ~(1 << (sol + 12))) | (state << (sol + 12));
       }
-      else if ((core_gameData->gen & GEN_ALLWPC) == 0)
+      else if (!genDispatch.wpc)
         coreGlobals.solenoids = (coreGlobals.solenoids & ~(1 << sol)) | (state << sol);
-      else if (core_gameData->gen & (GEN_ALLS11 | GEN_SAM | GEN_SPA) && 40 <= sol && sol < 48)
+      else if (genDispatch.sol37 && 40 <= sol && sol < 48)
         coreGlobals.solenoids = (coreGlobals.solenoids & ~(1 << (sol - 4))) | (state << (sol - 4));
     }
   }
@@ -2500,6 +2835,44 @@ INLINE void core_eye_flicker_fusion(core_tPhysicOutput* output, const float emis
 
 static const double BULB_INTEGRATION_PERIOD = 0.001; // do the integration in a loop of small steps
 
+// AC bulbs: the filament heating is proportional to U^2, so over an integration step an AC bulb gets the heating of the same
+// (RMS) DC voltage times the mean of 2.sin^2 over the step. Measuring time in half-cycles from the last zero cross, the integral
+// of 2.sin^2(PI.x) is G(x) = x - sin(2.PI.x)/(2.PI), so this mean is (G(x+dx) - G(x)) / dx. G is tabulated over one half-cycle
+// (G(x+1) = G(x) + 1), and a step, even spread over a triac-chopped half-cycle, costs 2 table lookups instead of a sinf.
+#define CORE_AC_HEAT_STEPS 1024
+static float core_ac_heat_integral[CORE_AC_HEAT_STEPS + 1];
+
+static void core_init_ac_heating(void)
+{
+  for (int i = 0; i <= CORE_AC_HEAT_STEPS; i++) {
+    const double x = (double)i / CORE_AC_HEAT_STEPS;
+    core_ac_heat_integral[i] = (float)(x - sin(2.0 * PI * x) / (2.0 * PI));
+  }
+}
+
+// G(x) for x >= 0, x in half-cycles
+INLINE float core_ac_heat_G(const float x)
+{
+  const float ix = floorf(x);
+  const float fi = (x - ix) * (float)CORE_AC_HEAT_STEPS;
+  int i = (int)fi;
+  if (i >= CORE_AC_HEAT_STEPS) i = CORE_AC_HEAT_STEPS - 1;
+  return ix + core_ac_heat_integral[i] + (fi - (float)i) * (core_ac_heat_integral[i + 1] - core_ac_heat_integral[i]);
+}
+
+// Voltage giving the mean heating of an AC bulb (U RMS) over a step of dx half-cycles starting x half-cycles (0 <= x < 1) after the zero cross
+INLINE float core_ac_heat_voltage(const float U, const float x, const float dx)
+{
+  return dx > 0.f ? U * sqrtf(fmaxf(core_ac_heat_G(x + dx) - core_ac_heat_G(x), 0.f) / dx) : U;
+}
+
+// Position in the half-cycle (0 <= x < 1) of time t
+INLINE float core_ac_half_cycle_pos(const double t)
+{
+  const double x = (t - coreGlobals.lastACZeroCrossTimeStamp) * (2.0 * 60.0);
+  return (float)(x - floor(x));
+}
+
 // Incandescent bulb model based on Dulli Chandra Agrawal's and others publications (Heating-times of tungsten filament incandescent lamps).
 // The bulb is a varying resistor depending on filament temperature, which is heated by the current (Ohm's law)
 // and cooled by radiating energy (Planck & Stefan/Boltzmann laws). The visible emission power is then evaluated from the filament temperature.
@@ -2520,10 +2893,15 @@ void core_update_pwm_output_bulb(const double now, const int index, const int is
       countf = 1.f;
     const int count = (int)countf;
     const float dt = dt_diff/countf;
+    const float acStep = dt * (float)(2.0 * 60.0);
+    float acPos = output->state.bulb.isAC ? core_ac_half_cycle_pos(output->state.bulb.prevIntegrationTimestamp) : 0.f;
+    output->state.bulb.settled = FALSE; // see core_update_pwm_output_bulbs
     for(int i = 0; i < count; ++i) {
       // Keeps T within the range of the LUT (between room temperature and melt down point)
       output->state.bulb.filament_temperature = output->state.bulb.filament_temperature < 293.0f ? 293.0f : output->state.bulb.filament_temperature > (float) BULB_T_MAX ? (float) BULB_T_MAX : output->state.bulb.filament_temperature;
-      const float Ut = output->state.bulb.isAC ? (1.41421356f * sinf((float)(60.0 * 2.0 * PI) * (float)(output->state.bulb.prevIntegrationTimestamp - coreGlobals.lastACZeroCrossTimeStamp)) * output->state.bulb.prevIntegrationValue) : output->state.bulb.prevIntegrationValue;
+      const float Ut = output->state.bulb.isAC ? core_ac_heat_voltage(output->state.bulb.prevIntegrationValue, acPos, acStep) : output->state.bulb.prevIntegrationValue;
+      acPos += acStep;
+      acPos -= floorf(acPos);
       const float dT = dt * bulb_heat_up_factor(output->state.bulb.bulb, output->state.bulb.filament_temperature, Ut, output->state.bulb.serial_R);
       output->state.bulb.filament_temperature += dT < 1000.0f ? dT : 1000.0f; // Limit initial current surge (1ms is a bit long when emulating this part of the heating)
       core_eye_flicker_fusion(output, bulb_filament_temperature_to_emission(output->state.bulb.bulb, output->state.bulb.filament_temperature));
@@ -2542,6 +2920,118 @@ void core_update_pwm_output_bulb(const double now, const int index, const int is
   #endif
 }
 
+// Batched version of the stable state integration of core_update_pwm_output_bulb (isFlip = FALSE), used by core_update_pwm_outputs:
+// the state of up to CORE_BULB_BATCH bulbs is gathered in arrays, then all of them are integrated together step after step, so that
+// the eye model and the temperature updates run lane-wise (and get vectorized by the compiler). Lanes run for their own step count,
+// finished lanes are masked. AC bulbs use the same half-cycle heating table as core_update_pwm_output_bulb.
+// Bulbs whose last integration over a period without flip barely changed them are settled: until their next flip, they are only
+// stamped forward. Lit DC bulbs keep their state (filament at its fixed point), unlit bulbs only cool down, using the cool down LUT.
+#define CORE_BULB_BATCH 16
+#define CORE_BULB_SETTLED_T     2.0f          // max filament temperature change (K) of a settled lit bulb over the last integration
+#define CORE_BULB_SETTLED_VALUE (1.f/1024.f)  // max output change over the last integration, and max output of a settled unlit bulb
+static void core_update_pwm_output_bulbs(const double now, const int* indices, const int n)
+{
+  int   bulb[CORE_BULB_BATCH], count[CORE_BULB_BATCH], isAC[CORE_BULB_BATCH], settled[CORE_BULB_BATCH];
+  float T[CORE_BULB_BATCH], U[CORE_BULB_BATCH], Ut[CORE_BULB_BATCH], serial_R[CORE_BULB_BATCH], dt[CORE_BULB_BATCH];
+  float eye0[CORE_BULB_BATCH], eye1[CORE_BULB_BATCH], eye2[CORE_BULB_BATCH], eyeOld[CORE_BULB_BATCH], value[CORE_BULB_BATCH];
+  float acPos[CORE_BULB_BATCH], acStep[CORE_BULB_BATCH];
+  float Tc[CORE_BULB_BATCH], factor[CORE_BULB_BATCH], emission[CORE_BULB_BATCH], T0[CORE_BULB_BATCH];
+  int maxCount = 0;
+
+  for (int l = 0; l < n; l++) {
+    core_tPhysicOutput* const output = &coreGlobals.physicOutputState[indices[l]];
+    const int state = output->lastIntegrationFlipPos & 1;
+    const float newU = (state ^ output->state.bulb.isReversed) ? output->state.bulb.U : 0.f;
+    const float dt_diff = (float)(output->state.bulb.integrationTimestamp - output->state.bulb.prevIntegrationTimestamp);
+    count[l] = 0;
+    settled[l] = output->state.bulb.settled && newU == output->state.bulb.prevIntegrationValue;
+    if (settled[l]) {
+      if (newU == 0.f && output->state.bulb.filament_temperature > 293.0f && dt_diff > 0.f)
+        output->state.bulb.filament_temperature = (float)bulb_cool_down(output->state.bulb.bulb, output->state.bulb.filament_temperature, dt_diff);
+    }
+    else if (newU != output->state.bulb.prevIntegrationValue || dt_diff >= (float)(BULB_INTEGRATION_PERIOD*20.)) {
+      float countf = floorf(dt_diff*(float)(1./BULB_INTEGRATION_PERIOD) + 0.5f);
+      if (countf < 1.f)
+        countf = 1.f;
+      count[l] = (int)countf;
+      dt[l] = dt_diff/countf;
+      if (count[l] > maxCount)
+        maxCount = count[l];
+    }
+    else
+      dt[l] = 0.f;
+    bulb[l] = output->state.bulb.bulb;
+    isAC[l] = output->state.bulb.isAC;
+    T0[l] = T[l] = output->state.bulb.filament_temperature;
+    U[l] = output->state.bulb.prevIntegrationValue;
+    serial_R[l] = output->state.bulb.serial_R;
+    eye0[l] = output->state.bulb.eye_integration[0];
+    eye1[l] = output->state.bulb.eye_integration[1];
+    eye2[l] = output->state.bulb.eye_integration[2];
+    eyeOld[l] = output->state.bulb.eye_emission_old;
+    value[l] = output->value;
+    if (isAC[l] && count[l]) {
+      acPos[l] = core_ac_half_cycle_pos(output->state.bulb.prevIntegrationTimestamp);
+      acStep[l] = dt[l] * (float)(2.0 * 60.0);
+    }
+    else
+      acPos[l] = acStep[l] = 0.f;
+  }
+
+  for (int step = 0; step < maxCount; step++) {
+    for (int l = 0; l < n; l++) {
+      // Keeps T within the range of the LUT (between room temperature and melt down point), masked lanes only use it for the lookup
+      Tc[l] = T[l] < 293.0f ? 293.0f : T[l] > (float) BULB_T_MAX ? (float) BULB_T_MAX : T[l];
+      Ut[l] = isAC[l] ? core_ac_heat_voltage(U[l], acPos[l], acStep[l]) : U[l];
+    }
+    bulb_heat_up_factors(n, bulb, Tc, Ut, serial_R, factor);
+    for (int l = 0; l < n; l++) {
+      const float dT = dt[l] * factor[l];
+      if (step < count[l])
+        T[l] = Tc[l] + (dT < 1000.0f ? dT : 1000.0f); // Limit initial current surge (1ms is a bit long when emulating this part of the heating)
+    }
+    bulb_filament_temperature_to_emissions(n, bulb, T, emission);
+    for (int l = 0; l < n; l++) {
+      // Same eye model as core_eye_flicker_fusion
+      const float eyeIntegrationFactor = (0.07f + 0.02f * 2.f*sqrtf(fmaxf(value[l],0.f))), revEyeIntegrationFactor = 1.0f - eyeIntegrationFactor;
+      const float e0 = (eyeIntegrationFactor * 0.5f) * (emission[l] + eyeOld[l]) + revEyeIntegrationFactor * eye0[l];
+      const float e1 = (eyeIntegrationFactor * 0.5f) * (e0 + eye0[l]) + revEyeIntegrationFactor * eye1[l];
+      const float e2 = (eyeIntegrationFactor * 0.5f) * (e1 + eye1[l]) + revEyeIntegrationFactor * eye2[l];
+      const float v  = (eyeIntegrationFactor * 0.5f) * (e2 + eye2[l]) + revEyeIntegrationFactor * value[l];
+      const float p  = acPos[l] + acStep[l];
+      const int active = step < count[l];
+      eye0[l]   = active ? e0 : eye0[l];
+      eye1[l]   = active ? e1 : eye1[l];
+      eye2[l]   = active ? e2 : eye2[l];
+      value[l]  = active ? v : value[l];
+      eyeOld[l] = active ? emission[l] : eyeOld[l];
+      acPos[l]  = active ? p - floorf(p) : acPos[l];
+    }
+  }
+
+  for (int l = 0; l < n; l++) {
+    core_tPhysicOutput* const output = &coreGlobals.physicOutputState[indices[l]];
+    if (count[l]) {
+      const float newU = ((output->lastIntegrationFlipPos & 1) ^ output->state.bulb.isReversed) ? output->state.bulb.U : 0.f;
+      // Settled if integrated for a while without flip, with a negligible change, and either unlit or lit by a DC voltage
+      output->state.bulb.settled = count[l] >= 20 && newU == U[l] && fabsf(value[l] - output->value) < CORE_BULB_SETTLED_VALUE
+        && (U[l] == 0.f ? (T[l] < 1500.0f && value[l] < CORE_BULB_SETTLED_VALUE && eye0[l] < CORE_BULB_SETTLED_VALUE && eye1[l] < CORE_BULB_SETTLED_VALUE && eye2[l] < CORE_BULB_SETTLED_VALUE)
+                        : (!isAC[l] && fabsf(T[l] - T0[l]) < CORE_BULB_SETTLED_T));
+      output->state.bulb.filament_temperature = T[l];
+      output->state.bulb.eye_integration[0] = eye0[l];
+      output->state.bulb.eye_integration[1] = eye1[l];
+      output->state.bulb.eye_integration[2] = eye2[l];
+      output->state.bulb.eye_emission_old = eyeOld[l];
+      output->value = value[l];
+    }
+    if (count[l] || settled[l]) {
+      output->state.bulb.prevIntegrationTimestamp = output->state.bulb.integrationTimestamp;
+      output->state.bulb.prevIntegrationValue = ((output->lastIntegrationFlipPos & 1) ^ output->state.bulb.isReversed) ? output->state.bulb.U : 0.f;
+    }
+    output->state.bulb.integrationTimestamp = now;
+  }
+}
+
 // LED and VFD behave similarly:
 // - LED reacts almost instantly (<1us)
 // - The documentation for the behavior of Vacuum Fluorescent Display (used by alphanum displays) is sparse, so the integrator likely needs more work. From the searchs made, it appears that:
@@ -2591,11 +3081,192 @@ void core_update_pwm_output_led(const double now, const int index, const int isF
   #endif
 }
 
+// Batched version of the stable state integration of core_update_pwm_output_led (isFlip = FALSE), used by core_update_pwm_outputs
+// for the LED and VFD outputs, mostly alphanumeric segments which come by digits of 16 outputs. Like for the bulbs, the lanes that
+// need an integration are integrated together step after step (eye model run lane-wise), finished lanes being masked. Lanes that
+// are dark and stay dark (null emission and null eye model state) are left out, since the integration would not change them.
+#define CORE_LED_BATCH 16
+static void core_update_pwm_output_leds(const double now, const int* indices, const int n)
+{
+  int   count[CORE_LED_BATCH];
+  float emission[CORE_LED_BATCH], eye0[CORE_LED_BATCH], eye1[CORE_LED_BATCH], eye2[CORE_LED_BATCH], eyeOld[CORE_LED_BATCH], value[CORE_LED_BATCH];
+  int maxCount = 0;
+
+  for (int l = 0; l < n; l++) {
+    core_tPhysicOutput* const output = &coreGlobals.physicOutputState[indices[l]];
+    const float power = (output->lastIntegrationFlipPos & 1) ? output->state.bulb.relative_brightness : 0.f;
+    const float dt_diff = (float)(output->state.bulb.integrationTimestamp - output->state.bulb.prevIntegrationTimestamp);
+    count[l] = 0;
+    emission[l] = 0.f;
+    if (power != output->state.bulb.prevIntegrationValue || dt_diff >= (float)(BULB_INTEGRATION_PERIOD*20.)) {
+      // Same step count and emission as core_update_pwm_output_led
+      float countf = floorf(dt_diff*(float)(1./BULB_INTEGRATION_PERIOD) + 0.5f);
+      if (countf < 1.f)
+        countf = 1.f;
+      const float dt_ratio = (dt_diff/countf)*(float)(1./BULB_INTEGRATION_PERIOD);
+      emission[l] = output->state.bulb.prevIntegrationValue * cube(sqrtf(sqrtf(dt_ratio)));
+      if (emission[l] != 0.f || output->value != 0.f || output->state.bulb.eye_emission_old != 0.f
+        || output->state.bulb.eye_integration[0] != 0.f || output->state.bulb.eye_integration[1] != 0.f || output->state.bulb.eye_integration[2] != 0.f)
+        count[l] = (int)countf;
+      if (count[l] > maxCount)
+        maxCount = count[l];
+      output->state.bulb.prevIntegrationTimestamp = output->state.bulb.integrationTimestamp;
+      output->state.bulb.prevIntegrationValue = power;
+    }
+    output->state.bulb.integrationTimestamp = now;
+    eye0[l] = output->state.bulb.eye_integration[0];
+    eye1[l] = output->state.bulb.eye_integration[1];
+    eye2[l] = output->state.bulb.eye_integration[2];
+    eyeOld[l] = output->state.bulb.eye_emission_old;
+    value[l] = output->value;
+  }
+
+  for (int step = 0; step < maxCount; step++) {
+    for (int l = 0; l < n; l++) {
+      // Same eye model as core_eye_flicker_fusion
+      const float eyeIntegrationFactor = (0.07f + 0.02f * 2.f*sqrtf(fmaxf(value[l],0.f))), revEyeIntegrationFactor = 1.0f - eyeIntegrationFactor;
+      const float e0 = (eyeIntegrationFactor * 0.5f) * (emission[l] + eyeOld[l]) + revEyeIntegrationFactor * eye0[l];
+      const float e1 = (eyeIntegrationFactor * 0.5f) * (e0 + eye0[l]) + revEyeIntegrationFactor * eye1[l];
+      const float e2 = (eyeIntegrationFactor * 0.5f) * (e1 + eye1[l]) + revEyeIntegrationFactor * eye2[l];
+      const float v  = (eyeIntegrationFactor * 0.5f) * (e2 + eye2[l]) + revEyeIntegrationFactor * value[l];
+      const int active = step < count[l];
+      eye0[l]   = active ? e0 : eye0[l];
+      eye1[l]   = active ? e1 : eye1[l];
+      eye2[l]   = active ? e2 : eye2[l];
+      value[l]  = active ? v : value[l];
+      eyeOld[l] = active ? emission[l] : eyeOld[l];
+    }
+  }
+
+  if (maxCount)
+    for (int l = 0; l < n; l++) {
+      core_tPhysicOutput* const output = &coreGlobals.physicOutputState[indices[l]];
+      output->state.bulb.eye_integration[0] = eye0[l];
+      output->state.bulb.eye_integration[1] = eye1[l];
+      output->state.bulb.eye_integration[2] = eye2[l];
+      output->state.bulb.eye_emission_old = eyeOld[l];
+      output->value = value[l];
+    }
+}
+
+// The physical outputs are integrated by the host thread and, when outputs are exported (see outexport.c),
+// by the emulation thread: this lock serializes them (it is never contended otherwise)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define CORE_SPIN_LOCK(p)   while (_InterlockedExchange((volatile long *)(p), 1)) { }
+#define CORE_SPIN_UNLOCK(p) _InterlockedExchange((volatile long *)(p), 0)
+#else
+#define CORE_SPIN_LOCK(p)   while (__sync_lock_test_and_set((p), 1)) { }
+#define CORE_SPIN_UNLOCK(p) __sync_lock_release(p)
+#endif
+static volatile long pwmIntegrationLock = 0;
+
+// Restart the integration of an output from its current binary state, dropping its pending flips. The flipBufferPos
+// parity is the binary state: it is set back from binaryOutputState for direct outputs, which do not record flips.
+static void core_restart_pwm_output(int index, double now)
+{
+  core_tPhysicOutput* const output = &coreGlobals.physicOutputState[index];
+  output->flipBufferPos = (output->flipBufferPos & ~1u) | ((coreGlobals.binaryOutputState[index >> 3] >> (index & 7)) & 1);
+  output->lastIntegrationFlipPos = output->flipBufferPos;
+  if (output->integrator == &core_update_pwm_output_bulb || output->integrator == &core_update_pwm_output_led) {
+    output->state.bulb.integrationTimestamp = now;
+    output->state.bulb.prevIntegrationTimestamp = now;
+    output->state.bulb.settled = FALSE;
+  }
+}
+
+// Select the outputs integrated by core_update_pwm_outputs. Hosts usually only read a small part of the
+// outputs (the lamps of the table, the toys of a DOF setup,...) while the integration of the others costs as
+// much. Unwatched outputs keep their last value and their pending flips are dropped when they are watched
+// again, restarting the integration from their current binary state.
+void core_set_pwm_output_watched(int startIndex, int count, int watched)
+{
+  // called from the host thread (see core_update_pwm_outputs)
+  const double now = timer_get_published_time();
+  CORE_SPIN_LOCK(&pwmIntegrationLock);
+  for (int i = startIndex; i < startIndex + count; i++) {
+    const UINT8 bit = (UINT8)(1 << (i & 7));
+    if (!watched) {
+      coreGlobals.physicOutputUnwatched[i >> 3] |= bit;
+      continue;
+    }
+    if ((coreGlobals.physicOutputUnwatched[i >> 3] & bit) == 0)
+      continue;
+    core_restart_pwm_output(i, now);
+    coreGlobals.physicOutputUnwatched[i >> 3] &= ~bit;
+  }
+  CORE_SPIN_UNLOCK(&pwmIntegrationLock);
+}
+
+int core_get_pwm_output_watched(int index)
+{
+  return (coreGlobals.physicOutputUnwatched[index >> 3] & (1 << (index & 7))) == 0;
+}
+
+// Select the outputs driven directly: the writers only keep their binary state, which the drivers use to update
+// lampMatrix and the solenoids as without physical outputs, with no flip recorded nor integrated. Outputs that
+// are modelled again restart their integration from their current binary state.
+void core_set_pwm_output_direct(int startIndex, int count, int direct)
+{
+  const double now = timer_get_published_time();
+  CORE_SPIN_LOCK(&pwmIntegrationLock);
+  for (int i = startIndex; i < startIndex + count; i++) {
+    const UINT8 bit = (UINT8)(1 << (i & 7));
+    if (direct)
+      coreGlobals.physicOutputDirect[i >> 3] |= bit;
+    else if (coreGlobals.physicOutputDirect[i >> 3] & bit) {
+      core_restart_pwm_output(i, now);
+      coreGlobals.physicOutputDirect[i >> 3] &= ~bit;
+    }
+  }
+  CORE_SPIN_UNLOCK(&pwmIntegrationLock);
+}
+
+// Select the output model of each output type from options.usemodsol: types without physical outputs (nor
+// CORE_MODOUT_FORCE_ON, set by the drivers which need the integration in their init) are driven directly.
+// Called once the driver is initialized, and again whenever options.usemodsol is changed.
+void core_init_pwm_output_models(void)
+{
+  const int forced = options.usemodsol & CORE_MODOUT_FORCE_ON;
+  core_set_pwm_output_direct(CORE_MODOUT_SOL0, CORE_MODOUT_SOL_MAX, !(forced || (options.usemodsol & (CORE_MODOUT_ENABLE_PHYSOUT_SOLENOIDS | CORE_MODOUT_ENABLE_MODSOL))));
+  core_set_pwm_output_direct(CORE_MODOUT_GI0, CORE_MODOUT_GI_MAX, !(forced || (options.usemodsol & CORE_MODOUT_ENABLE_PHYSOUT_GI)));
+  core_set_pwm_output_direct(CORE_MODOUT_LAMP0, CORE_MODOUT_LAMP_MAX, !(forced || (options.usemodsol & CORE_MODOUT_ENABLE_PHYSOUT_LAMPS)));
+  core_set_pwm_output_direct(CORE_MODOUT_SEG0, CORE_MODOUT_SEG_MAX, !(forced || (options.usemodsol & CORE_MODOUT_ENABLE_PHYSOUT_ALPHASEGS)));
+  /*-- the solenoid sources depend on the modulated solenoid options --*/
+  core_init_gen_dispatch();
+}
+
+// Reset an output, with a flip ring of ringSize timestamps. Each output has a small ring of its own, larger
+// ones are taken from a pool and kept when the output type changes again (the pool is only reset with coreGlobals).
+static void core_reset_pwm_output(int index, unsigned int ringSize)
+{
+  core_tPhysicOutput* const output = &coreGlobals.physicOutputState[index];
+  unsigned int offset = output->flipBufferOffset, capacity = output->flipBufferCapacity;
+  if (capacity < ringSize) {
+    if (ringSize > FLIP_BUFFER_SIZE_SLOW && coreGlobals.flipTimeStampPoolUsed + ringSize <= CORE_MODOUT_FLIP_POOL) {
+      offset = CORE_MODOUT_MAX * FLIP_BUFFER_SIZE_SLOW + coreGlobals.flipTimeStampPoolUsed;
+      capacity = ringSize;
+      coreGlobals.flipTimeStampPoolUsed += ringSize;
+    }
+    else if (capacity < FLIP_BUFFER_SIZE_SLOW) {
+      if (ringSize > FLIP_BUFFER_SIZE_SLOW)
+        logerror("Physical output #%d: flip timestamp pool is full, using a ring of %d flips instead of %d\n", index, FLIP_BUFFER_SIZE_SLOW, ringSize);
+      offset = index * FLIP_BUFFER_SIZE_SLOW;
+      capacity = FLIP_BUFFER_SIZE_SLOW;
+    }
+  }
+  memset(output, 0, sizeof(core_tPhysicOutput));
+  output->flipBufferOffset = offset;
+  output->flipBufferCapacity = capacity;
+  output->flipBufferMask = (ringSize < capacity ? ringSize : capacity) - 1;
+  output->flipBufferPos = (coreGlobals.binaryOutputState[index >> 3] >> (index & 7)) & 1;
+}
+
 void core_set_pwm_output_type(int startIndex, int count, int type)
 {
   for (int i = startIndex; i < startIndex + count; i++) {
-    memset(&(coreGlobals.physicOutputState[i]), 0, sizeof(core_tPhysicOutput));
-    coreGlobals.physicOutputState[i].flipBufferPos = (coreGlobals.binaryOutputState[i >> 3] >> (i & 7)) & 1;
+    core_reset_pwm_output(i, type == CORE_MODOUT_NONE || type == CORE_MODOUT_PULSE || type == CORE_MODOUT_SOL_CUSTOM ? FLIP_BUFFER_SIZE_SLOW
+                           : type >= CORE_MODOUT_LED ? FLIP_BUFFER_SIZE_FAST : FLIP_BUFFER_SIZE);
     coreGlobals.physicOutputState[i].type = type;
     switch (type) {
     case CORE_MODOUT_NONE:
@@ -2798,8 +3469,7 @@ void core_set_pwm_output_type(int startIndex, int count, int type)
 void core_set_pwm_output_bulb(int startIndex, int count, int bulb, float U, int isAC, float serial_R, float relative_brightness)
 {
   for (int i = startIndex; i < startIndex + count; i++) {
-    memset(&(coreGlobals.physicOutputState[i]), 0, sizeof(core_tPhysicOutput));
-    coreGlobals.physicOutputState[i].flipBufferPos = (coreGlobals.binaryOutputState[i >> 3] >> (i & 7)) & 1;
+    core_reset_pwm_output(i, FLIP_BUFFER_SIZE);
     coreGlobals.physicOutputState[i].type = CORE_MODOUT_CUSTOM_INTEGRATOR;
     coreGlobals.physicOutputState[i].state.bulb.bulb = bulb;
     coreGlobals.physicOutputState[i].state.bulb.U = U;
@@ -2823,23 +3493,51 @@ void core_set_pwm_output_types(int startIndex, int count, int* outputTypes)
 // according to physic engine constants while visual should be updated according to output display characteristics).
 void core_update_pwm_outputs(const int startIndex, const int count)
 {
-   // HACK timer_get_time is not thread safe and can only be called from emulation thread. Therefore we use a fake timer with timer_starttime which is thread safe as a workaround.
-   // const double now = timer_get_time();
-   mame_timer fake_timer = { 0 };
-   const double now = timer_starttime(&fake_timer);
+   // Called from the host thread for VPinMAME and libpinmame, where timer_get_time can't be used: integrate up to the last timeslice boundary
+   const double now = timer_get_published_time();
+   CORE_SPIN_LOCK(&pwmIntegrationLock);
+   int bulbBatch[CORE_BULB_BATCH], nBulbs = 0, ledBatch[CORE_LED_BATCH], nLeds = 0;
    for (int i = 0; i < count; i++)
    {
       const unsigned int index = startIndex + i;
+      if ((coreGlobals.physicOutputUnwatched[index >> 3] | coreGlobals.physicOutputDirect[index >> 3]) & (1 << (index & 7)))
+         continue;
       core_tPhysicOutput* const output = &coreGlobals.physicOutputState[index];
       // Perform integration of flip states that appended since last integration and before now if any
       while (output->lastIntegrationFlipPos != output->flipBufferPos)
       {
-         output->lastIntegrationFlipPos = (output->lastIntegrationFlipPos + 1) % FLIP_BUFFER_SIZE;
-         output->integrator(output->flipTimeStamps[output->lastIntegrationFlipPos], index, TRUE, (output->lastIntegrationFlipPos & 1) ^ 1);
+         output->lastIntegrationFlipPos = (output->lastIntegrationFlipPos + 1) & output->flipBufferMask;
+         output->integrator(coreGlobals.flipTimeStamps[output->flipBufferOffset + output->lastIntegrationFlipPos], index, TRUE, (output->lastIntegrationFlipPos & 1) ^ 1);
+      }
+      // Perform integration of stable state up to now, bulbs and LEDs/VFDs are integrated together by batches
+      #ifndef LOG_PWM_OUT
+      if (output->integrator == &core_update_pwm_output_bulb)
+      {
+         bulbBatch[nBulbs++] = index;
+         if (nBulbs == CORE_BULB_BATCH)
+         {
+            core_update_pwm_output_bulbs(now, bulbBatch, nBulbs);
+            nBulbs = 0;
+         }
+         continue;
+      }
+      if (output->integrator == &core_update_pwm_output_led)
+      {
+         ledBatch[nLeds++] = index;
+         if (nLeds == CORE_LED_BATCH)
+         {
+            core_update_pwm_output_leds(now, ledBatch, nLeds);
+            nLeds = 0;
+         }
+         continue;
       }
-      // Perform integration of stable state up to now
+      #endif
       output->integrator(now, index, FALSE, output->lastIntegrationFlipPos & 1);
    }
+   if (nBulbs)
+      core_update_pwm_output_bulbs(now, bulbBatch, nBulbs);
+   if (nLeds)
+      core_update_pwm_output_leds(now, ledBatch, nLeds);
    // Also update non PWM data structure if needed
    if (options.usemodsol & CORE_MODOUT_FORCE_ON)
    {
@@ -2863,6 +3561,35 @@ void core_update_pwm_outputs(const int startIndex, const int count)
          coreGlobals.solenoids = sols;
       }
    }
+   CORE_SPIN_UNLOCK(&pwmIntegrationLock);
+}
+
+// Append a flip to the ring of an output, counting the overruns (the ring then looks empty to the integrator
+// which restarts from the current state, losing the flips that were not integrated yet)
+INLINE void core_push_pwm_flip(core_tPhysicOutput* const output, const double now)
+{
+   const unsigned int bufferPos = (output->flipBufferPos + 1) & output->flipBufferMask;
+   if (bufferPos == output->lastIntegrationFlipPos)
+      output->flipOverruns++;
+   coreGlobals.flipTimeStamps[output->flipBufferOffset + bufferPos] = now;
+   output->flipBufferPos = bufferPos;
+}
+
+// Append a flip to the rings of the outputs whose bit is set in changeMask, jumping from one set bit to the next
+// (lowest bit index from the de Bruijn sequence 0x1D)
+static const UINT8 lowestBitIndex8[8] = { 0, 1, 6, 2, 7, 5, 4, 3 };
+INLINE void core_push_pwm_flips_8b(core_tPhysicOutput* const outputs, unsigned int changeMask, const double now)
+{
+   for (; changeMask; changeMask &= changeMask - 1)
+      core_push_pwm_flip(&outputs[lowestBitIndex8[(UINT8)((changeMask & (0u - changeMask)) * 0x1Du) >> 5]], now);
+}
+
+unsigned int core_get_pwm_output_overruns(int startIndex, int count)
+{
+   unsigned int overruns = 0;
+   for (int i = startIndex; i < startIndex + count; i++)
+      overruns += coreGlobals.physicOutputState[i].flipOverruns;
+   return overruns;
 }
 
 // Write binary state of outputs, taking care of PWM integration based on physical model of the connected device
@@ -2873,9 +3600,8 @@ void core_write_pwm_output(int index, int count, UINT8 bitStates)
    for (int i = 0; i < count; i++, bitStates = bitStates >> 1, index++, output++) {
       const int pos = index >> 3, ofs = index & 7;
       if (((coreGlobals.binaryOutputState[pos] >> ofs) & 1) != (bitStates & 1)) {
-         const unsigned int bufferPos = (output->flipBufferPos + 1) % FLIP_BUFFER_SIZE;
-         output->flipTimeStamps[bufferPos] = now;
-         output->flipBufferPos = bufferPos;
+         if ((coreGlobals.physicOutputDirect[pos] & (1 << ofs)) == 0)
+            core_push_pwm_flip(output, now);
          coreGlobals.binaryOutputState[pos] ^= 1 << ofs;
       }
    }
@@ -2884,35 +3610,25 @@ void core_write_pwm_output(int index, int count, UINT8 bitStates)
 void core_write_pwm_output_8b(int index, UINT8 bitStates)
 {
    assert((index & 7) == 0);
-   UINT8 changeMask = coreGlobals.binaryOutputState[index >> 3] ^ bitStates;
+   const UINT8 changeMask = coreGlobals.binaryOutputState[index >> 3] ^ bitStates;
    if (!changeMask)
       return;
-   const double now = timer_get_time();
-   for (core_tPhysicOutput* output = &coreGlobals.physicOutputState[index]; changeMask; changeMask >>= 1, output++)
-      if (changeMask & 1)
-      {
-         const unsigned int bufferPos = (output->flipBufferPos + 1) % FLIP_BUFFER_SIZE;
-         output->flipTimeStamps[bufferPos] = now;
-         output->flipBufferPos = bufferPos;
-      } 
    coreGlobals.binaryOutputState[index >> 3] = bitStates;
+   const UINT8 flipMask = changeMask & ~coreGlobals.physicOutputDirect[index >> 3];
+   if (flipMask)
+      core_push_pwm_flips_8b(&coreGlobals.physicOutputState[index], flipMask, timer_get_time());
 }
 
 void core_write_masked_pwm_output_8b(int index, UINT8 bitStates, UINT8 bitMask)
 {
    assert((index & 7) == 0);
-   UINT8 changeMask = bitMask & (coreGlobals.binaryOutputState[index >> 3] ^ bitStates); // Identify differences
+   const UINT8 changeMask = bitMask & (coreGlobals.binaryOutputState[index >> 3] ^ bitStates); // Identify differences
    if (!changeMask)
       return;
-   const double now = timer_get_time();
-   for (core_tPhysicOutput* output = &coreGlobals.physicOutputState[index]; changeMask; changeMask >>= 1, output++)
-      if (changeMask & 1)
-      {
-         const unsigned int bufferPos = (output->flipBufferPos + 1) % FLIP_BUFFER_SIZE;
-         output->flipTimeStamps[bufferPos] = now;
-         output->flipBufferPos = bufferPos;
-      }
    coreGlobals.binaryOutputState[index >> 3] = (coreGlobals.binaryOutputState[index >> 3] & ~bitMask) | (bitStates & bitMask);
+   const UINT8 flipMask = changeMask & ~coreGlobals.physicOutputDirect[index >> 3];
+   if (flipMask)
+      core_push_pwm_flips_8b(&coreGlobals.physicOutputState[index], flipMask, timer_get_time());
 }
 
 // Write a 8xn lamp matrix, taking care of PWM integration based on physical model of connected device
@@ -2920,13 +3636,30 @@ void core_write_pwm_output_lamp_matrix(int startIndex, UINT8 columns, UINT8 rows
 {
    if (options.usemodsol & (CORE_MODOUT_ENABLE_PHYSOUT_LAMPS | CORE_MODOUT_FORCE_ON))
    {
-      for (const int endIndex = startIndex + nCols * 8; startIndex < endIndex; columns >>= 1, startIndex += 8) {
-         if (columns & 1) {
-            coreGlobals.tmpLampMatrix[(startIndex - CORE_MODOUT_LAMP0) >> 3] |= rows;
-            core_write_pwm_output_8b(startIndex, rows);
+      assert((startIndex & 7) == 0 && nCols <= 8);
+      UINT8* const states = &coreGlobals.binaryOutputState[startIndex >> 3];
+      UINT8 newStates[8] = { 0 };
+      for (int i = 0; i < nCols; i++)
+         if ((columns >> i) & 1) {
+            coreGlobals.tmpLampMatrix[((startIndex - CORE_MODOUT_LAMP0) >> 3) + i] |= rows;
+            newStates[i] = rows;
          }
-         else {
-            core_write_pwm_output_8b(startIndex, 0);
+      // Drivers write the column and row latches separately, so many writes do not change anything: compare the whole 8x8 matrix at once
+      if (nCols == 8) {
+         UINT64 oldMatrix, newMatrix;
+         memcpy(&oldMatrix, states, 8);
+         memcpy(&newMatrix, newStates, 8);
+         if (oldMatrix == newMatrix)
+            return;
+      }
+      double now = -1.;
+      for (int i = 0; i < nCols; i++) {
+         const UINT8 changeMask = states[i] ^ newStates[i];
+         if (changeMask) {
+            if (now < 0.)
+               now = timer_get_time();
+            core_push_pwm_flips_8b(&coreGlobals.physicOutputState[startIndex + i * 8], changeMask, now);
+            states[i] = newStates[i];
          }
       }
    }
@@ -3013,8 +3746,131 @@ fprintf('%i, ', int_factor * b);
 fprintf(']\n');
 */
 
+// Low pass filter kernels: accumulate the weight of one raw frame into the shaded frame for every lit dot,
+// then scale the shaded frame down to 8 bit luminance. The SIMD versions expand each raw byte to 4 (SSE2/Neon)
+// or 8 (AVX2) lane masks by comparing against single bit masks, and divide using a precomputed reciprocal.
+static void dmd_shade_frame_c(UINT32* line, const UINT8* frameData, const int rawFrameSize, const UINT32 frame_weight, const int revByte) {
+  for (int jj = 0; jj < rawFrameSize; jj++) {
+    UINT8 data = *frameData++;
+    if (data == 0) {
+      line += 8;
+    } else if (revByte) {
+      for (int kk = 0; kk < 8; kk++, data >>= 1, line++)
+        if (data & 0x01) (*line) += frame_weight;
+    } else {
+      for (int kk = 0; kk < 8; kk++, data <<= 1, line++)
+        if (data & 0x80) (*line) += frame_weight;
+    }
+  }
+}
+
+static void dmd_luminance_c(UINT8* lum, const UINT32* line, const int frameSize, const UINT32 fir_sum) {
+  for (int ii = 0; ii < frameSize; ii++) {
+    const unsigned int data = (unsigned int) (*line++); // unsigned int precision is needed here
+    lum[ii] = (UINT8)(data / fir_sum);
+  }
+}
+
+#ifdef SSE_DMD_OPT
+static void dmd_shade_frame_sse2(UINT32* line, const UINT8* frameData, const int rawFrameSize, const UINT32 frame_weight, const int revByte) {
+  const __m128i weight = _mm_set1_epi32((int)frame_weight);
+  const __m128i mask0 = revByte ? _mm_setr_epi32(0x01, 0x02, 0x04, 0x08) : _mm_setr_epi32(0x80, 0x40, 0x20, 0x10);
+  const __m128i mask1 = revByte ? _mm_setr_epi32(0x10, 0x20, 0x40, 0x80) : _mm_setr_epi32(0x08, 0x04, 0x02, 0x01);
+  for (int jj = 0; jj < rawFrameSize; jj++, line += 8) {
+    const int data = frameData[jj];
+    if (data == 0)
+      continue;
+    const __m128i bits = _mm_set1_epi32(data);
+    const __m128i on0 = _mm_cmpeq_epi32(_mm_and_si128(bits, mask0), mask0);
+    const __m128i on1 = _mm_cmpeq_epi32(_mm_and_si128(bits, mask1), mask1);
+    _mm_storeu_si128((__m128i*)line, _mm_add_epi32(_mm_loadu_si128((const __m128i*)line), _mm_and_si128(on0, weight)));
+    _mm_storeu_si128((__m128i*)(line + 4), _mm_add_epi32(_mm_loadu_si128((const __m128i*)(line + 4)), _mm_and_si128(on1, weight)));
+  }
+}
+
+// Shaded values use the full unsigned 32 bit range, so they are converted to float as 2 16 bit halves. A small bias
+// keeps exact multiples of fir_sum from truncating one level down due to the reciprocal rounding.
+static void dmd_luminance_sse2(UINT8* lum, const UINT32* line, const int frameSize, const UINT32 fir_sum) {
+  const __m128 scale = _mm_set1_ps(1.0f / (float)fir_sum);
+  const __m128 bias = _mm_set1_ps(1.0f / 1024.0f);
+  const __m128 f65536 = _mm_set1_ps(65536.0f);
+  const __m128i lo16 = _mm_set1_epi32(0xFFFF);
+  assert((frameSize & 7) == 0);
+  for (int ii = 0; ii < frameSize; ii += 8) {
+    const __m128i v0 = _mm_loadu_si128((const __m128i*)(line + ii));
+    const __m128i v1 = _mm_loadu_si128((const __m128i*)(line + ii + 4));
+    const __m128 f0 = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(v0, 16)), f65536), _mm_cvtepi32_ps(_mm_and_si128(v0, lo16)));
+    const __m128 f1 = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(v1, 16)), f65536), _mm_cvtepi32_ps(_mm_and_si128(v1, lo16)));
+    const __m128i l0 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(f0, scale), bias));
+    const __m128i l1 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(f1, scale), bias));
+    const __m128i l16 = _mm_packs_epi32(l0, l1);
+    _mm_storel_epi64((__m128i*)(lum + ii), _mm_packus_epi16(l16, l16));
+  }
+}
+#endif
+
+#ifdef AVX2_DMD_OPT
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((target("avx2")))
+#endif
+static void dmd_shade_frame_avx2(UINT32* line, const UINT8* frameData, const int rawFrameSize, const UINT32 frame_weight, const int revByte) {
+  const __m256i weight = _mm256_set1_epi32((int)frame_weight);
+  const __m256i mask = revByte ? _mm256_setr_epi32(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80) : _mm256_setr_epi32(0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01);
+  for (int jj = 0; jj < rawFrameSize; jj++, line += 8) {
+    const int data = frameData[jj];
+    if (data == 0)
+      continue;
+    const __m256i on = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(data), mask), mask);
+    _mm256_storeu_si256((__m256i*)line, _mm256_add_epi32(_mm256_loadu_si256((const __m256i*)line), _mm256_and_si256(on, weight)));
+  }
+}
+
+static int dmd_has_avx2(void) {
+  static int has_avx2 = -1;
+  if (has_avx2 < 0) {
+  #if defined(_MSC_VER) && !defined(__clang__)
+    int regs[4];
+    __cpuid(regs, 0);
+    has_avx2 = 0;
+    if (regs[0] >= 7) {
+      __cpuid(regs, 1);
+      if ((regs[2] & (1 << 27)) && (regs[2] & (1 << 28)) && ((_xgetbv(0) & 6) == 6)) { // OSXSAVE, AVX, OS saves YMM
+        __cpuidex(regs, 7, 0);
+        has_avx2 = (regs[1] & (1 << 5)) != 0;
+      }
+    }
+  #else
+    __builtin_cpu_init();
+    has_avx2 = __builtin_cpu_supports("avx2") != 0;
+  #endif
+  }
+  return has_avx2;
+}
+#endif
+
+// Main DMD PWM states (2 for Strikes N' Spares) in initialization order, for on demand evaluation. The lock keeps
+// a state from being released while it is evaluated.
+static core_tDMDPWMState* dmdPWMStates[2];
+static volatile long dmdDemandLock = 0;
+static int dmdOnDemand = 0;
+
+#if defined(_MSC_VER)
+#define CORE_DMD_SEQ_LOAD(p) _InterlockedOr((p), 0)
+#define CORE_DMD_SEQ_INC(p)  _InterlockedIncrement(p)
+#else
+#define CORE_DMD_SEQ_LOAD(p) __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#define CORE_DMD_SEQ_INC(p)  __atomic_add_fetch((p), 1, __ATOMIC_SEQ_CST)
+#endif
+
+#if defined(VPINMAME) || defined(LIBPINMAME)
+// 8 dots (one byte per dot, in memory order) of a raw DMD byte, either high bit first or low bit first, used by the raw combiners
+static UINT64 dmd_dots_msb[256];
+static UINT64 dmd_dots_lsb[256];
+#endif
+
 void core_dmd_pwm_init(core_tDMDPWMState* dmd_state, const int width, const int height, const int filter, const int raw_combiner) {
   assert((width & 0x0007) == 0);
+  assert(height <= 64); // dirtyRows mask
   memset(dmd_state, 0, sizeof(core_tDMDPWMState));
   dmd_state->width = width;
   dmd_state->height = height;
@@ -3077,15 +3933,45 @@ void core_dmd_pwm_init(core_tDMDPWMState* dmd_state, const int width, const int
   dmd_state->shadedFrame = malloc(dmd_state->frameSize * sizeof(UINT32));
   dmd_state->bitplaneFrame = malloc(dmd_state->frameSize * sizeof(UINT8));
   dmd_state->luminanceFrame = malloc(dmd_state->frameSize * sizeof(UINT8));
-  assert(dmd_state->rawFrames != NULL && dmd_state->shadedFrame != NULL && dmd_state->bitplaneFrame != NULL && dmd_state->luminanceFrame != NULL);
+  dmd_state->rowHashes = calloc(dmd_state->height, sizeof(UINT64));
+  dmd_state->rawExportFrames = calloc(CORE_MAX_RAW_DMD_FRAMES, dmd_state->rawFrameSize);
+  dmd_state->demandRawFrames = malloc(dmd_state->nFrames * dmd_state->rawFrameSize);
+  dmd_state->demandShadedFrame = malloc(dmd_state->frameSize * sizeof(UINT32));
+  assert(dmd_state->rawFrames != NULL && dmd_state->shadedFrame != NULL && dmd_state->bitplaneFrame != NULL && dmd_state->luminanceFrame != NULL && dmd_state->rowHashes != NULL && dmd_state->rawExportFrames != NULL);
+  assert(dmd_state->demandRawFrames != NULL && dmd_state->demandShadedFrame != NULL);
   memset(dmd_state->rawFrames, 0, dmd_state->nFrames * dmd_state->rawFrameSize);
   memset(dmd_state->shadedFrame, 0, dmd_state->frameSize * sizeof(UINT32));
   memset(dmd_state->bitplaneFrame, 0, dmd_state->frameSize * sizeof(UINT8));
   memset(dmd_state->luminanceFrame, 0, dmd_state->frameSize * sizeof(UINT8));
   dmd_state->nextFrame = 0;
+  dmd_state->rawExportFrameCount = 0;
+  dmd_state->sequence = 0;
+  CORE_SPIN_LOCK(&dmdDemandLock);
+  for (int ii = 0; ii < 2; ii++)
+    if (dmdPWMStates[ii] == NULL) {
+      dmdPWMStates[ii] = dmd_state;
+      break;
+    }
+  CORE_SPIN_UNLOCK(&dmdDemandLock);
+  #if defined(VPINMAME) || defined(LIBPINMAME)
+  for (int ii = 0; ii < 256; ii++) {
+    UINT8 msb[8], lsb[8];
+    for (int jj = 0; jj < 8; jj++) {
+      msb[jj] = (ii >> (7 - jj)) & 1;
+      lsb[jj] = (ii >> jj) & 1;
+    }
+    memcpy(&dmd_dots_msb[ii], msb, 8);
+    memcpy(&dmd_dots_lsb[ii], lsb, 8);
+  }
+  #endif
 }
 
 void core_dmd_pwm_exit(core_tDMDPWMState* dmd_state) {
+  CORE_SPIN_LOCK(&dmdDemandLock);
+  for (int ii = 0; ii < 2; ii++)
+    if (dmdPWMStates[ii] == dmd_state)
+      dmdPWMStates[ii] = NULL;
+  CORE_SPIN_UNLOCK(&dmdDemandLock);
   free(dmd_state->rawFrames);
   dmd_state->rawFrames = NULL;
   free(dmd_state->shadedFrame);
@@ -3094,46 +3980,254 @@ void core_dmd_pwm_exit(core_tDMDPWMState* dmd_state) {
   dmd_state->bitplaneFrame = NULL;
   free(dmd_state->luminanceFrame);
   dmd_state->luminanceFrame = NULL;
+  free(dmd_state->rowHashes);
+  dmd_state->rowHashes = NULL;
+  free(dmd_state->rawExportFrames);
+  dmd_state->rawExportFrames = NULL;
+  free(dmd_state->demandRawFrames);
+  dmd_state->demandRawFrames = NULL;
+  free(dmd_state->demandShadedFrame);
+  dmd_state->demandShadedFrame = NULL;
 }
 
-// TODO for the time being, DMDs are always updated from core/updateDisplay, running at a fixed 60Hz. This may lead to stutters
-// as it is not aligned with real display refresh rate. We should update DMD on request but this needs to make these functions
-// thread safe. To avoid synchronization, a simple loop model with consumer accesing data before barrier, and provider pushing
-// data after the barrier should be enough.
+// Hash each row of luminance (and bitplane if not NULL) frames, update rowHashes, flag changed rows in dirtyRows and return
+// the hash of the whole frame. Width must be a multiple of 8 and height at most 64. Uses 64 bit FNV-1a on 8 dots at a time.
+UINT64 core_dmd_hash_frame(const int width, const int height, const UINT8* const dmdDotLum, const UINT8* const dmdDotRaw, UINT64* rowHashes, UINT64* dirtyRows) {
+  #define FNV_OFFSET 0xcbf29ce484222325ull
+  #define FNV_PRIME  0x00000100000001b3ull
+  UINT64 frameHash = FNV_OFFSET;
+  for (int jj = 0; jj < height; jj++) {
+    UINT64 rowHash = FNV_OFFSET, v;
+    for (int ii = 0; ii < width; ii += 8) {
+      memcpy(&v, dmdDotLum + jj * width + ii, sizeof(v));
+      rowHash = (rowHash ^ v) * FNV_PRIME;
+    }
+    if (dmdDotRaw)
+      for (int ii = 0; ii < width; ii += 8) {
+        memcpy(&v, dmdDotRaw + jj * width + ii, sizeof(v));
+        rowHash = (rowHash ^ v) * FNV_PRIME;
+      }
+    if (rowHashes[jj] != rowHash) {
+      rowHashes[jj] = rowHash;
+      *dirtyRows |= (UINT64)1 << jj;
+    }
+    frameHash = (frameHash ^ rowHash) * FNV_PRIME;
+  }
+  return frameHash;
+  #undef FNV_OFFSET
+  #undef FNV_PRIME
+}
+
+// DMDs are updated from core/updateDisplay, running at a fixed 60Hz, which may lead to stutters as it is not aligned with
+// the real display refresh rate. Alternatively, in on demand mode, a consumer evaluates the DMD at its own refresh instants
+// with 'core_dmd_evaluate_pwm' (from one other thread), and the driver updates do not evaluate it anymore. Submitted frames
+// are guarded by a sequence counter: the consumer copies them, then retries if a frame was submitted meanwhile.
+static void core_dmd_filter_pwm(core_tDMDPWMState* dmd_state);
+
 void core_dmd_submit_frame(core_tDMDPWMState* dmd_state, const UINT8* frame, const int ntimes) {
+  // Track how many identical frames were submitted in a row (comparing to the last stored one), to skip filtering of static screens
+  int identicalStored = 0; // Number of last stored frames that are identical to this one
+  if (ntimes > 0) {
+    const UINT8* const lastFrame = dmd_state->rawFrames + ((dmd_state->nextFrame + dmd_state->nFrames - 1) % dmd_state->nFrames) * dmd_state->rawFrameSize;
+    if (memcmp(lastFrame, frame, dmd_state->rawFrameSize) == 0) {
+      identicalStored = dmd_state->uniformFrames;
+      dmd_state->uniformFrames = dmd_state->uniformFrames >= 0x10000000 ? 0x10000000 : dmd_state->uniformFrames + ntimes;
+    }
+    else
+      dmd_state->uniformFrames = ntimes;
+  }
+  CORE_DMD_SEQ_INC(&dmd_state->sequence);
   for (int i = 0; i < ntimes; i++) {
-    memcpy(dmd_state->rawFrames + dmd_state->nextFrame * dmd_state->rawFrameSize, frame, dmd_state->rawFrameSize);
+    // Once the whole buffer holds this frame, the slot to overwrite already has the same content
+    if (identicalStored + i < dmd_state->nFrames)
+      memcpy(dmd_state->rawFrames + dmd_state->nextFrame * dmd_state->rawFrameSize, frame, dmd_state->rawFrameSize);
     dmd_state->nextFrame = (dmd_state->nextFrame + 1) % dmd_state->nFrames;
     dmd_state->frame_index++;
   }
+  CORE_DMD_SEQ_INC(&dmd_state->sequence);
+}
+
+void core_dmd_set_on_demand(const int onDemand) {
+  dmdOnDemand = onDemand;
+}
+
+// Evaluate luminance and bitplane frames of main DMD 'index' from its last submitted raw frames, into caller buffers of
+// at least width * height bytes. Returns width * height, or 0 if the DMD does not exist or has no PWM state.
+int core_dmd_evaluate_pwm(const int index, UINT8* const dmdDotLum, UINT8* const dmdDotRaw, const int size) {
+  int result = 0;
+  CORE_SPIN_LOCK(&dmdDemandLock);
+  core_tDMDPWMState* const dmd_state = (index >= 0 && index < 2) ? dmdPWMStates[index] : NULL;
+  if (dmd_state != NULL && size >= dmd_state->frameSize) {
+    core_tDMDPWMState eval = *dmd_state;
+    long sequence;
+    do {
+      while ((sequence = CORE_DMD_SEQ_LOAD(&dmd_state->sequence)) & 1) { }
+      memcpy(dmd_state->demandRawFrames, dmd_state->rawFrames, dmd_state->nFrames * dmd_state->rawFrameSize);
+      eval.nextFrame = dmd_state->nextFrame;
+    } while (CORE_DMD_SEQ_LOAD(&dmd_state->sequence) != sequence);
+    eval.rawFrames = dmd_state->demandRawFrames;
+    eval.shadedFrame = dmd_state->demandShadedFrame;
+    eval.luminanceFrame = dmdDotLum;
+    eval.bitplaneFrame = dmdDotRaw;
+    core_dmd_filter_pwm(&eval);
+    result = dmd_state->frameSize;
+  }
+  CORE_SPIN_UNLOCK(&dmdDemandLock);
+  return result;
 }
 
 void core_dmd_update_pwm(core_tDMDPWMState* dmd_state) {
-  // Apply low pass filter over stored frames then scale down to final shades
-  memset(dmd_state->shadedFrame, 0, dmd_state->width * dmd_state->height * sizeof(UINT32));
-  for (int ii = 0; ii < dmd_state->fir_size; ii++) {
-    const UINT32 frame_weight = dmd_state->fir_weights[ii];
-    UINT32* line = dmd_state->shadedFrame;
-    const UINT8* frameData = dmd_state->rawFrames + ((dmd_state->nextFrame + (dmd_state->nFrames - 1) + (dmd_state->nFrames - ii)) % dmd_state->nFrames) * dmd_state->rawFrameSize;
+  // In on demand mode, the consumer evaluates the DMD with 'core_dmd_evaluate_pwm' when it needs a frame
+  if (dmdOnDemand)
+    return;
+  // Skip filtering and combining if the result can't have changed: no frame submitted since last update, or the
+  // stored frames were all the same at last update and all frames submitted since then are identical to them
+  const unsigned int nNewFrames = dmd_state->frame_index - dmd_state->updatedFrameIndex;
+  if (!dmd_state->hasUpdated || (nNewFrames != 0 && (unsigned int)dmd_state->uniformFrames < (unsigned int)dmd_state->nFrames + nNewFrames)) {
+    core_dmd_filter_pwm(dmd_state);
+    // Hash once here so that output consumers (VPinMAME, LibPinMAME) don't need to compare whole frames
+    #if defined(VPINMAME) || defined(LIBPINMAME)
+    dmd_state->frameHash = core_dmd_hash_frame(dmd_state->width, dmd_state->height, dmd_state->luminanceFrame, dmd_state->bitplaneFrame, dmd_state->rowHashes, &dmd_state->dirtyRows);
+    #endif
+  }
+  dmd_state->updatedFrameIndex = dmd_state->frame_index;
+  dmd_state->hasUpdated = 1;
+
+  #if defined(VPINMAME) || defined(LIBPINMAME)
+  if (genDispatch.dmdExportRaw)
+    genDispatch.dmdExportRaw(dmd_state);
+  else
+    dmd_state->rawExportFrameCount = 0;
+  #endif
+}
+
+// For GTS3, WPC and Alvin G. 2 also store raw single bitplane frame for backward compatibility with colorization plugins
+// (kept per DMD state, so each of the 2 DMDs of GTS3 Strikes N' Spares has its own stream)
+#if defined(VPINMAME) || defined(LIBPINMAME)
+static void core_dmd_export_raw(core_tDMDPWMState* dmd_state) {
+  dmd_state->rawExportFrameCount = dmd_state->nFrames > CORE_MAX_RAW_DMD_FRAMES ? CORE_MAX_RAW_DMD_FRAMES : dmd_state->nFrames;
+  UINT8* rawData = dmd_state->rawExportFrames;
+  for (int frame = 0; frame < dmd_state->rawExportFrameCount; frame++) {
+    const UINT8* frameData = dmd_state->rawFrames + ((dmd_state->nextFrame + (dmd_state->nFrames - 1) + (dmd_state->nFrames - frame)) % dmd_state->nFrames) * dmd_state->rawFrameSize;
     for (int jj = 0; jj < dmd_state->rawFrameSize; jj++) {
-      UINT8 data = *frameData++;
-      if (dmd_state->revByte) {
-        for (int kk = 0; kk < 8; kk++, data >>= 1, line++)
-          if (data & 0x01) (*line) += frame_weight;
-      } else {
-        for (int kk = 0; kk < 8; kk++, data <<= 1, line++)
-          if (data & 0x80) (*line) += frame_weight;
-      }
+      *rawData = dmd_state->revByte ? (*frameData++) : core_revbyte(*frameData++);
+      rawData++;
     }
   }
-  const UINT32* line = dmd_state->shadedFrame;
-  for (int ii = 0; ii < dmd_state->height * dmd_state->width; ii++) {
-    const unsigned int data = (unsigned int) (*line++); // unsigned int precision is needed here
-    dmd_state->luminanceFrame[ii] = (UINT8)(data / dmd_state->fir_sum);
+}
+#endif
+
+/*-------------------------------------------------
+/  Resolve the hardware generation dependent
+/  behaviour of the hot paths (see genDispatch)
+/--------------------------------------------------*/
+static void core_init_gen_dispatch(void) {
+  const UINT64 gen = core_gameData->gen;
+  const int modulated = coreGlobals.nSolenoids && (options.usemodsol & (CORE_MODOUT_ENABLE_PHYSOUT_SOLENOIDS | CORE_MODOUT_ENABLE_MODSOL | CORE_MODOUT_FORCE_ON));
+  const int fliptronics = (gen & (GEN_WPCFLIPTRON | GEN_WPCDCS | GEN_WPCSECURITY | GEN_WPC95 | GEN_WPC95DCS)) != 0;
+  int solNo;
+
+  #define GEN_SOL(no, t, i, m) { genDispatch.sol[(no) - 1].type = (t); genDispatch.sol[(no) - 1].index = (UINT8)(i); genDispatch.sol[(no) - 1].mask = (m); }
+  #define GEN_SOL_MOD(no, i, t, m) { if (modulated) GEN_SOL(no, CORE_SOLSRC_PHYS, i, 0) else GEN_SOL(no, t, 0, m) }
+  memset(genDispatch.sol, 0, sizeof(genDispatch.sol));
+  for (solNo = 1; solNo <= 28; solNo++)
+    GEN_SOL_MOD(solNo, solNo - 1, CORE_SOLSRC_SOL, 1u << (solNo - 1))
+  for (solNo = 29; solNo <= 32; solNo++) {
+    if (gen & GEN_ALLS11)
+      GEN_SOL_MOD(solNo, solNo - 1, CORE_SOLSRC_SOL, 1u << (solNo - 1))
+    else if (gen & GEN_ALLWPC) // WPC GameOn
+      GEN_SOL(solNo, CORE_SOLSRC_SOL2, 0, 1u << (solNo - 29 + 8))
+  }
+  for (solNo = 33; solNo <= 36; solNo++) { // driver specific sols
+    if (gen & GEN_ALLWPC) { // WPC only: Upper flipper
+      if (fliptronics && modulated)
+        GEN_SOL(solNo, CORE_SOLSRC_PHYS, solNo - 1, 0)
+      else if ((solNo == sURFlip) && (core_gameData->hw.flippers & FLIP_SOL(FLIP_UR)))
+        GEN_SOL(solNo, CORE_SOLSRC_SOL2, 0, CORE_URFLIPSOLBITS)
+      else if ((solNo == sULFlip) && (core_gameData->hw.flippers & FLIP_SOL(FLIP_UL)))
+        GEN_SOL(solNo, CORE_SOLSRC_SOL2, 0, CORE_ULFLIPSOLBITS)
+      else
+        GEN_SOL(solNo, CORE_SOLSRC_SOL2, 0, 1u << (solNo - 33 + 4))
+    }
+    else if (gen & GEN_SAM) // SAM only: fake GameOn solenoid for fast flips
+      GEN_SOL(solNo, CORE_SOLSRC_SOL2, 0, 0x10)
+  }
+  for (solNo = 37; solNo <= 44; solNo++) { // WPC95 & S11 extra
+    if (gen & (GEN_WPC95|GEN_WPC95DCS)) // Duplicated in 37..40 / 41..44, so always read from 41..44 (hence the |4 in the index/mask)
+      GEN_SOL_MOD(solNo, (solNo - 13) | 4, CORE_SOLSRC_SOL, 1u << ((solNo - 13) | 4))
+    else if (gen & GEN_ALLS11)
+      GEN_SOL_MOD(solNo, 32 + solNo - 37 + 8, CORE_SOLSRC_SOL2, 1u << (solNo - 37 + 8))
+  }
+  for (solNo = 45; solNo <= 48; solNo++) { // Lower flippers
+    if (fliptronics && modulated)
+      GEN_SOL(solNo, CORE_SOLSRC_PHYS, solNo - 1, 0)
+    else /*-- Game must have lower flippers but for symmetry we check anyway --*/
+      GEN_SOL(solNo, CORE_SOLSRC_SOL2, 0, solNo == sLRFlip ? CORE_LRFLIPSOLBITS : solNo == sLLFlip ? CORE_LLFLIPSOLBITS : 1u << (solNo - 45))
   }
+  #undef GEN_SOL_MOD
+  #undef GEN_SOL
+
+  genDispatch.wpc = (gen & GEN_ALLWPC) != 0;
+  genDispatch.wpc95 = (gen & (GEN_WPC95 | GEN_WPC95DCS)) != 0;
+  genDispatch.sol33 = (gen & GEN_ALLWPC) ? CORE_SOL33_WPC : (gen & GEN_SAM) ? CORE_SOL33_SAM : (gen & GEN_ALLWS) ? CORE_SOL33_WS : CORE_SOL33_NONE;
+  genDispatch.sol37 = (gen & (GEN_ALLS11 | GEN_SAM | GEN_SPA)) != 0;
+  genDispatch.modFlippers = fliptronics && modulated;
+  genDispatch.reportPhysicSols = coreGlobals.nSolenoids &&
+    ((options.usemodsol & (CORE_MODOUT_ENABLE_PHYSOUT_SOLENOIDS | CORE_MODOUT_FORCE_ON)) || ((gen & (GEN_ALLWPC | GEN_SAM)) && (options.usemodsol & CORE_MODOUT_ENABLE_MODSOL)));
+  genDispatch.flipSwCol = (gen & (GEN_GTS3 | GEN_SPA | GEN_ALVG | GEN_ALVG_DMD2 | GEN_WICO)) ? 15 : CORE_FLIPPERSWCOL;
+
+  {
+    static const UINT8 lum4[] = { 0, 85, 170, 255 };
+    static const UINT8 lum16[] = { 0, 17, 34, 51, 68, 85, 102, 119, 136, 153, 170, 187, 204, 221, 238, 255 };
+    genDispatch.dmdDepth = (gen & (GEN_SAM | GEN_SPA | GEN_ALVG | GEN_ALVG_DMD2 | GEN_GTS3)) ? 4 : 2;
+    genDispatch.dmdBitplaneLum = (gen & GEN_SAM) ? NULL : (gen & GEN_SPA) ? lum16 : lum4;
+  }
+  genDispatch.dmdShadeFrame = dmd_shade_frame_c;
+  genDispatch.dmdLuminance = dmd_luminance_c;
+  #ifdef SSE_DMD_OPT
+  genDispatch.dmdShadeFrame = dmd_shade_frame_sse2;
+  genDispatch.dmdLuminance = dmd_luminance_sse2;
+  #endif
+  #ifdef AVX2_DMD_OPT
+  if (dmd_has_avx2())
+    genDispatch.dmdShadeFrame = dmd_shade_frame_avx2;
+  #endif
+  #if defined(VPINMAME) || defined(LIBPINMAME)
+  genDispatch.dmdExportRaw = (gen & (GEN_ALLWPC | GEN_GTS3 | GEN_ALVG_DMD2)) ? core_dmd_export_raw : NULL;
+  #endif
+}
+
+int core_dmd_bitplane_depth(void) {
+  return genDispatch.dmdDepth;
+}
+
+static void core_dmd_filter_pwm(core_tDMDPWMState* dmd_state) {
+  // Apply low pass filter over stored frames then scale down to final shades
+  void (* const shade_frame)(UINT32*, const UINT8*, const int, const UINT32, const int) = genDispatch.dmdShadeFrame;
+  void (* const luminance)(UINT8*, const UINT32*, const int, const UINT32) = genDispatch.dmdLuminance;
+  // The speed governor only keeps the central half of the taps (the largest weights), delaying the output by a quarter of the filter
+  const int fir_first = governor.level >= CORE_GOVERNOR_DMDFILTER ? dmd_state->fir_size / 4 : 0;
+  const int fir_last = dmd_state->fir_size - fir_first;
+  UINT32 fir_sum = dmd_state->fir_sum;
+  memset(dmd_state->shadedFrame, 0, dmd_state->width * dmd_state->height * sizeof(UINT32));
+  if (fir_first) {
+    UINT64 sum = 0;
+    for (int ii = fir_first; ii < fir_last; ii++)
+      sum += dmd_state->fir_weights[ii];
+    fir_sum = (UINT32)(sum / 255);
+  }
+  for (int ii = fir_first; ii < fir_last; ii++) {
+    const UINT8* frameData = dmd_state->rawFrames + ((dmd_state->nextFrame + (dmd_state->nFrames - 1) + (dmd_state->nFrames - ii)) % dmd_state->nFrames) * dmd_state->rawFrameSize;
+    shade_frame(dmd_state->shadedFrame, frameData, dmd_state->rawFrameSize, dmd_state->fir_weights[ii], dmd_state->revByte);
+  }
+  luminance(dmd_state->luminanceFrame, dmd_state->shadedFrame, dmd_state->frameSize, fir_sum);
 
   // Compute combined bitplane frames as they used to be for backward compatibility with colorization plugins
+  // Each raw byte is expanded through a table to its 8 dots (one byte per dot, packed in a UINT64), so summing
+  // frames adds 8 dots at once without carry between them (at most 12 frames are summed, see GTS3_5C).
   #if defined(VPINMAME) || defined(LIBPINMAME)
+  #define DMD_RAW_FRAME(n) (dmd_state->rawFrames + ((dmd_state->nextFrame + (dmd_state->nFrames - (n))) % dmd_state->nFrames) * dmd_state->rawFrameSize)
+  #define DMD_STORE_DOTS(kk, dots) { const UINT64 d_ = (dots); memcpy(&dmd_state->bitplaneFrame[(kk) * 8], &d_, 8); }
   switch (dmd_state->raw_combiner) {
   case CORE_DMD_PWM_COMBINER_GTS3_4C_A: // Reproduce previous (somewhat hacky) frame combiner used by GTS3 driver
   case CORE_DMD_PWM_COMBINER_GTS3_4C_B:
@@ -3149,141 +4243,98 @@ void core_dmd_update_pwm(core_tDMDPWMState* dmd_state) {
       const int nFrames = dmd_state->raw_combiner == CORE_DMD_PWM_COMBINER_GTS3_4C_A ? 6
                         : dmd_state->raw_combiner == CORE_DMD_PWM_COMBINER_GTS3_4C_B ? 8
                         :                         /* CORE_DMD_PWM_COMBINER_GTS3_5C */  12;
-      memset(dmd_state->bitplaneFrame, 0, dmd_state->frameSize);
-      for (int i = 1; i <= nFrames; i++)
-      {
-        UINT8* rawData = &dmd_state->bitplaneFrame[0];
-        const UINT8* frameData = dmd_state->rawFrames + ((dmd_state->nextFrame + (dmd_state->nFrames - i)) % dmd_state->nFrames) * dmd_state->rawFrameSize;
-        for (int kk = 0; kk < dmd_state->rawFrameSize; kk++)
-          for (UINT8 ll = 0, data = *frameData++; ll < 8; ll++, data <<= 1)
-            (*rawData++) += (data >> 7);
+      const UINT8* frames[12];
+      for (int i = 0; i < nFrames; i++)
+        frames[i] = DMD_RAW_FRAME(i + 1);
+      for (int kk = 0; kk < dmd_state->rawFrameSize; kk++) {
+        UINT64 dots = 0;
+        for (int i = 0; i < nFrames; i++)
+          dots += dmd_dots_msb[frames[i][kk]];
+        DMD_STORE_DOTS(kk, dots);
       }
       if (dmd_state->raw_combiner == CORE_DMD_PWM_COMBINER_GTS3_4C_A)
-        for (int kk = 0; kk < dmd_state->frameSize; kk++)
-          if (dmd_state->bitplaneFrame[kk] == 4) {
-            level = level4_a2;
-            break;
-          }
+        if (memchr(dmd_state->bitplaneFrame, 4, dmd_state->frameSize) != NULL)
+          level = level4_a2;
       for (int kk = 0; kk < dmd_state->frameSize; kk++)
         dmd_state->bitplaneFrame[kk] = level[dmd_state->bitplaneFrame[kk]];
     }
     break;
   case CORE_DMD_PWM_COMBINER_SUM_2: // Sum of the last 2 raw frames seen (WPC/Phantom Haus)
     {
-      UINT8* rawData = &dmd_state->bitplaneFrame[0];
-      const UINT8* const frame0 = dmd_state->rawFrames + ((dmd_state->nextFrame + (dmd_state->nFrames - 1)) % dmd_state->nFrames) * dmd_state->rawFrameSize;
-      const UINT8* const frame1 = dmd_state->rawFrames + ((dmd_state->nextFrame + (dmd_state->nFrames - 2)) % dmd_state->nFrames) * dmd_state->rawFrameSize;
-      for (int kk = 0; kk < dmd_state->rawFrameSize; kk++) {
-        const unsigned int intens1 = (frame0[kk] & 0x55) + (frame1[kk] & 0x55); // 0x55 = 01010101 binary mask
-        const unsigned int intens2 = (frame0[kk] & 0xaa) + (frame1[kk] & 0xaa); // 0xaa = 10101010 binary mask
-        *rawData++ =  intens1       & 0x03;
-        *rawData++ = (intens2 >> 1) & 0x03;
-        *rawData++ = (intens1 >> 2) & 0x03;
-        *rawData++ = (intens2 >> 3) & 0x03;
-        *rawData++ = (intens1 >> 4) & 0x03;
-        *rawData++ = (intens2 >> 5) & 0x03;
-        *rawData++ = (intens1 >> 6) & 0x03;
-        *rawData++ = (intens2 >> 7) & 0x03;
-      }
+      const UINT8* const frame0 = DMD_RAW_FRAME(1);
+      const UINT8* const frame1 = DMD_RAW_FRAME(2);
+      for (int kk = 0; kk < dmd_state->rawFrameSize; kk++)
+        DMD_STORE_DOTS(kk, dmd_dots_lsb[frame0[kk]] + dmd_dots_lsb[frame1[kk]]);
     }
     break;
   case CORE_DMD_PWM_COMBINER_SUM_3: // Sum of the last 3 raw frames seen (WPC)
     {
-      UINT8* rawData = &dmd_state->bitplaneFrame[0];
-      const UINT8* const frame0 = dmd_state->rawFrames + ((dmd_state->nextFrame + (dmd_state->nFrames - 1)) % dmd_state->nFrames) * dmd_state->rawFrameSize;
-      const UINT8* const frame1 = dmd_state->rawFrames + ((dmd_state->nextFrame + (dmd_state->nFrames - 2)) % dmd_state->nFrames) * dmd_state->rawFrameSize;
-      const UINT8* const frame2 = dmd_state->rawFrames + ((dmd_state->nextFrame + (dmd_state->nFrames - 3)) % dmd_state->nFrames) * dmd_state->rawFrameSize;
-      for (int kk = 0; kk < dmd_state->rawFrameSize; kk++) {
-        const unsigned int intens1 = (frame0[kk] & 0x55) + (frame1[kk] & 0x55) + (frame2[kk] & 0x55); // 0x55 = 01010101 binary mask
-        const unsigned int intens2 = (frame0[kk] & 0xaa) + (frame1[kk] & 0xaa) + (frame2[kk] & 0xaa); // 0xaa = 10101010 binary mask
-        *rawData++ =  intens1       & 0x03;
-        *rawData++ = (intens2 >> 1) & 0x03;
-        *rawData++ = (intens1 >> 2) & 0x03;
-        *rawData++ = (intens2 >> 3) & 0x03;
-        *rawData++ = (intens1 >> 4) & 0x03;
-        *rawData++ = (intens2 >> 5) & 0x03;
-        *rawData++ = (intens1 >> 6) & 0x03;
-        *rawData++ = (intens2 >> 7) & 0x03;
-      }
+      const UINT8* const frame0 = DMD_RAW_FRAME(1);
+      const UINT8* const frame1 = DMD_RAW_FRAME(2);
+      const UINT8* const frame2 = DMD_RAW_FRAME(3);
+      for (int kk = 0; kk < dmd_state->rawFrameSize; kk++)
+        DMD_STORE_DOTS(kk, dmd_dots_lsb[frame0[kk]] + dmd_dots_lsb[frame1[kk]] + dmd_dots_lsb[frame2[kk]]);
     }
     break;
   case CORE_DMD_PWM_COMBINER_SUM_2_1: // high bit for double length frame, low bit for single length frame
   case CORE_DMD_PWM_COMBINER_SUM_1_2:
     {
-      UINT8 *rawData = &dmd_state->bitplaneFrame[0];
       const UINT8 *frame0, *frame1;
       if (dmd_state->raw_combiner == CORE_DMD_PWM_COMBINER_SUM_2_1) { // double length frame are the 2 before last one, single length frame is the last one (Data East 128x32, Sega/Stern Whitestar)
-        frame0 = dmd_state->rawFrames + ((dmd_state->nextFrame + (dmd_state->nFrames - 2)) % dmd_state->nFrames) * dmd_state->rawFrameSize;
-        frame1 = dmd_state->rawFrames + ((dmd_state->nextFrame + (dmd_state->nFrames - 1)) % dmd_state->nFrames) * dmd_state->rawFrameSize;
+        frame0 = DMD_RAW_FRAME(2);
+        frame1 = DMD_RAW_FRAME(1);
       }
       else { //if (dmd_state->raw_combiner == CORE_DMD_PWM_COMBINER_SUM_1_2) { // double length frame are the 2 last ones, single length frame is the one before (Data East 128x16)
-        frame0 = dmd_state->rawFrames + ((dmd_state->nextFrame + (dmd_state->nFrames - 1)) % dmd_state->nFrames) * dmd_state->rawFrameSize;
-        frame1 = dmd_state->rawFrames + ((dmd_state->nextFrame + (dmd_state->nFrames - 3)) % dmd_state->nFrames) * dmd_state->rawFrameSize;
-      }
-      for (int kk = 0; kk < dmd_state->rawFrameSize; kk++) {
-        const unsigned int intens1 = 2*(frame0[kk] & 0x55) + (frame1[kk] & 0x55);   // 0x55 = 01010101 binary mask
-        const unsigned int intens2 =   (frame0[kk] & 0xaa) + (frame1[kk] & 0xaa)/2; // 0xaa = 10101010 binary mask
-        *rawData++ = (intens2 >> 6) & 0x03;
-        *rawData++ = (intens1 >> 6) & 0x03;
-        *rawData++ = (intens2 >> 4) & 0x03;
-        *rawData++ = (intens1 >> 4) & 0x03;
-        *rawData++ = (intens2 >> 2) & 0x03;
-        *rawData++ = (intens1 >> 2) & 0x03;
-        *rawData++ =  intens2       & 0x03;
-        *rawData++ =  intens1       & 0x03;
+        frame0 = DMD_RAW_FRAME(1);
+        frame1 = DMD_RAW_FRAME(3);
       }
+      for (int kk = 0; kk < dmd_state->rawFrameSize; kk++)
+        DMD_STORE_DOTS(kk, 2 * dmd_dots_msb[frame0[kk]] + dmd_dots_msb[frame1[kk]]);
     }
     break;
   case CORE_DMD_PWM_COMBINER_SUM_4: // Sum of the last 4 frames (Alvin G. for Pistol Poker & Mystery Castle)
     {
+      // Note that the 3rd frame has never been part of the sum: this is kept as is, since existing colorizations rely on it
       static const UINT8 level[5] = { 0, 3, 7, 11, 15 }; // brightness mapping 0,25,50,75,100% (backward compatible to encode 5 levels on 4 bits)
-      UINT8* rawData = &dmd_state->bitplaneFrame[0];
-      const UINT8* const frame0 = dmd_state->rawFrames + ((dmd_state->nextFrame + (dmd_state->nFrames - 1)) % dmd_state->nFrames) * dmd_state->rawFrameSize;
-      const UINT8* const frame1 = dmd_state->rawFrames + ((dmd_state->nextFrame + (dmd_state->nFrames - 2)) % dmd_state->nFrames) * dmd_state->rawFrameSize;
-      const UINT8* const frame2 = dmd_state->rawFrames + ((dmd_state->nextFrame + (dmd_state->nFrames - 3)) % dmd_state->nFrames) * dmd_state->rawFrameSize;
-      const UINT8* const frame3 = dmd_state->rawFrames + ((dmd_state->nextFrame + (dmd_state->nFrames - 4)) % dmd_state->nFrames) * dmd_state->rawFrameSize;
-      for (int kk = 0; kk < dmd_state->rawFrameSize; kk++) {
-        UINT8 v0 = frame0[kk], v1 = frame1[kk], v2 = frame2[kk], v3 = frame3[kk];
-        for (int ii = 0; ii < 8; ii++, v0 <<= 1, v1 <<= 1, v2 <<= 1, v3 <<= 1)
-          *rawData++ = level[((v0 >> 7) & 0x01) + ((v1 >> 7) & 0x01) + ((v1 >> 7) & 0x02) + ((v3 >> 7) & 0x01)];
-      }
+      const UINT8* const frame0 = DMD_RAW_FRAME(1);
+      const UINT8* const frame1 = DMD_RAW_FRAME(2);
+      const UINT8* const frame3 = DMD_RAW_FRAME(4);
+      for (int kk = 0; kk < dmd_state->rawFrameSize; kk++)
+        DMD_STORE_DOTS(kk, dmd_dots_msb[frame0[kk]] + dmd_dots_msb[frame1[kk]] + dmd_dots_msb[frame3[kk]]);
+      for (int kk = 0; kk < dmd_state->frameSize; kk++)
+        dmd_state->bitplaneFrame[kk] = level[dmd_state->bitplaneFrame[kk]];
     }
     break;
   default:
     assert(0); // Unsupported combiner
   }
-  #endif
-
-  // For GTS3, WPC and Alvin G. 2 also store raw single bitplane frame for backward compatibility with colorization plugins
-  // TODO move these data to dmd_state struct (for cleanup and to fix multiple DMD support for GTS3 Strikes N' Spares)
-  #if defined(VPINMAME) || defined(LIBPINMAME)
-  if (core_gameData->gen & (GEN_ALLWPC | GEN_GTS3 | GEN_ALVG_DMD2)) {
-    raw_dmd_frame_count = dmd_state->nFrames > CORE_MAX_RAW_DMD_FRAMES ? CORE_MAX_RAW_DMD_FRAMES : dmd_state->nFrames;
-    UINT8* rawData = &raw_dmd_frames[0];
-    for (int frame = 0; frame < (int)raw_dmd_frame_count; frame++) {
-      const UINT8* frameData = dmd_state->rawFrames + ((dmd_state->nextFrame + (dmd_state->nFrames - 1) + (dmd_state->nFrames - frame)) % dmd_state->nFrames) * dmd_state->rawFrameSize;
-      for (int jj = 0; jj < dmd_state->rawFrameSize; jj++) {
-        *rawData = dmd_state->revByte ? (*frameData++) : core_revbyte(*frameData++);
-        rawData++;
-      }
-    }
-  }
-  else {
-    raw_dmd_frame_count = 0;
-  }
+  #undef DMD_RAW_FRAME
+  #undef DMD_STORE_DOTS
   #endif
 }
 
 // Render to internal display, using provided luminance, if there is a visible display (PinMAME always, and VPinMAME when its window is shown)
 // FIXME apply colors LUT ?
 #if defined(PINMAME) || defined(VPINMAME)
+// Luminance to DMD pen and to AA shade, built on first use to avoid 2 divides per dot and frame
+static BMTYPE dmdLumPen[256];
+static UINT8 dmdLumTrafoAA[256];
+static int dmdLumLUTValid = 0;
+
 void core_dmd_render_internal(struct mame_bitmap *bitmap, const int x, const int y, const int width, const int height, const UINT8* const dmdDotLum, const int apply_aa) {
   #define DMD_OFS(row, col) ((row)*width + (col))
+  if (!dmdLumLUTValid) {
+    for (int ii = 0; ii < 256; ii++) {
+      dmdLumPen[ii] = DMD_PAL(ii);
+      dmdLumTrafoAA[ii] = (UINT8)TRAFO_AA(ii);
+    }
+    dmdLumLUTValid = 1;
+  }
   BMTYPE **lines = ((BMTYPE **)bitmap->line) + (y * locals.displaySize);
   for (int ii = 0; ii < height; ii++) {
     BMTYPE *line = (*lines) + (x * locals.displaySize);
     for (int jj = 0; jj < width; jj++) {
-      *line = DMD_PAL(dmdDotLum[DMD_OFS(ii, jj)]);
+      *line = dmdLumPen[dmdDotLum[DMD_OFS(ii, jj)]];
       line += locals.displaySize;
     }
     lines += locals.displaySize;
@@ -3295,33 +4346,47 @@ void core_dmd_render_internal(struct mame_bitmap *bitmap, const int x, const int
   // Note that pixels which are off are always counted as contributing 0 (so NOT the 'off-color/brightness')
   assert((locals.displaySize == 1) || (locals.displaySize == 2));
   if (apply_aa && locals.displaySize == 2) {
+    // The filter only ever sums 2 or 4 transformed dots, so precompute the resulting pens once per frame (index is the sum
+    // of TRAFO_AA values, 0 is off), and the transformed dots once per row, instead of doing it per output pixel
+    BMTYPE aaSide[2*47+1], aaCorner[4*47+1];
+    UINT8 trafo[2][DMD_MAXX], colSum[DMD_MAXX];
+    aaSide[0] = aaCorner[0] = 0;
+    for (unsigned int ii = 1; ii < sizeof(aaCorner)/sizeof(aaCorner[0]); ii++) {
+      if (ii < sizeof(aaSide)/sizeof(aaSide[0]))
+        aaSide[ii] = DMD_AA_PAL(ii * pmoptions.dmd_antialias,2,16u*100 /3u); // /3 = heuristic to kinda match old AA behavior
+      aaCorner[ii] = DMD_AA_PAL(ii * pmoptions.dmd_antialias,1,16u*100 /3u);
+    }
+    assert(width <= DMD_MAXX);
+    for (int jj = 0; jj < width; jj++)
+      trafo[0][jj] = dmdLumTrafoAA[dmdDotLum[DMD_OFS(0, jj)]];
     lines = ((BMTYPE **)bitmap->line) + (y * 2);
-    for (int ii = 0; ii < height * 2 - 1; ii++) {
-      const int pi = (ii - 1) >> 1;
-      BMTYPE *line = (*lines) + (x * 2);
-      for (int jj = 0; jj < width * 2 - 1; jj++) {
-        const int pj = (jj - 1) >> 1;
-        if ((ii & 1) & (jj & 1)) { // Corner point
-          // x 0 x
-          // 0 0 0
-          // x 0 x
-          const UINT32 lum = TRAFO_AA(dmdDotLum[DMD_OFS(pi, pj)]) + TRAFO_AA(dmdDotLum[DMD_OFS(pi+1, pj)]) + TRAFO_AA(dmdDotLum[DMD_OFS(pi, pj+1)]) + TRAFO_AA(dmdDotLum[DMD_OFS(pi+1, pj+1)]);
-          *line = lum == 0 ? 0 : DMD_AA_PAL(lum * pmoptions.dmd_antialias,1,16u*100 /3u); // /3 = heuristic to kinda match old AA behavior
-        } else if (ii & 1) { // Vertical side point
-          // 0 x 0
-          // 0 0 0
-          // 0 x 0
-          const UINT32 lum = TRAFO_AA(dmdDotLum[DMD_OFS(pi, pj+1)]) + TRAFO_AA(dmdDotLum[DMD_OFS(pi+1, pj+1)]);
-          *line = lum == 0 ? 0 : DMD_AA_PAL(lum * pmoptions.dmd_antialias,2,16u*100 /3u); // /3 = heuristic to kinda match old AA behavior
-        } else if (jj & 1) { // Horizontal side point
-          // 0 0 0
-          // x 0 x
-          // 0 0 0
-          const UINT32 lum = TRAFO_AA(dmdDotLum[DMD_OFS(pi+1, pj)]) + TRAFO_AA(dmdDotLum[DMD_OFS(pi+1, pj+1)]);
-          *line = lum == 0 ? 0 : DMD_AA_PAL(lum * pmoptions.dmd_antialias,2,16u*100 /3u); // /3 = heuristic to kinda match old AA behavior
-        }
-        line++;
+    for (int ii = 0; ii < height; ii++) {
+      const UINT8* const cur = trafo[ii & 1];
+      UINT8* const next = trafo[(ii & 1) ^ 1];
+      // Horizontal side points (between 2 dots on a dot row)
+      // 0 0 0
+      // x 0 x
+      // 0 0 0
+      BMTYPE *line = (*lines) + (x * 2) + 1;
+      for (int jj = 0; jj < width - 1; jj++, line += 2)
+        *line = aaSide[cur[jj] + cur[jj + 1]];
+      lines++;
+      if (ii == height - 1)
+        break;
+      for (int jj = 0; jj < width; jj++) {
+        next[jj] = dmdLumTrafoAA[dmdDotLum[DMD_OFS(ii + 1, jj)]];
+        colSum[jj] = cur[jj] + next[jj];
+      }
+      // Vertical side points (between 2 dot rows) and corner points
+      // 0 x 0   x 0 x
+      // 0 0 0   0 0 0
+      // 0 x 0   x 0 x
+      line = (*lines) + (x * 2);
+      for (int jj = 0; jj < width - 1; jj++, line += 2) {
+        line[0] = aaSide[colSum[jj]];
+        line[1] = aaCorner[colSum[jj] + colSum[jj + 1]];
       }
+      line[0] = aaSide[colSum[width - 1]];
       lines++;
     }
   }
@@ -3329,56 +4394,115 @@ void core_dmd_render_internal(struct mame_bitmap *bitmap, const int x, const int
 }
 #endif
 
-// Prepare data for VPinMAME interface, using computed luminance and applying user LUT for luminance/color (Controller.RawDmdPixels / Controller.RawColoredDmdPixels)
+// Colorization of the main DMD, computed once per changed frame in g_raw_colordmdbuffer and shared by VPinMAME
+// (Controller.RawColoredDmdPixels) and LibPinMAME (PINMAME_DMD_MODE_COLOR). Without palette triggers, or until one
+// matched, colors come from the user LUT applied to the luminance. When the bitplane frame matches a trigger hash, its
+// palette is applied to the bitplane shades, until another trigger matches (like colorization palette switches).
+#if defined(VPINMAME) || defined(LIBPINMAME)
+// 64 bit FNV-1a of the bitplane frame (one byte per dot), stable accross PinMAME builds unlike the luminance hash
+UINT64 core_dmd_bitplane_hash(const int width, const int height, const UINT8* const dmdDotRaw) {
+  UINT64 hash = 0xcbf29ce484222325ull;
+  for (int ii = 0; ii < width * height; ii++)
+    hash = (hash ^ dmdDotRaw[ii]) * 0x100000001b3ull;
+  return hash;
+}
+
+// Add (or replace) a palette trigger, returns 0 if the table is full or the number of colors is not supported
+int core_dmd_add_palette_trigger(const UINT64 bitplaneHash, const UINT32* const colors, const int nColors) {
+  int ii;
+  if (nColors != 4 && nColors != 16)
+    return 0;
+  for (ii = 0; ii < dmdPalettes.count; ii++)
+    if (dmdPalettes.hash[ii] == bitplaneHash)
+      break;
+  if (ii == CORE_DMD_MAX_PALETTE_TRIGGERS)
+    return 0;
+  dmdPalettes.hash[ii] = bitplaneHash;
+  dmdPalettes.nColors[ii] = nColors;
+  memcpy(dmdPalettes.colors[ii], colors, nColors * sizeof(UINT32));
+  if (ii == dmdPalettes.count)
+    dmdPalettes.count++;
+  return 1;
+}
+
+void core_dmd_clear_palette_triggers(void) {
+  dmdPalettes.count = 0;
+  dmdPalettes.active = -1;
+}
+
+static void core_dmd_colorize(const int width, const int height, const UINT8* const dmdDotLum, const UINT8* const dmdDotRaw) {
+  const int size = width * height;
+  UINT32* rawCol = g_raw_colordmdbuffer;
+  if (dmdPalettes.count) {
+    const UINT64 hash = core_dmd_bitplane_hash(width, height, dmdDotRaw);
+    for (int ii = 0; ii < dmdPalettes.count; ii++)
+      if (dmdPalettes.hash[ii] == hash) {
+        dmdPalettes.active = ii;
+        break;
+      }
+  }
+  if (dmdPalettes.active >= 0) {
+    const UINT32* const colors = dmdPalettes.colors[dmdPalettes.active];
+    // 4 colors palettes applied to 16 shades DMDs use the 2 high bits of the shade
+    const int shift = dmdPalettes.nColors[dmdPalettes.active] == 4 && genDispatch.dmdDepth == 4 ? 2 : 0;
+    const int mask = dmdPalettes.nColors[dmdPalettes.active] - 1;
+    for (int ii = 0; ii < size; ii++)
+      (*rawCol++) = colors[(dmdDotRaw[ii] >> shift) & mask];
+  }
+  else {
+    for (int ii = 0; ii < size; ii++)
+      (*rawCol++) = locals.vpm_dmd_color_lut[dmdDotLum[ii]];
+  }
+}
+#endif
+
+// Prepare data for VPinMAME interface, using computed luminance and applying user LUT for luminance (Controller.RawDmdPixels)
 #ifdef VPINMAME
-void core_dmd_render_vpm(const int width, const int height, const UINT8* const dmdDotLum) {
+void core_dmd_render_vpm(const int width, const int height, const UINT8* const dmdDotLum, const UINT64 frameHash, const UINT64 dirtyRows) {
   const int size = width * height;
   g_raw_dmdx = width;
   g_raw_dmdy = height;
-  if (memcmp(locals.vpm_dmd_last_lum, dmdDotLum, size) != 0) {
-    memcpy(locals.vpm_dmd_last_lum, dmdDotLum, size);
+  if (dirtyRows) {
     UINT8* rawLum = g_raw_dmdbuffer;
-    UINT32* rawCol = g_raw_colordmdbuffer;
-    for (int ii = 0; ii < size; ii++) {
-      const UINT8 lum = dmdDotLum[ii];
-      (*rawLum++) = locals.vpm_dmd_luminance_lut[lum];
-      (*rawCol++) = locals.vpm_dmd_color_lut[lum];
-    }
+    for (int ii = 0; ii < size; ii++)
+      (*rawLum++) = locals.vpm_dmd_luminance_lut[dmdDotLum[ii]];
+    g_raw_dmd_hash = frameHash;
+    g_raw_dmd_dirty_rows |= dirtyRows;
     g_needs_DMD_update = 1;
+    core_latencyStart(CORE_LATENCY_DMD, -1);
   }
 }
 #endif
 
 // Prepare data for LibPinMAME interface (similar to VPinMAME but without color LUT, and with a global flag to select luminance/bitplanes)
 #ifdef LIBPINMAME
-void core_dmd_render_lpm(const int width, const int height, const UINT8* const dmdDotLum, const UINT8* const dmdDotRaw) {
+void core_dmd_render_lpm(const int width, const int height, const UINT8* const dmdDotLum, const UINT8* const dmdDotRaw, const UINT64 frameHash, const UINT64 dirtyRows) {
   const int size = width * height;
   g_raw_dmdx = width;
   g_raw_dmdy = height;
+  if (dirtyRows == 0)
+    return;
   if (g_fDmdMode == 0) { // PINMAME_DMD_MODE_BRIGHTNESS
-    if (memcmp(locals.vpm_dmd_last_lum, dmdDotLum, size) != 0) {
-      memcpy(locals.vpm_dmd_last_lum, dmdDotLum, size);
-      UINT8* rawLum = g_raw_dmdbuffer;
-      for (int ii = 0; ii < size; ii++)
-        (*rawLum++) = locals.vpm_dmd_luminance_lut[dmdDotLum[ii]];
-      g_needs_DMD_update = 1;
-    }
-  }
-  else if (g_fDmdMode == 1) {// PINMAME_DMD_MODE_RAW
-    if (memcmp(g_raw_dmdbuffer, dmdDotRaw, size) != 0) {
-      memcpy(g_raw_dmdbuffer, dmdDotRaw, size);
-      g_needs_DMD_update = 1;
-    }
+    UINT8* rawLum = g_raw_dmdbuffer;
+    for (int ii = 0; ii < size; ii++)
+      (*rawLum++) = locals.vpm_dmd_luminance_lut[dmdDotLum[ii]];
   }
+  else if (g_fDmdMode == 1) // PINMAME_DMD_MODE_RAW
+    memcpy(g_raw_dmdbuffer, dmdDotRaw, size);
+  // PINMAME_DMD_MODE_COLOR frames are in g_raw_colordmdbuffer, filled by core_dmd_colorize
+  g_raw_dmd_hash = frameHash;
+  g_raw_dmd_dirty_rows |= dirtyRows;
+  g_needs_DMD_update = 1;
+  core_latencyStart(CORE_LATENCY_DMD, -1);
 }
 #endif
 
 // Send main DMD to dmddevice plugins
 #ifdef VPINMAME
-void core_dmd_render_dmddevice(const int width, const int height, const UINT8* const dmdDotLum, const UINT8* const dmdDotRaw, const int isDMD2) {
+void core_dmd_render_dmddevice(const int width, const int height, const UINT8* const dmdDotLum, const UINT8* const dmdDotRaw, const int rawFrameCount, const UINT8* const rawFrame, const int isDMD2) {
   if (g_fShowPinDMD) {
     const int isStrikesNSpares = strncasecmp(Machine->gamedrv->name, "snspare", 7) == 0;
-    dmddeviceRenderDMDFrame(width, height, dmdDotLum, dmdDotRaw, raw_dmd_frame_count, raw_dmd_frames, isStrikesNSpares ? (isDMD2 ? 2 : 1) : 3);
+    dmddeviceRenderDMDFrame(width, height, dmdDotLum, dmdDotRaw, rawFrameCount, (UINT8*)rawFrame, isStrikesNSpares ? (isDMD2 ? 2 : 1) : 3);
   }
 }
 #endif
@@ -3387,75 +4511,98 @@ void core_dmd_render_dmddevice(const int width, const int height, const UINT8* c
 // DMD frame capture can be enabled either by:
 // - setting g_fDumpFrames (not supported as it is only available through keyboard input which VPinMame doesn't have)
 // - setting g_fShowPinDMD (enable dmddevice.dll) and g_fShowWinDMD (enable VPinMAME rendering) simultaneously
-// TODO this is not yet implemented for Strikes N' Spares which has 2 DMDs
+// The second DMD of Strikes N' Spares is captured to its own files, suffixed with '_2'
+// Capture files stay open with a large stdio buffer until the machine stops (or capture gets disabled), since
+// captures for colorization run for hours and reopening them for each frame hurts frame pacing.
 #ifdef VPINMAME
-void core_dmd_capture_frame(const int width, const int height, const UINT8* const dmdDotRaw, const int rawFrameCount, const UINT8* const rawFrame) {
-  const int isStrikeNSpares = strncasecmp(Machine->gamedrv->name, "snspare", 7) == 0;
-  if (!isStrikeNSpares && (g_fDumpFrames || (g_fShowPinDMD && g_fShowWinDMD))) {
+#define CORE_DMD_CAPTURE_BUFFER (256 * 1024)
+static FILE* dmdCaptureRaw[2]; // .raw file of each DMD (single bitplane raw frames)
+static FILE* dmdCaptureTxt[2]; // .txt file of each DMD (combined bitplane frames)
+
+static FILE* core_dmd_capture_open(const char* filename, const char* mode) {
+  FILE* f = fopen(filename, mode);
+  if (f) {
+    setvbuf(f, NULL, _IOFBF, CORE_DMD_CAPTURE_BUFFER);
+    fseek(f, 0, SEEK_END);
+  }
+  return f;
+}
+
+void core_dmd_capture_close(void) {
+  for (int ii = 0; ii < 2; ii++) {
+    if (dmdCaptureRaw[ii])
+      fclose(dmdCaptureRaw[ii]);
+    if (dmdCaptureTxt[ii])
+      fclose(dmdCaptureTxt[ii]);
+    dmdCaptureRaw[ii] = dmdCaptureTxt[ii] = NULL;
+  }
+}
+
+void core_dmd_capture_frame(const int width, const int height, const UINT8* const dmdDotRaw, const int rawFrameCount, const UINT8* const rawFrame, const int isDMD2) {
+  const int dmd = isDMD2 != 0;
+  if (g_fDumpFrames || (g_fShowPinDMD && g_fShowWinDMD)) {
     char *ptr;
     char DumpFilename[MAX_PATH];
     const DWORD tick = GetTickCount();
-    #ifndef _WIN64
-      const HINSTANCE hInst = GetModuleHandle("VPinMAME.dll");
-    #else
-      const HINSTANCE hInst = GetModuleHandle("VPinMAME64.dll");
-    #endif
-    GetModuleFileName(hInst, DumpFilename, MAX_PATH);
-    ptr = strrchr(DumpFilename, '\\');
-    strcpy_s(ptr + 1, 11, "DmdDump\\");
-    strcat_s(DumpFilename, MAX_PATH, Machine->gamedrv->name);
+    if (dmdCaptureRaw[dmd] == NULL || dmdCaptureTxt[dmd] == NULL) {
+      #ifndef _WIN64
+        const HINSTANCE hInst = GetModuleHandle("VPinMAME.dll");
+      #else
+        const HINSTANCE hInst = GetModuleHandle("VPinMAME64.dll");
+      #endif
+      GetModuleFileName(hInst, DumpFilename, MAX_PATH);
+      ptr = strrchr(DumpFilename, '\\');
+      strcpy_s(ptr + 1, 11, "DmdDump\\");
+      strcat_s(DumpFilename, MAX_PATH, Machine->gamedrv->name);
+      if (isDMD2)
+        strcat_s(DumpFilename, MAX_PATH, "_2");
+    }
 
     // Additional single bitplane raw frames for GTS3, WPC and Alvin G.
     if (rawFrameCount != 0) {
-      FILE* fr;
-      char RawFilename[MAX_PATH];
-      strcpy_s(RawFilename, MAX_PATH, DumpFilename);
-      strcat_s(RawFilename, MAX_PATH, ".raw");
-      fr = fopen(RawFilename, "rb");
-      if (fr) {
-        fclose(fr);
-        fr = fopen(RawFilename, "ab");
-      }
-      else {
-        fr = fopen(RawFilename, "ab");
-        if (fr) {
-          fputc(0x52, fr);
-          fputc(0x41, fr);
-          fputc(0x57, fr);
-          fputc(0x00, fr);
-          fputc(0x01, fr);
-          fputc(width, fr);
-          fputc(height, fr);
-          fputc(rawFrameCount, fr);
+      if (dmdCaptureRaw[dmd] == NULL) {
+        char RawFilename[MAX_PATH];
+        strcpy_s(RawFilename, MAX_PATH, DumpFilename);
+        strcat_s(RawFilename, MAX_PATH, ".raw");
+        dmdCaptureRaw[dmd] = core_dmd_capture_open(RawFilename, "ab");
+        if (dmdCaptureRaw[dmd] && ftell(dmdCaptureRaw[dmd]) == 0) {
+          const UINT8 header[] = { 0x52, 0x41, 0x57, 0x00, 0x01, (UINT8)width, (UINT8)height, (UINT8)rawFrameCount };
+          fwrite(header, 1, sizeof(header), dmdCaptureRaw[dmd]);
         }
       }
-      if (fr) {
-        fwrite(&tick, 1, 4, fr);
-        fwrite(rawFrame, 1, (width * height / 8 * rawFrameCount), fr);
-        fclose(fr);
+      if (dmdCaptureRaw[dmd]) {
+        fwrite(&tick, 1, 4, dmdCaptureRaw[dmd]);
+        fwrite(rawFrame, 1, (width * height / 8 * rawFrameCount), dmdCaptureRaw[dmd]);
       }
     }
 
     // Bitplane frame combined from PWM pattern of raw frames
-    static UINT8 lastCapture[DMD_MAXX * DMD_MAXY] = { 0 };
-    if (memcmp(lastCapture, dmdDotRaw, width * height) != 0)
+    static UINT8 lastCapture[2][DMD_MAXX * DMD_MAXY] = { 0 };
+    if (memcmp(lastCapture[dmd], dmdDotRaw, width * height) != 0)
     {
-       FILE *f;
-       memcpy(lastCapture, dmdDotRaw, width * height);
-       strcat_s(DumpFilename, MAX_PATH, ".txt");
-       f = fopen(DumpFilename, "a");
-       if (f) {
-          fprintf(f, "0x%08x\n", tick);
+       memcpy(lastCapture[dmd], dmdDotRaw, width * height);
+       if (dmdCaptureTxt[dmd] == NULL) {
+          strcat_s(DumpFilename, MAX_PATH, ".txt");
+          dmdCaptureTxt[dmd] = core_dmd_capture_open(DumpFilename, "a");
+       }
+       if (dmdCaptureTxt[dmd]) {
+          // Format the whole frame (one hex digit per dot), then write it at once
+          static const char hex[] = "0123456789abcdef";
+          char frame[11 + DMD_MAXY * (DMD_MAXX + 1) + 1];
+          char* txt = frame + sprintf(frame, "0x%08x\n", tick);
           for (int jj = 0; jj < height; jj++) {
+             const UINT8* const row = dmdDotRaw + jj * width;
              for (int ii = 0; ii < width; ii++)
-                fprintf(f, "%01x", dmdDotRaw[jj * width + ii]);
-             fprintf(f, "\n");
+                *txt++ = hex[row[ii] & 0x0F];
+             *txt++ = '\n';
           }
-          fprintf(f, "\n");
-          fclose(f);
+          *txt++ = '\n';
+          fwrite(frame, 1, txt - frame, dmdCaptureTxt[dmd]);
        }
     }
   }
+  else if (dmdCaptureRaw[dmd] || dmdCaptureTxt[dmd])
+    core_dmd_capture_close();
 }
 #endif
 
@@ -3470,35 +4617,63 @@ void core_dmd_video_update(struct mame_bitmap *bitmap, const struct rectangle *c
   else { // Only bitplane state: consider luminance equal to (scaled) bitplane output
     dmdDotRaw = &coreGlobals.dmdDotRaw[0];
     dmdDotLum = &coreGlobals.dmdDotLum[0];
-    if ((core_gameData->gen & GEN_SAM) == 0) {
-      static const UINT8 lum4[] = { 0, 85, 170, 255 };
-      static const UINT8 lum16[] = { 0, 17, 34, 51, 68, 85, 102, 119, 136, 153, 170, 187, 204, 221, 238, 255 };
-      const UINT8* const lum = (core_gameData->gen & GEN_SPA) != 0 ? lum16 : lum4;
+    if (genDispatch.dmdBitplaneLum) {
+      const UINT8* const lum = genDispatch.dmdBitplaneLum;
       for (int ii = 0; ii < layout->length * layout->start; ii++)
         dmdDotLum[ii] = lum[dmdDotRaw[ii]];
     }
   }
 
-  #if defined(LIBPINMAME)
+  #if defined(VPINMAME) || defined(LIBPINMAME)
+    // Hash and changed rows, computed by core_dmd_update_pwm for PWM state, or here for drivers that only provide a bitplane frame
+    UINT64 frameHash, dirtyRows = 0;
     const int isMainDMD = layout->length >= 128; // Up to 2 main DMDs (1 for all games, except Strikes N' Spares which has 2)
+    if (dmd_state) {
+      frameHash = dmd_state->frameHash;
+      dirtyRows = dmd_state->dirtyRows;
+      dmd_state->dirtyRows = 0;
+    }
+    else if (isMainDMD)
+      frameHash = core_dmd_hash_frame(layout->length, layout->start, dmdDotLum, dmdDotRaw, locals.vpm_dmd_row_hashes[layout->top != 0], &dirtyRows);
+  #endif
+
+  #if defined(VPINMAME) || defined(LIBPINMAME)
+    // Colorize once for all consumers (LibPinMAME only needs it when colored frames are requested)
+    #if defined(LIBPINMAME)
+    if (isMainDMD && dirtyRows && g_fDmdMode == 2) // PINMAME_DMD_MODE_COLOR
+    #else
+    if (isMainDMD && dirtyRows)
+    #endif
+      core_dmd_colorize(layout->length, layout->start, dmdDotLum, dmdDotRaw);
+    if (isMainDMD)
+      netpub_dmd(layout->top != 0, layout->length, layout->start, dmdDotLum, dmdDotRaw, frameHash, dirtyRows);
+  #endif
+
+  #if defined(LIBPINMAME)
     if (isMainDMD) {
-      core_dmd_render_lpm(layout->length, layout->start, dmdDotLum, dmdDotRaw);
+      core_dmd_render_lpm(layout->length, layout->start, dmdDotLum, dmdDotRaw, frameHash, dirtyRows);
+      libpinmame_golden_dmd(dmdDotLum, dmdDotRaw, layout->length * layout->start);
       has_DMD_Video = 1;
     }
 
   #elif defined(VPINMAME)
-    const int isMainDMD = layout->length >= 128; // Up to 2 main DMDs (1 for all games, except Strikes N' Spares which has 2)
     // FIXME check for VPinMame window hidden/shown state, and do not render if hidden
-    core_dmd_render_internal(bitmap, layout->left, layout->top, layout->length, layout->start, dmdDotLum, pmoptions.dmd_antialias && !(layout->type & CORE_DMDNOAA));
+    if (governor.level < CORE_GOVERNOR_DMDRENDER || (cpu_getcurrentframe() & 1))
+      core_dmd_render_internal(bitmap, layout->left, layout->top, layout->length, layout->start, dmdDotLum, pmoptions.dmd_antialias && !(layout->type & CORE_DMDNOAA));
     if (isMainDMD) {
       has_DMD_Video = 1;
-      core_dmd_render_vpm(layout->length, layout->start, dmdDotLum);
-      core_dmd_render_dmddevice(layout->length, layout->start, dmdDotLum, dmdDotRaw, layout->top != 0);
-      core_dmd_capture_frame(layout->length, layout->start, dmdDotRaw, raw_dmd_frame_count ,raw_dmd_frames);
+      core_dmd_render_vpm(layout->length, layout->start, dmdDotLum, frameHash, dirtyRows);
+      const int rawFrameCount = dmd_state ? dmd_state->rawExportFrameCount : 0;
+      const UINT8* const rawFrames = dmd_state ? dmd_state->rawExportFrames : NULL;
+      core_dmd_render_dmddevice(layout->length, layout->start, dmdDotLum, dmdDotRaw, rawFrameCount, rawFrames, layout->top != 0);
+      core_dmd_capture_frame(layout->length, layout->start, dmdDotRaw, rawFrameCount, rawFrames, layout->top != 0);
+      if (dirtyRows)
+        vpm_publish_dmd_frame(layout->top != 0, layout->length, layout->start, dmdDotLum, dmdDotRaw, rawFrameCount, rawFrames, frameHash);
     }
   
   #elif defined(PINMAME)
-    core_dmd_render_internal(bitmap, layout->left, layout->top, layout->length, layout->start, dmdDotLum, pmoptions.dmd_antialias && !(layout->type & CORE_DMDNOAA));
+    if (governor.level < CORE_GOVERNOR_DMDRENDER || (cpu_getcurrentframe() & 1))
+      core_dmd_render_internal(bitmap, layout->left, layout->top, layout->length, layout->start, dmdDotLum, pmoptions.dmd_antialias && !(layout->type & CORE_DMDNOAA));
 
   #endif
 }
@@ -3509,8 +4684,13 @@ void core_dmd_video_update(struct mame_bitmap *bitmap, const struct rectangle *c
 
 void core_sound_throttle_adj(int sIn, int *sOut, int buffersize, double samplerate)
 {
+   extern int throttle;
    const int delta = (sIn >= *sOut) ? (sIn - *sOut) : (sIn + buffersize - *sOut);
 
+   // Running unthrottled (fast forward): nothing to adjust, the output isn't paced by the sound device
+   if (!throttle)
+      return;
+
 #ifdef DEBUG_SOUND
    {
       char tmp[161];
@@ -210,6 +210,7 @@
 
 #define DMD_MAXX 256
 #define DMD_MAXY 64
+#define CORE_MAX_RAW_DMD_FRAMES 5 /* Maximum number of raw frames sent to colorization plugins */
 
 /* Shortcuts for some common display sizes */
 #define DISP_SEG_16(row,type)    {4*(row), 0, 20*(row), 16, type}
@@ -404,6 +405,7 @@ typedef int (*ptPinMAMEvidUpdate)(struct mame_bitmap *bitmap, const struct recta
 #define CORE_MODOUT_GI0   (CORE_MODOUT_SOL0 + CORE_MODOUT_SOL_MAX) /* Index of first GI output */
 #define CORE_MODOUT_SEG0  (CORE_MODOUT_GI0  + CORE_MODOUT_GI_MAX ) /* Index of first alphanumeric segment output */
 #define CORE_MODOUT_MAX   (CORE_MODOUT_SEG0 + CORE_MODOUT_SEG_MAX) /* Maximum number of modulated outputs */
+#define CORE_MODOUT_FLIP_POOL             (CORE_MODOUT_MAX * 16) /* Number of flip timestamps available for the outputs that need a larger ring than FLIP_BUFFER_SIZE_SLOW */
 
 #define CORE_MODOUT_NONE                   0 /* just don't do anything: value defined by driver is kept unchanged by integrator */
 #define CORE_MODOUT_PULSE                  1 /* No integration, just the raw pulse state */
@@ -457,7 +459,10 @@ typedef struct {
 
 typedef void (*core_tPhysOutputIntegrator)(const double, const int, const int, const int);
 
-#define FLIP_BUFFER_SIZE 32               /* Number of state considered for PWM integration. Must be even (and should a power of 2 for performance reason) */
+/* Number of states considered for PWM integration, depending on the output type (see core_set_pwm_output_type). Must be powers of 2 (so even) */
+#define FLIP_BUFFER_SIZE_SLOW 8           /* Outputs that only use their last state (no integration, custom getSol) */
+#define FLIP_BUFFER_SIZE 32               /* Bulbs and solenoids */
+#define FLIP_BUFFER_SIZE_FAST 64          /* Strobed LEDs and VFDs */
 typedef struct {
    int type;                              /* Type of modulation from CORE_MODOUT_ definitions */
    float value;                           /* Last computed output main physical characteristic (relative brightness for bulbs, strength for solenoids,...) */
@@ -477,6 +482,7 @@ typedef struct {
          float filament_temperature;      /* actual filament temperature */
          float eye_integration[3];        /* flicker/fusion eye model state */
          float eye_emission_old;          /* prev emission value in the eye model state */
+         int settled;                     /* integration skipped until the next flip (see core_update_pwm_output_bulbs) */ // bool
       } bulb; // Physical model of a bulb / LED / VFD
       struct
       {
@@ -485,9 +491,12 @@ typedef struct {
          float switchDownLatency;
       } sol; // Physical model of a solenoid
    } state;
-   double flipTimeStamps[FLIP_BUFFER_SIZE];
+   unsigned int flipBufferOffset;         /* Start of the flip ring in coreGlobals.flipTimeStamps */
+   unsigned int flipBufferCapacity;       /* Allocated size of the flip ring, kept when the output type changes */
+   unsigned int flipBufferMask;           /* Used size of the flip ring minus 1 */
    unsigned int flipBufferPos;
    unsigned int lastIntegrationFlipPos;
+   unsigned int flipOverruns;             /* Number of times the ring was filled before being integrated, losing its pending flips */
 } core_tPhysicOutput;
 
 #ifdef LSB_FIRST
@@ -521,8 +530,12 @@ typedef struct {
   int nSolenoids, nLamps, nGI, nAlphaSegs;                      /* Number of physical outputs the driver handles */
   double lastACZeroCrossTimeStamp;                              /* Last time AC did cross 0 as reported by the driver (should be 120Hz) */
   UINT8 binaryOutputState[CORE_MODOUT_MAX / 8];                 /* Pulsed binary state */
+  UINT8 physicOutputUnwatched[CORE_MODOUT_MAX / 8];            /* Physical outputs the host does not read, left out of the integration (see core_set_pwm_output_watched) */
+  UINT8 physicOutputDirect[CORE_MODOUT_MAX / 8];               /* Outputs only kept as binary states, without flips nor integration (see core_set_pwm_output_direct) */
   core_tPhysicOutput physicOutputState[CORE_MODOUT_MAX];        /* Output state, taking in account the physical device wired to the binary output */
   float lastPhysicOutputReportedValue[CORE_MODOUT_MAX];         /* Last state value reported for each of the physic outputs */
+  double flipTimeStamps[CORE_MODOUT_MAX * FLIP_BUFFER_SIZE_SLOW + CORE_MODOUT_FLIP_POOL]; /* Flip rings: one small ring per output, followed by a pool for the larger ones */
+  unsigned int flipTimeStampPoolUsed;
   /*-- Miscellaneous --*/
   int    simAvail;                                              /* Simulator (keys) available */
   int    soundEn;                                               /* Sound enabled ? */
@@ -601,6 +614,28 @@ extern void core_updInvSw(int swNo, int inv);
 /*-- get a switch column. (colEn=bits) --*/
 extern int core_getSwCol(int colEn);
 
+/*-- latency telemetry: wall clock delays from a host input to the resulting output --*/
+#define CORE_LATENCY_SWITCH_READ  0 /* switch set by the host -> first read of its column by the ROM */
+#define CORE_LATENCY_SWITCH_SOL   1 /* switch set by the host -> next solenoid change reported to the host */
+#define CORE_LATENCY_DMD          2 /* DMD frame rendered by the core -> handed to (or read by) the host */
+#define CORE_LATENCY_STAGES       3
+#define CORE_LATENCY_WINDOW    1024 /* percentiles are computed over the last samples */
+extern void core_latencyEnable(int enable);
+extern void core_latencySwitch(int swNo);
+extern void core_latencyStart(int stage, int param);
+extern void core_latencyStop(int stage, int param);
+extern UINT32 core_latencyGet(int stage, double *p50, double *p95, double *p99, double *max);
+
+/*-- speed governor: when the emulation falls behind real time, trades accuracy for speed, one level after the other --*/
+#define CORE_GOVERNOR_OFF         0
+#define CORE_GOVERNOR_INTERLEAVE  1 /* 4x coarser cpu_boost_interleave timeslices */
+#define CORE_GOVERNOR_DMDFILTER   2 /* DMD PWM low pass filter over the central half of its taps */
+#define CORE_GOVERNOR_RESAMPLE    3 /* linear audio resampling (if the configured quality is better) */
+#define CORE_GOVERNOR_DMDRENDER   4 /* internal DMD window only rendered every other frame */
+#define CORE_GOVERNOR_MAXLEVEL    4
+extern int g_speed_governor;        /* highest level the governor may select, 0 disables it */
+extern int core_governorLevel(void);
+
 /*-- solenoid handling --*/
 extern int core_getSol(int solNo);
 extern int core_getPulsedSol(int solNo);
@@ -616,6 +651,11 @@ INLINE void core_update_pwm_lamps(void) { if (options.usemodsol & (CORE_MODOUT_F
 extern void core_set_pwm_output_type(int startIndex, int count, int type);
 extern void core_set_pwm_output_types(int startIndex, int count, int* outputTypes);
 extern void core_set_pwm_output_bulb(int startIndex, int count, int bulb, float U, int isAC, float serial_R, float relative_brightness);
+extern void core_set_pwm_output_watched(int startIndex, int count, int watched);
+extern int core_get_pwm_output_watched(int index);
+extern void core_set_pwm_output_direct(int startIndex, int count, int direct);
+extern void core_init_pwm_output_models(void);
+extern unsigned int core_get_pwm_output_overruns(int startIndex, int count);
 extern void core_write_pwm_output(int startIndex, int count, UINT8 bitStates); // Write binary state of count outputs, taking care of PWM integration based on physical model of connected device
 extern void core_write_pwm_output_8b(int startIndex, UINT8 bitStates);
 extern void core_write_masked_pwm_output_8b(int startIndex, UINT8 bitStates, UINT8 bitMask);
@@ -640,9 +680,21 @@ typedef struct {
   int     nextFrame;          // Position in circular buffer to store next raw frame
   UINT32* shadedFrame;        // Shaded frame computed from raw frames
   unsigned int frame_index;   // Raw frame index
+  int     uniformFrames;      // Number of consecutive identical raw frames submitted (saturated), used to skip updates of static screens
+  unsigned int updatedFrameIndex; // Raw frame index when 'core_dmd_update_pwm' last computed the integrated data (valid if hasUpdated)
+  int     hasUpdated;         // Integrated data have been computed at least once
   // Integrated data, computed by 'core_dmd_update_pwm'
   UINT8*  bitplaneFrame;      // DMD: bitplane frame built up from raw rasterized frames (depends on each driver, stable result that can be used for post processing like colorization, ...)
   UINT8*  luminanceFrame;     // DMD: linear luminance computed from PWM frames, for rendering (result may change and can't be considered as stable accross PinMame builds)
+  UINT64* rowHashes;          // Hash of each row of luminance and bitplane frames
+  UINT64  frameHash;          // Hash of the whole luminance and bitplane frames (combined row hashes)
+  UINT64  dirtyRows;          // Bit n set if row n changed since 'core_dmd_video_update' last consumed this mask
+  // On demand evaluation (see 'core_dmd_evaluate_pwm'), from another thread than the one submitting frames
+  volatile long sequence;     // Incremented before and after 'core_dmd_submit_frame' updates the raw frames (odd while updating)
+  UINT8*  demandRawFrames;    // Copy of the raw frames evaluated on demand
+  UINT32* demandShadedFrame;  // Shaded frame of the on demand evaluation
+  UINT8*  rawExportFrames;    // Last raw frames (most recent first, high bit first) sent to colorization plugins and frame capture (GTS3, WPC and Alvin G. 2 only)
+  int     rawExportFrameCount; // Number of frames in rawExportFrames (0 if not provided by the driver)
 } core_tDMDPWMState;
 
 #define CORE_DMD_PWM_FILTER_DE_128x16   0
@@ -667,7 +719,19 @@ extern void core_dmd_pwm_init(core_tDMDPWMState* dmd_state, const int width, con
 extern void core_dmd_pwm_exit(core_tDMDPWMState* dmd_state);
 extern void core_dmd_submit_frame(core_tDMDPWMState* dmd_state, const UINT8* frame, const int ntimes);
 extern void core_dmd_update_pwm(core_tDMDPWMState* dmd_state);
+extern void core_dmd_set_on_demand(const int onDemand);
+extern int  core_dmd_evaluate_pwm(const int index, UINT8* const dmdDotLum, UINT8* const dmdDotRaw, const int size);
 extern void core_dmd_video_update(struct mame_bitmap *bitmap, const struct rectangle *cliprect, const struct core_dispLayout *layout, core_tDMDPWMState* dmd_state);
+extern int  core_dmd_bitplane_depth(void); // bits per dot of the bitplane frames of the running machine: 4 (16 shades) or 2 (4 shades)
+extern UINT64 core_dmd_hash_frame(const int width, const int height, const UINT8* const dmdDotLum, const UINT8* const dmdDotRaw, UINT64* rowHashes, UINT64* dirtyRows);
+
+/*-- DMD colorization: palettes switched when a main DMD bitplane frame matches a trigger hash --*/
+#if defined(VPINMAME) || defined(LIBPINMAME)
+#define CORE_DMD_MAX_PALETTE_TRIGGERS 256
+extern UINT64 core_dmd_bitplane_hash(const int width, const int height, const UINT8* const dmdDotRaw);
+extern int  core_dmd_add_palette_trigger(const UINT64 bitplaneHash, const UINT32* const colors, const int nColors);
+extern void core_dmd_clear_palette_triggers(void);
+#endif
 
 extern void core_sound_throttle_adj(int sIn, int *sOut, int buffersize, double samplerate);
 
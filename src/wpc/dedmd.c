@@ -215,15 +215,11 @@ PINMAME_VIDEO_UPDATE(dedmd32_update) {
 	  /* Start with an empty frame buffer */
 	  procClearDMD();
 
-	  /* Fill the P-ROC subframes from the video RAM */
+	  /* Fill the P-ROC subframes from the video RAM. Each byte is reversed in the
+	     video RAM relative to the bit order the P-ROC expects, so reverse each byte. */
      const UINT8* RAM = ((UINT8*)dmdlocals.RAMbankPtr) + ((crtc6845_start_address_r(0) & 0x0100) << 2);
-     procFillDMDSubFrame(procSubFrame0, RAM        , 0x200);
-	  procFillDMDSubFrame(procSubFrame1, RAM + 0x200, 0x200);
-
-	  /* Each byte is reversed in the video RAM relative to the bit order the P-ROC
-	     expects. So reverse each byte. */
-	  procReverseSubFrameBytes(procSubFrame0);
-	  procReverseSubFrameBytes(procSubFrame1);
+	  procFillDMDSubFrameReversed(procSubFrame0, RAM        , 0x200);
+	  procFillDMDSubFrameReversed(procSubFrame1, RAM + 0x200, 0x200);
 	  procUpdateDMD();
 	  /* Don't explicitly update the DMD from here. The P-ROC code
 	     will update after the next DMD event. */
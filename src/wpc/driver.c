@@ -17,6 +17,113 @@ struct GameDriver *drivers[] = {
 0 /* end of array */
 };
 const struct GameDriver *test_drivers[] = { 0 };
+
+/*-------------------------------------------------------------
+/  Name and clone index of drivers[], built on first use.
+/  Lookups are case insensitive, like the frontends expect.
+/--------------------------------------------------------------*/
+#  include <ctype.h>
+
+#define DRIVER_INDEX_NONE (-1)
+
+static int  driver_index_count = -1;
+static int  driver_index_size;
+static int *driver_index_bucket;  /* first game of each name hash bucket */
+static int *driver_index_next;    /* next game in the same bucket */
+static int *driver_first_clone;   /* first clone of each game */
+static int *driver_next_clone;    /* next clone of the same parent */
+
+static unsigned driver_hash_name(const char *name) {
+  unsigned h = 0;
+  for (; *name; ++name)
+    h = h*31 + tolower((unsigned char)*name);
+  return h;
+}
+
+static int driver_name_equal(const char *a, const char *b) {
+  for (; *a && tolower((unsigned char)*a) == tolower((unsigned char)*b); ++a, ++b)
+    ;
+  return tolower((unsigned char)*a) == tolower((unsigned char)*b);
+}
+
+static int driver_find_slow(const struct GameDriver *drv) {
+  /* only used once per clone while building the index */
+  const int hash = driver_hash_name(drv->name) & (driver_index_size-1);
+  int i;
+  for (i = driver_index_bucket[hash]; i != DRIVER_INDEX_NONE; i = driver_index_next[i])
+    if (drivers[i] == drv)
+      return i;
+  return DRIVER_INDEX_NONE;
+}
+
+static void driver_build_index(void) {
+  int count = 0, size = 16, i;
+  while (drivers[count])
+    count++;
+  while (size < count*2)
+    size <<= 1;
+
+  driver_index_bucket = malloc(size * sizeof(int));
+  driver_index_next   = malloc((count+1) * sizeof(int));
+  driver_first_clone  = malloc((count+1) * sizeof(int));
+  driver_next_clone   = malloc((count+1) * sizeof(int));
+  if (!driver_index_bucket || !driver_index_next || !driver_first_clone || !driver_next_clone) {
+    free(driver_index_bucket); free(driver_index_next);
+    free(driver_first_clone);  free(driver_next_clone);
+    driver_index_bucket = driver_index_next = driver_first_clone = driver_next_clone = NULL;
+    return;
+  }
+  driver_index_size = size;
+
+  for (i = 0; i < size; i++)
+    driver_index_bucket[i] = DRIVER_INDEX_NONE;
+  /* insert backwards, so that the first of two equal names wins like a linear search */
+  for (i = count-1; i >= 0; i--) {
+    const int hash = driver_hash_name(drivers[i]->name) & (size-1);
+    driver_index_next[i] = driver_index_bucket[hash];
+    driver_index_bucket[hash] = i;
+    driver_first_clone[i] = DRIVER_INDEX_NONE;
+  }
+  /* clone lists, in drivers[] order */
+  for (i = count-1; i >= 0; i--) {
+    const struct GameDriver *parent = drivers[i]->clone_of;
+    const int p = parent ? driver_find_slow(parent) : DRIVER_INDEX_NONE;
+    driver_next_clone[i] = DRIVER_INDEX_NONE;
+    if (p != DRIVER_INDEX_NONE) {
+      driver_next_clone[i] = driver_first_clone[p];
+      driver_first_clone[p] = i;
+    }
+  }
+  driver_index_count = count;
+}
+
+int driver_get_index(const char *name) {
+  int i;
+  if (driver_index_count < 0)
+    driver_build_index();
+  if (!driver_index_bucket) { /* out of memory: linear search */
+    for (i = 0; drivers[i]; i++)
+      if (driver_name_equal(drivers[i]->name, name))
+        return i;
+    return DRIVER_INDEX_NONE;
+  }
+  for (i = driver_index_bucket[driver_hash_name(name) & (driver_index_size-1)]; i != DRIVER_INDEX_NONE; i = driver_index_next[i])
+    if (driver_name_equal(drivers[i]->name, name))
+      return i;
+  return DRIVER_INDEX_NONE;
+}
+
+int driver_get_first_clone(int game) {
+  if (driver_index_count < 0)
+    driver_build_index();
+  return (driver_first_clone && game >= 0 && game < driver_index_count) ? driver_first_clone[game] : DRIVER_INDEX_NONE;
+}
+
+int driver_get_next_clone(int game) {
+  if (driver_index_count < 0)
+    driver_build_index();
+  return (driver_next_clone && game >= 0 && game < driver_index_count) ? driver_next_clone[game] : DRIVER_INDEX_NONE;
+}
 #else /* DRIVER_RECURSIVE */
 
 /* A comment on the "LED Ghost Fix" MODs from https://emmytech.com/arcade/led_ghost_busting/index.html :
@@ -0,0 +1,126 @@
+// license:BSD-3-Clause
+
+/***************************************************************************
+ Game alias table (see gamealias.h)
+
+ The whole file is kept in one buffer, the alias and real names are cut
+ in place and indexed by an open addressing hash table on the lower case
+ alias. The first line of an alias wins, like the former sequential scan.
+***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "gamealias.h"
+
+typedef struct {
+  const char *alias;
+  const char *real;
+} tGameAlias;
+
+static struct {
+  char *filename;     // file the table was loaded from
+  int loaded;         // a stat was done, even if the file does not exist
+  long size;
+  long mtime;
+  char *text;         // file contents, names are cut in place
+  tGameAlias *table;
+  unsigned int mask;  // table size - 1, size is a power of 2
+} locals;
+
+static unsigned int alias_hash(const char *name) {
+  unsigned int hash = 2166136261u; // FNV-1a
+  while (*name) {
+    hash ^= (unsigned char)tolower((unsigned char)*name++);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static int alias_cmp(const char *a, const char *b) {
+  while (*a && tolower((unsigned char)*a) == tolower((unsigned char)*b)) { a++; b++; }
+  return tolower((unsigned char)*a) - tolower((unsigned char)*b);
+}
+
+static void alias_clear(void) {
+  free(locals.table); locals.table = NULL;
+  free(locals.text); locals.text = NULL;
+  locals.mask = 0;
+}
+
+static void alias_load(FILE *f, long size) {
+  char *line, *next;
+  unsigned int count = 1, tableSize = 16;
+
+  locals.text = malloc(size + 1);
+  if (!locals.text) return;
+  size = (long)fread(locals.text, 1, size, f);
+  locals.text[size] = '\0';
+
+  for (line = locals.text; *line; line++)
+    if (*line == '\n') count++;
+  while (tableSize < count * 2) tableSize *= 2;
+  locals.table = calloc(tableSize, sizeof(tGameAlias));
+  if (!locals.table) { alias_clear(); return; }
+  locals.mask = tableSize - 1;
+
+  for (line = locals.text; line; line = next) {
+    char *alias, *real;
+    unsigned int pos;
+
+    next = strchr(line, '\n');
+    if (next) *next++ = '\0';
+    // Skip lines that start with "#"
+    if (line[0] == '#') continue;
+    alias = strtok(line, ", \t\r");
+    real = alias ? strtok(NULL, " ,\t\r#;'") : NULL;
+    if (!real) continue;
+
+    for (pos = alias_hash(alias) & locals.mask; locals.table[pos].alias; pos = (pos + 1) & locals.mask)
+      if (alias_cmp(locals.table[pos].alias, alias) == 0) break;
+    if (!locals.table[pos].alias) {
+      locals.table[pos].alias = alias;
+      locals.table[pos].real = real;
+    }
+  }
+}
+
+static void alias_update(const char *filename) {
+  struct stat st;
+  const int exists = (stat(filename, &st) == 0);
+  const long size = exists ? (long)st.st_size : -1;
+  const long mtime = exists ? (long)st.st_mtime : -1;
+
+  if (locals.loaded && locals.filename && strcmp(locals.filename, filename) == 0 &&
+      locals.size == size && locals.mtime == mtime)
+    return;
+
+  alias_clear();
+  free(locals.filename);
+  locals.filename = malloc(strlen(filename) + 1);
+  if (locals.filename) strcpy(locals.filename, filename);
+  locals.loaded = 1;
+  locals.size = size;
+  locals.mtime = mtime;
+
+  if (exists) {
+    FILE *f = fopen(filename, "rb");
+    if (f) { alias_load(f, size); fclose(f); }
+  }
+}
+
+const char* gamealias_find(const char* filename, const char* alias) {
+  unsigned int pos;
+
+  if (!filename || !alias) return NULL;
+  alias_update(filename);
+  if (!locals.table) return NULL;
+
+  for (pos = alias_hash(alias) & locals.mask; locals.table[pos].alias; pos = (pos + 1) & locals.mask)
+    if (alias_cmp(locals.table[pos].alias, alias) == 0)
+      return locals.table[pos].real;
+  return NULL;
+}
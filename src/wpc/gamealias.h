@@ -0,0 +1,23 @@
+// license:BSD-3-Clause
+
+#ifndef INC_GAMEALIAS
+#define INC_GAMEALIAS
+#if !defined(__GNUC__) || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || (__GNUC__ >= 4)	// GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+/*----------------------------------------------------------------
+/ Game alias table (VPMAlias.txt), shared by VPinMAME and libpinmame.
+/
+/ Each line maps an alias to a real game name: "alias,realname".
+/ Lines starting with # are comments. The file is read once into a
+/ hashed table and read again only when its size or modification
+/ time changed, so a lookup does not touch the file contents.
+/
+/ gamealias_find returns the real game name for the alias (case
+/ insensitive), or NULL if the file or the alias does not exist. The
+/ returned string stays valid until the file is reloaded.
+/---------------------------------------------------------------*/
+extern const char* gamealias_find(const char* filename, const char* alias);
+
+#endif /* INC_GAMEALIAS */
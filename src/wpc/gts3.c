@@ -1154,6 +1154,7 @@ MACHINE_DRIVER_START(gts3_21)
   MDRV_IMPORT_FROM(gts3)
   MDRV_CPU_ADD(M65C02, 3579545./2.)
   MDRV_CPU_MEMORY(GTS3_dmdreadmem, GTS3_dmdwritemem)
+  MDRV_CPU_FLAGS(CPU_IDLE_DETECT) // mostly polls between the vblank NMIs and the command IRQs
   MDRV_CORE_INIT_RESET_STOP(gts3dmd,NULL,gts3dmd)
   MDRV_IMPORT_FROM(gts80s_s3)
 MACHINE_DRIVER_END
@@ -1171,9 +1172,11 @@ MACHINE_DRIVER_START(gts3_22)
   MDRV_IMPORT_FROM(gts3)
   MDRV_CPU_ADD(M65C02, 3579545./2.)
   MDRV_CPU_MEMORY(GTS3_dmdreadmem, GTS3_dmdwritemem)
+  MDRV_CPU_FLAGS(CPU_IDLE_DETECT)
   MDRV_CORE_INIT_RESET_STOP(gts3dmd,NULL,gts3)
   MDRV_CPU_ADD(M65C02, 3579545./2.)
   MDRV_CPU_MEMORY(GTS3_dmdreadmem2, GTS3_dmdwritemem2)
+  MDRV_CPU_FLAGS(CPU_IDLE_DETECT)
   MDRV_CORE_INIT_RESET_STOP(gts3dmd2,NULL,gts3dmd2)
   MDRV_SOUND_ADD(OKIM6295, sns_okim6295_interface)
   MDRV_DIAGNOSTIC_LEDH(3)
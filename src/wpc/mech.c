@@ -156,6 +156,8 @@ static void mech_update(int mechNo) {
   }
   /*-- update position --*/
   if (speed || (md->pos < 0)) {
+    const int firstUpdate = md->pos < 0;
+    UINT32 swState = 0;
     int anglePos = md->anglePos + speed * MECH_STEP / md->acc / md->ret;
     if (md->type & MECH_STOPEND) {
       if (anglePos >= md->length*MECH_STEP) anglePos = (md->length - 1)*MECH_STEP;
@@ -178,13 +180,20 @@ static void mech_update(int mechNo) {
     /*-- update switches --*/
     currPos = (md->type & MECH_LENGTHSW) ? currPos / MECH_STEP : md->pos;
 
-    for (ii = 0; ii < MECH_MAXMECHSW && md->swPos[ii].swNo > 0; ii++)
-      core_setSw(md->swPos[ii].swNo, FALSE);
     for (ii = 0; ii < MECH_MAXMECHSW && md->swPos[ii].swNo > 0; ii++) {
       if (md->swPos[ii].pulse) currPos %= md->swPos[ii].pulse;
       if ((currPos >= md->swPos[ii].startPos) &&
           (currPos <= md->swPos[ii].endPos))
-        core_setSw(md->swPos[ii].swNo, TRUE);
+        swState |= 1u << ii;
+    }
+    /*-- slow mechs stay many updates within the same switch ranges, only write the switches when a range is entered or left --*/
+    if (firstUpdate || swState != md->swState) {
+      for (ii = 0; ii < MECH_MAXMECHSW && md->swPos[ii].swNo > 0; ii++)
+        core_setSw(md->swPos[ii].swNo, FALSE);
+      for (ii = 0; ii < MECH_MAXMECHSW && md->swPos[ii].swNo > 0; ii++)
+        if (swState & (1u << ii))
+          core_setSw(md->swPos[ii].swNo, TRUE);
+      md->swState = swState;
     }
   }
 
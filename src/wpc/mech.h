@@ -67,6 +67,7 @@ typedef struct {
   int speed;    /* current speed -acc -> acc */
   int anglePos;
   int last;
+  UINT32 swState; /* switch ranges active at the last position update, one bit per swPos entry */
 } mech_tMechData, *ptMechData;
 
 extern void mech_init(void);
@@ -0,0 +1,267 @@
+// license:BSD-3-Clause
+
+/***************************************************************************
+ Network publisher (see netpub.h for the protocol)
+
+ Runs on the emulation thread: the DMD frames are sent from the display
+ update, rate limited, with only the rows changed since the last frame
+ sent (rows changed by skipped frames are kept pending); the outputs
+ are sampled from a timer like the output exporter. The socket is non
+ blocking and send errors are ignored, a lost datagram being repaired
+ by the next full state at the latest.
+***************************************************************************/
+
+#if defined(_WIN32) || defined(_WIN64)
+ #include <winsock2.h> // before windows.h, which driver.h may include
+ #include <ws2tcpip.h>
+#endif
+#include <stdio.h>
+#include <string.h>
+#include "driver.h"
+#include "core.h"
+#include "outexport.h"
+#include "netpub.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+ typedef SOCKET netpub_socket;
+ #define NETPUB_NOSOCKET INVALID_SOCKET
+ #define netpub_closesocket closesocket
+#else
+ #include <fcntl.h>
+ #include <unistd.h>
+ #include <netdb.h>
+ #include <sys/socket.h>
+ #include <netinet/in.h>
+ typedef int netpub_socket;
+ #define NETPUB_NOSOCKET (-1)
+ #define netpub_closesocket close
+#endif
+
+char* g_net_publish = NULL;
+int g_net_publish_dmd_rate = 60;
+int g_net_publish_output_rate = 100;
+int g_net_publish_raw = 0;
+int g_net_publish_ttl = 1;
+
+#define NETPUB_KEY_PERIOD 1.0 /* seconds between full states */
+
+static struct {
+  int active;
+  netpub_socket sock;
+  struct sockaddr_storage addr;
+  int addrLength;
+  mame_timer *timer;
+  UINT32 sequence;
+  /*-- DMD, per display --*/
+  double dmdNext[2], dmdKey[2];            /* emulated time of the next frame allowed, of the next full frame */
+  UINT64 pendingRows[2], sentHash[2];
+  UINT16 frameNo[2];
+  /*-- outputs --*/
+  double outputKey;
+  int resync;
+  UINT8 sent[CORE_MODOUT_MAX];             /* last values sent */
+  UINT8 datagram[NETPUB_DATAGRAM];
+  int length;
+} locals;
+
+INLINE void netpub_put16(UINT8* p, UINT16 v) { p[0] = (UINT8)v; p[1] = (UINT8)(v >> 8); }
+INLINE void netpub_put32(UINT8* p, UINT32 v) { netpub_put16(p, (UINT16)v); netpub_put16(p + 2, (UINT16)(v >> 16)); }
+INLINE void netpub_put64(UINT8* p, UINT64 v) { netpub_put32(p, (UINT32)v); netpub_put32(p + 4, (UINT32)(v >> 32)); }
+
+/*-- transport: non blocking UDP socket --*/
+static int netpub_open(const char* endpoint) {
+  char host[256];
+  const char* port = strrchr(endpoint, ':');
+  struct addrinfo hints, *res = NULL;
+  size_t hostLength;
+
+  if (port == NULL || (hostLength = (size_t)(port - endpoint)) >= sizeof(host))
+    return FALSE;
+  if (endpoint[0] == '[' && hostLength >= 2 && endpoint[hostLength - 1] == ']') { // [IPv6]:port
+    endpoint++;
+    hostLength -= 2;
+  }
+  memcpy(host, endpoint, hostLength);
+  host[hostLength] = 0;
+  port++;
+
+#if defined(_WIN32) || defined(_WIN64)
+  {
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+      return FALSE;
+  }
+#endif
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_DGRAM;
+  if (getaddrinfo(host, port, &hints, &res) != 0 || res == NULL || res->ai_addrlen > sizeof(locals.addr)) {
+    if (res)
+      freeaddrinfo(res);
+    return FALSE;
+  }
+  memcpy(&locals.addr, res->ai_addr, res->ai_addrlen);
+  locals.addrLength = (int)res->ai_addrlen;
+  locals.sock = socket(res->ai_family, SOCK_DGRAM, IPPROTO_UDP);
+  freeaddrinfo(res);
+  if (locals.sock == NETPUB_NOSOCKET)
+    return FALSE;
+
+#if defined(_WIN32) || defined(_WIN64)
+  {
+    u_long on = 1;
+    const DWORD ttl = (DWORD)g_net_publish_ttl;
+    ioctlsocket(locals.sock, FIONBIO, &on);
+    if (locals.addr.ss_family == AF_INET)
+      setsockopt(locals.sock, IPPROTO_IP, IP_MULTICAST_TTL, (const char*)&ttl, sizeof(ttl));
+  }
+#else
+  fcntl(locals.sock, F_SETFL, fcntl(locals.sock, F_GETFL) | O_NONBLOCK);
+  if (locals.addr.ss_family == AF_INET) {
+    const unsigned char ttl = (unsigned char)g_net_publish_ttl;
+    setsockopt(locals.sock, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+  }
+#endif
+  if (locals.addr.ss_family == AF_INET6) {
+    const int hops = g_net_publish_ttl;
+    setsockopt(locals.sock, IPPROTO_IPV6, IPV6_MULTICAST_HOPS, (const char*)&hops, sizeof(hops));
+  }
+  return TRUE;
+}
+
+static void netpub_close(void) {
+  if (locals.sock != NETPUB_NOSOCKET)
+    netpub_closesocket(locals.sock);
+  locals.sock = NETPUB_NOSOCKET;
+#if defined(_WIN32) || defined(_WIN64)
+  WSACleanup();
+#endif
+}
+
+static void netpub_begin(int type, int flags) {
+  memcpy(locals.datagram, "PMNP", 4);
+  locals.datagram[4] = NETPUB_VERSION;
+  locals.datagram[5] = (UINT8)type;
+  netpub_put16(locals.datagram + 6, (UINT16)flags);
+  netpub_put32(locals.datagram + 8, locals.sequence++);
+  netpub_put32(locals.datagram + 12, (UINT32)(timer_get_time() * 1000000.0));
+  locals.length = NETPUB_HEADER;
+}
+
+static void netpub_send(void) {
+  sendto(locals.sock, (const char*)locals.datagram, locals.length, 0, (const struct sockaddr*)&locals.addr, locals.addrLength);
+  locals.length = 0;
+}
+
+/*-- DMD frames --*/
+void netpub_dmd(int display, int width, int height, const UINT8* dmdDotLum, const UINT8* dmdDotRaw, UINT64 frameHash, UINT64 dirtyRows) {
+  const double now = timer_get_time();
+  const int rowSize = g_net_publish_raw ? (width + 1) / 2 : width;
+  int key, y;
+
+  if (!locals.active || g_net_publish_dmd_rate <= 0 || display < 0 || display > 1 || height > 64 || NETPUB_DMD_HEADER + 1 + rowSize > NETPUB_DATAGRAM)
+    return;
+
+  locals.pendingRows[display] |= dirtyRows;
+  key = now >= locals.dmdKey[display];
+  if (!key && (locals.pendingRows[display] == 0 || now < locals.dmdNext[display]))
+    return;
+  if (key) {
+    locals.pendingRows[display] = height == 64 ? ~(UINT64)0 : ((UINT64)1 << height) - 1;
+    locals.dmdKey[display] = now + NETPUB_KEY_PERIOD;
+  }
+  else if (frameHash == locals.sentHash[display]) { // the changed rows are back to the frame sent
+    locals.pendingRows[display] = 0;
+    return;
+  }
+  locals.dmdNext[display] = now + 1.0 / g_net_publish_dmd_rate;
+  locals.frameNo[display]++;
+
+  locals.length = 0;
+  for (y = 0; y < height; y++) {
+    if ((locals.pendingRows[display] & ((UINT64)1 << y)) == 0)
+      continue;
+    if (locals.length == 0 || locals.length + 1 + rowSize > NETPUB_DATAGRAM) {
+      if (locals.length)
+        netpub_send();
+      netpub_begin(NETPUB_DMD, key ? NETPUB_KEY : 0);
+      locals.datagram[16] = (UINT8)display;
+      locals.datagram[17] = g_net_publish_raw ? 1 : 0;
+      netpub_put16(locals.datagram + 18, (UINT16)width);
+      netpub_put16(locals.datagram + 20, (UINT16)height);
+      netpub_put16(locals.datagram + 22, locals.frameNo[display]);
+      netpub_put64(locals.datagram + 24, frameHash);
+      locals.length = NETPUB_DMD_HEADER;
+    }
+    locals.datagram[locals.length++] = (UINT8)y;
+    if (g_net_publish_raw) {
+      const UINT8* const row = dmdDotRaw + y * width;
+      int x;
+      for (x = 0; x < width; x += 2)
+        locals.datagram[locals.length++] = (row[x] & 0x0f) | (x + 1 < width ? (row[x + 1] & 0x0f) << 4 : 0);
+    }
+    else {
+      memcpy(locals.datagram + locals.length, dmdDotLum + y * width, width);
+      locals.length += width;
+    }
+  }
+  if (locals.length)
+    netpub_send();
+  locals.pendingRows[display] = 0;
+  locals.sentHash[display] = frameHash;
+}
+
+/*-- outputs --*/
+static void netpub_add(char type, int index, int base, UINT8 value) {
+  const int number = index - base + 1;
+  if (!locals.resync && locals.sent[index] == value)
+    return;
+  locals.sent[index] = value;
+  if (locals.length + 4 > NETPUB_DATAGRAM) {
+    netpub_send();
+    netpub_begin(NETPUB_OUTPUTS, locals.resync ? NETPUB_KEY : 0);
+  }
+  locals.datagram[locals.length++] = (UINT8)type;
+  locals.datagram[locals.length++] = value;
+  netpub_put16(locals.datagram + locals.length, (UINT16)number);
+  locals.length += 2;
+}
+
+static void netpub_update_outputs(int param) {
+  const double now = timer_get_time();
+  locals.resync = now >= locals.outputKey;
+  if (locals.resync)
+    locals.outputKey = now + NETPUB_KEY_PERIOD;
+  netpub_begin(NETPUB_OUTPUTS, locals.resync ? NETPUB_KEY : 0);
+  outexport_sample_outputs(netpub_add);
+  if (locals.length > NETPUB_HEADER)
+    netpub_send();
+  locals.length = 0;
+}
+
+void netpub_start(void) {
+  memset(&locals, 0, sizeof(locals));
+  locals.sock = NETPUB_NOSOCKET;
+  if (g_net_publish == NULL || g_net_publish[0] == 0 || (g_net_publish_dmd_rate <= 0 && g_net_publish_output_rate <= 0))
+    return;
+  if (!netpub_open(g_net_publish)) {
+    logerror("Network publisher: unable to open %s\n", g_net_publish);
+    netpub_close();
+    return;
+  }
+  locals.active = TRUE;
+  if (g_net_publish_output_rate > 0) {
+    locals.timer = timer_alloc(netpub_update_outputs);
+    timer_adjust(locals.timer, TIME_IN_HZ(g_net_publish_output_rate), 0, TIME_IN_HZ(g_net_publish_output_rate));
+  }
+}
+
+void netpub_stop(void) {
+  if (!locals.active)
+    return;
+  if (locals.timer)
+    timer_remove(locals.timer);
+  netpub_close();
+  locals.active = FALSE;
+  locals.timer = NULL;
+}
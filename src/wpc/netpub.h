@@ -0,0 +1,69 @@
+// license:BSD-3-Clause
+
+#ifndef INC_NETPUB
+#define INC_NETPUB
+#if !defined(__GNUC__) || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || (__GNUC__ >= 4)	// GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+/*----------------------------------------------------------------
+/ Network publisher: streams the main DMD frames and the output
+/ changes as UDP datagrams, typically to a multicast group, for the
+/ displays and toys driven by the other computers of a cabinet.
+/ src/libpinmame/netrecv.cpp is a reference receiver.
+/
+/ g_net_publish is the destination "address:port" (IPv6 addresses in
+/ brackets), NULL or empty to disable the publisher. The DMD frames
+/ and the outputs are sent at most g_net_publish_dmd_rate and
+/ g_net_publish_output_rate times per emulated second, 0 to disable
+/ either. g_net_publish_raw selects the DMD data: 0 for the luminance
+/ (8 bits per dot), 1 for the raw shades (4 bits per dot, the shade
+/ levels of the colorization plugins). Multicast datagrams are sent
+/ with a TTL of g_net_publish_ttl.
+/
+/ Every datagram starts with a 16 byte header, little endian:
+/   0  'P' 'M' 'N' 'P'
+/   4  UINT8  NETPUB_VERSION
+/   5  UINT8  type: NETPUB_DMD or NETPUB_OUTPUTS
+/   6  UINT16 flags: NETPUB_KEY if the datagram is part of a full state
+/   8  UINT32 sequence, incremented for each datagram (gaps are losses)
+/  12  UINT32 emulated time in microseconds
+/
+/ NETPUB_DMD payload: only the rows changed since the last frame sent,
+/ a frame being split over as many datagrams as needed.
+/  16  UINT8  display: 0, or 1 for the 2nd DMD of Strikes N' Spares
+/  17  UINT8  format: 0 luminance, 1 raw shades
+/  18  UINT16 width
+/  20  UINT16 height
+/  22  UINT16 frame number, the same in all datagrams of a frame
+/  24  UINT64 frame hash
+/  32  rows: UINT8 row number followed by the dots of the row, one
+/      per byte (luminance) or two per byte (raw, low nibble first)
+/
+/ NETPUB_OUTPUTS payload: the changed outputs, 4 bytes each:
+/      char type (S, L, G or A, see outexport.h), UINT8 value (0..255),
+/      UINT16 number (starting at 1)
+/
+/ A full state (all DMD rows, all outputs) is sent every second, so a
+/ receiver started late or missing datagrams catches up. Sending never
+/ blocks the emulation: datagrams the network can't take are dropped.
+/---------------------------------------------------------------*/
+#define NETPUB_VERSION   1
+#define NETPUB_DMD       1
+#define NETPUB_OUTPUTS   2
+#define NETPUB_KEY       0x0001
+#define NETPUB_HEADER    16
+#define NETPUB_DMD_HEADER 32
+#define NETPUB_DATAGRAM  1400 // maximum datagram size, fits in an Ethernet frame
+
+extern char* g_net_publish;
+extern int g_net_publish_dmd_rate;
+extern int g_net_publish_output_rate;
+extern int g_net_publish_raw;
+extern int g_net_publish_ttl;
+
+extern void netpub_start(void);
+extern void netpub_stop(void);
+extern void netpub_dmd(int display, int width, int height, const UINT8* dmdDotLum, const UINT8* dmdDotRaw, UINT64 frameHash, UINT64 dirtyRows);
+
+#endif /* INC_NETPUB */
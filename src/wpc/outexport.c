@@ -0,0 +1,264 @@
+// license:BSD-3-Clause
+
+/***************************************************************************
+ Output exporter (see outexport.h for the protocol)
+
+ Runs on the emulation thread, from a timer at the requested rate: the
+ physical outputs are integrated up to the current emulated time, compared
+ to the last sent values and the changes are written to the client without
+ ever blocking the emulation. A line that could not be written completely
+ is kept and completed on the next updates before any new line is built.
+***************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "driver.h"
+#include "core.h"
+#include "outexport.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+ #include <windows.h>
+#else
+ #include <errno.h>
+ #include <fcntl.h>
+ #include <unistd.h>
+ #include <sys/socket.h>
+ #include <sys/un.h>
+ #ifndef MSG_NOSIGNAL
+  #define MSG_NOSIGNAL 0 // macOS, SO_NOSIGPIPE is set on the client socket instead
+ #endif
+#endif
+
+char* g_output_export = NULL;
+int g_output_export_rate = 250;
+
+#define OUTEXPORT_LINE_MAX (32 + CORE_MODOUT_MAX * 10)
+
+static struct {
+  int active;
+  mame_timer *timer;
+#if defined(_WIN32) || defined(_WIN64)
+  HANDLE pipe;
+#else
+  int listenFd, clientFd;
+  char path[sizeof(((struct sockaddr_un*)0)->sun_path)];
+#endif
+  int connected, resync;
+  UINT8 sent[CORE_MODOUT_MAX];             /* last values sent to the client */
+  char line[OUTEXPORT_LINE_MAX];
+  int lineLength, lineSent;
+} locals;
+
+INLINE UINT8 outexport_byte(float v) { return (UINT8)(255.0f * (v < 0.0f ? 0.0f : v > 1.0f ? 1.0f : v)); }
+
+/*-- transport: named pipe on Windows, Unix domain socket elsewhere, both non blocking --*/
+#if defined(_WIN32) || defined(_WIN64)
+static int outexport_open(const char* name) {
+  char pipeName[MAX_PATH];
+  snprintf(pipeName, sizeof(pipeName), "%s%s", strncmp(name, "\\\\", 2) ? "\\\\.\\pipe\\" : "", name);
+  locals.pipe = CreateNamedPipeA(pipeName, PIPE_ACCESS_OUTBOUND, PIPE_TYPE_BYTE | PIPE_NOWAIT, 1, 64 * 1024, 0, 0, NULL);
+  return locals.pipe != INVALID_HANDLE_VALUE;
+}
+
+static void outexport_close(void) {
+  if (locals.pipe != INVALID_HANDLE_VALUE)
+    CloseHandle(locals.pipe);
+  locals.pipe = INVALID_HANDLE_VALUE;
+}
+
+static int outexport_accept(void) {
+  // with PIPE_NOWAIT, this returns right away and fails with ERROR_PIPE_CONNECTED once a client is there
+  if (ConnectNamedPipe(locals.pipe, NULL))
+    return TRUE;
+  switch (GetLastError()) {
+  case ERROR_PIPE_CONNECTED:
+    return TRUE;
+  case ERROR_NO_DATA: // a client connected and left already
+    DisconnectNamedPipe(locals.pipe);
+    return FALSE;
+  default: // ERROR_PIPE_LISTENING
+    return FALSE;
+  }
+}
+
+static void outexport_disconnect(void) {
+  DisconnectNamedPipe(locals.pipe);
+}
+
+static int outexport_write(const char* data, int length) {
+  DWORD written = 0;
+  if (!WriteFile(locals.pipe, data, (DWORD)length, &written, NULL))
+    return -1;
+  return (int)written;
+}
+#else
+static int outexport_open(const char* name) {
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", name);
+  snprintf(locals.path, sizeof(locals.path), "%s", name);
+  locals.clientFd = -1;
+  locals.listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (locals.listenFd < 0)
+    return FALSE;
+  unlink(addr.sun_path);
+  if (bind(locals.listenFd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(locals.listenFd, 1) < 0) {
+    close(locals.listenFd);
+    locals.listenFd = -1;
+    return FALSE;
+  }
+  fcntl(locals.listenFd, F_SETFL, fcntl(locals.listenFd, F_GETFL) | O_NONBLOCK);
+  return TRUE;
+}
+
+static void outexport_disconnect(void) {
+  if (locals.clientFd >= 0)
+    close(locals.clientFd);
+  locals.clientFd = -1;
+}
+
+static void outexport_close(void) {
+  outexport_disconnect();
+  if (locals.listenFd >= 0) {
+    close(locals.listenFd);
+    unlink(locals.path);
+  }
+  locals.listenFd = -1;
+}
+
+static int outexport_accept(void) {
+  locals.clientFd = accept(locals.listenFd, NULL, NULL);
+  if (locals.clientFd < 0)
+    return FALSE;
+  fcntl(locals.clientFd, F_SETFL, fcntl(locals.clientFd, F_GETFL) | O_NONBLOCK);
+#ifdef SO_NOSIGPIPE
+  { int on = 1; setsockopt(locals.clientFd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on)); }
+#endif
+  return TRUE;
+}
+
+static int outexport_write(const char* data, int length) {
+  const ssize_t written = send(locals.clientFd, data, (size_t)length, MSG_NOSIGNAL);
+  if (written < 0)
+    return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+  return (int)written;
+}
+#endif
+
+/*-- output sampling --*/
+static void outexport_add(char type, int index, int base, UINT8 value) {
+  if (!locals.resync && locals.sent[index] == value)
+    return;
+  locals.sent[index] = value;
+  locals.lineLength += sprintf(locals.line + locals.lineLength, " %c%d=%d", type, index - base + 1, value);
+}
+
+void outexport_sample_outputs(void (*add)(char type, int index, int base, UINT8 value)) {
+  int ii;
+
+  /*-- solenoids, same values as Controller.ChangedSolenoids --*/
+  if (coreGlobals.nSolenoids && (options.usemodsol & (CORE_MODOUT_ENABLE_PHYSOUT_SOLENOIDS | CORE_MODOUT_ENABLE_MODSOL))) {
+    float state[CORE_MODOUT_SOL_MAX];
+    core_update_pwm_solenoids();
+    core_getAllPhysicSols(state);
+    for (ii = 0; ii < coreGlobals.nSolenoids; ii++)
+      add('S', CORE_MODOUT_SOL0 + ii, CORE_MODOUT_SOL0, outexport_byte(state[ii]));
+  }
+  else {
+    const UINT64 allSol = core_getAllSol();
+    for (ii = 0; ii < CORE_FIRSTCUSTSOL + core_gameData->hw.custSol - 1 && ii < 64; ii++)
+      add('S', CORE_MODOUT_SOL0 + ii, CORE_MODOUT_SOL0, ((allSol >> ii) & 1) ? 255 : 0);
+  }
+
+  /*-- lamps --*/
+  if (coreGlobals.nLamps && (options.usemodsol & CORE_MODOUT_ENABLE_PHYSOUT_LAMPS)) {
+    core_update_pwm_lamps();
+    for (ii = 0; ii < coreGlobals.nLamps; ii++)
+      add('L', CORE_MODOUT_LAMP0 + ii, CORE_MODOUT_LAMP0, outexport_byte(coreGlobals.physicOutputState[CORE_MODOUT_LAMP0 + ii].value));
+  }
+  else {
+    for (ii = 0; ii < (8 + core_gameData->hw.lampCol) * 8; ii++)
+      add('L', CORE_MODOUT_LAMP0 + ii, CORE_MODOUT_LAMP0, ((coreGlobals.lampMatrix[ii >> 3] >> (ii & 7)) & 1) ? 255 : 0);
+  }
+
+  /*-- GI, WPC levels 0..8 are scaled to 0..255 --*/
+  if (coreGlobals.nGI && (options.usemodsol & CORE_MODOUT_ENABLE_PHYSOUT_GI)) {
+    core_update_pwm_gis();
+    for (ii = 0; ii < coreGlobals.nGI; ii++)
+      add('G', CORE_MODOUT_GI0 + ii, CORE_MODOUT_GI0, outexport_byte(coreGlobals.physicOutputState[CORE_MODOUT_GI0 + ii].value));
+  }
+  else {
+    for (ii = 0; ii < CORE_MAXGI; ii++)
+      add('G', CORE_MODOUT_GI0 + ii, CORE_MODOUT_GI0, (UINT8)((coreGlobals.gi[ii] > 8 ? 8 : coreGlobals.gi[ii]) * 255 / 8));
+  }
+
+  /*-- alphanumeric segments, only exported as physical outputs --*/
+  if (coreGlobals.nAlphaSegs && (options.usemodsol & CORE_MODOUT_ENABLE_PHYSOUT_ALPHASEGS)) {
+    core_update_pwm_segments();
+    for (ii = 0; ii < coreGlobals.nAlphaSegs; ii++)
+      add('A', CORE_MODOUT_SEG0 + ii, CORE_MODOUT_SEG0, outexport_byte(coreGlobals.physicOutputState[CORE_MODOUT_SEG0 + ii].value));
+  }
+}
+
+static void outexport_update(int param) {
+  if (!locals.connected) {
+    if (!outexport_accept())
+      return;
+    locals.connected = TRUE;
+    locals.resync = TRUE;
+    locals.lineLength = locals.lineSent = 0;
+  }
+
+  /*-- build a new line once the previous one is sent --*/
+  if (locals.lineSent == locals.lineLength) {
+    locals.lineLength = sprintf(locals.line, "%.6f", timer_get_time());
+    locals.lineSent = 0;
+    const int header = locals.lineLength;
+    outexport_sample_outputs(outexport_add);
+    locals.resync = FALSE;
+    if (locals.lineLength == header) {
+      locals.lineLength = 0;
+      return;
+    }
+    locals.line[locals.lineLength++] = '\n';
+  }
+
+  {
+    const int written = outexport_write(locals.line + locals.lineSent, locals.lineLength - locals.lineSent);
+    if (written < 0) { // client gone, wait for the next one
+      outexport_disconnect();
+      locals.connected = FALSE;
+      return;
+    }
+    locals.lineSent += written;
+  }
+}
+
+void outexport_start(void) {
+  memset(&locals, 0, sizeof(locals));
+#if defined(_WIN32) || defined(_WIN64)
+  locals.pipe = INVALID_HANDLE_VALUE;
+#else
+  locals.listenFd = locals.clientFd = -1;
+#endif
+  if (g_output_export == NULL || g_output_export[0] == 0 || g_output_export_rate <= 0)
+    return;
+  if (!outexport_open(g_output_export)) {
+    logerror("Output export: unable to open %s\n", g_output_export);
+    return;
+  }
+  locals.active = TRUE;
+  locals.timer = timer_alloc(outexport_update);
+  timer_adjust(locals.timer, TIME_IN_HZ(g_output_export_rate), 0, TIME_IN_HZ(g_output_export_rate));
+}
+
+void outexport_stop(void) {
+  if (!locals.active)
+    return;
+  if (locals.timer)
+    timer_remove(locals.timer);
+  outexport_close();
+  locals.active = FALSE;
+  locals.timer = NULL;
+}
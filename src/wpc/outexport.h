@@ -0,0 +1,38 @@
+// license:BSD-3-Clause
+
+#ifndef INC_OUTEXPORT
+#define INC_OUTEXPORT
+#if !defined(__GNUC__) || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || (__GNUC__ >= 4)	// GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+/*----------------------------------------------------------------
+/ Output exporter: streams the changes of the solenoids, lamps, GI and
+/ alphanumeric segments to one local client (DOF or any other toy
+/ controller), without any poll from the table script.
+/
+/ g_output_export is the endpoint, NULL or empty to disable the exporter:
+/ a named pipe on Windows (\\.\pipe\ is prepended if missing), a Unix
+/ domain socket path elsewhere. g_output_export_rate is the number of
+/ updates per emulated second.
+/
+/ Each update with changes is one text line: the emulated time, followed
+/ by the changed outputs as <type><no>=<value>, type being S (solenoid),
+/ L (lamp), G (GI) or A (alphanumeric segment), no starting at 1 like
+/ Controller.ModOutputType, value from 0 to 255. For example:
+/   12.345678 S5=255 L23=0 G2=128
+/ All outputs are sent when a client connects. Updates are dropped while
+/ the client does not read them, a later update then carries the changes.
+/---------------------------------------------------------------*/
+extern char* g_output_export;
+extern int g_output_export_rate;
+
+extern void outexport_start(void);
+extern void outexport_stop(void);
+
+/*-- samples all the outputs, calling add for each with its type (see
+     above), its index in physicOutputState, the index of the first output
+     of its type and its value; also used by the network publisher --*/
+extern void outexport_sample_outputs(void (*add)(char type, int index, int base, UINT8 value));
+
+#endif /* INC_OUTEXPORT */
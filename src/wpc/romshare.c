@@ -0,0 +1,211 @@
+// license:BSD-3-Clause
+
+/***************************************************************************
+ ROM region sharing (see romshare.h)
+
+ The cache files are written to a temporary name and renamed, so an
+ instance never maps a partly written file, and the instances loading
+ the same ROM at the same time just write it twice. On POSIX systems
+ the all zero pages are left as holes, so the mostly empty regions
+ (e.g. the 80MB SAM CPU region) stay small on disk and, as with the
+ calloc'ed memory they replace, are not resident until they are read.
+***************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "romshare.h"
+#include "sha1.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+ #include <windows.h>
+ #define ROMSHARE_SUPPORTED
+#elif defined(__linux__) || defined(__APPLE__)
+ #include <sys/types.h>
+ #include <sys/mman.h>
+ #include <fcntl.h>
+ #include <unistd.h>
+ #define ROMSHARE_SUPPORTED
+#endif
+
+#define ROMSHARE_PAGE      4096
+#define ROMSHARE_MIN       0x10000 // smaller regions are not worth a mapping
+#define ROMSHARE_MAPPINGS  32
+
+static struct {
+  char dir[512];
+  struct { UINT8* base; size_t length; } map[ROMSHARE_MAPPINGS];
+} locals;
+
+void romshare_config(const char* dir) {
+  if (dir && strlen(dir) < sizeof(locals.dir))
+    strcpy(locals.dir, dir);
+  else
+    locals.dir[0] = '\0';
+}
+
+int romshare_mapped(const UINT8* base) {
+  int i;
+  if (base)
+    for (i = 0; i < ROMSHARE_MAPPINGS; i++)
+      if (locals.map[i].base == base)
+        return 1;
+  return 0;
+}
+
+#ifdef ROMSHARE_SUPPORTED
+
+static const UINT8 zeropage[ROMSHARE_PAGE];
+
+// cache file name: SHA1 and length of the contents
+static int romshare_path(char* path, size_t size, const UINT8* base, size_t length) {
+  struct sha1_ctx ctx;
+  UINT8 digest[20];
+  char hex[41];
+  size_t pos;
+  int i;
+
+  sha1_init(&ctx);
+  for (pos = 0; pos < length; pos += 0x100000)
+    sha1_update(&ctx, (unsigned)(length - pos < 0x100000 ? length - pos : 0x100000), base + pos);
+  sha1_final(&ctx);
+  sha1_digest(&ctx, sizeof(digest), digest);
+  for (i = 0; i < 20; i++)
+    sprintf(hex + 2*i, "%02x", digest[i]);
+
+  return snprintf(path, size, "%s/%s-%lx.rom", locals.dir, hex, (unsigned long)length) < (int)size;
+}
+
+#if defined(_WIN32) || defined(_WIN64)
+
+static int romshare_write(const char* path, const UINT8* base, size_t length) {
+  char tmp[600];
+  HANDLE hFile;
+  size_t pos;
+  int ok = 1;
+
+  snprintf(tmp, sizeof(tmp), "%s.%lu", path, (unsigned long)GetCurrentProcessId());
+  hFile = CreateFileA(tmp, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (hFile == INVALID_HANDLE_VALUE)
+    return 0;
+  for (pos = 0; ok && pos < length; pos += 0x100000) {
+    const DWORD size = (DWORD)(length - pos < 0x100000 ? length - pos : 0x100000);
+    DWORD written;
+    ok = WriteFile(hFile, base + pos, size, &written, NULL) && written == size;
+  }
+  CloseHandle(hFile);
+  if (ok && !MoveFileExA(tmp, path, MOVEFILE_REPLACE_EXISTING))
+    ok = GetFileAttributesA(path) != INVALID_FILE_ATTRIBUTES; // written by another instance meanwhile
+  if (!ok)
+    DeleteFileA(tmp);
+  return ok;
+}
+
+static UINT8* romshare_open(const char* path, size_t length) {
+  LARGE_INTEGER size;
+  HANDLE hMap;
+  UINT8* map = NULL;
+  const HANDLE hFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+  if (hFile == INVALID_HANDLE_VALUE)
+    return NULL;
+  if (GetFileSizeEx(hFile, &size) && (UINT64)size.QuadPart == (UINT64)length) {
+    hMap = CreateFileMappingA(hFile, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    if (hMap) {
+      map = (UINT8*)MapViewOfFile(hMap, FILE_MAP_COPY, 0, 0, length);
+      CloseHandle(hMap); // the view keeps the mapping open
+    }
+  }
+  CloseHandle(hFile);
+  return map;
+}
+
+static void romshare_unmap(UINT8* map, size_t length) {
+  UnmapViewOfFile(map);
+}
+
+#else
+
+static int romshare_write(const char* path, const UINT8* base, size_t length) {
+  char tmp[600];
+  size_t pos;
+  int fd, ok = 1;
+
+  snprintf(tmp, sizeof(tmp), "%s.%ld", path, (long)getpid());
+  fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+    return 0;
+  for (pos = 0; ok && pos < length; pos += ROMSHARE_PAGE) {
+    const size_t size = length - pos < ROMSHARE_PAGE ? length - pos : ROMSHARE_PAGE;
+    if (memcmp(base + pos, zeropage, size) != 0)
+      ok = pwrite(fd, base + pos, size, (off_t)pos) == (ssize_t)size;
+  }
+  ok = ok && ftruncate(fd, (off_t)length) == 0;
+  ok = (close(fd) == 0) && ok;
+  ok = ok && rename(tmp, path) == 0;
+  if (!ok)
+    unlink(tmp);
+  return ok;
+}
+
+static UINT8* romshare_open(const char* path, size_t length) {
+  void* map = MAP_FAILED;
+  const int fd = open(path, O_RDONLY);
+  off_t size;
+
+  if (fd < 0)
+    return NULL;
+  size = lseek(fd, 0, SEEK_END);
+  if (size == (off_t)length)
+    map = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd); // the mapping keeps the file open
+  return map == MAP_FAILED ? NULL : (UINT8*)map;
+}
+
+static void romshare_unmap(UINT8* map, size_t length) {
+  munmap(map, length);
+}
+
+#endif
+
+UINT8* romshare_map(UINT8* base, size_t length) {
+  char path[560];
+  UINT8* map;
+  int slot;
+
+  if (!locals.dir[0] || !base || length < ROMSHARE_MIN)
+    return base;
+  for (slot = 0; slot < ROMSHARE_MAPPINGS && locals.map[slot].base; slot++)
+    ;
+  if (slot == ROMSHARE_MAPPINGS || !romshare_path(path, sizeof(path), base, length))
+    return base;
+
+  map = romshare_open(path, length);
+  if (!map && romshare_write(path, base, length))
+    map = romshare_open(path, length);
+  if (!map)
+    return base;
+
+  free(base);
+  locals.map[slot].base = map;
+  locals.map[slot].length = length;
+  return map;
+}
+
+void romshare_free(UINT8* base) {
+  int i;
+  for (i = 0; i < ROMSHARE_MAPPINGS; i++)
+    if (base && locals.map[i].base == base) {
+      romshare_unmap(base, locals.map[i].length);
+      locals.map[i].base = NULL;
+      return;
+    }
+  free(base);
+}
+
+#else
+
+UINT8* romshare_map(UINT8* base, size_t length) { return base; }
+void romshare_free(UINT8* base) { free(base); }
+
+#endif
@@ -0,0 +1,33 @@
+// license:BSD-3-Clause
+
+#ifndef INC_ROMSHARE
+#define INC_ROMSHARE
+#if !defined(__GNUC__) || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || (__GNUC__ >= 4)	// GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <stddef.h>
+#include "osd_cpu.h"
+
+/*----------------------------------------------------------------
+/ ROM region sharing: once loaded, the ROM regions are backed by a
+/ private (copy on write) mapping of a cache file named by the SHA1
+/ of their contents. The clones and the instances running the same
+/ ROM images then share the pages of the OS file cache instead of
+/ each holding its own copy; a page written by the emulation (RAM
+/ inside a CPU region, driver patches) becomes private to it.
+/
+/ romshare_config sets the cache directory, NULL or "" (the default)
+/ disables the sharing. The files are written once and never removed.
+/
+/ romshare_map returns the mapping replacing base (which is then freed)
+/ or base itself if the region is not shared. Memory returned by it
+/ must be released with romshare_free, which also frees the regions
+/ that were not shared.
+/---------------------------------------------------------------*/
+extern void romshare_config(const char* dir);
+extern UINT8* romshare_map(UINT8* base, size_t length);
+extern int romshare_mapped(const UINT8* base);
+extern void romshare_free(UINT8* base);
+
+#endif /* INC_ROMSHARE */
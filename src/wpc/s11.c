@@ -167,7 +167,7 @@ static INTERRUPT_GEN(s11_vblank) {
           tmpLamps >>= 1;
         }
       }
-      procFlush();
+      procRequestFlush();
     }
 #endif //PROC_SUPPORT
     memcpy(coreGlobals.lampMatrix, coreGlobals.tmpLampMatrix, sizeof(coreGlobals.tmpLampMatrix));
@@ -784,6 +784,8 @@ static SWITCH_UPDATE(s11) {
   }
 #endif
 
+  pia_mark_input_dirty(S11_PIA2, PIA_INPUT_A);
+
   /*-- Generate interupts for diganostic keys --*/
   cpu_set_nmi_line(0, core_getSw(S11_SWCPUDIAG) ? ASSERT_LINE : CLEAR_LINE);
   sndbrd_0_diag(core_getSw(S11_SWSOUNDDIAG));
@@ -829,6 +831,8 @@ static MACHINE_INIT(s11) {
   pia_config(S11_PIA3, PIA_STANDARD_ORDERING, &s11_pia[3]);
   pia_config(S11_PIA4, PIA_STANDARD_ORDERING, &s11_pia[4]);
   pia_config(S11_PIA5, PIA_STANDARD_ORDERING, &s11_pia[5]);
+  /* jumper W7 only changes with the DIPs, re-read once per switch update */
+  pia_set_input_cache(S11_PIA2, PIA_INPUT_A);
 
   /*Additional hardware dependent init code*/
   switch (core_gameData->gen) {
@@ -193,7 +193,7 @@ void update_proc_coils(UINT8 cur_data, UINT8 last_data, int coil_index) {
       changed_data >>= 1;
       cur_data >>= 1;
     }
-    procFlush();
+    procRequestFlush();
   }
 }
 #endif
@@ -362,7 +362,7 @@ static INTERRUPT_GEN(s4_vblank) {
           tmpLamps >>= 1;
         }
       }
-      procFlush();
+      procRequestFlush();
     }
 #endif
     memcpy(coreGlobals.lampMatrix, coreGlobals.tmpLampMatrix, sizeof(coreGlobals.tmpLampMatrix));
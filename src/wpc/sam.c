@@ -30,6 +30,7 @@
   03/09/2012 - Added SAM2 generation for extended memory, and possible stereo support one day
 ************************************************************************************************/
 
+#include <math.h>
 #include "driver.h"
 #include "core.h"
 #include "sim.h"
@@ -39,10 +40,23 @@
 #include "sndbrd.h"
 #include "mech.h"
 
+#if (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || defined(__x86_64__)
+ #define SSE_DMD_OPT
+ #include <emmintrin.h>
+#elif (defined(_M_ARM) || defined(_M_ARM64) || defined(__arm__) || defined(__arm64__) || defined(__aarch64__)) && (!defined(__ARM_ARCH) || __ARM_ARCH >= 7) && (!defined(_MSC_VER) || defined(__clang__)) //!! disable sse2neon if MSVC&non-clang
+ #define SSE_DMD_OPT // uses sse2neon then
+ #include "../../ext/sse2neon.h"
+#endif
+
 #if defined(VPINMAME)
 extern void dmddeviceFwdConsoleData(UINT8 data);
 #elif defined(LIBPINMAME)
 extern void libpinmame_forward_console_data(void* data, int size);
+extern int  libpinmame_nodebus_mode(void);
+extern void libpinmame_nodebus_message(int channel, const UINT8* data, int size);
+extern void libpinmame_nodebus_flush(void);
+extern int  libpinmame_nodebus_response(UINT8* data, int maxSize);
+extern void libpinmame_nodebus_response_sent(int size);
 #endif
 
 // Defines
@@ -121,12 +135,21 @@ int at91_receive_serial(int usartno, data8_t *buf, int size);
 /*----------------
 / Local variables
 /-----------------*/
+#define SAM_DMD_PAGELOG 64
+#define SAM_DMD_ROW_TIME (12 * 41.6e-6)           // each row is rasterized 2 / 4 / 1 / 5 times 41.6us
+#define SAM_DMD_FRAME_TIME (32 * SAM_DMD_ROW_TIME) // 15.97ms, 62.6Hz
+
 struct {
 	int vblankCount;
 	UINT8 diagnosticLed;
 	int sw_stb;
 	UINT8 zc; // bool
 	int video_page[2];
+	// DMD page register changes since the last display update, to find the pages each row was rasterized from
+	struct { double time; int page[2]; } pageLog[SAM_DMD_PAGELOG];
+	int pageLogCount;
+	int dmdPage[2];      // pages at dmdUpdateTime
+	double dmdUpdateTime;
 	INT16 samplebuf[2][SNDBUFSIZE];
 	INT16 lastsamp[2];
 	int sampout;
@@ -355,6 +378,35 @@ static int dedswitch_upper_r(void)
 static void sam_init_nodeboard(int bridge);
 static void sam_nodebus_transmit(int usartno, data8_t* data, int size);
 
+#if defined(LIBPINMAME)
+// Host bridge, same values as PINMAME_NODEBUS_MODE and PINMAME_NODEBUS_CHANNEL
+#define SAM_NBHOST_OFF      0
+#define SAM_NBHOST_MONITOR  1
+#define SAM_NBHOST_BRIDGE   2
+
+#define SAM_NBHOST_REQUEST  0
+#define SAM_NBHOST_RESPONSE 1
+#define SAM_NBHOST_CONSOLE  2
+
+static struct {
+	int        mode;
+	mame_timer *timer;
+} nbhost;
+
+// Every emulated ms: deliver the traffic to the host and push its responses to the CPU board
+static void sam_nodebus_host_sync(int param) {
+	UINT8 data[256];
+	int size;
+	libpinmame_nodebus_flush();
+	while ((size = libpinmame_nodebus_response(data, sizeof(data))) > 0) {
+		const int sent = size - at91_receive_serial(0, data, size);
+		libpinmame_nodebus_response_sent(sent);
+		if (sent < size)
+			break;
+	}
+}
+#endif
+
 static int sam_getSol(int solNo)
 {
 	return coreGlobals.physicOutputState[CORE_MODOUT_SOL0 + solNo - 1].value > 0.5f;
@@ -681,6 +733,13 @@ static WRITE32_HANDLER(samdmdram_w)
 	    samlocals.video_page[1] = data >> 16;
 	  else
 	    samlocals.video_page[0] = data;
+	  {
+	    // keep the time of the change for the display update, the last entry takes further changes if the log is full
+	    const int n = samlocals.pageLogCount < SAM_DMD_PAGELOG ? samlocals.pageLogCount++ : SAM_DMD_PAGELOG - 1;
+	    samlocals.pageLog[n].time = timer_get_time();
+	    samlocals.pageLog[n].page[0] = samlocals.video_page[0];
+	    samlocals.pageLog[n].page[1] = samlocals.video_page[1];
+	  }
 	  break;
 
 	// ?? - The code reads the dips, and if the value read is 0x76, this address is never written to, otherwise
@@ -738,6 +797,11 @@ static WRITE32_HANDLER(sambank_w)
 
 				//Swap bank memory
 				cpu_setbank(SAM_ROMBANK0, memory_region(REGION_USER1) + (data << 23));
+#ifdef SAM_USE_JIT
+				//only does something if the JIT range was extended over the bank window (at91jit option)
+				if (data != samlocals.bank)
+					at91_jit_invalidate(0x04800000, 0x00800000);
+#endif
 
 				//save value for read @ 1180000
 				samlocals.bank = data;
@@ -1456,6 +1520,14 @@ static MACHINE_INIT(sam) {
 		for (int i = 0; i < coreGlobals.nSolenoids; i++)
 			if (coreGlobals.physicOutputState[i].type != CORE_MODOUT_SOL_2_STATE)
 				core_set_pwm_output_type(CORE_MODOUT_SOL0, 1, CORE_MODOUT_LEGACY_SOL_2_STATE);
+#if defined(LIBPINMAME)
+	nbhost.mode = libpinmame_nodebus_mode();
+	nbhost.timer = NULL;
+	if (nbhost.mode != SAM_NBHOST_OFF) {
+		nbhost.timer = timer_alloc(sam_nodebus_host_sync);
+		timer_adjust(nbhost.timer, TIME_IN_MSEC(1), 0, TIME_IN_MSEC(1));
+	}
+#endif
 }
 
 void sam_init(void)
@@ -1596,6 +1668,14 @@ static MACHINE_STOP(sam) {
 	if(fpSND) fclose(fpSND);
 	fpSND = NULL;
 	#endif
+#if defined(LIBPINMAME)
+	if (nbhost.timer) {
+		timer_remove(nbhost.timer);
+		libpinmame_nodebus_flush();
+	}
+	nbhost.timer = NULL;
+	nbhost.mode = SAM_NBHOST_OFF;
+#endif
 }
 
 static SWITCH_UPDATE(sam) {
@@ -1853,6 +1933,10 @@ static void sam_nodebus_send_flush(sam_nodeboard_t* nodeboard, int reqResponseSi
 		printf("\n");
 	#endif
 
+	#if defined(LIBPINMAME)
+		if (nbhost.mode != SAM_NBHOST_OFF)
+			libpinmame_nodebus_message(SAM_NBHOST_RESPONSE, nblocals.sendMsg, nblocals.sendMsgPos);
+	#endif
 	int remaining = at91_receive_serial(0, nblocals.sendMsg, nblocals.sendMsgPos);
 	#if LOG_NODEBOARD
 		if (remaining)
@@ -2068,6 +2152,11 @@ static void sam_nodebus_transmit(int usartno, data8_t *data, int size)
 				// Broadcasted messages have an additional expected response length byte which is not included in the payload length
 				msgLength = ((nblocals.rcvMsg[0] & 0x80) != 0) ? (2 + nblocals.rcvMsg[1] + 1) : (2 + nblocals.rcvMsg[1]);
 			if (nblocals.rcvMsgPos == msgLength - 1) {
+#if defined(LIBPINMAME)
+				if (nbhost.mode != SAM_NBHOST_OFF)
+					libpinmame_nodebus_message(SAM_NBHOST_REQUEST, nblocals.rcvMsg, msgLength);
+				if (nbhost.mode != SAM_NBHOST_BRIDGE)
+#endif
 				sam_nodebus_msg_received();
 				nblocals.rcvMsgPos = 0;
 				nblocals.rcvChecksum = 0;
@@ -2088,7 +2177,10 @@ static void sam_nodebus_transmit(int usartno, data8_t *data, int size)
 		while(size--)
 			dmddeviceFwdConsoleData(*(data++));
 #elif defined(LIBPINMAME)
-		libpinmame_forward_console_data(data, size);
+		if (nbhost.mode != SAM_NBHOST_OFF)
+			libpinmame_nodebus_message(SAM_NBHOST_CONSOLE, data, size);
+		else
+			libpinmame_forward_console_data(data, size);
 #endif
 	}
 }
@@ -2199,30 +2291,91 @@ MACHINE_DRIVER_END
   least the last 24 frames. For the time being we only apply a LUT corresponding
   to the 1 / 2 / 4 / 5 pattern.
 --*/
-static PINMAME_VIDEO_UPDATE(samdmd_update) {
+// Mix the two pages of row ii into raw shades and luminance
+static void sam_dmd_mix_row(const int ii, const int page0, const int page1, UINT8* dotRaw, UINT8* dotLum) {
 	// This LUT suppose that each bitplane correspond to one of the frame, since the display length is 1 / 2 / 4 / 5,
 	// RAM never contains 8/9/10/11 which creates a monotonic LUT, but with a discontinuity as the hardware has 13 shades while the code uses 12.
 	static const UINT8 lumLUT[16] = { 0, 21, 43, 64, 85, 106, 128, 149, 106 /*unused*/, 128 /*unused*/, 149 /*unused*/, 170 /*unused*/, 191, 213, 234, 255};
+	const UINT8* const offs1 = memory_region(REGION_CPU1) + 0x1080000 + (page0 << 12) + ii * 128;
+	const UINT8* const offs2 = memory_region(REGION_CPU1) + 0x1080000 + (page1 << 12) + ii * 128;
+	int jj;
+#if defined(SSE_DMD_OPT) && !LOGALL
+	// 16 dots at a time: the LUT is 255/12 steps of the shade, skipping the unused values 8..11, so it is computed as
+	// lum = ((temp < 8 ? temp : temp - 3) * 255 + 6) / 12, the division being done by a 16 bit multiply (exact for these values)
+	const __m128i lowNibble = _mm_set1_epi8(0x0F);
+	const __m128i seven = _mm_set1_epi8(7);
+	const __m128i three = _mm_set1_epi8(3);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i mul255 = _mm_set1_epi16(255);
+	const __m128i round6 = _mm_set1_epi16(6);
+	const __m128i div12 = _mm_set1_epi16(5462);
+	(void)lumLUT;
+	for( jj = 0; jj < 128; jj += 16 )
+	{
+		const __m128i RAM1 = _mm_loadu_si128((const __m128i*)(offs1 + jj));
+		const __m128i RAM2 = _mm_loadu_si128((const __m128i*)(offs2 + jj));
+		const __m128i mix = _mm_and_si128(_mm_srli_epi16(RAM1, 4), lowNibble);
+		const __m128i temp = _mm_and_si128(_mm_or_si128(_mm_and_si128(RAM2, mix), _mm_andnot_si128(mix, RAM1)), lowNibble);
+		const __m128i shade = _mm_sub_epi8(temp, _mm_and_si128(_mm_cmpgt_epi8(temp, seven), three));
+		const __m128i lumLo = _mm_mulhi_epu16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(shade, zero), mul255), round6), div12);
+		const __m128i lumHi = _mm_mulhi_epu16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(shade, zero), mul255), round6), div12);
+		_mm_storeu_si128((__m128i*)(dotRaw + jj), temp);
+		_mm_storeu_si128((__m128i*)(dotLum + jj), _mm_packus_epi16(lumLo, lumHi));
+	}
+#else
+	for( jj = 0; jj < 128; jj++ )
+	{
+		const UINT8 RAM1 = offs1[jj];
+		const UINT8 RAM2 = offs2[jj];
+		const UINT8 mix = RAM1 >> 4;
+		const UINT8 temp = (RAM2 & mix) | (RAM1 & (mix^0xF)); //!! is this correct or is mix rather a multiplier/ratio/alphavalue??
+		if ((mix != 0xF) && (mix != 0x0)) //!! happens e.g. in POTC in extra ball explosion animation: RAM1 values triggering this: 223, 190, 175, 31, 25, 19, 17 with RAM2 being always 0. But is this just wrong game data (as its a converted animation)?!
+			LOG(("Special DMD Bitmask %01X RAM1=%02x RAM2=%02x pix@(%3dx%2d)", mix, RAM1, RAM2, jj, ii));
+		*dotRaw++ = temp;
+		*dotLum++ = lumLUT[temp];
+	}
+#endif
+}
+
+static PINMAME_VIDEO_UPDATE(samdmd_update) {
+	// Interframe emulation: the display rasterizes row ii at ii * SAM_DMD_ROW_TIME into each SAM_DMD_FRAME_TIME frame. For each
+	// row, the pages are taken as they were when the row was rasterized during the time elapsed since the last update (from the
+	// logged page register changes), and the luminance is averaged if it was rasterized more than once. Page flips in the middle
+	// of a display frame are therefore only seen by the rows rasterized after them, like on the real display.
+	const double now = timer_get_time();
+	const double from = now - samlocals.dmdUpdateTime > 4 * SAM_DMD_FRAME_TIME ? now - 4 * SAM_DMD_FRAME_TIME : samlocals.dmdUpdateTime; // skipped frames
 	int ii;
 	for( ii = 0; ii < 32; ii++ )
 	{
 		UINT8 *dotRaw = &coreGlobals.dmdDotRaw[ii * layout->length];
 		UINT8 *dotLum = &coreGlobals.dmdDotLum[ii * layout->length];
-		const UINT8* const offs1 = memory_region(REGION_CPU1) + 0x1080000 + (samlocals.video_page[0] << 12) + ii * 128;
-		const UINT8* const offs2 = memory_region(REGION_CPU1) + 0x1080000 + (samlocals.video_page[1] << 12) + ii * 128;
-		int jj;
-		for( jj = 0; jj < 128; jj++ )
-		{
-			const UINT8 RAM1 = offs1[jj];
-			const UINT8 RAM2 = offs2[jj];
-			const UINT8 mix = RAM1 >> 4;
-			const UINT8 temp = (RAM2 & mix) | (RAM1 & (mix^0xF)); //!! is this correct or is mix rather a multiplier/ratio/alphavalue??
-			if ((mix != 0xF) && (mix != 0x0)) //!! happens e.g. in POTC in extra ball explosion animation: RAM1 values triggering this: 223, 190, 175, 31, 25, 19, 17 with RAM2 being always 0. But is this just wrong game data (as its a converted animation)?!
-				LOG(("Special DMD Bitmask %01X RAM1=%02x RAM2=%02x pix@(%3dx%2d)", mix, RAM1, RAM2, jj, ii));
-			*dotRaw++ = temp;
-			*dotLum++ = lumLUT[temp];
+		const double rowOffset = (ii + 0.5) * SAM_DMD_ROW_TIME; // middle of the row rasterization
+		double t = floor((from - rowOffset) / SAM_DMD_FRAME_TIME + 1.0) * SAM_DMD_FRAME_TIME + rowOffset; // first one after 'from'
+		int page[2] = { samlocals.dmdPage[0], samlocals.dmdPage[1] };
+		int log = 0, n = 0;
+		UINT16 lumSum[128];
+		UINT8 raw[128], lum[128];
+		if (samlocals.pageLogCount == 0 || t > now) { // no page change, or not rasterized (first update): use the last pages
+			sam_dmd_mix_row(ii, samlocals.video_page[0], samlocals.video_page[1], dotRaw, dotLum);
+			continue;
+		}
+		for (; t <= now; t += SAM_DMD_FRAME_TIME, n++) {
+			for (; log < samlocals.pageLogCount && samlocals.pageLog[log].time <= t; log++) {
+				page[0] = samlocals.pageLog[log].page[0];
+				page[1] = samlocals.pageLog[log].page[1];
+			}
+			sam_dmd_mix_row(ii, page[0], page[1], raw, lum);
+			for (int jj = 0; jj < 128; jj++)
+				lumSum[jj] = (n ? lumSum[jj] : 0) + lum[jj];
 		}
+		memcpy(dotRaw, raw, 128); // the last rasterized shades
+		for (int jj = 0; jj < 128; jj++)
+			dotLum[jj] = (UINT8)((lumSum[jj] + n / 2) / n);
 	}
+	samlocals.dmdPage[0] = samlocals.video_page[0];
+	samlocals.dmdPage[1] = samlocals.video_page[1];
+	samlocals.dmdUpdateTime = now;
+	samlocals.pageLogCount = 0;
 	core_dmd_video_update(bitmap, cliprect, layout, NULL);
 	return 0;
 }
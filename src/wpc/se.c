@@ -199,7 +199,7 @@ static INTERRUPT_GEN(se_vblank) {
 					tmpSol >>= 1;
 				}
 			}
-			procFlush();
+			procRequestFlush();
 			// TODO/PROC: This doesn't seem to be happening in core.c.  Why not?
 			lastSol = allSol;
 		}
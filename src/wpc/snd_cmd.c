@@ -41,15 +41,7 @@
 #define LOG(x)
 #endif
 
-#ifndef _WIN32
- #include <sys/time.h>
- static unsigned int timeGetTime2()
- {
-   struct timeval now;
-   gettimeofday(&now, NULL);
-   return now.tv_usec/1000;
- }
-#else
+#ifdef _WIN32
  #ifndef WIN32_LEAN_AND_MEAN
  #define WIN32_LEAN_AND_MEAN
  #endif
@@ -66,13 +58,7 @@
  #endif
  #include <windows.h>
  #include <direct.h>
- #if !defined(__MINGW32__) || defined(VPINMAME)
-  #define timeGetTime2 GetTickCount
- #else
-  static DWORD timeGetTime2(void) {
-    return (DWORD)(timer_get_time()*1000.); //!! meh!
-  }
- #endif
+ #define timeGetTime2 GetTickCount
 #endif
 
 #ifdef VPINMAME_ALTSOUND // for alternate/external sound processing
@@ -92,6 +78,19 @@
  static HANDLE hFilePinSound;
  static HANDLE hFilePinMAME;
 
+ /* the commands are written to the mailslot (and to the PSREC file) by an
+    I/O thread, so a slow PinSound Studio never stalls the emulation */
+ #define PINSOUND_QUEUE 256 /* commands waiting for the I/O thread, power of 2 */
+ static struct {
+   HANDLE thread;
+   HANDLE wake;                /* auto reset, set when commands are queued and at exit */
+   volatile LONG head;         /* commands queued, written by the emulation thread */
+   volatile LONG tail;         /* commands sent, written by the I/O thread */
+   volatile LONG quit;
+   UINT32 dropped;
+   struct { int cmd; DWORD time; BOOL log; } queue[PINSOUND_QUEUE];
+ } pinsound_io;
+
  void pinsound_exit();
 #endif
 
@@ -124,8 +123,6 @@ static struct {
   int digitMode;
   int currDigit;
   int digits[MAX_CMD_LENGTH*2];
-  int cmdLog[MAX_CMD_LOG];
-  int firstLog;
   mem_write_handler soundCmd;
   int boards; // 0 = none, 1 = board0, 2 = board1, 3 = both
   int rollover; 
@@ -133,18 +130,29 @@ static struct {
   int nextCmd[MAX_CMD_LENGTH+1];
 } locals;
 
+#define WAVE_BUFFER_SIZE (256*1024) /* bytes collected before they hit the disk */
+
 static struct {
   void* file;
   UINT32 offs;
+  UINT8 *buffer;        /* pending sample data, flushed in large blocks */
+  UINT32 buffered;
+  int writeerror;
   int recording;
   int dumping;
   int spinner;
   int nextWaveFileNo;
-  UINT32 startTick;
-  UINT32 silence;
-  int silentsamples;
+  UINT32 position;      /* emulated samples since the dump file was opened */
+  UINT32 silence;       /* position of the last non silent frame */
+  UINT32 silentsamples; /* silence held back until the sound continues */
+  int ripping;          /* 0 = off, 1 = warming up, 2 = dumping, 3 = done */
+  UINT32 ripwarmup;     /* emulated samples left before the first command */
 } wavelocals;
 
+#define DUMP_SILENCE_SECONDS  2   /* end of a clip */
+#define DUMP_MAX_SECONDS    240   /* longest clip */
+#define RIP_WARMUP_SECONDS    5   /* let the sound board boot before the first command */
+
 static void wave_init(void);
 static void wave_exit(void);
 static void wave_handle(void);
@@ -166,6 +174,12 @@ void snd_cmd_init(void) {
   }
   for (ii = 0; ii < MAX_CMD_LENGTH*2; ii++) locals.digits[ii] = 0x10;
   wave_init();
+
+#if defined(VPINMAME_ALTSOUND) && defined(ALTSOUND_NATIVE_MIXER)
+  // altsound plays through the PinMAME mixer, the channel must exist before the first command
+  if (options.samplerate != 0 && pmoptions.sound_mode == 1)
+    alt_sound_mixer_start();
+#endif
 }
 
 /*----------------------------------------*/
@@ -285,7 +299,7 @@ static BOOL readSlot(const HANDLE hFile, char * msg)
 	}
 
 	// if there are any data waiting to be read
-	if (msgSize > 0)
+	if (msgSize != MAILSLOT_NO_MESSAGE && msgSize > 0)
 	{
 		// Allocate buffer memory
 		buffer = (LPTSTR) GlobalAlloc(GPTR, msgSize); //Combines GMEM_FIXED and GMEM_ZEROINIT.
@@ -323,17 +337,109 @@ static BOOL readSlot(const HANDLE hFile, char * msg)
 	return FALSE;
 }
 
+static DWORD WINAPI pinsound_io_thread(LPVOID param)
+{
+	for (;;)
+	{
+		const LONG head = InterlockedCompareExchange(&pinsound_io.head, 0, 0);
+		LONG tail = pinsound_io.tail;
+		BOOL logged = FALSE;
+
+		// send all the queued commands, one mailslot message each
+		for (; tail != head; tail++)
+		{
+			const int i = (int)((ULONG)tail & (PINSOUND_QUEUE - 1));
+			TCHAR cmd_to_pinsound_studio[100];
+			_stprintf( cmd_to_pinsound_studio, _T("%02x"), pinsound_io.queue[i].cmd );
+			sendToSlot(hFilePinSound, cmd_to_pinsound_studio);
+
+			// write the sound cmd to PSREC file
+			if (fp_pinsound_log && pinsound_io.queue[i].log) {
+				fprintf(fp_pinsound_log, "%02x %lu\n", pinsound_io.queue[i].cmd, pinsound_io.queue[i].time);
+				logged = TRUE;
+			}
+		}
+		InterlockedExchange(&pinsound_io.tail, tail);
+		if (logged)
+			fflush(fp_pinsound_log);
+
+		if (InterlockedCompareExchange(&pinsound_io.quit, 0, 0) && tail == InterlockedCompareExchange(&pinsound_io.head, 0, 0))
+			return 0;
+		WaitForSingleObject(pinsound_io.wake, INFINITE);
+	}
+}
+
+static void pinsound_io_start(void)
+{
+	memset(&pinsound_io, 0, sizeof(pinsound_io));
+	pinsound_io.wake = CreateEvent(NULL, FALSE, FALSE, NULL);
+	if (pinsound_io.wake)
+		pinsound_io.thread = CreateThread(NULL, 0, pinsound_io_thread, NULL, 0, NULL);
+	if (pinsound_io.thread == NULL)
+		LOG(("PinSound: Cannot create the I/O thread, the commands are sent synchronously.\n"));
+}
+
+static void pinsound_io_stop(void)
+{
+	if (pinsound_io.thread)
+	{
+		InterlockedExchange(&pinsound_io.quit, 1);
+		SetEvent(pinsound_io.wake);
+		WaitForSingleObject(pinsound_io.thread, 2000);
+		CloseHandle(pinsound_io.thread);
+		pinsound_io.thread = NULL;
+	}
+	if (pinsound_io.wake)
+	{
+		CloseHandle(pinsound_io.wake);
+		pinsound_io.wake = NULL;
+	}
+	if (pinsound_io.dropped)
+		LOG(("PinSound: %u commands dropped, PinSound Studio did not keep up.\n", pinsound_io.dropped));
+}
+
+// queue a command for the I/O thread (sent directly if it could not be started)
+static void pinsound_send(const int cmd, const BOOL log)
+{
+	const LONG head = pinsound_io.head;
+
+	if (pinsound_io.thread == NULL)
+	{
+		TCHAR cmd_to_pinsound_studio[100];
+		_stprintf( cmd_to_pinsound_studio, _T("%02x"), cmd );
+		sendToSlot(hFilePinSound, cmd_to_pinsound_studio);
+		if (fp_pinsound_log && log) {
+			fprintf(fp_pinsound_log, "%02x %lu\n", cmd, timeGetTime2() - start_time_pinsound_log);
+			fflush(fp_pinsound_log);
+		}
+		return;
+	}
+
+	if ((ULONG)(head - InterlockedCompareExchange(&pinsound_io.tail, 0, 0)) >= PINSOUND_QUEUE)
+	{
+		pinsound_io.dropped++;
+		return;
+	}
+	{
+		const int i = (int)((ULONG)head & (PINSOUND_QUEUE - 1));
+		pinsound_io.queue[i].cmd = cmd;
+		pinsound_io.queue[i].time = timeGetTime2() - start_time_pinsound_log;
+		pinsound_io.queue[i].log = log;
+	}
+	InterlockedExchange(&pinsound_io.head, head + 1);
+	SetEvent(pinsound_io.wake);
+}
+
 static void pinsound_exit()
 {
 	// send stop-all command to the PinSound Studio
 	if (pinsound_studio_enabled)
 	{
-		TCHAR cmd_to_pinsound_studio[3];
-		_stprintf( cmd_to_pinsound_studio, _T("00") );
 		// double because we don't know if we are talking 8bits or 16bits instructions
-		sendToSlot(hFilePinSound, cmd_to_pinsound_studio);
-		sendToSlot(hFilePinSound, cmd_to_pinsound_studio);
-	
+		pinsound_send(0x00, FALSE);
+		pinsound_send(0x00, FALSE);
+		pinsound_io_stop();
+
 		CloseHandle(hFilePinSound);
 		CloseHandle(hFilePinMAME);
 
@@ -359,6 +465,7 @@ void reinit_pinSound(void)
 	char	game_rom_system[100];
 	BOOL	response;
 	char	buffer_msg[100];
+	int		wait;
 
 	if (!(pmoptions.sound_mode == 2 || pmoptions.sound_mode == 3) || options.samplerate == 0) // if not internal or external pinsound enabled, or if sound in general is disabled -> return
 		return;
@@ -386,11 +493,9 @@ void reinit_pinSound(void)
 
 	sendToSlot(hFilePinSound, game_rom_system);
 
-	// wait for the answer from the PinSound Studio
-	Sleep(500);
-
-	// read response from PinSoundStudio
-	response = readSlot(hFilePinMAME, buffer_msg);
+	// wait for the answer from the PinSound Studio, up to 500ms
+	for (wait = 0; (response = readSlot(hFilePinMAME, buffer_msg)) != TRUE && wait < 500; wait += 10)
+		Sleep(10);
 	if(response != TRUE)
 	{
 		pinsound_studio_enabled = FALSE;
@@ -408,6 +513,7 @@ void reinit_pinSound(void)
 			//int	ch;
 
 			pinsound_studio_enabled = TRUE;
+			pinsound_io_start();
 			
 			// force internal PinMAME volume mixer to 0 to mute emulated sounds & musics
 			//for(ch = 0; ch < MIXER_MAX_CHANNELS; ch++)
@@ -502,8 +608,6 @@ static void pinsound_handle(const int boardNo, const int cmd)
 		{
 			// send current sound cmd to PSStudio
 			//int	ch;
-			TCHAR cmd_to_pinsound_studio[100];
-			_stprintf( cmd_to_pinsound_studio, _T("%02x"), cmd );
 
 			// force internal PinMAME volume mixer to 0 to mute emulated sounds & musics
 			// required for WPC89 sound board
@@ -512,13 +616,8 @@ static void pinsound_handle(const int boardNo, const int cmd)
 			//		mixer_set_volume(ch, 0);
 			mixer_sound_enable_global_w(0);
 
-			sendToSlot(hFilePinSound, cmd_to_pinsound_studio);
-
-			// write current sound cmd to PSREC file
-			if (fp_pinsound_log) {
-				fprintf(fp_pinsound_log, "%02x %lu\n", cmd, timeGetTime2() - start_time_pinsound_log);
-				fflush(fp_pinsound_log);
-			}
+			// send it and write it to the PSREC file from the I/O thread
+			pinsound_send(cmd, TRUE);
 		}
 
 		// skip instruction every 2 instr
@@ -531,7 +630,26 @@ void reinit_pinSound() {}
 
 /*----------------
 / log handling
+/
+/ The commands are appended to a ring with their emulated time. The head
+/ is only stored after the entry is written and never reset, so readers
+/ on other threads need no lock: each one keeps its own cursor and drops
+/ the entries that may have been overwritten while it was copying them.
 /-----------------*/
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define SND_CMD_LOAD(p)     ((UINT32)_InterlockedOr((volatile long *)(p), 0))
+#define SND_CMD_STORE(p, v) _InterlockedExchange((volatile long *)(p), (long)(v))
+#else
+#define SND_CMD_LOAD(p)     __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define SND_CMD_STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#endif
+
+static struct {
+  volatile UINT32 head;   /* number of commands ever logged */
+  struct snd_tCmdLogEntry entries[SND_CMD_LOG_SIZE];
+} cmdLog;
+
 void snd_cmd_log(int boardNo, int cmd) {
 #ifdef VPINMAME_ALTSOUND
   if (options.samplerate != 0 && pmoptions.sound_mode == 1)
@@ -547,20 +665,65 @@ void snd_cmd_log(int boardNo, int cmd) {
 #endif
 
   if (locals.soundMode || (locals.boards == 0)) return; // Don't log from within sound commander
-  if (locals.boards == 3) {
-    locals.cmdLog[locals.firstLog++] = boardNo;
-    locals.firstLog %= MAX_CMD_LOG;
+  {
+    const UINT32 head = cmdLog.head;
+    struct snd_tCmdLogEntry* const entry = &cmdLog.entries[head & (SND_CMD_LOG_SIZE - 1)];
+    entry->time = timer_get_time();
+    entry->boardNo = boardNo;
+    entry->cmd = cmd;
+    SND_CMD_STORE(&cmdLog.head, head + 1);
   }
+}
 
-  locals.cmdLog[locals.firstLog++] = cmd;
-  locals.firstLog %= MAX_CMD_LOG;
+/*-- cursor positioned after the last logged command --*/
+UINT32 snd_cmd_log_position(void) {
+  return SND_CMD_LOAD(&cmdLog.head);
 }
 
-int snd_get_cmd_log(int *last, int *buffer) {
-  int count = 0;
-  while (*last != locals.firstLog) {
-    buffer[count++] = locals.cmdLog[(*last)++];
-    *last %= MAX_CMD_LOG;
+/*-- read the commands after the cursor, returns the number of entries copied and
+     sets *lost to the number of commands overwritten before they could be read --*/
+int snd_read_cmd_log(UINT32 *cursor, struct snd_tCmdLogEntry *entries, int max, int *lost) {
+  const UINT32 head = SND_CMD_LOAD(&cmdLog.head);
+  UINT32 first = *cursor;
+  UINT32 ii, count, newHead;
+
+  *lost = 0;
+  if (head - first > SND_CMD_LOG_SIZE) {
+    *lost = (int)(head - first - SND_CMD_LOG_SIZE);
+    first = head - SND_CMD_LOG_SIZE;
+  }
+  count = head - first;
+  if (count > (UINT32)max)
+    count = (UINT32)max;
+  for (ii = 0; ii < count; ii++)
+    entries[ii] = cmdLog.entries[(first + ii) & (SND_CMD_LOG_SIZE - 1)];
+
+  /*-- the writer may have wrapped over the first entries while they were copied --*/
+  newHead = SND_CMD_LOAD(&cmdLog.head);
+  if (newHead - first >= SND_CMD_LOG_SIZE) {
+    const UINT32 overwritten = newHead - first - SND_CMD_LOG_SIZE + 1;
+    const UINT32 drop = overwritten > count ? count : overwritten;
+    memmove(entries, entries + drop, (count - drop) * sizeof(entries[0]));
+    *lost += (int)overwritten;
+    first += overwritten;
+    count -= drop;
+  }
+  *cursor = first + count;
+  return (int)count;
+}
+
+/*-- up to MAX_CMD_LOG values: the commands, each preceded by its board number
+     if the game has two sound boards. The commands which don't fit are left
+     for the next call --*/
+int snd_get_cmd_log(UINT32 *cursor, int *buffer) {
+  struct snd_tCmdLogEntry entries[MAX_CMD_LOG];
+  const int withBoard = locals.boards == 3;
+  int lost, ii, count = 0;
+  const int read = snd_read_cmd_log(cursor, entries, withBoard ? MAX_CMD_LOG / 2 : MAX_CMD_LOG, &lost);
+  for (ii = 0; ii < read; ii++) {
+    if (withBoard)
+      buffer[count++] = entries[ii].boardNo;
+    buffer[count++] = entries[ii].cmd;
   }
   return count;
 }
@@ -581,6 +744,9 @@ int manual_sound_commands(struct mame_bitmap *bitmap) {
   /*-- we must have something to play with --*/
   if (!locals.boards) return TRUE;
 
+  /*-- the sound ripper drives everything from pm_wave_record() --*/
+  if (wavelocals.ripping) return TRUE;
+
 #ifdef MAME_DEBUG
   /*-- Keypresses interferes with mame debugger (while it's active) --*/
   if(mame_debug && debugger_focus)	return TRUE;
@@ -732,7 +898,7 @@ int manual_sound_commands(struct mame_bitmap *bitmap) {
     core_textOutf(SND_XROW, 130, BLACK, "Last commands");
     for (ii = 0; ii < MAX_CMD_LOG; ii++)
       core_textOutf(SND_XROW + 13*ii, 140, BLACK, "%02x",
-                   locals.cmdLog[(locals.firstLog+ii) % MAX_CMD_LOG]);
+                   cmdLog.entries[(cmdLog.head - MAX_CMD_LOG + ii) & (SND_CMD_LOG_SIZE - 1)].cmd);
     playCmd(-1, NULL);
     return FALSE;
   }
@@ -895,10 +1061,43 @@ static int playCmd(int length, int *cmd) {
 /* Local Functions */
 static int wave_open(char *filename);
 static void wave_close(void);
+static int wave_flush(void);
 
 
 static void wave_init(void) {
   memset(&wavelocals, 0, sizeof(wavelocals));
+  if (pmoptions.soundrip && locals.boards && Machine->sample_rate) {
+    wavelocals.ripping = 1;
+    wavelocals.ripwarmup = RIP_WARMUP_SECONDS * (UINT32)(Machine->sample_rate+0.5);
+  }
+}
+
+/*------------------------------------
+  Sound ripper: once the sound board
+  has booted, halt the game CPU(s) and
+  dump every command to its own file,
+  then ask the core to quit
+  ----------------------------------------*/
+static void rip_start(void) {
+  int ii;
+  for (ii = 0; ii < MAX_CPU; ii++)
+    if ((Machine->drv->cpu[ii].cpu_type) &&
+        (Machine->drv->cpu[ii].cpu_flags == 0))
+      cpu_set_halt_line(ii, 1);
+  locals.soundMode = 1;
+
+  for (ii = 0; ii < MAX_CMD_LENGTH*2; ii++) locals.digits[ii] = 0x10;
+  if (pmoptions.soundrip_prefix >= 0) {
+    locals.digits[MAX_CMD_LENGTH*2-4] = (pmoptions.soundrip_prefix >> 4) & 0x0f;
+    locals.digits[MAX_CMD_LENGTH*2-3] = pmoptions.soundrip_prefix & 0x0f;
+  }
+  locals.digits[MAX_CMD_LENGTH*2-2] = locals.digits[MAX_CMD_LENGTH*2-1] = 0;
+  wavelocals.ripping = 2;
+  playNextCmd(); /* starts with command 01, 00 ends the run */
+}
+
+int snd_cmd_rip_done(void) {
+  return wavelocals.ripping == 3;
 }
 static void wave_exit(void) {
   if (wavelocals.recording == 1) {
@@ -1006,8 +1205,12 @@ static int wave_open(char *filename) {
   wavelocals.file = mame_fopen(Machine->gamedrv->name, filename, FILETYPE_WAVE, 1);
 
   if (!wavelocals.file) return -1;
-  wavelocals.startTick = timeGetTime2();
-  wavelocals.silence = timeGetTime2();
+  if (!wavelocals.buffer)
+    wavelocals.buffer = malloc(WAVE_BUFFER_SIZE);
+  wavelocals.buffered = 0;
+  wavelocals.writeerror = 0;
+  wavelocals.position = 0;
+  wavelocals.silence = 0;
   wavelocals.silentsamples = 0;
   /* write the core header for a WAVE file */
   wavelocals.offs = mame_fwrite(wavelocals.file, "RIFF", 4);
@@ -1050,20 +1253,76 @@ static int wave_open(char *filename) {
 
 static void wave_close(void) {
   if (wavelocals.recording == 1 || wavelocals.dumping == 1) {
-    UINT32 temp32;
     if (wavelocals.file == NULL)
       return;
-    mame_fseek(wavelocals.file, 4, SEEK_SET);
-    temp32 = intel32(wavelocals.offs);
-    mame_fwrite(wavelocals.file, &temp32, 4);
-
-    mame_fseek(wavelocals.file, 40, SEEK_SET);
-    temp32 = intel32(wavelocals.offs-44);
-    mame_fwrite(wavelocals.file, &temp32, 4);
-
+    wave_flush();
     mame_fclose(wavelocals.file);
     wavelocals.file = NULL;
   }
+  free(wavelocals.buffer);
+  wavelocals.buffer = NULL;
+}
+
+/*------------------------------------
+  Block writer: sample data is
+  collected in memory and written in
+  large blocks; the header sizes are
+  patched on every flush so a crashed
+  session still leaves a valid file
+  ----------------------------------------*/
+static int wave_flush(void) {
+  UINT32 temp32;
+  if (wavelocals.buffered) {
+    if (mame_fwrite(wavelocals.file, wavelocals.buffer, wavelocals.buffered) < wavelocals.buffered)
+      wavelocals.writeerror = 1;
+    wavelocals.buffered = 0;
+  }
+
+  mame_fseek(wavelocals.file, 4, SEEK_SET);
+  temp32 = intel32(wavelocals.offs);
+  mame_fwrite(wavelocals.file, &temp32, 4);
+
+  mame_fseek(wavelocals.file, 40, SEEK_SET);
+  temp32 = intel32(wavelocals.offs-44);
+  mame_fwrite(wavelocals.file, &temp32, 4);
+
+  mame_fseek(wavelocals.file, 0, SEEK_END);
+  return !wavelocals.writeerror;
+}
+
+/* queue 16 bit samples (or silence if buf is NULL), returns the bytes accepted */
+static int wave_write(const INT16 *buf, UINT32 bytes) {
+  UINT32 done = 0;
+  if (!wavelocals.buffer) { /* out of memory, write through */
+    done = buf ? mame_fwrite_lsbfirst(wavelocals.file, buf, bytes) : 0;
+    wavelocals.offs += done;
+    return done;
+  }
+
+  while (done < bytes) {
+    UINT32 n = WAVE_BUFFER_SIZE - wavelocals.buffered;
+    if (n > bytes - done) n = bytes - done;
+    if (!buf)
+      memset(wavelocals.buffer + wavelocals.buffered, 0, n);
+    else {
+#ifdef LSB_FIRST
+      memcpy(wavelocals.buffer + wavelocals.buffered, (const UINT8 *)buf + done, n);
+#else
+      UINT32 i;
+      for (i = 0; i < n; i += 2) {
+        const UINT16 v = buf[(done + i) / 2];
+        wavelocals.buffer[wavelocals.buffered + i] = v & 0xff;
+        wavelocals.buffer[wavelocals.buffered + i + 1] = v >> 8;
+      }
+#endif
+    }
+    wavelocals.buffered += n;
+    done += n;
+    if (wavelocals.buffered == WAVE_BUFFER_SIZE && !wave_flush())
+      return 0;
+  }
+  wavelocals.offs += bytes;
+  return bytes;
 }
 
 /*--------------------*/
@@ -1094,51 +1353,56 @@ static int is_silent(const INT16* const buf, const int size)
 
 void pm_wave_record(INT16 *buffer, int samples) {
   int written;
+  if (wavelocals.ripping) {
+    if (wavelocals.ripping == 1) {
+      if (wavelocals.ripwarmup > (UINT32)samples)
+        wavelocals.ripwarmup -= samples;
+      else
+        rip_start();
+    }
+    else if (wavelocals.ripping == 2) {
+      playCmd(-1, NULL); /* clock out the command bytes */
+      if (wavelocals.dumping != 1)
+        wavelocals.ripping = 3;
+    }
+  }
   if (wavelocals.dumping == 1) {
-		const UINT32 tick = timeGetTime2();
-		if (!is_silent(buffer, samples * CHANNELCOUNT))
-			wavelocals.silence = tick;
+		/* end of clip detection runs on emulated time so it works unthrottled */
+		const UINT32 rate = (UINT32)(Machine->sample_rate+0.5);
+		const int silent = is_silent(buffer, samples * CHANNELCOUNT);
+		wavelocals.position += samples;
+		if (!silent)
+			wavelocals.silence = wavelocals.position;
 
 		if (wavelocals.offs > 44) {
-			if (wavelocals.silence == tick) {
+			if (!silent) {
 				if (wavelocals.silentsamples > 0) {
-					int i;
-					INT16 * const silentBuffer = malloc(samples * 2 * CHANNELCOUNT);
-					memset(silentBuffer, 0x00, samples * 2 * CHANNELCOUNT);
-					for (i = 0; i < (wavelocals.silentsamples - 1); i++) {
-						written = mame_fwrite_lsbfirst(wavelocals.file, silentBuffer, samples * 2 * CHANNELCOUNT);
-						wavelocals.offs += written;
-					}
-					free(silentBuffer);
+					wave_write(NULL, wavelocals.silentsamples * 2 * CHANNELCOUNT);
 					wavelocals.silentsamples = 0;
 				}
-				written = mame_fwrite_lsbfirst(wavelocals.file, buffer, samples * 2 * CHANNELCOUNT);
-				wavelocals.offs += written;
+				written = wave_write(buffer, samples * 2 * CHANNELCOUNT);
 				if (written < samples * 2) {
 					wave_close(); wavelocals.dumping = -1;
 				}
 			}
-			else {
-				wavelocals.silentsamples++;
-				if (wavelocals.silentsamples == 1) {
-					written = mame_fwrite_lsbfirst(wavelocals.file, buffer, samples * 2 * CHANNELCOUNT);
-					wavelocals.offs += written;
-				}
+			else if (wavelocals.position - wavelocals.silence == (UINT32)samples) {
+				/* keep the first silent frame, the decay often ends in it */
+				written = wave_write(buffer, samples * 2 * CHANNELCOUNT);
 			}
+			else
+				wavelocals.silentsamples += samples;
 		}
 		else if (wavelocals.offs == 44) {
-			written = mame_fwrite_lsbfirst(wavelocals.file, buffer, samples * 2 * CHANNELCOUNT);
-			wavelocals.offs += written;
+			written = wave_write(buffer, samples * 2 * CHANNELCOUNT);
 			if (written < samples * 2) {
 				wave_close(); wavelocals.dumping = -1;
 			}
 		}
-		if ((tick - wavelocals.silence > 2000) || (tick - wavelocals.startTick > 240000))
+		if ((wavelocals.position - wavelocals.silence > DUMP_SILENCE_SECONDS * rate) || (wavelocals.position > DUMP_MAX_SECONDS * rate))
 			playNextCmd();
   }
   else if (wavelocals.recording == 1) {
-    written = mame_fwrite_lsbfirst(wavelocals.file, buffer, samples * 2 * CHANNELCOUNT);
-    wavelocals.offs += written;
+    written = wave_write(buffer, samples * 2 * CHANNELCOUNT);
     if (written < samples * 2) {
       wave_close(); wavelocals.recording = -1;
     }
@@ -9,12 +9,25 @@
 /* 161200 changed manual_sound_commands to return TRUE if not in sound command mode */
 /*        added snd_cmd_exit, snd_cmd_log, removed sound_mode variable */
 
+#define SND_CMD_LOG_SIZE	1024	/* sound command history entries, power of 2 */
+
+/* Sound command history: written by snd_cmd_log on the emulation thread, read
+   from any thread through one cursor per reader (see snd_read_cmd_log) */
+struct snd_tCmdLogEntry {
+  double time;	/* emulated time of the command */
+  int boardNo;
+  int cmd;
+};
+
 /* Exported Functions */
 int manual_sound_commands(struct mame_bitmap *bitmap);
 void snd_cmd_init(void);
 void snd_cmd_exit(void);
 void snd_cmd_log(int boardNo, int cmd);
-int snd_get_cmd_log(int *last, int *buffer);
+int snd_get_cmd_log(UINT32 *cursor, int *buffer);
+UINT32 snd_cmd_log_position(void);
+int snd_read_cmd_log(UINT32 *cursor, struct snd_tCmdLogEntry *entries, int max, int *lost);
+int snd_cmd_rip_done(void);
 
 void reinit_pinSound(void);
 
@@ -39,7 +52,7 @@ void reinit_pinSound(void);
 #define SMDCMD_PLAY		KEYCODE_SPACE
 #define SMDCMD_INSERT	KEYCODE_INSERT
 
-#define MAX_CMD_LOG		16
+#define MAX_CMD_LOG		16	/* values returned by snd_get_cmd_log */
 
 
 #endif	/*INC_SNDCMD*/
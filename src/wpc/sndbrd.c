@@ -24,6 +24,20 @@ static struct intfData {
   int manCmdBuf; // if board requires 2 sound commands, keep last value here.
 } intf[2];
 
+/*-- Synced writes: a FIFO of timestamped writes, delivered in order from the end of the --*/
+/*-- current timeslice on, spaced like the original writes, so commands written close --*/
+/*-- together in a long timeslice are neither lost nor merged in the board latch --*/
+#define MAX_SYNCS 32 // must be a power of 2
+static struct {
+  struct {
+    WRITE_HANDLER((*handler));
+    int offset,data;
+    double time;
+  } fifo[MAX_SYNCS];
+  unsigned int head, tail;
+  void *timer;
+} syncData;
+
 void sndbrd_init(int brdNo, int brdType, int cpuNo, UINT8 *romRegion,
                  WRITE_HANDLER((*data_cb)),WRITE_HANDLER((*ctrl_cb))) {
   const struct sndbrdIntf *b = allsndboards[brdType>>8];
@@ -65,6 +79,7 @@ void sndbrd_exit(int board) {
   if (b && (coreGlobals.soundEn || (b->flags & SNDBRD_NOTSOUND)) && b->exit)
     b->exit(board);
   memset(&intf[board],0,sizeof(intf[0]));
+  memset(&syncData,0,sizeof(syncData)); // the timers are gone with the machine
 }
 void sndbrd_diag(int board, int button) {
   const struct sndbrdIntf *b = intf[board].brdIntf;
@@ -85,6 +100,8 @@ void sndbrd_data_w(int board, int data) {
     if((b->flags & SNDBRD_NOTSOUND)==0)
 		snd_cmd_log(board, data);
 #endif
+    cpu_interleave_activity();
+    cpu_signal_event(CPU_EVENT_WRITE);
     if (b->flags & SNDBRD_NODATASYNC)
       b->data_w(board, data);
     else
@@ -103,6 +120,8 @@ int sndbrd_data_r(int board) {
 void sndbrd_ctrl_w(int board, int data) {
   const struct sndbrdIntf *b = intf[board].brdIntf;
   if (b && (coreGlobals.soundEn || (b->flags & SNDBRD_NOTSOUND)) && b->ctrl_w) {
+    cpu_interleave_activity();
+    cpu_signal_event(CPU_EVENT_WRITE);
     if (b->flags & SNDBRD_NOCTRLSYNC)
       b->ctrl_w(board, data);
     else
@@ -167,32 +186,32 @@ int sndbrd_type(int offset) { return intf[offset].type; }
 int sndbrd_0_type()         { return intf[0].type; }
 int sndbrd_1_type()         { return intf[1].type; }
 
-#define MAX_SYNCS 5
-static struct {
-  int used;
-  WRITE_HANDLER((*handler));
-  int offset,data;
-} syncData[MAX_SYNCS];
 
 static void sndbrd_doSync(int param) {
-  syncData[param].used = FALSE;
-  syncData[param].handler(syncData[param].offset,syncData[param].data);
+  const int ii = syncData.head++ & (MAX_SYNCS-1);
+
+  if (syncData.head != syncData.tail) {
+    const double delay = syncData.fifo[syncData.head & (MAX_SYNCS-1)].time - syncData.fifo[ii].time;
+    timer_adjust(syncData.timer, delay > 0 ? delay : TIME_NOW, 0, 0);
+  }
+  syncData.fifo[ii].handler(syncData.fifo[ii].offset,syncData.fifo[ii].data);
 }
 
 void sndbrd_sync_w(WRITE_HANDLER((*handler)),int offset, int data) {
   int ii;
 
   if (!handler) return;
-  for (ii = 0; ii < MAX_SYNCS; ii++)
-    if (!syncData[ii].used) {
-      syncData[ii].used = TRUE;
-      syncData[ii].handler = handler;
-      syncData[ii].offset = offset;
-      syncData[ii].data = data;
-      timer_set(TIME_NOW, ii, sndbrd_doSync);
-      return;
-    }
-  DBGLOG(("Warning: out of sync timers"));
+  if (syncData.tail - syncData.head == MAX_SYNCS)
+    { DBGLOG(("Warning: sync FIFO full")); return; }
+  if (!syncData.timer)
+    syncData.timer = timer_alloc(sndbrd_doSync);
+  ii = syncData.tail & (MAX_SYNCS-1);
+  syncData.fifo[ii].handler = handler;
+  syncData.fifo[ii].offset = offset;
+  syncData.fifo[ii].data = data;
+  syncData.fifo[ii].time = timer_get_time();
+  if (syncData.tail++ == syncData.head)
+    timer_adjust(syncData.timer, TIME_NOW, 0, 0);
 }
 const struct sndbrdIntf NULLIntf = { 0 }; // remove when all boards below works.
 #else /* SNDBRD_RECURSIVE */
@@ -0,0 +1,119 @@
+// license:BSD-3-Clause
+
+/***************************************************************************
+ Thread scheduling (see threadsched.h)
+
+ The Windows functions that are not available on every supported version
+ (SetThreadDescription from Windows 10 1607, the MMCSS functions of
+ avrt.dll) are looked up at runtime, so nothing fails when they are
+ missing.
+***************************************************************************/
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+ #define _GNU_SOURCE // pthread_setaffinity_np, pthread_setname_np
+#endif
+
+#include <string.h>
+#include "threadsched.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+ #include <windows.h>
+#elif defined(__linux__) || defined(__APPLE__)
+ #include <pthread.h>
+ #include <sched.h>
+#endif
+
+static struct {
+  UINT64 affinity;
+  int realtime;
+} locals[THREADSCHED_ROLES];
+
+// short names: Linux limits them to 15 characters
+static const char* const thread_names[THREADSCHED_ROLES] = {
+  "PinMAME emu", "PinMAME audio", "PinMAME altsnd", "PinMAME DMDdev"
+};
+
+void threadsched_config(int role, UINT64 affinity, int realtime) {
+  if (role < 0 || role >= THREADSCHED_ROLES) return;
+  locals[role].affinity = affinity;
+  locals[role].realtime = realtime > 0 ? realtime : 0;
+}
+
+#if defined(_WIN32) || defined(_WIN64)
+
+typedef HRESULT (WINAPI *tSetThreadDescription)(HANDLE, PCWSTR);
+typedef HANDLE (WINAPI *tAvSetMmThreadCharacteristicsA)(LPCSTR, LPDWORD);
+
+void threadsched_apply(int role) {
+  static tSetThreadDescription pSetThreadDescription = NULL;
+  static tAvSetMmThreadCharacteristicsA pAvSetMmThreadCharacteristics = NULL;
+  static int lookedUp = 0;
+
+  if (role < 0 || role >= THREADSCHED_ROLES) return;
+
+  if (!lookedUp) {
+    const HMODULE hKernel = GetModuleHandleA("kernel32.dll");
+    if (hKernel)
+      pSetThreadDescription = (tSetThreadDescription)GetProcAddress(hKernel, "SetThreadDescription");
+    lookedUp = 1;
+  }
+  if (pSetThreadDescription) {
+    WCHAR wName[32];
+    MultiByteToWideChar(CP_ACP, 0, thread_names[role], -1, wName, sizeof(wName) / sizeof(wName[0]));
+    pSetThreadDescription(GetCurrentThread(), wName);
+  }
+
+  if (locals[role].affinity)
+    SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)locals[role].affinity);
+
+  if (locals[role].realtime) {
+    if (!pAvSetMmThreadCharacteristics) {
+      const HMODULE hAvrt = LoadLibraryA("avrt.dll"); // kept loaded, the registration lasts as long as the thread
+      if (hAvrt)
+        pAvSetMmThreadCharacteristics = (tAvSetMmThreadCharacteristicsA)GetProcAddress(hAvrt, "AvSetMmThreadCharacteristicsA");
+    }
+    if (pAvSetMmThreadCharacteristics) {
+      DWORD taskIndex = 0;
+      pAvSetMmThreadCharacteristics("Pro Audio", &taskIndex);
+    }
+  }
+}
+
+#elif defined(__linux__) || defined(__APPLE__)
+
+void threadsched_apply(int role) {
+  if (role < 0 || role >= THREADSCHED_ROLES) return;
+
+#if defined(__APPLE__)
+  pthread_setname_np(thread_names[role]);
+#else
+  pthread_setname_np(pthread_self(), thread_names[role]);
+#endif
+
+#if defined(__linux__) && !defined(__ANDROID__)
+  if (locals[role].affinity) {
+    cpu_set_t cpus;
+    int cpu;
+    CPU_ZERO(&cpus);
+    for (cpu = 0; cpu < 64 && cpu < CPU_SETSIZE; cpu++)
+      if (locals[role].affinity & ((UINT64)1 << cpu))
+        CPU_SET(cpu, &cpus);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+  }
+#endif
+
+  if (locals[role].realtime) {
+    struct sched_param param;
+    const int minPriority = sched_get_priority_min(SCHED_FIFO);
+    const int maxPriority = sched_get_priority_max(SCHED_FIFO);
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = locals[role].realtime < minPriority ? minPriority : locals[role].realtime > maxPriority ? maxPriority : locals[role].realtime;
+    pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+  }
+}
+
+#else
+
+void threadsched_apply(int role) {}
+
+#endif
@@ -0,0 +1,34 @@
+// license:BSD-3-Clause
+
+#ifndef INC_THREADSCHED
+#define INC_THREADSCHED
+#if !defined(__GNUC__) || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || (__GNUC__ >= 4)	// GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include "osd_cpu.h"
+
+/*----------------------------------------------------------------
+/ Thread scheduling: names the PinMAME threads for the profilers and
+/ debuggers, and applies the CPU affinity and scheduling class
+/ configured for their role.
+/
+/ affinity is a mask of the allowed CPUs, 0 to leave the thread to the
+/ OS scheduler (not supported on macOS). realtime is 0 for the normal
+/ scheduling, otherwise the thread is registered to MMCSS "Pro Audio"
+/ on Windows, or runs SCHED_FIFO with realtime as priority (clamped
+/ to the system range) elsewhere, which needs the matching privileges.
+/
+/ threadsched_config is called before the threads are started,
+/ threadsched_apply by each thread when it starts.
+/---------------------------------------------------------------*/
+#define THREADSCHED_EMULATION 0 // runs the emulated machine
+#define THREADSCHED_AUDIO     1 // altsound native mixer: end of stream callbacks
+#define THREADSCHED_ALTSOUND  2 // altsound command processing
+#define THREADSCHED_DMDDEVICE 3 // VPinMAME dmddevice output
+#define THREADSCHED_ROLES     4
+
+extern void threadsched_config(int role, UINT64 affinity, int realtime);
+extern void threadsched_apply(int role);
+
+#endif /* INC_THREADSCHED */
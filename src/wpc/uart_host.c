@@ -0,0 +1,102 @@
+/*
+    Buffered transport between the emulated UARTs (uart_16c450.c,
+    uart_8251.c) and the host serial port (windows/serial.c or
+    unix/serial.c).
+
+    The emulated UARTs still exchange one byte at a time with the guest,
+    but the host port is only accessed in batches: received bytes are read
+    in blocks into a ring buffer, and sent bytes are collected and written
+    in blocks once enough are pending, or when the guest polls the UART
+    for incoming data.
+*/
+
+#include <errno.h>
+#include <string.h>
+
+#include "uart_host.h"
+
+#define UART_RX_SIZE    1024    // must be a power of 2
+#define UART_TX_SIZE    256     // bytes collected before a forced write
+
+static struct {
+    data8_t rx[UART_RX_SIZE];
+    unsigned int rx_read, rx_write;
+    data8_t tx[UART_TX_SIZE];
+    int tx_count;
+    uart_stats_t stats;
+} locals;
+
+void uart_host_reset(void)
+{
+    memset(&locals, 0, sizeof(locals));
+}
+
+int uart_flush(void)
+{
+    int sent = 0;
+
+    while (sent < locals.tx_count) {
+        int written = uart_write(locals.tx + sent, locals.tx_count - sent);
+        if (written <= 0) {
+            break;
+        }
+        locals.stats.tx_bytes += written;
+        locals.stats.tx_writes++;
+        sent += written;
+    }
+
+    // keep what the host port did not accept for the next flush
+    if (sent > 0 && sent < locals.tx_count) {
+        memmove(locals.tx, locals.tx + sent, locals.tx_count - sent);
+    }
+    locals.tx_count -= sent;
+
+    return locals.tx_count ? -EAGAIN : 0;
+}
+
+int uart_getch(void)
+{
+    // a guest polling for incoming data is done sending for now
+    if (locals.tx_count) {
+        uart_flush();
+    }
+
+    if (locals.rx_read == locals.rx_write) {
+        // refill the ring buffer, never across its end to keep one read per refill
+        unsigned int offset = locals.rx_write & (UART_RX_SIZE - 1);
+        int space = UART_RX_SIZE - (int)(locals.rx_write - locals.rx_read);
+        int received;
+        if (space > UART_RX_SIZE - (int)offset) {
+            space = UART_RX_SIZE - (int)offset;
+        }
+        received = uart_read(locals.rx + offset, space);
+        if (received <= 0) {
+            return received < 0 ? received : -EAGAIN;
+        }
+        locals.stats.rx_bytes += received;
+        locals.stats.rx_reads++;
+        locals.rx_write += received;
+    }
+
+    return locals.rx[locals.rx_read++ & (UART_RX_SIZE - 1)];
+}
+
+int uart_putch(data8_t value)
+{
+    if (locals.tx_count == UART_TX_SIZE && uart_flush() < 0) {
+        locals.stats.tx_dropped++;
+        return -EAGAIN;
+    }
+
+    locals.tx[locals.tx_count++] = value;
+    if (locals.tx_count == UART_TX_SIZE) {
+        uart_flush();
+    }
+
+    return 0;
+}
+
+void uart_get_stats(uart_stats_t *stats)
+{
+    *stats = locals.stats;
+}
@@ -6,7 +6,23 @@
 
 #include "memory.h"
 
+typedef struct {
+    data32_t rx_bytes, rx_reads;        // bytes received, in that many host reads
+    data32_t tx_bytes, tx_writes;       // bytes sent, in that many host writes
+    data32_t tx_dropped;                // bytes lost because the host port did not accept them
+} uart_stats_t;
+
+// Host serial port (windows/serial.c or unix/serial.c), non-blocking block transfers
+// returning the number of bytes transferred or a negative errno value.
 int uart_open(const char *device, data32_t baudrate);
+int uart_close(void);
 int uart_baudrate(data32_t baudrate);
+int uart_read(data8_t *buffer, int size);
+int uart_write(const data8_t *buffer, int size);
+
+// Buffered byte interface used by the emulated UARTs (uart_host.c)
+void uart_host_reset(void);
 int uart_getch(void);
 int uart_putch(data8_t value);
+int uart_flush(void);
+void uart_get_stats(uart_stats_t *stats);
@@ -12,7 +12,7 @@ static struct {
   UINT32 solMask[2];
   UINT8  dips[VP_MAXDIPBANKS];
   UINT16 lastSeg[CORE_SEGCOUNT];
-  int    lastSoundCommandIndex;
+  UINT32 soundCommandCursor;
   mech_tInitData md;
 } locals;
 
@@ -24,6 +24,8 @@ INLINE UINT8 saturatedByte(float v) { return (UINT8)(255.0f * (v < 0.0f ? 0.0f :
 void vp_init(void) {
   memset(&locals, 0, sizeof(locals));
   locals.solMask[0] = locals.solMask[1] = 0xffffffff;
+  locals.soundCommandCursor = snd_cmd_log_position();
+  vp_resetJournal();
   mech_init();
 }
 
@@ -235,6 +237,7 @@ void vp_setSolMask(int no, int mask) {
 		// 1 enable legacy "modulated solenoid"
 		// 2 enable physical outputs (solenoids/lamps/GI/alphanum segments)
 		options.usemodsol = (options.usemodsol & CORE_MODOUT_FORCE_ON) | (mask==2 ? CORE_MODOUT_ENABLE_PHYSOUT_ALL : mask);
+		core_init_pwm_output_models();
 	}
 	else if (no == 0 || no == 1)
 	{
@@ -272,35 +275,67 @@ UINT64 vp_getSolMask64(void) {
 /*-----------
 /  set Output Modulation Type ('no' starts at 1 upward, for example 1-5 for WPC GI)
 /-----------*/
-void vp_setModOutputType(int output, int no, int type) {
-	int pos = -1;
+static int vp_getModOutputPos(int output, int no) {
 	if (output == VP_OUT_SOLENOID && 1 <= no && no <= coreGlobals.nSolenoids)
-		pos = CORE_MODOUT_SOL0 + no - 1;
+		return CORE_MODOUT_SOL0 + no - 1;
 	else if (output == VP_OUT_GI && 1 <= no && no <= coreGlobals.nGI)
-		pos = CORE_MODOUT_GI0 + no - 1;
+		return CORE_MODOUT_GI0 + no - 1;
 	else if (output == VP_OUT_LAMP && 1 <= no && no <= coreGlobals.nLamps)
-		pos = CORE_MODOUT_LAMP0 + no - 1;
+		return CORE_MODOUT_LAMP0 + no - 1;
 	else if (output == VP_OUT_ALPHASEG && 1 <= no && no <= coreGlobals.nAlphaSegs)
-		pos = CORE_MODOUT_SEG0 + no - 1;
+		return CORE_MODOUT_SEG0 + no - 1;
+	return -1;
+}
+
+void vp_setModOutputType(int output, int no, int type) {
+	const int pos = vp_getModOutputPos(output, no);
 	if (pos != -1)
 		core_set_pwm_output_type(pos, 1, type);
 }
 
 int vp_getModOutputType(int output, int no) {
-	int pos;
-	if (output == VP_OUT_SOLENOID && 1 <= no && no <= coreGlobals.nSolenoids)
-		pos = CORE_MODOUT_SOL0 + no - 1;
-	else if (output == VP_OUT_GI && 1 <= no && no <= coreGlobals.nGI)
-		pos = CORE_MODOUT_GI0 + no - 1;
-	else if (output == VP_OUT_LAMP && 1 <= no && no <= coreGlobals.nLamps)
-		pos = CORE_MODOUT_LAMP0 + no - 1;
-	else if (output == VP_OUT_ALPHASEG && 1 <= no && no <= coreGlobals.nAlphaSegs)
-		pos = CORE_MODOUT_SEG0 + no - 1;
-	else
+	const int pos = vp_getModOutputPos(output, no);
+	if (pos == -1)
 		return -1; // Undefined behavior
 	return coreGlobals.physicOutputState[pos].type;
 }
 
+/*-----------
+/  set whether an output is watched ('no' starts at 1 upward, 0 for all outputs of the type)
+/-----------*/
+static int vp_getModOutputRange(int output, int no, int* count) {
+	*count = 1;
+	if (no != 0)
+		return vp_getModOutputPos(output, no);
+	*count = output == VP_OUT_SOLENOID ? coreGlobals.nSolenoids : output == VP_OUT_GI ? coreGlobals.nGI : output == VP_OUT_LAMP ? coreGlobals.nLamps : coreGlobals.nAlphaSegs;
+	return output == VP_OUT_SOLENOID ? CORE_MODOUT_SOL0 : output == VP_OUT_GI ? CORE_MODOUT_GI0 : output == VP_OUT_LAMP ? CORE_MODOUT_LAMP0 : output == VP_OUT_ALPHASEG ? CORE_MODOUT_SEG0 : -1;
+}
+
+void vp_setOutputWatched(int output, int no, int watched) {
+	int count;
+	const int pos = vp_getModOutputRange(output, no, &count);
+	if (pos != -1)
+		core_set_pwm_output_watched(pos, count, watched);
+}
+
+int vp_getOutputWatched(int output, int no) {
+	const int pos = vp_getModOutputPos(output, no);
+	if (pos == -1)
+		return -1;
+	return core_get_pwm_output_watched(pos);
+}
+
+/*-----------
+/  get the number of flip ring overruns of an output ('no' starts at 1 upward, 0 for all outputs of the type)
+/-----------*/
+int vp_getOutputOverruns(int output, int no) {
+	int count;
+	const int pos = vp_getModOutputRange(output, no, &count);
+	if (pos == -1)
+		return -1;
+	return (int)core_get_pwm_output_overruns(pos, count);
+}
+
 extern void time_fence_post(); // in cpuexec.c
 extern volatile double time_fence_global_offset;
 void vp_setTimeFence(double timeInS)
@@ -345,7 +380,7 @@ void vp_setMechData(int para, int data) {
 /------------------------------------------------*/
 int vp_getNewSoundCommands(vp_tChgSound chgSound) {
   int cmds[MAX_CMD_LOG];
-  int numcmd = snd_get_cmd_log(&locals.lastSoundCommandIndex, cmds);
+  int numcmd = snd_get_cmd_log(&locals.soundCommandCursor, cmds);
   int ii;
 
   // this would have been even easier if vp_tChgSound was a plain array
@@ -375,3 +410,178 @@ int vp_getChangedLEDs(vp_tChgLED chgStat, UINT64 mask, UINT64 mask2) {
   memcpy(locals.lastSeg, coreGlobals.drawSeg, sizeof(locals.lastSeg));
   return idx;
 }
+
+/*-------------------------------------------------
+/  Output change journal
+/
+/  The changes of the lamps, solenoids and GI are appended to one ring,
+/  each with its emulated time, while at least one cursor is open. Each
+/  consumer reads from its own cursor, so several of them can follow the
+/  changes without stealing each other's 'changed since last call' state
+/  like the vp_getChanged* functions do.
+/
+/  The journal is written from core_updateSw, on the emulation thread, at
+/  the point where the drivers have published their outputs, and read from
+/  any host thread: the head is only stored after the entry is written, and
+/  readers drop the entries that may have been overwritten while they were
+/  copying them.
+/------------------------------------------------*/
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define VP_JOURNAL_LOAD(p)     ((UINT32)_InterlockedOr((volatile long *)(p), 0))
+#define VP_JOURNAL_STORE(p, v) _InterlockedExchange((volatile long *)(p), (long)(v))
+#define VP_JOURNAL_ADD(p, v)   _InterlockedExchangeAdd((volatile long *)(p), (long)(v))
+#else
+#define VP_JOURNAL_LOAD(p)     __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define VP_JOURNAL_STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define VP_JOURNAL_ADD(p, v)   __atomic_fetch_add((p), (v), __ATOMIC_ACQ_REL)
+#endif
+
+static struct {
+  volatile UINT32 head;    /* number of entries ever written, never reset so that open cursors stay valid */
+  volatile long cursors;   /* open cursors, nothing is journaled without any */
+  volatile long resync;    /* take a new snapshot without journaling it */
+  vp_tJournalEntry entries[VP_JOURNAL_SIZE];
+  UINT8  lastPhysicsOutput[CORE_MODOUT_MAX];
+  UINT8  lastLampMatrix[CORE_MAXLAMPCOL];
+  int    lastGI[CORE_MAXGI];
+  UINT64 lastSol;
+} journal = { 0, 0, 1 };
+
+INLINE void vp_journalAdd(double now, int type, int no, int value) {
+  const UINT32 head = journal.head;
+  vp_tJournalEntry* const entry = &journal.entries[head & (VP_JOURNAL_SIZE - 1)];
+  entry->time = now;
+  entry->no = (UINT16)no;
+  entry->type = (UINT8)type;
+  entry->value = (UINT8)value;
+  VP_JOURNAL_STORE(&journal.head, head + 1);
+}
+
+/*-- same values and numbering as vp_getChangedLamps/Solenoids/GI --*/
+void vp_updateJournal(void) {
+  const int resync = VP_JOURNAL_LOAD(&journal.resync) != 0;
+  const double now = timer_get_time();
+  int ii;
+
+  if (VP_JOURNAL_LOAD(&journal.cursors) == 0)
+    return;
+  if (resync)
+    VP_JOURNAL_STORE(&journal.resync, 0);
+
+  /*-- solenoids --*/
+  if (coreGlobals.nSolenoids && (options.usemodsol & (CORE_MODOUT_ENABLE_PHYSOUT_SOLENOIDS | CORE_MODOUT_ENABLE_MODSOL))) {
+    float state[CORE_MODOUT_SOL_MAX];
+    core_update_pwm_solenoids();
+    core_getAllPhysicSols(state);
+    for (ii = 0; ii < coreGlobals.nSolenoids; ii++) {
+      if ((options.usemodsol & CORE_MODOUT_ENABLE_MODSOL) && (coreGlobals.physicOutputState[CORE_MODOUT_SOL0 + ii].type == CORE_MODOUT_BULB_44_6_3V_AC_REV))
+        state[ii] = 1.0f - state[ii];
+      {
+        const UINT8 v = saturatedByte(state[ii]);
+        if (v != journal.lastPhysicsOutput[CORE_MODOUT_SOL0 + ii] && !resync)
+          vp_journalAdd(now, VP_OUT_SOLENOID, ii + 1, v);
+        journal.lastPhysicsOutput[CORE_MODOUT_SOL0 + ii] = v;
+      }
+    }
+  }
+  else {
+    const UINT64 allSol = core_getAllSol();
+    UINT64 chgSol = resync ? 0 : (allSol ^ journal.lastSol) & vp_getSolMask64();
+    journal.lastSol = allSol;
+    for (ii = 0; chgSol; ii++, chgSol >>= 1)
+      if (chgSol & 0x01)
+        vp_journalAdd(now, VP_OUT_SOLENOID, ii + 1, (int)((allSol >> ii) & 0x01));
+  }
+
+  /*-- lamps, the whole columns are compared before looking at their bits --*/
+  if (coreGlobals.nLamps && (options.usemodsol & CORE_MODOUT_ENABLE_PHYSOUT_LAMPS)) {
+    core_update_pwm_lamps();
+    for (ii = 0; ii < coreGlobals.nLamps; ii++) {
+      const UINT8 v = saturatedByte(coreGlobals.physicOutputState[CORE_MODOUT_LAMP0 + ii].value);
+      if (v != journal.lastPhysicsOutput[CORE_MODOUT_LAMP0 + ii] && !resync)
+        vp_journalAdd(now, VP_OUT_LAMP, coreData && coreData->m2lamp ? coreData->m2lamp((ii / 8) + 1, ii & 7) : 0, v);
+      journal.lastPhysicsOutput[CORE_MODOUT_LAMP0 + ii] = v;
+    }
+  }
+  else {
+    const int hasSAMModulatedLeds = (core_gameData->gen & GEN_SAM) && (core_gameData->hw.lampCol > 2);
+    const int nCol = CORE_STDLAMPCOLS + (hasSAMModulatedLeds ? 2 : core_gameData->hw.lampCol);
+    for (ii = 0; ii < nCol; ii++) {
+      const UINT8 bits = coreGlobals.lampMatrix[ii];
+      UINT8 chgLamp = resync ? 0 : bits ^ journal.lastLampMatrix[ii];
+      int jj;
+      journal.lastLampMatrix[ii] = bits;
+      for (jj = 0; chgLamp; jj++, chgLamp >>= 1)
+        if (chgLamp & 0x01)
+          vp_journalAdd(now, VP_OUT_LAMP, coreData && coreData->m2lamp ? coreData->m2lamp(ii + 1, jj) : 0, (bits >> jj) & 0x01);
+    }
+  }
+
+  /*-- GI --*/
+  if (coreGlobals.nGI && (options.usemodsol & CORE_MODOUT_ENABLE_PHYSOUT_GI)) {
+    core_update_pwm_gis();
+    for (ii = 0; ii < coreGlobals.nGI; ii++) {
+      const UINT8 v = saturatedByte(coreGlobals.physicOutputState[CORE_MODOUT_GI0 + ii].value);
+      if (v != journal.lastPhysicsOutput[CORE_MODOUT_GI0 + ii] && !resync)
+        vp_journalAdd(now, VP_OUT_GI, ii, v);
+      journal.lastPhysicsOutput[CORE_MODOUT_GI0 + ii] = v;
+    }
+  }
+  else {
+    for (ii = 0; ii < CORE_MAXGI; ii++) {
+      if (coreGlobals.gi[ii] != journal.lastGI[ii] && !resync)
+        vp_journalAdd(now, VP_OUT_GI, ii, coreGlobals.gi[ii]);
+      journal.lastGI[ii] = coreGlobals.gi[ii];
+    }
+  }
+}
+
+/*-- open a cursor, positioned after the last journaled change --*/
+UINT32 vp_openJournalCursor(void) {
+  if (VP_JOURNAL_ADD(&journal.cursors, 1) == 0)
+    VP_JOURNAL_STORE(&journal.resync, 1); // the snapshot is stale since nothing was journaled
+  return VP_JOURNAL_LOAD(&journal.head);
+}
+
+void vp_closeJournalCursor(void) {
+  VP_JOURNAL_ADD(&journal.cursors, -1);
+}
+
+/*-- start again from a new snapshot, when a new game is started --*/
+void vp_resetJournal(void) {
+  VP_JOURNAL_STORE(&journal.resync, 1);
+}
+
+/*-- read the changes after the cursor, returns the number of entries copied and
+     sets *lost to the number of changes overwritten before they could be read --*/
+int vp_readJournal(UINT32* cursor, vp_tJournalEntry* entries, int max, int* lost) {
+  const UINT32 head = VP_JOURNAL_LOAD(&journal.head);
+  UINT32 first = *cursor;
+  UINT32 ii, count, newHead;
+
+  *lost = 0;
+  if (head - first > VP_JOURNAL_SIZE) {
+    *lost = (int)(head - first - VP_JOURNAL_SIZE);
+    first = head - VP_JOURNAL_SIZE;
+  }
+  count = head - first;
+  if (count > (UINT32)max)
+    count = (UINT32)max;
+  for (ii = 0; ii < count; ii++)
+    entries[ii] = journal.entries[(first + ii) & (VP_JOURNAL_SIZE - 1)];
+
+  /*-- the writer may have wrapped over the first entries while they were copied
+       (it overwrites the slot of head - VP_JOURNAL_SIZE before publishing head + 1) --*/
+  newHead = VP_JOURNAL_LOAD(&journal.head);
+  if (newHead - first >= VP_JOURNAL_SIZE) {
+    const UINT32 overwritten = newHead - first - VP_JOURNAL_SIZE + 1;
+    const UINT32 drop = overwritten > count ? count : overwritten;
+    memmove(entries, entries + drop, (count - drop) * sizeof(vp_tJournalEntry));
+    *lost += (int)overwritten;
+    first += overwritten;
+    count -= drop;
+  }
+  *cursor = first + count;
+  return (int)count;
+}
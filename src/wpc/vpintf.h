@@ -18,6 +18,9 @@ typedef struct { int giNo,   currStat; } vp_tChgGIs[CORE_MODOUT_GI_MAX];
 typedef struct { int ledNo, chgSeg, currStat; } vp_tChgLED[CORE_SEGCOUNT];
 typedef struct { int sndNo; } vp_tChgSound[MAX_CMD_LOG];
 typedef struct { int nvramNo, oldStat, currStat; } vp_tChgNVRAMs[CORE_MAXNVRAM];
+typedef struct { double time; UINT16 no; UINT8 type, value; } vp_tJournalEntry; /* type is VP_OUT_xxx */
+
+#define VP_JOURNAL_SIZE          4096 /* Output change journal entries, power of 2 */
 
 #define VP_OUT_SOLENOID          0 /* Solenoid output type */
 #define VP_OUT_LAMP              1 /* Lamp output type */
@@ -49,7 +52,7 @@ int vp_getLamp(int lampNo);
 /*------------------------------------
 /  set status of a switch (0=off, !0=on)
 /-------------------------------------*/
-INLINE void vp_putSwitch(int swNo, int newStat) { core_setSw(swNo, newStat); }
+INLINE void vp_putSwitch(int swNo, int newStat) { core_setSw(swNo, newStat); core_latencySwitch(swNo); }
 
 /*------------------------------------
 /  get status of a switch (0=off, !0=on)
@@ -116,6 +119,17 @@ void vp_setModOutputType(int output, int no, int type);
 /-----------*/
 int vp_getModOutputType(int output, int no);
 
+/*-----------
+/  set/get whether an output is watched by the host: unwatched physical outputs are not integrated anymore
+/-----------*/
+void vp_setOutputWatched(int output, int no, int watched);
+int vp_getOutputWatched(int output, int no);
+
+/*-----------
+/  get the number of flip ring overruns of an output, that is to say flips lost since it was not integrated often enough
+/-----------*/
+int vp_getOutputOverruns(int output, int no);
+
 /*-----------
 /  set a time fence where emulation is suspended when reached
 /-----------*/
@@ -139,4 +153,16 @@ int vp_getNewSoundCommands(vp_tChgSound chgSound);
 /-------------------------------------------------*/
 int vp_getChangedLEDs(vp_tChgLED chgStat, UINT64 mask, UINT64 mask2);
 
+/*-------------------------------------------------
+/  Output change journal: lamps, solenoids and GI changes with their emulated time,
+/  read through one cursor per consumer instead of a shared 'since last call' state
+/-------------------------------------------------*/
+UINT32 vp_openJournalCursor(void);
+void vp_closeJournalCursor(void);
+int vp_readJournal(UINT32* cursor, vp_tJournalEntry* entries, int max, int* lost);
+void vp_resetJournal(void);
+
+/*-- used from core.c --*/
+void vp_updateJournal(void);
+
 #endif /* INC_VPINTF */
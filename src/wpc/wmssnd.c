@@ -1347,21 +1347,27 @@ const struct sndbrdIntf dcsIntf = { "DCS", dcs_init, NULL, NULL, dcs_data_w, dcs
   ((UINT16 *)(((bank) & 0x08) ? memory_region(DCS_BANKREGION) : \
               (dcslocals.cpuRegion + ADSP2100_DATA_OFFSET + (0x2000<<1))))
 
+/*-- the banks are also mapped straight into the ADSP data memory, --*/
+/*-- so the sample and RAM bank accesses skip the handlers below --*/
 static WRITE16_HANDLER(dcs1_ROMbankSelect1_w) {
   dcslocals.ROMbank1 = data;
   dcslocals.ROMbankPtr = DCS1_ROMBANKBASE(dcslocals.ROMbank1);
+  adsp2100_set_data_pages(0x2000, 0x2fff, NULL, NULL, dcslocals.ROMbankPtr);
 }
 static WRITE16_HANDLER(dcs2_ROMbankSelect1_w) {
   dcslocals.ROMbank1 = data;
   dcslocals.ROMbankPtr = DCS2_ROMBANKBASE(dcslocals.ROMbank2,dcslocals.ROMbank1);
+  adsp2100_set_data_pages(0x0000, 0x07ff, NULL, NULL, dcslocals.ROMbankPtr);
 }
 static WRITE16_HANDLER(dcs2_ROMbankSelect2_w) {
   dcslocals.ROMbank2 = data;
   dcslocals.ROMbankPtr = DCS2_ROMBANKBASE(dcslocals.ROMbank2,dcslocals.ROMbank1);
+  adsp2100_set_data_pages(0x0000, 0x07ff, NULL, NULL, dcslocals.ROMbankPtr);
 }
 static WRITE16_HANDLER(dcs2_RAMbankSelect_w) {
   dcslocals.RAMbank  = data;
   dcslocals.RAMbankPtr = DCS2_RAMBANKBASE(dcslocals.RAMbank);
+  adsp2100_set_data_pages(0x2000, 0x2fff, dcslocals.RAMbankPtr, dcslocals.RAMbankPtr, NULL);
 }
 static READ16_HANDLER (dcs2_RAMbankSelect_r) {
   return dcslocals.RAMbank;
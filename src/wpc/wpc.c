@@ -46,6 +46,7 @@
 #define WPC_IRQFREQ        (8000000./8192.) /* IRQ Frequency-Timed by JD (976) */
 
 #define DMD_ROWFREQ        (2000000./(16.*16.*2.)) // DMD row frequency deduced from schematics 16.9148.1 (half of length is serial dot shift then column latch)
+#define DMD_ROWTIME        (1./DMD_ROWFREQ)
 
 #define GENWPC_HASDMD      (GEN_ALLWPC & ~(GEN_WPCALPHA_1|GEN_WPCALPHA_2))
 #define GENWPC_HASFLIPTRON (GEN_ALLWPC & ~(GEN_WPCALPHA_1|GEN_WPCALPHA_2|GEN_WPCDMD))
@@ -68,7 +69,9 @@ static void wpc_serialCnv(const char no[21], UINT8 pic[16], UINT8 code[3]);
 
 /*-- DMD --*/
 static VIDEO_START(wpc_dmd);
-static void wpc_dmd_hsync(int);
+static void wpc_dmd_vsync(int);
+static void wpc_dmd_firq(int);
+static void wpc_dmd_schedule_firq(int line);
 PINMAME_VIDEO_UPDATE(wpcdmd_update32);
 PINMAME_VIDEO_UPDATE(wpcdmd_update64);
 
@@ -117,6 +120,7 @@ static struct {
     UINT8 sData[16];
     UINT8 codeNo[3];
     UINT8 lastW;          /* last written command */
+    UINT8 swCol;          /* switch column selected by the last command, 0 if it was another one */
     UINT8 sNoS;           /* serial number scrambler */
     UINT8 count;
     int   codeW;
@@ -139,8 +143,10 @@ static int wpc_modsol_aux_board = 0;
 static int wpc_fastflip_addr = 0;
 
 static struct {
-  int    row;                    // Rasterizer row position
   int    firq;                   // State of FIRQ output line to CPU
+  double vsyncTime;              // Emulated time at which the rasterizer was last at row 0
+  mame_timer* vsync_timer;
+  mame_timer* firq_timer;
   core_tDMDPWMState pwm_state;
 } dmdlocals;
 
@@ -386,27 +392,23 @@ MACHINE_DRIVER_END
 MACHINE_DRIVER_START(wpc_dmd)
   MDRV_IMPORT_FROM(wpc)
   MDRV_VIDEO_START(wpc_dmd)
-  MDRV_TIMER_ADD(wpc_dmd_hsync,DMD_ROWFREQ)
 MACHINE_DRIVER_END
 
 MACHINE_DRIVER_START(wpc_dmdS)
   MDRV_IMPORT_FROM(wpc)
   MDRV_VIDEO_START(wpc_dmd)
-  MDRV_TIMER_ADD(wpc_dmd_hsync,DMD_ROWFREQ)
   MDRV_IMPORT_FROM(wmssnd_wpcs)
 MACHINE_DRIVER_END
 
 MACHINE_DRIVER_START(wpc_dcsS)
   MDRV_IMPORT_FROM(wpc)
   MDRV_VIDEO_START(wpc_dmd)
-  MDRV_TIMER_ADD(wpc_dmd_hsync,DMD_ROWFREQ)
   MDRV_IMPORT_FROM(wmssnd_dcs1)
 MACHINE_DRIVER_END
 
 MACHINE_DRIVER_START(wpc_95S)
   MDRV_IMPORT_FROM(wpc)
   MDRV_VIDEO_START(wpc_dmd)
-  MDRV_TIMER_ADD(wpc_dmd_hsync,DMD_ROWFREQ)
   MDRV_IMPORT_FROM(wmssnd_dcs2)
 MACHINE_DRIVER_END
 
@@ -547,7 +549,7 @@ static INTERRUPT_GEN(wpc_interface_update) {
 					tmpLamps >>= 1;
 				}
 			}
-			procFlush();
+			procRequestFlush();
 		}
     #endif
     memcpy(coreGlobals.lampMatrix, coreGlobals.tmpLampMatrix, sizeof(coreGlobals.tmpLampMatrix));
@@ -757,7 +759,7 @@ WRITE_HANDLER(wpc_w) {
   switch (offset) {
     case WPC_ROMBANK: { /* change rom bank */
       int bank = data & wpclocals.pageMask;
-      cpu_setbank(1, memory_region(WPC_ROMREGION)+ bank * 0x4000);
+      memory_set_bank(1, bank);
       #ifdef PINMAME
         /* Bank support for CODELIST */
         cpu_bankid[1] = bank + ( 0x3F ^ wpclocals.pageMask );
@@ -995,23 +997,25 @@ WRITE_HANDLER(wpc_w) {
       DBGLOG(("WPC_IRQACK. PC=%04x d=%02x\n",activecpu_get_pc(), data));
       break;
     case WPC_DMD_PAGE3000: /* set the page that is accessed by CPU at 0x3000 (WPC-95 only) */
-      if (core_gameData->gen & (GEN_WPC95DCS | GEN_WPC95)) cpu_setbank(4, memory_region(WPC_DMDREGION) + (data & 0x0f) * 0x200); break;
+      if (core_gameData->gen & (GEN_WPC95DCS | GEN_WPC95)) memory_set_bank(4, data & 0x0f); break;
     case WPC_DMD_PAGE3200: /* set the page that is accessed by CPU at 0x3200 (WPC-95 only) */
-      if (core_gameData->gen & (GEN_WPC95DCS | GEN_WPC95)) cpu_setbank(5, memory_region(WPC_DMDREGION) + (data & 0x0f) * 0x200); break;
+      if (core_gameData->gen & (GEN_WPC95DCS | GEN_WPC95)) memory_set_bank(5, data & 0x0f); break;
     case WPC_DMD_PAGE3400: /* set the page that is accessed by CPU at 0x3400 (WPC-95 only) */
-      if (core_gameData->gen & (GEN_WPC95DCS | GEN_WPC95)) cpu_setbank(6, memory_region(WPC_DMDREGION) + (data & 0x0f) * 0x200); break;
+      if (core_gameData->gen & (GEN_WPC95DCS | GEN_WPC95)) memory_set_bank(6, data & 0x0f); break;
     case WPC_DMD_PAGE3600: /* set the page that is accessed by CPU at 0x3600 (WPC-95 only) */
-      if (core_gameData->gen & (GEN_WPC95DCS | GEN_WPC95)) cpu_setbank(7, memory_region(WPC_DMDREGION) + (data & 0x0f) * 0x200); break;
+      if (core_gameData->gen & (GEN_WPC95DCS | GEN_WPC95)) memory_set_bank(7, data & 0x0f); break;
     case WPC_DMD_PAGE3800: /* set the page that is accessed by CPU at 0x3800 */
-      cpu_setbank(2, memory_region(WPC_DMDREGION) + (data & 0x0f) * 0x200); break;
+      memory_set_bank(2, data & 0x0f); break;
     case WPC_DMD_PAGE3A00: /* set the page that is accessed by CPU at 0x3A00 */
-      cpu_setbank(3, memory_region(WPC_DMDREGION) + (data & 0x0f) * 0x200); break;
+      memory_set_bank(3, data & 0x0f); break;
     case WPC_DMD_FIRQLINE: /* acknowledge raised DMD FIRQ if any, and set the line to generate the next FIRQ (0xFF to ack and disable) */
       //printf("%8.5f FIRQ ROW: %02x PC: %04x\n", timer_get_time(), data, activecpu_get_pc());
       if (dmdlocals.firq != 0) {
         dmdlocals.firq = 0;
         update_firq();
       }
+      if (dmdlocals.firq_timer)
+        wpc_dmd_schedule_firq(data);
       break;
     case WPC_DMD_SHOWPAGE: /* set the page that will be rasterized after next DMD vblank */
       //{ static double prev = 0.; printf("%8.5f Set page: %02x PC: %04x elapsed:%8.5f\n", timer_get_time(), data, activecpu_get_pc(), timer_get_time()-prev); prev = timer_get_time(); }
@@ -1073,10 +1077,10 @@ static WRITE_HANDLER(wpc_ram_w) {
 /---------------------------*/
 static int wpc_pic_r(void) {
   int ret = 0;
+  if (wpclocals.pic.swCol) // switch matrix scan, decoded when the column was selected
+    return coreGlobals.swMatrix[wpclocals.pic.swCol];
   if (wpclocals.pic.lastW == 0x0d)
     ret = wpclocals.pic.count;
-  else if ((wpclocals.pic.lastW >= 0x16) && (wpclocals.pic.lastW <= 0x1f))
-    ret = coreGlobals.swMatrix[wpclocals.pic.lastW-0x15];
   else if ((wpclocals.pic.lastW & 0xf0) == 0x70) {
     ret = wpclocals.pic.sData[wpclocals.pic.lastW & 0x0f];
     /* update serial number scrambler */
@@ -1108,6 +1112,7 @@ static void wpc_pic_w(int data) {
   }
 
   wpclocals.pic.lastW = data;
+  wpclocals.pic.swCol = (data >= 0x16 && data <= 0x1f) ? data - 0x15 : 0;
 }
 
 /*-------------------------
@@ -1199,12 +1204,18 @@ static MACHINE_INIT(wpc) {
     const int isPH = (core_gameData->hw.gameSpecific1 & WPC_PH);
     core_dmd_pwm_init(&dmdlocals.pwm_state, 128, isPH ? 64 : 32, isPH ? CORE_DMD_PWM_FILTER_WPC_PH : CORE_DMD_PWM_FILTER_WPC, isPH ? CORE_DMD_PWM_COMBINER_SUM_2 : CORE_DMD_PWM_COMBINER_SUM_3);
     dmdlocals.pwm_state.revByte = 1;
+    dmdlocals.vsyncTime = timer_get_time();
+    dmdlocals.vsync_timer = timer_alloc(wpc_dmd_vsync);
+    dmdlocals.firq_timer = timer_alloc(wpc_dmd_firq);
+    timer_adjust(dmdlocals.vsync_timer, DMD_ROWTIME * dmdlocals.pwm_state.height, 0, DMD_ROWTIME * dmdlocals.pwm_state.height);
+    wpc_dmd_schedule_firq(wpc_data[WPC_DMD_FIRQLINE]);
   }
 
 #ifdef PINMAME_HOST_UART
   if (pmoptions.serial_device != NULL) {
     uart_16c450_reset();
     uart_8251_reset();
+    uart_host_reset();
 
     // use default baud rate; game will set a baud rate at startup
     if (uart_open(pmoptions.serial_device, 9600) < 0) {
@@ -1500,6 +1511,13 @@ static MACHINE_INIT(wpc) {
   }
 
   wpclocals.pageMask = romLengthMask[((romLength>>17)-1)&0x07];
+  /* register the ROM pages and the DMD RAM pages so bank switches are a single pointer store */
+  memory_configure_bank(1, 0, wpclocals.pageMask + 1, memory_region(WPC_ROMREGION), 0x4000);
+  if (memory_region(WPC_DMDREGION)) {
+    const int lastDMDBank = (core_gameData->gen & (GEN_WPC95DCS | GEN_WPC95)) ? 7 : 3;
+    for (int ii = 2; ii <= lastDMDBank; ii++)
+      memory_configure_bank(ii, 0, 16, memory_region(WPC_DMDREGION), 0x200);
+  }
   wpclocals.memProtMask = 0x1000;
   /* the non-paged ROM is at the end of the image. move it into the CPU region */
   memcpy(memory_region(WPC_CPUREGION) + 0x8000,
@@ -1533,6 +1551,16 @@ static MACHINE_STOP(wpc) {
       core_dmd_pwm_exit(&dmdlocals.pwm_state);
   if (wpc_printfile)
     { mame_fclose(wpc_printfile); wpc_printfile = NULL; }
+#ifdef PINMAME_HOST_UART
+  if (pmoptions.serial_device != NULL) {
+    uart_stats_t stats;
+    uart_flush();
+    uart_get_stats(&stats);
+    printf("serial_device: %u bytes sent in %u writes (%u dropped), %u bytes received in %u reads.\n",
+           stats.tx_bytes, stats.tx_writes, stats.tx_dropped, stats.rx_bytes, stats.rx_reads);
+    uart_close();
+  }
+#endif
 }
 
 /*-----------------------------------------------
@@ -1612,26 +1640,47 @@ static VIDEO_START(wpc_dmd) {
 // CPU may ask the DMD board to raise FIRQ when a given row is reached.
 // The FIRQ is then acked (pulled down) by writing again the requested FIRQ row 
 // to the corresponding register (game code use 0xFF to disables DMD FIRQ).
-static void wpc_dmd_hsync(int param) {
-  dmdlocals.row = (dmdlocals.row + 1) % dmdlocals.pwm_state.height; // FIXME Phantom Haus uses the same AV card than other WPC95 but with a 64 row display, therefore the CPU must tell the rasterizer that it is 64 row high somewhere we don't know
-  if (dmdlocals.row == 0) { // VSYNC
-    // Rasterize next page (latched while rasterizing the previous page)
-    const int rasterizedPage = wpc_data[WPC_DMD_SHOWPAGE] & 0x0f;
-    //printf("%8.5f Rnd page: %02x\n", timer_get_time(), rasterizedPage);
-    core_dmd_submit_frame(&dmdlocals.pwm_state, memory_region(WPC_DMDREGION) + rasterizedPage * dmdlocals.pwm_state.rawFrameSize, 1);
-    #ifdef PROC_SUPPORT
-      if (coreGlobals.p_rocEn) /* looks like P-ROC uses the last 3 subframes sent rather than the first 3 */
-        procFillDMDSubFrame(dmd_state->frame_index % 3, memory_region(WPC_DMDREGION) + rasterizedPage * dmdlocals.pwm_state.rawFrameSize, dmdlocals.pwm_state.rawFrameSize);
-      /* Don't explicitly update the DMD from here. The P-ROC code will update after the next DMD event. */
-    #endif
-  }
-  if (dmdlocals.row == wpc_data[WPC_DMD_FIRQLINE] && dmdlocals.firq != 1) {
-    //printf("%8.5f FIRQ at row %02x\n", timer_get_time(), dmdlocals.row);
+//
+// The row position is not tracked row by row: it is fully defined by the time
+// elapsed since the last VSYNC, so only the VSYNC and the requested FIRQ row
+// are scheduled (the FIRQ one again each time the FIRQ row is written).
+static void wpc_dmd_vsync(int param) {
+  // Rasterize next page (latched while rasterizing the previous page)
+  const int rasterizedPage = wpc_data[WPC_DMD_SHOWPAGE] & 0x0f;
+  dmdlocals.vsyncTime = timer_get_time();
+  //printf("%8.5f Rnd page: %02x\n", timer_get_time(), rasterizedPage);
+  core_dmd_submit_frame(&dmdlocals.pwm_state, memory_region(WPC_DMDREGION) + rasterizedPage * dmdlocals.pwm_state.rawFrameSize, 1);
+  #ifdef PROC_SUPPORT
+    if (coreGlobals.p_rocEn) /* looks like P-ROC uses the last 3 subframes sent rather than the first 3 */
+      procFillDMDSubFrame(dmd_state->frame_index % 3, memory_region(WPC_DMDREGION) + rasterizedPage * dmdlocals.pwm_state.rawFrameSize, dmdlocals.pwm_state.rawFrameSize);
+    /* Don't explicitly update the DMD from here. The P-ROC code will update after the next DMD event. */
+  #endif
+}
+
+static void wpc_dmd_firq(int param) {
+  if (dmdlocals.firq != 1) {
+    //printf("%8.5f FIRQ at row %02x\n", timer_get_time(), wpc_data[WPC_DMD_FIRQLINE]);
     dmdlocals.firq = 1;
     update_firq();
   }
 }
 
+// Schedule the FIRQ for the next time the rasterizer reaches the given row, then once per frame.
+// If the rasterizer is already on that row, the FIRQ will be raised on next frame.
+// FIXME Phantom Haus uses the same AV card than other WPC95 but with a 64 row display, therefore the CPU must tell the rasterizer that it is 64 row high somewhere we don't know
+static void wpc_dmd_schedule_firq(int line) {
+  const double frameTime = DMD_ROWTIME * dmdlocals.pwm_state.height;
+  double delay;
+  if (line >= dmdlocals.pwm_state.height) {
+    timer_adjust(dmdlocals.firq_timer, TIME_NEVER, 0, 0);
+    return;
+  }
+  delay = dmdlocals.vsyncTime + line * DMD_ROWTIME - timer_get_time();
+  while (delay <= 0.)
+    delay += frameTime;
+  timer_adjust(dmdlocals.firq_timer, delay, 0, frameTime);
+}
+
 int wpcdmd_update(int height, struct mame_bitmap* bitmap, const struct rectangle* cliprect, const struct core_dispLayout* layout) {
   core_dmd_update_pwm(&dmdlocals.pwm_state);
   core_dmd_video_update(bitmap, cliprect, layout, &dmdlocals.pwm_state);
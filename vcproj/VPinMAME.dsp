@@ -2360,6 +2360,14 @@ SOURCE=.\src\wpc\flicker.c
 # End Source File
 # Begin Source File
 
+SOURCE=.\src\wpc\gamealias.c
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\wpc\gamealias.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\src\wpc\gen.h
 # End Source File
 # Begin Source File
@@ -2560,6 +2568,14 @@ SOURCE=.\src\wpc\nuova.c
 # End Source File
 # Begin Source File
 
+SOURCE=.\src\wpc\outexport.c
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\wpc\outexport.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\src\wpc\peyper.c
 # End Source File
 # Begin Source File
@@ -2772,6 +2788,14 @@ SOURCE=.\src\wpc\techno.c
 # End Source File
 # Begin Source File
 
+SOURCE=.\src\wpc\threadsched.c
+# End Source File
+# Begin Source File
+
+SOURCE=.\src\wpc\threadsched.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\src\wpc\vd.c
 # End Source File
 # Begin Source File